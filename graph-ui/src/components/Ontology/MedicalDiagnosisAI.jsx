@@ -154,6 +154,26 @@ const MedicalDiagnosisAI = () => {
   const [aiLoading, setAiLoading] = useState(false);
   const [aiError, setAiError] = useState(null);
 
+  // Next-question suggestions (information gain over the differential)
+  const [ruledOut, setRuledOut] = useState([]);
+  const [questions, setQuestions] = useState(null);
+
+  useEffect(() => {
+    const controller = new AbortController();
+    fetch('/api/diagnose/next-question', {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/json' },
+      body: JSON.stringify({ present: selectedSymptoms, absent: ruledOut, top_k: 3 }),
+      signal: controller.signal,
+    })
+      .then(r => r.json())
+      .then(json => setQuestions(json.data ? json.data.questions : null))
+      .catch(err => {
+        if (err.name !== 'AbortError') setQuestions(null);
+      });
+    return () => controller.abort();
+  }, [selectedSymptoms, ruledOut]);
+
   const allSymptoms = Object.entries(medicalOntology.symptoms).map(([id, data]) => ({
     id,
     label: data.label
@@ -165,6 +185,15 @@ const MedicalDiagnosisAI = () => {
         ? prev.filter(s => s !== symptomId)
         : [...prev, symptomId]
     );
+    setRuledOut(prev => prev.filter(s => s !== symptomId));
+  };
+
+  const answerQuestion = (symptomId, present) => {
+    if (present) {
+      setSelectedSymptoms(prev => [...prev, symptomId]);
+    } else {
+      setRuledOut(prev => [...prev, symptomId]);
+    }
   };
 
   const performDiagnosis = () => {
@@ -304,12 +333,15 @@ const MedicalDiagnosisAI = () => {
     const symptomLabels = selectedSymptoms.map(
       id => medicalOntology.symptoms[id]?.label || id
     );
+    const ruledOutLabels = ruledOut.map(
+      id => medicalOntology.symptoms[id]?.label || id
+    );
 
     try {
       const res = await fetch('/api/diagnose', {
         method: 'POST',
         headers: { 'Content-Type': 'application/json' },
-        body: JSON.stringify({ symptoms: symptomLabels }),
+        body: JSON.stringify({ symptoms: symptomLabels, absent: ruledOutLabels }),
       });
       const json = await res.json();
       if (!res.ok || json.error) {
@@ -325,6 +357,7 @@ const MedicalDiagnosisAI = () => {
 
   const reset = () => {
     setSelectedSymptoms([]);
+    setRuledOut([]);
     setDiagnosis(null);
     setReasoning(null);
     setAiResult(null);
@@ -360,7 +393,7 @@ const MedicalDiagnosisAI = () => {
             {allSymptoms.map(symptom => (
               <button
                 key={symptom.id}
-                className={`symptom-chip ${selectedSymptoms.includes(symptom.id) ? 'selected' : ''}`}
+                className={`symptom-chip ${selectedSymptoms.includes(symptom.id) ? 'selected' : ''} ${ruledOut.includes(symptom.id) ? 'ruled-out' : ''}`}
                 onClick={() => toggleSymptom(symptom.id)}
               >
                 {symptom.label}
@@ -369,6 +402,27 @@ const MedicalDiagnosisAI = () => {
             ))}
           </div>
 
+          {questions && questions.length > 0 && (
+            <div className="next-questions">
+              <h3>💡 Ask next</h3>
+              {questions.map(q => (
+                <div key={q.id} className="next-question">
+                  <span className="question-text">Does the patient have <strong>{q.label}</strong>?</span>
+                  <span className="question-gain" title="Expected information gain">
+                    {q.gain.toFixed(2)} bits
+                  </span>
+                  <button className="btn-answer yes" onClick={() => answerQuestion(q.id, true)}>Yes</button>
+                  <button className="btn-answer no" onClick={() => answerQuestion(q.id, false)}>No</button>
+                </div>
+              ))}
+              {ruledOut.length > 0 && (
+                <div className="ruled-out-list">
+                  Ruled out: {ruledOut.map(id => medicalOntology.symptoms[id]?.label || id).join(', ')}
+                </div>
+              )}
+            </div>
+          )}
+
           <div className="action-bar">
             <div className="selected-count">
               {selectedSymptoms.length} symptom{selectedSymptoms.length !== 1 ? 's' : ''} selected
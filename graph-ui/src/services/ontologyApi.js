@@ -92,8 +92,13 @@ export const getClassInstances = (classId, directOnly = true) =>
 // Hierarchy & Reasoning
 // ============================================================================
 
-export const getHierarchy = (rootId = 'owl:Thing') => 
-  ontologyApi.get('/api/ontology/hierarchy', { params: { root: rootId } });
+export const getHierarchy = (rootId = 'owl:Thing', { depth = 2, limit = 50 } = {}) => 
+  ontologyApi.get('/api/ontology/hierarchy', { params: { root: rootId, depth, limit } });
+
+// Next page of a class's subclasses (cursor = next_cursor from a hierarchy response)
+export const getHierarchyChildren = (classId, cursor = null, { depth = 0, limit = 50 } = {}) => 
+  ontologyApi.get(`/api/ontology/hierarchy/${classId}/children`,
+    { params: { cursor, depth, limit } });
 
 export const checkConsistency = () => 
   ontologyApi.get('/api/ontology/reasoning/consistency');
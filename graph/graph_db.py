@@ -7,28 +7,48 @@ Supports:
 - Graph traversal (BFS, DFS)
 - Node/edge operations (add, delete, search)
 - Multiple graph types (directed, undirected, weighted)
+- Point-in-time read views for long reads that run alongside writers
+- Native topology mirror (GraphStore) with batched bulk edge ingestion
+- Temporal mode: time-travel reads of any past version (as_of)
+- Per-value node counters maintained on mutation (count_values)
 """
 
 import json
-from typing import List, Dict, Set, Optional, Tuple, Any
-from collections import deque
+import threading
+import time
+from contextlib import contextmanager
+from datetime import datetime
+from typing import Callable, List, Dict, Set, Optional, Tuple, Any, Union
 from src.adapters.simple_db import SimpleDB
+from src.adapters.graph_store import GraphStore, GraphView
+from src.adapters.ts_store import to_ms
+
+# import_diff re-plans against a fresh snapshot this many times when other
+# writers commit between its read and its batch
+_IMPORT_ATTEMPTS = 8
 
 
 class GraphDB:
     """Graph database with traversal algorithms"""
     
-    def __init__(self, directed: bool = True, weighted: bool = False):
+    def __init__(self, directed: bool = True, weighted: bool = False, temporal: bool = False):
         """
         Initialize graph database
         
         Args:
             directed: True for directed graph, False for undirected
             weighted: True if edges have weights
+            temporal: Keep every past version for as_of() reads
         """
         self.db = SimpleDB()
+        if temporal:
+            self.db.enable_history()
         self.directed = directed
         self.weighted = weighted
+        self._local = threading.local()  # per-thread pinned snapshot
+        self._counted: Tuple[str, ...] = ()  # data fields with value counters
+        self._generation = 0  # bumped by every _reset_topology
+        self._reset_topology()
         
         # Store metadata
         self.db.set("__meta__:directed", str(directed))
@@ -41,8 +61,265 @@ class GraphDB:
     
     def __exit__(self, exc_type, exc_val, exc_tb):
         self.db.clear()
+        self._reset_topology()
         return False
     
+    # ========================================================================
+    # Native Topology
+    # ========================================================================
+    
+    def _reset_topology(self):
+        """Start an empty topology mirror (after construction or clear)"""
+        self._topo = GraphStore(track_in=True)
+        self._topo_layers: Dict[str, GraphStore] = {}
+        self._topo_ids: Dict[str, int] = {}
+        self._topo_names: List[str] = []
+        self._topo_lock = threading.Lock()
+        self._generation += 1
+    
+    def generation(self) -> int:
+        """
+        Number of times the graph was cleared or replaced wholesale
+        
+        Topology view versions and value_writes counts start over after
+        that, so caches keyed on them need the generation too.
+        """
+        return self._generation
+    
+    def _topo_id(self, node_id: str) -> int:
+        """Dense integer ID of a node in the topology mirror"""
+        idx = self._topo_ids.get(node_id)
+        if idx is None:
+            with self._topo_lock:
+                idx = self._topo_ids.get(node_id)
+                if idx is None:
+                    idx = len(self._topo_names)
+                    self._topo_names.append(node_id)
+                    self._topo_ids[node_id] = idx
+        return idx
+    
+    def _topo_push(self, pairs: List[Tuple[str, str]], weights: Optional[List[float]] = None,
+                   delete: bool = False, labels: Optional[List[str]] = None,
+                   layers_only: bool = False):
+        """Queue edge inserts (or deletes) in the topology mirror, both ways if undirected"""
+        if not self.directed:
+            pairs = pairs + [(t, f) for f, t in pairs]
+            weights = weights + weights if weights is not None else None
+            labels = labels + labels if labels is not None else None
+        self._topo_apply(pairs, weights, delete, labels, layers_only)
+    
+    def _topo_apply(self, pairs: List[Tuple[str, str]], weights: Optional[List[float]] = None,
+                    delete: bool = False, labels: Optional[List[str]] = None,
+                    layers_only: bool = False):
+        """
+        Queue directed edge inserts (or deletes) in the topology mirror
+        
+        Labeled edges also go to the layer of their label; layers_only
+        leaves the all-edges store alone (used when an edge is relabeled).
+        """
+        src = [self._topo_id(f) for f, _ in pairs]
+        dst = [self._topo_id(t) for _, t in pairs]
+        if not layers_only:
+            if delete:
+                self._topo.delete_edges(src, dst)
+            else:
+                self._topo.add_edges(src, dst, weights)
+        if not labels:
+            return
+        
+        by_label: Dict[str, List[int]] = {}
+        for i, label in enumerate(labels):
+            if label:
+                by_label.setdefault(label, []).append(i)
+        for label, rows in by_label.items():
+            layer = self._topo_layers.get(label)
+            if layer is None:
+                if delete:
+                    continue
+                with self._topo_lock:
+                    layer = self._topo_layers.setdefault(label, GraphStore(track_in=True))
+            if delete:
+                layer.delete_edges([src[i] for i in rows], [dst[i] for i in rows])
+            else:
+                layer.add_edges([src[i] for i in rows], [dst[i] for i in rows],
+                                [weights[i] for i in rows] if weights is not None else None)
+    
+    def topology(self, label: Optional[str] = None) -> Tuple[GraphView, List[str]]:
+        """
+        Immutable view of the graph's edges in the native store
+        
+        Waits for queued edge updates (read-your-writes), then pins the
+        current version. Readers of the view never block writers. Node n of
+        the view is names[n]; IDs of deleted nodes stay allocated. Node IDs
+        are shared by all labels, so views of several labels can be combined.
+        
+        Args:
+            label: Only edges with this label (see edge_labels); None for all
+        
+        Returns:
+            (view, names) - release the view (or use it in a with block)
+            when done
+        
+        Example:
+            view, names = graph.topology()
+            with view:
+                out = [names[n] for n in view.neighbors(names.index("A"))]
+        """
+        view = self.topology_view(label)
+        with self._topo_lock:
+            names = list(self._topo_names)
+        return view, names
+    
+    def topology_view(self, label: Optional[str] = None) -> GraphView:
+        """
+        Like topology(), without copying the node names
+        
+        For readers that only touch a few nodes: map them with
+        topology_id and topology_names instead.
+        """
+        if label is None:
+            store = self._topo
+        elif label in self._topo_layers:
+            store = self._topo_layers[label]
+        else:
+            raise KeyError(f"No edges labeled {label!r}")
+        store.flush()
+        return store.view()
+    
+    def topology_names(self, ids: List[int]) -> List[str]:
+        """Node IDs of some topology() view node numbers"""
+        with self._topo_lock:
+            return [self._topo_names[i] for i in ids]
+    
+    def edge_labels(self) -> List[str]:
+        """Edge labels with a layer in the topology mirror"""
+        return sorted(self._topo_layers)
+    
+    def topology_id(self, node_id: str, allocate: bool = False) -> Optional[int]:
+        """
+        Integer ID of a node in topology() views
+        
+        Args:
+            allocate: Assign an ID to a node that was never linked (it has
+                no edges in any view)
+        
+        Returns:
+            The ID, or None if the node was never linked and allocate is False
+        """
+        if allocate:
+            return self._topo_id(node_id)
+        return self._topo_ids.get(node_id)
+    
+    # ========================================================================
+    # Read Views
+    # ========================================================================
+    
+    @contextmanager
+    def snapshot(self):
+        """
+        Pin a consistent point-in-time view for reads on the calling thread
+        
+        Inside the block every read method (get_node, get_neighbors,
+        get_all_edges, ...) sees the graph as it was on entry, while other
+        threads keep writing without blocking. Nested blocks reuse the outer
+        view. Mutations made inside the block are not visible to its reads.
+        
+        Example:
+            with graph.snapshot():
+                edges = graph.get_all_edges()
+                data = [graph.get_edge(f, t) for f, t, _ in edges]
+        """
+        if getattr(self._local, 'snapshot', None) is not None:
+            yield self._local.snapshot
+            return
+        
+        snap = self.db.snapshot()
+        self._local.snapshot = snap
+        try:
+            yield snap
+        finally:
+            self._local.snapshot = None
+            snap.release()
+    
+    @property
+    def temporal(self) -> bool:
+        """True if past versions are kept (see as_of)"""
+        return self.db.history_enabled
+    
+    def version(self) -> int:
+        """Version of the latest committed change (pass it to as_of later)"""
+        return self.db.version()
+    
+    @contextmanager
+    def as_of(self, version: Optional[int] = None,
+              timestamp: Optional[Union[int, str, datetime]] = None):
+        """
+        Pin a past state of a temporal graph for reads on the calling thread
+        
+        Works like snapshot(): inside the block every read and traversal
+        (get_node, get_neighbors, bfs, shortest_path, export_to_json, ...)
+        sees the graph as of the given version or time. Give exactly one of
+        version or timestamp.
+        
+        Args:
+            version: A value returned by version()
+            timestamp: Unix milliseconds, ISO-8601 string or datetime (naive
+                values are UTC); the last version committed by then is used
+            
+        Raises:
+            ValueError: If the graph is not temporal, or the version or time
+                is outside the retained history
+        
+        Example:
+            v = graph.version()
+            graph.delete_node("A")
+            with graph.as_of(v):
+                graph.get_node("A")   # still there
+        """
+        if (version is None) == (timestamp is None):
+            raise ValueError("Give exactly one of version or timestamp")
+        if not self.temporal:
+            raise ValueError("Graph was not created with temporal=True")
+        if timestamp is not None:
+            ms = timestamp if isinstance(timestamp, int) else to_ms(timestamp)
+            version = self.db.version_at(ms)
+            if version == 0:
+                raise ValueError(f"No history at {timestamp}")
+        
+        snap = self.db.snapshot_at(version)
+        outer = getattr(self._local, 'snapshot', None)
+        self._local.snapshot = snap
+        try:
+            yield snap
+        finally:
+            self._local.snapshot = outer
+            snap.release()
+    
+    def compact_history(self, retain_seconds: Optional[float] = None,
+                        before_version: Optional[int] = None) -> int:
+        """
+        Drop history past the retention window of a temporal graph
+        
+        Args:
+            retain_seconds: Keep versions from this many seconds back on
+            before_version: Or: drop versions older than this one
+            
+        Returns:
+            Number of stored versions freed
+        """
+        if before_version is None:
+            if retain_seconds is None:
+                raise ValueError("Give retain_seconds or before_version")
+            before_version = self.db.version_at(int((time.time() - retain_seconds) * 1000))
+            if before_version == 0:
+                return 0
+        return self.db.compact(before_version)
+    
+    def _reader(self):
+        """Pinned snapshot for this thread, or the live database"""
+        snap = getattr(self._local, 'snapshot', None)
+        return snap if snap is not None else self.db
+    
     # ========================================================================
     # Node Operations
     # ========================================================================
@@ -66,6 +343,8 @@ class GraphDB:
         # Store node data
         node_data = data or {}
         self.db.set(key, json.dumps(node_data))
+        if self._counted:
+            self._count_change(None, node_data)
         
         # Initialize empty adjacency list
         self.db.set(f"adj:{node_id}", "[]")
@@ -90,6 +369,8 @@ class GraphDB:
         
         if not self.db.exists(key):
             return False
+        if self._counted:
+            self._count_change(json.loads(self.db.get(key) or "{}"), None)
         
         # Remove all edges to/from this node
         edges_to_remove = []
@@ -101,8 +382,12 @@ class GraphDB:
                     if from_node == node_id or to_node == node_id:
                         edges_to_remove.append(edge_key)
         
+        labels = [json.loads(data).get("label", "") if data else ""
+                  for data in self.db.mget(edges_to_remove)]
         for edge_key in edges_to_remove:
             self.db.delete(edge_key)
+        self._topo_push([tuple(k.split(":")[1:3]) for k in edges_to_remove], delete=True,
+                        labels=labels)
         
         # Remove from adjacency lists
         for adj_key in self.db.keys():
@@ -132,7 +417,7 @@ class GraphDB:
             Dictionary of node attributes including 'id', or None if not found
         """
         key = f"node:{node_id}"
-        data = self.db.get(key)
+        data = self._reader().get(key)
         
         if data:
             node_data = json.loads(data)
@@ -143,6 +428,16 @@ class GraphDB:
             }
         return None
     
+    def get_nodes(self, node_ids: List[str]) -> List[Optional[Dict[str, Any]]]:
+        """
+        Data of several nodes in one batched lookup
+        
+        Returns:
+            One data dict per node id, in order (None for unknown nodes)
+        """
+        raw = self._reader().mget([f"node:{node_id}" for node_id in node_ids])
+        return [json.loads(data) if data else None for data in raw]
+    
     def update_node(self, node_id: str, data: Dict[str, Any]) -> bool:
         """
         Update node data
@@ -159,22 +454,107 @@ class GraphDB:
         if not self.db.exists(key):
             return False
         
+        if self._counted:
+            self._count_change(json.loads(self.db.get(key) or "{}"), data)
         self.db.set(key, json.dumps(data))
         return True
     
     def node_exists(self, node_id: str) -> bool:
         """Check if node exists"""
-        return self.db.exists(f"node:{node_id}")
+        return self._reader().exists(f"node:{node_id}")
     
     def get_all_nodes(self) -> List[str]:
         """Get list of all node IDs"""
         nodes = []
-        for key in self.db.keys():
+        for key in self._reader().keys():
             if key.startswith("node:"):
                 node_id = key[5:]  # Remove "node:" prefix
                 nodes.append(node_id)
         return sorted(nodes)
     
+    # ========================================================================
+    # Value Counters
+    # ========================================================================
+    
+    def count_values(self, field: str):
+        """
+        Keep a count of nodes per value of a node data field
+        
+        From then on add_node, update_node, delete_node and the importers
+        update the counts as they write, so value_counts is one lookup. The
+        counts are stored with the graph: snapshot() and as_of() reads see
+        the counts of their version. The first call counts existing nodes.
+        """
+        if field in self._counted:
+            return
+        counts: Dict[str, List[int]] = {}
+        keys = [key for key in self.db.keys() if key.startswith("node:")]
+        for raw in self.db.mget(keys):
+            value = json.loads(raw).get(field) if raw else None
+            if value is not None:
+                counts.setdefault(str(value), [0, 0])[0] += 1
+        self.db.set(f"__meta__:counts:{field}", json.dumps(counts))
+        self._counted += (field,)
+    
+    def _counters(self, field: str) -> Dict[str, List[int]]:
+        if field not in self._counted:
+            raise KeyError(f"Values of {field!r} are not counted")
+        raw = self._reader().get(f"__meta__:counts:{field}")
+        return json.loads(raw) if raw else {}
+    
+    def value_counts(self, field: str) -> Dict[str, int]:
+        """
+        Nodes per value of a field registered with count_values
+        
+        Raises:
+            KeyError: If the field is not counted
+        """
+        return {value: count for value, (count, _) in self._counters(field).items() if count}
+    
+    def value_writes(self, field: str) -> Dict[str, int]:
+        """
+        Per value of a counted field, how many node writes (add, update,
+        delete) touched a node with it since counting began
+        
+        A cheap change detector for caches built over one kind of node:
+        the number moves only when such a node is written.
+        
+        Raises:
+            KeyError: If the field is not counted
+        """
+        return {value: writes for value, (_, writes) in self._counters(field).items()}
+    
+    def _counter_writes(self, changes: List[Tuple[Optional[Dict[str, Any]],
+                                                  Optional[Dict[str, Any]]]]) -> List[Tuple[str, str]]:
+        """Counter records after moving nodes' counted values from old to new data"""
+        writes = []
+        for field in self._counted:
+            key = f"__meta__:counts:{field}"
+            counts = None
+            for old, new in changes:
+                before = old.get(field) if old else None
+                after = new.get(field) if new else None
+                if before is None and after is None:
+                    continue
+                if counts is None:
+                    counts = json.loads(self.db.get(key) or "{}")
+                if before is not None:
+                    entry = counts.setdefault(str(before), [0, 0])
+                    entry[0] = max(entry[0] - 1, 0)
+                    entry[1] += 1
+                if after is not None:
+                    entry = counts.setdefault(str(after), [0, 0])
+                    entry[0] += 1
+                    entry[1] += before != after
+            if counts is not None:
+                writes.append((key, json.dumps(counts)))
+        return writes
+    
+    def _count_change(self, old: Optional[Dict[str, Any]], new: Optional[Dict[str, Any]]):
+        """Move a node's counted values from old data to new data"""
+        for key, value in self._counter_writes([(old, new)]):
+            self.db.set(key, value)
+    
     # ========================================================================
     # Edge Operations
     # ========================================================================
@@ -193,11 +573,13 @@ class GraphDB:
             True if edge was added, False otherwise
         """
         # Ensure both nodes exist
-        if not self.node_exists(from_node) or not self.node_exists(to_node):
+        if not self.db.exists(f"node:{from_node}") or not self.db.exists(f"node:{to_node}"):
             return False
         
         # Add edge
         edge_key = f"edge:{from_node}:{to_node}"
+        old = self.db.get(edge_key)
+        old_label = json.loads(old).get("label", "") if old else ""
         edge_data = {}
         if self.weighted:
             edge_data["weight"] = weight
@@ -230,12 +612,92 @@ class GraphDB:
             adj_list_reverse.append(reverse_edge_info)
             self.db.set(f"adj:{to_node}", json.dumps(adj_list_reverse))
         
+        if old_label and old_label != label:
+            self._topo_push([(from_node, to_node)], delete=True, labels=[old_label],
+                            layers_only=True)
+        self._topo_push([(from_node, to_node)], [weight], labels=[label])
+        
         # Update edge count
         count = int(self.db.get("__meta__:edge_count") or "0")
         self.db.set("__meta__:edge_count", str(count + 1))
         
         return True
     
+    def add_edges(self, edges: List[Tuple]) -> int:
+        """
+        Add many edges at once
+        
+        Equivalent to add_edge per tuple, but endpoints and old adjacency
+        lists are read in batched lookups, each touched adjacency list is
+        rewritten once, and the topology mirror gets one bulk push.
+        
+        Args:
+            edges: (from_node, to_node[, weight[, label]]) tuples
+            
+        Returns:
+            Number of new edges (edges with a missing endpoint are skipped)
+        """
+        edges = [tuple(e) + (1.0, "")[len(e) - 2:] for e in edges]
+        endpoints = list({n for e in edges for n in e[:2]})
+        found = self.db.mget([f"node:{n}" for n in endpoints])
+        present = {n for n, data in zip(endpoints, found) if data is not None}
+        
+        # Last write per directed pair wins, as with repeated add_edge calls
+        latest: Dict[Tuple[str, str], Tuple[float, str]] = {}
+        for from_node, to_node, weight, label in edges:
+            if from_node not in present or to_node not in present:
+                continue
+            latest.pop((from_node, to_node), None)
+            latest[(from_node, to_node)] = (weight, label)
+            if not self.directed:
+                latest.pop((to_node, from_node), None)
+                latest[(to_node, from_node)] = (weight, label)
+        if not latest:
+            return 0
+        
+        existing = self.db.mget([f"edge:{f}:{t}" for f, t in latest])
+        added = set()
+        relabeled: Dict[Tuple[str, str], str] = {}
+        by_source: Dict[str, Dict[str, Dict[str, Any]]] = {}
+        for ((from_node, to_node), (weight, label)), old in zip(latest.items(), existing):
+            if old is None:
+                added.add((from_node, to_node) if self.directed else frozenset((from_node, to_node)))
+            else:
+                old_label = json.loads(old).get("label", "")
+                if old_label and old_label != label:
+                    relabeled[(from_node, to_node)] = old_label
+            
+            edge_data = {}
+            if self.weighted:
+                edge_data["weight"] = weight
+            if label:
+                edge_data["label"] = label
+            self.db.set(f"edge:{from_node}:{to_node}", json.dumps(edge_data))
+            
+            edge_info = {"to": to_node}
+            if self.weighted:
+                edge_info["weight"] = weight
+            by_source.setdefault(from_node, {})[to_node] = edge_info
+        
+        # One adjacency rewrite per source node
+        sources = list(by_source)
+        for from_node, adj in zip(sources, self.db.mget([f"adj:{f}" for f in sources])):
+            updates = by_source[from_node]
+            adj_list = [e for e in json.loads(adj or "[]") if e.get('to') not in updates]
+            adj_list.extend(updates.values())
+            self.db.set(f"adj:{from_node}", json.dumps(adj_list))
+        
+        if relabeled:
+            self._topo_apply(list(relabeled), delete=True, labels=list(relabeled.values()),
+                             layers_only=True)
+        self._topo_apply(list(latest), [w for w, _ in latest.values()],
+                         labels=[label for _, label in latest.values()])
+        
+        count = int(self.db.get("__meta__:edge_count") or "0")
+        self.db.set("__meta__:edge_count", str(count + len(added)))
+        
+        return len(added)
+    
     def delete_edge(self, from_node: str, to_node: str) -> bool:
         """
         Delete an edge
@@ -249,7 +711,8 @@ class GraphDB:
         """
         edge_key = f"edge:{from_node}:{to_node}"
         
-        if not self.db.exists(edge_key):
+        old = self.db.get(edge_key)
+        if old is None:
             return False
         
         # Delete edge
@@ -269,6 +732,9 @@ class GraphDB:
             adj_list_reverse = [e for e in adj_list_reverse if e.get('to') != from_node]
             self.db.set(f"adj:{to_node}", json.dumps(adj_list_reverse))
         
+        self._topo_push([(from_node, to_node)], delete=True,
+                        labels=[json.loads(old).get("label", "")])
+        
         # Update edge count
         count = int(self.db.get("__meta__:edge_count") or "0")
         self.db.set("__meta__:edge_count", str(max(0, count - 1)))
@@ -278,7 +744,7 @@ class GraphDB:
     def get_edge(self, from_node: str, to_node: str) -> Optional[Dict[str, Any]]:
         """Get edge data"""
         edge_key = f"edge:{from_node}:{to_node}"
-        data = self.db.get(edge_key)
+        data = self._reader().get(edge_key)
         
         if data:
             return json.loads(data)
@@ -286,7 +752,7 @@ class GraphDB:
     
     def edge_exists(self, from_node: str, to_node: str) -> bool:
         """Check if edge exists"""
-        return self.db.exists(f"edge:{from_node}:{to_node}")
+        return self._reader().exists(f"edge:{from_node}:{to_node}")
     
     def get_neighbors(self, node_id: str) -> List[Dict[str, Any]]:
         """
@@ -295,11 +761,21 @@ class GraphDB:
         Returns:
             List of dictionaries with 'to' and optionally 'weight'
         """
-        adj_list = self.db.get(f"adj:{node_id}")
+        adj_list = self._reader().get(f"adj:{node_id}")
         if adj_list:
             return json.loads(adj_list)
         return []
     
+    def get_neighbors_many(self, node_ids: List[str]) -> List[List[Dict[str, Any]]]:
+        """
+        Adjacency lists of several nodes in one batched lookup
+        
+        Returns:
+            One neighbor list per node id, in order ([] for unknown nodes)
+        """
+        raw = self._reader().mget([f"adj:{node_id}" for node_id in node_ids])
+        return [json.loads(adj) if adj else [] for adj in raw]
+    
     def get_all_edges(self) -> List[Tuple[str, str, Optional[float]]]:
         """
         Get all edges in the graph
@@ -310,22 +786,22 @@ class GraphDB:
         edges = []
         seen = set()
         
-        for key in self.db.keys():
-            if key.startswith("edge:"):
-                parts = key.split(":")
-                if len(parts) >= 3:
-                    from_node, to_node = parts[1], parts[2]
-                    
-                    # For undirected graphs, avoid duplicates
-                    if not self.directed:
-                        edge_tuple = tuple(sorted([from_node, to_node]))
-                        if edge_tuple in seen:
-                            continue
-                        seen.add(edge_tuple)
-                    
-                    edge_data = json.loads(self.db.get(key))
-                    weight = edge_data.get("weight") if self.weighted else None
-                    edges.append((from_node, to_node, weight))
+        # Pairs come from the adjacency lists: node IDs may contain ':'
+        with self.snapshot() as view:
+            node_ids = [key[5:] for key in view.keys() if key.startswith("node:")]
+            pairs = self._edge_pairs(view, node_ids)
+            for (from_node, to_node), raw in zip(
+                    pairs, view.mget([f"edge:{f}:{t}" for f, t in pairs])):
+                # For undirected graphs, avoid duplicates
+                if not self.directed:
+                    edge_tuple = tuple(sorted([from_node, to_node]))
+                    if edge_tuple in seen:
+                        continue
+                    seen.add(edge_tuple)
+                
+                edge_data = json.loads(raw or "{}")
+                weight = edge_data.get("weight") if self.weighted else None
+                edges.append((from_node, to_node, weight))
         
         return edges
     
@@ -352,35 +828,38 @@ class GraphDB:
             return {"visited": [], "found": False, "path": [], "distances": {}}
         
         visited = []
-        queue = deque([start_node])
+        frontier = [start_node]
         visited_set = {start_node}
         parent = {start_node: None}
         distances = {start_node: 0}
         
-        while queue:
-            current = queue.popleft()
-            visited.append(current)
-            
-            # Check if we found the target
-            if target_node and current == target_node:
-                path = self._reconstruct_path(parent, start_node, target_node)
-                return {
-                    "visited": visited,
-                    "found": True,
-                    "path": path,
-                    "distances": distances
-                }
-            
-            # Visit neighbors
-            neighbors = self.get_neighbors(current)
-            for neighbor_info in neighbors:
-                neighbor = neighbor_info['to']
+        # Level-synchronous: the whole frontier's adjacency lists are fetched
+        # in one batched lookup, then expanded in FIFO order.
+        while frontier:
+            next_frontier = []
+            for current, neighbors in zip(frontier, self.get_neighbors_many(frontier)):
+                visited.append(current)
                 
-                if neighbor not in visited_set:
-                    visited_set.add(neighbor)
-                    queue.append(neighbor)
-                    parent[neighbor] = current
-                    distances[neighbor] = distances[current] + 1
+                # Check if we found the target
+                if target_node and current == target_node:
+                    path = self._reconstruct_path(parent, start_node, target_node)
+                    return {
+                        "visited": visited,
+                        "found": True,
+                        "path": path,
+                        "distances": distances
+                    }
+                
+                # Visit neighbors
+                for neighbor_info in neighbors:
+                    neighbor = neighbor_info['to']
+                    
+                    if neighbor not in visited_set:
+                        visited_set.add(neighbor)
+                        next_frontier.append(neighbor)
+                        parent[neighbor] = current
+                        distances[neighbor] = distances[current] + 1
+            frontier = next_frontier
         
         # Build path if target was specified
         path = []
@@ -592,12 +1071,18 @@ class GraphDB:
         """
         out_degree = len(self.get_neighbors(node_id))
         
-        # Count in-degree
-        in_degree = 0
-        for node in self.get_all_nodes():
-            neighbors = self.get_neighbors(node)
-            if any(n['to'] == node_id for n in neighbors):
-                in_degree += 1
+        # Count in-degree: reverse lists of the topology mirror, unless a
+        # pinned snapshot asks for its own point in time
+        if getattr(self._local, 'snapshot', None) is None:
+            view, _ = self.topology()
+            with view:
+                idx = self.topology_id(node_id)
+                in_degree = len(view.in_neighbors(idx)) if idx is not None else 0
+        else:
+            in_degree = 0
+            for neighbors in self.get_neighbors_many(self.get_all_nodes()):
+                if any(n['to'] == node_id for n in neighbors):
+                    in_degree += 1
         
         return {
             "in_degree": in_degree,
@@ -605,11 +1090,221 @@ class GraphDB:
             "total": in_degree + out_degree
         }
     
+    # ========================================================================
+    # Diff Import
+    # ========================================================================
+    
+    def _edge_pairs(self, view, node_ids: List[str]) -> List[Tuple[str, str]]:
+        """(from, to) of every edge leaving node_ids, from their adjacency lists"""
+        pairs = []
+        for node_id, adj in zip(node_ids, view.mget([f"adj:{n}" for n in node_ids])):
+            pairs.extend((node_id, e['to']) for e in json.loads(adj or "[]"))
+        return pairs
+    
+    def import_diff(self, nodes: Dict[str, Optional[Dict[str, Any]]], edges: List[Tuple],
+                    owned: Optional[Callable[[str, Dict[str, Any]], bool]] = None
+                    ) -> Dict[str, int]:
+        """
+        Make the graph match incoming data, writing only the difference
+        
+        The current nodes, adjacency lists and edge payloads are read from
+        one snapshot in batched lookups and compared with the incoming
+        ones: payloads by their JSON (a node whose data only differs in
+        key order is unchanged), edge sets by (from, to) pair. Only added,
+        changed and removed records are written, as ONE atomic batch
+        (SimpleDB.apply): readers see the old graph or the new one, never
+        a mix. Untouched nodes keep their counters' write counts and
+        untouched edge layers keep their topology versions, so caches
+        keyed on them stay warm; an identical re-import writes nothing.
+        
+        The batch is only applied if nothing else committed since the
+        snapshot the diff was computed from (SimpleDB.apply_if); otherwise
+        the diff is recomputed from a fresh snapshot. The topology mirror
+        is updated after the batch lands, not as part of it, so topology()
+        and in-degrees can briefly show the graph from before the import.
+        
+        Args:
+            nodes: node id -> data; None keeps an existing node's data
+                ({} for a new node)
+            edges: (from_node, to_node[, weight[, label]]) tuples; the last
+                one per pair wins, edges with an endpoint that is neither
+                imported nor kept are skipped
+            owned: Which existing nodes the import replaces (default: all).
+                Owned nodes missing from nodes are deleted. Edges leaving
+                an owned or imported node are replaced by the incoming
+                ones; other edges are kept unless an endpoint is deleted.
+        
+        Returns:
+            Counts of nodes and edges added, updated, deleted and unchanged
+        
+        Raises:
+            MemoryError: If the batch could not be applied
+            RuntimeError: If other writers kept committing between the
+                diff and its batch on every attempt
+        """
+        edges = [tuple(e) + (1.0, "")[len(e) - 2:] for e in edges]
+        for _ in range(_IMPORT_ATTEMPTS):
+            version, writes, stats, mirror = self._plan_diff(nodes, edges, owned)
+            if not writes or self.db.apply_if(version, writes):
+                break
+        else:
+            raise RuntimeError("Graph changed during import on every attempt")
+        
+        for pairs, options in mirror:
+            self._topo_apply(pairs, **options)
+        return stats
+    
+    def _plan_diff(self, nodes: Dict[str, Optional[Dict[str, Any]]], edges: List[Tuple],
+                   owned: Optional[Callable[[str, Dict[str, Any]], bool]]):
+        """
+        import_diff's writes, from one snapshot
+        
+        The snapshot is always fresh: a view the caller pinned with
+        snapshot() predates its own writes, and a diff planned from it
+        would never pass apply_if.
+        
+        Returns:
+            (snapshot version, batch, stats, topology mirror calls as
+            (pairs, _topo_apply options))
+        """
+        with self.db.snapshot() as view:
+            version = view.version
+            current_ids = [key[5:] for key in view.keys() if key.startswith("node:")]
+            current_raw = dict(zip(current_ids, view.mget([f"node:{n}" for n in current_ids])))
+            pairs = self._edge_pairs(view, current_ids)
+            current_edges = {
+                pair: (data.get("weight") if self.weighted else None, data.get("label", ""))
+                for pair, data in zip(pairs, (json.loads(raw or "{}") for raw in view.mget(
+                    [f"edge:{f}:{t}" for f, t in pairs])))
+            }
+            adj_raw = dict(zip(current_ids, view.mget([f"adj:{n}" for n in current_ids])))
+        
+        stats = dict.fromkeys(("nodes_added", "nodes_updated", "nodes_deleted", "nodes_unchanged",
+                               "edges_added", "edges_updated", "edges_deleted",
+                               "edges_unchanged"), 0)
+        writes: List[Tuple[str, Optional[str]]] = []
+        changes: List[Tuple[Optional[Dict[str, Any]], Optional[Dict[str, Any]]]] = []
+        
+        # Nodes: compare payloads, delete owned nodes that are not imported
+        managed = set(nodes)
+        deleted = set()
+        for node_id in current_ids:
+            if node_id in nodes:
+                continue
+            old = json.loads(current_raw[node_id])
+            if owned is None or owned(node_id, old):
+                managed.add(node_id)
+                deleted.add(node_id)
+                changes.append((old, None))
+                writes += [(f"node:{node_id}", None), (f"adj:{node_id}", None)]
+        for node_id, data in nodes.items():
+            raw = current_raw.get(node_id)
+            if raw is None:
+                stats["nodes_added"] += 1
+                changes.append((None, data or {}))
+                writes.append((f"node:{node_id}", json.dumps(data or {})))
+            elif data is None or raw == json.dumps(data) or json.loads(raw) == data:
+                stats["nodes_unchanged"] += 1
+            else:
+                stats["nodes_updated"] += 1
+                changes.append((json.loads(raw), data))
+                writes.append((f"node:{node_id}", json.dumps(data)))
+        stats["nodes_deleted"] = len(deleted)
+        final_nodes = (set(current_ids) - deleted) | set(nodes)
+        
+        # Edges: kept ones plus incoming ones, last write per pair wins
+        target: Dict[Tuple[str, str], Tuple[Optional[float], str]] = {}
+        for (f, t), payload in current_edges.items():
+            replaced = f in managed or (not self.directed and t in managed)
+            if not replaced and f in final_nodes and t in final_nodes:
+                target[(f, t)] = payload
+        for from_node, to_node, weight, label in edges:
+            if from_node not in final_nodes or to_node not in final_nodes:
+                continue
+            payload = (weight if self.weighted else None, label)
+            target[(from_node, to_node)] = payload
+            if not self.directed:
+                target[(to_node, from_node)] = payload
+        
+        added = [pair for pair in target if pair not in current_edges]
+        updated = [pair for pair in target
+                   if pair in current_edges and current_edges[pair] != target[pair]]
+        removed = [pair for pair in current_edges if pair not in target]
+        
+        for f, t in added + updated:
+            weight, label = target[(f, t)]
+            edge_data = {}
+            if self.weighted:
+                edge_data["weight"] = weight
+            if label:
+                edge_data["label"] = label
+            writes.append((f"edge:{f}:{t}", json.dumps(edge_data)))
+        writes += [(f"edge:{f}:{t}", None) for f, t in removed]
+        
+        # One adjacency rewrite per surviving source whose edges changed
+        touched: Dict[str, List[Tuple[str, str]]] = {}
+        for pair in added + updated + removed:
+            touched.setdefault(pair[0], [])
+        for node_id in set(nodes) - set(current_raw):
+            touched.setdefault(node_id, [])
+        for from_node in touched:
+            if from_node in deleted:
+                continue
+            adj_list = []
+            listed = set()
+            for entry in json.loads(adj_raw.get(from_node) or "[]"):
+                if (from_node, entry['to']) in target:
+                    listed.add(entry['to'])
+                    adj_list.append(entry)
+            for f, t in added:
+                if f == from_node and t not in listed:
+                    adj_list.append({"to": t})
+            for entry in adj_list:
+                if self.weighted:
+                    entry["weight"] = target[(from_node, entry['to'])][0]
+            writes.append((f"adj:{from_node}", json.dumps(adj_list)))
+        
+        if self.directed:
+            edge_count = len(target)
+            stats["edges_added"], stats["edges_updated"] = len(added), len(updated)
+            stats["edges_deleted"] = len(removed)
+        else:
+            def logical(pairs):
+                return len({frozenset(p) for p in pairs})
+            edge_count = logical(target)
+            stats["edges_added"], stats["edges_updated"] = logical(added), logical(updated)
+            stats["edges_deleted"] = logical(removed)
+        stats["edges_unchanged"] = edge_count - stats["edges_added"] - stats["edges_updated"]
+        
+        if writes:
+            writes += self._counter_writes(changes) if self._counted else []
+            writes += [("__meta__:node_count", str(len(final_nodes))),
+                       ("__meta__:edge_count", str(edge_count))]
+        
+        # Topology mirror: drop removed edges and stale labels, push the rest
+        mirror: List[Tuple[List[Tuple[str, str]], Dict[str, Any]]] = []
+        if removed:
+            mirror.append((removed, {"delete": True,
+                                     "labels": [current_edges[p][1] for p in removed]}))
+        relabeled = [p for p in updated
+                     if current_edges[p][1] and current_edges[p][1] != target[p][1]]
+        if relabeled:
+            mirror.append((relabeled, {"delete": True, "layers_only": True,
+                                       "labels": [current_edges[p][1] for p in relabeled]}))
+        if added or updated:
+            pushed = added + updated
+            mirror.append((pushed, {
+                "weights": [target[p][0] if self.weighted else 1.0 for p in pushed],
+                "labels": [target[p][1] for p in pushed],
+            }))
+        
+        return version, writes, stats, mirror
+    
     # ========================================================================
     # Import/Export Operations
     # ========================================================================
     
-    def import_from_json(self, json_str: str) -> bool:
+    def import_from_json(self, json_str: str, diff: bool = False) -> bool:
         """
         Import graph from JSON format
         
@@ -622,32 +1317,48 @@ class GraphDB:
                 {"id": "B", "data": {"label": "Node B"}}
             ],
             "edges": [
-                {"from": "A", "to": "B", "weight": 1.0}
+                {"from": "A", "to": "B", "weight": 1.0, "label": "knows"}
             ]
         }
+        
+        Args:
+            json_str: Graph in the format above
+            diff: Write only what differs from the current graph (see
+                import_diff) instead of clearing it and loading everything;
+                a graph whose directed/weighted flags change is reloaded
         """
         try:
             graph_data = json.loads(json_str)
+            directed = graph_data.get("directed", True)
+            weighted = graph_data.get("weighted", False)
+            nodes = {node["id"]: node.get("data", {}) for node in graph_data.get("nodes", [])}
+            edges = [
+                (edge["from"], edge["to"], edge.get("weight", 1.0), edge.get("label", ""))
+                for edge in graph_data.get("edges", [])
+            ]
+            
+            if diff and (directed, weighted) == (self.directed, self.weighted):
+                self.import_diff(nodes, edges)
+                return True
             
             # Clear existing graph
             self.db.clear()
+            self._reset_topology()
             
             # Set metadata
-            self.directed = graph_data.get("directed", True)
-            self.weighted = graph_data.get("weighted", False)
+            self.directed = directed
+            self.weighted = weighted
             self.db.set("__meta__:directed", str(self.directed))
             self.db.set("__meta__:weighted", str(self.weighted))
             self.db.set("__meta__:node_count", "0")
             self.db.set("__meta__:edge_count", "0")
             
             # Import nodes
-            for node in graph_data.get("nodes", []):
-                self.add_node(node["id"], node.get("data", {}))
+            for node_id, data in nodes.items():
+                self.add_node(node_id, data)
             
             # Import edges
-            for edge in graph_data.get("edges", []):
-                weight = edge.get("weight", 1.0)
-                self.add_edge(edge["from"], edge["to"], weight)
+            self.add_edges(edges)
             
             return True
             
@@ -657,7 +1368,7 @@ class GraphDB:
     
     def export_to_json(self, pretty: bool = True) -> str:
         """
-        Export graph to JSON format
+        Export graph to JSON format (the format import_from_json reads)
         
         Args:
             pretty: Pretty print JSON
@@ -665,20 +1376,30 @@ class GraphDB:
         Returns:
             JSON string representation of the graph
         """
-        nodes = []
-        for node_id in self.get_all_nodes():
-            node_data = self.get_node(node_id)
-            nodes.append({
-                "id": node_id,
-                "data": node_data
-            })
-        
-        edges = []
-        for from_node, to_node, weight in self.get_all_edges():
-            edge = {"from": from_node, "to": to_node}
-            if self.weighted and weight is not None:
-                edge["weight"] = weight
-            edges.append(edge)
+        # Nodes and edges come from one point-in-time view, so concurrent
+        # writers can never produce an edge whose endpoint is missing.
+        with self.snapshot() as view:
+            node_ids = self.get_all_nodes()
+            nodes = [{"id": node_id, "data": data}
+                     for node_id, data in zip(node_ids, self.get_nodes(node_ids))]
+            
+            pairs = self._edge_pairs(view, node_ids)
+            seen = set()
+            edges = []
+            for (from_node, to_node), raw in zip(
+                    pairs, view.mget([f"edge:{f}:{t}" for f, t in pairs])):
+                # For undirected graphs, export each edge once
+                if not self.directed:
+                    if frozenset((from_node, to_node)) in seen:
+                        continue
+                    seen.add(frozenset((from_node, to_node)))
+                edge_data = json.loads(raw or "{}")
+                edge = {"from": from_node, "to": to_node}
+                if self.weighted and "weight" in edge_data:
+                    edge["weight"] = edge_data["weight"]
+                if edge_data.get("label"):
+                    edge["label"] = edge_data["label"]
+                edges.append(edge)
         
         graph_data = {
             "directed": self.directed,
@@ -691,7 +1412,7 @@ class GraphDB:
             return json.dumps(graph_data, indent=2)
         return json.dumps(graph_data)
     
-    def import_from_adjacency_list(self, text: str) -> bool:
+    def import_from_adjacency_list(self, text: str, diff: bool = False) -> bool:
         """
         Import graph from adjacency list format
         
@@ -702,17 +1423,18 @@ class GraphDB:
         
         For weighted graphs:
         A -> B(1.5), C(2.0)
+        
+        Args:
+            text: Graph in the format above
+            diff: Write only what differs from the current graph (see
+                import_diff); nodes that stay keep their data
         """
         try:
-            self.db.clear()
-            self.db.set("__meta__:directed", str(self.directed))
-            self.db.set("__meta__:weighted", str(self.weighted))
-            self.db.set("__meta__:node_count", "0")
-            self.db.set("__meta__:edge_count", "0")
-            
-            lines = text.strip().split('\n')
+            # Nodes in order of appearance; the format carries no node data
+            nodes: Dict[str, Optional[Dict[str, Any]]] = {}
+            edges = []
             
-            for line in lines:
+            for line in text.strip().split('\n'):
                 line = line.strip()
                 if not line or line.startswith('#'):
                     continue
@@ -720,16 +1442,15 @@ class GraphDB:
                 if '->' in line:
                     parts = line.split('->')
                     from_node = parts[0].strip()
-                    
-                    # Add source node
-                    if not self.node_exists(from_node):
-                        self.add_node(from_node)
+                    nodes.setdefault(from_node, None)
                     
                     # Parse destinations
                     if len(parts) > 1:
                         destinations = parts[1].split(',')
                         for dest in destinations:
                             dest = dest.strip()
+                            if not dest:
+                                continue  # "A ->": a node without edges
                             
                             # Parse weighted edge: B(1.5)
                             if '(' in dest and ')' in dest:
@@ -740,13 +1461,23 @@ class GraphDB:
                                 to_node = dest
                                 weight = 1.0
                             
-                            # Add destination node
-                            if not self.node_exists(to_node):
-                                self.add_node(to_node)
-                            
-                            # Add edge
-                            self.add_edge(from_node, to_node, weight)
+                            nodes.setdefault(to_node, None)
+                            edges.append((from_node, to_node, weight))
+            
+            if diff:
+                self.import_diff(nodes, edges)
+                return True
+            
+            self.db.clear()
+            self._reset_topology()
+            self.db.set("__meta__:directed", str(self.directed))
+            self.db.set("__meta__:weighted", str(self.weighted))
+            self.db.set("__meta__:node_count", "0")
+            self.db.set("__meta__:edge_count", "0")
             
+            for node_id in nodes:
+                self.add_node(node_id)
+            self.add_edges(edges)
             return True
             
         except Exception as e:
@@ -786,12 +1517,13 @@ class GraphDB:
     
     def get_stats(self) -> Dict[str, Any]:
         """Get graph statistics"""
+        view = self._reader()
         return {
-            "nodes": int(self.db.get("__meta__:node_count") or "0"),
-            "edges": int(self.db.get("__meta__:edge_count") or "0"),
+            "nodes": int(view.get("__meta__:node_count") or "0"),
+            "edges": int(view.get("__meta__:edge_count") or "0"),
             "directed": self.directed,
             "weighted": self.weighted,
-            "db_entries": self.db.count()
+            "db_entries": view.count()
         }
     
     def __repr__(self):
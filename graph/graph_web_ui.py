@@ -10,6 +10,11 @@ Provides interactive query interface with visualization and actions
 from flask import Flask, render_template, request, jsonify
 from flask_cors import CORS
 from graph_db import GraphDB
+from src.services.pattern_service import PatternService
+from src.services.graph_service import GraphService
+from src.services.centrality_service import CentralityService
+from src.services.walk_service import WalkService
+from src.services.base_service import NodeNotFoundError, ValidationError
 import json
 import os
 import logging
@@ -198,6 +203,52 @@ Respond ONLY with a single line JSON object using double quotes for all keys and
     except Exception as e:
         return jsonify({'error': str(e)}), 500
 
+# --- Pattern Query Endpoint (native subgraph matcher) ---
+@app.route('/api/pattern_query', methods=['POST'])
+def pattern_query():
+    """
+    Match a subgraph pattern, e.g.
+    MATCH (a:Disease)-[:HAS_SYMPTOM]->(s)<-[:HAS_SYMPTOM]-(b:Disease) RETURN a, b, s LIMIT 20
+
+    Body: {"query": "...", "limit": optional row cap, "all_orderings": optional bool}
+    """
+    try:
+        logger.info("POST /api/pattern_query")
+        if not graph:
+            logger.error("Graph not initialized")
+            return jsonify({'error': 'Graph not initialized'}), 400
+
+        data = request.json or {}
+        query = data.get('query', '')
+        if not query:
+            return jsonify({'error': 'No query provided'}), 400
+
+        # limit=0 asks for no rows; only a missing limit falls back to the default
+        limit = data.get('limit')
+        if limit is not None:
+            try:
+                if isinstance(limit, (bool, float)):
+                    raise ValueError(limit)
+                limit = int(limit)
+            except (TypeError, ValueError):
+                limit = -1
+            if limit < 0:
+                return jsonify({'error': 'limit must be a non-negative integer'}), 400
+
+        result = PatternService(graph).query(
+            query,
+            limit=limit,
+            all_orderings=bool(data.get('all_orderings', False)),
+        )
+        logger.info(f"Pattern query returned {len(result.rows)} rows")
+        return jsonify({'query': query, **result.to_dict()})
+    except ValidationError as e:
+        return jsonify({'error': str(e)}), 400
+    except Exception as e:
+        logger.error(f"Error in pattern_query: {str(e)}")
+        logger.error(traceback.format_exc())
+        return jsonify({'error': f'Internal server error: {str(e)}'}), 500
+
 app.config['DEBUG'] = False
 
 # Enable CORS for React frontend and test pages
@@ -293,6 +344,131 @@ def get_stats():
         logger.error(traceback.format_exc())
         return jsonify({'error': f'Internal server error: {str(e)}'}), 500
 
+@app.route('/api/graph/analytics/triangles', methods=['GET'])
+def get_triangle_stats():
+    """
+    Triangle count, transitivity and average clustering coefficient
+
+    Query params: approximate (true/false; default picks by graph size),
+    samples (approximate mode), top (list the N nodes in most triangles)
+    """
+    try:
+        logger.info("GET /api/graph/analytics/triangles")
+        if not graph:
+            logger.error("Graph not initialized")
+            return jsonify({'error': 'Graph not initialized'}), 400
+
+        approximate = request.args.get('approximate')
+        if approximate is not None:
+            approximate = approximate.lower() in ('1', 'true', 'yes')
+        top = request.args.get('top', default=0, type=int)
+        stats = GraphService(graph).get_triangle_stats(
+            per_node=top > 0,
+            approximate=approximate,
+            samples=request.args.get('samples', default=200000, type=int),
+        )
+        result = stats.to_dict()
+        if top > 0:
+            result.pop('per_node', None)
+            result['top_nodes'] = stats.top_nodes(top)
+        logger.info(f"Triangles: {stats.triangles} (approximate={stats.approximate})")
+        return jsonify(result)
+    except ValidationError as e:
+        return jsonify({'error': str(e)}), 400
+    except Exception as e:
+        logger.error(f"Error in get_triangle_stats: {str(e)}")
+        logger.error(traceback.format_exc())
+        return jsonify({'error': f'Internal server error: {str(e)}'}), 500
+
+@app.route('/api/graph/analytics/centrality', methods=['GET'])
+def get_centrality():
+    """
+    Centrality overlay values
+
+    Query params: measure (betweenness | closeness), top (N highest nodes;
+    0 returns every value), nodes (comma-separated, closeness only),
+    approximate (true/false; default picks by graph size), epsilon,
+    ignore_direction (true/false)
+    """
+    try:
+        logger.info("GET /api/graph/analytics/centrality")
+        if not graph:
+            logger.error("Graph not initialized")
+            return jsonify({'error': 'Graph not initialized'}), 400
+
+        def flag(name):
+            value = request.args.get(name)
+            return None if value is None else value.lower() in ('1', 'true', 'yes')
+
+        measure = request.args.get('measure', 'betweenness')
+        ignore_direction = bool(flag('ignore_direction'))
+        service = CentralityService(graph)
+        if measure == 'betweenness':
+            result = service.betweenness(
+                approximate=flag('approximate'),
+                epsilon=request.args.get('epsilon', default=0.01, type=float),
+                ignore_direction=ignore_direction,
+            )
+        elif measure == 'closeness':
+            nodes = request.args.get('nodes')
+            result = service.closeness(
+                nodes=[n for n in nodes.split(',') if n] if nodes else None,
+                ignore_direction=ignore_direction,
+            )
+        else:
+            return jsonify({'error': f'Unknown measure: {measure}'}), 400
+
+        top = request.args.get('top', default=20, type=int)
+        payload = result.to_dict()
+        if top > 0:
+            payload.pop('values')
+            payload['top_nodes'] = result.top_nodes(top)
+        logger.info(f"Centrality {measure}: {len(result.values)} nodes (cached={result.cached})")
+        return jsonify(payload)
+    except ValidationError as e:
+        return jsonify({'error': str(e)}), 400
+    except Exception as e:
+        logger.error(f"Error in get_centrality: {str(e)}")
+        logger.error(traceback.format_exc())
+        return jsonify({'error': f'Internal server error: {str(e)}'}), 500
+
+@app.route('/api/graph/analytics/related', methods=['GET'])
+def get_related():
+    """
+    Related-node suggestions by random walk with restart
+
+    Query params: nodes (comma-separated sources), top (default 10),
+    restart (default 0.15), walks, weighted (true/false, default true),
+    ignore_direction (true/false), p, q (node2vec parameters)
+    """
+    try:
+        logger.info("GET /api/graph/analytics/related")
+        if not graph:
+            logger.error("Graph not initialized")
+            return jsonify({'error': 'Graph not initialized'}), 400
+
+        nodes = [n for n in request.args.get('nodes', '').split(',') if n]
+        result = WalkService(graph).related(
+            nodes,
+            top_k=request.args.get('top', default=10, type=int),
+            restart=request.args.get('restart', default=0.15, type=float),
+            walks=request.args.get('walks', default=WalkService.DEFAULT_WALKS, type=int),
+            weighted=request.args.get('weighted', 'true').lower() in ('1', 'true', 'yes'),
+            ignore_direction=request.args.get('ignore_direction', '').lower() in ('1', 'true', 'yes'),
+            p=request.args.get('p', default=1.0, type=float),
+            q=request.args.get('q', default=1.0, type=float),
+        )
+        logger.info(f"Related to {len(result.sources)} nodes: {len(result.related)} suggestions")
+        return jsonify(result.to_dict())
+    except NodeNotFoundError as e:
+        return jsonify({'error': str(e)}), 404
+    except ValidationError as e:
+        return jsonify({'error': str(e)}), 400
+    except Exception as e:
+        logger.error(f"Error in get_related: {str(e)}")
+        logger.error(traceback.format_exc())
+        return jsonify({'error': f'Internal server error: {str(e)}'}), 500
+
 @app.route('/api/graph/nodes', methods=['GET'])
 def get_all_nodes():
     """Get all nodes"""
@@ -552,6 +728,33 @@ def all_paths():
         logger.error(traceback.format_exc())
         return jsonify({'error': f'Internal server error: {str(e)}'}), 500
 
+@app.route('/api/graph/explain', methods=['POST'])
+def explain_connection():
+    """
+    Smallest subgraph connecting a set of nodes (approximate Steiner tree)
+
+    Body: {"nodes": [...], "weighted": true/false (default: graph's flag)}
+    """
+    try:
+        logger.info("POST /api/graph/explain")
+        if not graph:
+            logger.error("Graph not initialized")
+            return jsonify({'error': 'Graph not initialized'}), 400
+
+        data = request.json or {}
+        result = GraphService(graph).explain_connection(data.get('nodes', []),
+                                                        weighted=data.get('weighted'))
+        logger.info(f"Explained {len(result.terminals)} nodes with {len(result.edges)} edges")
+        return jsonify(result.to_dict())
+    except NodeNotFoundError as e:
+        return jsonify({'error': str(e)}), 404
+    except ValidationError as e:
+        return jsonify({'error': str(e)}), 400
+    except Exception as e:
+        logger.error(f"Error in explain_connection: {str(e)}")
+        logger.error(traceback.format_exc())
+        return jsonify({'error': f'Internal server error: {str(e)}'}), 500
+
 @app.route('/api/graph/search', methods=['POST'])
 def search_nodes():
     """Search nodes by criteria"""
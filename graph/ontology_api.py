@@ -13,6 +13,13 @@ from datetime import datetime
 from typing import Dict, Any
 from src.services.ontology_service import OntologyService
 from src.services.graph_pagination_service import GraphPaginationService
+from src.services.lod_service import LODService
+from src.services.walk_service import WalkService
+from src.services.graph_service import GraphService
+from src.services.symptom_service import SymptomService
+from src.services.diagnosis_service import DiagnosisService
+from src.services.vocabulary_service import VocabularyService
+from src.services.hierarchy_service import HierarchyService
 from src.services.ontology_models import (
     OntologyClass,
     OntologyProperty,
@@ -40,6 +47,14 @@ CORS(app)
 # Initialize ontology service (lazy initialization to avoid startup hang)
 ontology_service = None
 pagination_service = None
+lod_service = None
+hierarchy_service = None
+symptom_service = None
+symptom_service_mtime = None
+diagnosis_service = None
+diagnosis_service_mtime = None
+vocabulary_service = None
+vocabulary_service_mtime = None
 
 def init_demo_data(service):
     """Initialize demo data if ontology is empty"""
@@ -84,28 +99,28 @@ def init_demo_data(service):
             property_type=PropertyType.DATA,
             domain=["demo:Person"],
             range=[str(XSDDatatype.STRING)],
-            annotations={"required": "true"}
+            required=True
         ))
         service.create_property(OntologyProperty(
             id="demo:email", label="email",
             property_type=PropertyType.DATA,
             domain=["demo:Person"],
             range=[str(XSDDatatype.STRING)],
-            annotations={"required": "true"}
+            required=True
         ))
         service.create_property(OntologyProperty(
             id="demo:department", label="department",
             property_type=PropertyType.DATA,
             domain=["demo:Professor"],
             range=[str(XSDDatatype.STRING)],
-            annotations={"required": "true"}
+            required=True
         ))
         service.create_property(OntologyProperty(
             id="demo:student_id", label="student_id",
             property_type=PropertyType.DATA,
             domain=["demo:Student"],
             range=[str(XSDDatatype.STRING)],
-            annotations={"required": "true"}
+            required=True
         ))
         
         # Create instances
@@ -155,10 +170,92 @@ def get_pagination_service():
     return pagination_service
 
 
+def get_lod_service():
+    """Get or create level-of-detail service instance"""
+    global lod_service
+    if lod_service is None:
+        lod_service = LODService(get_ontology_service().graph)
+    return lod_service
+
+
+def get_hierarchy_service():
+    """Get or create the on-demand class hierarchy service"""
+    global hierarchy_service
+    if hierarchy_service is None:
+        hierarchy_service = HierarchyService(get_ontology_service().graph)
+    return hierarchy_service
+
+
+def medical_ttl_path() -> str:
+    """Path of the medical ontology served by the diagnosis endpoints"""
+    import os
+    return os.path.join(os.path.dirname(__file__), 'sample_data', 'medical_ontology.ttl')
+
+
+def get_symptom_service():
+    """Get the symptom extractor, rebuilt when medical_ontology.ttl changes"""
+    global symptom_service, symptom_service_mtime
+    import os
+    ttl_path = medical_ttl_path()
+    mtime = os.path.getmtime(ttl_path)
+    if symptom_service is None or mtime != symptom_service_mtime:
+        symptom_service = SymptomService.from_ontology(ttl_path)
+        symptom_service_mtime = mtime
+    return symptom_service
+
+
+def get_diagnosis_service():
+    """Get the differential diagnosis model, rebuilt when medical_ontology.ttl changes"""
+    global diagnosis_service, diagnosis_service_mtime
+    import os
+    ttl_path = medical_ttl_path()
+    mtime = os.path.getmtime(ttl_path)
+    if diagnosis_service is None or mtime != diagnosis_service_mtime:
+        diagnosis_service = DiagnosisService.from_ontology(ttl_path)
+        diagnosis_service_mtime = mtime
+    return diagnosis_service
+
+
+def get_vocabulary_service():
+    """
+    Get the compressed vocabulary for triple-pattern queries
+
+    VOCABULARY_HDT names a prebuilt file (see scripts/ttl_to_hdt.py);
+    otherwise medical_ontology.ttl is converted next to itself whenever it
+    is newer than its .hdt. The file is reopened when it changes.
+    """
+    global vocabulary_service, vocabulary_service_mtime
+    import os
+    hdt_path = os.environ.get('VOCABULARY_HDT')
+    if not hdt_path:
+        ttl_path = medical_ttl_path()
+        hdt_path = os.path.splitext(ttl_path)[0] + '.hdt'
+        if not os.path.exists(hdt_path) or os.path.getmtime(hdt_path) < os.path.getmtime(ttl_path):
+            VocabularyService.convert(ttl_path, hdt_path)
+    mtime = os.path.getmtime(hdt_path)
+    if vocabulary_service is None or vocabulary_service.path != hdt_path or \
+            mtime != vocabulary_service_mtime:
+        vocabulary_service = VocabularyService(hdt_path)
+        vocabulary_service_mtime = mtime
+    return vocabulary_service
+
+
 # ============================================================================
 # Helper Functions
 # ============================================================================
 
+def resolve_node(graph, name: str) -> str:
+    """Node ID for an ID or a (case-insensitive) label"""
+    if graph.node_exists(name):
+        return name
+    wanted = str(name).strip().lower()
+    matches = graph.find_nodes(
+        lambda node_id, node: str((node or {}).get('data', {}).get('label', '')).lower() == wanted)
+    if not matches:
+        raise NodeNotFoundError(f"Node '{name}' not found")
+    return matches[0]
+
+
 def success_response(data: Any, message: str = "Success") -> Dict:
     """Create success response"""
     return {
@@ -313,27 +410,55 @@ def get_class_full(class_id: str):
 
 @app.route('/api/ontology/hierarchy', methods=['GET'])
 def get_hierarchy():
-    """Get class hierarchy tree"""
+    """
+    GET /api/ontology/hierarchy?root=owl:Thing&depth=2&limit=50
+    Returns: { class_id, label, parent_id, depth, child_count,
+               instance_count, children: [...], next_cursor }
+
+    Only depth levels below the root are loaded, at most limit children
+    per class; a class with more (or not yet expanded) carries a
+    next_cursor for /api/ontology/hierarchy/<class_id>/children, so a tree
+    UI expands on demand.
+    """
     try:
-        root_id = request.args.get('root', 'owl:Thing')
-        hierarchy = get_ontology_service().get_class_hierarchy(root_id)
-        
-        def serialize_hierarchy(node):
-            return {
-                "class_id": node.class_id,
-                "label": node.label,
-                "parent_id": node.parent_id,
-                "instance_count": node.instance_count,
-                "depth": node.depth,
-                "children": [serialize_hierarchy(child) for child in node.children]
-            }
-        
-        return jsonify(success_response(serialize_hierarchy(hierarchy)))
+        root = get_hierarchy_service().tree(
+            request.args.get('root', 'owl:Thing'),
+            depth=int(request.args.get('depth', HierarchyService.DEFAULT_DEPTH)),
+            limit=int(request.args.get('limit', HierarchyService.DEFAULT_LIMIT)))
+        return jsonify(success_response(root.to_dict()))
+    except NodeNotFoundError as e:
+        return error_response(str(e), 404)
+    except (ValidationError, ValueError) as e:
+        return error_response(str(e), 400)
     except Exception as e:
         logger.error(f"Error getting hierarchy: {e}", exc_info=True)
         return error_response(str(e), 500)
 
 
+@app.route('/api/ontology/hierarchy/<class_id>/children', methods=['GET'])
+def get_hierarchy_children(class_id: str):
+    """
+    GET /api/ontology/hierarchy/<class_id>/children?cursor=...&limit=50&depth=0
+    Returns: { parent_id, total, children: [...], next_cursor }
+
+    One page of direct subclasses with their counts; pass next_cursor back
+    for the following page (null when there are no more).
+    """
+    try:
+        page = get_hierarchy_service().children(
+            class_id, cursor=request.args.get('cursor'),
+            limit=int(request.args.get('limit', HierarchyService.DEFAULT_LIMIT)),
+            depth=int(request.args.get('depth', 0)))
+        return jsonify(success_response(page.to_dict()))
+    except NodeNotFoundError as e:
+        return error_response(str(e), 404)
+    except (ValidationError, ValueError) as e:
+        return error_response(str(e), 400)
+    except Exception as e:
+        logger.error(f"Error getting subclasses: {e}", exc_info=True)
+        return error_response(str(e), 500)
+
+
 # ============================================================================
 # Property Endpoints
 # ============================================================================
@@ -371,7 +496,10 @@ def get_property(property_id: str):
             "domain": prop.domain,
             "range": prop.range,
             "inverse_of": prop.inverse_of,
-            "characteristics": [c.value for c in prop.characteristics]
+            "characteristics": [c.value for c in prop.characteristics],
+            "required": prop.required,
+            "min_cardinality": prop.min_cardinality,
+            "max_cardinality": prop.max_cardinality
         }))
     except NodeNotFoundError as e:
         return error_response(str(e), 404)
@@ -405,7 +533,11 @@ def create_property():
             domain=data.get('domain', []),
             range=data.get('range', []),
             inverse_of=data.get('inverse_of'),
-            characteristics=characteristics
+            characteristics=characteristics,
+            required=bool(data.get('required', False)),
+            min_cardinality=int(data.get('min_cardinality') or 0),
+            max_cardinality=(int(data['max_cardinality'])
+                             if data.get('max_cardinality') is not None else None)
         )
         
         created = get_ontology_service().create_property(prop_obj)
@@ -477,6 +609,47 @@ def create_instance():
         return error_response(str(e), 500)
 
 
+@app.route('/api/ontology/instances/validate', methods=['POST'])
+def validate_instances():
+    """Validate a batch of instances against their classes' constraints
+
+    Request Body (JSON):
+        instances (list): Objects with id, class_ids and properties
+        max_violations (int): Violations listed (default: 1000)
+
+    Returns:
+        JSON with valid, checked, invalid, total_violations and violations
+    """
+    try:
+        data = request.get_json()
+
+        if not data or not isinstance(data.get('instances'), list):
+            return error_response("Missing 'instances' list in request body", 400)
+
+        instances = [
+            OntologyInstance(
+                id=item['id'],
+                label=item.get('label', item['id']),
+                class_ids=item.get('class_ids', []),
+                properties=item.get('properties', {})
+            )
+            for item in data['instances']
+        ]
+        report = get_ontology_service().shape_service.validate(
+            instances,
+            max_violations=int(data.get('max_violations', 1000))
+        )
+        return jsonify(success_response(report.to_dict()))
+
+    except (KeyError, TypeError, ValueError) as e:
+        return error_response(f"Invalid instance batch: {e}", 400)
+    except ValidationError as e:
+        return error_response(str(e), 400)
+    except Exception as e:
+        logger.error(f"Error validating instances: {e}", exc_info=True)
+        return error_response(str(e), 500)
+
+
 @app.route('/api/ontology/instances/<instance_id>', methods=['GET'])
 def get_instance(instance_id: str):
     """Get specific instance"""
@@ -802,7 +975,15 @@ def get_statistics():
             "total_object_properties": stats.total_object_properties,
             "total_data_properties": stats.total_data_properties,
             "total_annotation_properties": stats.total_annotation_properties,
-            "max_hierarchy_depth": stats.max_hierarchy_depth
+            "max_hierarchy_depth": stats.max_hierarchy_depth,
+            "avg_hierarchy_depth": stats.avg_hierarchy_depth,
+            "avg_branching_factor": stats.avg_branching_factor,
+            "max_branching_factor": stats.max_branching_factor,
+            "root_classes": stats.root_classes,
+            "leaf_classes": stats.leaf_classes,
+            "multi_parent_classes": stats.multi_parent_classes,
+            "cyclic_classes": stats.cyclic_classes,
+            "version": stats.version
         }))
     except Exception as e:
         logger.error(f"Error getting statistics: {e}", exc_info=True)
@@ -903,15 +1084,21 @@ def import_ontology():
 # Medical AI — Ollama LLM Diagnosis (Sprint 1)
 # ============================================================================
 
+# Candidates from the native differential handed to the LLM
+DIAGNOSE_CANDIDATES = 3
+
+
 @app.route('/api/diagnose', methods=['POST'])
 def diagnose():
     """
     POST /api/diagnose
-    Body: { "symptoms": ["Fever", "Cough", ...] }
-    Returns: { diagnosis, reasoning, model_used }
+    Body: { "symptoms": ["Fever", "Cough", ...], "absent": ["Rash", ...] }
+    Returns: { diagnosis, reasoning, model_used, differential }
 
-    Builds a concise prompt from the medical ontology (diseases + symptoms)
-    and forwards it to the local Ollama llama3.2:3b model.
+    Ranks the diseases natively (see /api/diagnose/differential) and builds
+    a concise prompt from the top candidates only, falling back to every
+    disease in the ontology, then forwards it to the local Ollama
+    llama3.2:3b model.
     """
     import ollama
     import os
@@ -923,10 +1110,26 @@ def diagnose():
     if not symptoms:
         return error_response('No symptoms provided. Send {"symptoms": ["Fever","Cough"]}', 400)
 
+    # ---- Rank candidates natively; the LLM only weighs the top few ------
+    disease_context = ""
+    context_title = "Knowledge base (diseases and their typical symptoms)"
+    differential = None
+    try:
+        differential = get_diagnosis_service().diagnose(
+            symptoms, data.get('absent') or [], top_k=DIAGNOSE_CANDIDATES)
+    except Exception as e:
+        logger.warning(f"Could not rank candidates for diagnose prompt: {e}")
+    if differential and differential.present:
+        disease_context = "\n".join(
+            f"- {c['label']} (probability from symptom weights: {c['probability']:.0%}, "
+            f"severity: {c['severity'] or 'unknown'}): symptoms include {', '.join(c['symptoms'])}"
+            for c in differential.ranked
+        )
+        context_title = "Most likely diseases (ranked by the ontology's symptom weights)"
+
     # ---- Load the medical ontology for context ---------------------------
     TTL_PATH = os.path.join(os.path.dirname(__file__), 'sample_data', 'medical_ontology.ttl')
-    disease_context = ""
-    if os.path.exists(TTL_PATH):
+    if not disease_context and os.path.exists(TTL_PATH):
         try:
             g = RDFGraph()
             g.parse(TTL_PATH, format='turtle')
@@ -970,7 +1173,7 @@ def diagnose():
         "and note recommended next steps. Be concise."
     )
     user_prompt = (
-        f"Knowledge base (diseases and their typical symptoms):\n{disease_context}\n\n"
+        f"{context_title}:\n{disease_context}\n\n"
         f"Patient symptoms: {symptom_list}\n\n"
         "Please provide:\n"
         "1. Most likely diagnosis (and confidence reasoning)\n"
@@ -1001,9 +1204,167 @@ def diagnose():
         'reasoning': f'LLM-based reasoning over medical ontology ({len(symptoms)} symptoms analyzed)',
         'model_used': model_used,
         'symptoms_received': symptoms,
+        'differential': differential.to_dict() if differential else None,
     }, 'LLM diagnosis complete'))
 
 
+@app.route('/api/diagnose/extract-symptoms', methods=['POST'])
+def extract_symptoms():
+    """
+    POST /api/diagnose/extract-symptoms
+    Body: { "text": "fever and a bad cough, no vomiting", "max_edits": 1 }
+    Returns: { symptoms, negated, coverage, needs_llm }
+
+    Matches the ontology's symptom labels and synonyms natively (with
+    negation and typo tolerance) in microseconds. needs_llm is set when
+    nothing was found or too much of the text went unexplained, so
+    callers can fall back to LLM extraction only then.
+    """
+    try:
+        data = request.get_json(silent=True) or {}
+        max_edits = data.get('max_edits')
+        result = get_symptom_service().extract(
+            data.get('text'), max_edits=int(max_edits) if max_edits is not None else None)
+        return jsonify(success_response(result.to_dict(), 'Symptoms extracted'))
+
+    except (ValidationError, ValueError) as e:
+        return error_response(str(e), 400)
+    except FileNotFoundError:
+        return error_response('medical_ontology.ttl not found', 404)
+    except Exception as e:
+        logger.error(f"Error extracting symptoms: {e}", exc_info=True)
+        return error_response(str(e), 500)
+
+
+@app.route('/api/diagnose/differential', methods=['POST'])
+def differential_diagnosis():
+    """
+    POST /api/diagnose/differential
+    Body: { "present": ["Fever", "Cough"], "absent": ["Runny Nose"], "top_k": 5 }
+       or { "text": "fever and a cough but no runny nose" }
+    Returns: { present, absent, unknown, ranked, groups }
+
+    Scores every disease with a noisy-OR model over the ontology's symptom
+    weights in one native pass; groups rolls the posteriors up the
+    med:parent hierarchy. Symptoms may be IDs or labels; free text is run
+    through the dictionary extractor first (negated mentions become
+    absent evidence).
+    """
+    try:
+        data = request.get_json(silent=True) or {}
+        present = list(data.get('present') or data.get('symptoms') or [])
+        absent = list(data.get('absent') or [])
+        if data.get('text'):
+            extracted = get_symptom_service().extract(data['text'])
+            present += [s['id'] for s in extracted.symptoms]
+            absent += [s['id'] for s in extracted.negated]
+        result = get_diagnosis_service().diagnose(present, absent,
+                                                  top_k=int(data.get('top_k', 5)))
+        return jsonify(success_response(result.to_dict(), 'Differential ranked'))
+
+    except (ValidationError, ValueError, TypeError) as e:
+        return error_response(str(e), 400)
+    except FileNotFoundError:
+        return error_response('medical_ontology.ttl not found', 404)
+    except Exception as e:
+        logger.error(f"Error ranking differential: {e}", exc_info=True)
+        return error_response(str(e), 500)
+
+
+@app.route('/api/diagnose/next-question', methods=['POST'])
+def next_question():
+    """
+    POST /api/diagnose/next-question
+    Body: { "present": ["Fever"], "absent": ["Runny Nose"], "top_k": 3 }
+    Returns: { questions, entropy, candidates, present, absent, unknown }
+
+    Ranks the symptoms not yet answered by expected information gain over
+    the current differential, so a triage UI can ask the most telling
+    question next. Each answer reuses the previous posterior, keeping a
+    round trip well under a millisecond of compute.
+    """
+    try:
+        data = request.get_json(silent=True) or {}
+        result = get_diagnosis_service().next_questions(
+            list(data.get('present') or []), list(data.get('absent') or []),
+            top_k=int(data.get('top_k', 5)))
+        return jsonify(success_response(result.to_dict(), 'Questions ranked'))
+
+    except (ValidationError, ValueError, TypeError) as e:
+        return error_response(str(e), 400)
+    except FileNotFoundError:
+        return error_response('medical_ontology.ttl not found', 404)
+    except Exception as e:
+        logger.error(f"Error ranking questions: {e}", exc_info=True)
+        return error_response(str(e), 500)
+
+
+@app.route('/api/diagnose/explain', methods=['POST'])
+def explain_diagnosis():
+    """
+    POST /api/diagnose/explain
+    Body: { "symptoms": ["Fever", "Cough", ...], "disease": "Influenza" }
+       or { "nodes": [...] }
+    Returns: the smallest ontology subgraph joining them (nodes, edges, cost)
+
+    Symptoms and diseases may be given as node IDs or labels. The tree is
+    an approximate Steiner tree over hop counts, computed natively, so it
+    stays fast where enumerating paths between every pair would not.
+    """
+    try:
+        data = request.get_json(silent=True) or {}
+        names = list(data.get('nodes') or data.get('symptoms') or [])
+        if data.get('disease'):
+            names.append(data['disease'])
+        if not names:
+            return error_response('No nodes provided. Send {"symptoms": [...], "disease": "..."}', 400)
+
+        graph = get_ontology_service().graph
+        result = GraphService(graph).explain_connection(
+            [resolve_node(graph, name) for name in names],
+            weighted=bool(data.get('weighted', False)),
+        )
+        return jsonify(success_response(result.to_dict(), 'Connection explained'))
+
+    except NodeNotFoundError as e:
+        return error_response(str(e), 404)
+    except ValidationError as e:
+        return error_response(str(e), 400)
+    except Exception as e:
+        logger.error(f"Error explaining diagnosis: {e}", exc_info=True)
+        return error_response(str(e), 500)
+
+
+# ============================================================================
+# Vocabulary Endpoints
+# ============================================================================
+
+@app.route('/api/ontology/vocabulary/triples', methods=['GET'])
+def vocabulary_triples():
+    """
+    GET /api/ontology/vocabulary/triples?s=...&p=...&o=...&limit=100&offset=0
+    Returns: { pattern, total, offset, triples: [{subject, predicate, object}] }
+
+    Answers a triple pattern straight from the memory-mapped HDT file
+    (omitted positions match anything). Terms use N-Triples syntax
+    (<iri>, "text"@en); a bare IRI is accepted too.
+    """
+    try:
+        page = get_vocabulary_service().triples(
+            request.args.get('s'), request.args.get('p'), request.args.get('o'),
+            limit=int(request.args.get('limit', VocabularyService.DEFAULT_LIMIT)),
+            offset=int(request.args.get('offset', 0)))
+        return jsonify(success_response(page.to_dict(), f"{page.total} matching triples"))
+
+    except (ValidationError, ValueError) as e:
+        return error_response(str(e), 400)
+    except FileNotFoundError as e:
+        return error_response(f'Vocabulary not found: {e}', 404)
+    except Exception as e:
+        logger.error(f"Error querying vocabulary: {e}", exc_info=True)
+        return error_response(str(e), 500)
+
+
 # ============================================================================
 # Graph Pagination Endpoints
 # ============================================================================
@@ -1076,6 +1437,79 @@ def get_viewport():
         return error_response(str(e), 500)
 
 
+@app.route('/api/ontology/graph/lod_viewport', methods=['POST'])
+def get_lod_viewport():
+    """Get level-of-detail viewport centered on a node
+
+    Nodes near the center are returned in full; the rest of the graph is
+    summarised as super-nodes (type 'cluster') with member counts and a
+    representative node, so the payload stays within budget.
+
+    Request Body (JSON):
+        center_node (str): ID of the center node
+        budget (int): Maximum nodes plus super-nodes to return (default: 150)
+
+    Returns:
+        JSON with nodes, aggregated edges, items per hierarchy level
+    """
+    try:
+        data = request.get_json()
+
+        if not data or 'center_node' not in data:
+            return error_response("Missing 'center_node' in request body", 400)
+
+        result = get_lod_service().get_viewport(
+            center_id=data['center_node'],
+            budget=int(data.get('budget', LODService.DEFAULT_BUDGET))
+        )
+
+        return jsonify(success_response(result))
+
+    except NodeNotFoundError as e:
+        return error_response(str(e), 404)
+    except (ValidationError, ValueError) as e:
+        return error_response(str(e), 400)
+    except Exception as e:
+        logger.error(f"Error getting LOD viewport: {e}", exc_info=True)
+        return error_response(str(e), 500)
+
+
+@app.route('/api/ontology/graph/related/<node_id>', methods=['GET'])
+def get_related_nodes(node_id):
+    """Get related-concept suggestions for a node
+
+    Scores nodes by random walk with restart from the node, so concepts
+    reachable through many short paths rank first, not only direct
+    neighbours.
+
+    Path Parameters:
+        node_id (str): ID of the node
+
+    Query Parameters:
+        limit (int): Maximum suggestions to return (default: 10)
+        restart (float): Restart probability per step (default: 0.15)
+
+    Returns:
+        JSON with suggestions (node_id, label, score), best first
+    """
+    try:
+        result = WalkService(get_ontology_service().graph).related(
+            [node_id],
+            top_k=int(request.args.get('limit', 10)),
+            restart=float(request.args.get('restart', 0.15)),
+            ignore_direction=True,
+        )
+        return jsonify(success_response(result.to_dict()))
+
+    except NodeNotFoundError as e:
+        return error_response(str(e), 404)
+    except (ValidationError, ValueError) as e:
+        return error_response(str(e), 400)
+    except Exception as e:
+        logger.error(f"Error getting related nodes: {e}", exc_info=True)
+        return error_response(str(e), 500)
+
+
 @app.route('/api/ontology/graph/neighbors/<node_id>', methods=['GET'])
 def get_neighbors(node_id):
     """Get immediate neighbors of a node
@@ -0,0 +1,624 @@
+"""
+Partitioned Graph
+
+A graph split over K worker processes, for graphs and traversal loads
+beyond what one process's memory and cores can serve.
+
+- Partitioning: the native multilevel partitioner (coarsen, partition,
+  refine) assigns the nodes of a GraphDB to parts of similar size with
+  few edges between them
+- Workers: each runs this file as a script and owns one part in its own
+  native SimpleDB, in GraphDB's key layout (node:<id>, adj:<id>), plus a
+  routing table of the far ends of edges into other parts ("ghosts"),
+  which the partitioner keeps few
+- Coordinator: PartitionedGraph keeps the node -> part map (also in a
+  SimpleDB), routes point lookups to the owners in one batch per worker,
+  and runs BFS and shortest paths as scatter-gather rounds: every worker
+  expands its share of the frontier and returns only the nodes owned
+  elsewhere, which the coordinator forwards to their owners (frontier
+  exchange), so traffic follows the edges the partitioner could not keep
+  inside a part
+- Transport: one Unix socketpair per worker, carrying pickled
+  (operation, arguments) messages framed by multiprocessing.connection
+
+Workers run this file as a script (see _worker_main), so it only imports
+the standard library and the native adapters at module level.
+"""
+
+import heapq
+import itertools
+import json
+import os
+import socket
+import subprocess
+import sys
+import threading
+from multiprocessing.connection import Connection
+from pathlib import Path
+from typing import TYPE_CHECKING, Any, Dict, List, Optional, Tuple
+
+from src.adapters.simple_db import SimpleDB
+from src.adapters.coarsen import Hierarchy
+from src.adapters.partition import partition
+
+if TYPE_CHECKING:
+    from graph_db import GraphDB
+
+
+# Repository root, put on the workers' import path
+ROOT = Path(__file__).resolve().parent.parent
+
+# Writes per message while loading parts
+LOAD_BATCH = 20000
+
+
+# ============================================================================
+# WORKER PROCESS
+# ============================================================================
+
+class _PartWorker:
+    """One part of the graph; every public method is a message operation"""
+
+    def __init__(self, part: int):
+        self.part = part
+        self.db = SimpleDB()
+        self.ghosts: Dict[str, int] = {}    # node of another part -> owner
+        self.queries: Dict[int, Dict[str, Any]] = {}
+
+    def apply(self, writes: List[Tuple[str, Optional[str]]]) -> bool:
+        return self.db.apply(writes)
+
+    def get(self, keys: List[str]) -> List[Optional[str]]:
+        return self.db.mget(keys)
+
+    def missing(self) -> List[str]:
+        """Edge targets that are not nodes of this part"""
+        targets = set()
+        keys = [key for key in self.db.keys() if key.startswith("adj:")]
+        for raw in self.db.mget(keys):
+            targets.update(e['to'] for e in json.loads(raw or "[]"))
+        targets = list(targets)
+        present = self.db.mget([f"node:{t}" for t in targets])
+        return [t for t, raw in zip(targets, present) if raw is None]
+
+    def route(self, owners: Dict[str, int]):
+        self.ghosts.update(owners)
+
+    def add_node(self, node_id: str, raw: str) -> bool:
+        if self.db.exists(f"node:{node_id}"):
+            return False
+        self.db.set(f"node:{node_id}", raw)
+        return True
+
+    def link(self, from_node: str, entry: Dict[str, Any], owner: int) -> bool:
+        """Add or replace the edge entry of from_node; True if it is new"""
+        adj = json.loads(self.db.get(f"adj:{from_node}") or "[]")
+        kept = [e for e in adj if e['to'] != entry['to']]
+        self.db.set(f"adj:{from_node}", json.dumps(kept + [entry]))
+        if owner != self.part:
+            self.ghosts[entry['to']] = owner
+        return len(kept) == len(adj)
+
+    def bfs(self, qid: int, inbox: List[Tuple[str, Optional[str]]]):
+        """
+        One BFS level: visit this part's frontier (nodes queued here last
+        round plus those forwarded by other parts), queue the unseen local
+        neighbours for the next round and return the remote ones.
+
+        Returns:
+            (visited, remote, pending): (node, parent) pairs visited now,
+            remote (node, parent) pairs per owning part, and whether local
+            nodes are queued for the next round
+        """
+        q = self.queries.setdefault(qid, {"seen": {}, "pending": [], "sent": set()})
+        seen, sent = q["seen"], q["sent"]
+        level = []
+        for node, parent in q["pending"] + inbox:
+            if node not in seen:
+                seen[node] = parent
+                level.append((node, parent))
+
+        pending, remote, queued = [], {}, set()
+        ghosts = self.ghosts
+        adjs = self.db.mget([f"adj:{n}" for n, _ in level])
+        for (node, _), raw in zip(level, adjs):
+            for entry in json.loads(raw or "[]"):
+                target = entry['to']
+                if target in seen or target in queued or target in sent:
+                    continue
+                owner = ghosts.get(target)
+                if owner is None:
+                    queued.add(target)
+                    pending.append((target, node))
+                else:
+                    sent.add(target)
+                    remote.setdefault(owner, []).append((target, node))
+        q["pending"] = pending
+        return level, remote, bool(pending)
+
+    def sssp(self, qid: int, inbox: List[Tuple[str, float, Optional[str]]],
+             bound: float, target: str):
+        """
+        One shortest-path round: Dijkstra over this part from the nodes
+        whose distance improved (forwarded by other parts), pruned at the
+        best distance to target known so far.
+
+        Returns:
+            (remote, target_distance): per owning part, the improved
+            (node, distance, parent) candidates; this part's distance to
+            target (None if it does not own a reached target)
+        """
+        q = self.queries.setdefault(qid, {"dist": {}, "sent": {}})
+        dist, sent = q["dist"], q["sent"]
+        heap = []
+        for node, d, parent in inbox:
+            if d < dist.get(node, (float('inf'),))[0]:
+                dist[node] = (d, parent)
+                heapq.heappush(heap, (d, node))
+
+        remote: Dict[int, Dict[str, Tuple[float, str]]] = {}
+        while heap:
+            d, node = heapq.heappop(heap)
+            if d > dist[node][0] or d >= bound or node == target:
+                continue
+            for entry in json.loads(self.db.get(f"adj:{node}") or "[]"):
+                to, nd = entry['to'], d + entry.get('weight', 1.0)
+                if nd >= bound:
+                    continue
+                owner = self.ghosts.get(to)
+                if owner is None:
+                    if nd < dist.get(to, (float('inf'),))[0]:
+                        dist[to] = (nd, node)
+                        heapq.heappush(heap, (nd, to))
+                elif nd < sent.get(to, float('inf')):
+                    sent[to] = nd
+                    remote.setdefault(owner, {})[to] = (nd, node)
+        found = dist.get(target)
+        return ({p: [(n, d, parent) for n, (d, parent) in m.items()] for p, m in remote.items()},
+                found[0] if found else None)
+
+    def parent(self, qid: int, node: str) -> Optional[str]:
+        """Predecessor of a node reached by a shortest-path query"""
+        found = self.queries.get(qid, {}).get("dist", {}).get(node)
+        return found[1] if found else None
+
+    def end(self, qid: int):
+        self.queries.pop(qid, None)
+
+    def stats(self) -> Dict[str, int]:
+        return {"nodes": sum(1 for key in self.db.keys() if key.startswith("node:")),
+                "ghosts": len(self.ghosts)}
+
+
+def _worker_main(argv: List[str]) -> int:
+    """
+    Worker entry point.
+
+        worker <socket fd> <part>
+
+    Serves (operation, args) messages until the coordinator closes the
+    socket; replies ("ok", result) or ("error", message).
+    """
+    conn = Connection(int(argv[1]))
+    worker = _PartWorker(int(argv[2]))
+    while True:
+        try:
+            op, args = conn.recv()
+        except (EOFError, OSError):
+            return 0
+        if op == "close":
+            return 0
+        try:
+            reply = ("ok", getattr(worker, op)(*args))
+        except Exception as e:
+            reply = ("error", f"{type(e).__name__}: {e}")
+        try:
+            conn.send(reply)
+        except OSError:         # coordinator closed while we were working
+            return 0
+
+
+# ============================================================================
+# COORDINATOR
+# ============================================================================
+
+class PartitionedGraph:
+    """
+    A graph served by K worker processes, one part each
+
+    Reads and traversals match GraphDB's (get_node, get_neighbors, bfs,
+    shortest_path); calls are serialized, so one instance may be shared
+    between threads.
+
+    Example:
+        with PartitionedGraph.from_graph(graph, parts=4) as pg:
+            pg.shortest_path("A", "Z")
+    """
+
+    def __init__(self, parts: int, directed: bool = True, weighted: bool = False):
+        """
+        Start empty workers
+
+        Args:
+            parts: Number of worker processes (K)
+            directed: True for directed graph, False for undirected
+            weighted: True if edges have weights
+        """
+        if parts < 1:
+            raise ValueError("Need at least one part")
+        self.parts = parts
+        self.directed = directed
+        self.weighted = weighted
+        self.partition_stats: Dict[str, Any] = {}
+        self._owners = SimpleDB()
+        self._sizes = [0] * parts
+        self._lock = threading.Lock()
+        self._qids = itertools.count()
+        self._procs: List[subprocess.Popen] = []
+        self._conns: List[Connection] = []
+
+        env = dict(os.environ)
+        env["PYTHONPATH"] = os.pathsep.join(filter(None, [str(ROOT), env.get("PYTHONPATH")]))
+        try:
+            for part in range(parts):
+                ours, theirs = socket.socketpair()
+                with theirs:
+                    self._procs.append(subprocess.Popen(
+                        [sys.executable, os.path.abspath(__file__), "worker",
+                         str(theirs.fileno()), str(part)],
+                        pass_fds=(theirs.fileno(),), env=env, stdin=subprocess.DEVNULL))
+                self._conns.append(Connection(ours.detach()))
+        except Exception:
+            self.close()
+            raise
+
+    @classmethod
+    def from_graph(cls, graph: "GraphDB", parts: int, imbalance: float = 0.03,
+                   seed: int = 0) -> "PartitionedGraph":
+        """
+        Partition a graph and load its parts into new workers
+
+        Nodes linked in the topology mirror are placed by the native
+        partitioner; nodes without edges fill up the smallest parts. Node
+        records and adjacency lists are copied as stored, from one
+        snapshot of the graph.
+
+        Args:
+            graph: Graph to copy
+            parts: Number of worker processes (K)
+            imbalance: Parts may exceed their share of nodes by this fraction
+            seed: Partitioner seed (the placement is reproducible per seed)
+        """
+        pg = cls(parts, graph.directed, graph.weighted)
+        try:
+            with graph.snapshot() as snap:
+                node_ids = graph.get_all_nodes()
+                view = graph.topology_view()
+                with view:
+                    if view.edge_count:
+                        hierarchy = Hierarchy(view, min_nodes=16 * parts, seed=seed)
+                        assigned, pg.partition_stats = partition(hierarchy, parts, imbalance, seed)
+                        hierarchy.close()
+                    else:
+                        assigned = []
+
+                owners = []
+                for node_id in node_ids:
+                    tid = graph.topology_id(node_id)
+                    part = assigned[tid] if tid is not None and tid < len(assigned) else None
+                    owners.append(part)
+                    if part is not None:
+                        pg._sizes[part] += 1
+                for i, part in enumerate(owners):
+                    if part is None:
+                        owners[i] = pg._smallest()
+                        pg._sizes[owners[i]] += 1
+                pg._owners.apply([(n, str(p)) for n, p in zip(node_ids, owners)])
+
+                by_part: List[List[str]] = [[] for _ in range(parts)]
+                for node_id, part in zip(node_ids, owners):
+                    by_part[part].append(node_id)
+                for start in range(0, max(map(len, by_part)), LOAD_BATCH // 2):
+                    requests = {}
+                    for part, ids in enumerate(by_part):
+                        chunk = ids[start:start + LOAD_BATCH // 2]
+                        if not chunk:
+                            continue
+                        keys = [f"node:{n}" for n in chunk] + [f"adj:{n}" for n in chunk]
+                        requests[part] = ("apply", ([(k, v) for k, v in zip(keys, snap.mget(keys))
+                                                     if v is not None],))
+                    pg._scatter(requests)
+
+            # Owners of the far ends of edges leaving each part
+            missing = pg._scatter({part: ("missing", ()) for part in range(parts)})
+            pg._scatter({part: ("route", ({n: int(p) for n, p in zip(ids, pg._owners.mget(ids))
+                                           if p is not None},))
+                         for part, ids in missing.items() if ids})
+        except Exception:
+            pg.close()
+            raise
+        return pg
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.close()
+        return False
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        """Stop the workers (their parts are discarded)."""
+        for conn in getattr(self, '_conns', []):
+            try:
+                conn.send(("close", ()))
+            except OSError:
+                pass
+            conn.close()
+        for proc in getattr(self, '_procs', []):
+            try:
+                proc.wait(timeout=5)
+            except subprocess.TimeoutExpired:
+                proc.kill()
+                proc.wait()
+        self._conns, self._procs = [], []
+
+    # ========================================================================
+    # Messaging
+    # ========================================================================
+
+    def _scatter(self, requests: Dict[int, Tuple[str, tuple]]) -> Dict[int, Any]:
+        """
+        Send every request, then gather the replies (workers run in parallel)
+
+        Every reply is read before an error reply is raised, so each socket
+        stays in step with its worker. A worker that cannot be reached
+        leaves replies in an unknown state: the instance is closed.
+        """
+        if not self._conns:
+            raise RuntimeError("Partitioned graph is closed")
+        replies = {}
+        part = None
+        try:
+            for part, (op, args) in requests.items():
+                self._conns[part].send((op, args))
+            for part in requests:
+                replies[part] = self._conns[part].recv()
+        except (EOFError, OSError):
+            self.close()
+            raise RuntimeError(f"Worker of part {part} exited; graph closed") from None
+
+        for part, (status, result) in replies.items():
+            if status != "ok":
+                raise RuntimeError(f"Part {part}: {result}")
+        return {part: result for part, (_, result) in replies.items()}
+
+    def _call(self, part: int, op: str, *args) -> Any:
+        return self._scatter({part: (op, args)})[part]
+
+    def _smallest(self) -> int:
+        return min(range(self.parts), key=self._sizes.__getitem__)
+
+    def _gather(self, prefix: str, node_ids: List[str]) -> List[Optional[str]]:
+        """Raw values of prefix + id at each node's owner, in order"""
+        out: List[Optional[str]] = [None] * len(node_ids)
+        by_part: Dict[int, List[int]] = {}
+        for i, owner in enumerate(self._owners.mget(node_ids)):
+            if owner is not None:
+                by_part.setdefault(int(owner), []).append(i)
+        replies = self._scatter({part: ("get", ([f"{prefix}{node_ids[i]}" for i in idx],))
+                                 for part, idx in by_part.items()})
+        for part, idx in by_part.items():
+            for i, raw in zip(idx, replies[part]):
+                out[i] = raw
+        return out
+
+    # ========================================================================
+    # Point Operations
+    # ========================================================================
+
+    def owner(self, node_id: str) -> Optional[int]:
+        """Part holding a node (None if it does not exist)"""
+        found = self._owners.get(node_id)
+        return int(found) if found is not None else None
+
+    def node_exists(self, node_id: str) -> bool:
+        return self._owners.exists(node_id)
+
+    def get_node(self, node_id: str) -> Optional[Dict[str, Any]]:
+        """Node 'id' and 'data' (as GraphDB.get_node), or None if not found"""
+        data = self.get_nodes([node_id])[0]
+        return {'id': node_id, 'data': data} if data is not None else None
+
+    def get_nodes(self, node_ids: List[str]) -> List[Optional[Dict[str, Any]]]:
+        """Node data of several nodes, one batched lookup per owning worker"""
+        with self._lock:
+            raws = self._gather("node:", node_ids)
+        return [json.loads(raw) if raw is not None else None for raw in raws]
+
+    def get_neighbors(self, node_id: str) -> List[Dict[str, Any]]:
+        return self.get_neighbors_many([node_id])[0]
+
+    def get_neighbors_many(self, node_ids: List[str]) -> List[List[Dict[str, Any]]]:
+        """Adjacency lists of several nodes ([] for unknown nodes)"""
+        with self._lock:
+            raws = self._gather("adj:", node_ids)
+        return [json.loads(raw or "[]") for raw in raws]
+
+    def add_node(self, node_id: str, data: Optional[Dict[str, Any]] = None) -> bool:
+        """
+        Add a node to the smallest part
+
+        Returns:
+            True if added, False if it already exists
+        """
+        with self._lock:
+            if self._owners.exists(node_id):
+                return False
+            part = self._smallest()
+            self._call(part, "add_node", node_id, json.dumps(data or {}))
+            self._owners.set(node_id, str(part))
+            self._sizes[part] += 1
+            return True
+
+    def add_edge(self, from_node: str, to_node: str, weight: float = 1.0) -> bool:
+        """
+        Add (or re-weigh) an edge at the source's worker (and the reverse
+        at the target's for undirected graphs)
+
+        Returns:
+            True if both nodes exist
+        """
+        with self._lock:
+            owners = self._owners.mget([from_node, to_node])
+            if None in owners:
+                return False
+            src, dst = map(int, owners)
+            links = [(src, from_node, to_node, dst)]
+            if not self.directed:
+                links.append((dst, to_node, from_node, src))
+            for part, node, other, other_part in links:
+                entry = {"to": other, "weight": weight} if self.weighted else {"to": other}
+                self._call(part, "link", node, entry, other_part)
+            return True
+
+    # ========================================================================
+    # Distributed Traversal
+    # ========================================================================
+
+    def _end(self, qid: int):
+        self._scatter({part: ("end", (qid,)) for part in range(self.parts)})
+
+    def bfs(self, start_node: str, target_node: Optional[str] = None) -> Dict[str, Any]:
+        """
+        Breadth-First Search, level-synchronous across the workers
+
+        Each round, every worker with frontier nodes visits them and
+        expands their adjacency lists; neighbours in the same part stay
+        there for the next round, the others are forwarded to their owners
+        by the coordinator. Within a level, nodes are listed by part.
+
+        Returns:
+            Same as GraphDB.bfs: 'visited', 'found', 'path', 'distances'
+            (with a target, the search stops after the target's level)
+        """
+        with self._lock:
+            start_owner = self._owners.get(start_node)
+            if start_owner is None:
+                return {"visited": [], "found": False, "path": [], "distances": {}}
+            qid = next(self._qids)
+            visited, parent, distances = [], {}, {}
+            inbox: Dict[int, List[Tuple[str, Optional[str]]]] = {int(start_owner): [(start_node, None)]}
+            active: set = set()
+            depth = 0
+            try:
+                while inbox or active:
+                    replies = self._scatter({part: ("bfs", (qid, inbox.get(part, [])))
+                                             for part in sorted(set(inbox) | active)})
+                    inbox, active = {}, set()
+                    for part, (level, remote, pending) in replies.items():
+                        for node, via in level:
+                            visited.append(node)
+                            parent[node] = via
+                            distances[node] = depth
+                        for owner, items in remote.items():
+                            inbox.setdefault(owner, []).extend(items)
+                        if pending:
+                            active.add(part)
+                    if target_node is not None and target_node in distances:
+                        break
+                    depth += 1
+            finally:
+                self._end(qid)
+
+        found = target_node is not None and target_node in distances
+        path = []
+        if found:
+            node = target_node
+            while node is not None:
+                path.append(node)
+                node = parent[node]
+            path.reverse()
+        return {"visited": visited, "found": found, "path": path, "distances": distances}
+
+    def shortest_path(self, start_node: str, end_node: str) -> Dict[str, Any]:
+        """
+        Shortest path between two nodes (hops, or weights if weighted)
+
+        Weighted searches run rounds of local Dijkstra: each worker settles
+        what it can inside its part and forwards improved distances of
+        remote nodes; once the target is reached, paths at least as long
+        are pruned. The search ends when no worker forwards anything.
+
+        Returns:
+            Same as GraphDB.shortest_path: 'path' and 'distance'
+        """
+        if not self.weighted:
+            result = self.bfs(start_node, end_node)
+            return {
+                "path": result["path"],
+                "distance": len(result["path"]) - 1 if result["path"] else float('inf')
+            }
+
+        with self._lock:
+            owners = self._owners.mget([start_node, end_node])
+            if None in owners:
+                return {"path": [], "distance": float('inf')}
+            target_owner = int(owners[1])
+            qid = next(self._qids)
+            bound = float('inf')
+            inbox = {int(owners[0]): [(start_node, 0.0, None)]}
+            try:
+                while inbox:
+                    replies = self._scatter({part: ("sssp", (qid, items, bound, end_node))
+                                             for part, items in inbox.items()})
+                    inbox = {}
+                    for part, (remote, target_dist) in replies.items():
+                        if target_dist is not None:
+                            bound = min(bound, target_dist)
+                        for owner, items in remote.items():
+                            inbox.setdefault(owner, []).extend(items)
+
+                path = []
+                if bound < float('inf'):
+                    node, part = end_node, target_owner
+                    while node is not None:
+                        path.append(node)
+                        node = self._call(part, "parent", qid, node)
+                        if node is not None:
+                            part = int(self._owners.get(node))
+                    path.reverse()
+            finally:
+                self._end(qid)
+        return {"path": path, "distance": bound}
+
+    # ========================================================================
+    # Statistics
+    # ========================================================================
+
+    def get_stats(self) -> Dict[str, Any]:
+        """
+        Node and ghost (remote edge end) counts per part, with the
+        partitioner's statistics from loading
+        """
+        with self._lock:
+            counts = self._scatter({part: ("stats", ()) for part in range(self.parts)})
+        return {
+            "parts": self.parts,
+            "directed": self.directed,
+            "weighted": self.weighted,
+            "nodes": sum(c["nodes"] for c in counts.values()),
+            "nodes_per_part": [counts[p]["nodes"] for p in range(self.parts)],
+            "ghosts_per_part": [counts[p]["ghosts"] for p in range(self.parts)],
+            "partition": dict(self.partition_stats),
+        }
+
+    def __repr__(self) -> str:
+        kind = "Directed" if self.directed else "Undirected"
+        return f"<PartitionedGraph {kind}, {self.parts} parts, {sum(self._sizes)} nodes>"
+
+
+if __name__ == "__main__":
+    sys.exit(_worker_main(sys.argv[1:]))
@@ -72,41 +72,78 @@ def get_status():
 
 @app.route('/api/qc/run-tests', methods=['POST'])
 def run_tests():
-    """Execute tests"""
+    """
+    Start a test run in the background
+    
+    Tests are sharded across worker processes (coverage runs execute
+    in-process); poll /api/qc/jobs/<job_id> for progress and the final suite.
+    """
     try:
         data = request.get_json() or {}
         layer = data.get('layer')
         test_file = data.get('test_path')
+        workers = data.get('workers')
         coverage = data.get('coverage', False)
         
-        # Run tests and get suite result
-        if test_file:
-            suite = test_runner.run_tests(test_file=test_file, coverage=coverage)
-        elif layer and layer != 'all':
-            suite = test_runner.run_tests(layer=layer, coverage=coverage)
-        else:
-            suite = test_runner.run_tests(coverage=coverage)
+        if workers is not None and (isinstance(workers, bool) or not isinstance(workers, int)
+                                    or workers < 1):
+            return jsonify({
+                'success': False,
+                'error': "'workers' must be a positive integer"
+            }), 400
+        if not isinstance(coverage, bool):
+            return jsonify({
+                'success': False,
+                'error': "'coverage' must be true or false"
+            }), 400
+        
+        if layer == 'all':
+            layer = None
+        job = test_runner.start_tests(layer=layer, test_file=test_file,
+                                      workers=workers, coverage=coverage)
         
         return jsonify({
             'success': True,
-            'data': {
-                'run_id': suite.suite_id,
-                'total': suite.total_tests,
-                'passed': suite.passed,
-                'failed': suite.failed,
-                'skipped': suite.skipped,
-                'duration': suite.duration,
-                'success_rate': (suite.passed / suite.total_tests * 100) if suite.total_tests > 0 else 0
-            }
-        })
+            'data': job.to_dict()
+        }), 202
     except Exception as e:
-        logger.error(f"Error running tests: {e}", exc_info=True)
+        logger.error(f"Error starting tests: {e}", exc_info=True)
         return jsonify({
             'success': False,
             'error': str(e)
         }), 500
 
 
+@app.route('/api/qc/jobs/<job_id>')
+def get_job(job_id):
+    """Get progress of a background test run"""
+    job = test_runner.get_job(job_id)
+    if job is None:
+        return jsonify({
+            'success': False,
+            'error': f"Unknown job: {job_id}"
+        }), 404
+    
+    suite = job.get('result')
+    if suite:
+        total = suite['total_tests']
+        job['result'] = {
+            'run_id': suite['suite_id'],
+            'total': total,
+            'passed': suite['passed'],
+            'failed': suite['failed'],
+            'skipped': suite['skipped'],
+            'duration': suite['duration'],
+            'coverage': suite.get('coverage'),
+            'success_rate': (suite['passed'] / total * 100) if total > 0 else 0
+        }
+    
+    return jsonify({
+        'success': True,
+        'data': job
+    })
+
+
 @app.route('/api/qc/history')
 def get_history():
     """Get test run history"""
@@ -8,6 +8,23 @@ and operations. All ctypes interactions are isolated here.
 
 Available adapters:
 - SimpleDB: Key-value hash table database
+- Snapshot: Point-in-time read view of a SimpleDB
+- IntMap32 / IntMap64: Integer-keyed tables for dense ID maps
+- TimeSeriesStore: Compressed append-only test-result series
+- GraphStore / GraphView: Batched adjacency ingestion with immutable read views
+- Pattern: Subgraph pattern matching over GraphView versions
+- count_triangles / estimate_triangles: Triangle counts and clustering coefficients
+- betweenness / betweenness_sample / harmonic_closeness: Centrality measures
+- Hierarchy: Multilevel coarsening for level-of-detail views
+- WalkGraph: Random walks, node2vec sampling and restart proximity
+- minimum_spanning_tree / steiner_tree: Spanning forests and connection subgraphs
+- PhraseDict: Dictionary phrase matching over free text (Aho-Corasick)
+- DiagnosisModel / rollup_posterior / entropy: Noisy-OR diagnosis and next-question gains
+- HDTWriter / HDTFile: Compressed, memory-mapped RDF files queried by triple pattern
+- hierarchy_levels: Depths and shape of class hierarchies in one topological pass
+- ShapeProgram / ShapeBatch: Compiled class constraints checked over instance batches
+- partition: Multilevel K-way partitioning of a coarsening Hierarchy
+- ReplicationLeader / Replica: Log shipping of a SimpleDB to read-only replicas
 
 Usage:
     from adapters import SimpleDB
@@ -17,11 +34,55 @@ Usage:
     print(db.get("key"))
 """
 
-from .simple_db import SimpleDB, DBStats
+from .simple_db import SimpleDB, Snapshot, DBStats
+from .int_table import IntMap32, IntMap64
+from .ts_store import TimeSeriesStore
+from .graph_store import GraphStore, GraphView
+from .pattern_match import Pattern
+from .triangles import count_triangles, estimate_triangles
+from .centrality import betweenness, betweenness_sample, harmonic_closeness
+from .coarsen import Hierarchy
+from .walks import WalkGraph
+from .spanning import minimum_spanning_tree, steiner_tree
+from .text_match import PhraseDict
+from .diagnosis import DiagnosisModel, rollup_posterior, entropy
+from .hdt import HDTWriter, HDTFile
+from .dag import hierarchy_levels
+from .shapes import ShapeProgram, ShapeBatch
+from .partition import partition
+from .replication import ReplicationLeader, Replica
 
 __all__ = [
     'SimpleDB',
+    'Snapshot',
     'DBStats',
+    'IntMap32',
+    'IntMap64',
+    'TimeSeriesStore',
+    'GraphStore',
+    'GraphView',
+    'Pattern',
+    'count_triangles',
+    'estimate_triangles',
+    'betweenness',
+    'betweenness_sample',
+    'harmonic_closeness',
+    'Hierarchy',
+    'WalkGraph',
+    'minimum_spanning_tree',
+    'steiner_tree',
+    'PhraseDict',
+    'DiagnosisModel',
+    'rollup_posterior',
+    'entropy',
+    'HDTWriter',
+    'HDTFile',
+    'hierarchy_levels',
+    'ShapeProgram',
+    'ShapeBatch',
+    'partition',
+    'ReplicationLeader',
+    'Replica',
 ]
 
 __version__ = '1.0.0'
@@ -0,0 +1,167 @@
+"""
+Centrality Python Adapter
+
+Python wrapper for the C centrality library (betweenness and harmonic
+closeness over GraphStore views).
+This is the ONLY module that uses ctypes for centrality.
+
+Shortest paths are unweighted and follow edge direction unless undirected
+is set. Betweenness is returned on the raw scale (sum over ordered node
+pairs); divide by (n-1)(n-2) to normalise.
+"""
+
+import ctypes
+from array import array
+from typing import Any, Dict, Iterable, Optional, Tuple
+from ._loader import load_library
+from .graph_store import GraphView, _u32_array
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+CT_UNDIRECTED = 0x1
+
+_U32P = ctypes.POINTER(ctypes.c_uint32)
+_F64P = ctypes.POINTER(ctypes.c_double)
+
+
+class CTStats(ctypes.Structure):
+    """Centrality run statistics (matches C CTStats)."""
+    _fields_ = [
+        ("samples", ctypes.c_uint64),
+        ("vertex_diameter", ctypes.c_uint32),
+        ("epsilon", ctypes.c_double),
+        ("threads", ctypes.c_uint),
+    ]
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert to Python dictionary."""
+        return {
+            'samples': self.samples,
+            'vertex_diameter': self.vertex_diameter,
+            'epsilon': self.epsilon,
+            'threads': self.threads,
+        }
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.ct_betweenness.argtypes = [
+    ctypes.c_void_p, _U32P, ctypes.c_size_t, ctypes.c_uint, ctypes.c_uint,
+    _F64P, ctypes.POINTER(CTStats),
+]
+_lib.ct_betweenness.restype = ctypes.c_bool
+
+_lib.ct_betweenness_sample.argtypes = [
+    ctypes.c_void_p, ctypes.c_double, ctypes.c_double, ctypes.c_uint64, ctypes.c_uint64,
+    ctypes.c_uint, ctypes.c_uint, _F64P, ctypes.POINTER(CTStats),
+]
+_lib.ct_betweenness_sample.restype = ctypes.c_bool
+
+_lib.ct_harmonic.argtypes = [
+    ctypes.c_void_p, _U32P, ctypes.c_size_t, ctypes.c_uint, ctypes.c_uint, _F64P,
+]
+_lib.ct_harmonic.restype = ctypes.c_bool
+
+
+# ============================================================================
+# PYTHON WRAPPER FUNCTIONS
+# ============================================================================
+
+def _result_array(view: GraphView) -> Tuple[array, Optional[ctypes.c_void_p]]:
+    values = array('d', bytes(8 * view.node_count))
+    ptr = ctypes.cast(values.buffer_info()[0], _F64P) if view.node_count else None
+    return values, ptr
+
+
+def _id_array(ids: Optional[Iterable[int]]) -> Tuple[Optional[array], Optional[ctypes.c_void_p], int]:
+    if ids is None:
+        return None, None, 0
+    arr = _u32_array(sorted(set(ids)))
+    ptr = ctypes.cast(arr.buffer_info()[0], _U32P) if arr else None
+    return arr, ptr, len(arr)
+
+
+def betweenness(view: GraphView, sources: Optional[Iterable[int]] = None,
+                undirected: bool = False, threads: int = 0) -> Tuple[array, Dict[str, Any]]:
+    """
+    Exact betweenness (Brandes), optionally from a subset of sources.
+
+    Args:
+        view: Graph version to analyse (must track in-adjacency)
+        sources: Source node IDs (None = all); with k of n sources, scale
+            the result by n / k for an estimate
+        undirected: Ignore edge directions
+        threads: Worker threads (0 = one per CPU)
+
+    Returns:
+        (values indexed by node ID as array('d'), stats)
+    """
+    values, out = _result_array(view)
+    ids, ids_ptr, n_ids = _id_array(sources)
+    if ids is not None and not n_ids:
+        return values, CTStats().to_dict()
+    stats = CTStats()
+    if not _lib.ct_betweenness(view._ptr(), ids_ptr, n_ids, CT_UNDIRECTED if undirected else 0,
+                               threads, out, ctypes.byref(stats)):
+        raise ValueError("Centrality needs a view with in-adjacency (or ran out of memory)")
+    return values, stats.to_dict()
+
+
+def betweenness_sample(view: GraphView, epsilon: float = 0.01, delta: float = 0.1,
+                       seed: int = 0, max_samples: int = 0, undirected: bool = False,
+                       threads: int = 0) -> Tuple[array, Dict[str, Any]]:
+    """
+    Approximate betweenness from sampled shortest paths.
+
+    With probability 1 - delta every value divided by n(n-1) is within
+    epsilon of the exact one.
+
+    Args:
+        max_samples: Cap on sampled paths (0 = as many as the bound needs);
+            stats['epsilon'] reports the bound achieved
+
+    Returns:
+        (values on the raw scale indexed by node ID, stats)
+    """
+    if not (epsilon > 0 and 0 < delta < 1):
+        raise ValueError("epsilon must be positive and delta in (0, 1)")
+    values, out = _result_array(view)
+    stats = CTStats()
+    if not _lib.ct_betweenness_sample(view._ptr(), epsilon, delta, seed, max_samples,
+                                      CT_UNDIRECTED if undirected else 0, threads, out,
+                                      ctypes.byref(stats)):
+        raise ValueError("Centrality needs a view with in-adjacency (or ran out of memory)")
+    return values, stats.to_dict()
+
+
+def harmonic_closeness(view: GraphView, targets: Optional[Iterable[int]] = None,
+                       undirected: bool = False, threads: int = 0) -> array:
+    """
+    Harmonic closeness: sum of 1 / d(u, x) over nodes u that reach x.
+
+    Args:
+        targets: Node IDs to score (None = all); other entries stay 0
+
+    Returns:
+        Values indexed by node ID as array('d')
+    """
+    values, out = _result_array(view)
+    ids, ids_ptr, n_ids = _id_array(targets)
+    if ids is not None and not n_ids:
+        return values
+    if not _lib.ct_harmonic(view._ptr(), ids_ptr, n_ids, CT_UNDIRECTED if undirected else 0,
+                            threads, out):
+        raise ValueError("Centrality needs a view with in-adjacency (or ran out of memory)")
+    return values
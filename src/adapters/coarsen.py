@@ -0,0 +1,214 @@
+"""
+Coarsen Python Adapter
+
+Python wrapper for the C coarsen library (multilevel graph coarsening for
+level-of-detail views).
+This is the ONLY module that uses ctypes for coarsen.
+
+A Hierarchy is built once from a GraphView and is independent of it
+afterwards. Level 0 nodes are the view's node IDs; every node of level
+l + 1 is a cluster of level-l nodes.
+"""
+
+import ctypes
+from array import array
+from typing import Iterable, List, Optional, Tuple
+from ._loader import load_library
+from .graph_store import GraphView, _u32_array
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+CH_NONE = 0xFFFFFFFF
+
+_U32P = ctypes.POINTER(ctypes.c_uint32)
+_F64P = ctypes.POINTER(ctypes.c_double)
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.ch_build.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_uint64]
+_lib.ch_build.restype = ctypes.c_void_p
+
+_lib.ch_free.argtypes = [ctypes.c_void_p]
+_lib.ch_free.restype = None
+
+_lib.ch_levels.argtypes = [ctypes.c_void_p]
+_lib.ch_levels.restype = ctypes.c_size_t
+
+_lib.ch_level_size.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+_lib.ch_level_size.restype = ctypes.c_size_t
+
+for _name in ("ch_parents", "ch_sizes", "ch_reps"):
+    getattr(_lib, _name).argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+    getattr(_lib, _name).restype = _U32P
+
+_lib.ch_children.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_uint32,
+                             ctypes.POINTER(_U32P)]
+_lib.ch_children.restype = ctypes.c_size_t
+
+_lib.ch_neighbors.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_uint32,
+                              ctypes.POINTER(_U32P), ctypes.POINTER(_F64P)]
+_lib.ch_neighbors.restype = ctypes.c_size_t
+
+_lib.ch_distances.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_uint32,
+                              ctypes.c_uint32, _U32P]
+_lib.ch_distances.restype = ctypes.c_bool
+
+_lib.ch_lift_min.argtypes = [ctypes.c_void_p, ctypes.c_size_t, _U32P, _U32P]
+_lib.ch_lift_min.restype = ctypes.c_bool
+
+_lib.ch_cut_edges.argtypes = [ctypes.c_void_p, _U32P, _U32P, ctypes.c_size_t,
+                              _U32P, _U32P, _F64P, ctypes.c_size_t]
+_lib.ch_cut_edges.restype = ctypes.c_int64
+
+
+# ============================================================================
+# PYTHON WRAPPER CLASS
+# ============================================================================
+
+def _ptr(arr: array, ctype):
+    return ctypes.cast(arr.buffer_info()[0], ctype) if len(arr) else None
+
+
+class Hierarchy:
+    """
+    Multilevel coarsening of a graph version.
+
+    Example:
+        with graph.view() as view:
+            h = Hierarchy(view, min_nodes=32)
+        top = h.levels - 1
+        for c in range(h.level_size(top)):
+            print(h.sizes(top)[c], "nodes around", h.reps(top)[c])
+    """
+
+    def __init__(self, view: GraphView, min_nodes: int = 32, seed: int = 0):
+        """
+        Args:
+            view: Graph version to coarsen (must track in-adjacency)
+            min_nodes: Stop once a level has at most this many nodes
+            seed: Matching order seed (the hierarchy is reproducible per seed)
+        """
+        self._h = _lib.ch_build(view._ptr(), min_nodes, seed)
+        if not self._h:
+            raise ValueError("Coarsening needs a view with in-adjacency (or ran out of memory)")
+        self.levels = _lib.ch_levels(self._h)
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        """Free the native hierarchy."""
+        if getattr(self, '_h', None):
+            _lib.ch_free(self._h)
+            self._h = None
+
+    def _handle(self):
+        if not self._h:
+            raise ValueError("Hierarchy is closed")
+        return self._h
+
+    def _check_level(self, level: int):
+        if not 0 <= level < self.levels:
+            raise ValueError(f"Level {level} out of range (0..{self.levels - 1})")
+
+    def level_size(self, level: int) -> int:
+        """Nodes at a level."""
+        return _lib.ch_level_size(self._handle(), level)
+
+    def _array(self, fn, level: int) -> array:
+        self._check_level(level)
+        n = self.level_size(level)
+        out = array('I', bytes(4 * n))
+        if n:
+            ctypes.memmove(out.buffer_info()[0], fn(self._handle(), level), 4 * n)
+        return out
+
+    def parents(self, level: int) -> array:
+        """Cluster at level + 1 of every node (CH_NONE at the top or if excluded)."""
+        return self._array(_lib.ch_parents, level)
+
+    def sizes(self, level: int) -> array:
+        """Level-0 nodes inside every node (0 for excluded level-0 nodes)."""
+        return self._array(_lib.ch_sizes, level)
+
+    def reps(self, level: int) -> array:
+        """Representative (highest-degree) level-0 node of every node."""
+        return self._array(_lib.ch_reps, level)
+
+    def children(self, level: int, node: int) -> List[int]:
+        """Members at level - 1 of a node at level >= 1."""
+        ids = _U32P()
+        n = _lib.ch_children(self._handle(), level, node, ctypes.byref(ids))
+        return ids[:n] if n else []
+
+    def neighbors(self, level: int, node: int) -> List[Tuple[int, float]]:
+        """(neighbour, summed level-0 edge weight) pairs in the level's super-graph."""
+        ids, weights = _U32P(), _F64P()
+        n = _lib.ch_neighbors(self._handle(), level, node, ctypes.byref(ids), ctypes.byref(weights))
+        return list(zip(ids[:n], weights[:n])) if n else []
+
+    def distances(self, level: int, source: int, max_hops: int = CH_NONE) -> array:
+        """Hop distances from source in the level's super-graph (CH_NONE if farther)."""
+        self._check_level(level)
+        out = array('I', bytes(4 * self.level_size(level)))
+        if not _lib.ch_distances(self._handle(), level, source, max_hops, _ptr(out, _U32P)):
+            raise ValueError(f"Node {source} is not in level {level}")
+        return out
+
+    def lift_min(self, level: int, below: array) -> array:
+        """
+        Minimum of a level - 1 per-node array over each node's members.
+
+        Example:
+            dist = [h.distances(0, focus)]
+            for level in range(1, h.levels):
+                dist.append(h.lift_min(level, dist[-1]))   # nearest member
+        """
+        self._check_level(level)
+        if level == 0 or len(below) != self.level_size(level - 1):
+            raise ValueError(f"Need a level {level} >= 1 and one value per level {level - 1} node")
+        below = below if isinstance(below, array) and below.typecode == 'I' else _u32_array(below)
+        out = array('I', bytes(4 * self.level_size(level)))
+        _lib.ch_lift_min(self._handle(), level, _ptr(below, _U32P), _ptr(out, _U32P))
+        return out
+
+    def cut_edges(self, items: Iterable[Tuple[int, int]]) -> List[Tuple[int, int, float]]:
+        """
+        Aggregate edges between the items of a cut.
+
+        Args:
+            items: (level, node) pairs, none inside another
+
+        Returns:
+            (i, j, weight) with i < j indexing items; weight sums the level-0
+            edges between the two items
+        """
+        items = list(items)
+        levels = _u32_array(level for level, _ in items)
+        ids = _u32_array(node for _, node in items)
+        capacity = 4 * len(items)
+        while True:
+            a = array('I', bytes(4 * capacity))
+            b = array('I', bytes(4 * capacity))
+            w = array('d', bytes(8 * capacity))
+            total = _lib.ch_cut_edges(self._handle(), _ptr(levels, _U32P), _ptr(ids, _U32P),
+                                      len(items), _ptr(a, _U32P), _ptr(b, _U32P),
+                                      _ptr(w, _F64P), capacity)
+            if total < 0:
+                raise ValueError("Cut items are invalid or overlap")
+            if total <= capacity:
+                return list(zip(a[:total], b[:total], w[:total]))
+            capacity = total
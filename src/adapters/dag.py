@@ -0,0 +1,87 @@
+"""
+DAG Python Adapter
+
+Python wrapper for the C dag library (depths and shape of hierarchies
+stored as GraphStore views, edges pointing from child to parent).
+This is the ONLY module that uses ctypes for dag.
+"""
+
+import ctypes
+from array import array
+from typing import Any, Dict, Optional, Tuple
+from ._loader import load_library
+from .graph_store import GraphView
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+DAG_CYCLIC = 0xFFFFFFFF
+
+
+class DAGStats(ctypes.Structure):
+    """Hierarchy shape (matches C DAGStats)."""
+    _fields_ = [
+        ("nodes", ctypes.c_size_t),
+        ("edges", ctypes.c_size_t),
+        ("roots", ctypes.c_size_t),
+        ("leaves", ctypes.c_size_t),
+        ("multi_parent", ctypes.c_size_t),
+        ("cyclic", ctypes.c_size_t),
+        ("max_depth", ctypes.c_uint32),
+        ("max_children", ctypes.c_uint32),
+        ("depth_sum", ctypes.c_uint64),
+    ]
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert to Python dictionary."""
+        return {name: getattr(self, name) for name, _ in self._fields_}
+
+
+_U32P = ctypes.POINTER(ctypes.c_uint32)
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.dag_levels.argtypes = [ctypes.c_void_p, _U32P, ctypes.POINTER(DAGStats)]
+_lib.dag_levels.restype = ctypes.c_bool
+
+
+# ============================================================================
+# PYTHON WRAPPER FUNCTIONS
+# ============================================================================
+
+def hierarchy_levels(view: GraphView, depths: bool = True
+                     ) -> Tuple[Optional[array], Dict[str, Any]]:
+    """
+    Depth of every node (longest path up to a root) in one topological pass.
+
+    Args:
+        view: Hierarchy layer, edges from child to parent (must track
+            in-adjacency); self-loops are ignored
+        depths: Also return the per-node depths
+
+    Returns:
+        (depths, stats): depths[n] is node n's depth (0 without edges,
+        DAG_CYCLIC on or below a cycle), None if not requested; stats
+        counts linked nodes, edges, roots, leaves, nodes with several
+        parents and cyclic nodes, with the maximum depth and child count
+        and the sum of depths
+    """
+    out = array('I', bytes(4 * view.node_count)) if depths else None
+    stats = DAGStats()
+    ptr = ctypes.cast(out.buffer_info()[0], _U32P) if out else None
+    if not _lib.dag_levels(view._ptr(), ptr, ctypes.byref(stats)):
+        raise ValueError("Hierarchy levels need a view with in-adjacency "
+                         "(or ran out of memory)")
+    return out, stats.to_dict()
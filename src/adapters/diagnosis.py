@@ -0,0 +1,275 @@
+"""
+Diagnosis Python Adapter
+
+Python wrapper for the C diagnosis library (noisy-OR differential
+diagnosis over weighted disease-symptom links).
+This is the ONLY module that uses ctypes for diagnosis.
+
+Diseases and symptoms are dense indices; see diagnosis.h for the model.
+"""
+
+import ctypes
+from array import array
+from typing import Iterable, List, Optional, Sequence, Tuple
+from ._loader import load_library
+from .graph_store import _u32_array
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+DX_NONE = 0xFFFFFFFF
+
+_U32P = ctypes.POINTER(ctypes.c_uint32)
+_F32P = ctypes.POINTER(ctypes.c_float)
+_F64P = ctypes.POINTER(ctypes.c_double)
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.dx_build.argtypes = [ctypes.c_size_t, ctypes.c_size_t, _U32P, _U32P, _F32P,
+                          ctypes.c_size_t, _F64P, ctypes.c_double]
+_lib.dx_build.restype = ctypes.c_void_p
+
+_lib.dx_free.argtypes = [ctypes.c_void_p]
+_lib.dx_free.restype = None
+
+_lib.dx_disease_count.argtypes = [ctypes.c_void_p]
+_lib.dx_disease_count.restype = ctypes.c_size_t
+
+_lib.dx_symptom_count.argtypes = [ctypes.c_void_p]
+_lib.dx_symptom_count.restype = ctypes.c_size_t
+
+_lib.dx_link_count.argtypes = [ctypes.c_void_p]
+_lib.dx_link_count.restype = ctypes.c_size_t
+
+_lib.dx_diagnose.argtypes = [ctypes.c_void_p, _U32P, ctypes.c_size_t, _U32P, ctypes.c_size_t,
+                             _F64P, _F64P, ctypes.c_size_t, _U32P, _F64P]
+_lib.dx_diagnose.restype = ctypes.c_int64
+
+_lib.dx_observe.argtypes = [ctypes.c_void_p, _F64P, ctypes.c_uint32, ctypes.c_bool, _F64P]
+_lib.dx_observe.restype = ctypes.c_bool
+
+_lib.dx_entropy.argtypes = [_F64P, ctypes.c_size_t]
+_lib.dx_entropy.restype = ctypes.c_double
+
+_lib.dx_questions.argtypes = [ctypes.c_void_p, _F64P, _U32P, ctypes.c_size_t, _F64P, _F64P,
+                              ctypes.c_uint, ctypes.c_size_t, _U32P, _F64P]
+_lib.dx_questions.restype = ctypes.c_int64
+
+_lib.dx_rollup.argtypes = [_F64P, ctypes.c_size_t, _U32P, _U32P, ctypes.c_size_t, _F64P]
+_lib.dx_rollup.restype = ctypes.c_bool
+
+
+# ============================================================================
+# PYTHON WRAPPER CLASS
+# ============================================================================
+
+def _ptr(arr: array, ctype):
+    return ctypes.cast(arr.buffer_info()[0], ctype) if len(arr) else None
+
+
+class DiagnosisModel:
+    """
+    Immutable noisy-OR model; diagnoses are thread-safe.
+
+    Example:
+        model = DiagnosisModel(2, 3, [(0, 0, 0.9), (1, 0, 0.3), (1, 2, 0.8)])
+        ranked, _ = model.diagnose(present=[0], absent=[2], top_k=2)
+    """
+
+    def __init__(self, n_diseases: int, n_symptoms: int,
+                 links: Iterable[Tuple[int, int, float]],
+                 priors: Optional[Sequence[float]] = None, leak: float = 0.01):
+        """
+        Args:
+            n_diseases, n_symptoms: Index ranges
+            links: (disease, symptom, weight) with weight in [0, 1]; a
+                repeated pair keeps its largest weight
+            priors: Positive prior per disease (None = uniform)
+            leak: Probability of a symptom without any modelled cause
+
+        Raises:
+            ValueError: For indices or values out of range
+        """
+        diseases, symptoms, weights = array('I'), array('I'), array('f')
+        try:
+            for d, s, w in links:
+                diseases.append(d)
+                symptoms.append(s)
+                weights.append(w)
+        except (OverflowError, TypeError) as e:
+            raise ValueError(f"Links must be (disease, symptom, weight): {e}") from None
+        prior_arr = None
+        if priors is not None:
+            prior_arr = array('d', priors)
+            if len(prior_arr) != n_diseases:
+                raise ValueError("One prior per disease is required")
+        self._m = _lib.dx_build(n_diseases, n_symptoms, _ptr(diseases, _U32P),
+                                _ptr(symptoms, _U32P), _ptr(weights, _F32P), len(weights),
+                                _ptr(prior_arr, _F64P) if prior_arr is not None else None,
+                                leak)
+        if not self._m:
+            raise ValueError("Index out of range, weight outside [0, 1], non-positive prior "
+                             "or leak outside (0, 1)")
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        """Free the native model."""
+        if getattr(self, '_m', None):
+            _lib.dx_free(self._m)
+            self._m = None
+
+    def _handle(self):
+        if not self._m:
+            raise ValueError("DiagnosisModel is closed")
+        return self._m
+
+    @property
+    def disease_count(self) -> int:
+        return _lib.dx_disease_count(self._handle())
+
+    @property
+    def symptom_count(self) -> int:
+        return _lib.dx_symptom_count(self._handle())
+
+    @property
+    def link_count(self) -> int:
+        return _lib.dx_link_count(self._handle())
+
+    def diagnose(self, present: Iterable[int] = (), absent: Iterable[int] = (),
+                 top_k: int = 5) -> Tuple[List[Tuple[int, float]], array]:
+        """
+        Posterior over the diseases given observed symptoms.
+
+        Args:
+            present: Symptoms observed
+            absent: Symptoms known not to be there
+            top_k: Diseases to rank
+
+        Returns:
+            (ranked, posterior): the top_k (disease, probability) pairs,
+            best first, and the posterior of every disease
+
+        Raises:
+            ValueError: For symptoms out of range or given twice
+        """
+        present, absent = _u32_array(present), _u32_array(absent)
+        m = self._handle()
+        n = _lib.dx_disease_count(m)
+        k = max(0, min(top_k, n))
+        post = array('d', bytes(8 * n))
+        top_ids, top_post = array('I', bytes(4 * k)), array('d', bytes(8 * k))
+        found = _lib.dx_diagnose(m, _ptr(present, _U32P), len(present),
+                                 _ptr(absent, _U32P), len(absent), None, _ptr(post, _F64P),
+                                 k, _ptr(top_ids, _U32P), _ptr(top_post, _F64P))
+        if found < 0:
+            raise ValueError("Symptom out of range or given twice (or out of memory)")
+        return list(zip(top_ids[:found], top_post[:found])), post
+
+    def log_likelihoods(self, present: Iterable[int] = (), absent: Iterable[int] = ()) -> array:
+        """Unnormalised log posterior (log prior + log likelihood) per disease."""
+        present, absent = _u32_array(present), _u32_array(absent)
+        m = self._handle()
+        out = array('d', bytes(8 * _lib.dx_disease_count(m)))
+        if _lib.dx_diagnose(m, _ptr(present, _U32P), len(present), _ptr(absent, _U32P),
+                            len(absent), _ptr(out, _F64P), None, 0, None, None) < 0:
+            raise ValueError("Symptom out of range or given twice (or out of memory)")
+        return out
+
+    def _posterior(self, posterior: Sequence[float]) -> array:
+        post = array('d', posterior)
+        if len(post) != _lib.dx_disease_count(self._handle()):
+            raise ValueError("One probability per disease is required")
+        return post
+
+    def observe(self, posterior: Sequence[float], symptom: int, present: bool) -> array:
+        """
+        Posterior updated with one more answer (O(diseases), without
+        rescoring the earlier evidence).
+
+        Raises:
+            ValueError: For a symptom out of range or a zero posterior
+        """
+        post = self._posterior(posterior)
+        if not 0 <= symptom < _lib.dx_symptom_count(self._handle()) or \
+                not _lib.dx_observe(self._handle(), _ptr(post, _F64P), symptom, present,
+                                    _ptr(post, _F64P)):
+            raise ValueError("Symptom out of range or a posterior summing to 0")
+        return post
+
+    def questions(self, posterior: Sequence[float], skip: Iterable[int] = (),
+                  top_k: int = 5, threads: int = 0) -> Tuple[List[Tuple[int, float]], array]:
+        """
+        Symptoms whose answers are expected to tell the most about the
+        disease (information gain in bits).
+
+        Args:
+            posterior: Probability per disease (e.g. from diagnose)
+            skip: Symptoms already asked
+            top_k: Questions to rank
+            threads: Worker threads for large models (0 = one per CPU)
+
+        Returns:
+            (ranked, p_present): the top_k (symptom, gain) pairs, best
+            first, and every symptom's probability of being present
+
+        Raises:
+            ValueError: For skipped symptoms out of range or a zero posterior
+        """
+        post = self._posterior(posterior)
+        skip = _u32_array(skip)
+        m = self._handle()
+        n = _lib.dx_symptom_count(m)
+        k = max(0, min(top_k, n))
+        p_present = array('d', bytes(8 * n))
+        top_ids, top_gain = array('I', bytes(4 * k)), array('d', bytes(8 * k))
+        found = _lib.dx_questions(m, _ptr(post, _F64P), _ptr(skip, _U32P), len(skip), None,
+                                  _ptr(p_present, _F64P), threads, k,
+                                  _ptr(top_ids, _U32P), _ptr(top_gain, _F64P))
+        if found < 0:
+            raise ValueError("Symptom out of range or a posterior summing to 0")
+        return list(zip(top_ids[:found], top_gain[:found])), p_present
+
+
+def entropy(posterior: Sequence[float]) -> float:
+    """Entropy in bits of a posterior (normalised first)."""
+    post = array('d', posterior)
+    return _lib.dx_entropy(_ptr(post, _F64P), len(post))
+
+
+def rollup_posterior(posterior: Sequence[float], group_of: Sequence[int],
+                     parent: Sequence[int]) -> array:
+    """
+    Total posterior of each group of a classification tree (its diseases
+    and those of the groups below it).
+
+    Args:
+        posterior: Probability per disease
+        group_of: Group per disease (DX_NONE = none)
+        parent: Parent per group (DX_NONE = root)
+
+    Raises:
+        ValueError: For indices out of range or a cycle among the parents
+    """
+    post = array('d', posterior)
+    groups, parents = _u32_array(group_of), _u32_array(parent)
+    if len(groups) != len(post):
+        raise ValueError("One group per disease is required")
+    out = array('d', bytes(8 * len(parents)))
+    if not _lib.dx_rollup(_ptr(post, _F64P), len(post), _ptr(groups, _U32P),
+                          _ptr(parents, _U32P), len(parents), _ptr(out, _F64P)):
+        raise ValueError("Group out of range or a cycle in the hierarchy")
+    return out
@@ -0,0 +1,422 @@
+"""
+GraphStore Python Adapter
+
+Python wrapper for the C graph_store library (dynamic adjacency lists with
+batched, lock-free ingestion and immutable read views).
+This is the ONLY module that uses ctypes for graph_store.
+
+Nodes are dense integer IDs in [0, 2**32); callers map their own names.
+Each Python thread writes through its own native producer, opened on first
+use and closed when the thread exits.
+"""
+
+import ctypes
+import threading
+from array import array
+from typing import Dict, Iterable, List, Optional, Sequence, Tuple
+from ._loader import load_library
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+GS_TRACK_IN = 0x1
+
+_U32P = ctypes.POINTER(ctypes.c_uint32)
+_F32P = ctypes.POINTER(ctypes.c_float)
+
+
+class GSStats(ctypes.Structure):
+    """Store statistics (matches C GSStats)."""
+    _fields_ = [
+        ("version", ctypes.c_uint64),
+        ("nodes", ctypes.c_size_t),
+        ("edges", ctypes.c_size_t),
+        ("merges", ctypes.c_size_t),
+        ("ops_applied", ctypes.c_size_t),
+        ("pending", ctypes.c_size_t),
+        ("producers", ctypes.c_size_t),
+        ("merge_retries", ctypes.c_size_t),
+    ]
+
+    def to_dict(self) -> Dict[str, int]:
+        """Convert to Python dictionary."""
+        return {
+            'version': self.version,
+            'nodes': self.nodes,
+            'edges': self.edges,
+            'merges': self.merges,
+            'ops_applied': self.ops_applied,
+            'pending': self.pending,
+            'producers': self.producers,
+            'merge_retries': self.merge_retries,
+        }
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.gs_create.argtypes = [ctypes.c_uint]
+_lib.gs_create.restype = ctypes.c_void_p
+
+_lib.gs_destroy.argtypes = [ctypes.c_void_p]
+_lib.gs_destroy.restype = None
+
+_lib.gs_producer_open.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+_lib.gs_producer_open.restype = ctypes.c_void_p
+
+_lib.gs_producer_close.argtypes = [ctypes.c_void_p]
+_lib.gs_producer_close.restype = None
+
+_lib.gs_push_insert.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_float]
+_lib.gs_push_insert.restype = None
+
+_lib.gs_push_delete.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32]
+_lib.gs_push_delete.restype = None
+
+_lib.gs_push_inserts.argtypes = [ctypes.c_void_p, _U32P, _U32P, _F32P, ctypes.c_size_t]
+_lib.gs_push_inserts.restype = None
+
+_lib.gs_push_deletes.argtypes = [ctypes.c_void_p, _U32P, _U32P, ctypes.c_size_t]
+_lib.gs_push_deletes.restype = None
+
+_lib.gs_flush.argtypes = [ctypes.c_void_p]
+_lib.gs_flush.restype = ctypes.c_uint64
+
+_lib.gs_stats.argtypes = [ctypes.c_void_p]
+_lib.gs_stats.restype = GSStats
+
+_lib.gs_view_acquire.argtypes = [ctypes.c_void_p]
+_lib.gs_view_acquire.restype = ctypes.c_void_p
+
+_lib.gs_view_release.argtypes = [ctypes.c_void_p]
+_lib.gs_view_release.restype = None
+
+_lib.gs_view_version.argtypes = [ctypes.c_void_p]
+_lib.gs_view_version.restype = ctypes.c_uint64
+
+_lib.gs_view_node_count.argtypes = [ctypes.c_void_p]
+_lib.gs_view_node_count.restype = ctypes.c_size_t
+
+_lib.gs_view_edge_count.argtypes = [ctypes.c_void_p]
+_lib.gs_view_edge_count.restype = ctypes.c_size_t
+
+_lib.gs_view_neighbors.argtypes = [
+    ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(_U32P), ctypes.POINTER(_F32P),
+]
+_lib.gs_view_neighbors.restype = ctypes.c_size_t
+
+_lib.gs_view_in_neighbors.argtypes = [
+    ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(_U32P), ctypes.POINTER(_F32P),
+]
+_lib.gs_view_in_neighbors.restype = ctypes.c_size_t
+
+_lib.gs_view_has_edge.argtypes = [
+    ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.POINTER(ctypes.c_float),
+]
+_lib.gs_view_has_edge.restype = ctypes.c_bool
+
+_lib.gs_view_tracks_in.argtypes = [ctypes.c_void_p]
+_lib.gs_view_tracks_in.restype = ctypes.c_bool
+
+
+def _u32_array(values: Iterable[int]) -> array:
+    try:
+        return array('I', values)
+    except (OverflowError, TypeError) as e:
+        raise ValueError(f"Node IDs must be integers in [0, 2**32): {e}") from None
+
+
+# ============================================================================
+# NATIVE HANDLES
+# ============================================================================
+
+class _Graph:
+    """
+    Owns the C GraphStore; producers and views keep it alive.
+
+    The garbage collector may finalize a whole unreachable group in any
+    order, so the graph closes producers still open before destroying.
+    """
+
+    def __init__(self, flags: int):
+        self.ptr = _lib.gs_create(flags)
+        self.producers = set()
+
+    def __del__(self):
+        if getattr(self, 'ptr', None):
+            for producer in self.producers:
+                _lib.gs_producer_close(producer)
+            _lib.gs_destroy(self.ptr)
+            self.ptr = None
+
+
+class _Producer:
+    """One thread's C producer, closed when the thread's locals go away."""
+
+    def __init__(self, graph: _Graph, ring_capacity: int):
+        self.graph = graph
+        self.ptr = _lib.gs_producer_open(graph.ptr, ring_capacity)
+        if not self.ptr:
+            raise MemoryError("Failed to open graph producer")
+        graph.producers.add(self.ptr)
+
+    def __del__(self):
+        ptr, self.ptr = getattr(self, 'ptr', None), None
+        if ptr and self.graph.ptr:
+            self.graph.producers.discard(ptr)
+            _lib.gs_producer_close(ptr)
+
+
+# ============================================================================
+# PYTHON WRAPPER CLASSES
+# ============================================================================
+
+class GraphView:
+    """
+    Immutable version of a GraphStore.
+
+    Merges after the view was taken are not visible.  Release it (or use it
+    as a context manager) so old versions can be freed.
+    """
+
+    def __init__(self, graph: _Graph):
+        self._graph = graph
+        self._view = _lib.gs_view_acquire(graph.ptr)
+
+    def __del__(self):
+        self.release()
+
+    def release(self):
+        """Unpin this version; the view is unusable afterwards."""
+        if getattr(self, '_view', None):
+            _lib.gs_view_release(self._view)
+            self._view = None
+
+    def __enter__(self) -> 'GraphView':
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        self.release()
+
+    def _ptr(self) -> int:
+        if not self._view:
+            raise ValueError("View has been released")
+        return self._view
+
+    @property
+    def version(self) -> int:
+        return _lib.gs_view_version(self._ptr())
+
+    @property
+    def node_count(self) -> int:
+        """Highest node ID + 1."""
+        return _lib.gs_view_node_count(self._ptr())
+
+    @property
+    def edge_count(self) -> int:
+        return _lib.gs_view_edge_count(self._ptr())
+
+    @property
+    def tracks_in(self) -> bool:
+        """True if in_neighbors is available."""
+        return _lib.gs_view_tracks_in(self._ptr())
+
+    def _list(self, fn, node: int, weights: bool):
+        ids, ws = _U32P(), _F32P()
+        n = fn(self._ptr(), node, ctypes.byref(ids), ctypes.byref(ws))
+        if not weights:
+            return ids[:n]
+        return list(zip(ids[:n], ws[:n]))
+
+    def neighbors(self, node: int) -> List[int]:
+        """Out-neighbor IDs of node, ascending."""
+        return self._list(_lib.gs_view_neighbors, node, False)
+
+    def weighted_neighbors(self, node: int) -> List[Tuple[int, float]]:
+        """(neighbor, weight) pairs of node, ascending by neighbor."""
+        return self._list(_lib.gs_view_neighbors, node, True)
+
+    def in_neighbors(self, node: int) -> List[int]:
+        """
+        In-neighbor IDs of node, ascending.
+
+        Raises:
+            ValueError: If the store was created with track_in=False
+        """
+        if not self.tracks_in:
+            raise ValueError("Store does not track in-neighbors")
+        return self._list(_lib.gs_view_in_neighbors, node, False)
+
+    def in_neighbors_from(self, node: int, start: int = 0,
+                          limit: Optional[int] = None) -> List[int]:
+        """
+        One page of in_neighbors: the IDs >= start, ascending, at most
+        limit.  Only the page is copied, so paging a wide node is cheap.
+
+        Raises:
+            ValueError: If the store was created with track_in=False
+        """
+        if not self.tracks_in:
+            raise ValueError("Store does not track in-neighbors")
+        ids, ws = _U32P(), _F32P()
+        n = _lib.gs_view_in_neighbors(self._ptr(), node, ctypes.byref(ids), ctypes.byref(ws))
+        lo, hi = 0, n
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if ids[mid] < start:
+                lo = mid + 1
+            else:
+                hi = mid
+        end = n if limit is None else min(n, lo + max(limit, 0))
+        return ids[lo:end]
+
+    def degree(self, node: int) -> int:
+        return _lib.gs_view_neighbors(self._ptr(), node, None, None)
+
+    def in_degree(self, node: int) -> int:
+        """
+        Number of in-neighbors (a stored length, O(1)).
+
+        Raises:
+            ValueError: If the store was created with track_in=False
+        """
+        if not self.tracks_in:
+            raise ValueError("Store does not track in-neighbors")
+        return _lib.gs_view_in_neighbors(self._ptr(), node, None, None)
+
+    def edge_weight(self, src: int, dst: int) -> Optional[float]:
+        """Weight of src -> dst, or None if absent."""
+        w = ctypes.c_float()
+        if _lib.gs_view_has_edge(self._ptr(), src, dst, ctypes.byref(w)):
+            return w.value
+        return None
+
+    def has_edge(self, src: int, dst: int) -> bool:
+        return _lib.gs_view_has_edge(self._ptr(), src, dst, None)
+
+    def __repr__(self) -> str:
+        if not self._view:
+            return "<GraphView released>"
+        return f"<GraphView version={self.version} nodes={self.node_count} edges={self.edge_count}>"
+
+
+class GraphStore:
+    """
+    Directed, weighted adjacency store for bulk and concurrent ingestion.
+
+    Writes are queued and merged in the background; call flush() before
+    reading your own writes.  Views never block writers or the merger.
+
+    Example:
+        g = GraphStore()
+        g.add_edges([0, 0, 1], [1, 2, 2])
+        g.flush()
+        with g.view() as v:
+            v.neighbors(0)        # [1, 2]
+    """
+
+    def __init__(self, track_in: bool = True, ring_capacity: int = 0):
+        """
+        Create an empty store.
+
+        Args:
+            track_in: Also maintain in-neighbor lists
+            ring_capacity: Per-thread queue size in ops (0 = default)
+
+        Raises:
+            MemoryError: If store creation fails
+        """
+        self._graph = _Graph(GS_TRACK_IN if track_in else 0)
+        if not self._graph.ptr:
+            raise MemoryError("Failed to create graph store")
+        self._ring_capacity = ring_capacity
+        self._local = threading.local()
+
+    def _producer(self) -> int:
+        producer = getattr(self._local, 'producer', None)
+        if producer is None:
+            producer = self._local.producer = _Producer(self._graph, self._ring_capacity)
+        return producer.ptr
+
+    # ========================================================================
+    # WRITES
+    # ========================================================================
+
+    def add_edge(self, src: int, dst: int, weight: float = 1.0):
+        """Queue an edge insert (re-adding an edge updates its weight)."""
+        _lib.gs_push_insert(self._producer(), src, dst, weight)
+
+    def delete_edge(self, src: int, dst: int):
+        """Queue an edge delete."""
+        _lib.gs_push_delete(self._producer(), src, dst)
+
+    def add_edges(self, src: Sequence[int], dst: Sequence[int],
+                  weights: Optional[Sequence[float]] = None):
+        """
+        Queue src[i] -> dst[i] for every i in one native call.
+
+        Raises:
+            ValueError: If the sequences differ in length or hold invalid IDs
+        """
+        s, d = _u32_array(src), _u32_array(dst)
+        if len(s) != len(d) or (weights is not None and len(weights) != len(s)):
+            raise ValueError("src, dst and weights must have the same length")
+        if not s:
+            return
+        w = array('f', weights) if weights is not None else None
+        _lib.gs_push_inserts(
+            self._producer(),
+            ctypes.cast(s.buffer_info()[0], _U32P),
+            ctypes.cast(d.buffer_info()[0], _U32P),
+            ctypes.cast(w.buffer_info()[0], _F32P) if w is not None else None,
+            len(s),
+        )
+
+    def delete_edges(self, src: Sequence[int], dst: Sequence[int]):
+        """Queue src[i] -> dst[i] deletes in one native call."""
+        s, d = _u32_array(src), _u32_array(dst)
+        if len(s) != len(d):
+            raise ValueError("src and dst must have the same length")
+        if not s:
+            return
+        _lib.gs_push_deletes(
+            self._producer(),
+            ctypes.cast(s.buffer_info()[0], _U32P),
+            ctypes.cast(d.buffer_info()[0], _U32P),
+            len(s),
+        )
+
+    def flush(self) -> int:
+        """
+        Wait until every write queued (by any thread) so far is visible.
+
+        Returns:
+            The version containing them
+        """
+        return _lib.gs_flush(self._graph.ptr)
+
+    # ========================================================================
+    # READS
+    # ========================================================================
+
+    def view(self) -> GraphView:
+        """Pin the latest published version."""
+        return GraphView(self._graph)
+
+    def stats(self) -> Dict[str, int]:
+        """Version, counts, merge totals and queued ops."""
+        return _lib.gs_stats(self._graph.ptr).to_dict()
+
+    def __repr__(self) -> str:
+        s = self.stats()
+        return f"<GraphStore version={s['version']} nodes={s['nodes']} edges={s['edges']}>"
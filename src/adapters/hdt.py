@@ -0,0 +1,335 @@
+"""
+HDT Python Adapter
+
+Python wrapper for the C hdt library (compressed, queryable RDF files
+with a front-coded dictionary and bitmap triples).
+This is the ONLY module that uses ctypes for hdt.
+
+Terms are strings in N-Triples syntax (what rdflib's term.n3() returns);
+the file treats them as opaque.  See hdt.h for the format.
+"""
+
+import ctypes
+import os
+from array import array
+from typing import Dict, Iterable, Iterator, List, Optional, Sequence, Tuple
+from ._loader import load_library
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+HDT_ANY = 0xFFFFFFFFFFFFFFFF
+
+SUBJECT, PREDICATE, OBJECT = 0, 1, 2
+
+_U64P = ctypes.POINTER(ctypes.c_uint64)
+
+
+class HDTStats(ctypes.Structure):
+    """
+    File statistics structure (matches C HDTStats).
+    """
+    _fields_ = [
+        ("triples", ctypes.c_uint64),
+        ("shared", ctypes.c_uint64),
+        ("subjects", ctypes.c_uint64),
+        ("predicates", ctypes.c_uint64),
+        ("objects", ctypes.c_uint64),
+        ("bytes", ctypes.c_uint64),
+        ("dictionary_bytes", ctypes.c_uint64),
+    ]
+
+    def to_dict(self) -> Dict[str, int]:
+        """Convert to Python dictionary."""
+        return {name: getattr(self, name) for name, _ in self._fields_}
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.hdt_writer_create.argtypes = []
+_lib.hdt_writer_create.restype = ctypes.c_void_p
+
+_lib.hdt_writer_free.argtypes = [ctypes.c_void_p]
+_lib.hdt_writer_free.restype = None
+
+_lib.hdt_writer_add.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t,
+                                ctypes.c_char_p, ctypes.c_size_t,
+                                ctypes.c_char_p, ctypes.c_size_t]
+_lib.hdt_writer_add.restype = ctypes.c_bool
+
+_lib.hdt_writer_save.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.POINTER(HDTStats)]
+_lib.hdt_writer_save.restype = ctypes.c_bool
+
+_lib.hdt_open.argtypes = [ctypes.c_char_p]
+_lib.hdt_open.restype = ctypes.c_void_p
+
+_lib.hdt_close.argtypes = [ctypes.c_void_p]
+_lib.hdt_close.restype = None
+
+_lib.hdt_stats.argtypes = [ctypes.c_void_p, ctypes.POINTER(HDTStats)]
+_lib.hdt_stats.restype = None
+
+_lib.hdt_term_count.argtypes = [ctypes.c_void_p, ctypes.c_uint]
+_lib.hdt_term_count.restype = ctypes.c_uint64
+
+_lib.hdt_lookup.argtypes = [ctypes.c_void_p, ctypes.c_uint, ctypes.c_char_p, ctypes.c_size_t]
+_lib.hdt_lookup.restype = ctypes.c_int64
+
+_lib.hdt_terms.argtypes = [ctypes.c_void_p, ctypes.c_uint, _U64P, ctypes.c_size_t,
+                           ctypes.c_char_p, ctypes.c_size_t, _U64P]
+_lib.hdt_terms.restype = ctypes.c_int64
+
+_lib.hdt_search.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_uint64, ctypes.c_uint64]
+_lib.hdt_search.restype = ctypes.c_void_p
+
+_lib.hdt_iter_free.argtypes = [ctypes.c_void_p]
+_lib.hdt_iter_free.restype = None
+
+_lib.hdt_iter_next.argtypes = [ctypes.c_void_p, _U64P, ctypes.c_size_t]
+_lib.hdt_iter_next.restype = ctypes.c_size_t
+
+_lib.hdt_count.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_uint64, ctypes.c_uint64]
+_lib.hdt_count.restype = ctypes.c_int64
+
+
+# ============================================================================
+# PYTHON WRAPPER CLASS
+# ============================================================================
+
+_BATCH = 1024           # triples fetched per native call
+
+Triple = Tuple[str, str, str]
+
+
+def _ptr(arr: array, ctype):
+    return ctypes.cast(arr.buffer_info()[0], ctype) if len(arr) else None
+
+
+class HDTWriter:
+    """
+    Collects triples and writes them as an HDT file.
+
+    Example:
+        writer = HDTWriter()
+        writer.add("<http://ex.org/a>", "<http://ex.org/p>", '"label"@en')
+        stats = writer.save("vocab.hdt")
+    """
+
+    def __init__(self):
+        self._w = _lib.hdt_writer_create()
+        if not self._w:
+            raise MemoryError("Failed to create HDT writer")
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        """Free the native writer."""
+        if getattr(self, '_w', None):
+            _lib.hdt_writer_free(self._w)
+            self._w = None
+
+    def _handle(self):
+        if not self._w:
+            raise ValueError("HDTWriter is closed")
+        return self._w
+
+    def add(self, s: str, p: str, o: str):
+        """Add one triple (duplicates are dropped on save)."""
+        s, p, o = s.encode(), p.encode(), o.encode()
+        if not _lib.hdt_writer_add(self._handle(), s, len(s), p, len(p), o, len(o)):
+            raise MemoryError("Failed to add triple")
+
+    def add_all(self, triples: Iterable[Triple]) -> int:
+        """Add many triples; returns how many were given."""
+        n = 0
+        for s, p, o in triples:
+            self.add(s, p, o)
+            n += 1
+        return n
+
+    def save(self, path: str) -> Dict[str, int]:
+        """
+        Write the file, replacing path.
+
+        Returns:
+            Statistics: triples, terms per dictionary section, bytes
+
+        Raises:
+            OSError: If the file cannot be written
+        """
+        stats = HDTStats()
+        if not _lib.hdt_writer_save(self._handle(), os.fsencode(path), ctypes.byref(stats)):
+            raise OSError(f"Failed to write HDT file: {path}")
+        return stats.to_dict()
+
+
+class HDTFile:
+    """
+    Read-only, memory-mapped HDT file; queries are thread-safe.
+
+    Example:
+        vocab = HDTFile("vocab.hdt")
+        for s, p, o in vocab.search(p="<http://www.w3.org/2000/01/rdf-schema#label>"):
+            ...
+    """
+
+    def __init__(self, path: str):
+        """
+        Raises:
+            OSError: If the file cannot be read or is not an HDT file
+        """
+        self._h = _lib.hdt_open(os.fsencode(path))
+        if not self._h:
+            raise OSError(f"Not a readable HDT file: {path}")
+        self.path = path
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        """Unmap the file."""
+        if getattr(self, '_h', None):
+            _lib.hdt_close(self._h)
+            self._h = None
+
+    def _handle(self):
+        if not self._h:
+            raise ValueError("HDTFile is closed")
+        return self._h
+
+    def stats(self) -> Dict[str, int]:
+        stats = HDTStats()
+        _lib.hdt_stats(self._handle(), ctypes.byref(stats))
+        return stats.to_dict()
+
+    @property
+    def triple_count(self) -> int:
+        return _lib.hdt_count(self._handle(), HDT_ANY, HDT_ANY, HDT_ANY)
+
+    def term_count(self, role: int) -> int:
+        """Distinct terms used as SUBJECT, PREDICATE or OBJECT."""
+        return _lib.hdt_term_count(self._handle(), role)
+
+    def lookup(self, term: str, role: int) -> Optional[int]:
+        """ID of a term in a role, or None if it never appears there."""
+        raw = term.encode()
+        found = _lib.hdt_lookup(self._handle(), role, raw, len(raw))
+        return found if found >= 0 else None
+
+    def terms(self, ids: Sequence[int], role: int) -> List[str]:
+        """
+        Terms for IDs of one role.
+
+        Raises:
+            ValueError: For an ID out of range
+        """
+        ids = array('Q', ids)
+        ends = array('Q', bytes(8 * len(ids)))
+        cap = 64 * len(ids)
+        while True:
+            buf = ctypes.create_string_buffer(max(cap, 1))
+            need = _lib.hdt_terms(self._handle(), role, _ptr(ids, _U64P), len(ids), buf, cap,
+                                  _ptr(ends, _U64P))
+            if need < 0:
+                raise ValueError("Term ID out of range")
+            if need <= cap:
+                break
+            cap = need
+        raw, out, start = buf.raw, [], 0
+        for end in ends:
+            out.append(raw[start:end].decode())
+            start = end
+        return out
+
+    def _pattern(self, s: Optional[str], p: Optional[str], o: Optional[str]):
+        """IDs of a pattern's bound terms (HDT_ANY if unbound); None if one is unknown."""
+        ids = []
+        for term, role in ((s, SUBJECT), (p, PREDICATE), (o, OBJECT)):
+            if term is None:
+                ids.append(HDT_ANY)
+                continue
+            found = self.lookup(term, role)
+            if found is None:
+                return None
+            ids.append(found)
+        return ids
+
+    def search_ids(self, s: int = HDT_ANY, p: int = HDT_ANY, o: int = HDT_ANY,
+                   offset: int = 0) -> Iterator[Tuple[int, int, int]]:
+        """
+        ID triples matching a pattern, in subject, predicate, object order.
+
+        Raises:
+            ValueError: For an ID out of range
+        """
+        it = _lib.hdt_search(self._handle(), s, p, o)
+        if not it:
+            raise ValueError("Term ID out of range")
+        try:
+            while offset > 0:
+                skipped = _lib.hdt_iter_next(it, None, offset)
+                if skipped == 0:
+                    return
+                offset -= skipped
+            out = array('Q', bytes(8 * 3 * _BATCH))
+            while True:
+                n = _lib.hdt_iter_next(it, _ptr(out, _U64P), _BATCH)
+                if n == 0:
+                    return
+                for i in range(n):
+                    yield out[3 * i], out[3 * i + 1], out[3 * i + 2]
+        finally:
+            _lib.hdt_iter_free(it)
+
+    def search(self, s: Optional[str] = None, p: Optional[str] = None,
+               o: Optional[str] = None, limit: Optional[int] = None,
+               offset: int = 0) -> Iterator[Triple]:
+        """
+        Triples matching a pattern (None = any term), decoded in batches.
+
+        Args:
+            s, p, o: Bound terms in N-Triples syntax, or None
+            limit: Maximum triples to return (None = all)
+            offset: Matches to skip first
+        """
+        ids = self._pattern(s, p, o)
+        if ids is None or limit == 0:
+            return
+        batch: List[Tuple[int, int, int]] = []
+        remaining = limit
+        for triple in self.search_ids(*ids, offset=max(offset, 0)):
+            batch.append(triple)
+            if remaining is not None:
+                remaining -= 1
+            if len(batch) == _BATCH or remaining == 0:
+                yield from self._decode(batch)
+                batch = []
+                if remaining == 0:
+                    return
+        yield from self._decode(batch)
+
+    def _decode(self, batch: List[Tuple[int, int, int]]) -> Iterator[Triple]:
+        columns = []
+        for role in (SUBJECT, PREDICATE, OBJECT):
+            distinct = sorted({t[role] for t in batch})
+            columns.append(dict(zip(distinct, self.terms(distinct, role))))
+        for s, p, o in batch:
+            yield columns[0][s], columns[1][p], columns[2][o]
+
+    def count(self, s: Optional[str] = None, p: Optional[str] = None,
+              o: Optional[str] = None) -> int:
+        """Number of triples matching a pattern (None = any term)."""
+        ids = self._pattern(s, p, o)
+        return _lib.hdt_count(self._handle(), *ids) if ids is not None else 0
@@ -0,0 +1,222 @@
+"""
+IntTable Python Adapter
+
+Python wrapper for the C int_table family (integer key -> integer value).
+This is the ONLY module that uses ctypes for int_table.
+
+Variants:
+- IntMap32: uint32 keys -> uint32 values (ID -> slot maps)
+- IntMap64: uint64 keys -> uint64 values (ID -> offset maps)
+"""
+
+import ctypes
+from typing import Dict, Iterable, List, Optional
+from ._loader import load_library
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+def _declare(prefix: str, c_int) -> None:
+    """Declare the signatures of one variant (all share the same shape)."""
+    fn = lambda name: getattr(_lib, f"{prefix}_{name}")
+
+    fn("create").argtypes = [ctypes.c_size_t]
+    fn("create").restype = ctypes.c_void_p
+
+    fn("create_dense").argtypes = [c_int]
+    fn("create_dense").restype = ctypes.c_void_p
+
+    fn("destroy").argtypes = [ctypes.c_void_p]
+    fn("destroy").restype = None
+
+    fn("put").argtypes = [ctypes.c_void_p, c_int, c_int]
+    fn("put").restype = ctypes.c_bool
+
+    fn("get").argtypes = [ctypes.c_void_p, c_int, ctypes.POINTER(c_int)]
+    fn("get").restype = ctypes.c_bool
+
+    fn("remove").argtypes = [ctypes.c_void_p, c_int]
+    fn("remove").restype = ctypes.c_bool
+
+    fn("clear").argtypes = [ctypes.c_void_p]
+    fn("clear").restype = None
+
+    for name in ("count", "capacity"):
+        fn(name).argtypes = [ctypes.c_void_p]
+        fn(name).restype = ctypes.c_size_t
+
+    fn("is_dense").argtypes = [ctypes.c_void_p]
+    fn("is_dense").restype = ctypes.c_bool
+
+    fn("get_many").argtypes = [
+        ctypes.c_void_p, ctypes.POINTER(c_int), ctypes.c_size_t,
+        ctypes.POINTER(c_int), ctypes.POINTER(ctypes.c_uint8),
+    ]
+    fn("get_many").restype = ctypes.c_size_t
+
+
+_declare("imap32", ctypes.c_uint32)
+_declare("imap64", ctypes.c_uint64)
+
+
+# ============================================================================
+# PYTHON WRAPPER CLASSES
+# ============================================================================
+
+class _IntMap:
+    """
+    Shared implementation; subclasses pick the C variant.
+
+    Supports dict-style access (m[k], m[k] = v, del m[k], k in m, len(m)).
+    """
+
+    _PREFIX = ""
+    _C_INT = ctypes.c_uint32
+    _BITS = 32
+
+    def __init__(self, capacity: int = 0, dense_max_key: Optional[int] = None):
+        """
+        Create a table.
+
+        Args:
+            capacity: Expected number of keys (presizes a hashed table)
+            dense_max_key: If given, create a direct-mapped table for keys
+                in [0, dense_max_key] instead of a hashed one
+
+        Raises:
+            ValueError: If dense_max_key is out of range
+            MemoryError: If allocation fails
+        """
+        if dense_max_key is not None:
+            self._check(dense_max_key)
+            self._t = self._fn("create_dense")(dense_max_key)
+        else:
+            self._t = self._fn("create")(capacity)
+        if not self._t:
+            raise MemoryError("Failed to create integer table")
+
+    @classmethod
+    def _fn(cls, name: str):
+        return getattr(_lib, f"{cls._PREFIX}_{name}")
+
+    def _check(self, n: int) -> int:
+        if not isinstance(n, int) or isinstance(n, bool):
+            raise TypeError("Keys and values must be integers")
+        if n < 0 or n >> self._BITS:
+            raise ValueError(f"{n} does not fit in uint{self._BITS}")
+        return n
+
+    def __del__(self):
+        if getattr(self, '_t', None):
+            self._fn("destroy")(self._t)
+            self._t = None
+
+    # ========================================================================
+    # OPERATIONS
+    # ========================================================================
+
+    def put(self, key: int, value: int) -> bool:
+        """
+        Insert or update.
+
+        Returns:
+            False if a dense table's key is out of range
+        """
+        return self._fn("put")(self._t, self._check(key), self._check(value))
+
+    def get(self, key: int, default: Optional[int] = None) -> Optional[int]:
+        """Value for key, or default if absent."""
+        out = self._C_INT()
+        if self._fn("get")(self._t, self._check(key), ctypes.byref(out)):
+            return out.value
+        return default
+
+    def remove(self, key: int) -> bool:
+        """Remove key.  Returns True if it was present."""
+        return self._fn("remove")(self._t, self._check(key))
+
+    def clear(self) -> None:
+        """Remove all keys."""
+        self._fn("clear")(self._t)
+
+    def get_many(self, keys: Iterable[int]) -> List[Optional[int]]:
+        """
+        Batched lookup (hashes and prefetches ahead of the probes).
+
+        Returns:
+            Values in key order, None for missing keys
+        """
+        keys = [self._check(k) for k in keys]
+        n = len(keys)
+        if n == 0:
+            return []
+
+        c_keys = (self._C_INT * n)(*keys)
+        c_vals = (self._C_INT * n)()
+        found = (ctypes.c_uint8 * n)()
+        self._fn("get_many")(self._t, c_keys, n, c_vals, found)
+        return [c_vals[i] if found[i] else None for i in range(n)]
+
+    @property
+    def dense(self) -> bool:
+        """True for a direct-mapped table."""
+        return self._fn("is_dense")(self._t)
+
+    def stats(self) -> Dict[str, int]:
+        """Size information: count, capacity (slots or key range), dense."""
+        return {
+            'count': self._fn("count")(self._t),
+            'capacity': self._fn("capacity")(self._t),
+            'dense': self.dense,
+        }
+
+    # ========================================================================
+    # PYTHONIC INTERFACE
+    # ========================================================================
+
+    def __len__(self) -> int:
+        return self._fn("count")(self._t)
+
+    def __contains__(self, key: int) -> bool:
+        return self.get(key) is not None
+
+    def __getitem__(self, key: int) -> int:
+        value = self.get(key)
+        if value is None:
+            raise KeyError(key)
+        return value
+
+    def __setitem__(self, key: int, value: int) -> None:
+        if not self.put(key, value):
+            raise KeyError(f"Key {key} outside dense range")
+
+    def __delitem__(self, key: int) -> None:
+        if not self.remove(key):
+            raise KeyError(key)
+
+    def __repr__(self) -> str:
+        kind = "dense" if self.dense else "hashed"
+        return f"<{type(self).__name__} {kind} count={len(self)}>"
+
+
+class IntMap32(_IntMap):
+    """uint32 -> uint32 table (e.g. dictionary-encoded node ID -> slot)."""
+    _PREFIX = "imap32"
+    _C_INT = ctypes.c_uint32
+    _BITS = 32
+
+
+class IntMap64(_IntMap):
+    """uint64 -> uint64 table (e.g. ID -> byte offset)."""
+    _PREFIX = "imap64"
+    _C_INT = ctypes.c_uint64
+    _BITS = 64
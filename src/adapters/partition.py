@@ -0,0 +1,91 @@
+"""
+Partition Python Adapter
+
+Python wrapper for the C partition library (multilevel K-way partitioning
+of a coarsening Hierarchy).
+This is the ONLY module that uses ctypes for partition.
+
+Parts are balanced by level-0 node count and chosen to cut little edge
+weight; see partition.h for the coarsen / partition / refine scheme.
+"""
+
+import ctypes
+from array import array
+from typing import Any, Dict, Tuple
+from ._loader import load_library
+from .coarsen import Hierarchy
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+class PTStats(ctypes.Structure):
+    """Partition statistics (matches C PTStats)."""
+    _fields_ = [
+        ("cut", ctypes.c_double),
+        ("cut_edges", ctypes.c_size_t),
+        ("largest", ctypes.c_size_t),
+        ("smallest", ctypes.c_size_t),
+        ("moves", ctypes.c_size_t),
+    ]
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert to Python dictionary."""
+        return {name: getattr(self, name) for name, _ in self._fields_}
+
+
+_U32P = ctypes.POINTER(ctypes.c_uint32)
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.pt_partition.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_double,
+                              ctypes.c_uint64, _U32P, ctypes.POINTER(PTStats)]
+_lib.pt_partition.restype = ctypes.c_bool
+
+
+# ============================================================================
+# PYTHON WRAPPER FUNCTIONS
+# ============================================================================
+
+def partition(hierarchy: Hierarchy, k: int, imbalance: float = 0.03,
+              seed: int = 0) -> Tuple[array, Dict[str, Any]]:
+    """
+    Split the level-0 nodes of a hierarchy into k parts.
+
+    Example:
+        with store.view() as view:
+            h = Hierarchy(view, min_nodes=16 * k)
+        parts, stats = partition(h, k)
+
+    Args:
+        hierarchy: Coarsening of the graph to split
+        k: Number of parts
+        imbalance: Parts may exceed total / k nodes by this fraction
+        seed: Seed of the initial partition (reproducible per seed)
+
+    Returns:
+        (parts, stats): the part of every level-0 node; stats has the cut
+        weight and edge count, the largest and smallest part sizes and the
+        refinement moves made
+    """
+    if k < 1 or not imbalance >= 0:
+        raise ValueError("Need k >= 1 and a non-negative imbalance")
+    n = hierarchy.level_size(0)
+    parts = array('I', bytes(4 * n))
+    stats = PTStats()
+    if not _lib.pt_partition(hierarchy._handle(), k, imbalance, seed,
+                             ctypes.cast(parts.buffer_info()[0], _U32P) if n else None,
+                             ctypes.byref(stats)):
+        raise MemoryError("Failed to partition graph")
+    return parts, stats.to_dict()
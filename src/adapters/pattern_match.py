@@ -0,0 +1,214 @@
+"""
+Pattern Match Python Adapter
+
+Python wrapper for the C pattern_match library (subgraph matching over
+GraphStore views with a worst-case-optimal join).
+This is the ONLY module that uses ctypes for pattern_match.
+
+A Pattern is built from variables (optionally restricted to candidate node
+IDs) and pattern edges, each bound to the GraphView its data edges come
+from.  Matches are tuples of node IDs in variable order.
+"""
+
+import ctypes
+from typing import Callable, Dict, Iterable, List, Optional, Tuple
+from ._loader import load_library
+from .graph_store import GraphView, _u32_array
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+PM_MAX_VARS = 16
+PM_MAX_EDGES = 64
+PM_BREAK_SYMMETRY = 0x1
+
+_U32P = ctypes.POINTER(ctypes.c_uint32)
+
+# An empty array has no buffer (address 0), which C reads as "any node";
+# empty candidate lists point here instead, with n_candidates = 0
+_NO_CANDIDATES = (ctypes.c_uint32 * 1)()
+
+
+class PMVar(ctypes.Structure):
+    """Pattern variable (matches C PMVar)."""
+    _fields_ = [
+        ("candidates", _U32P),
+        ("n_candidates", ctypes.c_size_t),
+        ("klass", ctypes.c_uint32),
+    ]
+
+
+class PMEdge(ctypes.Structure):
+    """Pattern edge (matches C PMEdge)."""
+    _fields_ = [
+        ("src", ctypes.c_uint32),
+        ("dst", ctypes.c_uint32),
+        ("view", ctypes.c_void_p),
+        ("undirected", ctypes.c_bool),
+    ]
+
+
+class PMStats(ctypes.Structure):
+    """Match statistics (matches C PMStats)."""
+    _fields_ = [
+        ("matches", ctypes.c_size_t),
+        ("automorphisms", ctypes.c_size_t),
+        ("threads", ctypes.c_uint),
+        ("stopped", ctypes.c_bool),
+    ]
+
+    def to_dict(self) -> Dict[str, int]:
+        """Convert to Python dictionary."""
+        return {
+            'matches': self.matches,
+            'automorphisms': self.automorphisms,
+            'threads': self.threads,
+            'stopped': self.stopped,
+        }
+
+
+_PMCallback = ctypes.CFUNCTYPE(ctypes.c_bool, _U32P, ctypes.c_size_t, ctypes.c_void_p)
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.pm_match.argtypes = [
+    ctypes.POINTER(PMVar), ctypes.c_size_t,
+    ctypes.POINTER(PMEdge), ctypes.c_size_t,
+    ctypes.c_uint, ctypes.c_uint, ctypes.c_size_t,
+    _PMCallback, ctypes.c_void_p, ctypes.POINTER(PMStats),
+]
+_lib.pm_match.restype = ctypes.c_int64
+
+
+# ============================================================================
+# PYTHON WRAPPER CLASS
+# ============================================================================
+
+class Pattern:
+    """
+    Small labeled pattern to match against GraphStore views.
+
+    Example:
+        p = Pattern()
+        a, s, b = p.add_var(diseases, klass=1), p.add_var(), p.add_var(diseases, klass=1)
+        p.add_edge(a, s, has_symptom_view)
+        p.add_edge(b, s, has_symptom_view)
+        pairs = p.match()          # each {a, b} pair once per shared symptom
+    """
+
+    def __init__(self):
+        self._vars: List[Tuple[Optional[object], int]] = []
+        self._edges: List[Tuple[int, int, GraphView, bool]] = []
+
+    @property
+    def var_count(self) -> int:
+        return len(self._vars)
+
+    def add_var(self, candidates: Optional[Iterable[int]] = None, klass: int = 0) -> int:
+        """
+        Add a variable.
+
+        Args:
+            candidates: Node IDs it may bind to (None = any node)
+            klass: Symmetry class; only variables of equal class (and equal
+                candidates) are treated as interchangeable
+
+        Returns:
+            Variable index
+        """
+        if len(self._vars) >= PM_MAX_VARS:
+            raise ValueError(f"Patterns are limited to {PM_MAX_VARS} variables")
+        ids = None
+        if candidates is not None:
+            ids = _u32_array(sorted(set(candidates)))
+        self._vars.append((ids, klass))
+        return len(self._vars) - 1
+
+    def add_edge(self, src: int, dst: int, view: GraphView, undirected: bool = False):
+        """Require an edge src -> dst (either direction if undirected) in view."""
+        if len(self._edges) >= PM_MAX_EDGES:
+            raise ValueError(f"Patterns are limited to {PM_MAX_EDGES} edges")
+        if not (0 <= src < len(self._vars) and 0 <= dst < len(self._vars)):
+            raise ValueError("Pattern edge refers to an unknown variable")
+        if not view.tracks_in:
+            raise ValueError("Pattern views must track in-adjacency")
+        self._edges.append((src, dst, view, undirected))
+
+    def stream(self, on_rows: Callable[[List[Tuple[int, ...]]], Optional[bool]],
+               limit: int = 0, threads: int = 0, break_symmetry: bool = True) -> Dict[str, int]:
+        """
+        Run the match, passing batches of matches to on_rows as they are found.
+
+        on_rows is called from matcher threads, one call at a time; returning
+        False stops the search.  An exception in on_rows stops the search and
+        is re-raised here.
+
+        Args:
+            limit: Stop after this many matches (0 = all)
+            threads: Worker threads (0 = one per CPU)
+            break_symmetry: Report each subgraph once rather than once per
+                automorphism of the pattern
+
+        Returns:
+            Statistics: matches, automorphisms, threads, stopped
+        """
+        n_vars = len(self._vars)
+        if n_vars == 0:
+            raise ValueError("Pattern has no variables")
+
+        vars_arr = (PMVar * n_vars)()
+        for i, (ids, klass) in enumerate(self._vars):
+            if ids is not None:
+                addr, n = ids.buffer_info()
+                vars_arr[i].candidates = ctypes.cast(addr if n else _NO_CANDIDATES, _U32P)
+                vars_arr[i].n_candidates = n
+            vars_arr[i].klass = klass
+        edges_arr = (PMEdge * max(1, len(self._edges)))()
+        for i, (src, dst, view, undirected) in enumerate(self._edges):
+            edges_arr[i].src = src
+            edges_arr[i].dst = dst
+            edges_arr[i].view = view._ptr()
+            edges_arr[i].undirected = undirected
+
+        error: List[BaseException] = []
+
+        def trampoline(rows, n_rows, _ctx):
+            flat = rows[:n_rows * n_vars]
+            batch = [tuple(flat[i:i + n_vars]) for i in range(0, len(flat), n_vars)]
+            try:
+                return on_rows(batch) is not False
+            except BaseException as e:
+                error.append(e)
+                return False
+
+        callback = _PMCallback(trampoline)
+        stats = PMStats()
+        result = _lib.pm_match(
+            vars_arr, n_vars, edges_arr, len(self._edges),
+            PM_BREAK_SYMMETRY if break_symmetry else 0, threads, limit,
+            callback, None, ctypes.byref(stats),
+        )
+        if error:
+            raise error[0]
+        if result < 0:
+            raise ValueError("Invalid pattern or out of memory")
+        return stats.to_dict()
+
+    def match(self, limit: int = 0, threads: int = 0,
+              break_symmetry: bool = True) -> List[Tuple[int, ...]]:
+        """All matches (up to limit), in no particular order."""
+        rows: List[Tuple[int, ...]] = []
+        self.stream(rows.extend, limit=limit, threads=threads, break_symmetry=break_symmetry)
+        return rows
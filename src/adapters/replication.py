@@ -0,0 +1,464 @@
+"""
+SimpleDB Replication
+
+Leader-follower replication of a SimpleDB by log shipping:
+
+- ReplicationLeader enables the store's mutation log (SimpleDB.enable_log)
+  and listens on a socket.  Each connected follower gets a thread that
+  streams the log from the follower's position, whole commits at a time.
+- Replica connects, keeps its own SimpleDB and replays what it receives,
+  one local commit per leader commit, so its readers never see part of a
+  leader commit.  It serves read-only queries from that copy.
+- Catch-up: a follower that is new, followed another leader, or has
+  fallen behind the log's floor first receives a dump of a leader
+  snapshot, then the log after the snapshot's version.
+- Lag: replicas report how many commits and how long they trail the
+  leader version last heard of; the leader reports each follower's
+  acknowledged position.  A replica can be promoted to leader (hot
+  standby); its followers then resync from a snapshot.
+
+Transport: multiprocessing.connection (a Unix socket by default, TCP for
+a (host, port) address; pass an authkey beyond the local host).  Only
+raw byte messages are exchanged, never pickles:
+
+    replica -> leader   H <json {"leader", "position"}>   hello
+                        A <u64 position>                  acknowledgement
+    leader -> replica   W <leader id>                     welcome
+                        S <u64 version> <u64 leader version> <dump>
+                        L <u64 through> <u64 leader version> <log records>
+
+An L message without records is a heartbeat.
+"""
+
+import json
+import logging
+import struct
+import threading
+import time
+import uuid
+from multiprocessing import AuthenticationError
+from multiprocessing.connection import Client, Connection, Listener
+from typing import Any, Dict, List, Optional, Tuple
+
+from .simple_db import SimpleDB, Snapshot
+
+logger = logging.getLogger(__name__)
+
+_HEADER = struct.Struct('<cQQ')    # kind, position, leader version
+_ACK = struct.Struct('<cQ')
+_CLOSE_CHECK = 0.1                 # seconds a replica blocks between close checks
+
+
+class ReplicationLeader:
+    """
+    Stream a SimpleDB's commits to Replica processes.
+
+    Example:
+        >>> leader = ReplicationLeader(db)
+        >>> replica = Replica(leader.address)      # usually another process
+        >>> db.set("k", "v")
+        >>> replica.wait(db.version()) and replica.get("k")
+        'v'
+    """
+
+    def __init__(self, db: SimpleDB, address: Any = None, authkey: Optional[bytes] = None,
+                 log_bytes: int = 0, batch_bytes: int = 1 << 20,
+                 poll_interval: float = 0.002, heartbeat: float = 0.5):
+        """
+        Args:
+            db: Store to replicate (its log is enabled here)
+            address: Socket path or (host, port); None picks a Unix socket
+            authkey: Shared secret followers must present
+            log_bytes: Replication log limit (0 = library default)
+            batch_bytes: Soft size limit of one log message
+            poll_interval: Seconds between checks for new commits
+            heartbeat: Seconds between messages to an idle follower
+        """
+        db.enable_log(log_bytes)
+        self.db = db
+        self.id = uuid.uuid4().hex
+        self._authkey = authkey
+        self._batch_bytes = batch_bytes
+        self._poll = poll_interval
+        self._heartbeat = heartbeat
+
+        self._listener = Listener(address, authkey=authkey)
+        self.address = self._listener.address
+        self._closed = threading.Event()
+        self._lock = threading.Lock()
+        self._followers: Dict[int, Dict[str, Any]] = {}
+        self._next_follower = 0
+        self._threads: List[threading.Thread] = []
+        self._accepter = threading.Thread(target=self._accept, daemon=True)
+        self._accepter.start()
+
+    # ========================================================================
+    # FOLLOWER CONNECTIONS
+    # ========================================================================
+
+    def _accept(self) -> None:
+        while not self._closed.is_set():
+            try:
+                conn = self._listener.accept()
+            except AuthenticationError as e:
+                logger.warning("Rejected follower of %r: %s", self.address, e)
+                continue
+            except (OSError, EOFError):
+                continue          # failed handshake, or the listener closed
+            if self._closed.is_set():
+                conn.close()
+                break
+            thread = threading.Thread(target=self._serve, args=(conn,), daemon=True)
+            with self._lock:
+                self._threads = [t for t in self._threads if t.is_alive()] + [thread]
+            thread.start()
+
+    def _serve(self, conn: Connection) -> None:
+        with self._lock:
+            fid = self._next_follower
+            self._next_follower += 1
+            state = self._followers[fid] = {
+                'position': 0, 'sent': 0, 'snapshots': 0, 'since': time.time(),
+            }
+        try:
+            msg = conn.recv_bytes()
+            if msg[:1] != b'H':
+                return
+            hello = json.loads(msg[1:])
+            position = hello.get('position') if hello.get('leader') == self.id else None
+            conn.send_bytes(b'W' + self.id.encode('ascii'))
+
+            quiet_since = time.monotonic()
+            while not self._closed.is_set():
+                chunk = None if position is None else self.db.log_read(position, self._batch_bytes)
+                if chunk is None:
+                    # Beyond the log: seed from a snapshot, then follow the log
+                    with self.db.snapshot() as snap:
+                        records, position = self.db.dump(snap)
+                    conn.send_bytes(_HEADER.pack(b'S', position, self.db.version()) + records)
+                    state['snapshots'] += 1
+                    state['sent'] = position
+                    quiet_since = time.monotonic()
+                else:
+                    records, through = chunk
+                    idle = time.monotonic() - quiet_since >= self._heartbeat
+                    if records or through != position or idle:
+                        conn.send_bytes(_HEADER.pack(b'L', through, self.db.version()) + records)
+                        position = state['sent'] = through
+                        quiet_since = time.monotonic()
+                    else:
+                        self._closed.wait(self._poll)
+
+                while conn.poll():
+                    ack = conn.recv_bytes()
+                    if ack[:1] == b'A':
+                        state['position'] = _ACK.unpack(ack)[1]
+        except (OSError, EOFError, ValueError, struct.error):
+            pass                  # follower went away; it reconnects with its position
+        finally:
+            conn.close()
+            with self._lock:
+                self._followers.pop(fid, None)
+
+    # ========================================================================
+    # STATUS / LIFECYCLE
+    # ========================================================================
+
+    def stats(self) -> Dict[str, Any]:
+        """
+        Leader position and every connected follower's lag.
+
+        Returns:
+            Dictionary with:
+            - id / address: Leader identity and socket
+            - version: Newest commit
+            - log_floor / log_records / log_bytes: Replication log extent
+            - followers: Per follower acknowledged position, lag in
+              commits, sent position and snapshots shipped
+        """
+        version = self.db.version()
+        store = self.db.stats()
+        with self._lock:
+            followers = [{
+                'follower': fid,
+                'position': s['position'],
+                'lag': max(0, version - s['position']),
+                'sent': s['sent'],
+                'snapshots': s['snapshots'],
+                'connected_seconds': time.time() - s['since'],
+            } for fid, s in sorted(self._followers.items())]
+        return {
+            'id': self.id,
+            'address': self.address,
+            'version': version,
+            'log_floor': self.db.log_floor(),
+            'log_records': store['log_records'],
+            'log_bytes': store['log_bytes'],
+            'followers': followers,
+        }
+
+    def close(self) -> None:
+        """Stop accepting and disconnect every follower (idempotent)."""
+        if self._closed.is_set():
+            return
+        self._closed.set()
+        try:
+            # Wake the blocking accept()
+            Client(self.address, authkey=self._authkey).close()
+        except (OSError, EOFError):
+            pass
+        self._listener.close()
+        self._accepter.join()
+        with self._lock:
+            threads = list(self._threads)
+        for thread in threads:
+            thread.join()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.close()
+        return False
+
+    def __repr__(self) -> str:
+        with self._lock:
+            n = len(self._followers)
+        return f"<ReplicationLeader {self.address!r} followers={n}>"
+
+
+class Replica:
+    """
+    Read-only copy of a leader's SimpleDB, kept current in the background.
+
+    Reads go to the local copy and may trail the leader; use wait() for
+    read-your-writes.  The replica reconnects on its own and resumes from
+    its position while the leader's log still covers it.
+
+    Example:
+        >>> replica = Replica('/tmp/leader.sock')
+        >>> replica.wait(version_written_by_leader, timeout=1.0)
+        True
+        >>> replica.get("k")
+        'v'
+    """
+
+    def __init__(self, address: Any, authkey: Optional[bytes] = None,
+                 db: Optional[SimpleDB] = None, reconnect_interval: float = 0.2):
+        """
+        Args:
+            address: Leader socket (ReplicationLeader.address)
+            authkey: Shared secret of the leader
+            db: Store to replicate into (default: a new SimpleDB);
+                do not write to it directly
+            reconnect_interval: Seconds between connection attempts
+        """
+        self.db = db if db is not None else SimpleDB()
+        self.address = address
+        self._authkey = authkey
+        self._retry = reconnect_interval
+
+        self._cond = threading.Condition()
+        self._leader: Optional[str] = None
+        self._position = 0
+        self._leader_version = 0
+        self._behind_since: Optional[float] = None
+        self._connected = False
+        self._snapshots = 0
+        self._bytes = 0
+        self._closed = threading.Event()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+
+    # ========================================================================
+    # FOLLOWING
+    # ========================================================================
+
+    def _run(self) -> None:
+        rejected = False
+        while not self._closed.is_set():
+            try:
+                conn = Client(self.address, authkey=self._authkey)
+            except AuthenticationError as e:
+                if not rejected:        # once per run of rejections
+                    logger.warning("Leader %r rejected the replica: %s", self.address, e)
+                rejected = True
+                self._closed.wait(self._retry)
+                continue
+            except (OSError, EOFError):
+                self._closed.wait(self._retry)
+                continue
+            rejected = False
+            try:
+                self._follow(conn)
+            except (OSError, EOFError, ValueError, struct.error):
+                pass
+            finally:
+                conn.close()
+                with self._cond:
+                    self._connected = False
+                    self._cond.notify_all()
+            self._closed.wait(self._retry)
+
+    def _follow(self, conn: Connection) -> None:
+        with self._cond:
+            hello = {'leader': self._leader, 'position': self._position}
+        conn.send_bytes(b'H' + json.dumps(hello).encode('utf-8'))
+        welcome = conn.recv_bytes()
+        if welcome[:1] != b'W':
+            raise ValueError("Unexpected greeting from leader")
+        leader = welcome[1:].decode('ascii')
+        with self._cond:
+            self._connected = True
+
+        while not self._closed.is_set():
+            if not conn.poll(_CLOSE_CHECK):
+                continue
+            msg = conn.recv_bytes()
+            kind, position, leader_version = _HEADER.unpack_from(msg)
+            records = msg[_HEADER.size:]
+            if kind not in (b'S', b'L'):
+                raise ValueError("Unexpected message from leader")
+            if records and not self.db.replay(records):
+                with self._cond:
+                    self._leader = None     # resync from a snapshot
+                raise ValueError("Replication records rejected")
+
+            with self._cond:
+                self._leader = leader
+                self._position = position
+                self._leader_version = max(leader_version, position)
+                self._bytes += len(msg)
+                if kind == b'S':
+                    self._snapshots += 1
+                if self._position >= self._leader_version:
+                    self._behind_since = None
+                elif self._behind_since is None:
+                    self._behind_since = time.monotonic()
+                self._cond.notify_all()
+            conn.send_bytes(_ACK.pack(b'A', position))
+
+    def wait(self, version: int, timeout: Optional[float] = None) -> bool:
+        """
+        Block until the replica reflects leader commit `version`.
+
+        Returns:
+            True once caught up, False on timeout or close
+        """
+        deadline = None if timeout is None else time.monotonic() + timeout
+        with self._cond:
+            while self._position < version and not self._closed.is_set():
+                remaining = None if deadline is None else deadline - time.monotonic()
+                if remaining is not None and remaining <= 0:
+                    return False
+                self._cond.wait(remaining if remaining is not None else 0.1)
+            return self._position >= version
+
+    # ========================================================================
+    # READ-ONLY QUERIES
+    # ========================================================================
+
+    def get(self, key: str) -> Optional[str]:
+        return self.db.get(key)
+
+    def mget(self, keys: List[str], batch_size: int = 0) -> List[Optional[str]]:
+        return self.db.mget(keys, batch_size)
+
+    def exists(self, key: str) -> bool:
+        return self.db.exists(key)
+
+    def count(self) -> int:
+        return self.db.count()
+
+    def keys(self) -> List[str]:
+        return self.db.keys()
+
+    def items(self) -> List[Tuple[str, str]]:
+        with self.db.snapshot() as snap:
+            return snap.items()
+
+    def snapshot(self) -> Snapshot:
+        """Consistent read view; never shows part of a leader commit."""
+        return self.db.snapshot()
+
+    def __len__(self) -> int:
+        return self.count()
+
+    def __contains__(self, key: str) -> bool:
+        return self.exists(key)
+
+    def __getitem__(self, key: str) -> str:
+        value = self.get(key)
+        if value is None:
+            raise KeyError(key)
+        return value
+
+    # ========================================================================
+    # STATUS / LIFECYCLE
+    # ========================================================================
+
+    @property
+    def position(self) -> int:
+        """Last leader commit this replica reflects."""
+        with self._cond:
+            return self._position
+
+    @property
+    def connected(self) -> bool:
+        with self._cond:
+            return self._connected
+
+    def stats(self) -> Dict[str, Any]:
+        """
+        Replication state.
+
+        Returns:
+            Dictionary with:
+            - leader / connected: Leader followed and link state
+            - position: Last leader commit reflected
+            - leader_version: Newest leader commit heard of
+            - lag: Commits behind leader_version
+            - lag_seconds: How long the replica has trailed it
+            - snapshots: Full resyncs received
+            - bytes_received: Replication traffic
+        """
+        with self._cond:
+            behind = self._behind_since
+            return {
+                'leader': self._leader,
+                'connected': self._connected,
+                'position': self._position,
+                'leader_version': self._leader_version,
+                'lag': self._leader_version - self._position,
+                'lag_seconds': time.monotonic() - behind if behind is not None else 0.0,
+                'snapshots': self._snapshots,
+                'bytes_received': self._bytes,
+            }
+
+    def promote(self, address: Any = None, authkey: Optional[bytes] = None,
+                **options: Any) -> ReplicationLeader:
+        """
+        Stop following and serve this copy as the new leader (failover).
+
+        Followers of the new leader resync from a snapshot, since its
+        commit numbers are its own.  Options go to ReplicationLeader.
+        """
+        self.close()
+        return ReplicationLeader(self.db, address, authkey=authkey, **options)
+
+    def close(self) -> None:
+        """Stop following; the local copy stays readable (idempotent)."""
+        self._closed.set()
+        self._thread.join()
+        with self._cond:
+            self._cond.notify_all()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.close()
+        return False
+
+    def __repr__(self) -> str:
+        return f"<Replica {self.address!r} position={self.position}>"
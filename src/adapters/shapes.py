@@ -0,0 +1,277 @@
+"""
+Shapes Python Adapter
+
+Python wrapper for the C shapes library (class constraints compiled into
+flat rule programs, checked over batches of instances on worker threads).
+This is the ONLY module that uses ctypes for shapes.
+
+Classes, properties and class sets are integers chosen by the caller;
+see shapes.h for the rule operators.
+"""
+
+import ctypes
+from array import array
+from typing import Any, Dict, Iterable, List, Sequence, Tuple
+from ._loader import load_library
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+SHP_ALL = 0xFFFFFFFF
+SHP_NONE = 0xFFFFFFFF
+
+# Rule operators
+MIN_COUNT, MAX_COUNT, DATATYPE, RANGE = 1, 2, 3, 4
+
+# Datatype masks
+XSD_STRING = 1 << 0
+XSD_INTEGER = 1 << 1
+XSD_DECIMAL = 1 << 2
+XSD_BOOLEAN = 1 << 3
+XSD_DATE = 1 << 4
+XSD_DATETIME = 1 << 5
+XSD_TIME = 1 << 6
+XSD_ANY_URI = 1 << 7
+
+# Value kinds
+STRING, INTEGER, NUMBER, BOOLEAN, REF = 0, 1, 2, 3, 4
+
+_U32P = ctypes.POINTER(ctypes.c_uint32)
+_U64P = ctypes.POINTER(ctypes.c_uint64)
+_U8P = ctypes.POINTER(ctypes.c_uint8)
+
+
+class ShpBatch(ctypes.Structure):
+    """Instance batch (matches C ShpBatch)."""
+    _fields_ = [
+        ("instances", ctypes.c_size_t),
+        ("entities", ctypes.c_size_t),
+        ("type_off", _U64P),
+        ("types", _U32P),
+        ("value_off", _U64P),
+        ("value_prop", _U32P),
+        ("value_kind", _U8P),
+        ("value_target", _U32P),
+        ("text_end", _U64P),
+        ("text", ctypes.c_char_p),
+    ]
+
+
+class ShpStats(ctypes.Structure):
+    """Validation totals (matches C ShpStats)."""
+    _fields_ = [
+        ("violations", ctypes.c_uint64),
+        ("invalid", ctypes.c_uint64),
+        ("checks", ctypes.c_uint64),
+        ("threads", ctypes.c_uint),
+    ]
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert to Python dictionary."""
+        return {name: getattr(self, name) for name, _ in self._fields_}
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.shp_program_create.argtypes = [ctypes.c_size_t]
+_lib.shp_program_create.restype = ctypes.c_void_p
+
+_lib.shp_program_free.argtypes = [ctypes.c_void_p]
+_lib.shp_program_free.restype = None
+
+_lib.shp_add_parent.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32]
+_lib.shp_add_parent.restype = ctypes.c_bool
+
+_lib.shp_add_class_set.argtypes = [ctypes.c_void_p, _U32P, ctypes.c_size_t]
+_lib.shp_add_class_set.restype = ctypes.c_int64
+
+_lib.shp_add_rule.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32,
+                              ctypes.c_uint32, ctypes.c_uint32]
+_lib.shp_add_rule.restype = ctypes.c_int64
+
+_lib.shp_compile.argtypes = [ctypes.c_void_p]
+_lib.shp_compile.restype = ctypes.c_bool
+
+_lib.shp_flat_rules.argtypes = [ctypes.c_void_p]
+_lib.shp_flat_rules.restype = ctypes.c_size_t
+
+_lib.shp_is_a.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32]
+_lib.shp_is_a.restype = ctypes.c_bool
+
+_lib.shp_validate.argtypes = [ctypes.c_void_p, ctypes.POINTER(ShpBatch), ctypes.c_uint,
+                              _U32P, ctypes.c_size_t, ctypes.POINTER(ShpStats)]
+_lib.shp_validate.restype = ctypes.c_int64
+
+
+# ============================================================================
+# PYTHON WRAPPER CLASSES
+# ============================================================================
+
+# (property, kind, lexical form, target entity or SHP_NONE)
+Value = Tuple[int, int, str, int]
+
+# (instance, rule, value index or SHP_NONE, values of the rule's property)
+Violation = Tuple[int, int, int, int]
+
+
+def _ptr(arr: array, ctype):
+    return ctypes.cast(arr.buffer_info()[0], ctype) if len(arr) else None
+
+
+class ShapeBatch:
+    """
+    Entities and instance values in the native layout.
+
+    Args:
+        entity_types: Classes of every entity; the first len(values)
+            entities are the instances checked, the rest are only referred to
+        values: Per instance, its (property, kind, text, target) values
+    """
+
+    def __init__(self, entity_types: Sequence[Sequence[int]], values: Sequence[Iterable[Value]]):
+        if len(values) > len(entity_types):
+            raise ValueError("More instances than entities")
+        self._type_off = array('Q', [0])
+        self._types = array('I')
+        for classes in entity_types:
+            self._types.extend(classes)
+            self._type_off.append(len(self._types))
+
+        self._value_off = array('Q', [0])
+        self._prop, self._kind = array('I'), array('B')
+        self._target, self._text_end = array('I'), array('Q')
+        chunks: List[bytes] = []
+        end = 0
+        for instance_values in values:
+            for prop, kind, text, target in instance_values:
+                raw = text.encode()
+                chunks.append(raw)
+                end += len(raw)
+                self._prop.append(prop)
+                self._kind.append(kind)
+                self._target.append(target)
+                self._text_end.append(end)
+            self._value_off.append(len(self._prop))
+        self._text = b"".join(chunks)
+
+        self._c = ShpBatch(
+            instances=len(values), entities=len(entity_types),
+            type_off=_ptr(self._type_off, _U64P), types=_ptr(self._types, _U32P),
+            value_off=_ptr(self._value_off, _U64P), value_prop=_ptr(self._prop, _U32P),
+            value_kind=_ptr(self._kind, _U8P), value_target=_ptr(self._target, _U32P),
+            text_end=_ptr(self._text_end, _U64P), text=self._text,
+        )
+
+    @property
+    def instances(self) -> int:
+        return self._c.instances
+
+    def value(self, index: int) -> Tuple[int, str]:
+        """(property, text) of a value by its index in the batch."""
+        start = self._text_end[index - 1] if index else 0
+        return self._prop[index], self._text[start:self._text_end[index]].decode()
+
+
+class ShapeProgram:
+    """
+    Compiled class constraints.
+
+    Example:
+        program = ShapeProgram(classes=2)
+        program.add_parent(1, 0)
+        program.add_rule(0, MIN_COUNT, prop=0, arg=1)     # required
+        program.compile()
+        violations, stats = program.validate(ShapeBatch([[1]], [[]]))
+    """
+
+    def __init__(self, classes: int):
+        self._p = _lib.shp_program_create(classes)
+        if not self._p:
+            raise MemoryError("Failed to create shape program")
+        self.classes = classes
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        """Free the native program."""
+        if getattr(self, '_p', None):
+            _lib.shp_program_free(self._p)
+            self._p = None
+
+    def _handle(self):
+        if not self._p:
+            raise ValueError("ShapeProgram is closed")
+        return self._p
+
+    def add_parent(self, cls: int, parent: int):
+        """
+        Raises:
+            ValueError: For IDs out of range or a compiled program
+        """
+        if not _lib.shp_add_parent(self._handle(), cls, parent):
+            raise ValueError(f"Cannot add subclass edge {cls} -> {parent}")
+
+    def add_class_set(self, classes: Iterable[int]) -> int:
+        """Union of classes for RANGE rules; returns its ID."""
+        ids = array('I', classes)
+        found = _lib.shp_add_class_set(self._handle(), _ptr(ids, _U32P), len(ids))
+        if found < 0:
+            raise ValueError("Class out of range (or program compiled)")
+        return found
+
+    def add_rule(self, cls: int, op: int, prop: int, arg: int) -> int:
+        """Rule on cls (or SHP_ALL); returns its ID."""
+        found = _lib.shp_add_rule(self._handle(), cls, op, prop, arg)
+        if found < 0:
+            raise ValueError("Unknown class, operator or class set (or program compiled)")
+        return found
+
+    def compile(self):
+        if not _lib.shp_compile(self._handle()):
+            raise MemoryError("Failed to compile shape program")
+
+    @property
+    def flat_rules(self) -> int:
+        """Rules over all classes after inheritance is flattened."""
+        return _lib.shp_flat_rules(self._handle())
+
+    def is_a(self, cls: int, ancestor: int) -> bool:
+        return _lib.shp_is_a(self._handle(), cls, ancestor)
+
+    def validate(self, batch: ShapeBatch, threads: int = 0,
+                 max_violations: int = 10000) -> Tuple[List[Violation], Dict[str, Any]]:
+        """
+        Check every instance of a batch.
+
+        Args:
+            batch: Instances and the entities they refer to
+            threads: Worker threads (0 = one per CPU)
+            max_violations: Violations returned (stats counts them all)
+
+        Returns:
+            (violations, stats): violations in instance order; stats has the
+            total violations, invalid instances, rules evaluated and threads
+
+        Raises:
+            ValueError: For an uncompiled program or a batch with class or
+                entity IDs out of range
+        """
+        out = array('I', bytes(16 * max_violations))
+        stats = ShpStats()
+        n = _lib.shp_validate(self._handle(), ctypes.byref(batch._c), threads,
+                              _ptr(out, _U32P), max_violations, ctypes.byref(stats))
+        if n < 0:
+            raise ValueError("Program not compiled, or batch IDs out of range")
+        return [tuple(out[4 * i:4 * i + 4]) for i in range(n)], stats.to_dict()
@@ -8,7 +8,8 @@ All upper layers (services, API) should import from here, not use ctypes directl
 """
 
 import ctypes
-from typing import Optional, List, Dict, Any
+import weakref
+from typing import Optional, List, Dict, Any, Tuple
 from ._loader import load_library
 
 
@@ -19,11 +20,33 @@ from ._loader import load_library
 # Load the shared library
 _lib = load_library("simpledb")
 
+_SIZE_MAX = ctypes.c_size_t(-1).value
+
 
 # ============================================================================
 # C TYPE DEFINITIONS
 # ============================================================================
 
+class DBOptions(ctypes.Structure):
+    """
+    Allocation policies for db_create_with_options (matches C DBOptions).
+    """
+    _fields_ = [
+        ("initial_capacity", ctypes.c_size_t),
+        ("pages", ctypes.c_int),
+        ("numa", ctypes.c_int),
+        ("numa_node", ctypes.c_int),
+    ]
+
+
+# Policy names accepted by SimpleDB(...) -> C enum values
+PAGE_POLICIES = {'default': 0, 'transparent': 1, 'hugetlb': 2}
+NUMA_POLICIES = {'default': 0, 'interleave': 1, 'bind': 2}
+
+_PAGE_POLICY_NAMES = {v: k for k, v in PAGE_POLICIES.items()}
+_NUMA_POLICY_NAMES = {v: k for k, v in NUMA_POLICIES.items()}
+
+
 class DBStats(ctypes.Structure):
     """
     Database statistics structure (matches C DBStats).
@@ -33,6 +56,14 @@ class DBStats(ctypes.Structure):
         ("total_collisions", ctypes.c_size_t),
         ("max_chain_length", ctypes.c_size_t),
         ("used_buckets", ctypes.c_size_t),
+        ("active_snapshots", ctypes.c_size_t),
+        ("retained_versions", ctypes.c_size_t),
+        ("page_policy", ctypes.c_size_t),
+        ("numa_policy", ctypes.c_size_t),
+        ("table_bytes", ctypes.c_size_t),
+        ("huge_page_bytes", ctypes.c_size_t),
+        ("log_records", ctypes.c_size_t),
+        ("log_bytes", ctypes.c_size_t),
     ]
 
     def to_dict(self) -> Dict[str, int]:
@@ -42,6 +73,14 @@ class DBStats(ctypes.Structure):
             'total_collisions': self.total_collisions,
             'max_chain_length': self.max_chain_length,
             'used_buckets': self.used_buckets,
+            'active_snapshots': self.active_snapshots,
+            'retained_versions': self.retained_versions,
+            'page_policy': _PAGE_POLICY_NAMES.get(self.page_policy, 'default'),
+            'numa_policy': _NUMA_POLICY_NAMES.get(self.numa_policy, 'default'),
+            'table_bytes': self.table_bytes,
+            'huge_page_bytes': self.huge_page_bytes,
+            'log_records': self.log_records,
+            'log_bytes': self.log_bytes,
         }
 
 
@@ -53,6 +92,9 @@ class DBStats(ctypes.Structure):
 _lib.db_create.argtypes = []
 _lib.db_create.restype = ctypes.c_void_p
 
+_lib.db_create_with_options.argtypes = [ctypes.POINTER(DBOptions)]
+_lib.db_create_with_options.restype = ctypes.c_void_p
+
 _lib.db_destroy.argtypes = [ctypes.c_void_p]
 _lib.db_destroy.restype = None
 
@@ -69,22 +111,286 @@ _lib.db_delete.restype = ctypes.c_bool
 _lib.db_exists.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
 _lib.db_exists.restype = ctypes.c_bool
 
+_lib.db_apply.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_char_p),
+                          ctypes.POINTER(ctypes.c_char_p), ctypes.c_size_t]
+_lib.db_apply.restype = ctypes.c_bool
+
+_lib.db_apply_if.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.POINTER(ctypes.c_char_p),
+                             ctypes.POINTER(ctypes.c_char_p), ctypes.c_size_t]
+_lib.db_apply_if.restype = ctypes.c_int
+
+# Batched lookup
+_lib.db_mget.argtypes = [
+    ctypes.c_void_p, ctypes.c_void_p, ctypes.POINTER(ctypes.c_char_p),
+    ctypes.c_size_t, ctypes.POINTER(ctypes.c_char_p), ctypes.c_size_t,
+]
+_lib.db_mget.restype = ctypes.c_size_t
+
 # Utility operations
 _lib.db_count.argtypes = [ctypes.c_void_p]
 _lib.db_count.restype = ctypes.c_size_t
 
 _lib.db_clear.argtypes = [ctypes.c_void_p]
-_lib.db_clear.restype = None
+_lib.db_clear.restype = ctypes.c_bool
 
 _lib.db_keys.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_size_t)]
 _lib.db_keys.restype = ctypes.POINTER(ctypes.c_char_p)
 
+_lib.db_free_keys.argtypes = [ctypes.POINTER(ctypes.c_char_p), ctypes.c_size_t]
+_lib.db_free_keys.restype = None
+
 _lib.db_stats.argtypes = [ctypes.c_void_p]
 _lib.db_stats.restype = DBStats
 
 _lib.db_print.argtypes = [ctypes.c_void_p]
 _lib.db_print.restype = None
 
+# Snapshots
+_lib.db_snapshot_acquire.argtypes = [ctypes.c_void_p]
+_lib.db_snapshot_acquire.restype = ctypes.c_void_p
+
+_lib.db_snapshot_release.argtypes = [ctypes.c_void_p]
+_lib.db_snapshot_release.restype = None
+
+_lib.db_snapshot_version.argtypes = [ctypes.c_void_p]
+_lib.db_snapshot_version.restype = ctypes.c_uint64
+
+_lib.db_version.argtypes = [ctypes.c_void_p]
+_lib.db_version.restype = ctypes.c_uint64
+
+_lib.db_get_at.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_char_p]
+_lib.db_get_at.restype = ctypes.c_char_p
+
+# Copying reads: values are copied under the lock, so a concurrent writer
+# cannot free them before they are decoded
+_lib.db_get_copy.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_char_p,
+                             ctypes.POINTER(ctypes.c_void_p)]
+_lib.db_get_copy.restype = ctypes.c_bool
+
+_lib.db_mget_copy.argtypes = [
+    ctypes.c_void_p, ctypes.c_void_p, ctypes.POINTER(ctypes.c_char_p),
+    ctypes.c_size_t, ctypes.POINTER(ctypes.c_void_p), ctypes.c_size_t,
+]
+_lib.db_mget_copy.restype = ctypes.c_size_t
+
+_lib.db_free_values.argtypes = [ctypes.POINTER(ctypes.c_void_p), ctypes.c_size_t]
+_lib.db_free_values.restype = None
+
+_lib.db_exists_at.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_char_p]
+_lib.db_exists_at.restype = ctypes.c_bool
+
+_lib.db_count_at.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+_lib.db_count_at.restype = ctypes.c_size_t
+
+_lib.db_keys_at.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.POINTER(ctypes.c_size_t)]
+_lib.db_keys_at.restype = ctypes.POINTER(ctypes.c_char_p)
+
+# Temporal history
+_lib.db_history_enable.argtypes = [ctypes.c_void_p]
+_lib.db_history_enable.restype = ctypes.c_bool
+
+_lib.db_history_enabled.argtypes = [ctypes.c_void_p]
+_lib.db_history_enabled.restype = ctypes.c_bool
+
+_lib.db_history_floor.argtypes = [ctypes.c_void_p]
+_lib.db_history_floor.restype = ctypes.c_uint64
+
+_lib.db_version_at_time.argtypes = [ctypes.c_void_p, ctypes.c_int64]
+_lib.db_version_at_time.restype = ctypes.c_uint64
+
+_lib.db_version_time.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+_lib.db_version_time.restype = ctypes.c_int64
+
+_lib.db_snapshot_at.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+_lib.db_snapshot_at.restype = ctypes.c_void_p
+
+_lib.db_compact.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+_lib.db_compact.restype = ctypes.c_size_t
+
+# Replication log
+_lib.db_log_enable.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+_lib.db_log_enable.restype = ctypes.c_bool
+
+_lib.db_log_enabled.argtypes = [ctypes.c_void_p]
+_lib.db_log_enabled.restype = ctypes.c_bool
+
+_lib.db_log_floor.argtypes = [ctypes.c_void_p]
+_lib.db_log_floor.restype = ctypes.c_uint64
+
+_lib.db_log_read.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_size_t,
+                             ctypes.POINTER(ctypes.c_size_t), ctypes.POINTER(ctypes.c_uint64)]
+_lib.db_log_read.restype = ctypes.c_void_p
+
+_lib.db_dump.argtypes = [ctypes.c_void_p, ctypes.c_void_p,
+                         ctypes.POINTER(ctypes.c_size_t), ctypes.POINTER(ctypes.c_uint64)]
+_lib.db_dump.restype = ctypes.c_void_p
+
+_lib.db_log_replay.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t]
+_lib.db_log_replay.restype = ctypes.c_bool
+
+_lib.db_free_buffer.argtypes = [ctypes.c_void_p]
+_lib.db_free_buffer.restype = None
+
+
+def _mget(db_ptr, snap_ptr, keys: List[str], batch_size: int) -> List[Optional[str]]:
+    """Shared body of SimpleDB.mget / Snapshot.mget."""
+    n = len(keys)
+    if n == 0:
+        return []
+    for key in keys:
+        if not isinstance(key, str):
+            raise TypeError("Key must be a string")
+
+    c_keys = (ctypes.c_char_p * n)(*[k.encode('utf-8') for k in keys])
+    c_vals = (ctypes.c_void_p * n)()
+    if _lib.db_mget_copy(db_ptr, snap_ptr, c_keys, n, c_vals, batch_size) == _SIZE_MAX:
+        raise MemoryError("Failed to copy values")
+    try:
+        return [ctypes.string_at(v).decode('utf-8') if v else None for v in c_vals]
+    finally:
+        _lib.db_free_values(c_vals, n)
+
+
+def _get(db_ptr, snap_ptr, key: str) -> Optional[str]:
+    """Shared body of SimpleDB.get / Snapshot.get."""
+    if not isinstance(key, str):
+        raise TypeError("Key must be a string")
+
+    value = ctypes.c_void_p()
+    if not _lib.db_get_copy(db_ptr, snap_ptr, key.encode('utf-8'), ctypes.byref(value)):
+        raise MemoryError("Failed to copy value")
+    if not value:
+        return None
+    try:
+        return ctypes.string_at(value).decode('utf-8')
+    finally:
+        _lib.db_free_buffer(value)
+
+
+def _take_buffer(ptr, length: int) -> bytes:
+    """Copy a C buffer from db_log_read / db_dump and release it."""
+    data = ctypes.string_at(ptr, length)
+    _lib.db_free_buffer(ptr)
+    return data
+
+
+def _take_keys(keys_ptr, count: int) -> List[str]:
+    """Decode a C key array and release it."""
+    if not keys_ptr:
+        return []
+
+    keys = []
+    for i in range(count):
+        key_bytes = keys_ptr[i]
+        if key_bytes:
+            keys.append(key_bytes.decode('utf-8'))
+
+    _lib.db_free_keys(keys_ptr, count)
+    return keys
+
+
+# ============================================================================
+# SNAPSHOT WRAPPER
+# ============================================================================
+
+class Snapshot:
+    """
+    Point-in-time read view of a SimpleDB.
+
+    Reads through a snapshot see the database exactly as it was when the
+    snapshot was taken, no matter what is written afterwards.  Writers are
+    never blocked; superseded values are kept until the snapshot is released.
+
+    Example:
+        >>> db.set("k", "old")
+        >>> with db.snapshot() as snap:
+        ...     db.set("k", "new")
+        ...     snap.get("k")
+        'old'
+    """
+
+    def __init__(self, db: 'SimpleDB', version: Optional[int] = None):
+        self._owner = db  # keeps the database alive while pinned
+        if version is None:
+            self._snap = _lib.db_snapshot_acquire(db._db)
+            if not self._snap:
+                raise MemoryError("Failed to acquire snapshot")
+        else:
+            self._snap = _lib.db_snapshot_at(db._db, version)
+            if not self._snap:
+                raise ValueError(f"Version {version} is outside the readable history")
+        db._snapshots.add(self)
+
+    @property
+    def version(self) -> int:
+        """Commit version this snapshot reads at."""
+        return _lib.db_snapshot_version(self._snap)
+
+    @property
+    def released(self) -> bool:
+        return self._snap is None
+
+    def _handle(self):
+        if self._snap is None:
+            raise RuntimeError("Snapshot has been released")
+        return self._snap
+
+    def get(self, key: str) -> Optional[str]:
+        """Get value by key as of this snapshot."""
+        return _get(self._owner._db, self._handle(), key)
+
+    def exists(self, key: str) -> bool:
+        """Check if key existed as of this snapshot."""
+        if not isinstance(key, str):
+            raise TypeError("Key must be a string")
+
+        return _lib.db_exists_at(self._owner._db, self._handle(), key.encode('utf-8'))
+
+    def mget(self, keys: List[str], batch_size: int = 0) -> List[Optional[str]]:
+        """Batched get as of this snapshot (see SimpleDB.mget)."""
+        return _mget(self._owner._db, self._handle(), list(keys), batch_size)
+
+    def count(self) -> int:
+        """Number of entries as of this snapshot."""
+        return _lib.db_count_at(self._owner._db, self._handle())
+
+    def keys(self) -> List[str]:
+        """All keys as of this snapshot."""
+        count = ctypes.c_size_t()
+        keys_ptr = _lib.db_keys_at(self._owner._db, self._handle(), ctypes.byref(count))
+        return _take_keys(keys_ptr, count.value)
+
+    def items(self) -> List[tuple]:
+        """All (key, value) pairs as of this snapshot."""
+        items = []
+        for key in self.keys():
+            value = self.get(key)
+            if value is not None:
+                items.append((key, value))
+        return items
+
+    def release(self) -> None:
+        """Release the snapshot (idempotent)."""
+        if self._snap is not None:
+            _lib.db_snapshot_release(self._snap)
+            self._snap = None
+            self._owner._snapshots.discard(self)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.release()
+        return False
+
+    def __del__(self):
+        if getattr(self, '_snap', None) is not None and getattr(self._owner, '_db', None):
+            self.release()
+
+    def __repr__(self) -> str:
+        state = "released" if self.released else f"version={self.version}"
+        return f"<Snapshot {state}>"
+
 
 # ============================================================================
 # PYTHON WRAPPER CLASS
@@ -118,20 +424,44 @@ class SimpleDB:
         value
     """
 
-    def __init__(self):
+    def __init__(self, pages: str = 'default', numa: str = 'default',
+                 numa_node: int = 0, initial_capacity: int = 0):
         """
         Create a new database instance.
 
+        Args:
+            pages: Page policy for the table ('default', 'transparent' for
+                THP madvise, 'hugetlb' for explicit 2MB pages)
+            numa: NUMA placement ('default', 'interleave', 'bind')
+            numa_node: Node used with numa='bind'
+            initial_capacity: Buckets to presize for large tables
+
+        Policies are best effort; stats() reports what was obtained.
+
         Raises:
+            ValueError: If a policy name is unknown
             MemoryError: If database creation fails
         """
-        self._db = _lib.db_create()
+        if pages not in PAGE_POLICIES:
+            raise ValueError(f"Unknown page policy: {pages!r}")
+        if numa not in NUMA_POLICIES:
+            raise ValueError(f"Unknown NUMA policy: {numa!r}")
+
+        self._snapshots = weakref.WeakSet()
+        if pages == 'default' and numa == 'default' and not initial_capacity:
+            self._db = _lib.db_create()
+        else:
+            opts = DBOptions(initial_capacity, PAGE_POLICIES[pages],
+                             NUMA_POLICIES[numa], numa_node)
+            self._db = _lib.db_create_with_options(ctypes.byref(opts))
         if not self._db:
             raise MemoryError("Failed to create database")
 
     def __del__(self):
         """Destructor - cleanup database."""
         if hasattr(self, '_db') and self._db:
+            for snap in list(self._snapshots):
+                snap.release()
             _lib.db_destroy(self._db)
             self._db = None
 
@@ -189,11 +519,7 @@ class SimpleDB:
             >>> db.get("nonexistent")
             None
         """
-        if not isinstance(key, str):
-            raise TypeError("Key must be a string")
-
-        result = _lib.db_get(self._db, key.encode('utf-8'))
-        return result.decode('utf-8') if result else None
+        return _get(self._db, None, key)
 
     def delete(self, key: str) -> bool:
         """
@@ -239,6 +565,89 @@ class SimpleDB:
 
         return _lib.db_exists(self._db, key.encode('utf-8'))
 
+    def mget(self, keys: List[str], batch_size: int = 0) -> List[Optional[str]]:
+        """
+        Get many values in one call.
+
+        Lookups are interleaved in the C core so their cache misses overlap;
+        much faster than repeated get() for large batches.
+
+        Args:
+            keys: Keys to look up
+            batch_size: Lookups in flight at once (0 = library default)
+
+        Returns:
+            Values in key order, None for missing keys
+
+        Example:
+            >>> db.set("a", "1")
+            >>> db.mget(["a", "b"])
+            ['1', None]
+        """
+        return _mget(self._db, None, list(keys), batch_size)
+
+    def apply(self, writes: List[Tuple[str, Optional[str]]]) -> bool:
+        """
+        Apply many writes as one commit.
+
+        No reader or snapshot ever sees part of the batch: it lands under
+        a single version number.  A None value deletes the key.
+
+        Args:
+            writes: (key, value or None) pairs; a repeated key's last write wins
+
+        Returns:
+            True on success, False on allocation failure (nothing is
+            applied: the batch is all or nothing)
+
+        Example:
+            >>> db.apply([("a", "1"), ("b", None)])
+            True
+        """
+        c_keys, c_vals, n = self._batch(writes)
+        if n == 0:
+            return True
+        return _lib.db_apply(self._db, c_keys, c_vals, n)
+
+    def apply_if(self, version: int, writes: List[Tuple[str, Optional[str]]]) -> bool:
+        """
+        Apply many writes as one commit, only if nothing else has committed
+        since version.
+
+        The check and the commit happen under the database lock, so a
+        batch computed from a snapshot at version can be applied without
+        losing a concurrent write: on a conflict, re-read and retry.
+
+        Args:
+            version: Expected current version (e.g. a snapshot's version)
+            writes: As for apply
+
+        Returns:
+            True if applied, False if the database is past version (nothing
+            applied)
+
+        Raises:
+            MemoryError: If the batch could not be allocated (nothing applied)
+        """
+        c_keys, c_vals, n = self._batch(writes)
+        r = _lib.db_apply_if(self._db, version, c_keys, c_vals, n)
+        if r < 0:
+            raise MemoryError("Failed to apply batch")
+        return r > 0
+
+    @staticmethod
+    def _batch(writes):
+        """(keys, values, n) C arrays for db_apply / db_apply_if."""
+        writes = list(writes)
+        n = len(writes)
+        for key, value in writes:
+            if not isinstance(key, str) or not (value is None or isinstance(value, str)):
+                raise TypeError("Keys must be strings and values strings or None")
+        c_keys = (ctypes.c_char_p * n)(*[k.encode('utf-8') for k, _ in writes])
+        c_vals = (ctypes.c_char_p * n)(*[v.encode('utf-8') if v is not None else None
+                                          for _, v in writes])
+        return c_keys, c_vals, n
+
     # ========================================================================
     # UTILITY OPERATIONS
     # ========================================================================
@@ -262,13 +671,17 @@ class SimpleDB:
         """
         Remove all entries from database.
 
+        Raises:
+            MemoryError: If the clear could not be allocated (nothing removed)
+
         Example:
             >>> db.set("key", "value")
             >>> db.clear()
             >>> db.count()
             0
         """
-        _lib.db_clear(self._db)
+        if not _lib.db_clear(self._db):
+            raise MemoryError("Failed to clear database")
 
     def keys(self) -> List[str]:
         """
@@ -285,19 +698,7 @@ class SimpleDB:
         """
         count = ctypes.c_size_t()
         keys_ptr = _lib.db_keys(self._db, ctypes.byref(count))
-
-        if not keys_ptr:
-            return []
-
-        # Extract keys
-        keys = []
-        for i in range(count.value):
-            key_bytes = keys_ptr[i]
-            if key_bytes:
-                keys.append(key_bytes.decode('utf-8'))
-
-        # Note: C library handles freeing the array
-        return keys
+        return _take_keys(keys_ptr, count.value)
 
     def items(self) -> List[tuple]:
         """
@@ -319,7 +720,7 @@ class SimpleDB:
                 items.append((key, value))
         return items
 
-    def stats(self) -> Dict[str, int]:
+    def stats(self) -> Dict[str, Any]:
         """
         Get database statistics.
 
@@ -329,6 +730,12 @@ class SimpleDB:
             - total_collisions: Number of hash collisions
             - max_chain_length: Longest collision chain
             - used_buckets: Non-empty hash buckets
+            - active_snapshots: Snapshots currently held
+            - retained_versions: Superseded values kept for snapshots
+            - page_policy / numa_policy: Allocation policies in effect
+            - table_bytes: Bucket array and entry slab memory
+            - huge_page_bytes: Part of table_bytes on huge pages
+            - log_records / log_bytes: Writes held by the replication log
 
         Example:
             >>> db.set("key", "value")
@@ -339,6 +746,173 @@ class SimpleDB:
         c_stats = _lib.db_stats(self._db)
         return c_stats.to_dict()
 
+    # ========================================================================
+    # SNAPSHOTS
+    # ========================================================================
+
+    def snapshot(self) -> Snapshot:
+        """
+        Acquire a point-in-time read view.
+
+        Use it as a context manager so the view is released promptly;
+        old versions are retained only while some snapshot needs them.
+
+        Example:
+            >>> with db.snapshot() as snap:
+            ...     keys = snap.keys()
+            ...     values = [snap.get(k) for k in keys]  # consistent
+        """
+        return Snapshot(self)
+
+    def version(self) -> int:
+        """Commit version of the most recent write."""
+        return _lib.db_version(self._db)
+
+    # ========================================================================
+    # TEMPORAL HISTORY
+    # ========================================================================
+
+    def enable_history(self) -> None:
+        """
+        Keep every version from now on so past states can be read again.
+
+        History costs one stored version per write; trim it with compact().
+        Cannot be turned off.
+        """
+        _lib.db_history_enable(self._db)
+
+    @property
+    def history_enabled(self) -> bool:
+        return _lib.db_history_enabled(self._db)
+
+    def history_floor(self) -> int:
+        """Oldest version snapshot_at() accepts."""
+        return _lib.db_history_floor(self._db)
+
+    def snapshot_at(self, version: int) -> Snapshot:
+        """
+        Read view of the database right after commit `version`.
+
+        Raises:
+            ValueError: If version is newer than version() or older than
+                history_floor()
+
+        Example:
+            >>> db.enable_history()
+            >>> db.set("k", "old"); v = db.version(); db.set("k", "new")
+            >>> with db.snapshot_at(v) as snap:
+            ...     snap.get("k")
+            'old'
+        """
+        if version < 0:
+            raise ValueError("Version must be non-negative")
+        return Snapshot(self, version)
+
+    def version_at(self, unix_ms: int) -> int:
+        """Last version committed at or before unix_ms (0 if before history)."""
+        return _lib.db_version_at_time(self._db, int(unix_ms))
+
+    def version_time(self, version: int) -> Optional[int]:
+        """Commit time of version in unix milliseconds, or None if unknown."""
+        ms = _lib.db_version_time(self._db, version)
+        return ms if ms >= 0 else None
+
+    def compact(self, floor: int) -> int:
+        """
+        Drop history older than version `floor` (held snapshots stay valid).
+
+        Returns:
+            Number of versions freed
+        """
+        return _lib.db_compact(self._db, max(0, floor))
+
+    # ========================================================================
+    # REPLICATION LOG
+    # ========================================================================
+
+    def enable_log(self, max_bytes: int = 0) -> None:
+        """
+        Log every commit from now on so followers can replay it.
+
+        The log keeps whole commits and drops the oldest beyond max_bytes
+        of encoded records (0 = library default, 64MB); followers further
+        behind catch up from dump() instead.  Calling it again changes the
+        limit.  Cannot be turned off.
+        """
+        if max_bytes < 0:
+            raise ValueError("max_bytes must be non-negative")
+        _lib.db_log_enable(self._db, max_bytes)
+
+    @property
+    def log_enabled(self) -> bool:
+        return _lib.db_log_enabled(self._db)
+
+    def log_floor(self) -> int:
+        """Oldest position log_read() accepts."""
+        return _lib.db_log_floor(self._db)
+
+    def log_read(self, after: int, max_bytes: int = 0) -> Optional[Tuple[bytes, int]]:
+        """
+        Encoded commits after version `after`, for replay() on a replica.
+
+        Args:
+            after: Replica position (last leader version it reflects)
+            max_bytes: Soft size limit; whole commits only (0 = no limit)
+
+        Returns:
+            (records, position the records bring the replica to), or None
+            if the log cannot serve `after` (no log, position below
+            log_floor() or ahead of version())
+
+        Example:
+            >>> db.enable_log(); db.set("k", "v")
+            >>> records, position = db.log_read(0)
+            >>> replica.replay(records)
+            True
+        """
+        if after < 0:
+            return None
+        length = ctypes.c_size_t()
+        through = ctypes.c_uint64()
+        ptr = _lib.db_log_read(self._db, after, max(0, max_bytes),
+                               ctypes.byref(length), ctypes.byref(through))
+        if not ptr:
+            return None
+        return _take_buffer(ptr, length.value), through.value
+
+    def dump(self, snapshot: Optional[Snapshot] = None) -> Tuple[bytes, int]:
+        """
+        Encode the whole state (as of snapshot, default now) as one commit.
+
+        Replaying it replaces a replica's contents; follow up with
+        log_read(version).
+
+        Returns:
+            (records, version the records reflect)
+        """
+        snap = snapshot._handle() if snapshot is not None else None
+        length = ctypes.c_size_t()
+        version = ctypes.c_uint64()
+        ptr = _lib.db_dump(self._db, snap, ctypes.byref(length), ctypes.byref(version))
+        if not ptr:
+            raise MemoryError("Failed to encode database")
+        return _take_buffer(ptr, length.value), version.value
+
+    def replay(self, records: bytes) -> bool:
+        """
+        Apply records from log_read() / dump() of another database.
+
+        Each leader commit becomes one local commit, so readers never see
+        part of one.  Replicas should not be written to otherwise.
+
+        Returns:
+            True on success, False for malformed records (nothing applied)
+            or on allocation failure
+        """
+        if not isinstance(records, (bytes, bytearray)):
+            raise TypeError("Records must be bytes")
+        return _lib.db_log_replay(self._db, bytes(records), len(records))
+
     def print_debug(self) -> None:
         """
         Print database contents to stdout (for debugging).
@@ -0,0 +1,136 @@
+"""
+Spanning Python Adapter
+
+Python wrapper for the C spanning library (minimum spanning forests and
+approximate Steiner trees of GraphStore views).
+This is the ONLY module that uses ctypes for spanning.
+
+Both treat a view as undirected: an edge exists if either direction does,
+weighing the lighter of the two; self-loops are ignored.
+"""
+
+import ctypes
+from array import array
+from typing import Any, Dict, Iterable, List, Tuple
+from ._loader import load_library
+from .graph_store import GraphView, _u32_array
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+SP_UNWEIGHTED = 0x1
+
+
+class SPStats(ctypes.Structure):
+    """Tree statistics (matches C SPStats)."""
+    _fields_ = [
+        ("weight", ctypes.c_double),
+        ("edges", ctypes.c_size_t),
+        ("components", ctypes.c_size_t),
+        ("threads", ctypes.c_uint),
+    ]
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert to Python dictionary."""
+        return {
+            'weight': self.weight,
+            'edges': self.edges,
+            'components': self.components,
+            'threads': self.threads,
+        }
+
+
+_U32P = ctypes.POINTER(ctypes.c_uint32)
+_F64P = ctypes.POINTER(ctypes.c_double)
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.sp_mst.argtypes = [ctypes.c_void_p, ctypes.c_uint, ctypes.c_uint,
+                        _U32P, _U32P, _F64P, ctypes.POINTER(SPStats)]
+_lib.sp_mst.restype = ctypes.c_bool
+
+_lib.sp_steiner.argtypes = [ctypes.c_void_p, _U32P, ctypes.c_size_t, ctypes.c_uint,
+                            _U32P, _U32P, _F64P, ctypes.POINTER(SPStats)]
+_lib.sp_steiner.restype = ctypes.c_bool
+
+
+# ============================================================================
+# PYTHON WRAPPER FUNCTIONS
+# ============================================================================
+
+Edge = Tuple[int, int, float]
+
+
+def _ptr(arr: array, ctype):
+    return ctypes.cast(arr.buffer_info()[0], ctype) if len(arr) else None
+
+
+def _outputs(view: GraphView):
+    n = view.node_count
+    return array('I', bytes(4 * n)), array('I', bytes(4 * n)), array('d', bytes(8 * n))
+
+
+def _edges(a: array, b: array, w: array, stats: SPStats) -> List[Edge]:
+    count = stats.edges
+    return list(zip(a[:count], b[:count], w[:count]))
+
+
+def minimum_spanning_tree(view: GraphView, unweighted: bool = False,
+                          threads: int = 0) -> Tuple[List[Edge], Dict[str, Any]]:
+    """
+    Minimum spanning forest (Borůvka).
+
+    Args:
+        view: Graph version (must track in-adjacency)
+        unweighted: Give every edge weight 1
+        threads: Worker threads (0 = one per CPU)
+
+    Returns:
+        (edges, stats): edges as (a, b, weight) with a < b; stats has the
+        total weight, edge count and the number of trees over linked nodes
+    """
+    a, b, w = _outputs(view)
+    stats = SPStats()
+    if not _lib.sp_mst(view._ptr(), SP_UNWEIGHTED if unweighted else 0, threads,
+                       _ptr(a, _U32P), _ptr(b, _U32P), _ptr(w, _F64P), ctypes.byref(stats)):
+        raise ValueError("Spanning trees need a view with in-adjacency and no NaN weights "
+                         "(or ran out of memory)")
+    return _edges(a, b, w, stats), stats.to_dict()
+
+
+def steiner_tree(view: GraphView, terminals: Iterable[int],
+                 unweighted: bool = False) -> Tuple[List[Edge], Dict[str, Any]]:
+    """
+    Approximate Steiner tree joining the terminals (at most twice the
+    optimum weight).
+
+    Args:
+        view: Graph version (must track in-adjacency)
+        terminals: Nodes to join (duplicates are ignored)
+        unweighted: Give every edge weight 1 (minimise hops)
+
+    Returns:
+        (edges, stats): edges as (a, b, weight); stats['components'] is the
+        number of terminal groups left unjoined (1 if all are connected)
+    """
+    terminals = _u32_array(terminals)
+    a, b, w = _outputs(view)
+    stats = SPStats()
+    if not _lib.sp_steiner(view._ptr(), _ptr(terminals, _U32P), len(terminals),
+                           SP_UNWEIGHTED if unweighted else 0,
+                           _ptr(a, _U32P), _ptr(b, _U32P), _ptr(w, _F64P), ctypes.byref(stats)):
+        raise ValueError("Terminal out of range, negative or NaN weights, or a view "
+                         "without in-adjacency")
+    return _edges(a, b, w, stats), stats.to_dict()
@@ -0,0 +1,204 @@
+"""
+Text Match Python Adapter
+
+Python wrapper for the C text_match library (Aho-Corasick dictionary
+matching over free text with negation scopes and a fuzzy fallback).
+This is the ONLY module that uses ctypes for text_match.
+
+Phrases and text are case-folded and matched on whole tokens; see
+text_match.h for the folding, fuzzy and negation rules.
+"""
+
+import ctypes
+from typing import Any, Dict, List, Tuple
+from ._loader import load_library
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+TM_TERM = 0
+TM_NEGATION = 1
+TM_TERMINATOR = 2
+
+TM_NEGATED = 0x1
+TM_FUZZY = 0x2
+
+
+class TMMatch(ctypes.Structure):
+    """One term match (matches C TMMatch)."""
+    _fields_ = [
+        ("value", ctypes.c_uint32),
+        ("start", ctypes.c_uint32),
+        ("end", ctypes.c_uint32),
+        ("flags", ctypes.c_uint32),
+        ("distance", ctypes.c_uint32),
+    ]
+
+
+class TMStats(ctypes.Structure):
+    """Scan statistics (matches C TMStats)."""
+    _fields_ = [
+        ("tokens", ctypes.c_size_t),
+        ("covered", ctypes.c_size_t),
+        ("terms", ctypes.c_size_t),
+    ]
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert to Python dictionary."""
+        return {'tokens': self.tokens, 'covered': self.covered, 'terms': self.terms}
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.tm_create.argtypes = []
+_lib.tm_create.restype = ctypes.c_void_p
+
+_lib.tm_free.argtypes = [ctypes.c_void_p]
+_lib.tm_free.restype = None
+
+_lib.tm_add.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t, ctypes.c_uint32,
+                        ctypes.c_uint]
+_lib.tm_add.restype = ctypes.c_bool
+
+_lib.tm_build.argtypes = [ctypes.c_void_p]
+_lib.tm_build.restype = ctypes.c_bool
+
+_lib.tm_phrase_count.argtypes = [ctypes.c_void_p]
+_lib.tm_phrase_count.restype = ctypes.c_size_t
+
+_lib.tm_state_count.argtypes = [ctypes.c_void_p]
+_lib.tm_state_count.restype = ctypes.c_size_t
+
+_lib.tm_scan.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t, ctypes.c_uint,
+                         ctypes.c_uint, ctypes.POINTER(TMMatch), ctypes.c_size_t,
+                         ctypes.POINTER(TMStats)]
+_lib.tm_scan.restype = ctypes.c_int64
+
+
+# ============================================================================
+# PYTHON WRAPPER CLASS
+# ============================================================================
+
+class PhraseDict:
+    """
+    Phrase dictionary compiled to an Aho-Corasick automaton.
+
+    Example:
+        terms = PhraseDict()
+        terms.add("fever", 0)
+        terms.add("no", 0, TM_NEGATION)
+        terms.build()
+        matches, stats = terms.scan("No fever but a bad cough")
+    """
+
+    def __init__(self):
+        self._d = _lib.tm_create()
+        if not self._d:
+            raise MemoryError("Failed to create phrase dictionary")
+        self._built = False
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        """Free the native dictionary."""
+        if getattr(self, '_d', None):
+            _lib.tm_free(self._d)
+            self._d = None
+
+    def _handle(self):
+        if not self._d:
+            raise ValueError("PhraseDict is closed")
+        return self._d
+
+    def add(self, phrase: str, value: int, kind: int = TM_TERM) -> bool:
+        """
+        Add a phrase (before build).
+
+        Args:
+            phrase: Text to match (case and punctuation are folded)
+            value: Reported for matches of the phrase
+            kind: TM_TERM, TM_NEGATION or TM_TERMINATOR
+
+        Returns:
+            False if the phrase folds to nothing (e.g. only punctuation)
+
+        Raises:
+            ValueError: After build or for an unknown kind
+        """
+        if self._built or kind not in (TM_TERM, TM_NEGATION, TM_TERMINATOR):
+            raise ValueError("Phrases must be added before build, with a known kind")
+        raw = phrase.encode('utf-8')
+        return bool(_lib.tm_add(self._handle(), raw, len(raw), value, kind))
+
+    def build(self) -> None:
+        """Compile the automaton."""
+        if not _lib.tm_build(self._handle()):
+            raise ValueError("Dictionary already built (or out of memory)")
+        self._built = True
+
+    @property
+    def phrase_count(self) -> int:
+        return _lib.tm_phrase_count(self._handle())
+
+    @property
+    def state_count(self) -> int:
+        return _lib.tm_state_count(self._handle())
+
+    def scan(self, text: str, max_edits: int = 1,
+             negation_window: int = 5) -> Tuple[List[Dict[str, Any]], Dict[str, Any]]:
+        """
+        Find dictionary terms in text.
+
+        Args:
+            text: Free text
+            max_edits: Edit bound for fuzzy matches of uncovered tokens
+                (0 = exact only)
+            negation_window: Tokens after a negation cue that it reaches
+
+        Returns:
+            (matches, stats): matches in text order, each with value, start
+            and end (character offsets), text, negated, fuzzy and distance;
+            stats has tokens, covered (tokens explained by the dictionary)
+            and terms
+        """
+        if not self._built:
+            raise ValueError("Dictionary not built")
+        raw = text.encode('utf-8')
+        stats = TMStats()
+        cap = 16
+        while True:
+            out = (TMMatch * cap)()
+            found = _lib.tm_scan(self._handle(), raw, len(raw), max_edits, negation_window,
+                                 out, cap, ctypes.byref(stats))
+            if found < 0:
+                raise ValueError("Text too long (or out of memory)")
+            if found <= cap:
+                break
+            cap = found
+
+        matches = []
+        for m in out[:found]:
+            prefix = len(raw[:m.start].decode('utf-8', errors='ignore'))
+            span = raw[m.start:m.end].decode('utf-8', errors='ignore')
+            matches.append({
+                'value': m.value,
+                'start': prefix,
+                'end': prefix + len(span),
+                'text': span,
+                'negated': bool(m.flags & TM_NEGATED),
+                'fuzzy': bool(m.flags & TM_FUZZY),
+                'distance': m.distance,
+            })
+        return matches, stats.to_dict()
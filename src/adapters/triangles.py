@@ -0,0 +1,126 @@
+"""
+Triangles Python Adapter
+
+Python wrapper for the C triangles library (triangle counts and clustering
+coefficients of GraphStore views).
+This is the ONLY module that uses ctypes for triangles.
+
+Counts are taken on the undirected simple graph underlying a view: edge
+directions are ignored, reciprocal edges count once, self-loops are dropped.
+"""
+
+import ctypes
+from array import array
+from typing import Any, Dict, Optional, Tuple
+from ._loader import load_library
+from .graph_store import GraphView
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+class TCResult(ctypes.Structure):
+    """Triangle statistics (matches C TCResult)."""
+    _fields_ = [
+        ("triangles", ctypes.c_uint64),
+        ("wedges", ctypes.c_uint64),
+        ("transitivity", ctypes.c_double),
+        ("avg_clustering", ctypes.c_double),
+        ("nodes", ctypes.c_size_t),
+        ("clustered_nodes", ctypes.c_size_t),
+        ("edges", ctypes.c_size_t),
+        ("samples", ctypes.c_uint64),
+    ]
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert to Python dictionary (avg_clustering None if not computed)."""
+        return {
+            'triangles': self.triangles,
+            'wedges': self.wedges,
+            'transitivity': self.transitivity,
+            'avg_clustering': self.avg_clustering if self.avg_clustering >= 0 else None,
+            'nodes': self.nodes,
+            'clustered_nodes': self.clustered_nodes,
+            'edges': self.edges,
+            'samples': self.samples,
+            'approximate': self.samples > 0,
+        }
+
+
+_U64P = ctypes.POINTER(ctypes.c_uint64)
+_F64P = ctypes.POINTER(ctypes.c_double)
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.tc_count.argtypes = [ctypes.c_void_p, ctypes.c_uint, _U64P, _F64P, ctypes.POINTER(TCResult)]
+_lib.tc_count.restype = ctypes.c_bool
+
+_lib.tc_estimate.argtypes = [
+    ctypes.c_void_p, ctypes.c_uint64, ctypes.c_uint64, ctypes.c_uint, ctypes.POINTER(TCResult),
+]
+_lib.tc_estimate.restype = ctypes.c_bool
+
+
+# ============================================================================
+# PYTHON WRAPPER FUNCTIONS
+# ============================================================================
+
+def count_triangles(view: GraphView, per_node: bool = False,
+                    threads: int = 0) -> Tuple[Dict[str, Any], Optional[array], Optional[array]]:
+    """
+    Count triangles exactly.
+
+    Args:
+        view: Graph version to analyse (must track in-adjacency)
+        per_node: Also return per-node triangle counts and local clustering
+            coefficients (needed for avg_clustering)
+        threads: Worker threads (0 = one per CPU)
+
+    Returns:
+        (stats, triangles, clustering); the arrays are indexed by node ID
+        (array('Q') and array('d')), or None unless per_node
+    """
+    result = TCResult()
+    triangles = clustering = None
+    tri_ptr, cc_ptr = None, None
+    if per_node:
+        n = view.node_count
+        triangles = array('Q', bytes(8 * n))
+        clustering = array('d', bytes(8 * n))
+        if n:
+            tri_ptr = ctypes.cast(triangles.buffer_info()[0], _U64P)
+            cc_ptr = ctypes.cast(clustering.buffer_info()[0], _F64P)
+    if not _lib.tc_count(view._ptr(), threads, tri_ptr, cc_ptr, ctypes.byref(result)):
+        raise ValueError("Triangle counting needs a view with in-adjacency (or ran out of memory)")
+    if per_node and not view.node_count:
+        result.avg_clustering = 0.0
+    return result.to_dict(), triangles, clustering
+
+
+def estimate_triangles(view: GraphView, samples: int = 200000, seed: int = 0,
+                       threads: int = 0) -> Dict[str, Any]:
+    """
+    Estimate triangle statistics by wedge sampling.
+
+    Half the samples estimate transitivity (and from it the triangle
+    count), the other half the average clustering coefficient; the
+    standard error of each is about 1/sqrt(samples / 2).
+
+    Returns:
+        The same statistics as count_triangles, with approximate=True
+    """
+    result = TCResult()
+    if not _lib.tc_estimate(view._ptr(), samples, seed, threads, ctypes.byref(result)):
+        raise ValueError("Triangle estimation needs a view with in-adjacency (or ran out of memory)")
+    return result.to_dict()
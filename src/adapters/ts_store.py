@@ -0,0 +1,336 @@
+"""
+TimeSeriesStore Python Adapter
+
+Python wrapper for the C ts_store library (append-only, compressed,
+time-partitioned test-result series).
+This is the ONLY module that uses ctypes for ts_store.
+
+Timestamps are integer milliseconds since the Unix epoch; durations are
+seconds.  Statuses are the strings in STATUSES.
+"""
+
+import ctypes
+from datetime import datetime, timezone
+from typing import Dict, List, Optional, Any, Union
+from ._loader import load_library
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+# Status names -> C TSStatus values
+STATUSES = {'passed': 0, 'failed': 1, 'skipped': 2, 'error': 3}
+_STATUS_NAMES = {v: k for k, v in STATUSES.items()}
+
+_STATUS_COUNT = len(STATUSES)
+
+DAY_MS = 86_400_000
+
+# Open-ended scan bounds
+_TS_MIN = -(1 << 63)
+_TS_MAX = (1 << 63) - 1
+
+
+class TSPoint(ctypes.Structure):
+    """One record (matches C TSPoint)."""
+    _fields_ = [
+        ("ts", ctypes.c_int64),
+        ("duration", ctypes.c_double),
+        ("ref", ctypes.c_uint32),
+        ("status", ctypes.c_uint8),
+    ]
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert to Python dictionary."""
+        return {
+            'ts': self.ts,
+            'status': _STATUS_NAMES[self.status],
+            'duration': self.duration,
+            'ref': self.ref,
+        }
+
+
+class TSSummary(ctypes.Structure):
+    """Aggregate over one time bucket (matches C TSSummary)."""
+    _fields_ = [
+        ("start", ctypes.c_int64),
+        ("end", ctypes.c_int64),
+        ("count", ctypes.c_size_t),
+        ("status_counts", ctypes.c_size_t * _STATUS_COUNT),
+        ("duration_sum", ctypes.c_double),
+        ("duration_min", ctypes.c_double),
+        ("duration_max", ctypes.c_double),
+    ]
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert to Python dictionary."""
+        counts = {_STATUS_NAMES[i]: self.status_counts[i] for i in range(_STATUS_COUNT)}
+        return {
+            'start': self.start,
+            'end': self.end,
+            'count': self.count,
+            'status_counts': counts,
+            'pass_rate': 100.0 * counts['passed'] / self.count if self.count else 0.0,
+            'duration_sum': self.duration_sum,
+            'duration_avg': self.duration_sum / self.count if self.count else 0.0,
+            'duration_min': self.duration_min,
+            'duration_max': self.duration_max,
+        }
+
+
+class TSStats(ctypes.Structure):
+    """Store statistics (matches C TSStats)."""
+    _fields_ = [
+        ("series", ctypes.c_size_t),
+        ("blocks", ctypes.c_size_t),
+        ("points", ctypes.c_size_t),
+        ("compressed_bytes", ctypes.c_size_t),
+        ("raw_bytes", ctypes.c_size_t),
+    ]
+
+    def to_dict(self) -> Dict[str, int]:
+        """Convert to Python dictionary."""
+        return {
+            'series': self.series,
+            'blocks': self.blocks,
+            'points': self.points,
+            'compressed_bytes': self.compressed_bytes,
+            'raw_bytes': self.raw_bytes,
+        }
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.ts_create.argtypes = [ctypes.c_int64]
+_lib.ts_create.restype = ctypes.c_void_p
+
+_lib.ts_destroy.argtypes = [ctypes.c_void_p]
+_lib.ts_destroy.restype = None
+
+_lib.ts_block_span.argtypes = [ctypes.c_void_p]
+_lib.ts_block_span.restype = ctypes.c_int64
+
+_lib.ts_append.argtypes = [
+    ctypes.c_void_p, ctypes.c_char_p, ctypes.c_int64,
+    ctypes.c_uint8, ctypes.c_double, ctypes.c_uint32,
+]
+_lib.ts_append.restype = ctypes.c_bool
+
+_lib.ts_drop_before.argtypes = [ctypes.c_void_p, ctypes.c_int64]
+_lib.ts_drop_before.restype = ctypes.c_size_t
+
+_lib.ts_scan.argtypes = [
+    ctypes.c_void_p, ctypes.c_char_p, ctypes.c_int64, ctypes.c_int64,
+    ctypes.POINTER(TSPoint), ctypes.c_size_t,
+]
+_lib.ts_scan.restype = ctypes.c_size_t
+
+_lib.ts_latest.argtypes = [
+    ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t, ctypes.POINTER(TSPoint),
+]
+_lib.ts_latest.restype = ctypes.c_size_t
+
+_lib.ts_summarize.argtypes = [
+    ctypes.c_void_p, ctypes.c_char_p, ctypes.c_int64, ctypes.c_int64,
+    ctypes.c_int64, ctypes.POINTER(TSSummary), ctypes.c_size_t,
+]
+_lib.ts_summarize.restype = ctypes.c_size_t
+
+_lib.ts_count.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+_lib.ts_count.restype = ctypes.c_size_t
+
+_lib.ts_series.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_size_t)]
+_lib.ts_series.restype = ctypes.POINTER(ctypes.c_char_p)
+
+_lib.ts_free_names.argtypes = [ctypes.POINTER(ctypes.c_char_p), ctypes.c_size_t]
+_lib.ts_free_names.restype = None
+
+_lib.ts_stats.argtypes = [ctypes.c_void_p]
+_lib.ts_stats.restype = TSStats
+
+
+def to_ms(value: Union[str, datetime]) -> int:
+    """
+    Milliseconds since the epoch for an ISO-8601 string or datetime.
+
+    Naive values are taken as UTC (the services store utcnow() stamps).
+    """
+    if isinstance(value, str):
+        value = datetime.fromisoformat(value)
+    if value.tzinfo is None:
+        value = value.replace(tzinfo=timezone.utc)
+    return int(value.timestamp() * 1000)
+
+
+# ============================================================================
+# PYTHON WRAPPER CLASS
+# ============================================================================
+
+class TimeSeriesStore:
+    """
+    Append-only store of (timestamp, status, duration, ref) series.
+
+    Points are compressed in blocks of block_span_ms; every block keeps a
+    summary, so day-bucketed trends over long ranges read summaries only.
+    Retention (drop_before) frees whole blocks.
+
+    Example:
+        ts = TimeSeriesStore()
+        ts.append("test:core::test_set", 1700000000000, "passed", 0.012)
+        ts.summarize("test:core::test_set", bucket_ms=DAY_MS)
+    """
+
+    def __init__(self, block_span_ms: int = DAY_MS):
+        """
+        Create an empty store.
+
+        Args:
+            block_span_ms: Block width in milliseconds (epoch-aligned)
+
+        Raises:
+            ValueError: If block_span_ms is negative
+            MemoryError: If store creation fails
+        """
+        if block_span_ms < 0:
+            raise ValueError("block_span_ms must be non-negative")
+        self._ts = _lib.ts_create(block_span_ms)
+        if not self._ts:
+            raise MemoryError("Failed to create time-series store")
+
+    def __del__(self):
+        if getattr(self, '_ts', None):
+            _lib.ts_destroy(self._ts)
+            self._ts = None
+
+    @staticmethod
+    def _name(series: str) -> bytes:
+        if not isinstance(series, str):
+            raise TypeError("Series name must be a string")
+        return series.encode('utf-8')
+
+    @property
+    def block_span(self) -> int:
+        """Block width in milliseconds."""
+        return _lib.ts_block_span(self._ts)
+
+    # ========================================================================
+    # WRITES
+    # ========================================================================
+
+    def append(self, series: str, ts: int, status: str, duration: float,
+               ref: int = 0) -> bool:
+        """
+        Append a point.
+
+        Args:
+            series: Series name (created on first use)
+            ts: Milliseconds since the epoch, >= the series' latest point
+            status: One of STATUSES
+            duration: Seconds
+            ref: Caller's 32-bit link to a detail record
+
+        Returns:
+            False if ts is older than the series' latest point
+
+        Raises:
+            ValueError: For an unknown status
+        """
+        if status not in STATUSES:
+            raise ValueError(f"Unknown status: {status}")
+        return _lib.ts_append(self._ts, self._name(series), int(ts),
+                              STATUSES[status], float(duration), ref & 0xFFFFFFFF)
+
+    def drop_before(self, ts: int) -> int:
+        """
+        Drop every block ending at or before ts, in all series.
+
+        Returns:
+            Number of points dropped
+        """
+        return _lib.ts_drop_before(self._ts, int(ts))
+
+    # ========================================================================
+    # QUERIES
+    # ========================================================================
+
+    def scan(self, series: str, start: Optional[int] = None,
+             end: Optional[int] = None) -> List[Dict[str, Any]]:
+        """Points with start <= ts < end, oldest first."""
+        name = self._name(series)
+        lo = _TS_MIN if start is None else int(start)
+        hi = _TS_MAX if end is None else int(end)
+
+        n = _lib.ts_scan(self._ts, name, lo, hi, None, 0)
+        if n == 0:
+            return []
+        out = (TSPoint * n)()
+        n = min(n, _lib.ts_scan(self._ts, name, lo, hi, out, n))
+        return [out[i].to_dict() for i in range(n)]
+
+    def latest(self, series: str, n: int = 1) -> List[Dict[str, Any]]:
+        """The n most recent points, newest first."""
+        if n <= 0:
+            return []
+        out = (TSPoint * n)()
+        got = _lib.ts_latest(self._ts, self._name(series), n, out)
+        return [out[i].to_dict() for i in range(got)]
+
+    def summarize(self, series: str, start: Optional[int] = None,
+                  end: Optional[int] = None, bucket_ms: int = DAY_MS) -> List[Dict[str, Any]]:
+        """
+        Per-bucket aggregates over [start, end), oldest first.
+
+        Buckets are epoch-aligned and only non-empty ones are returned.
+        With bucket_ms a multiple of the block span, whole blocks are read
+        from their stored summaries.
+        """
+        name = self._name(series)
+        lo = _TS_MIN if start is None else int(start)
+        hi = _TS_MAX if end is None else int(end)
+
+        n = _lib.ts_summarize(self._ts, name, lo, hi, bucket_ms, None, 0)
+        if n == 0:
+            return []
+        out = (TSSummary * n)()
+        n = min(n, _lib.ts_summarize(self._ts, name, lo, hi, bucket_ms, out, n))
+        return [out[i].to_dict() for i in range(n)]
+
+    def count(self, series: str) -> int:
+        """Number of points in series."""
+        return _lib.ts_count(self._ts, self._name(series))
+
+    def series(self, prefix: str = "") -> List[str]:
+        """Names of all series (optionally filtered by prefix), sorted."""
+        count = ctypes.c_size_t(0)
+        names_ptr = _lib.ts_series(self._ts, ctypes.byref(count))
+        if not names_ptr:
+            return []
+
+        names = [names_ptr[i].decode('utf-8') for i in range(count.value)]
+        _lib.ts_free_names(names_ptr, count.value)
+        return sorted(n for n in names if n.startswith(prefix))
+
+    def stats(self) -> Dict[str, int]:
+        """Series, blocks, points and encoded vs raw size."""
+        return _lib.ts_stats(self._ts).to_dict()
+
+    # ========================================================================
+    # PYTHONIC INTERFACE
+    # ========================================================================
+
+    def __contains__(self, series: str) -> bool:
+        return self.count(series) > 0
+
+    def __repr__(self) -> str:
+        s = self.stats()
+        return f"<TimeSeriesStore series={s['series']} points={s['points']}>"
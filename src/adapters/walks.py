@@ -0,0 +1,188 @@
+"""
+Walks Python Adapter
+
+Python wrapper for the C walks library (uniform, weighted and node2vec
+random walks; random walk with restart proximity).
+This is the ONLY module that uses ctypes for walks.
+
+A WalkGraph is built once from a GraphView and is independent of it
+afterwards. Node IDs are the view's node IDs.
+"""
+
+import ctypes
+from array import array
+from typing import Iterable, List, Tuple
+from ._loader import load_library
+from .graph_store import GraphView, _u32_array
+
+
+# ============================================================================
+# LOAD C LIBRARY
+# ============================================================================
+
+_lib = load_library("simpledb")
+
+
+# ============================================================================
+# C TYPE DEFINITIONS
+# ============================================================================
+
+RW_UNDIRECTED = 0x1
+RW_WEIGHTED = 0x2
+RW_END = 0xFFFFFFFF
+
+_U32P = ctypes.POINTER(ctypes.c_uint32)
+_F64P = ctypes.POINTER(ctypes.c_double)
+
+
+class RWParams(ctypes.Structure):
+    _fields_ = [
+        ("length", ctypes.c_uint32),
+        ("p", ctypes.c_double),
+        ("q", ctypes.c_double),
+        ("restart", ctypes.c_double),
+        ("seed", ctypes.c_uint64),
+        ("threads", ctypes.c_uint),
+    ]
+
+
+# ============================================================================
+# C FUNCTION SIGNATURES
+# ============================================================================
+
+_lib.rw_prepare.argtypes = [ctypes.c_void_p, ctypes.c_uint, ctypes.c_uint]
+_lib.rw_prepare.restype = ctypes.c_void_p
+
+_lib.rw_free.argtypes = [ctypes.c_void_p]
+_lib.rw_free.restype = None
+
+_lib.rw_node_count.argtypes = [ctypes.c_void_p]
+_lib.rw_node_count.restype = ctypes.c_size_t
+
+_lib.rw_edge_count.argtypes = [ctypes.c_void_p]
+_lib.rw_edge_count.restype = ctypes.c_size_t
+
+_lib.rw_walks.argtypes = [ctypes.c_void_p, _U32P, ctypes.c_size_t, ctypes.c_uint32,
+                          ctypes.POINTER(RWParams), _U32P]
+_lib.rw_walks.restype = ctypes.c_bool
+
+_lib.rw_proximity.argtypes = [ctypes.c_void_p, _U32P, ctypes.c_size_t, ctypes.c_uint64,
+                              ctypes.POINTER(RWParams), ctypes.c_size_t, _U32P, _F64P]
+_lib.rw_proximity.restype = ctypes.c_int64
+
+
+# ============================================================================
+# PYTHON WRAPPER CLASS
+# ============================================================================
+
+def _ptr(arr: array, ctype):
+    return ctypes.cast(arr.buffer_info()[0], ctype) if len(arr) else None
+
+
+class WalkGraph:
+    """
+    Random-walk sampler over a graph version.
+
+    Example:
+        with graph.view() as view:
+            walker = WalkGraph(view, weighted=True)
+        corpus = walker.walks([0, 1], walks_per_node=10, length=20, p=0.5, q=2.0)
+        related = walker.proximity([0], walks=20000, top_k=10)
+    """
+
+    def __init__(self, view: GraphView, weighted: bool = False, undirected: bool = False,
+                 threads: int = 0):
+        """
+        Args:
+            view: Graph version to walk
+            weighted: Step with probability proportional to edge weight
+            undirected: Follow edges in both directions (needs in-adjacency)
+            threads: Build threads (0 = one per CPU)
+        """
+        flags = (RW_WEIGHTED if weighted else 0) | (RW_UNDIRECTED if undirected else 0)
+        self._g = _lib.rw_prepare(view._ptr(), flags, threads)
+        if not self._g:
+            raise ValueError("Undirected walks need a view with in-adjacency (or out of memory)")
+        self.node_count = _lib.rw_node_count(self._g)
+        self.edge_count = _lib.rw_edge_count(self._g)
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        """Free the native walk graph."""
+        if getattr(self, '_g', None):
+            _lib.rw_free(self._g)
+            self._g = None
+
+    def _handle(self):
+        if not self._g:
+            raise ValueError("WalkGraph is closed")
+        return self._g
+
+    @staticmethod
+    def _params(length: int, p: float, q: float, restart: float, seed: int,
+                threads: int) -> RWParams:
+        if p <= 0 or q <= 0:
+            raise ValueError("p and q must be positive")
+        return RWParams(length, p, q, restart, seed & 0xFFFFFFFFFFFFFFFF, threads)
+
+    def walks(self, starts: Iterable[int], walks_per_node: int = 1, length: int = 40,
+              p: float = 1.0, q: float = 1.0, seed: int = 0, threads: int = 0) -> array:
+        """
+        Walk corpus.
+
+        Args:
+            starts: Start nodes
+            walks_per_node: Walks from each start node
+            length: Steps per walk
+            p: node2vec return parameter (low = backtrack often)
+            q: node2vec in-out parameter (low = move outward, DFS-like)
+            seed: RNG seed (results do not depend on threads)
+            threads: Walk threads (0 = one per CPU)
+
+        Returns:
+            Flat array('I'): walk k is out[k * (length + 1):(k + 1) * (length + 1)],
+            starting at starts[k % len(starts)] and padded with RW_END after
+            a dead end
+        """
+        starts = _u32_array(starts)
+        params = self._params(length, p, q, 0.0, seed, threads)
+        out = array('I', bytes(4 * len(starts) * walks_per_node * (length + 1)))
+        if not _lib.rw_walks(self._handle(), _ptr(starts, _U32P), len(starts), walks_per_node,
+                             ctypes.byref(params), _ptr(out, _U32P)):
+            raise ValueError("Start node out of range")
+        return out
+
+    def proximity(self, sources: Iterable[int], walks: int = 10000, restart: float = 0.15,
+                  max_length: int = 100, top_k: int = 20, p: float = 1.0, q: float = 1.0,
+                  seed: int = 0, threads: int = 0) -> List[Tuple[int, float]]:
+        """
+        Nodes closest to the sources by random walk with restart.
+
+        Args:
+            sources: Nodes the walks restart from
+            walks: Number of walks (more = less noise)
+            restart: Probability of ending a walk at each step
+            max_length: Cap on steps per walk
+            top_k: Results wanted
+            p, q: node2vec parameters (see walks)
+
+        Returns:
+            (node, score) best first, sources excluded; a score is the
+            node's share of all visits (a personalised PageRank estimate)
+        """
+        sources = _u32_array(sources)
+        if not sources:
+            raise ValueError("Need at least one source")
+        if not 0.0 <= restart <= 1.0:
+            raise ValueError("restart must be within [0, 1]")
+        params = self._params(max_length, p, q, restart, seed, threads)
+        ids = array('I', bytes(4 * top_k))
+        scores = array('d', bytes(8 * top_k))
+        found = _lib.rw_proximity(self._handle(), _ptr(sources, _U32P), len(sources), walks,
+                                  ctypes.byref(params), top_k, _ptr(ids, _U32P),
+                                  _ptr(scores, _F64P))
+        if found < 0:
+            raise ValueError("Source node out of range or too many walk steps")
+        return list(zip(ids[:found], scores[:found]))
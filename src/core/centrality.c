@@ -0,0 +1,786 @@
+/**
+ * centrality.c — Betweenness and harmonic closeness centrality
+ *
+ * Directed traversals read the view's adjacency lists directly.  With
+ * CT_UNDIRECTED a deduplicated undirected CSR copy is built first
+ * (off[u] .. off[u + 1] indexes u's sorted neighbours in adj), and serves
+ * as both the out- and the in-lists.
+ *
+ * Every thread owns its BFS state (dist, sigma, delta, visit order) and,
+ * for betweenness, its own accumulator, so the hot loops share nothing.
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   /* sysconf */
+#endif
+
+#include "centrality.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define CHUNK         256u      /* vertices claimed at a time (CSR build) */
+#define SOURCE_CHUNK  8u        /* Brandes sources claimed at a time      */
+#define SAMPLE_CHUNK  1024u     /* sampled pairs per RNG stream           */
+#define MAX_THREADS   64u
+#define RK_C          0.5       /* universal constant of the sample bound */
+
+typedef struct {
+    const GSView *view;
+    bool          undirected;
+    size_t        n;
+    size_t       *off;          /* undirected CSR, n + 1 (CT_UNDIRECTED) */
+    uint32_t     *adj;
+} Topo;
+
+typedef struct {
+    int32_t  *dist;             /* -1 = not reached */
+    double   *sigma;            /* shortest-path counts */
+    double   *delta;            /* dependencies */
+    uint32_t *order;            /* nodes in BFS order */
+    double   *acc;              /* betweenness accumulator */
+} Work;
+
+/* One direction of a bidirectional search, expanded a level at a time. */
+typedef struct {
+    int32_t  *dist;             /* -1 = not reached */
+    double   *sigma;
+    uint32_t *order;            /* visited nodes; the deepest level is
+                                   order[level_begin .. visited) */
+    size_t    level_begin, visited;
+    int32_t   level;
+} Side;
+
+typedef struct {
+    Side      side[2];          /* 0: from s along out-edges,
+                                   1: from t along in-edges */
+    uint32_t *hits;             /* sampled-path credits */
+} PairWork;
+
+typedef void (*RangeFn)(void *ctx, unsigned worker, size_t begin, size_t end);
+
+typedef struct {
+    RangeFn         fn;
+    void           *ctx;
+    size_t          n, chunk;
+    _Atomic size_t  next;
+} Ranges;
+
+typedef struct {
+    Ranges  *r;
+    unsigned worker;
+} RangeWorker;
+
+static unsigned thread_count(unsigned threads, size_t chunks)
+{
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads > chunks)
+        threads = chunks ? (unsigned)chunks : 1;
+    return threads;
+}
+
+static void *range_main(void *arg)
+{
+    RangeWorker *w = arg;
+    Ranges *r = w->r;
+    for (;;) {
+        size_t begin = atomic_fetch_add(&r->next, r->chunk);
+        if (begin >= r->n)
+            break;
+        size_t end = begin + r->chunk < r->n ? begin + r->chunk : r->n;
+        r->fn(r->ctx, w->worker, begin, end);
+    }
+    return NULL;
+}
+
+/*
+ * Run fn over [0, n) in chunks on `threads` workers (the caller is worker
+ * 0).  If a thread cannot be started its share falls to the others.
+ */
+static void parallel_ranges(size_t n, size_t chunk, unsigned threads, RangeFn fn, void *ctx)
+{
+    Ranges r = { .fn = fn, .ctx = ctx, .n = n, .chunk = chunk };
+    atomic_init(&r.next, 0);
+    RangeWorker workers[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    unsigned started = 1;
+
+    for (unsigned t = 0; t < threads; t++)
+        workers[t] = (RangeWorker){ &r, t };
+    for (; started < threads; started++)
+        if (pthread_create(&tids[started], NULL, range_main, &workers[started]) != 0)
+            break;
+    range_main(&workers[0]);
+    for (unsigned t = 1; t < started; t++)
+        pthread_join(tids[t], NULL);
+}
+
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/* -------------------------------------------------------------------------
+ * Topology access
+ * ---------------------------------------------------------------------- */
+
+/* Sorted union of out- and in-neighbours without u; counts only if out is NULL. */
+static size_t undirected_neighbors(const GSView *v, uint32_t u, uint32_t *out)
+{
+    const uint32_t *a = NULL, *b = NULL;
+    size_t na = gs_view_neighbors(v, u, &a, NULL);
+    size_t nb = gs_view_in_neighbors(v, u, &b, NULL);
+    size_t i = 0, j = 0, n = 0;
+    while (i < na || j < nb) {
+        uint32_t x;
+        if (j == nb || (i < na && a[i] < b[j]))
+            x = a[i++];
+        else if (i == na || b[j] < a[i])
+            x = b[j++];
+        else {
+            x = a[i++];
+            j++;
+        }
+        if (x == u)
+            continue;
+        if (out)
+            out[n] = x;
+        n++;
+    }
+    return n;
+}
+
+static void degree_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    Topo *t = ctx;
+    (void)worker;
+    for (size_t u = begin; u < end; u++)
+        t->off[u + 1] = undirected_neighbors(t->view, (uint32_t)u, NULL);
+}
+
+static void fill_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    Topo *t = ctx;
+    (void)worker;
+    for (size_t u = begin; u < end; u++)
+        undirected_neighbors(t->view, (uint32_t)u, t->adj + t->off[u]);
+}
+
+static void topo_free(Topo *t)
+{
+    free(t->off);
+    free(t->adj);
+}
+
+static bool topo_open(const GSView *v, unsigned flags, unsigned threads, Topo *t)
+{
+    memset(t, 0, sizeof *t);
+    if (!gs_view_tracks_in(v))
+        return false;
+    t->view = v;
+    t->n = gs_view_node_count(v);
+    t->undirected = flags & CT_UNDIRECTED;
+    if (!t->undirected)
+        return true;
+
+    t->off = calloc(t->n + 1, sizeof *t->off);
+    if (!t->off)
+        return false;
+    threads = thread_count(threads, (t->n + CHUNK - 1) / CHUNK);
+    parallel_ranges(t->n, CHUNK, threads, degree_pass, t);
+    for (size_t u = 0; u < t->n; u++)
+        t->off[u + 1] += t->off[u];
+    t->adj = malloc((t->off[t->n] ? t->off[t->n] : 1) * sizeof *t->adj);
+    if (!t->adj) {
+        topo_free(t);
+        return false;
+    }
+    parallel_ranges(t->n, CHUNK, threads, fill_pass, t);
+    return true;
+}
+
+static inline size_t out_list(const Topo *t, uint32_t u, const uint32_t **list)
+{
+    if (t->undirected) {
+        *list = t->adj + t->off[u];
+        return t->off[u + 1] - t->off[u];
+    }
+    return gs_view_neighbors(t->view, u, list, NULL);
+}
+
+static inline size_t in_list(const Topo *t, uint32_t u, const uint32_t **list)
+{
+    if (t->undirected)
+        return out_list(t, u, list);
+    return gs_view_in_neighbors(t->view, u, list, NULL);
+}
+
+/* -------------------------------------------------------------------------
+ * Per-thread state
+ * ---------------------------------------------------------------------- */
+
+static void work_free(Work *w)
+{
+    free(w->dist);
+    free(w->sigma);
+    free(w->delta);
+    free(w->order);
+    free(w->acc);
+    memset(w, 0, sizeof *w);
+}
+
+static bool work_init(Work *w, size_t n)
+{
+    size_t m = n ? n : 1;
+    memset(w, 0, sizeof *w);
+    w->dist = malloc(m * sizeof *w->dist);
+    w->sigma = malloc(m * sizeof *w->sigma);
+    w->delta = malloc(m * sizeof *w->delta);
+    w->order = malloc(m * sizeof *w->order);
+    w->acc = calloc(m, sizeof *w->acc);
+    if (!w->dist || !w->sigma || !w->delta || !w->order || !w->acc) {
+        work_free(w);
+        return false;
+    }
+    for (size_t u = 0; u < n; u++)
+        w->dist[u] = -1;
+    return true;
+}
+
+static bool works_init(Work *works, unsigned threads, size_t n)
+{
+    for (unsigned t = 0; t < threads; t++) {
+        if (!work_init(&works[t], n)) {
+            while (t--)
+                work_free(&works[t]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * BFS from s counting shortest paths.  Returns the number of nodes in
+ * w->order; the caller resets their dist entries.
+ */
+static size_t bfs_paths(const Topo *t, Work *w, uint32_t s)
+{
+    size_t head = 0, tail = 1;
+    w->order[0] = s;
+    w->dist[s] = 0;
+    w->sigma[s] = 1.0;
+    w->delta[s] = 0.0;
+    while (head < tail) {
+        uint32_t u = w->order[head++];
+        int32_t du = w->dist[u];
+        const uint32_t *nb;
+        size_t deg = out_list(t, u, &nb);
+        for (size_t i = 0; i < deg; i++) {
+            uint32_t x = nb[i];
+            if (w->dist[x] < 0) {
+                w->dist[x] = du + 1;
+                w->sigma[x] = 0.0;
+                w->delta[x] = 0.0;
+                w->order[tail++] = x;
+            }
+            if (w->dist[x] == du + 1)
+                w->sigma[x] += w->sigma[u];
+        }
+    }
+    return tail;
+}
+
+static void bfs_reset(Work *w, size_t visited)
+{
+    for (size_t i = 0; i < visited; i++)
+        w->dist[w->order[i]] = -1;
+}
+
+/* -------------------------------------------------------------------------
+ * Exact betweenness (Brandes)
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const Topo     *t;
+    Work           *works;
+    const uint32_t *sources;    /* NULL = 0 .. n - 1 */
+} BrandesCtx;
+
+static void brandes_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    BrandesCtx *c = ctx;
+    const Topo *t = c->t;
+    Work *w = &c->works[worker];
+
+    for (size_t k = begin; k < end; k++) {
+        uint32_t s = c->sources ? c->sources[k] : (uint32_t)k;
+        if (s >= t->n)
+            continue;
+        size_t visited = bfs_paths(t, w, s);
+
+        /* Pull dependencies from successors, farthest nodes first. */
+        for (size_t i = visited; i-- > 1;) {
+            uint32_t u = w->order[i];
+            const uint32_t *nb;
+            size_t deg = out_list(t, u, &nb);
+            double d = 0.0;
+            for (size_t j = 0; j < deg; j++) {
+                uint32_t x = nb[j];
+                if (w->dist[x] == w->dist[u] + 1)
+                    d += (1.0 + w->delta[x]) / w->sigma[x];
+            }
+            w->delta[u] = w->sigma[u] * d;
+            w->acc[u] += w->delta[u];
+        }
+        bfs_reset(w, visited);
+    }
+}
+
+static void merge_acc(Work *works, unsigned threads, size_t n, double *out)
+{
+    for (size_t u = 0; u < n; u++) {
+        double sum = 0.0;
+        for (unsigned k = 0; k < threads; k++)
+            sum += works[k].acc[u];
+        out[u] = sum;
+    }
+}
+
+bool ct_betweenness(const GSView *v, const uint32_t *sources, size_t n_sources,
+                    unsigned flags, unsigned threads, double *out, CTStats *stats)
+{
+    Topo t;
+    if (!topo_open(v, flags, threads, &t))
+        return false;
+    if (!sources)
+        n_sources = t.n;
+    threads = thread_count(threads, (n_sources + SOURCE_CHUNK - 1) / SOURCE_CHUNK);
+
+    Work works[MAX_THREADS];
+    bool ok = works_init(works, threads, t.n);
+    if (ok) {
+        BrandesCtx c = { &t, works, sources };
+        parallel_ranges(n_sources, SOURCE_CHUNK, threads, brandes_pass, &c);
+        merge_acc(works, threads, t.n, out);
+        for (unsigned k = 0; k < threads; k++)
+            work_free(&works[k]);
+        if (stats)
+            *stats = (CTStats){ .samples = n_sources, .threads = threads };
+    }
+    topo_free(&t);
+    return ok;
+}
+
+/* -------------------------------------------------------------------------
+ * Sampled betweenness (Riondato-Kornaropoulos)
+ * ---------------------------------------------------------------------- */
+
+static void pair_work_free(PairWork *w)
+{
+    for (int k = 0; k < 2; k++) {
+        free(w->side[k].dist);
+        free(w->side[k].sigma);
+        free(w->side[k].order);
+    }
+    free(w->hits);
+    memset(w, 0, sizeof *w);
+}
+
+static bool pair_works_init(PairWork *works, unsigned threads, size_t n)
+{
+    size_t m = n ? n : 1;
+    for (unsigned t = 0; t < threads; t++) {
+        PairWork *w = &works[t];
+        bool ok = true;
+        memset(w, 0, sizeof *w);
+        for (int k = 0; k < 2; k++) {
+            w->side[k].dist = malloc(m * sizeof *w->side[k].dist);
+            w->side[k].sigma = malloc(m * sizeof *w->side[k].sigma);
+            w->side[k].order = malloc(m * sizeof *w->side[k].order);
+            ok = ok && w->side[k].dist && w->side[k].sigma && w->side[k].order;
+        }
+        w->hits = calloc(m, sizeof *w->hits);
+        if (!ok || !w->hits) {
+            pair_work_free(w);
+            while (t--)
+                pair_work_free(&works[t]);
+            return false;
+        }
+        for (int k = 0; k < 2; k++)
+            for (size_t u = 0; u < n; u++)
+                w->side[k].dist[u] = -1;
+    }
+    return true;
+}
+
+/*
+ * Upper bound on the number of nodes on any shortest path.  Per weakly
+ * connected component: its size, and for undirected traversals also
+ * 2 * ecc(root) + 1, since any two nodes are within 2 * ecc of each other.
+ * dist must be all -1 and is left that way.
+ */
+static uint32_t vertex_diameter(const Topo *t, int32_t *dist, uint32_t *order)
+{
+    uint32_t bound = 0;
+    size_t seen = 0;
+    for (size_t root = 0; root < t->n; root++) {
+        if (dist[root] >= 0)
+            continue;
+        size_t head = seen, tail = seen + 1;
+        int32_t ecc = 0;
+        order[seen] = (uint32_t)root;
+        dist[root] = 0;
+        while (head < tail) {
+            uint32_t u = order[head++];
+            const uint32_t *lists[2];
+            size_t degs[2] = { out_list(t, u, &lists[0]), 0 };
+            if (!t->undirected)
+                degs[1] = in_list(t, u, &lists[1]);
+            for (int side = 0; side < 2; side++)
+                for (size_t i = 0; i < degs[side]; i++) {
+                    uint32_t x = lists[side][i];
+                    if (dist[x] < 0) {
+                        dist[x] = dist[u] + 1;
+                        ecc = dist[x];
+                        order[tail++] = x;
+                    }
+                }
+        }
+        uint64_t vd = tail - seen;
+        if (t->undirected && 2 * (uint64_t)ecc + 1 < vd)
+            vd = 2 * (uint64_t)ecc + 1;
+        if (vd > bound)
+            bound = (uint32_t)vd;
+        seen = tail;
+    }
+    for (size_t u = 0; u < t->n; u++)
+        dist[u] = -1;
+    return bound;
+}
+
+/* Side 0 searches along out-edges, side 1 along in-edges; `back` flips. */
+static inline size_t side_list(const Topo *t, int k, bool back, uint32_t u, const uint32_t **list)
+{
+    return (k ^ back) ? in_list(t, u, list) : out_list(t, u, list);
+}
+
+static void side_start(Side *sd, uint32_t origin)
+{
+    sd->dist[origin] = 0;
+    sd->sigma[origin] = 1.0;
+    sd->order[0] = origin;
+    sd->level_begin = 0;
+    sd->visited = 1;
+    sd->level = 0;
+}
+
+static void side_expand(const Topo *t, Side *sd, int k)
+{
+    size_t end = sd->visited;
+    for (size_t i = sd->level_begin; i < end; i++) {
+        uint32_t u = sd->order[i];
+        const uint32_t *nb;
+        size_t deg = side_list(t, k, false, u, &nb);
+        for (size_t j = 0; j < deg; j++) {
+            uint32_t x = nb[j];
+            if (sd->dist[x] < 0) {
+                sd->dist[x] = sd->level + 1;
+                sd->sigma[x] = 0.0;
+                sd->order[sd->visited++] = x;
+            }
+            if (sd->dist[x] == sd->level + 1)
+                sd->sigma[x] += sd->sigma[u];
+        }
+    }
+    sd->level_begin = end;
+    sd->level++;
+}
+
+static inline double uniform01(uint64_t *rng)
+{
+    return (double)(splitmix64(rng) >> 11) * 0x1.0p-53;
+}
+
+/* Walk from x back to side k's origin along a uniformly random shortest
+ * path, crediting the nodes strictly between. */
+static void credit_walk(const Topo *t, const Side *sd, int k, uint32_t x,
+                        uint32_t *hits, uint64_t *rng)
+{
+    while (sd->dist[x] > 1) {
+        const uint32_t *nb;
+        size_t deg = side_list(t, k, true, x, &nb);
+        double r = uniform01(rng) * sd->sigma[x];
+        uint32_t chosen = x;
+        for (size_t i = 0; i < deg; i++) {
+            uint32_t y = nb[i];
+            if (sd->dist[y] != sd->dist[x] - 1)
+                continue;
+            chosen = y;
+            r -= sd->sigma[y];
+            if (r < 0)
+                break;
+        }
+        x = chosen;
+        hits[x]++;
+    }
+}
+
+/*
+ * Sample one shortest s-t path by balanced bidirectional BFS: grow the
+ * smaller frontier a level at a time until the searches meet.  Every
+ * shortest path crosses the new level exactly once, at a node x reached
+ * by the other side at minimal depth, so x is drawn with probability
+ * sigma_s(x) * sigma_t(x) / sigma_st and the path completed from both ends.
+ */
+static void sample_path(const Topo *t, PairWork *w, uint32_t s, uint32_t d, uint64_t *rng)
+{
+    side_start(&w->side[0], s);
+    side_start(&w->side[1], d);
+
+    for (;;) {
+        size_t f0 = w->side[0].visited - w->side[0].level_begin;
+        size_t f1 = w->side[1].visited - w->side[1].level_begin;
+        if (!f0 || !f1)
+            break;                          /* d unreachable from s */
+        int k = f0 <= f1 ? 0 : 1;
+        Side *e = &w->side[k], *o = &w->side[!k];
+        side_expand(t, e, k);
+
+        int32_t best = INT32_MAX;
+        double total = 0.0;
+        for (size_t i = e->level_begin; i < e->visited; i++) {
+            int32_t od = o->dist[e->order[i]];
+            if (od < 0 || od > best)
+                continue;
+            double paths = e->sigma[e->order[i]] * o->sigma[e->order[i]];
+            total = od < best ? paths : total + paths;
+            best = od;
+        }
+        if (best == INT32_MAX)
+            continue;
+
+        double r = uniform01(rng) * total;
+        uint32_t x = UINT32_MAX;
+        for (size_t i = e->level_begin; i < e->visited; i++) {
+            uint32_t y = e->order[i];
+            if (o->dist[y] != best)
+                continue;
+            x = y;
+            r -= e->sigma[y] * o->sigma[y];
+            if (r < 0)
+                break;
+        }
+        if (x != s && x != d)
+            w->hits[x]++;
+        credit_walk(t, e, k, x, w->hits, rng);
+        credit_walk(t, o, !k, x, w->hits, rng);
+        break;
+    }
+
+    for (int k = 0; k < 2; k++)
+        for (size_t i = 0; i < w->side[k].visited; i++)
+            w->side[k].dist[w->side[k].order[i]] = -1;
+}
+
+typedef struct {
+    const Topo *t;
+    PairWork   *works;
+    uint64_t    seed;
+} SampleCtx;
+
+static void sample_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    SampleCtx *c = ctx;
+    const Topo *t = c->t;
+    uint64_t rng = c->seed ^ ((uint64_t)(begin / SAMPLE_CHUNK) * 0xD1B54A32D192ED03ull);
+
+    for (size_t k = begin; k < end; k++) {
+        uint32_t s = (uint32_t)(splitmix64(&rng) % t->n);
+        uint32_t d = (uint32_t)(splitmix64(&rng) % (t->n - 1));
+        if (d >= s)
+            d++;
+        sample_path(t, &c->works[worker], s, d, &rng);
+    }
+}
+
+static double rk_log_terms(uint32_t vd, double delta)
+{
+    return floor(log2((double)(vd - 2))) + 1.0 + log(1.0 / delta);
+}
+
+bool ct_betweenness_sample(const GSView *v, double epsilon, double delta,
+                           uint64_t seed, uint64_t max_samples, unsigned flags,
+                           unsigned threads, double *out, CTStats *stats)
+{
+    if (!(epsilon > 0.0) || !(delta > 0.0 && delta < 1.0))
+        return false;
+    Topo t;
+    if (!topo_open(v, flags, threads, &t))
+        return false;
+
+    PairWork works[MAX_THREADS];
+    bool ok = pair_works_init(works, 1, t.n);
+    if (!ok)
+        goto out;
+
+    /* Paths with fewer than three nodes have no interior to credit. */
+    uint32_t vd = vertex_diameter(&t, works[0].side[0].dist, works[0].side[0].order);
+    uint64_t samples = 0;
+    if (vd > 2) {
+        samples = (uint64_t)ceil(RK_C / (epsilon * epsilon) * rk_log_terms(vd, delta));
+        if (max_samples && samples > max_samples) {
+            samples = max_samples;
+            epsilon = sqrt(RK_C * rk_log_terms(vd, delta) / (double)samples);
+        }
+    }
+
+    threads = thread_count(threads, (samples + SAMPLE_CHUNK - 1) / SAMPLE_CHUNK);
+    ok = pair_works_init(works + 1, threads - 1, t.n);
+    if (!ok) {
+        pair_work_free(&works[0]);
+        goto out;
+    }
+    SampleCtx c = { &t, works, seed };
+    parallel_ranges(samples, SAMPLE_CHUNK, threads, sample_pass, &c);
+
+    /* Each sample adds 1 / samples to the normalised (by n(n-1)) estimate
+     * of the nodes it credits; scale back to the raw ordered-pair sum. */
+    double scale = samples ? (double)t.n * (double)(t.n - 1) / (double)samples : 0.0;
+    for (size_t u = 0; u < t.n; u++) {
+        uint64_t h = 0;
+        for (unsigned k = 0; k < threads; k++)
+            h += works[k].hits[u];
+        out[u] = (double)h * scale;
+    }
+    for (unsigned k = 0; k < threads; k++)
+        pair_work_free(&works[k]);
+    if (stats)
+        *stats = (CTStats){
+            .samples = samples, .vertex_diameter = vd,
+            .epsilon = samples ? epsilon : 0.0, .threads = threads,
+        };
+
+out:
+    topo_free(&t);
+    return ok;
+}
+
+/* -------------------------------------------------------------------------
+ * Harmonic closeness (multi-source BFS)
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const Topo     *t;
+    const uint32_t *targets;    /* NULL = 0 .. n - 1 */
+    size_t          n_targets;
+    uint64_t      **seen, **frontier, **next;   /* per thread, n words each */
+    double         *out;
+} HarmonicCtx;
+
+static void harmonic_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    HarmonicCtx *c = ctx;
+    const Topo *t = c->t;
+    uint64_t *seen = c->seen[worker], *frontier = c->frontier[worker], *next = c->next[worker];
+    size_t n = t->n;
+
+    for (size_t batch = begin; batch < end; batch++) {
+        size_t first = batch * 64;
+        size_t count = c->n_targets - first < 64 ? c->n_targets - first : 64;
+        uint32_t ids[64];
+        double sum[64] = { 0 };
+        bool active = false;
+
+        memset(seen, 0, n * sizeof *seen);
+        memset(frontier, 0, n * sizeof *frontier);
+        for (size_t b = 0; b < count; b++) {
+            ids[b] = c->targets ? c->targets[first + b] : (uint32_t)(first + b);
+            if (ids[b] < n) {
+                seen[ids[b]] |= 1ull << b;
+                frontier[ids[b]] |= 1ull << b;
+                active = true;
+            }
+        }
+
+        /* Level d: nodes first reached now are at distance d from (i.e.
+         * reach) the targets whose bits they gain; search runs along
+         * in-edges so distances point towards the targets. */
+        for (double d = 1.0; active; d += 1.0) {
+            memset(next, 0, n * sizeof *next);
+            for (size_t x = 0; x < n; x++) {
+                uint64_t bits = frontier[x];
+                if (!bits)
+                    continue;
+                const uint32_t *nb;
+                size_t deg = in_list(t, (uint32_t)x, &nb);
+                for (size_t i = 0; i < deg; i++)
+                    next[nb[i]] |= bits;
+            }
+            active = false;
+            for (size_t y = 0; y < n; y++) {
+                uint64_t fresh = next[y] & ~seen[y];
+                frontier[y] = fresh;
+                if (!fresh)
+                    continue;
+                seen[y] |= fresh;
+                active = true;
+                while (fresh) {
+                    sum[__builtin_ctzll(fresh)] += 1.0 / d;
+                    fresh &= fresh - 1;
+                }
+            }
+        }
+        for (size_t b = 0; b < count; b++)
+            if (ids[b] < n)
+                c->out[ids[b]] = sum[b];
+    }
+}
+
+bool ct_harmonic(const GSView *v, const uint32_t *targets, size_t n_targets,
+                 unsigned flags, unsigned threads, double *out)
+{
+    Topo t;
+    if (!topo_open(v, flags, threads, &t))
+        return false;
+    if (!targets)
+        n_targets = t.n;
+    size_t batches = (n_targets + 63) / 64;
+    threads = thread_count(threads, batches);
+
+    uint64_t *seen[MAX_THREADS] = { 0 }, *frontier[MAX_THREADS] = { 0 }, *next[MAX_THREADS] = { 0 };
+    size_t words = t.n ? t.n : 1;
+    bool ok = true;
+    for (unsigned k = 0; k < threads && ok; k++) {
+        seen[k] = malloc(words * sizeof **seen);
+        frontier[k] = malloc(words * sizeof **frontier);
+        next[k] = malloc(words * sizeof **next);
+        ok = seen[k] && frontier[k] && next[k];
+    }
+    if (ok) {
+        HarmonicCtx c = { &t, targets, n_targets, seen, frontier, next, out };
+        parallel_ranges(batches, 1, threads, harmonic_pass, &c);
+    }
+    for (unsigned k = 0; k < threads; k++) {
+        free(seen[k]);
+        free(frontier[k]);
+        free(next[k]);
+    }
+    topo_free(&t);
+    return ok;
+}
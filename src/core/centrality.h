@@ -0,0 +1,85 @@
+/**
+ * centrality.h — Betweenness and harmonic closeness centrality
+ *
+ * Shortest paths are unweighted (edge weights are ignored) and follow edge
+ * direction unless CT_UNDIRECTED is given.  Views must track in-adjacency
+ * (GS_TRACK_IN).  Results are written to caller arrays indexed by node ID
+ * that hold gs_view_node_count(v) entries.
+ *
+ * Betweenness:
+ *   Raw values: the sum over ordered pairs (s, t) of the fraction of
+ *   shortest s-t paths passing through the node.  Divide by (n-1)(n-2) to
+ *   normalise (for directed and undirected graphs alike, since an
+ *   undirected pair is counted once per order).
+ *
+ *   ct_betweenness runs Brandes' algorithm from every source (or a given
+ *   subset), threads taking sources in chunks with private dependency
+ *   accumulators that are summed at the end.
+ *
+ *   ct_betweenness_sample follows Riondato and Kornaropoulos: it samples
+ *   node pairs, picks one shortest path between each uniformly at random
+ *   and credits its interior nodes.  The sample size follows from a
+ *   bound on the vertex diameter, and with probability 1 - delta every
+ *   normalised (by n(n-1)) estimate is within epsilon of the true value.
+ *   Paths are found by balanced bidirectional BFS, which on small-world
+ *   graphs touches far fewer nodes than a search from one end.
+ *
+ * Harmonic closeness:
+ *   The sum of 1 / d(u, x) over nodes u that reach x (incoming distances,
+ *   as in networkx).  ct_harmonic runs one BFS per 64 targets, each node
+ *   carrying a 64-bit word of "reached by target i" bits per frontier.
+ */
+
+#ifndef CENTRALITY_H
+#define CENTRALITY_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "graph_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CT_UNDIRECTED 0x1      /* ignore edge directions */
+
+typedef struct {
+    uint64_t samples;          /* sources run (exact) or node pairs sampled */
+    uint32_t vertex_diameter;  /* bound used to size the sample (sampling)  */
+    double   epsilon;          /* error bound on n(n-1)-normalised values;
+                                  0 for exact results                       */
+    unsigned threads;
+} CTStats;
+
+/**
+ * Exact (sources NULL) or source-restricted betweenness.  With a subset
+ * of k sources, scale by n / k for an unbiased estimate.  threads 0 = one
+ * per online CPU.  Returns false if the view lacks in-adjacency or memory
+ * runs out.
+ */
+bool ct_betweenness(const GSView *v, const uint32_t *sources, size_t n_sources,
+                    unsigned flags, unsigned threads, double *out, CTStats *stats);
+
+/**
+ * Approximate betweenness (raw scale) from sampled shortest paths.
+ * max_samples > 0 caps the sample size; stats->epsilon then reports the
+ * weaker bound actually achieved.  Results depend only on the seed.
+ */
+bool ct_betweenness_sample(const GSView *v, double epsilon, double delta,
+                           uint64_t seed, uint64_t max_samples, unsigned flags,
+                           unsigned threads, double *out, CTStats *stats);
+
+/**
+ * Harmonic closeness of the given targets (NULL = every node); entries of
+ * other nodes are left untouched.
+ */
+bool ct_harmonic(const GSView *v, const uint32_t *targets, size_t n_targets,
+                 unsigned flags, unsigned threads, double *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CENTRALITY_H */
@@ -0,0 +1,629 @@
+/**
+ * coarsen.c — Multilevel graph coarsening for level-of-detail views
+ *
+ * Every level is a weighted undirected CSR (off[u] .. off[u + 1] indexes
+ * u's sorted neighbours in adj, with weights in w) plus per-node cluster
+ * bookkeeping.  Contraction gathers each cluster's members through the
+ * child lists and merges their adjacency with a position table, so a
+ * level costs time linear in its edges (plus sorting the merged lists).
+ */
+
+#include "coarsen.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define MAX_LEVELS 64
+
+typedef struct {
+    size_t    n;
+    size_t   *off;              /* n + 1 */
+    uint32_t *adj;
+    double   *w;
+    uint32_t *size;             /* level-0 nodes inside */
+    uint32_t *rep;              /* representative level-0 node */
+    uint32_t *rep_deg;          /* its level-0 degree */
+    uint32_t *parent;           /* cluster at the next level, or CH_NONE */
+    size_t   *child_off;        /* level >= 1: members at the level below */
+    uint32_t *children;
+} Level;
+
+struct CHierarchy {
+    size_t n_levels;
+    Level  levels[MAX_LEVELS];
+};
+
+typedef struct {
+    uint32_t id;
+    double   w;
+} Adj;
+
+static void level_free(Level *l)
+{
+    free(l->off);
+    free(l->adj);
+    free(l->w);
+    free(l->size);
+    free(l->rep);
+    free(l->rep_deg);
+    free(l->parent);
+    free(l->child_off);
+    free(l->children);
+    memset(l, 0, sizeof *l);
+}
+
+/* Per-node arrays (adjacency and children are allocated by the builders). */
+static bool level_alloc(Level *l, size_t n)
+{
+    size_t m = n ? n : 1;
+    memset(l, 0, sizeof *l);
+    l->n = n;
+    l->off = calloc(n + 1, sizeof *l->off);
+    l->size = calloc(m, sizeof *l->size);
+    l->rep = malloc(m * sizeof *l->rep);
+    l->rep_deg = calloc(m, sizeof *l->rep_deg);
+    l->parent = malloc(m * sizeof *l->parent);
+    if (!l->off || !l->size || !l->rep || !l->rep_deg || !l->parent) {
+        level_free(l);
+        return false;
+    }
+    for (size_t u = 0; u < n; u++)
+        l->parent[u] = CH_NONE;
+    return true;
+}
+
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static int adj_cmp(const void *a, const void *b)
+{
+    uint32_t x = ((const Adj *)a)->id, y = ((const Adj *)b)->id;
+    return (x > y) - (x < y);
+}
+
+/* Merged lists are mostly short: insertion sort them, qsort the rest. */
+static void adj_sort(Adj *a, size_t n)
+{
+    if (n > 24) {
+        qsort(a, n, sizeof *a, adj_cmp);
+        return;
+    }
+    for (size_t i = 1; i < n; i++) {
+        Adj x = a[i];
+        size_t j = i;
+        for (; j > 0 && a[j - 1].id > x.id; j--)
+            a[j] = a[j - 1];
+        a[j] = x;
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Level 0
+ * ---------------------------------------------------------------------- */
+
+/* Union of out- and in-neighbours without u, weights of both directions
+ * summed; counts only if ids is NULL. */
+static size_t merged_neighbors(const GSView *v, uint32_t u, uint32_t *ids, double *w)
+{
+    const uint32_t *a = NULL, *b = NULL;
+    const float *wa = NULL, *wb = NULL;
+    size_t na = gs_view_neighbors(v, u, &a, &wa);
+    size_t nb = gs_view_in_neighbors(v, u, &b, &wb);
+    size_t i = 0, j = 0, n = 0;
+    while (i < na || j < nb) {
+        uint32_t x;
+        double weight;
+        if (j == nb || (i < na && a[i] < b[j])) {
+            x = a[i];
+            weight = wa[i++];
+        } else if (i == na || b[j] < a[i]) {
+            x = b[j];
+            weight = wb[j++];
+        } else {
+            x = a[i];
+            weight = (double)wa[i++] + wb[j++];
+        }
+        if (x == u)
+            continue;
+        if (ids) {
+            ids[n] = x;
+            w[n] = weight;
+        }
+        n++;
+    }
+    return n;
+}
+
+static bool build_base(const GSView *v, Level *l)
+{
+    size_t n = gs_view_node_count(v);
+    if (!level_alloc(l, n))
+        return false;
+    for (size_t u = 0; u < n; u++)
+        l->off[u + 1] = l->off[u] + merged_neighbors(v, (uint32_t)u, NULL, NULL);
+    size_t m = l->off[n] ? l->off[n] : 1;
+    l->adj = malloc(m * sizeof *l->adj);
+    l->w = malloc(m * sizeof *l->w);
+    if (!l->adj || !l->w) {
+        level_free(l);
+        return false;
+    }
+    for (size_t u = 0; u < n; u++) {
+        size_t deg = merged_neighbors(v, (uint32_t)u, l->adj + l->off[u], l->w + l->off[u]);
+        l->size[u] = deg > 0;
+        l->rep[u] = (uint32_t)u;
+        l->rep_deg[u] = deg > UINT32_MAX ? UINT32_MAX : (uint32_t)deg;
+    }
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Contraction
+ * ---------------------------------------------------------------------- */
+
+/*
+ * Assign every active node of `fine` a cluster leader (leader[u] == u for
+ * leaders).  Returns the number of clusters.
+ */
+static size_t match(const Level *fine, uint64_t *rng, uint32_t *leader,
+                    uint32_t *members, double *csize, uint32_t *order, uint32_t *stranded)
+{
+    size_t n = fine->n, active = 0, clusters = 0;
+    uint32_t pending = CH_NONE;
+
+    for (size_t u = 0; u < n; u++) {
+        leader[u] = CH_NONE;
+        stranded[u] = CH_NONE;
+        if (fine->size[u])
+            order[active++] = (uint32_t)u;
+    }
+    for (size_t i = active; i > 1; i--) {
+        size_t j = splitmix64(rng) % i;
+        uint32_t t = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = t;
+    }
+
+    for (size_t k = 0; k < active; k++) {
+        uint32_t u = order[k];
+        if (leader[u] != CH_NONE)
+            continue;
+        size_t begin = fine->off[u], end = fine->off[u + 1];
+
+        if (begin == end) {
+            /* No neighbours left at this level: pair with another such node. */
+            if (pending == CH_NONE) {
+                pending = u;
+            } else {
+                leader[pending] = leader[u] = pending;
+                members[pending] = 2;
+                pending = CH_NONE;
+                clusters++;
+            }
+            continue;
+        }
+
+        uint32_t best = CH_NONE;
+        double best_score = -1.0;
+        for (size_t i = begin; i < end; i++) {
+            uint32_t x = fine->adj[i];
+            if (leader[x] != CH_NONE)
+                continue;
+            double score = fine->w[i] / ((double)fine->size[u] * fine->size[x]);
+            if (score > best_score) {
+                best_score = score;
+                best = x;
+            }
+        }
+        if (best != CH_NONE) {
+            leader[u] = leader[best] = u;
+            members[u] = 2;
+            csize[u] = (double)fine->size[u] + fine->size[best];
+            clusters++;
+            continue;
+        }
+
+        /* Every neighbour is taken: join the heaviest cluster with room. */
+        uint32_t heaviest = CH_NONE;
+        double heaviest_w = -1.0;
+        for (size_t i = begin; i < end; i++) {
+            uint32_t c = leader[fine->adj[i]];
+            if (fine->w[i] > heaviest_w) {
+                heaviest_w = fine->w[i];
+                heaviest = c;
+            }
+            if (members[c] >= CH_MAX_GROUP)
+                continue;
+            double score = fine->w[i] / ((double)fine->size[u] * csize[c]);
+            if (score > best_score) {
+                best_score = score;
+                best = c;
+            }
+        }
+        if (best == CH_NONE) {
+            /* Neighbouring clusters are full (u hangs off a hub): group u
+             * with other nodes stranded next to the same cluster. */
+            uint32_t g = stranded[heaviest];
+            if (g != CH_NONE && members[g] < CH_MAX_GROUP)
+                best = g;
+        }
+        if (best != CH_NONE) {
+            leader[u] = best;
+            members[best]++;
+            csize[best] += fine->size[u];
+        } else {
+            leader[u] = u;
+            members[u] = 1;
+            csize[u] = fine->size[u];
+            stranded[heaviest] = u;
+            clusters++;
+        }
+    }
+    if (pending != CH_NONE) {
+        leader[pending] = pending;
+        clusters++;
+    }
+    return clusters;
+}
+
+static bool contract(Level *fine, Level *coarse, uint64_t *rng)
+{
+    size_t n = fine->n, m = n ? n : 1;
+    uint32_t *leader = malloc(m * sizeof *leader);
+    uint32_t *members = malloc(m * sizeof *members);
+    double   *csize = malloc(m * sizeof *csize);
+    uint32_t *order = malloc(m * sizeof *order);
+    uint32_t *stranded = malloc(m * sizeof *stranded);
+    uint32_t *pos = NULL;
+    Adj      *buf = NULL;
+    bool ok = false;
+
+    memset(coarse, 0, sizeof *coarse);
+    if (!leader || !members || !csize || !order || !stranded)
+        goto out;
+    size_t nc = match(fine, rng, leader, members, csize, order, stranded);
+    if (!level_alloc(coarse, nc))
+        goto out;
+
+    /* Number clusters by leader ID, then map every member. */
+    size_t next = 0;
+    for (size_t u = 0; u < n; u++)
+        if (leader[u] == u)
+            order[u] = (uint32_t)next++;
+    for (size_t u = 0; u < n; u++) {
+        if (leader[u] == CH_NONE)
+            continue;
+        uint32_t c = order[leader[u]];
+        fine->parent[u] = c;
+        coarse->size[c] += fine->size[u];
+        if (coarse->size[c] == fine->size[u] || fine->rep_deg[u] > coarse->rep_deg[c]
+                || (fine->rep_deg[u] == coarse->rep_deg[c] && fine->rep[u] < coarse->rep[c])) {
+            coarse->rep[c] = fine->rep[u];
+            coarse->rep_deg[c] = fine->rep_deg[u];
+        }
+    }
+
+    /* Child lists: counting sort of parents (members stay in ID order). */
+    coarse->child_off = calloc(nc + 1, sizeof *coarse->child_off);
+    coarse->children = malloc(m * sizeof *coarse->children);
+    if (!coarse->child_off || !coarse->children)
+        goto out;
+    for (size_t u = 0; u < n; u++)
+        if (fine->parent[u] != CH_NONE)
+            coarse->child_off[fine->parent[u] + 1]++;
+    for (size_t c = 0; c < nc; c++)
+        coarse->child_off[c + 1] += coarse->child_off[c];
+    for (size_t c = 0; c < nc; c++)
+        order[c] = (uint32_t)coarse->child_off[c];          /* fill cursors */
+    for (size_t u = 0; u < n; u++)
+        if (fine->parent[u] != CH_NONE)
+            coarse->children[order[fine->parent[u]]++] = (uint32_t)u;
+
+    /* Adjacency: merge members' lists, summing weights per cluster. */
+    size_t cap = fine->off[n] ? fine->off[n] : 1;
+    coarse->adj = malloc(cap * sizeof *coarse->adj);
+    coarse->w = malloc(cap * sizeof *coarse->w);
+    pos = malloc((nc ? nc : 1) * sizeof *pos);
+    buf = malloc(cap * sizeof *buf);
+    if (!coarse->adj || !coarse->w || !pos || !buf)
+        goto out;
+    for (size_t c = 0; c < nc; c++)
+        pos[c] = CH_NONE;
+
+    size_t total = 0;
+    for (size_t c = 0; c < nc; c++) {
+        size_t cnt = 0;
+        for (size_t k = coarse->child_off[c]; k < coarse->child_off[c + 1]; k++) {
+            uint32_t u = coarse->children[k];
+            for (size_t i = fine->off[u]; i < fine->off[u + 1]; i++) {
+                uint32_t pc = fine->parent[fine->adj[i]];
+                if (pc == c)
+                    continue;
+                if (pos[pc] == CH_NONE) {
+                    pos[pc] = (uint32_t)cnt;
+                    buf[cnt++] = (Adj){ pc, 0.0 };
+                }
+                buf[pos[pc]].w += fine->w[i];
+            }
+        }
+        adj_sort(buf, cnt);
+        for (size_t i = 0; i < cnt; i++) {
+            coarse->adj[total + i] = buf[i].id;
+            coarse->w[total + i] = buf[i].w;
+            pos[buf[i].id] = CH_NONE;
+        }
+        total += cnt;
+        coarse->off[c + 1] = total;
+    }
+    ok = true;
+
+out:
+    free(leader);
+    free(members);
+    free(csize);
+    free(order);
+    free(stranded);
+    free(pos);
+    free(buf);
+    if (!ok) {
+        level_free(coarse);
+        for (size_t u = 0; u < n; u++)
+            fine->parent[u] = CH_NONE;
+    }
+    return ok;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+CHierarchy *ch_build(const GSView *v, size_t min_nodes, uint64_t seed)
+{
+    if (!gs_view_tracks_in(v))
+        return NULL;
+    CHierarchy *h = calloc(1, sizeof *h);
+    if (!h)
+        return NULL;
+    if (!build_base(v, &h->levels[0])) {
+        free(h);
+        return NULL;
+    }
+    h->n_levels = 1;
+
+    size_t active = 0;
+    for (size_t u = 0; u < h->levels[0].n; u++)
+        active += h->levels[0].size[u] > 0;
+    uint64_t rng = seed;
+
+    while (h->n_levels < MAX_LEVELS && active > min_nodes && active > 1) {
+        Level *fine = &h->levels[h->n_levels - 1], *coarse = &h->levels[h->n_levels];
+        if (!contract(fine, coarse, &rng)) {
+            ch_free(h);
+            return NULL;
+        }
+        if (coarse->n >= active) {
+            /* No progress: drop the level and stop. */
+            level_free(coarse);
+            for (size_t u = 0; u < fine->n; u++)
+                fine->parent[u] = CH_NONE;
+            break;
+        }
+        active = coarse->n;
+        h->n_levels++;
+    }
+    return h;
+}
+
+void ch_free(CHierarchy *h)
+{
+    if (!h)
+        return;
+    for (size_t l = 0; l < h->n_levels; l++)
+        level_free(&h->levels[l]);
+    free(h);
+}
+
+size_t ch_levels(const CHierarchy *h)
+{
+    return h ? h->n_levels : 0;
+}
+
+static const Level *level_at(const CHierarchy *h, size_t level)
+{
+    return h && level < h->n_levels ? &h->levels[level] : NULL;
+}
+
+size_t ch_level_size(const CHierarchy *h, size_t level)
+{
+    const Level *l = level_at(h, level);
+    return l ? l->n : 0;
+}
+
+const uint32_t *ch_parents(const CHierarchy *h, size_t level)
+{
+    const Level *l = level_at(h, level);
+    return l ? l->parent : NULL;
+}
+
+const uint32_t *ch_sizes(const CHierarchy *h, size_t level)
+{
+    const Level *l = level_at(h, level);
+    return l ? l->size : NULL;
+}
+
+const uint32_t *ch_reps(const CHierarchy *h, size_t level)
+{
+    const Level *l = level_at(h, level);
+    return l ? l->rep : NULL;
+}
+
+size_t ch_children(const CHierarchy *h, size_t level, uint32_t node, const uint32_t **ids)
+{
+    const Level *l = level_at(h, level);
+    if (!l || level == 0 || node >= l->n) {
+        *ids = NULL;
+        return 0;
+    }
+    *ids = l->children + l->child_off[node];
+    return l->child_off[node + 1] - l->child_off[node];
+}
+
+size_t ch_neighbors(const CHierarchy *h, size_t level, uint32_t node,
+                    const uint32_t **ids, const double **weights)
+{
+    const Level *l = level_at(h, level);
+    if (!l || node >= l->n) {
+        if (ids)
+            *ids = NULL;
+        if (weights)
+            *weights = NULL;
+        return 0;
+    }
+    if (ids)
+        *ids = l->adj + l->off[node];
+    if (weights)
+        *weights = l->w + l->off[node];
+    return l->off[node + 1] - l->off[node];
+}
+
+bool ch_distances(const CHierarchy *h, size_t level, uint32_t source,
+                  uint32_t max_hops, uint32_t *dist)
+{
+    const Level *l = level_at(h, level);
+    if (!l || source >= l->n)
+        return false;
+    uint32_t *queue = malloc(l->n * sizeof *queue);
+    if (!queue)
+        return false;
+    for (size_t u = 0; u < l->n; u++)
+        dist[u] = CH_NONE;
+
+    size_t head = 0, tail = 1;
+    queue[0] = source;
+    dist[source] = 0;
+    while (head < tail) {
+        uint32_t u = queue[head++];
+        if (dist[u] >= max_hops)
+            continue;
+        for (size_t i = l->off[u]; i < l->off[u + 1]; i++) {
+            uint32_t x = l->adj[i];
+            if (dist[x] == CH_NONE) {
+                dist[x] = dist[u] + 1;
+                queue[tail++] = x;
+            }
+        }
+    }
+    free(queue);
+    return true;
+}
+
+bool ch_lift_min(const CHierarchy *h, size_t level, const uint32_t *below, uint32_t *out)
+{
+    const Level *l = level_at(h, level);
+    if (!l || level == 0)
+        return false;
+    for (size_t c = 0; c < l->n; c++) {
+        uint32_t best = CH_NONE;
+        for (size_t i = l->child_off[c]; i < l->child_off[c + 1]; i++)
+            if (below[l->children[i]] < best)
+                best = below[l->children[i]];
+        out[c] = best;
+    }
+    return true;
+}
+
+int64_t ch_cut_edges(const CHierarchy *h, const uint32_t *levels, const uint32_t *ids,
+                     size_t n_items, uint32_t *out_a, uint32_t *out_b, double *out_w,
+                     size_t capacity)
+{
+    if (!h || n_items >= CH_NONE)
+        return -1;
+    uint32_t *owner[MAX_LEVELS] = { 0 };
+    size_t    m = n_items ? n_items : 1;
+    double   *acc = malloc(m * sizeof *acc);
+    uint32_t *slot = malloc(m * sizeof *slot);      /* item -> touched index */
+    uint32_t *touched = malloc(m * sizeof *touched);
+    int64_t total = -1;
+
+    if (!acc || !slot || !touched)
+        goto out;
+    for (size_t i = 0; i < n_items; i++)
+        slot[i] = CH_NONE;
+    for (size_t l = 0; l < h->n_levels; l++) {
+        owner[l] = malloc((h->levels[l].n ? h->levels[l].n : 1) * sizeof **owner);
+        if (!owner[l])
+            goto out;
+        for (size_t u = 0; u < h->levels[l].n; u++)
+            owner[l][u] = CH_NONE;
+    }
+
+    /* Mark items, then push ownership down to their descendants. */
+    for (size_t i = 0; i < n_items; i++) {
+        if (levels[i] >= h->n_levels || ids[i] >= h->levels[levels[i]].n
+                || owner[levels[i]][ids[i]] != CH_NONE)
+            goto out;
+        owner[levels[i]][ids[i]] = (uint32_t)i;
+    }
+    for (size_t l = h->n_levels - 1; l-- > 0;) {
+        const Level *lv = &h->levels[l];
+        for (size_t u = 0; u < lv->n; u++) {
+            uint32_t p = lv->parent[u];
+            if (p == CH_NONE || owner[l + 1][p] == CH_NONE)
+                continue;
+            if (owner[l][u] != CH_NONE)
+                goto out;                   /* item inside another item */
+            owner[l][u] = owner[l + 1][p];
+        }
+    }
+
+    /*
+     * Each pair is counted from its finer item (at equal levels, from the
+     * lower index): its neighbours at its own level are either items,
+     * inside items, or ancestors of finer items, which count the edge
+     * themselves.
+     */
+    total = 0;
+    for (size_t i = 0; i < n_items; i++) {
+        const Level *lv = &h->levels[levels[i]];
+        uint32_t u = ids[i];
+        size_t n_touched = 0;
+        for (size_t k = lv->off[u]; k < lv->off[u + 1]; k++) {
+            uint32_t b = owner[levels[i]][lv->adj[k]];
+            if (b == CH_NONE || b == i || (levels[b] == levels[i] && b < i))
+                continue;
+            if (slot[b] == CH_NONE) {
+                slot[b] = (uint32_t)n_touched;
+                touched[n_touched++] = b;
+                acc[b] = 0.0;
+            }
+            acc[b] += lv->w[k];
+        }
+        for (size_t k = 0; k < n_touched; k++) {
+            uint32_t b = touched[k];
+            if ((size_t)total < capacity) {
+                out_a[total] = (uint32_t)(i < b ? i : b);
+                out_b[total] = (uint32_t)(i < b ? b : i);
+                out_w[total] = acc[b];
+            }
+            total++;
+            slot[b] = CH_NONE;
+        }
+    }
+
+out:
+    for (size_t l = 0; l < MAX_LEVELS; l++)
+        free(owner[l]);
+    free(acc);
+    free(slot);
+    free(touched);
+    return total;
+}
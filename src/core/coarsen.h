@@ -0,0 +1,104 @@
+/**
+ * coarsen.h — Multilevel graph coarsening for level-of-detail views
+ *
+ * ch_build contracts the undirected graph underlying a graph_store view
+ * into a hierarchy of ever smaller super-graphs.  Level 0 is the view
+ * itself (node IDs are view IDs); each node of level l + 1 is a cluster of
+ * level-l nodes, and its edges carry the summed weight of the level-0
+ * edges between the clusters.
+ *
+ * Each level is built by heavy-edge matching: nodes, visited in a seeded
+ * random order, pair with the unmatched neighbour of heaviest edge weight
+ * per unit of combined size.  A node whose neighbours are all taken joins
+ * the heaviest neighbouring cluster (up to CH_MAX_GROUP members) or, when
+ * those are full, a group of nodes stranded next to the same cluster.
+ * This keeps stars and other hub structures shrinking geometrically.
+ * Nodes left without neighbours (fully contracted components) are grouped
+ * pairwise.
+ * Coarsening stops at min_nodes nodes or when a level no longer shrinks.
+ *
+ * Level-0 nodes without edges (never linked, or deleted) take no part:
+ * their parent is CH_NONE.  The hierarchy owns copies of everything it
+ * needs, so the view may be released once ch_build returns.
+ */
+
+#ifndef COARSEN_H
+#define COARSEN_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "graph_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CH_NONE      UINT32_MAX
+#define CH_MAX_GROUP 8          /* members one cluster may absorb per level */
+
+typedef struct CHierarchy CHierarchy;
+
+/**
+ * Build the hierarchy (min_nodes 0 = coarsen as far as possible).
+ * Returns NULL if the view lacks in-adjacency or memory runs out.
+ */
+CHierarchy *ch_build(const GSView *v, size_t min_nodes, uint64_t seed);
+
+void ch_free(CHierarchy *h);
+
+/** Number of levels, including level 0. */
+size_t ch_levels(const CHierarchy *h);
+
+/** Nodes at a level (0 for levels out of range). */
+size_t ch_level_size(const CHierarchy *h, size_t level);
+
+/**
+ * Per-node arrays of a level, ch_level_size entries each, or NULL for
+ * levels out of range:
+ *   parents: cluster at level + 1 (CH_NONE at the top or if excluded)
+ *   sizes:   level-0 nodes inside (0 for excluded level-0 nodes)
+ *   reps:    representative level-0 node (the one of highest degree)
+ */
+const uint32_t *ch_parents(const CHierarchy *h, size_t level);
+const uint32_t *ch_sizes(const CHierarchy *h, size_t level);
+const uint32_t *ch_reps(const CHierarchy *h, size_t level);
+
+/** Level-(level - 1) members of a node at level >= 1; sorted by ID. */
+size_t ch_children(const CHierarchy *h, size_t level, uint32_t node, const uint32_t **ids);
+
+/** Neighbours of a node in the level's super-graph, sorted by ID. */
+size_t ch_neighbors(const CHierarchy *h, size_t level, uint32_t node,
+                    const uint32_t **ids, const double **weights);
+
+/**
+ * Hop distances from source in the level's super-graph, up to max_hops
+ * (CH_NONE beyond that or unreachable).  dist holds ch_level_size entries.
+ */
+bool ch_distances(const CHierarchy *h, size_t level, uint32_t source,
+                  uint32_t max_hops, uint32_t *dist);
+
+/**
+ * Minimum over each node's members of a per-node value of the level below
+ * (level >= 1).  Lifting level-0 distances level by level gives every
+ * cluster the distance of its nearest member.
+ */
+bool ch_lift_min(const CHierarchy *h, size_t level, const uint32_t *below, uint32_t *out);
+
+/**
+ * Aggregate edges between the items of a cut: item i is node ids[i] of
+ * level levels[i], and items must not contain one another.  Writes up to
+ * capacity pairs (out_a[k] < out_b[k] index items; out_w[k] is the summed
+ * level-0 edge weight) and returns the total number of pairs, or -1 for
+ * invalid or overlapping items (or lack of memory).
+ */
+int64_t ch_cut_edges(const CHierarchy *h, const uint32_t *levels, const uint32_t *ids,
+                     size_t n_items, uint32_t *out_a, uint32_t *out_b, double *out_w,
+                     size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COARSEN_H */
@@ -0,0 +1,102 @@
+/**
+ * dag.c — Levels and shape of hierarchies stored as graph_store views
+ *
+ * One scan counts every node's parents (out-edges) and children
+ * (in-edges), self-loops excluded; remaining[u] then counts the parents
+ * of u not settled yet.  Roots seed a FIFO queue, and settling a node
+ * raises each child's depth to at least one more than its own and
+ * releases the child when its last parent is settled.
+ */
+
+#include "dag.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Levels
+ * ---------------------------------------------------------------------- */
+
+bool dag_levels(const GSView *v, uint32_t *depth, DAGStats *out)
+{
+    if (!gs_view_tracks_in(v))
+        return false;
+
+    size_t n = gs_view_node_count(v);
+    uint32_t *remaining = malloc((n ? n : 1) * sizeof *remaining);
+    uint32_t *level = malloc((n ? n : 1) * sizeof *level);
+    uint32_t *queue = malloc((n ? n : 1) * sizeof *queue);
+    bool ok = false;
+    if (!remaining || !level || !queue)
+        goto out;
+
+    DAGStats s;
+    memset(&s, 0, sizeof s);
+    size_t head = 0, tail = 0;
+
+    for (uint32_t u = 0; u < n; u++) {
+        const uint32_t *nb;
+        size_t parents = 0, children = 0;
+        size_t deg = gs_view_neighbors(v, u, &nb, NULL);
+        for (size_t i = 0; i < deg; i++)
+            parents += nb[i] != u;
+        deg = gs_view_in_neighbors(v, u, &nb, NULL);
+        for (size_t i = 0; i < deg; i++)
+            children += nb[i] != u;
+
+        remaining[u] = (uint32_t)parents;
+        level[u] = 0;
+        if (parents == 0 && children == 0)
+            continue;
+        s.nodes++;
+        s.edges += parents;
+        s.multi_parent += parents > 1;
+        s.leaves += children == 0;
+        if (children > s.max_children)
+            s.max_children = (uint32_t)children;
+        if (parents == 0) {
+            s.roots++;
+            queue[tail++] = u;
+        }
+    }
+
+    while (head < tail) {
+        uint32_t u = queue[head++];
+        uint32_t below = level[u] + 1;
+        s.depth_sum += level[u];
+        if (level[u] > s.max_depth)
+            s.max_depth = level[u];
+
+        const uint32_t *nb;
+        size_t deg = gs_view_in_neighbors(v, u, &nb, NULL);
+        for (size_t i = 0; i < deg; i++) {
+            uint32_t c = nb[i];
+            if (c == u)
+                continue;
+            if (level[c] < below)
+                level[c] = below;
+            if (--remaining[c] == 0)
+                queue[tail++] = c;
+        }
+    }
+
+    /* Everything linked and unsettled hangs on a cycle */
+    for (uint32_t u = 0; u < n; u++) {
+        if (remaining[u] != 0) {
+            level[u] = DAG_CYCLIC;
+            s.cyclic++;
+        }
+    }
+
+    if (depth && n)
+        memcpy(depth, level, n * sizeof *level);
+    if (out)
+        *out = s;
+    ok = true;
+
+out:
+    free(remaining);
+    free(level);
+    free(queue);
+    return ok;
+}
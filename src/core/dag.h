@@ -0,0 +1,58 @@
+/**
+ * dag.h — Levels and shape of hierarchies stored as graph_store views
+ *
+ * A hierarchy is a layer whose edges point from child to parent, such as
+ * rdfs:subClassOf.  A node's depth is the length of its longest path up
+ * to a root (a node without parents), so with multiple inheritance a node
+ * sits one level below its deepest parent.  Self-loops are ignored.
+ *
+ * dag_levels computes every depth in one pass in topological order
+ * (Kahn's algorithm): roots start at depth 0, and a node is settled, at
+ * one more than its deepest parent, once all its parents are.  That is
+ * O(nodes + edges) however many parents nodes share, where recursing up
+ * from every node repeats the work below each shared ancestor.  Nodes on
+ * a cycle, or below one, are never settled; they are reported instead of
+ * looping forever.  The view must track in-adjacency (GS_TRACK_IN).
+ */
+
+#ifndef DAG_H
+#define DAG_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "graph_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DAG_CYCLIC UINT32_MAX   /* depth of nodes on or below a cycle */
+
+typedef struct {
+    size_t   nodes;             /* nodes with at least one edge           */
+    size_t   edges;
+    size_t   roots;             /* linked nodes without parents           */
+    size_t   leaves;            /* linked nodes without children          */
+    size_t   multi_parent;      /* nodes with two or more parents         */
+    size_t   cyclic;            /* nodes left without a depth             */
+    uint32_t max_depth;
+    uint32_t max_children;
+    uint64_t depth_sum;         /* over linked nodes with a depth         */
+} DAGStats;
+
+/**
+ * Depth of every node and the shape of the hierarchy.
+ *
+ * depth (may be NULL) receives gs_view_node_count(v) entries: 0 for
+ * nodes without edges, DAG_CYCLIC for nodes on or below a cycle.
+ * Returns false if the view lacks in-adjacency or memory runs out.
+ */
+bool dag_levels(const GSView *v, uint32_t *depth, DAGStats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DAG_H */
@@ -0,0 +1,542 @@
+/**
+ * diagnosis.c — Noisy-OR differential diagnosis
+ *
+ * dx_build sorts the links into symptom rows (two counting-sort passes,
+ * by disease then by symptom, so each row is ordered by disease and
+ * repeated pairs are adjacent) and precomputes each link's corrections
+ * to the leak-only log-probabilities:
+ *
+ *   present: log (1 - (1 - leak)(1 - w)) - log leak
+ *   absent:  log ((1 - leak)(1 - w)) - log (1 - leak)  =  log (1 - w)
+ *
+ * dx_diagnose starts every disease at its log prior plus the leak-only
+ * terms of all the evidence, adds the corrections of the observed rows,
+ * and normalises with a log-sum-exp.
+ *
+ * Question gains use the same leak-relative trick: with a normalised
+ * posterior, P(s) = leak + sum over the links of post[d] (p - leak) and
+ * H(S | D) = h(leak) + sum over the links of post[d] (h(p) - h(leak)),
+ * so every symptom's gain comes from one pass over its row.
+ */
+
+#include "diagnosis.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define W_MAX        (1.0 - 1e-6)   /* absent evidence never gives log 0 */
+#define CHUNK        1024u          /* symptoms claimed at a time */
+#define PAR_LINKS    (1u << 16)     /* smaller models score on one thread */
+#define MAX_THREADS  64u
+
+struct DXModel {
+    size_t    n_diseases, n_symptoms, n_links;
+    double   *log_prior;        /* n_diseases */
+    double    log_leak;         /* log leak */
+    double    log_quiet;        /* log (1 - leak) */
+    size_t   *off;              /* n_symptoms + 1 */
+    uint32_t *disease;          /* n_links, by symptom then disease */
+    double   *gain_present;
+    double   *gain_absent;
+    double   *p;                /* P(s | d) per link */
+    double   *dh;               /* h(P(s | d)) - h(leak) per link, bits */
+    double    leak, h_leak;
+};
+
+typedef void (*RangeFn)(void *ctx, unsigned worker, size_t begin, size_t end);
+
+typedef struct {
+    RangeFn         fn;
+    void           *ctx;
+    size_t          n, chunk;
+    _Atomic size_t  next;
+} Ranges;
+
+typedef struct {
+    Ranges  *r;
+    unsigned worker;
+} RangeWorker;
+
+static unsigned thread_count(unsigned threads, size_t chunks)
+{
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads > chunks)
+        threads = chunks ? (unsigned)chunks : 1;
+    return threads;
+}
+
+static void *range_main(void *arg)
+{
+    RangeWorker *w = arg;
+    Ranges *r = w->r;
+    for (;;) {
+        size_t begin = atomic_fetch_add(&r->next, r->chunk);
+        if (begin >= r->n)
+            break;
+        size_t end = begin + r->chunk < r->n ? begin + r->chunk : r->n;
+        r->fn(r->ctx, w->worker, begin, end);
+    }
+    return NULL;
+}
+
+/*
+ * Run fn over [0, n) in chunks on `threads` workers (the caller is worker
+ * 0).  If a thread cannot be started its share falls to the others.
+ */
+static void parallel_ranges(size_t n, size_t chunk, unsigned threads, RangeFn fn, void *ctx)
+{
+    Ranges r = { .fn = fn, .ctx = ctx, .n = n, .chunk = chunk };
+    atomic_init(&r.next, 0);
+    RangeWorker workers[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    unsigned started = 1;
+
+    for (unsigned t = 0; t < threads; t++)
+        workers[t] = (RangeWorker){ &r, t };
+    for (; started < threads; started++)
+        if (pthread_create(&tids[started], NULL, range_main, &workers[started]) != 0)
+            break;
+    range_main(&workers[0]);
+    for (unsigned t = 1; t < started; t++)
+        pthread_join(tids[t], NULL);
+}
+
+/* Binary entropy in bits. */
+static double h2(double p)
+{
+    if (p <= 0.0 || p >= 1.0)
+        return 0.0;
+    return -(p * log2(p) + (1.0 - p) * log2(1.0 - p));
+}
+
+/* -------------------------------------------------------------------------
+ * Building
+ * ---------------------------------------------------------------------- */
+
+DXModel *dx_build(size_t n_diseases, size_t n_symptoms,
+                  const uint32_t *diseases, const uint32_t *symptoms,
+                  const float *weights, size_t n_links,
+                  const double *priors, double leak)
+{
+    if (!(leak > 0.0 && leak < 1.0) || n_diseases > UINT32_MAX || n_symptoms > UINT32_MAX)
+        return NULL;
+    if (n_links && (!diseases || !symptoms || !weights))
+        return NULL;
+    for (size_t i = 0; i < n_links; i++) {
+        if (diseases[i] >= n_diseases || symptoms[i] >= n_symptoms ||
+            !(weights[i] >= 0.0f && weights[i] <= 1.0f))
+            return NULL;
+    }
+    if (priors) {
+        for (size_t d = 0; d < n_diseases; d++)
+            if (!(priors[d] > 0.0) || isinf(priors[d]))
+                return NULL;
+    }
+
+    DXModel *m = calloc(1, sizeof(*m));
+    size_t *by_disease = calloc(n_diseases + 1, sizeof(size_t));
+    size_t *tmp = malloc((n_links ? n_links : 1) * sizeof(size_t));
+    size_t *order = malloc((n_links ? n_links : 1) * sizeof(size_t));
+    if (!m || !by_disease || !tmp || !order)
+        goto fail;
+    m->n_diseases = n_diseases;
+    m->n_symptoms = n_symptoms;
+    m->log_prior = malloc((n_diseases ? n_diseases : 1) * sizeof(double));
+    m->off = calloc(n_symptoms + 1, sizeof(size_t));
+    m->disease = malloc((n_links ? n_links : 1) * sizeof(uint32_t));
+    m->gain_present = malloc((n_links ? n_links : 1) * sizeof(double));
+    m->gain_absent = malloc((n_links ? n_links : 1) * sizeof(double));
+    m->p = malloc((n_links ? n_links : 1) * sizeof(double));
+    m->dh = malloc((n_links ? n_links : 1) * sizeof(double));
+    if (!m->log_prior || !m->off || !m->disease || !m->gain_present || !m->gain_absent ||
+        !m->p || !m->dh)
+        goto fail;
+
+    double log_total = 0.0;
+    if (priors) {
+        double total = 0.0;
+        for (size_t d = 0; d < n_diseases; d++)
+            total += priors[d];
+        log_total = log(total);
+    } else if (n_diseases) {
+        log_total = log((double)n_diseases);
+    }
+    for (size_t d = 0; d < n_diseases; d++)
+        m->log_prior[d] = (priors ? log(priors[d]) : 0.0) - log_total;
+    m->log_leak = log(leak);
+    m->log_quiet = log1p(-leak);
+    m->leak = leak;
+    m->h_leak = h2(leak);
+
+    /* Counting sort by disease, then a stable one by symptom. */
+    for (size_t i = 0; i < n_links; i++)
+        by_disease[diseases[i] + 1]++;
+    for (size_t d = 0; d < n_diseases; d++)
+        by_disease[d + 1] += by_disease[d];
+    for (size_t i = 0; i < n_links; i++)
+        tmp[by_disease[diseases[i]]++] = i;
+    for (size_t i = 0; i < n_links; i++)
+        m->off[symptoms[i] + 1]++;
+    for (size_t s = 0; s < n_symptoms; s++)
+        m->off[s + 1] += m->off[s];
+    for (size_t j = 0; j < n_links; j++)
+        order[m->off[symptoms[tmp[j]]]++] = tmp[j];
+    /* The placement loop advanced each off[s] to the end of row s. */
+    memmove(m->off + 1, m->off, n_symptoms * sizeof(size_t));
+    m->off[0] = 0;
+
+    /* Merge repeated pairs (largest weight) and compact the rows. */
+    size_t n = 0;
+    for (size_t s = 0; s < n_symptoms; s++) {
+        size_t begin = m->off[s], end = m->off[s + 1];
+        m->off[s] = n;
+        for (size_t j = begin; j < end; j++) {
+            size_t i = order[j];
+            double w = weights[i];
+            if (n > m->off[s] && m->disease[n - 1] == diseases[i]) {
+                if (w > m->gain_absent[n - 1])
+                    m->gain_absent[n - 1] = w;
+                continue;
+            }
+            m->disease[n] = diseases[i];
+            m->gain_absent[n] = w;  /* weight for now */
+            n++;
+        }
+    }
+    m->off[n_symptoms] = n;
+    m->n_links = n;
+
+    for (size_t j = 0; j < n; j++) {
+        double w = m->gain_absent[j] < W_MAX ? m->gain_absent[j] : W_MAX;
+        m->p[j] = 1.0 - (1.0 - leak) * (1.0 - w);
+        m->dh[j] = h2(m->p[j]) - m->h_leak;
+        m->gain_present[j] = log(m->p[j]) - m->log_leak;
+        m->gain_absent[j] = log1p(-w);
+    }
+
+    free(by_disease);
+    free(tmp);
+    free(order);
+    return m;
+
+fail:
+    free(by_disease);
+    free(tmp);
+    free(order);
+    dx_free(m);
+    return NULL;
+}
+
+void dx_free(DXModel *m)
+{
+    if (!m)
+        return;
+    free(m->log_prior);
+    free(m->off);
+    free(m->disease);
+    free(m->gain_present);
+    free(m->gain_absent);
+    free(m->p);
+    free(m->dh);
+    free(m);
+}
+
+size_t dx_disease_count(const DXModel *m) { return m ? m->n_diseases : 0; }
+size_t dx_symptom_count(const DXModel *m) { return m ? m->n_symptoms : 0; }
+size_t dx_link_count(const DXModel *m)    { return m ? m->n_links : 0; }
+
+/* -------------------------------------------------------------------------
+ * Diagnosis
+ * ---------------------------------------------------------------------- */
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Symptoms in range and each given once. */
+static int check_evidence(const DXModel *m, const uint32_t *present, size_t n_present,
+                          const uint32_t *absent, size_t n_absent)
+{
+    size_t n = n_present + n_absent;
+    if (n == 0)
+        return 1;
+    if ((n_present && !present) || (n_absent && !absent))
+        return 0;
+    uint32_t *all = malloc(n * sizeof(uint32_t));
+    if (!all)
+        return -1;
+    if (n_present)
+        memcpy(all, present, n_present * sizeof(uint32_t));
+    if (n_absent)
+        memcpy(all + n_present, absent, n_absent * sizeof(uint32_t));
+    qsort(all, n, sizeof(uint32_t), cmp_u32);
+    int ok = all[n - 1] < m->n_symptoms;
+    for (size_t i = 1; ok && i < n; i++)
+        ok = all[i] != all[i - 1];
+    free(all);
+    return ok;
+}
+
+/* Min-heap on (score, -id): the root is the weakest of the best k. */
+static inline bool weaker(const double *score, uint32_t a, uint32_t b)
+{
+    return score[a] < score[b] || (score[a] == score[b] && a > b);
+}
+
+static void sift_down(uint32_t *heap, size_t n, size_t i, const double *score)
+{
+    for (;;) {
+        size_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < n && weaker(score, heap[l], heap[m]))
+            m = l;
+        if (r < n && weaker(score, heap[r], heap[m]))
+            m = r;
+        if (m == i)
+            return;
+        uint32_t tmp = heap[i];
+        heap[i] = heap[m];
+        heap[m] = tmp;
+        i = m;
+    }
+}
+
+/* Best k by score into heap, sorted best first; returns the count. */
+static size_t top_k(const double *score, size_t n, size_t k, uint32_t *heap)
+{
+    size_t size = 0;
+    if (k == 0)
+        return 0;
+    for (size_t d = 0; d < n; d++) {
+        if (size < k) {
+            heap[size++] = (uint32_t)d;
+            if (size == k)
+                for (size_t i = k / 2; i-- > 0;)
+                    sift_down(heap, size, i, score);
+        } else if (weaker(score, heap[0], (uint32_t)d)) {
+            heap[0] = (uint32_t)d;
+            sift_down(heap, size, 0, score);
+        }
+    }
+    if (size < k)
+        for (size_t i = size / 2; i-- > 0;)
+            sift_down(heap, size, i, score);
+    for (size_t end = size; end > 1; end--) {
+        uint32_t tmp = heap[0];
+        heap[0] = heap[end - 1];
+        heap[end - 1] = tmp;
+        sift_down(heap, end - 1, 0, score);
+    }
+    return size;
+}
+
+int64_t dx_diagnose(const DXModel *m,
+                    const uint32_t *present, size_t n_present,
+                    const uint32_t *absent, size_t n_absent,
+                    double *log_lik, double *post,
+                    size_t k, uint32_t *top_ids, double *top_post)
+{
+    if (!m || (k && (!top_ids || !top_post)))
+        return -1;
+    if (check_evidence(m, present, n_present, absent, n_absent) != 1)
+        return -1;
+
+    size_t nd = m->n_diseases;
+    if (k > nd)
+        k = nd;
+    double *score = log_lik ? log_lik : malloc((nd ? nd : 1) * sizeof(double));
+    if (!score)
+        return -1;
+
+    double base = (double)n_present * m->log_leak + (double)n_absent * m->log_quiet;
+    for (size_t d = 0; d < nd; d++)
+        score[d] = m->log_prior[d] + base;
+    for (size_t i = 0; i < n_present; i++) {
+        uint32_t s = present[i];
+        for (size_t j = m->off[s]; j < m->off[s + 1]; j++)
+            score[m->disease[j]] += m->gain_present[j];
+    }
+    for (size_t i = 0; i < n_absent; i++) {
+        uint32_t s = absent[i];
+        for (size_t j = m->off[s]; j < m->off[s + 1]; j++)
+            score[m->disease[j]] += m->gain_absent[j];
+    }
+
+    /* Log-sum-exp normalisation. */
+    double top = -INFINITY, total = 0.0;
+    for (size_t d = 0; d < nd; d++)
+        if (score[d] > top)
+            top = score[d];
+    for (size_t d = 0; d < nd; d++)
+        total += exp(score[d] - top);
+    double log_z = top + log(total);
+    if (post)
+        for (size_t d = 0; d < nd; d++)
+            post[d] = exp(score[d] - log_z);
+
+    size_t found = top_k(score, nd, k, top_ids);
+    for (size_t i = 0; i < found; i++)
+        top_post[i] = exp(score[top_ids[i]] - log_z);
+
+    if (score != log_lik)
+        free(score);
+    return (int64_t)found;
+}
+
+/* -------------------------------------------------------------------------
+ * Interviewing
+ * ---------------------------------------------------------------------- */
+
+bool dx_observe(const DXModel *m, const double *post_in, uint32_t symptom, bool present,
+                double *post_out)
+{
+    if (!m || symptom >= m->n_symptoms || (m->n_diseases && (!post_in || !post_out)))
+        return false;
+    double base = present ? m->leak : 1.0 - m->leak;
+    for (size_t d = 0; d < m->n_diseases; d++)
+        post_out[d] = post_in[d] * base;
+    for (size_t j = m->off[symptom]; j < m->off[symptom + 1]; j++) {
+        double like = present ? m->p[j] : 1.0 - m->p[j];
+        post_out[m->disease[j]] *= like / base;
+    }
+    double total = 0.0;
+    for (size_t d = 0; d < m->n_diseases; d++)
+        total += post_out[d];
+    if (!(total > 0.0) || isinf(total))
+        return false;
+    for (size_t d = 0; d < m->n_diseases; d++)
+        post_out[d] /= total;
+    return true;
+}
+
+double dx_entropy(const double *post, size_t n)
+{
+    double total = 0.0, h = 0.0;
+    for (size_t d = 0; d < n; d++)
+        total += post[d];
+    if (!(total > 0.0))
+        return 0.0;
+    for (size_t d = 0; d < n; d++) {
+        double q = post[d] / total;
+        if (q > 0.0)
+            h -= q * log2(q);
+    }
+    return h;
+}
+
+typedef struct {
+    const DXModel *m;
+    const double  *post;
+    double         scale;       /* 1 / sum of post */
+    double        *rank, *gain, *p_present;
+} Questions;
+
+static void question_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    Questions *q = ctx;
+    const DXModel *m = q->m;
+    (void)worker;
+    for (size_t s = begin; s < end; s++) {
+        double ps = 0.0, hc = 0.0;
+        for (size_t j = m->off[s]; j < m->off[s + 1]; j++) {
+            double w = q->post[m->disease[j]];
+            ps += w * (m->p[j] - m->leak);
+            hc += w * m->dh[j];
+        }
+        ps = m->leak + ps * q->scale;
+        hc = m->h_leak + hc * q->scale;
+        double g = h2(ps) - hc;
+        q->rank[s] = g > 0.0 ? g : 0.0;     /* rounding can dip below 0 */
+        if (q->gain)
+            q->gain[s] = q->rank[s];
+        if (q->p_present)
+            q->p_present[s] = ps;
+    }
+}
+
+int64_t dx_questions(const DXModel *m, const double *post,
+                     const uint32_t *skip, size_t n_skip,
+                     double *gain, double *p_present, unsigned threads,
+                     size_t k, uint32_t *top_ids, double *top_gain)
+{
+    if (!m || (m->n_diseases && !post) || (n_skip && !skip) ||
+        (k && (!top_ids || !top_gain)))
+        return -1;
+    size_t ns = m->n_symptoms;
+    for (size_t i = 0; i < n_skip; i++)
+        if (skip[i] >= ns)
+            return -1;
+    double total = 0.0;
+    for (size_t d = 0; d < m->n_diseases; d++)
+        total += post[d];
+    if (!(total > 0.0) || isinf(total))
+        return -1;
+
+    double *rank = malloc((ns ? ns : 1) * sizeof(double));
+    if (!rank)
+        return -1;
+    Questions q = { m, post, 1.0 / total, rank, gain, p_present };
+    if (m->n_links < PAR_LINKS)
+        threads = 1;
+    threads = thread_count(threads, (ns + CHUNK - 1) / CHUNK);
+    parallel_ranges(ns, CHUNK, threads, question_pass, &q);
+    for (size_t i = 0; i < n_skip; i++)
+        rank[skip[i]] = -INFINITY;
+
+    if (k > ns)
+        k = ns;
+    size_t found = top_k(rank, ns, k, top_ids);
+    while (found && rank[top_ids[found - 1]] == -INFINITY)
+        found--;
+    for (size_t i = 0; i < found; i++)
+        top_gain[i] = rank[top_ids[i]];
+    free(rank);
+    return (int64_t)found;
+}
+
+/* -------------------------------------------------------------------------
+ * Hierarchy roll-up
+ * ---------------------------------------------------------------------- */
+
+bool dx_rollup(const double *post, size_t n_diseases, const uint32_t *group_of,
+               const uint32_t *parent, size_t n_groups, double *out)
+{
+    if ((n_diseases && (!post || !group_of)) || (n_groups && (!parent || !out)))
+        return false;
+    for (size_t g = 0; g < n_groups; g++) {
+        if (parent[g] != DX_NONE && parent[g] >= n_groups)
+            return false;
+        out[g] = 0.0;
+    }
+    /* A chain longer than n_groups must revisit a group. */
+    for (size_t g = 0; g < n_groups; g++) {
+        size_t steps = 0;
+        for (uint32_t a = parent[g]; a != DX_NONE; a = parent[a])
+            if (++steps > n_groups)
+                return false;
+    }
+    for (size_t d = 0; d < n_diseases; d++)
+        if (group_of[d] != DX_NONE && group_of[d] >= n_groups)
+            return false;
+    for (size_t d = 0; d < n_diseases; d++) {
+        if (group_of[d] == DX_NONE)
+            continue;
+        for (uint32_t g = group_of[d]; g != DX_NONE; g = parent[g])
+            out[g] += post[d];
+    }
+    return true;
+}
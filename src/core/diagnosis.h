@@ -0,0 +1,125 @@
+/**
+ * diagnosis.h — Noisy-OR differential diagnosis
+ *
+ * A model links diseases to symptoms with weights: w(d, s) is the
+ * probability that disease d alone produces symptom s.  Every symptom
+ * also has a leak cause (anything not modelled), so
+ *
+ *   P(s | d) = 1 - (1 - leak) (1 - w(d, s))      (w = 0 when unlinked)
+ *
+ * Assuming a single disease is present and symptoms are independent
+ * given it, the evidence scores each disease as
+ *
+ *   log L(d) = log prior(d) + sum over present s of log P(s | d)
+ *                           + sum over absent s of log (1 - P(s | d))
+ *
+ * and the posterior is the softmax of log L over the diseases.  Symptoms
+ * neither present nor absent do not contribute.
+ *
+ * Layout: the links are kept symptom-major (CSR), each with its log
+ * P(s | d) and log (1 - P(s | d)) relative to the leak-only values, so a
+ * piece of evidence adds one constant to every disease and scatters its
+ * row's corrections.  A diagnosis costs O(diseases + links of the
+ * observed symptoms), whatever the number of symptoms in the model.
+ *
+ * Interviewing: the best next question is the symptom whose answer is
+ * expected to shrink the posterior's entropy most, i.e. with the largest
+ * mutual information I(D; S) = H(S) - sum over d of post(d) h(P(s | d))
+ * (h the binary entropy).  Unlinked pairs share the leak probability, so
+ * the gains of all symptoms take one pass over the links, O(diseases +
+ * links).  dx_observe updates a posterior with one answer in O(diseases),
+ * so an interview need not rescore its earlier evidence.
+ *
+ * A built model is immutable: diagnoses may run from any thread.
+ */
+
+#ifndef DIAGNOSIS_H
+#define DIAGNOSIS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DX_NONE UINT32_MAX      /* no group / no parent in dx_rollup */
+
+typedef struct DXModel DXModel;
+
+/**
+ * Build a model from (disease, symptom, weight) links.  Weights must lie
+ * in [0, 1] (they are capped just below 1, so an absent symptom never
+ * rules a disease out entirely); a repeated pair keeps its largest
+ * weight.  priors holds n_diseases positive values (NULL = uniform; they
+ * need not sum to 1); leak must lie in (0, 1).  Returns NULL for
+ * out-of-range indices or values, or lack of memory.
+ */
+DXModel *dx_build(size_t n_diseases, size_t n_symptoms,
+                  const uint32_t *diseases, const uint32_t *symptoms,
+                  const float *weights, size_t n_links,
+                  const double *priors, double leak);
+void     dx_free(DXModel *m);
+
+size_t dx_disease_count(const DXModel *m);
+size_t dx_symptom_count(const DXModel *m);
+size_t dx_link_count(const DXModel *m);
+
+/**
+ * Score the evidence.  log_lik and post (n_diseases entries each, either
+ * may be NULL) receive log L and the posterior of every disease; top_ids
+ * and top_post (k entries) the k most probable diseases, best first
+ * (ties by lower index).  Returns the number of top entries written
+ * (min(k, n_diseases)), or -1 for symptoms out of range, a symptom given
+ * twice (in either list), or lack of memory.
+ */
+int64_t dx_diagnose(const DXModel *m,
+                    const uint32_t *present, size_t n_present,
+                    const uint32_t *absent, size_t n_absent,
+                    double *log_lik, double *post,
+                    size_t k, uint32_t *top_ids, double *top_post);
+
+/**
+ * Posterior after one more observation: post_out[d] is proportional to
+ * post_in[d] P(s | d) (present) or post_in[d] (1 - P(s | d)) (absent).
+ * post_in and post_out may be the same array.  Returns false for a
+ * symptom out of range or a posterior that sums to 0.
+ */
+bool dx_observe(const DXModel *m, const double *post_in, uint32_t symptom, bool present,
+                double *post_out);
+
+/** Entropy in bits of a posterior (normalised first; 0 if it sums to 0). */
+double dx_entropy(const double *post, size_t n);
+
+/**
+ * Expected information gain in bits of asking about each symptom, given
+ * a posterior over the diseases (normalised first).  gain and p_present
+ * (n_symptoms entries, either may be NULL) receive every symptom's gain
+ * and probability of being present; top_ids / top_gain (k entries) the k
+ * best symptoms not in skip (the ones already asked), best first, ties
+ * by lower index.  Symptoms are split among threads (0 = one per online
+ * CPU) when the model has enough links to pay for them.  Returns the
+ * number of top entries written, or -1 for skipped symptoms out of
+ * range, a posterior summing to 0, or lack of memory.
+ */
+int64_t dx_questions(const DXModel *m, const double *post,
+                     const uint32_t *skip, size_t n_skip,
+                     double *gain, double *p_present, unsigned threads,
+                     size_t k, uint32_t *top_ids, double *top_gain);
+
+/**
+ * Roll disease posteriors up a classification tree: out[g] (n_groups
+ * entries) becomes the total posterior of the diseases in group g or
+ * below it.  group_of maps each disease to its group (DX_NONE = none);
+ * parent maps each group to its parent (DX_NONE = root).  Returns false
+ * for indices out of range or a cycle among the parents.
+ */
+bool dx_rollup(const double *post, size_t n_diseases, const uint32_t *group_of,
+               const uint32_t *parent, size_t n_groups, double *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DIAGNOSIS_H */
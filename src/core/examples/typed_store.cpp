@@ -0,0 +1,186 @@
+/**
+ * typed_store.cpp — Exercises simple_db.hpp (built and run by `make check-cpp`)
+ *
+ * Doubles as a usage example for native modules.  Exits non-zero on the
+ * first failed check.
+ */
+
+#include "simple_db.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n",              \
+                         __FILE__, __LINE__, #cond);                       \
+            std::exit(1);                                                  \
+        }                                                                  \
+    } while (0)
+
+struct EdgeKey {
+    std::uint32_t from;
+    std::uint32_t to;
+};
+
+/* Counts allocations; throws bad_alloc once the budget runs out. */
+static std::size_t alloc_count;
+static std::size_t alloc_budget = SIZE_MAX;
+
+template <class T>
+struct BudgetAlloc {
+    using value_type = T;
+    BudgetAlloc() = default;
+    template <class U> BudgetAlloc(const BudgetAlloc<U> &) noexcept {}
+
+    T *allocate(std::size_t n)
+    {
+        if (alloc_count >= alloc_budget) throw std::bad_alloc();
+        alloc_count++;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T *p, std::size_t n) noexcept { std::allocator<T>().deallocate(p, n); }
+
+    template <class U> bool operator==(const BudgetAlloc<U> &) const noexcept { return true; }
+    template <class U> bool operator!=(const BudgetAlloc<U> &) const noexcept { return false; }
+};
+
+static void database_and_snapshots()
+{
+    simpledb::Database db;
+    CHECK(db.set("node:A", "{\"label\":\"A\"}"));
+    CHECK(db.get("node:A") == std::string("{\"label\":\"A\"}"));
+
+    {
+        simpledb::Snapshot snap = db.snapshot();
+        db.set("node:A", "changed");
+        db.erase("node:A");
+        auto seen = snap.get("node:A");
+        CHECK(seen && *seen == "{\"label\":\"A\"}");
+        CHECK(snap.size() == 1);
+
+        std::size_t n = 0;
+        for (std::string_view key : snap.keys()) {
+            CHECK(key == "node:A");
+            n++;
+        }
+        CHECK(n == 1);
+    }
+    CHECK(db.stats().active_snapshots == 0);
+    CHECK(!db.contains("node:A"));
+
+    std::string long_key(300, 'k');   /* beyond the small-key buffer */
+    CHECK(db.set(long_key, "v"));
+    CHECK(db.get(long_key) == std::string("v"));
+
+    simpledb::Database moved = std::move(db);
+    CHECK(moved.size() == 1);
+}
+
+static void typed_store()
+{
+    simpledb::Database db;
+    simpledb::Store<std::uint64_t, std::int64_t> counts(db);
+
+    CHECK(counts.set(42, -7));
+    CHECK(counts.get(42) == std::int64_t(-7));
+    CHECK(!counts.get(43));
+    CHECK(db.get("42") == std::string("-7"));
+
+    db.set("44", "not a number");
+    CHECK(!counts.get(44));
+    CHECK(counts.erase(42));
+
+    /* encode buffers come from the store's allocator */
+    using codec = simpledb::Codec<std::string>;
+    simpledb::Store<std::string, std::string, codec, codec, BudgetAlloc<char>> names(db);
+    std::string long_key(100, 'n');   /* beyond the string's inline buffer */
+    alloc_count = 0;
+    CHECK(names.set(long_key, "v"));
+    CHECK(names.get(long_key) == std::string("v"));
+    CHECK(alloc_count == 0);           /* pass-through codecs need no scratch */
+
+    simpledb::Store<std::uint64_t, std::uint64_t, simpledb::Codec<std::uint64_t>,
+                    simpledb::Codec<std::uint64_t>, BudgetAlloc<char>> ids(db);
+    CHECK(ids.set(7, 18446744073709551615ull));
+    CHECK(ids.get(7) == std::uint64_t(18446744073709551615ull));
+}
+
+static void flat_map()
+{
+    simpledb::FlatMap<std::uint32_t, std::uint32_t> slots;
+    for (std::uint32_t i = 0; i < 10000; i++) slots[i * 7919u] = i;
+    CHECK(slots.size() == 10000);
+    for (std::uint32_t i = 0; i < 10000; i += 3) CHECK(slots.erase(i * 7919u));
+    for (std::uint32_t i = 0; i < 10000; i++) {
+        auto it = slots.find(i * 7919u);
+        CHECK((it != slots.end()) == (i % 3 != 0));
+        if (it != slots.end()) CHECK(it->second == i);
+    }
+
+    std::size_t seen = 0;
+    for (const auto &kv : slots) seen += (kv.first % 7919u == 0);
+    CHECK(seen == slots.size());
+
+    /* string keys: heterogeneous lookup by string_view, no temporary */
+    simpledb::FlatMap<std::string, int> names;
+    names.insert_or_assign(std::string("Fever"), 1);
+    names.try_emplace(std::string_view("Cough"), 2);
+    CHECK(names.contains(std::string_view("Fever")));
+    CHECK(names.find(std::string_view("Cough"))->second == 2);
+    CHECK(!names.try_emplace(std::string("Fever"), 9).second);
+
+    /* fixed-size struct keys hash their bytes */
+    simpledb::FlatMap<EdgeKey, double> weights;
+    weights[EdgeKey{1, 2}] = 0.5;
+    CHECK(weights.contains(EdgeKey{1, 2}));
+    CHECK(!weights.contains(EdgeKey{2, 1}));
+
+    simpledb::FlatMap<EdgeKey, double> moved = std::move(weights);
+    CHECK(moved.size() == 1);
+
+    /* moved-from maps stay usable, whichever way they were moved from */
+    CHECK(weights.empty() && !weights.contains(EdgeKey{1, 2}));
+    CHECK(weights.find(EdgeKey{1, 2}) == weights.end());
+    CHECK(!weights.erase(EdgeKey{1, 2}));
+    CHECK(weights.begin() == weights.end());
+    weights.clear();
+    for (std::uint32_t i = 0; i < 100; i++) weights[EdgeKey{i, i}] = i;
+    CHECK(weights.size() == 100 && weights.find(EdgeKey{7, 7})->second == 7);
+    simpledb::FlatMap<EdgeKey, double> other;
+    other = std::move(moved);
+    CHECK(!moved.contains(EdgeKey{1, 2}));
+    moved[EdgeKey{3, 4}] = 1.5;
+    CHECK(moved.size() == 1 && other.size() == 1);
+
+    /* a rehash that cannot allocate leaves the table as it was */
+    simpledb::FlatMap<std::string, int, simpledb::Hash<std::string>,
+                      simpledb::Equal<std::string>,
+                      BudgetAlloc<std::pair<std::string, int>>> tight;
+    alloc_count = 0;
+    int n = 0;
+    try {
+        for (;; n++) {
+            if (n == 64) alloc_budget = alloc_count;   /* next growth fails */
+            tight.insert_or_assign(std::to_string(n), n);
+        }
+    } catch (const std::bad_alloc &) {
+    }
+    alloc_budget = SIZE_MAX;
+    CHECK(n >= 64 && tight.size() == std::size_t(n));
+    for (int i = 0; i < n; i++) CHECK(tight.find(std::to_string(i))->second == i);
+    tight.insert_or_assign(std::to_string(n), n);
+    CHECK(tight.size() == std::size_t(n) + 1);
+}
+
+int main()
+{
+    database_and_snapshots();
+    typed_store();
+    flat_map();
+    std::puts("simple_db.hpp: all checks passed");
+    return 0;
+}
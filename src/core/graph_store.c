@@ -0,0 +1,800 @@
+/**
+ * graph_store.c — Dynamic adjacency store with batched ingestion
+ *
+ * Layout of a version (GSView):
+ *   table -> chunk[node >> 10] -> list[node & 1023] -> { deg, dst[], w[] }
+ *
+ * Chunks and lists are reference counted and immutable once published.
+ * The merger clones the chunk pointer array of the current version (one
+ * reference per chunk), then replaces only the chunks and lists the batch
+ * touches.  Memory per version is therefore proportional to the batch,
+ * not the graph.
+ *
+ * Producer rings are SPSC: the producer owns head, the merger owns tail.
+ * g->lock guards the producer list and the flush tickets; g->view_lock
+ * guards only the root pointer swap, so acquiring a view never waits for
+ * a merge in progress.
+ */
+
+#include "graph_store.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define CHUNK_BITS        10u
+#define CHUNK_SIZE        (1u << CHUNK_BITS)
+#define CHUNK_MASK        (CHUNK_SIZE - 1)
+#define DEFAULT_RING      (1u << 16)
+#define MIN_RING          64u
+#define MAX_BATCH         ((size_t)1 << 22)    /* ops per merge          */
+#define MERGE_MIN         ((size_t)1 << 16)    /* merge early at this    */
+#define MERGE_INTERVAL_NS 1000000L             /* otherwise every 1 ms   */
+#define MERGE_RETRY_NS    10000000L            /* after an OOM merge     */
+#define RADIX_BITS        11u
+#define RADIX_SIZE        (1u << RADIX_BITS)
+#define RADIX_PASSES      6u                   /* 6 * 11 >= 64           */
+
+enum { OP_INSERT = 0, OP_DELETE = 1 };
+
+typedef struct {
+    uint32_t src;
+    uint32_t dst;
+    float    w;
+    uint32_t kind;
+} Op;
+
+/* Adjacency list: header followed by dst[deg] then w[deg]. */
+typedef struct {
+    atomic_uint refs;
+    uint32_t    deg;
+} AdjList;
+
+typedef struct {
+    atomic_uint refs;
+    AdjList    *lists[CHUNK_SIZE];
+} Chunk;
+
+typedef struct {
+    Chunk  **chunks;
+    uint32_t nchunks;
+} Table;
+
+struct GSView {
+    atomic_uint refs;
+    uint64_t    version;
+    size_t      nodes;
+    size_t      edges;
+    bool        track_in;
+    Table       out;
+    Table       in;
+};
+
+struct GSProducer {
+    GraphStore    *g;
+    Op            *ring;
+    size_t         cap;            /* power of two */
+    _Atomic size_t head;           /* written by the producer */
+    _Atomic size_t tail;           /* written by the merger   */
+    size_t         cached_tail;    /* producer's last view of tail */
+    atomic_bool    closed;
+    GSProducer    *next;
+};
+
+struct GraphStore {
+    unsigned        flags;
+
+    pthread_mutex_t view_lock;     /* cur swap / acquire only */
+    GSView         *cur;
+
+    pthread_mutex_t lock;          /* producers, tickets, stop */
+    pthread_cond_t  wake;          /* merger waits here       */
+    pthread_cond_t  done;          /* flushers wait here      */
+    GSProducer     *producers;
+    size_t          nproducers;
+    uint64_t        flush_req;
+    uint64_t        flush_done;
+    size_t          held;          /* ops kept in batch after a failed merge */
+    bool            stop;
+    pthread_t       merger;
+    atomic_bool     idle;          /* merger sleeps until signalled */
+
+    /* Merger-owned */
+    Op             *batch;         /* grown on demand up to MAX_BATCH */
+    Op             *scratch;
+    size_t          batch_cap;
+    size_t          hist[RADIX_PASSES][RADIX_SIZE];
+    _Atomic size_t  merges;
+    _Atomic size_t  ops_applied;
+    _Atomic size_t  merge_retries;
+};
+
+/* -------------------------------------------------------------------------
+ * Adjacency lists and chunks
+ * ---------------------------------------------------------------------- */
+
+static inline uint32_t *adj_dst(AdjList *l)        { return (uint32_t *)(l + 1); }
+static inline float    *adj_w(AdjList *l)          { return (float *)(adj_dst(l) + l->deg); }
+
+static AdjList *adj_alloc(uint32_t deg)
+{
+    AdjList *l = malloc(sizeof(AdjList) + (size_t)deg * (sizeof(uint32_t) + sizeof(float)));
+    if (!l) return NULL;
+    atomic_init(&l->refs, 1);
+    l->deg = deg;
+    return l;
+}
+
+static inline void adj_release(AdjList *l)
+{
+    if (l && atomic_fetch_sub_explicit(&l->refs, 1, memory_order_acq_rel) == 1) free(l);
+}
+
+static void chunk_release(Chunk *c)
+{
+    if (!c || atomic_fetch_sub_explicit(&c->refs, 1, memory_order_acq_rel) != 1) return;
+    for (uint32_t i = 0; i < CHUNK_SIZE; i++) adj_release(c->lists[i]);
+    free(c);
+}
+
+/* Private copy of c (NULL = empty chunk); lists are shared. */
+static Chunk *chunk_copy(const Chunk *c)
+{
+    Chunk *n = calloc(1, sizeof(Chunk));
+    if (!n) return NULL;
+    atomic_init(&n->refs, 1);
+    if (c) {
+        for (uint32_t i = 0; i < CHUNK_SIZE; i++) {
+            n->lists[i] = c->lists[i];
+            if (n->lists[i]) atomic_fetch_add_explicit(&n->lists[i]->refs, 1, memory_order_relaxed);
+        }
+    }
+    return n;
+}
+
+static void table_release(Table *t)
+{
+    for (uint32_t i = 0; i < t->nchunks; i++) chunk_release(t->chunks[i]);
+    free(t->chunks);
+    t->chunks  = NULL;
+    t->nchunks = 0;
+}
+
+/* Share every chunk of old in t, growing to nchunks. */
+static bool table_clone(Table *t, const Table *old, uint32_t nchunks)
+{
+    if (nchunks < old->nchunks) nchunks = old->nchunks;
+    t->chunks  = nchunks ? calloc(nchunks, sizeof(Chunk *)) : NULL;
+    if (nchunks && !t->chunks) return false;
+    t->nchunks = nchunks;
+
+    for (uint32_t i = 0; i < old->nchunks; i++) {
+        t->chunks[i] = old->chunks[i];
+        if (t->chunks[i]) atomic_fetch_add_explicit(&t->chunks[i]->refs, 1, memory_order_relaxed);
+    }
+    return true;
+}
+
+static const AdjList *table_list(const Table *t, uint32_t node)
+{
+    uint32_t c = node >> CHUNK_BITS;
+    if (c >= t->nchunks || !t->chunks[c]) return NULL;
+    return t->chunks[c]->lists[node & CHUNK_MASK];
+}
+
+/* -------------------------------------------------------------------------
+ * Views
+ * ---------------------------------------------------------------------- */
+
+static void view_free(GSView *v)
+{
+    table_release(&v->out);
+    table_release(&v->in);
+    free(v);
+}
+
+void gs_view_release(GSView *v)
+{
+    if (v && atomic_fetch_sub_explicit(&v->refs, 1, memory_order_acq_rel) == 1) view_free(v);
+}
+
+GSView *gs_view_acquire(GraphStore *g)
+{
+    if (!g) return NULL;
+    pthread_mutex_lock(&g->view_lock);
+    GSView *v = g->cur;
+    atomic_fetch_add_explicit(&v->refs, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&g->view_lock);
+    return v;
+}
+
+uint64_t gs_view_version(const GSView *v)   { return v ? v->version : 0; }
+size_t   gs_view_node_count(const GSView *v) { return v ? v->nodes : 0; }
+size_t   gs_view_edge_count(const GSView *v) { return v ? v->edges : 0; }
+bool     gs_view_tracks_in(const GSView *v)  { return v && v->track_in; }
+
+static size_t list_out(const AdjList *l, const uint32_t **ids, const float **weights)
+{
+    AdjList *m = (AdjList *)l;
+    if (ids)     *ids     = l ? adj_dst(m) : NULL;
+    if (weights) *weights = l ? adj_w(m) : NULL;
+    return l ? l->deg : 0;
+}
+
+size_t gs_view_neighbors(const GSView *v, uint32_t node,
+                         const uint32_t **dst, const float **weights)
+{
+    return list_out(v ? table_list(&v->out, node) : NULL, dst, weights);
+}
+
+size_t gs_view_in_neighbors(const GSView *v, uint32_t node,
+                            const uint32_t **src, const float **weights)
+{
+    return list_out(v && v->track_in ? table_list(&v->in, node) : NULL, src, weights);
+}
+
+bool gs_view_has_edge(const GSView *v, uint32_t src, uint32_t dst, float *weight)
+{
+    const uint32_t *ids;
+    const float    *ws;
+    size_t lo = 0, hi = gs_view_neighbors(v, src, &ids, &ws);
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ids[mid] < dst)      lo = mid + 1;
+        else if (ids[mid] > dst) hi = mid;
+        else {
+            if (weight) *weight = ws[mid];
+            return true;
+        }
+    }
+    return false;
+}
+
+/* -------------------------------------------------------------------------
+ * Merging
+ * ---------------------------------------------------------------------- */
+
+/* Stable LSD radix sort of ops by (src, dst); digits shared by every key
+ * are skipped, so small graphs pay for few passes. */
+static void sort_ops(GraphStore *g, Op *ops, size_t n)
+{
+    size_t (*hist)[RADIX_SIZE] = g->hist;
+    Op     *tmp = g->scratch;
+    memset(g->hist, 0, sizeof(g->hist));
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t key = ((uint64_t)ops[i].src << 32) | ops[i].dst;
+        for (unsigned p = 0; p < RADIX_PASSES; p++) {
+            hist[p][(key >> (p * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+        }
+    }
+
+    Op *from = ops, *to = tmp;
+    for (unsigned p = 0; p < RADIX_PASSES; p++) {
+        uint64_t key0 = ((uint64_t)ops[0].src << 32) | ops[0].dst;
+        if (hist[p][(key0 >> (p * RADIX_BITS)) & (RADIX_SIZE - 1)] == n) continue;
+
+        size_t sum = 0;
+        for (unsigned b = 0; b < RADIX_SIZE; b++) {
+            size_t c = hist[p][b];
+            hist[p][b] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint64_t key = ((uint64_t)from[i].src << 32) | from[i].dst;
+            to[hist[p][(key >> (p * RADIX_BITS)) & (RADIX_SIZE - 1)]++] = from[i];
+        }
+        Op *t = from; from = to; to = t;
+    }
+    if (from != ops) memcpy(ops, from, n * sizeof(Op));
+}
+
+/*
+ * Fold ops (one source, sorted by dst, arrival order within a dst) into
+ * old.  The last op per dst wins.  Returns the new list (NULL if empty) in
+ * *out; false on allocation failure.
+ */
+static bool adj_merge(const AdjList *old, const Op *ops, size_t k,
+                      AdjList **out, ptrdiff_t *delta)
+{
+    AdjList        *m   = (AdjList *)old;
+    uint32_t        od  = old ? old->deg : 0;
+    const uint32_t *odst = old ? adj_dst(m) : NULL;
+    const float    *ow   = old ? adj_w(m) : NULL;
+
+    /* Pass 1: resulting degree */
+    uint32_t deg = 0;
+    size_t a = 0, b = 0;
+    while (a < od || b < k) {
+        if (b >= k || (a < od && odst[a] < ops[b].dst)) { deg++; a++; continue; }
+        size_t e = b;
+        while (e + 1 < k && ops[e + 1].dst == ops[b].dst) e++;
+        bool same = a < od && odst[a] == ops[b].dst;
+        if (ops[e].kind == OP_INSERT) deg++;
+        if (same) a++;
+        b = e + 1;
+    }
+
+    if (deg == 0) {
+        *delta -= od;
+        *out = NULL;
+        return true;
+    }
+
+    AdjList *l = adj_alloc(deg);
+    if (!l) return false;
+    uint32_t *ndst = adj_dst(l);
+    float    *nw   = adj_w(l);
+
+    /* Pass 2: fill */
+    uint32_t i = 0;
+    a = b = 0;
+    while (a < od || b < k) {
+        if (b >= k || (a < od && odst[a] < ops[b].dst)) {
+            ndst[i] = odst[a]; nw[i++] = ow[a++];
+            continue;
+        }
+        size_t e = b;
+        while (e + 1 < k && ops[e + 1].dst == ops[b].dst) e++;
+        bool same = a < od && odst[a] == ops[b].dst;
+        if (ops[e].kind == OP_INSERT) {
+            ndst[i] = ops[e].dst; nw[i++] = ops[e].w;
+            if (!same) (*delta)++;
+        } else if (same) {
+            (*delta)--;
+        }
+        if (same) a++;
+        b = e + 1;
+    }
+
+    *out = l;
+    return true;
+}
+
+/* Apply sorted ops to t (a clone of old).  Chunks t shares with old are
+ * copied before their first change. */
+static bool table_apply(Table *t, const Table *old, const Op *ops, size_t n, ptrdiff_t *delta)
+{
+    size_t i = 0;
+    while (i < n) {
+        uint32_t src = ops[i].src;
+        size_t   j   = i;
+        while (j < n && ops[j].src == src) j++;
+
+        uint32_t c      = src >> CHUNK_BITS;
+        Chunk   *oldc   = c < old->nchunks ? old->chunks[c] : NULL;
+        if (t->chunks[c] == oldc) {
+            Chunk *nc = chunk_copy(oldc);
+            if (!nc) return false;
+            chunk_release(oldc);
+            t->chunks[c] = nc;
+        }
+
+        AdjList **slot = &t->chunks[c]->lists[src & CHUNK_MASK];
+        AdjList  *nl;
+        if (!adj_merge(*slot, ops + i, j - i, &nl, delta)) return false;
+        adj_release(*slot);
+        *slot = nl;
+
+        i = j;
+    }
+    return true;
+}
+
+static void swap_ends(Op *ops, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        uint32_t t = ops[i].src;
+        ops[i].src = ops[i].dst;
+        ops[i].dst = t;
+    }
+}
+
+/*
+ * Publish a version with ops folded in.  Returns false, leaving cur and the
+ * ops (reordered, but stably per edge) as they were, when out of memory.
+ */
+static bool merge_batch(GraphStore *g, Op *ops, size_t n)
+{
+    GSView *cur = g->cur;     /* only the merger replaces cur */
+
+    uint32_t max_id = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (ops[i].src > max_id) max_id = ops[i].src;
+        if (ops[i].dst > max_id) max_id = ops[i].dst;
+    }
+    size_t   nodes   = (size_t)max_id + 1 > cur->nodes ? (size_t)max_id + 1 : cur->nodes;
+    uint32_t nchunks = (uint32_t)((nodes + CHUNK_SIZE - 1) >> CHUNK_BITS);
+
+    GSView *nv = calloc(1, sizeof(GSView));
+    if (!nv) return false;
+    atomic_init(&nv->refs, 1);
+    nv->track_in = cur->track_in;
+
+    ptrdiff_t delta = 0, unused = 0;
+    sort_ops(g, ops, n);
+    bool ok = table_clone(&nv->out, &cur->out, nchunks) &&
+              table_apply(&nv->out, &cur->out, ops, n, &delta);
+
+    if (ok && nv->track_in) {
+        swap_ends(ops, n);
+        sort_ops(g, ops, n);
+        ok = table_clone(&nv->in, &cur->in, nchunks) &&
+             table_apply(&nv->in, &cur->in, ops, n, &unused);
+        if (!ok) swap_ends(ops, n);
+    }
+
+    if (!ok) {                /* out of memory: keep cur, caller retries */
+        view_free(nv);
+        return false;
+    }
+
+    nv->version = cur->version + 1;
+    nv->nodes   = nodes;
+    nv->edges   = (size_t)((ptrdiff_t)cur->edges + delta);
+
+    pthread_mutex_lock(&g->view_lock);
+    g->cur = nv;
+    pthread_mutex_unlock(&g->view_lock);
+    gs_view_release(cur);
+
+    atomic_fetch_add_explicit(&g->merges, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g->ops_applied, n, memory_order_relaxed);
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Merger thread
+ * ---------------------------------------------------------------------- */
+
+/* Ops waiting in all rings.  Caller holds g->lock. */
+static size_t pending_locked(GraphStore *g)
+{
+    size_t n = 0;
+    for (GSProducer *p = g->producers; p; p = p->next) {
+        n += atomic_load_explicit(&p->head, memory_order_acquire) -
+             atomic_load_explicit(&p->tail, memory_order_relaxed);
+    }
+    return n;
+}
+
+/*
+ * Move up to MAX_BATCH ops from the rings into g->batch and free closed,
+ * drained producers.  Caller holds g->lock.  *more is set when ops were
+ * left behind.
+ */
+static size_t drain_locked(GraphStore *g, bool *more)
+{
+    size_t n = 0;
+    *more = false;
+
+    size_t want = pending_locked(g);
+    if (want > MAX_BATCH) want = MAX_BATCH;
+    if (want > g->batch_cap) {
+        size_t cap = g->batch_cap ? g->batch_cap : 4096;
+        while (cap < want) cap <<= 1;
+        Op *b = realloc(g->batch, cap * sizeof(Op));
+        if (b) g->batch = b;
+        Op *t = b ? realloc(g->scratch, cap * sizeof(Op)) : NULL;
+        if (t) g->scratch = t;
+        if (!b || !t) {            /* out of memory: retry next cycle */
+            *more = true;
+            return 0;
+        }
+        g->batch_cap = cap;
+    }
+
+    GSProducer **link = &g->producers;
+    while (*link) {
+        GSProducer *p      = *link;
+        bool        closed = atomic_load_explicit(&p->closed, memory_order_acquire);
+        size_t      head   = atomic_load_explicit(&p->head, memory_order_acquire);
+        size_t      tail   = atomic_load_explicit(&p->tail, memory_order_relaxed);
+        size_t      avail  = head - tail;
+
+        if (avail > g->batch_cap - n) {
+            avail = g->batch_cap - n;
+            *more = true;
+        }
+        while (avail) {
+            size_t off = tail & (p->cap - 1);
+            size_t run = p->cap - off < avail ? p->cap - off : avail;
+            memcpy(g->batch + n, p->ring + off, run * sizeof(Op));
+            n += run; tail += run; avail -= run;
+        }
+        atomic_store_explicit(&p->tail, tail, memory_order_release);
+
+        if (closed && tail == head) {
+            *link = p->next;
+            g->nproducers--;
+            free(p->ring);
+            free(p);
+        } else {
+            link = &p->next;
+        }
+    }
+    return n;
+}
+
+/* Sleep on wake for up to ns (or until signalled).  Caller holds g->lock. */
+static void wait_ns_locked(GraphStore *g, long ns)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += ns;
+    while (ts.tv_nsec >= 1000000000L) { ts.tv_sec++; ts.tv_nsec -= 1000000000L; }
+    pthread_cond_timedwait(&g->wake, &g->lock, &ts);
+}
+
+/*
+ * A batch whose merge runs out of memory stays in g->batch (g->held) and is
+ * retried before anything else is drained; flush tickets only complete once
+ * it has been published, so gs_flush never reports dropped ops as visible.
+ */
+static void *merger_main(void *arg)
+{
+    GraphStore *g = arg;
+
+    pthread_mutex_lock(&g->lock);
+    for (;;) {
+        /* Batch up: sleep unless flushed, signalled or enough is queued.
+         * A producer with a full (or half-full) ring signals wake. */
+        size_t pending = pending_locked(g);
+        if (g->held) {
+            if (!g->stop) wait_ns_locked(g, MERGE_RETRY_NS);
+        } else if (!g->stop && g->flush_req == g->flush_done && pending == 0) {
+            /* Nothing queued: sleep until a producer sees idle.  The fence
+             * pairs with the one in push_ops, so either the producer sees
+             * idle or the re-check below sees its op. */
+            atomic_store_explicit(&g->idle, true, memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            if (pending_locked(g) == 0) pthread_cond_wait(&g->wake, &g->lock);
+            atomic_store_explicit(&g->idle, false, memory_order_relaxed);
+        } else if (!g->stop && g->flush_req == g->flush_done && pending < MERGE_MIN) {
+            wait_ns_locked(g, MERGE_INTERVAL_NS);
+        }
+        if (g->stop) break;
+
+        uint64_t req = g->flush_req;
+        bool     more = true;      /* a retried batch predates what is queued */
+        size_t   n = g->held ? g->held : drain_locked(g, &more);
+        pthread_mutex_unlock(&g->lock);
+
+        bool merged = n == 0 || merge_batch(g, g->batch, n);
+        if (!merged) atomic_fetch_add_explicit(&g->merge_retries, 1, memory_order_relaxed);
+
+        pthread_mutex_lock(&g->lock);
+        g->held = merged ? 0 : n;
+        if (merged && !more && g->flush_done != req) {
+            g->flush_done = req;
+            pthread_cond_broadcast(&g->done);
+        }
+    }
+    pthread_mutex_unlock(&g->lock);
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------
+ * Lifecycle
+ * ---------------------------------------------------------------------- */
+
+GraphStore *gs_create(unsigned flags)
+{
+    GraphStore *g = calloc(1, sizeof(GraphStore));
+    if (!g) return NULL;
+    g->flags = flags;
+    atomic_init(&g->idle, false);
+
+    g->cur = calloc(1, sizeof(GSView));
+    if (!g->cur) goto fail;
+    atomic_init(&g->cur->refs, 1);
+    g->cur->track_in = (flags & GS_TRACK_IN) != 0;
+
+    pthread_mutex_init(&g->view_lock, NULL);
+    pthread_mutex_init(&g->lock, NULL);
+    pthread_cond_init(&g->wake, NULL);
+    pthread_cond_init(&g->done, NULL);
+
+    if (pthread_create(&g->merger, NULL, merger_main, g) != 0) {
+        pthread_cond_destroy(&g->done);
+        pthread_cond_destroy(&g->wake);
+        pthread_mutex_destroy(&g->lock);
+        pthread_mutex_destroy(&g->view_lock);
+        goto fail;
+    }
+    return g;
+
+fail:
+    free(g->cur);
+    free(g);
+    return NULL;
+}
+
+void gs_destroy(GraphStore *g)
+{
+    if (!g) return;
+
+    pthread_mutex_lock(&g->lock);
+    g->stop = true;
+    pthread_cond_signal(&g->wake);
+    pthread_mutex_unlock(&g->lock);
+    pthread_join(g->merger, NULL);
+
+    GSProducer *p = g->producers;
+    while (p) {
+        GSProducer *next = p->next;
+        free(p->ring);
+        free(p);
+        p = next;
+    }
+
+    gs_view_release(g->cur);
+    free(g->batch);
+    free(g->scratch);
+    pthread_cond_destroy(&g->done);
+    pthread_cond_destroy(&g->wake);
+    pthread_mutex_destroy(&g->lock);
+    pthread_mutex_destroy(&g->view_lock);
+    free(g);
+}
+
+/* -------------------------------------------------------------------------
+ * Ingestion
+ * ---------------------------------------------------------------------- */
+
+GSProducer *gs_producer_open(GraphStore *g, size_t ring_capacity)
+{
+    if (!g) return NULL;
+
+    size_t cap = MIN_RING;
+    size_t want = ring_capacity ? ring_capacity : DEFAULT_RING;
+    while (cap < want && cap < MAX_BATCH) cap <<= 1;
+
+    GSProducer *p = calloc(1, sizeof(GSProducer));
+    if (!p) return NULL;
+    p->ring = malloc(cap * sizeof(Op));
+    if (!p->ring) { free(p); return NULL; }
+    p->g   = g;
+    p->cap = cap;
+    atomic_init(&p->head, 0);
+    atomic_init(&p->tail, 0);
+    atomic_init(&p->closed, false);
+
+    pthread_mutex_lock(&g->lock);
+    p->next = g->producers;
+    g->producers = p;
+    g->nproducers++;
+    pthread_mutex_unlock(&g->lock);
+    return p;
+}
+
+void gs_producer_close(GSProducer *p)
+{
+    if (!p) return;
+    GraphStore *g = p->g;
+    pthread_mutex_lock(&g->lock);
+    atomic_store_explicit(&p->closed, true, memory_order_release);
+    pthread_cond_signal(&g->wake);
+    pthread_mutex_unlock(&g->lock);
+}
+
+static void wake_merger(GraphStore *g)
+{
+    pthread_mutex_lock(&g->lock);
+    pthread_cond_signal(&g->wake);
+    pthread_mutex_unlock(&g->lock);
+}
+
+/* Free slots available to the producer at head, waiting for at least one. */
+static size_t ring_space(GSProducer *p, size_t head)
+{
+    size_t space = p->cap - (head - p->cached_tail);
+    if (space) return space;
+
+    for (;;) {
+        p->cached_tail = atomic_load_explicit(&p->tail, memory_order_acquire);
+        space = p->cap - (head - p->cached_tail);
+        if (space) return space;
+        wake_merger(p->g);
+        sched_yield();
+    }
+}
+
+static void push_ops(GSProducer *p, const uint32_t *src, const uint32_t *dst,
+                     const float *w, uint32_t kind, size_t n)
+{
+    size_t head = atomic_load_explicit(&p->head, memory_order_relaxed);
+    size_t half = p->cap / 2;
+
+    while (n) {
+        size_t space = ring_space(p, head);
+        size_t run   = space < n ? space : n;
+        for (size_t i = 0; i < run; i++) {
+            Op *op = &p->ring[(head + i) & (p->cap - 1)];
+            op->src  = src[i];
+            op->dst  = dst[i];
+            op->w    = w ? w[i] : 1.0f;
+            op->kind = kind;
+        }
+        size_t before = head - p->cached_tail;
+        head += run;
+        atomic_store_explicit(&p->head, head, memory_order_release);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&p->g->idle, memory_order_relaxed) ||
+            (before < half && head - p->cached_tail >= half)) {
+            wake_merger(p->g);
+        }
+
+        src += run; dst += run; if (w) w += run;
+        n -= run;
+    }
+}
+
+void gs_push_insert(GSProducer *p, uint32_t src, uint32_t dst, float weight)
+{
+    if (p) push_ops(p, &src, &dst, &weight, OP_INSERT, 1);
+}
+
+void gs_push_delete(GSProducer *p, uint32_t src, uint32_t dst)
+{
+    if (p) push_ops(p, &src, &dst, NULL, OP_DELETE, 1);
+}
+
+void gs_push_inserts(GSProducer *p, const uint32_t *src, const uint32_t *dst,
+                     const float *weights, size_t n)
+{
+    if (p && src && dst) push_ops(p, src, dst, weights, OP_INSERT, n);
+}
+
+void gs_push_deletes(GSProducer *p, const uint32_t *src, const uint32_t *dst, size_t n)
+{
+    if (p && src && dst) push_ops(p, src, dst, NULL, OP_DELETE, n);
+}
+
+uint64_t gs_flush(GraphStore *g)
+{
+    if (!g) return 0;
+
+    pthread_mutex_lock(&g->lock);
+    uint64_t ticket = ++g->flush_req;
+    pthread_cond_signal(&g->wake);
+    while (g->flush_done < ticket && !g->stop) pthread_cond_wait(&g->done, &g->lock);
+    pthread_mutex_unlock(&g->lock);
+
+    pthread_mutex_lock(&g->view_lock);
+    uint64_t version = g->cur->version;
+    pthread_mutex_unlock(&g->view_lock);
+    return version;
+}
+
+GSStats gs_stats(GraphStore *g)
+{
+    GSStats s;
+    memset(&s, 0, sizeof(s));
+    if (!g) return s;
+
+    GSView *v = gs_view_acquire(g);
+    s.version = v->version;
+    s.nodes   = v->nodes;
+    s.edges   = v->edges;
+    gs_view_release(v);
+
+    s.merges        = atomic_load_explicit(&g->merges, memory_order_relaxed);
+    s.ops_applied   = atomic_load_explicit(&g->ops_applied, memory_order_relaxed);
+    s.merge_retries = atomic_load_explicit(&g->merge_retries, memory_order_relaxed);
+
+    pthread_mutex_lock(&g->lock);
+    s.pending   = pending_locked(g) + g->held;
+    s.producers = g->nproducers;
+    pthread_mutex_unlock(&g->lock);
+    return s;
+}
@@ -0,0 +1,148 @@
+/**
+ * graph_store.h — Dynamic adjacency store with batched ingestion
+ *
+ * Topology only: nodes are dense uint32 IDs (the caller interns its own
+ * names), edges carry a float weight.  Properties stay in SimpleDB.
+ *
+ * Writes:
+ *   Each writer thread opens a GSProducer and pushes edge inserts and
+ *   deletes into it.  A producer is a single-producer / single-consumer
+ *   ring: pushes are plain stores plus one release store, no lock.
+ *   A background merger drains all rings, radix-sorts the batch by
+ *   (source, destination) and folds it into the adjacency lists, then
+ *   publishes the result as a new version.  Within one producer later
+ *   operations on the same edge win; across producers order is the
+ *   merger's drain order.  gs_flush is the barrier: once it returns,
+ *   everything pushed before the call is visible.
+ *
+ * Reads:
+ *   gs_view_acquire pins the current version.  A version is immutable;
+ *   the merger builds the next one copy-on-write (only 1024-node chunks
+ *   and adjacency lists touched by the batch are copied) and swaps the
+ *   root pointer, so readers never wait for a merge and never see half a
+ *   batch.  Neighbor arrays returned by a view stay valid until it is
+ *   released.
+ *
+ * Thread-safety: producers are single-threaded handles; every other call
+ * may be made from any thread.
+ */
+
+#ifndef GRAPH_STORE_H
+#define GRAPH_STORE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct GraphStore GraphStore;
+typedef struct GSProducer GSProducer;
+
+/** Immutable version of the graph (see gs_view_acquire). */
+typedef struct GSView GSView;
+
+/** gs_create flags. */
+#define GS_TRACK_IN  0x1u   /* also maintain in-adjacency (reverse) lists */
+
+typedef struct {
+    uint64_t version;        /* published versions so far               */
+    size_t   nodes;          /* highest node ID seen + 1                */
+    size_t   edges;
+    size_t   merges;         /* merge batches applied                   */
+    size_t   ops_applied;    /* inserts + deletes folded in             */
+    size_t   pending;        /* pushed but not yet merged               */
+    size_t   producers;      /* open producers                          */
+    size_t   merge_retries;  /* merges that ran out of memory (retried) */
+} GSStats;
+
+/* -------------------------------------------------------------------------
+ * Lifecycle
+ * ---------------------------------------------------------------------- */
+
+/** Create an empty graph and start its merger thread.  NULL on failure. */
+GraphStore *gs_create(unsigned flags);
+
+/**
+ * Stop the merger and free the graph.  Pending operations are discarded and
+ * producers must be closed first; views still held stay valid until released.
+ */
+void gs_destroy(GraphStore *g);
+
+/* -------------------------------------------------------------------------
+ * Ingestion
+ * ---------------------------------------------------------------------- */
+
+/** Open a producer (ring of ring_capacity ops, 0 = default).  NULL on failure. */
+GSProducer *gs_producer_open(GraphStore *g, size_t ring_capacity);
+
+/** Close a producer; operations already pushed are still merged. */
+void gs_producer_close(GSProducer *p);
+
+/** Queue an edge insert (or weight update).  Blocks only while the ring is full. */
+void gs_push_insert(GSProducer *p, uint32_t src, uint32_t dst, float weight);
+
+/** Queue an edge delete (a no-op if the edge does not exist when merged). */
+void gs_push_delete(GSProducer *p, uint32_t src, uint32_t dst);
+
+/**
+ * Queue n inserts (weights may be NULL for 1.0).  Equivalent to n calls of
+ * gs_push_insert but publishes to the merger once per ring segment.
+ */
+void gs_push_inserts(GSProducer *p, const uint32_t *src, const uint32_t *dst,
+                     const float *weights, size_t n);
+
+/** Queue n deletes. */
+void gs_push_deletes(GSProducer *p, const uint32_t *src, const uint32_t *dst, size_t n);
+
+/**
+ * Barrier: wait until every operation pushed (by any producer) before the
+ * call has been merged and published.  Returns the version that includes
+ * them.  A merge that runs out of memory keeps its batch and is retried, so
+ * under memory pressure this waits (see GSStats.merge_retries) rather than
+ * returning before the operations are visible.
+ */
+uint64_t gs_flush(GraphStore *g);
+
+GSStats gs_stats(GraphStore *g);
+
+/* -------------------------------------------------------------------------
+ * Views
+ * ---------------------------------------------------------------------- */
+
+/** Pin the latest published version.  Never waits for a merge. */
+GSView *gs_view_acquire(GraphStore *g);
+
+void gs_view_release(GSView *v);
+
+uint64_t gs_view_version(const GSView *v);
+
+/** Highest node ID + 1 in this version. */
+size_t gs_view_node_count(const GSView *v);
+
+size_t gs_view_edge_count(const GSView *v);
+
+/**
+ * Out-neighbors of node, sorted by ID.  *dst / *weights (either may be
+ * NULL) point into the view.  Returns the out-degree (0 for unknown IDs).
+ */
+size_t gs_view_neighbors(const GSView *v, uint32_t node,
+                         const uint32_t **dst, const float **weights);
+
+/** In-neighbors (GS_TRACK_IN only; otherwise returns 0). */
+size_t gs_view_in_neighbors(const GSView *v, uint32_t node,
+                            const uint32_t **src, const float **weights);
+
+/** True if src -> dst exists; its weight goes to *weight (may be NULL). */
+bool gs_view_has_edge(const GSView *v, uint32_t src, uint32_t dst, float *weight);
+
+/** True if the view keeps in-adjacency lists. */
+bool gs_view_tracks_in(const GSView *v);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GRAPH_STORE_H */
@@ -0,0 +1,1040 @@
+/**
+ * hdt.c — Compressed, queryable RDF files (HDT-style)
+ *
+ * The writer interns terms in a hash table, recording whether each is
+ * used as a subject, predicate or object.  Saving sorts every dictionary
+ * section, renumbers and sorts the triples (dropping duplicates), and
+ * writes the sections one after another behind a fixed header of section
+ * offsets.  Every section is 8-byte aligned and starts with 64-bit
+ * counts, so the reader uses the mapping directly.
+ *
+ * hdt_open checks the header and the shape of every section (counts
+ * against sizes) without reading the data.  Values read from the data
+ * are checked where they are used as positions, so a damaged file ends a
+ * lookup or an iteration early instead of reading outside the mapping.
+ *
+ * Bitmaps keep the number of set bits before every 512-bit superblock:
+ * rank is one lookup plus at most 8 popcounts, select a binary search
+ * over the superblocks plus a scan of one.
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L  /* mmap, fstat */
+#endif
+
+#include "hdt.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * File layout
+ * ---------------------------------------------------------------------- */
+
+#define MAGIC        "SDBHDT01"
+#define BYTE_ORDER   UINT64_C(0x0102030405060708)   /* rejects foreign-endian files */
+#define BLOCK        16u        /* terms per front-coded block */
+#define SUPER_WORDS  8u         /* bitmap words per rank sample */
+
+enum {
+    SEC_SHARED, SEC_SUBJECTS, SEC_PREDICATES, SEC_OBJECTS,
+    SEC_BP, SEC_SP, SEC_BO, SEC_SO,
+    SEC_PRED_OFF, SEC_PRED_PAIRS,       /* pair positions by predicate */
+    SEC_OBJ_OFF, SEC_OBJ_TRIPLES,       /* triple positions by object */
+    N_SECTIONS
+};
+
+enum {
+    H_MAGIC, H_BYTE_ORDER, H_TRIPLES, H_PAIRS,
+    H_SHARED, H_SUBJECTS, H_PREDICATES, H_OBJECTS,
+    H_FIELDS                            /* then (offset, size) per section */
+};
+
+#define HEADER_WORDS  (H_FIELDS + 2u * N_SECTIONS)
+
+/*
+ * Sections (all counts uint64):
+ *   dictionary  count, n_blocks, data_len, max_len, block_off[n_blocks],
+ *               data: per block, varint length + bytes of the first term,
+ *               then varint prefix, varint suffix length + suffix bytes
+ *   packed      n, width, n_words, words
+ *   bitmap      n_bits, n_ones, n_words, n_super, words, ranks[n_super + 1]
+ */
+
+/* -------------------------------------------------------------------------
+ * Shared helpers
+ * ---------------------------------------------------------------------- */
+
+static int term_cmp(const uint8_t *a, uint64_t a_len, const uint8_t *b, uint64_t b_len)
+{
+    size_t n = a_len < b_len ? a_len : b_len;
+    int c = n ? memcmp(a, b, n) : 0;
+    if (c) return c;
+    return (a_len > b_len) - (a_len < b_len);
+}
+
+static unsigned bit_width(uint64_t max)
+{
+    return max ? 64u - (unsigned)__builtin_clzll(max) : 0u;
+}
+
+/* -------------------------------------------------------------------------
+ * Writer
+ * ---------------------------------------------------------------------- */
+
+#define ROLE_S  1u
+#define ROLE_P  2u
+#define ROLE_O  4u
+
+typedef struct {
+    uint64_t off;               /* into bytes */
+    uint32_t len;
+    uint8_t  roles;             /* ROLE_* bits, set on save */
+} Term;
+
+struct HDTWriter {
+    char     *bytes;
+    size_t    n_bytes, cap_bytes;
+    Term     *terms;
+    size_t    n_terms, cap_terms;
+    uint32_t *slots;            /* term index + 1, 0 = empty */
+    size_t    n_slots;          /* power of two */
+    uint32_t *triples;          /* term indices, 3 per triple */
+    size_t    n_triples, cap_triples;
+};
+
+typedef struct { uint32_t s, p, o; } Triple;
+
+typedef struct {
+    const uint8_t *s;
+    uint32_t       len;
+    uint32_t       term;
+} TermRef;
+
+typedef struct {
+    uint8_t *p;
+    size_t   len, cap;
+} Buf;
+
+static bool grow(void **p, size_t *cap, size_t need, size_t size)
+{
+    if (need <= *cap) return true;
+    size_t n = *cap ? *cap : 16;
+    while (n < need) n *= 2;
+    void *q = realloc(*p, n * size);
+    if (!q) return false;
+    *p = q;
+    *cap = n;
+    return true;
+}
+
+static uint64_t fnv1a(const char *s, size_t len)
+{
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)s[i];
+        hash *= UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+HDTWriter *hdt_writer_create(void)
+{
+    HDTWriter *w = calloc(1, sizeof *w);
+    if (!w) return NULL;
+    w->n_slots = 1024;
+    w->slots = calloc(w->n_slots, sizeof *w->slots);
+    if (!w->slots) {
+        free(w);
+        return NULL;
+    }
+    return w;
+}
+
+void hdt_writer_free(HDTWriter *w)
+{
+    if (!w) return;
+    free(w->bytes);
+    free(w->terms);
+    free(w->slots);
+    free(w->triples);
+    free(w);
+}
+
+static bool rehash(HDTWriter *w)
+{
+    size_t n = w->n_slots * 2, mask = n - 1;
+    uint32_t *slots = calloc(n, sizeof *slots);
+    if (!slots) return false;
+    for (size_t t = 0; t < w->n_terms; t++) {
+        size_t i = (size_t)fnv1a(w->bytes + w->terms[t].off, w->terms[t].len) & mask;
+        while (slots[i]) i = (i + 1) & mask;
+        slots[i] = (uint32_t)t + 1;
+    }
+    free(w->slots);
+    w->slots = slots;
+    w->n_slots = n;
+    return true;
+}
+
+/* Index of a term, added if new; UINT32_MAX on failure. */
+static uint32_t intern(HDTWriter *w, const char *s, size_t len)
+{
+    if (len > UINT32_MAX) return UINT32_MAX;
+    size_t mask = w->n_slots - 1, i = (size_t)fnv1a(s, len) & mask;
+    for (; w->slots[i]; i = (i + 1) & mask) {
+        Term *t = &w->terms[w->slots[i] - 1];
+        if (t->len == len && (len == 0 || memcmp(w->bytes + t->off, s, len) == 0))
+            return w->slots[i] - 1;
+    }
+    if (w->n_terms >= UINT32_MAX - 1) return UINT32_MAX;
+    if ((w->n_terms + 1) * 10 > w->n_slots * 7) {
+        if (!rehash(w)) return UINT32_MAX;
+        mask = w->n_slots - 1;
+        for (i = (size_t)fnv1a(s, len) & mask; w->slots[i]; i = (i + 1) & mask) {}
+    }
+    if (!grow((void **)&w->terms, &w->cap_terms, w->n_terms + 1, sizeof *w->terms) ||
+        !grow((void **)&w->bytes, &w->cap_bytes, w->n_bytes + len, 1))
+        return UINT32_MAX;
+    if (len) memcpy(w->bytes + w->n_bytes, s, len);
+    uint32_t idx = (uint32_t)w->n_terms++;
+    w->terms[idx] = (Term){ w->n_bytes, (uint32_t)len, 0 };
+    w->n_bytes += len;
+    w->slots[i] = idx + 1;
+    return idx;
+}
+
+bool hdt_writer_add(HDTWriter *w, const char *s, size_t s_len, const char *p, size_t p_len,
+                    const char *o, size_t o_len)
+{
+    if (!w || (!s && s_len) || (!p && p_len) || (!o && o_len)) return false;
+    if (!grow((void **)&w->triples, &w->cap_triples, 3 * (w->n_triples + 1), sizeof *w->triples))
+        return false;
+    uint32_t ids[3] = {
+        intern(w, s, s_len),
+        intern(w, p, p_len),
+        intern(w, o, o_len),
+    };
+    if (ids[0] == UINT32_MAX || ids[1] == UINT32_MAX || ids[2] == UINT32_MAX) return false;
+    memcpy(w->triples + 3 * w->n_triples++, ids, sizeof ids);
+    return true;
+}
+
+/* ---- Section encoders ---- */
+
+static bool buf_put(Buf *b, const void *src, size_t n)
+{
+    if (!grow((void **)&b->p, &b->cap, b->len + n, 1)) return false;
+    if (n) memcpy(b->p + b->len, src, n);
+    b->len += n;
+    return true;
+}
+
+static bool buf_u64(Buf *b, uint64_t v)
+{
+    return buf_put(b, &v, sizeof v);
+}
+
+static bool buf_varint(Buf *b, uint64_t v)
+{
+    uint8_t tmp[10];
+    size_t n = 0;
+    do {
+        tmp[n++] = (uint8_t)((v & 0x7f) | (v > 0x7f ? 0x80 : 0));
+        v >>= 7;
+    } while (v);
+    return buf_put(b, tmp, n);
+}
+
+static bool buf_align(Buf *b)
+{
+    static const uint8_t zero[8];
+    return buf_put(b, zero, (8 - b->len % 8) % 8);
+}
+
+static bool put_dictionary(Buf *b, const TermRef *terms, size_t n)
+{
+    size_t n_blocks = (n + BLOCK - 1) / BLOCK;
+    uint64_t *block_off = malloc((n_blocks + 1) * sizeof *block_off);
+    Buf data = { 0 };
+    uint64_t max_len = 0;
+    bool ok = false;
+    if (!block_off) goto out;
+
+    for (size_t i = 0; i < n; i++) {
+        const TermRef *t = &terms[i];
+        if (t->len > max_len) max_len = t->len;
+        if (i % BLOCK == 0) {
+            block_off[i / BLOCK] = data.len;
+            if (!buf_varint(&data, t->len) || !buf_put(&data, t->s, t->len)) goto out;
+            continue;
+        }
+        const TermRef *prev = &terms[i - 1];
+        uint32_t shared = 0, limit = t->len < prev->len ? t->len : prev->len;
+        while (shared < limit && t->s[shared] == prev->s[shared]) shared++;
+        if (!buf_varint(&data, shared) || !buf_varint(&data, t->len - shared) ||
+            !buf_put(&data, t->s + shared, t->len - shared))
+            goto out;
+    }
+
+    ok = buf_u64(b, n) && buf_u64(b, n_blocks) && buf_u64(b, data.len) && buf_u64(b, max_len) &&
+         buf_put(b, block_off, n_blocks * sizeof *block_off) &&
+         buf_put(b, data.p, data.len) && buf_align(b);
+out:
+    free(block_off);
+    free(data.p);
+    return ok;
+}
+
+static bool put_packed(Buf *b, const uint64_t *v, size_t n)
+{
+    uint64_t max = 0;
+    for (size_t i = 0; i < n; i++)
+        if (v[i] > max) max = v[i];
+    unsigned width = bit_width(max);
+    size_t n_words = (size_t)(((uint64_t)n * width + 63) / 64);
+    uint64_t *words = calloc(n_words + 1, sizeof *words);
+    if (!words) return false;
+    for (size_t i = 0; i < n && width; i++) {
+        uint64_t bit = (uint64_t)i * width;
+        size_t k = (size_t)(bit >> 6);
+        unsigned off = (unsigned)(bit & 63);
+        words[k] |= v[i] << off;
+        if (off + width > 64) words[k + 1] |= v[i] >> (64 - off);
+    }
+    bool ok = buf_u64(b, n) && buf_u64(b, width) && buf_u64(b, n_words) &&
+              buf_put(b, words, n_words * sizeof *words);
+    free(words);
+    return ok;
+}
+
+static bool put_bitmap(Buf *b, const uint64_t *words, uint64_t n_bits)
+{
+    uint64_t n_words = (n_bits + 63) / 64, n_super = (n_words + SUPER_WORDS - 1) / SUPER_WORDS;
+    uint64_t *ranks = malloc((n_super + 1) * sizeof *ranks), ones = 0;
+    if (!ranks) return false;
+    for (uint64_t i = 0; i < n_words; i++) {
+        if (i % SUPER_WORDS == 0) ranks[i / SUPER_WORDS] = ones;
+        ones += (uint64_t)__builtin_popcountll(words[i]);
+    }
+    ranks[n_super] = ones;
+    bool ok = buf_u64(b, n_bits) && buf_u64(b, ones) && buf_u64(b, n_words) &&
+              buf_u64(b, n_super) && buf_put(b, words, n_words * sizeof *words) &&
+              buf_put(b, ranks, (n_super + 1) * sizeof *ranks);
+    free(ranks);
+    return ok;
+}
+
+/* ---- Save ---- */
+
+static int ref_cmp(const void *a, const void *b)
+{
+    const TermRef *x = a, *y = b;
+    return term_cmp(x->s, x->len, y->s, y->len);
+}
+
+static int triple_cmp(const void *a, const void *b)
+{
+    const Triple *x = a, *y = b;
+    if (x->s != y->s) return x->s < y->s ? -1 : 1;
+    if (x->p != y->p) return x->p < y->p ? -1 : 1;
+    return (x->o > y->o) - (x->o < y->o);
+}
+
+/* Whether a term with these roles belongs to a dictionary section. */
+static bool in_section(unsigned sec, uint8_t roles)
+{
+    bool s = roles & ROLE_S, o = roles & ROLE_O;
+    switch (sec) {
+    case SEC_SHARED:     return s && o;
+    case SEC_SUBJECTS:   return s && !o;
+    case SEC_PREDICATES: return roles & ROLE_P;
+    default:             return o && !s;
+    }
+}
+
+/* Offsets of n groups (n + 1 entries) and the positions in each, in order. */
+static bool group_by(const uint64_t *key, size_t n, size_t n_groups,
+                     uint64_t **off_out, uint64_t **pos_out)
+{
+    uint64_t *off = calloc(n_groups + 2, sizeof *off);
+    uint64_t *pos = malloc((n + 1) * sizeof *pos);
+    if (!off || !pos) {
+        free(off);
+        free(pos);
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) off[key[i] + 2]++;
+    for (size_t g = 2; g < n_groups + 2; g++) off[g] += off[g - 1];
+    for (size_t i = 0; i < n; i++) pos[off[key[i] + 1]++] = i;
+    *off_out = off;
+    *pos_out = pos;
+    return true;
+}
+
+bool hdt_writer_save(HDTWriter *w, const char *path, HDTStats *stats)
+{
+    if (!w || !path) return false;
+    bool ok = false;
+    Buf sec[N_SECTIONS] = { { 0 } };
+    size_t nt = w->n_terms, n = w->n_triples, n_pairs = 0;
+    uint64_t counts[4] = { 0 };
+    TermRef *refs = malloc((nt + 1) * sizeof *refs);
+    uint32_t *sid = malloc((nt + 1) * sizeof *sid);
+    uint32_t *pid = malloc((nt + 1) * sizeof *pid);
+    uint32_t *oid = malloc((nt + 1) * sizeof *oid);
+    Triple *t = malloc((n + 1) * sizeof *t);
+    uint64_t *sp = NULL, *so = NULL, *bp = NULL, *bo = NULL, *off = NULL, *pos = NULL;
+    char *tmp = NULL;
+    FILE *f = NULL;
+    if (!refs || !sid || !pid || !oid || !t) goto out;
+
+    /* Dictionary: sort each section and number the terms */
+    for (size_t i = 0; i < nt; i++) w->terms[i].roles = 0;
+    for (size_t i = 0; i < n; i++) {
+        w->terms[w->triples[3 * i]].roles |= ROLE_S;
+        w->terms[w->triples[3 * i + 1]].roles |= ROLE_P;
+        w->terms[w->triples[3 * i + 2]].roles |= ROLE_O;
+    }
+    for (unsigned k = SEC_SHARED; k <= SEC_OBJECTS; k++) {
+        size_t m = 0;
+        for (size_t i = 0; i < nt; i++)
+            if (in_section(k, w->terms[i].roles))
+                refs[m++] = (TermRef){ (const uint8_t *)w->bytes + w->terms[i].off,
+                                       w->terms[i].len, (uint32_t)i };
+        qsort(refs, m, sizeof *refs, ref_cmp);
+        uint32_t base = k == SEC_SUBJECTS || k == SEC_OBJECTS ? (uint32_t)counts[SEC_SHARED] : 0;
+        for (size_t i = 0; i < m; i++) {
+            uint32_t id = base + (uint32_t)i;
+            if (k == SEC_SHARED) sid[refs[i].term] = oid[refs[i].term] = id;
+            else if (k == SEC_SUBJECTS) sid[refs[i].term] = id;
+            else if (k == SEC_PREDICATES) pid[refs[i].term] = id;
+            else oid[refs[i].term] = id;
+        }
+        counts[k] = m;
+        if (!put_dictionary(&sec[k], refs, m)) goto out;
+    }
+    uint64_t n_objects = counts[SEC_SHARED] + counts[SEC_OBJECTS];
+
+    /* Triples: renumber, sort, drop duplicates */
+    for (size_t i = 0; i < n; i++)
+        t[i] = (Triple){ sid[w->triples[3 * i]], pid[w->triples[3 * i + 1]],
+                         oid[w->triples[3 * i + 2]] };
+    qsort(t, n, sizeof *t, triple_cmp);
+    size_t m = 0;
+    for (size_t i = 0; i < n; i++)
+        if (m == 0 || triple_cmp(&t[m - 1], &t[i]) != 0) t[m++] = t[i];
+    n = m;
+
+    /* Bitmap triples */
+    sp = malloc((n + 1) * sizeof *sp);
+    so = malloc((n + 1) * sizeof *so);
+    bp = calloc(n / 64 + 1, sizeof *bp);
+    bo = calloc(n / 64 + 1, sizeof *bo);
+    if (!sp || !so || !bp || !bo) goto out;
+    for (size_t i = 0; i < n; i++) {
+        if (i == 0 || t[i].s != t[i - 1].s || t[i].p != t[i - 1].p) sp[n_pairs++] = t[i].p;
+        so[i] = t[i].o;
+        bool last_s = i + 1 == n || t[i + 1].s != t[i].s;
+        if (last_s || t[i + 1].p != t[i].p) bo[i / 64] |= UINT64_C(1) << (i % 64);
+        if (last_s) bp[(n_pairs - 1) / 64] |= UINT64_C(1) << ((n_pairs - 1) % 64);
+    }
+    if (!put_bitmap(&sec[SEC_BP], bp, n_pairs) || !put_packed(&sec[SEC_SP], sp, n_pairs) ||
+        !put_bitmap(&sec[SEC_BO], bo, n) || !put_packed(&sec[SEC_SO], so, n))
+        goto out;
+
+    /* Indexes for patterns without a subject */
+    if (!group_by(sp, n_pairs, counts[SEC_PREDICATES], &off, &pos)) goto out;
+    ok = put_packed(&sec[SEC_PRED_OFF], off, counts[SEC_PREDICATES] + 1) &&
+         put_packed(&sec[SEC_PRED_PAIRS], pos, n_pairs);
+    free(off);
+    free(pos);
+    off = pos = NULL;
+    if (!ok || !group_by(so, n, n_objects, &off, &pos)) goto out;
+    ok = put_packed(&sec[SEC_OBJ_OFF], off, n_objects + 1) &&
+         put_packed(&sec[SEC_OBJ_TRIPLES], pos, n);
+    if (!ok) goto out;
+    ok = false;
+
+    /* Header, then the sections in order */
+    uint64_t header[HEADER_WORDS] = { 0 };
+    memcpy(&header[H_MAGIC], MAGIC, 8);
+    header[H_BYTE_ORDER] = BYTE_ORDER;
+    header[H_TRIPLES] = n;
+    header[H_PAIRS] = n_pairs;
+    header[H_SHARED] = counts[SEC_SHARED];
+    header[H_SUBJECTS] = counts[SEC_SUBJECTS];
+    header[H_PREDICATES] = counts[SEC_PREDICATES];
+    header[H_OBJECTS] = counts[SEC_OBJECTS];
+    uint64_t at = sizeof header, dictionary = 0;
+    for (unsigned k = 0; k < N_SECTIONS; k++) {
+        header[H_FIELDS + 2 * k] = at;
+        header[H_FIELDS + 2 * k + 1] = sec[k].len;
+        at += sec[k].len;
+        if (k <= SEC_OBJECTS) dictionary += sec[k].len;
+    }
+
+    size_t path_len = strlen(path);
+    tmp = malloc(path_len + 5);
+    if (!tmp) goto out;
+    memcpy(tmp, path, path_len);
+    memcpy(tmp + path_len, ".tmp", 5);
+    f = fopen(tmp, "wb");
+    if (!f) goto out;
+    bool written = fwrite(header, sizeof header, 1, f) == 1;
+    for (unsigned k = 0; k < N_SECTIONS && written; k++)
+        written = sec[k].len == 0 || fwrite(sec[k].p, sec[k].len, 1, f) == 1;
+    int closed = fclose(f);
+    f = NULL;
+    if (!written || closed != 0 || rename(tmp, path) != 0) {
+        remove(tmp);
+        goto out;
+    }
+
+    if (stats)
+        *stats = (HDTStats){ n, counts[SEC_SHARED], counts[SEC_SUBJECTS],
+                             counts[SEC_PREDICATES], counts[SEC_OBJECTS], at, dictionary };
+    ok = true;
+out:
+    if (f) {
+        fclose(f);
+        remove(tmp);
+    }
+    for (unsigned k = 0; k < N_SECTIONS; k++) free(sec[k].p);
+    free(refs);
+    free(sid);
+    free(pid);
+    free(oid);
+    free(t);
+    free(sp);
+    free(so);
+    free(bp);
+    free(bo);
+    free(off);
+    free(pos);
+    free(tmp);
+    return ok;
+}
+
+/* -------------------------------------------------------------------------
+ * Reader
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    uint64_t        count, n_blocks, data_len, max_len;
+    const uint64_t *block_off;
+    const uint8_t  *data;
+} Dict;
+
+typedef struct {
+    uint64_t        n, width;
+    const uint64_t *words;
+} Packed;
+
+typedef struct {
+    uint64_t        n_bits, n_ones, n_words, n_super;
+    const uint64_t *words;
+    const uint64_t *ranks;      /* n_super + 1 */
+} Bitmap;
+
+struct HDT {
+    void     *map;
+    size_t    size;
+    uint64_t  n_triples, n_pairs, n_subjects, n_objects;
+    uint64_t  max_len;          /* longest term */
+    uint64_t  dictionary_bytes;
+    Dict      dict[4];          /* SEC_SHARED .. SEC_OBJECTS */
+    Bitmap    bp, bo;
+    Packed    sp, so, pred_off, pred_pairs, obj_off, obj_triples;
+};
+
+enum { WALK_PAIRS, WALK_PREDICATE, WALK_OBJECT };
+
+struct HDTIter {
+    const HDT *h;
+    int        mode;
+    uint64_t   s, p, o;         /* pattern */
+    uint64_t   i, end;          /* pairs (WALK_PAIRS) or index entries to visit */
+    uint64_t   next_start;      /* first triple of pair i (WALK_PAIRS) */
+    uint64_t   cur_s, cur_p;    /* current pair */
+    uint64_t   t, t_end;        /* its triples still to emit */
+};
+
+/* ---- Section views ---- */
+
+static const uint64_t *section(const HDT *h, unsigned k, uint64_t *words)
+{
+    const uint64_t *header = h->map;
+    uint64_t off = header[H_FIELDS + 2 * k], size = header[H_FIELDS + 2 * k + 1];
+    if (off % 8 || size % 8 || off < HEADER_WORDS * 8 || off > h->size || size > h->size - off)
+        return NULL;
+    *words = size / 8;
+    return (const uint64_t *)((const uint8_t *)h->map + off);
+}
+
+static bool load_dict(const HDT *h, unsigned k, Dict *d)
+{
+    uint64_t words;
+    const uint64_t *w = section(h, k, &words);
+    if (!w || words < 4) return false;
+    *d = (Dict){ w[0], w[1], w[2], w[3], w + 4, NULL };
+    if (d->n_blocks != d->count / BLOCK + (d->count % BLOCK != 0) || d->n_blocks > words - 4 ||
+        d->data_len > (words - 4 - d->n_blocks) * 8 || d->max_len > d->data_len)
+        return false;
+    d->data = (const uint8_t *)(w + 4 + d->n_blocks);
+    return true;
+}
+
+static bool load_packed(const HDT *h, unsigned k, uint64_t n, Packed *a)
+{
+    uint64_t words;
+    const uint64_t *w = section(h, k, &words);
+    if (!w || words < 3) return false;
+    *a = (Packed){ w[0], w[1], w + 3 };
+    uint64_t n_words = w[2];
+    return a->n == n && a->width <= 64 && n_words <= words - 3 &&
+           (a->width == 0 || a->n <= n_words * 64 / a->width);
+}
+
+static bool load_bitmap(const HDT *h, unsigned k, uint64_t n_bits, uint64_t n_ones, Bitmap *b)
+{
+    uint64_t words;
+    const uint64_t *w = section(h, k, &words);
+    if (!w || words < 4) return false;
+    *b = (Bitmap){ w[0], w[1], w[2], w[3], w + 4, NULL };
+    if (b->n_bits != n_bits || b->n_ones != n_ones || b->n_words != n_bits / 64 + (n_bits % 64 != 0) ||
+        b->n_super != b->n_words / SUPER_WORDS + (b->n_words % SUPER_WORDS != 0) ||
+        b->n_words + b->n_super + 1 > words - 4)
+        return false;
+    b->ranks = b->words + b->n_words;
+    return b->ranks[b->n_super] == n_ones;
+}
+
+static inline uint64_t packed_get(const Packed *a, uint64_t i)
+{
+    if (a->width == 0) return 0;
+    uint64_t bit = i * a->width, k = bit >> 6;
+    unsigned off = (unsigned)(bit & 63);
+    uint64_t v = a->words[k] >> off;
+    if (off + a->width > 64) v |= a->words[k + 1] << (64 - off);
+    return a->width == 64 ? v : v & ((UINT64_C(1) << a->width) - 1);
+}
+
+/* Set bits in [0, i), i <= n_bits. */
+static uint64_t rank1(const Bitmap *b, uint64_t i)
+{
+    uint64_t k = i >> 6, sb = k / SUPER_WORDS, r = b->ranks[sb];
+    for (uint64_t j = sb * SUPER_WORDS; j < k; j++) r += (uint64_t)__builtin_popcountll(b->words[j]);
+    if (i & 63) r += (uint64_t)__builtin_popcountll(b->words[k] & ((UINT64_C(1) << (i & 63)) - 1));
+    return r;
+}
+
+/* Position of set bit k (from 0), or n_bits if there is none. */
+static uint64_t select1(const Bitmap *b, uint64_t k)
+{
+    if (k >= b->n_ones) return b->n_bits;
+    uint64_t lo = 0, hi = b->n_super;
+    while (hi - lo > 1) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (b->ranks[mid] <= k) lo = mid;
+        else hi = mid;
+    }
+    uint64_t r = b->ranks[lo];
+    for (uint64_t j = lo * SUPER_WORDS; j < b->n_words && j < (lo + 1) * SUPER_WORDS; j++) {
+        uint64_t x = b->words[j], c = (uint64_t)__builtin_popcountll(x);
+        if (r + c > k) {
+            for (; r < k; r++) x &= x - 1;
+            return j * 64 + (uint64_t)__builtin_ctzll(x);
+        }
+        r += c;
+    }
+    return b->n_bits;
+}
+
+/* Items [begin, end) of group g in a bitmap of group ends; false if damaged. */
+static bool group_range(const Bitmap *b, uint64_t g, uint64_t *begin, uint64_t *end)
+{
+    *begin = g == 0 ? 0 : select1(b, g - 1) + 1;
+    *end = select1(b, g) + 1;
+    return *end <= b->n_bits && *begin <= *end;
+}
+
+HDT *hdt_open(const char *path)
+{
+    if (!path) return NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    HDT *h = calloc(1, sizeof *h);
+    struct stat st;
+    if (!h || fstat(fd, &st) != 0 || st.st_size < (off_t)(HEADER_WORDS * 8)) goto fail;
+    h->size = (size_t)st.st_size;
+    h->map = mmap(NULL, h->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (h->map == MAP_FAILED) {
+        h->map = NULL;
+        goto fail;
+    }
+    close(fd);
+    fd = -1;
+
+    const uint64_t *header = h->map;
+    if (memcmp(header, MAGIC, 8) != 0 || header[H_BYTE_ORDER] != BYTE_ORDER) goto fail;
+    h->n_triples = header[H_TRIPLES];
+    h->n_pairs = header[H_PAIRS];
+    for (unsigned k = SEC_SHARED; k <= SEC_OBJECTS; k++) {
+        if (!load_dict(h, k, &h->dict[k]) || h->dict[k].count != header[H_SHARED + k]) goto fail;
+        if (h->dict[k].max_len > h->max_len) h->max_len = h->dict[k].max_len;
+        h->dictionary_bytes += header[H_FIELDS + 2 * k + 1];
+    }
+    uint64_t shared = h->dict[SEC_SHARED].count, n_predicates = h->dict[SEC_PREDICATES].count;
+    h->n_subjects = shared + h->dict[SEC_SUBJECTS].count;
+    h->n_objects = shared + h->dict[SEC_OBJECTS].count;
+    if (h->n_subjects < shared || h->n_objects < shared || h->n_pairs > h->n_triples ||
+        n_predicates == UINT64_MAX || h->n_objects == UINT64_MAX)
+        goto fail;
+    if (!load_bitmap(h, SEC_BP, h->n_pairs, h->n_subjects, &h->bp) ||
+        !load_packed(h, SEC_SP, h->n_pairs, &h->sp) ||
+        !load_bitmap(h, SEC_BO, h->n_triples, h->n_pairs, &h->bo) ||
+        !load_packed(h, SEC_SO, h->n_triples, &h->so) ||
+        !load_packed(h, SEC_PRED_OFF, n_predicates + 1, &h->pred_off) ||
+        !load_packed(h, SEC_PRED_PAIRS, h->n_pairs, &h->pred_pairs) ||
+        !load_packed(h, SEC_OBJ_OFF, h->n_objects + 1, &h->obj_off) ||
+        !load_packed(h, SEC_OBJ_TRIPLES, h->n_triples, &h->obj_triples))
+        goto fail;
+    return h;
+fail:
+    if (fd >= 0) close(fd);
+    hdt_close(h);
+    return NULL;
+}
+
+void hdt_close(HDT *h)
+{
+    if (!h) return;
+    if (h->map) munmap(h->map, h->size);
+    free(h);
+}
+
+void hdt_stats(const HDT *h, HDTStats *stats)
+{
+    if (!h || !stats) return;
+    *stats = (HDTStats){ h->n_triples, h->dict[SEC_SHARED].count, h->dict[SEC_SUBJECTS].count,
+                         h->dict[SEC_PREDICATES].count, h->dict[SEC_OBJECTS].count,
+                         h->size, h->dictionary_bytes };
+}
+
+uint64_t hdt_term_count(const HDT *h, unsigned role)
+{
+    if (!h) return 0;
+    switch (role) {
+    case HDT_SUBJECT:   return h->n_subjects;
+    case HDT_PREDICATE: return h->dict[SEC_PREDICATES].count;
+    case HDT_OBJECT:    return h->n_objects;
+    default:            return 0;
+    }
+}
+
+/* ---- Dictionary ---- */
+
+/*
+ * Decode the terms of one block in order into buf (max_len bytes):
+ * cursor_next returns the next term's length, or -1 when the data is
+ * damaged.
+ */
+typedef struct {
+    const Dict *d;
+    uint64_t    pos, len, index;
+    uint8_t    *buf;
+} Cursor;
+
+static bool get_varint(const Dict *d, uint64_t *pos, uint64_t *out)
+{
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (*pos >= d->data_len) return false;
+        uint8_t c = d->data[(*pos)++];
+        v |= (uint64_t)(c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void cursor_init(Cursor *c, const Dict *d, uint64_t block, uint8_t *buf)
+{
+    *c = (Cursor){ d, d->block_off[block], 0, 0, buf };
+}
+
+static int64_t cursor_next(Cursor *c)
+{
+    const Dict *d = c->d;
+    uint64_t prefix = 0, suffix;
+    if (c->index++ > 0 && !get_varint(d, &c->pos, &prefix)) return -1;
+    if (!get_varint(d, &c->pos, &suffix)) return -1;
+    if (prefix > c->len || suffix > d->max_len - prefix || suffix > d->data_len - c->pos)
+        return -1;
+    memcpy(c->buf + prefix, d->data + c->pos, suffix);
+    c->pos += suffix;
+    c->len = prefix + suffix;
+    return (int64_t)c->len;
+}
+
+/* Length of term i of a section, decoded into buf; -1 if damaged. */
+static int64_t dict_term(const Dict *d, uint64_t i, uint8_t *buf)
+{
+    Cursor c;
+    cursor_init(&c, d, i / BLOCK, buf);
+    int64_t len = -1;
+    for (uint64_t k = 0; k <= i % BLOCK; k++)
+        if ((len = cursor_next(&c)) < 0) break;
+    return len;
+}
+
+/* Index of a term in a section, or -1. */
+static int64_t dict_find(const Dict *d, const uint8_t *term, size_t len, uint8_t *buf)
+{
+    if (d->count == 0) return -1;
+    uint64_t lo = 0, hi = d->n_blocks;
+    while (hi - lo > 1) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        int64_t n = dict_term(d, mid * BLOCK, buf);
+        if (n < 0) return -1;
+        if (term_cmp(buf, (uint64_t)n, term, len) <= 0) lo = mid;
+        else hi = mid;
+    }
+    Cursor c;
+    cursor_init(&c, d, lo, buf);
+    for (uint64_t i = lo * BLOCK; i < d->count && i < (lo + 1) * BLOCK; i++) {
+        int64_t n = cursor_next(&c);
+        if (n < 0) return -1;
+        int cmp = term_cmp(buf, (uint64_t)n, term, len);
+        if (cmp == 0) return (int64_t)i;
+        if (cmp > 0) break;
+    }
+    return -1;
+}
+
+/* Section and index within it of an ID in a role; false if out of range. */
+static bool locate(const HDT *h, unsigned role, uint64_t id, const Dict **d, uint64_t *i)
+{
+    uint64_t shared = h->dict[SEC_SHARED].count;
+    if (role == HDT_PREDICATE) {
+        *d = &h->dict[SEC_PREDICATES];
+        *i = id;
+    } else if (role == HDT_SUBJECT || role == HDT_OBJECT) {
+        *d = id < shared ? &h->dict[SEC_SHARED]
+                         : &h->dict[role == HDT_SUBJECT ? SEC_SUBJECTS : SEC_OBJECTS];
+        *i = id < shared ? id : id - shared;
+    } else {
+        return false;
+    }
+    return *i < (*d)->count;
+}
+
+int64_t hdt_lookup(const HDT *h, unsigned role, const char *term, size_t len)
+{
+    if (!h || (!term && len) || role > HDT_OBJECT) return -1;
+    uint8_t *buf = malloc(h->max_len + 1);
+    if (!buf) return -1;
+    const uint8_t *t = (const uint8_t *)term;
+    int64_t id;
+    if (role == HDT_PREDICATE) {
+        id = dict_find(&h->dict[SEC_PREDICATES], t, len, buf);
+    } else if ((id = dict_find(&h->dict[SEC_SHARED], t, len, buf)) < 0) {
+        id = dict_find(&h->dict[role == HDT_SUBJECT ? SEC_SUBJECTS : SEC_OBJECTS], t, len, buf);
+        if (id >= 0) id += (int64_t)h->dict[SEC_SHARED].count;
+    }
+    free(buf);
+    return id;
+}
+
+int64_t hdt_terms(const HDT *h, unsigned role, const uint64_t *ids, size_t n,
+                  char *buf, size_t cap, uint64_t *ends)
+{
+    if (!h || (!ids && n) || (!buf && cap) || (!ends && n)) return -1;
+    uint8_t *scratch = malloc(h->max_len + 1);
+    if (!scratch) return -1;
+    uint64_t total = 0;
+    int64_t result = -1;
+    for (size_t k = 0; k < n; k++) {
+        const Dict *d;
+        uint64_t i;
+        if (!locate(h, role, ids[k], &d, &i)) goto out;
+        int64_t len = dict_term(d, i, scratch);
+        if (len < 0) goto out;
+        if (total + (uint64_t)len <= cap) memcpy(buf + total, scratch, (size_t)len);
+        total += (uint64_t)len;
+        ends[k] = total;
+    }
+    result = (int64_t)total;
+out:
+    free(scratch);
+    return result;
+}
+
+/* ---- Triple patterns ---- */
+
+/* First position in [lo, hi) of a packed array with a value >= v (sorted range). */
+static uint64_t lower_bound(const Packed *a, uint64_t lo, uint64_t hi, uint64_t v)
+{
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (packed_get(a, mid) < v) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* Narrow a sorted range to the entries equal to v (at most one: no duplicates). */
+static void narrow(const Packed *a, uint64_t *lo, uint64_t *hi, uint64_t v)
+{
+    uint64_t at = lower_bound(a, *lo, *hi, v);
+    if (at < *hi && packed_get(a, at) == v) {
+        *lo = at;
+        *hi = at + 1;
+    } else {
+        *lo = *hi;
+    }
+}
+
+static bool in_range(const HDT *h, uint64_t s, uint64_t p, uint64_t o)
+{
+    return (s == HDT_ANY || s < h->n_subjects) &&
+           (p == HDT_ANY || p < h->dict[SEC_PREDICATES].count) &&
+           (o == HDT_ANY || o < h->n_objects);
+}
+
+/* Offsets [begin, end) of group g in an index; empty if damaged. */
+static void index_range(const Packed *off, uint64_t g, uint64_t limit,
+                        uint64_t *begin, uint64_t *end)
+{
+    *begin = packed_get(off, g);
+    *end = packed_get(off, g + 1);
+    if (*end > limit || *begin > *end) *begin = *end = 0;
+}
+
+HDTIter *hdt_search(const HDT *h, uint64_t s, uint64_t p, uint64_t o)
+{
+    if (!h || !in_range(h, s, p, o)) return NULL;
+    HDTIter *it = calloc(1, sizeof *it);
+    if (!it) return NULL;
+    *it = (HDTIter){ .h = h, .s = s, .p = p, .o = o };
+
+    if (s != HDT_ANY) {
+        it->mode = WALK_PAIRS;
+        if (!group_range(&h->bp, s, &it->i, &it->end)) it->i = it->end;
+        if (p != HDT_ANY) narrow(&h->sp, &it->i, &it->end, p);
+        uint64_t unused;
+        if (it->i < it->end && !group_range(&h->bo, it->i, &it->next_start, &unused))
+            it->i = it->end;
+    } else if (o != HDT_ANY) {
+        it->mode = WALK_OBJECT;
+        index_range(&h->obj_off, o, h->n_triples, &it->i, &it->end);
+    } else if (p != HDT_ANY) {
+        it->mode = WALK_PREDICATE;
+        index_range(&h->pred_off, p, h->n_pairs, &it->i, &it->end);
+    } else {
+        it->mode = WALK_PAIRS;
+        it->end = h->n_pairs;
+    }
+    return it;
+}
+
+void hdt_iter_free(HDTIter *it)
+{
+    free(it);
+}
+
+/* Move to the next pair with matching triples; false at the end. */
+static bool next_pair(HDTIter *it)
+{
+    const HDT *h = it->h;
+    while (it->i < it->end) {
+        uint64_t j, begin;
+        if (it->mode == WALK_PREDICATE) {
+            j = packed_get(&h->pred_pairs, it->i++);
+            if (j >= h->n_pairs || !group_range(&h->bo, j, &begin, &it->t_end)) break;
+        } else {
+            j = it->i++;
+            begin = it->next_start;
+            it->t_end = select1(&h->bo, j) + 1;
+            if (it->t_end > h->n_triples || begin > it->t_end) break;
+            it->next_start = it->t_end;
+        }
+        it->t = begin;
+        it->cur_p = packed_get(&h->sp, j);
+        it->cur_s = it->s != HDT_ANY ? it->s : rank1(&h->bp, j);
+        if (it->o != HDT_ANY) narrow(&h->so, &it->t, &it->t_end, it->o);
+        if (it->t < it->t_end) return true;
+    }
+    it->i = it->end;
+    it->t = it->t_end = 0;
+    return false;
+}
+
+size_t hdt_iter_next(HDTIter *it, uint64_t *out, size_t cap)
+{
+    if (!it) return 0;
+    const HDT *h = it->h;
+    size_t n = 0;
+    while (n < cap) {
+        uint64_t s, p, o;
+        if (it->mode == WALK_OBJECT) {
+            if (it->i >= it->end) break;
+            uint64_t t = packed_get(&h->obj_triples, it->i++);
+            uint64_t j = t < h->n_triples ? rank1(&h->bo, t) : h->n_pairs;
+            if (j >= h->n_pairs) {
+                it->i = it->end;
+                break;
+            }
+            p = packed_get(&h->sp, j);
+            if (it->p != HDT_ANY && p != it->p) continue;
+            s = rank1(&h->bp, j);
+            o = it->o;
+        } else {
+            if (it->t == it->t_end && !next_pair(it)) break;
+            s = it->cur_s;
+            p = it->cur_p;
+            o = packed_get(&h->so, it->t++);
+        }
+        if (out) {
+            out[3 * n] = s;
+            out[3 * n + 1] = p;
+            out[3 * n + 2] = o;
+        }
+        n++;
+    }
+    return n;
+}
+
+int64_t hdt_count(const HDT *h, uint64_t s, uint64_t p, uint64_t o)
+{
+    if (!h || !in_range(h, s, p, o)) return -1;
+    if (s == HDT_ANY && p == HDT_ANY) {
+        if (o == HDT_ANY) return (int64_t)h->n_triples;
+        uint64_t begin, end;
+        index_range(&h->obj_off, o, h->n_triples, &begin, &end);
+        return (int64_t)(end - begin);
+    }
+    if (s != HDT_ANY && p == HDT_ANY && o == HDT_ANY) {
+        uint64_t first, last, begin, end, unused;
+        if (!group_range(&h->bp, s, &first, &last) || first == last ||
+            !group_range(&h->bo, first, &begin, &unused) ||
+            !group_range(&h->bo, last - 1, &unused, &end))
+            return 0;
+        return (int64_t)(end - begin);
+    }
+    HDTIter *it = hdt_search(h, s, p, o);
+    if (!it) return -1;
+    int64_t total = 0;
+    size_t n;
+    while ((n = hdt_iter_next(it, NULL, SIZE_MAX)) > 0) total += (int64_t)n;
+    hdt_iter_free(it);
+    return total;
+}
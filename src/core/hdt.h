@@ -0,0 +1,135 @@
+/**
+ * hdt.h — Compressed, queryable RDF files (HDT-style)
+ *
+ * An HDT file holds a set of RDF triples in a form that is queried in
+ * place: hdt_open maps it read-only and every lookup works on the mapped
+ * bytes, so opening a file of any size is instant and pages are only
+ * read as queries touch them.
+ *
+ * Terms are opaque byte strings; the Python adapter stores them in
+ * N-Triples syntax (<iri>, "literal"@lang, "literal"^^<type>, _:blank).
+ *
+ * Dictionary:
+ *   Terms are split into four sorted sections, as in HDT: shared (used
+ *   as both subject and object), subject-only, predicates and
+ *   object-only.  Subjects are numbered shared first, then subject-only
+ *   (0 .. subjects-1), objects shared first, then object-only, so a
+ *   shared term has the same subject and object ID.  Each section is
+ *   front-coded in blocks of 16: a block's first term is stored whole,
+ *   the rest as (length of the prefix shared with the previous term,
+ *   suffix).  Term -> ID is a binary search over block heads and a scan
+ *   of one block; ID -> term decodes at most 16 terms.
+ *
+ * Triples (bitmap triples, sorted S, P, O):
+ *   Sp   predicate of every distinct (subject, predicate) pair
+ *   Bp   bit per pair, set on the last pair of each subject
+ *   So   object of every triple
+ *   Bo   bit per triple, set on the last triple of each pair
+ *   Integer arrays are bit-packed at the width of their largest value;
+ *   bitmaps carry a rank directory so the n-th set bit and the number of
+ *   set bits before a position are found without scanning.  Two stored
+ *   indexes answer patterns without a bound subject: pair positions
+ *   grouped by predicate, and triple positions grouped by object.
+ *
+ * Patterns (any of S, P, O bound, HDT_ANY otherwise) are answered by
+ *   S bound     the subject's pairs (binary search for P) and their
+ *               objects (binary search for O)
+ *   P only      the predicate index
+ *   O bound     the object index, filtered by P if bound
+ *   none        a scan of all triples
+ * Results come in S, P, O order, except by object index order (S, P)
+ * for patterns answered by the object index.
+ *
+ * Files are little-endian.  An open HDT is immutable: queries may run
+ * from any thread (each iterator from one thread at a time).
+ */
+
+#ifndef HDT_H
+#define HDT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HDT_ANY  UINT64_MAX     /* unbound pattern position */
+
+/** Term roles for hdt_lookup / hdt_terms. */
+#define HDT_SUBJECT    0u
+#define HDT_PREDICATE  1u
+#define HDT_OBJECT     2u
+
+typedef struct HDTWriter HDTWriter;
+typedef struct HDT       HDT;
+typedef struct HDTIter   HDTIter;
+
+typedef struct {
+    uint64_t triples;           /* distinct triples */
+    uint64_t shared;            /* terms by dictionary section */
+    uint64_t subjects;          /* subject-only */
+    uint64_t predicates;
+    uint64_t objects;           /* object-only */
+    uint64_t bytes;             /* file size */
+    uint64_t dictionary_bytes;  /* of which dictionary sections */
+} HDTStats;
+
+/* ---- Writing ---------------------------------------------------------- */
+
+HDTWriter *hdt_writer_create(void);
+void       hdt_writer_free(HDTWriter *w);
+
+/** Add a triple (terms are len bytes, not NUL-terminated); duplicates are dropped on save. */
+bool hdt_writer_add(HDTWriter *w, const char *s, size_t s_len, const char *p, size_t p_len,
+                    const char *o, size_t o_len);
+
+/** Write the file (replacing path).  Returns false on I/O errors or lack of memory. */
+bool hdt_writer_save(HDTWriter *w, const char *path, HDTStats *stats);
+
+/* ---- Reading ---------------------------------------------------------- */
+
+/** Map a file; NULL if it cannot be read or is not a valid HDT file. */
+HDT *hdt_open(const char *path);
+void hdt_close(HDT *h);
+
+void hdt_stats(const HDT *h, HDTStats *stats);
+
+/** Number of distinct subjects, predicates or objects. */
+uint64_t hdt_term_count(const HDT *h, unsigned role);
+
+/** ID of a term in a role, or -1 if it never appears in that role. */
+int64_t hdt_lookup(const HDT *h, unsigned role, const char *term, size_t len);
+
+/**
+ * Decode n IDs of one role into buf, back to back; ends[i] receives the
+ * end offset of term i.  Returns the bytes needed (nothing past cap is
+ * written, so retry with a larger buffer if the result exceeds cap), or
+ * -1 for an ID out of range.
+ */
+int64_t hdt_terms(const HDT *h, unsigned role, const uint64_t *ids, size_t n,
+                  char *buf, size_t cap, uint64_t *ends);
+
+/**
+ * Iterate the triples matching a pattern (IDs or HDT_ANY).  Returns
+ * NULL for an ID out of range or lack of memory.
+ */
+HDTIter *hdt_search(const HDT *h, uint64_t s, uint64_t p, uint64_t o);
+void     hdt_iter_free(HDTIter *it);
+
+/**
+ * Next matches as (s, p, o) ID triples: writes up to cap triples to out
+ * (3 * cap entries) and returns how many; 0 at the end.  With out NULL
+ * the matches are skipped instead (for offsets).
+ */
+size_t hdt_iter_next(HDTIter *it, uint64_t *out, size_t cap);
+
+/** Number of triples matching a pattern (-1 for an ID out of range). */
+int64_t hdt_count(const HDT *h, uint64_t s, uint64_t p, uint64_t o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDT_H */
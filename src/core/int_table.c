@@ -0,0 +1,72 @@
+/**
+ * int_table.c — Instantiates the int_table variants
+ *
+ * Shared, type-independent pieces live here; the per-variant code comes
+ * from int_table_tmpl.h, included once per variant.
+ *
+ * Control byte encoding (one per slot, 16-slot groups):
+ *   0x00..0x7F  full, low 7 bits of the hash tag
+ *   0x80        empty
+ *   0xFE        deleted (tombstone)
+ * Bit 7 set therefore means "no key here".
+ */
+
+#include "int_table.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define IT_GROUP         16u
+#define IT_MIN_CAPACITY  32u    /* two groups: keeps shift below 64 */
+#define IT_BATCH         16u    /* get_many prefetch distance       */
+#define IT_CTRL_EMPTY    ((uint8_t)0x80)
+#define IT_CTRL_DELETED  ((uint8_t)0xFE)
+
+/* Fibonacci hashing: the top bits select the group. */
+static inline uint64_t it_hash(uint64_t key)
+{
+    return key * UINT64_C(0x9E3779B97F4A7C15);
+}
+
+/* Tag from bits below the group index, so it adds information. */
+static inline uint8_t it_tag(uint64_t h)
+{
+    return (uint8_t)((h >> 24) & 0x7F);
+}
+
+/* Bitmask of the slots in a group whose control byte equals c. */
+static inline uint32_t it_match(const uint8_t *group, uint8_t c)
+{
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)c)));
+#else
+    uint32_t m = 0;
+    for (unsigned i = 0; i < IT_GROUP; i++) {
+        if (group[i] == c) m |= 1u << i;
+    }
+    return m;
+#endif
+}
+
+/* True if n elements of elem bytes can be allocated without overflow. */
+static inline bool it_fits(uint64_t n, size_t elem)
+{
+    return n != 0 && n <= SIZE_MAX / elem;
+}
+
+#define IT_TYPE   IntMap32
+#define IT_PREFIX imap32
+#define IT_KEY    uint32_t
+#define IT_VALUE  uint32_t
+#include "int_table_tmpl.h"
+
+#define IT_TYPE   IntMap64
+#define IT_PREFIX imap64
+#define IT_KEY    uint64_t
+#define IT_VALUE  uint64_t
+#include "int_table_tmpl.h"
@@ -0,0 +1,70 @@
+/**
+ * int_table.h — Integer-keyed hash tables for dense ID maps
+ *
+ * A family of tables mapping fixed-width integer keys to fixed-size
+ * values (slot numbers, offsets), generated from one template
+ * (int_table_tmpl.h) so every variant shares the same code:
+ *
+ *   IntMap32  uint32_t -> uint32_t   prefix imap32_   (ID -> slot)
+ *   IntMap64  uint64_t -> uint64_t   prefix imap64_   (ID -> offset)
+ *
+ * Two layouts behind one API:
+ *   - hashed: open addressing over 16-slot groups with a multiplicative
+ *     (Fibonacci) hash and one control byte per slot holding a 7-bit hash
+ *     tag; a probe compares a whole group's tags at once (SSE2 when
+ *     available).  Keys are stored inline, never behind a pointer.
+ *   - dense:  a direct-mapped value array indexed by the key plus a
+ *     presence bitmap, for keys known to lie in [0, max_key].
+ *
+ * Every key value is valid (there is no reserved sentinel).  Tables are
+ * not thread-safe; callers serialize access.
+ */
+
+#ifndef INT_TABLE_H
+#define INT_TABLE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Declare one table variant.
+ *
+ *   T  table type name      P  function prefix
+ *   K  unsigned key type    V  value type (any trivially copyable type)
+ */
+#define INT_TABLE_DECLARE(T, P, K, V)                                        \
+    typedef struct T T;                                                      \
+    /* Hashed table presized for capacity_hint keys.  NULL on failure. */    \
+    T     *P##_create(size_t capacity_hint);                                 \
+    /* Direct-mapped table for keys in [0, max_key].  NULL on failure. */    \
+    T     *P##_create_dense(K max_key);                                      \
+    void   P##_destroy(T *t);                                                \
+    /* Insert or update.  False on allocation failure, or out-of-range   */ \
+    /* key for a dense table.                                            */ \
+    bool   P##_put(T *t, K key, V value);                                    \
+    /* Copy value for key into *out.  Returns false if absent. */            \
+    bool   P##_get(const T *t, K key, V *out);                               \
+    bool   P##_remove(T *t, K key);                                          \
+    void   P##_clear(T *t);                                                  \
+    size_t P##_count(const T *t);                                            \
+    size_t P##_capacity(const T *t);                                         \
+    bool   P##_is_dense(const T *t);                                         \
+    /* Look up n keys, hashing and prefetching ahead of the probes.      */ \
+    /* values[i] is written only for hits; found (may be NULL) gets 1/0. */ \
+    /* Returns the number of hits.                                       */ \
+    size_t P##_get_many(const T *t, const K *keys, size_t n,                 \
+                        V *values, uint8_t *found);
+
+INT_TABLE_DECLARE(IntMap32, imap32, uint32_t, uint32_t)
+INT_TABLE_DECLARE(IntMap64, imap64, uint64_t, uint64_t)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INT_TABLE_H */
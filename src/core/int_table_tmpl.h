@@ -0,0 +1,327 @@
+/**
+ * int_table_tmpl.h — Template body for one int_table variant
+ *
+ * Include once per variant from int_table.c after defining:
+ *
+ *   IT_TYPE    table struct name     (IntMap32)
+ *   IT_PREFIX  function prefix       (imap32)
+ *   IT_KEY     unsigned key type     (uint32_t)
+ *   IT_VALUE   value type            (uint32_t)
+ *
+ * Relies on the shared helpers defined in int_table.c (it_hash, it_tag,
+ * it_match, it_fits, IT_GROUP, IT_CTRL_*).  The parameters are undefined at the end
+ * so the next variant can be instantiated.
+ */
+
+#define IT_CAT_(a, b) a##_##b
+#define IT_CAT(a, b)  IT_CAT_(a, b)
+#define IT_FN(name)   IT_CAT(IT_PREFIX, name)
+
+struct IT_TYPE {
+    uint8_t  *ctrl;        /* hashed: tag per slot; dense: presence bitmap */
+    IT_KEY   *keys;        /* hashed only                                  */
+    IT_VALUE *vals;
+    size_t    capacity;    /* slots (power of two) or max_key + 1          */
+    size_t    count;
+    size_t    tombstones;  /* hashed: deleted control bytes                */
+    unsigned  shift;       /* hashed: 64 - log2(groups)                    */
+    bool      dense;
+};
+
+/* -------------------------------------------------------------------------
+ * Hashed layout
+ * ---------------------------------------------------------------------- */
+
+static bool IT_FN(alloc_slots)(IT_TYPE *t, size_t capacity)
+{
+    uint8_t  *ctrl = malloc(capacity);
+    IT_KEY   *keys = malloc(capacity * sizeof(IT_KEY));
+    IT_VALUE *vals = malloc(capacity * sizeof(IT_VALUE));
+    if (!ctrl || !keys || !vals) {
+        free(ctrl); free(keys); free(vals);
+        return false;
+    }
+    memset(ctrl, IT_CTRL_EMPTY, capacity);
+
+    size_t groups = capacity / IT_GROUP;
+    unsigned log2 = 0;
+    while (((size_t)1 << log2) < groups) log2++;
+
+    t->ctrl       = ctrl;
+    t->keys       = keys;
+    t->vals       = vals;
+    t->capacity   = capacity;
+    t->count      = 0;
+    t->tombstones = 0;
+    t->shift      = 64u - log2;
+    return true;
+}
+
+/* Slot holding key, or SIZE_MAX. */
+static inline size_t IT_FN(find)(const IT_TYPE *t, IT_KEY key, uint64_t h)
+{
+    size_t  mask = t->capacity / IT_GROUP - 1;
+    size_t  g    = (size_t)(h >> t->shift);
+    uint8_t tag  = it_tag(h);
+
+    for (size_t probe = 1; probe <= mask + 1; probe++) {
+        const uint8_t *ctrl = t->ctrl + g * IT_GROUP;
+        for (uint32_t m = it_match(ctrl, tag); m; m &= m - 1) {
+            size_t slot = g * IT_GROUP + (size_t)__builtin_ctz(m);
+            if (t->keys[slot] == key) return slot;
+        }
+        if (it_match(ctrl, IT_CTRL_EMPTY)) return SIZE_MAX;
+        g = (g + probe) & mask;   /* triangular: visits every group */
+    }
+    return SIZE_MAX;
+}
+
+/* First empty or deleted slot on key's probe sequence (key known absent). */
+static size_t IT_FN(free_slot)(const IT_TYPE *t, uint64_t h)
+{
+    size_t mask = t->capacity / IT_GROUP - 1;
+    size_t g    = (size_t)(h >> t->shift);
+
+    for (size_t probe = 1; ; probe++) {
+        const uint8_t *ctrl = t->ctrl + g * IT_GROUP;
+        uint32_t m = it_match(ctrl, IT_CTRL_EMPTY) | it_match(ctrl, IT_CTRL_DELETED);
+        if (m) return g * IT_GROUP + (size_t)__builtin_ctz(m);
+        g = (g + probe) & mask;
+    }
+}
+
+static bool IT_FN(rehash)(IT_TYPE *t, size_t new_cap)
+{
+    IT_TYPE old = *t;
+    if (!IT_FN(alloc_slots)(t, new_cap)) {
+        *t = old;
+        return false;
+    }
+
+    for (size_t i = 0; i < old.capacity; i++) {
+        if (old.ctrl[i] & 0x80) continue;   /* empty or deleted */
+        uint64_t h    = it_hash(old.keys[i]);
+        size_t   slot = IT_FN(free_slot)(t, h);
+        t->ctrl[slot] = it_tag(h);
+        t->keys[slot] = old.keys[i];
+        t->vals[slot] = old.vals[i];
+        t->count++;
+    }
+
+    free(old.ctrl);
+    free(old.keys);
+    free(old.vals);
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Dense layout
+ * ---------------------------------------------------------------------- */
+
+static inline bool IT_FN(dense_has)(const IT_TYPE *t, IT_KEY key)
+{
+    return (uint64_t)key < t->capacity && (t->ctrl[key >> 3] >> (key & 7)) & 1u;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+IT_TYPE *IT_FN(create)(size_t capacity_hint)
+{
+    IT_TYPE *t = calloc(1, sizeof(IT_TYPE));
+    if (!t) return NULL;
+
+    /* Keep load <= 7/8 for the hinted size */
+    size_t capacity = IT_MIN_CAPACITY;
+    while (capacity - capacity / 8 < capacity_hint && capacity <= SIZE_MAX / 4) {
+        capacity *= 2;
+    }
+
+    if (!IT_FN(alloc_slots)(t, capacity)) {
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+IT_TYPE *IT_FN(create_dense)(IT_KEY max_key)
+{
+    if (!it_fits((uint64_t)max_key + 1, sizeof(IT_VALUE))) return NULL;
+
+    IT_TYPE *t = calloc(1, sizeof(IT_TYPE));
+    if (!t) return NULL;
+
+    t->dense    = true;
+    t->capacity = (size_t)max_key + 1;
+    t->ctrl     = calloc((t->capacity + 7) / 8, 1);
+    t->vals     = malloc(t->capacity * sizeof(IT_VALUE));
+    if (!t->ctrl || !t->vals) {
+        free(t->ctrl);
+        free(t->vals);
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void IT_FN(destroy)(IT_TYPE *t)
+{
+    if (!t) return;
+    free(t->ctrl);
+    free(t->keys);
+    free(t->vals);
+    free(t);
+}
+
+bool IT_FN(put)(IT_TYPE *t, IT_KEY key, IT_VALUE value)
+{
+    if (!t) return false;
+
+    if (t->dense) {
+        if ((uint64_t)key >= t->capacity) return false;
+        if (!IT_FN(dense_has)(t, key)) {
+            t->ctrl[key >> 3] |= (uint8_t)(1u << (key & 7));
+            t->count++;
+        }
+        t->vals[key] = value;
+        return true;
+    }
+
+    uint64_t h    = it_hash(key);
+    size_t   slot = IT_FN(find)(t, key, h);
+    if (slot != SIZE_MAX) {
+        t->vals[slot] = value;
+        return true;
+    }
+
+    /* Grow when live + deleted slots would pass 7/8; if most of that is
+     * tombstones, rehash at the same size to reclaim them instead. */
+    if (t->count + t->tombstones + 1 > t->capacity - t->capacity / 8) {
+        size_t new_cap = t->count >= t->capacity / 16 * 7 ? t->capacity * 2 : t->capacity;
+        if (!IT_FN(rehash)(t, new_cap)) return false;
+    }
+
+    slot = IT_FN(free_slot)(t, h);
+    if (t->ctrl[slot] == IT_CTRL_DELETED) t->tombstones--;
+    t->ctrl[slot] = it_tag(h);
+    t->keys[slot] = key;
+    t->vals[slot] = value;
+    t->count++;
+    return true;
+}
+
+bool IT_FN(get)(const IT_TYPE *t, IT_KEY key, IT_VALUE *out)
+{
+    if (!t) return false;
+
+    if (t->dense) {
+        if (!IT_FN(dense_has)(t, key)) return false;
+        if (out) *out = t->vals[key];
+        return true;
+    }
+
+    size_t slot = IT_FN(find)(t, key, it_hash(key));
+    if (slot == SIZE_MAX) return false;
+    if (out) *out = t->vals[slot];
+    return true;
+}
+
+bool IT_FN(remove)(IT_TYPE *t, IT_KEY key)
+{
+    if (!t) return false;
+
+    if (t->dense) {
+        if (!IT_FN(dense_has)(t, key)) return false;
+        t->ctrl[key >> 3] &= (uint8_t)~(1u << (key & 7));
+        t->count--;
+        return true;
+    }
+
+    size_t slot = IT_FN(find)(t, key, it_hash(key));
+    if (slot == SIZE_MAX) return false;
+
+    /* A group that still has an empty slot never let a probe pass, so the
+     * slot can go straight back to empty instead of becoming a tombstone. */
+    const uint8_t *group = t->ctrl + (slot & ~(size_t)(IT_GROUP - 1));
+    if (it_match(group, IT_CTRL_EMPTY)) {
+        t->ctrl[slot] = IT_CTRL_EMPTY;
+    } else {
+        t->ctrl[slot] = IT_CTRL_DELETED;
+        t->tombstones++;
+    }
+    t->count--;
+    return true;
+}
+
+void IT_FN(clear)(IT_TYPE *t)
+{
+    if (!t) return;
+    if (t->dense) {
+        memset(t->ctrl, 0, (t->capacity + 7) / 8);
+    } else {
+        memset(t->ctrl, IT_CTRL_EMPTY, t->capacity);
+        t->tombstones = 0;
+    }
+    t->count = 0;
+}
+
+size_t IT_FN(count)(const IT_TYPE *t)
+{
+    return t ? t->count : 0;
+}
+
+size_t IT_FN(capacity)(const IT_TYPE *t)
+{
+    return t ? t->capacity : 0;
+}
+
+bool IT_FN(is_dense)(const IT_TYPE *t)
+{
+    return t && t->dense;
+}
+
+size_t IT_FN(get_many)(const IT_TYPE *t, const IT_KEY *keys, size_t n,
+                       IT_VALUE *values, uint8_t *found)
+{
+    if (!t || !keys || !values) return 0;
+    size_t hits = 0;
+
+    if (t->dense) {
+        for (size_t i = 0; i < n; i++) {
+            bool ok = IT_FN(dense_has)(t, keys[i]);
+            if (ok) { values[i] = t->vals[keys[i]]; hits++; }
+            if (found) found[i] = ok;
+        }
+        return hits;
+    }
+
+    /* Group prefetching: hash a batch and prefetch every target group's
+     * control bytes and keys, then probe while those lines arrive. */
+    uint64_t hash[IT_BATCH];
+    for (size_t base = 0; base < n; base += IT_BATCH) {
+        size_t m = n - base < IT_BATCH ? n - base : IT_BATCH;
+
+        for (size_t i = 0; i < m; i++) {
+            hash[i] = it_hash(keys[base + i]);
+            size_t g = (size_t)(hash[i] >> t->shift) * IT_GROUP;
+            __builtin_prefetch(t->ctrl + g);
+            __builtin_prefetch(t->keys + g);
+        }
+        for (size_t i = 0; i < m; i++) {
+            size_t slot = IT_FN(find)(t, keys[base + i], hash[i]);
+            bool   ok   = slot != SIZE_MAX;
+            if (ok) { values[base + i] = t->vals[slot]; hits++; }
+            if (found) found[base + i] = ok;
+        }
+    }
+    return hits;
+}
+
+#undef IT_FN
+#undef IT_CAT
+#undef IT_CAT_
+#undef IT_TYPE
+#undef IT_PREFIX
+#undef IT_KEY
+#undef IT_VALUE
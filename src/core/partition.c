@@ -0,0 +1,377 @@
+/**
+ * partition.c — Multilevel K-way graph partitioning
+ *
+ * Partitions live in two per-node arrays sized for level 0 (levels only
+ * shrink): the partition of level l + 1 is projected into the other array
+ * through ch_parents, refined, and the arrays swap roles.  Part sizes are
+ * kept incrementally across levels since projection does not change them.
+ */
+
+#include "partition.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    uint32_t  k;
+    uint64_t  limit;            /* largest part size allowed */
+    uint64_t *size;             /* k: level-0 nodes per part */
+    double   *conn;             /* k: edge weight from the node in hand */
+    uint8_t  *seen;             /* k: part is in touched */
+    uint32_t *touched;          /* k */
+    uint32_t *order;            /* visiting order of a level's nodes */
+    uint64_t  rng;
+    size_t    moves;
+} Refiner;
+
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static void shuffle(uint32_t *ids, size_t n, uint64_t *rng)
+{
+    for (size_t i = 0; i < n; i++)
+        ids[i] = (uint32_t)i;
+    for (size_t i = n; i > 1; i--) {
+        size_t j = splitmix64(rng) % i;
+        uint32_t t = ids[i - 1];
+        ids[i - 1] = ids[j];
+        ids[j] = t;
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Initial partition
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    double   conn;
+    uint32_t node;
+} Cand;
+
+/* Max-heap of candidates by connection to the growing part; entries go
+ * stale when a node's connection grows and are skipped when popped. */
+static void heap_push(Cand *heap, size_t *n, Cand c)
+{
+    size_t i = (*n)++;
+    while (i > 0 && heap[(i - 1) / 2].conn < c.conn) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = c;
+}
+
+static Cand heap_pop(Cand *heap, size_t *n)
+{
+    Cand top = heap[0], last = heap[--(*n)];
+    size_t i = 0;
+    for (;;) {
+        size_t c = 2 * i + 1;
+        if (c >= *n)
+            break;
+        if (c + 1 < *n && heap[c + 1].conn > heap[c].conn)
+            c++;
+        if (heap[c].conn <= last.conn)
+            break;
+        heap[i] = heap[c];
+        i = c;
+    }
+    heap[i] = last;
+    return top;
+}
+
+/* Grow the parts of a level one after another: each starts from a random
+ * unassigned cluster and takes the unassigned neighbour most strongly
+ * connected to it until it holds its share of total / k nodes (a new
+ * random start when its component runs out).  Returns false without
+ * memory. */
+static bool initial(const CHierarchy *h, size_t level, Refiner *r, uint32_t *part)
+{
+    size_t n = ch_level_size(h, level);
+    const uint32_t *sizes = ch_sizes(h, level);
+    size_t entries = n;
+    for (size_t u = 0; u < n; u++)
+        entries += ch_neighbors(h, level, (uint32_t)u, NULL, NULL);
+    double *conn = calloc(n ? n : 1, sizeof *conn);
+    Cand *heap = malloc((entries ? entries : 1) * sizeof *heap);
+    if (!conn || !heap) {
+        free(conn);
+        free(heap);
+        return false;
+    }
+
+    uint64_t total = 0;
+    for (size_t u = 0; u < n; u++) {
+        total += sizes[u];
+        part[u] = CH_NONE;
+    }
+
+    shuffle(r->order, n, &r->rng);
+    size_t next_start = 0, n_heap = 0;
+    uint32_t current = 0;
+    uint64_t dealt = 0;
+    for (;;) {
+        uint32_t u = CH_NONE;
+        while (n_heap && u == CH_NONE) {
+            Cand c = heap_pop(heap, &n_heap);
+            if (part[c.node] == CH_NONE && c.conn == conn[c.node])
+                u = c.node;
+        }
+        while (u == CH_NONE && next_start < n) {
+            uint32_t s = r->order[next_start++];
+            if (part[s] == CH_NONE && sizes[s])
+                u = s;
+        }
+        if (u == CH_NONE)
+            break;
+
+        part[u] = current;
+        dealt += sizes[u];
+        r->size[current] += sizes[u];
+        const uint32_t *ids;
+        const double *w;
+        size_t deg = ch_neighbors(h, level, u, &ids, &w);
+        for (size_t i = 0; i < deg; i++) {
+            uint32_t v = ids[i];
+            if (part[v] == CH_NONE) {
+                conn[v] += w[i];
+                heap_push(heap, &n_heap, (Cand){ conn[v], v });
+            }
+        }
+
+        /* Part boundaries at multiples of total / k keep every part
+         * within one cluster of its share. */
+        if (current + 1 < r->k && dealt * r->k >= (uint64_t)(current + 1) * total) {
+            current++;
+            for (size_t i = 0; i < n_heap; i++)
+                conn[heap[i].node] = 0.0;
+            n_heap = 0;
+        }
+    }
+    free(conn);
+    free(heap);
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Refinement
+ * ---------------------------------------------------------------------- */
+
+/* Better target for a node of size s: more gain, or the same gain and a
+ * smaller part (than its own, for the first candidate). */
+static bool better(const Refiner *r, uint32_t own, uint64_t s, uint32_t cand, double gain,
+                   uint32_t best, double best_gain)
+{
+    if (gain != best_gain)
+        return gain > best_gain;
+    if (best == own)
+        return r->size[cand] + s < r->size[own];
+    return r->size[cand] < r->size[best];
+}
+
+static void refine(const CHierarchy *h, size_t level, Refiner *r, uint32_t *part)
+{
+    size_t n = ch_level_size(h, level);
+    const uint32_t *sizes = ch_sizes(h, level);
+    shuffle(r->order, n, &r->rng);
+
+    for (int pass = 0; pass < PT_MAX_PASSES; pass++) {
+        size_t moved = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint32_t u = r->order[i];
+            uint64_t s = sizes[u];
+            if (!s)
+                continue;
+            uint32_t own = part[u];
+
+            const uint32_t *ids;
+            const double *w;
+            size_t deg = ch_neighbors(h, level, u, &ids, &w);
+            size_t n_touched = 0;
+            for (size_t j = 0; j < deg; j++) {
+                uint32_t p = part[ids[j]];
+                if (!r->seen[p]) {
+                    r->seen[p] = 1;
+                    r->touched[n_touched++] = p;
+                }
+                r->conn[p] += w[j];
+            }
+
+            double internal = r->conn[own];
+            uint32_t best = own;
+            double best_gain = 0.0;
+            for (size_t j = 0; j < n_touched; j++) {
+                uint32_t p = r->touched[j];
+                if (p == own || r->size[p] + s > r->limit)
+                    continue;
+                double gain = r->conn[p] - internal;
+                if (better(r, own, s, p, gain, best, best_gain)) {
+                    best = p;
+                    best_gain = gain;
+                }
+            }
+            /* An overfull part sheds nodes wherever there is room */
+            if (best == own && r->size[own] > r->limit) {
+                for (uint32_t p = 0; p < r->k; p++) {
+                    if (p == own || r->size[p] + s > r->limit)
+                        continue;
+                    double gain = r->conn[p] - internal;
+                    if (best == own || gain > best_gain ||
+                        (gain == best_gain && r->size[p] < r->size[best])) {
+                        best = p;
+                        best_gain = gain;
+                    }
+                }
+            }
+
+            for (size_t j = 0; j < n_touched; j++) {
+                r->conn[r->touched[j]] = 0.0;
+                r->seen[r->touched[j]] = 0;
+            }
+            if (best != own) {
+                r->size[own] -= s;
+                r->size[best] += s;
+                part[u] = best;
+                moved++;
+            }
+        }
+        r->moves += moved;
+        if (!moved)
+            break;
+    }
+}
+
+/* Edge weight between parts at a level; counts the edges into *edges. */
+static double level_cut(const CHierarchy *h, size_t level, const uint32_t *part, size_t *edges)
+{
+    size_t n = ch_level_size(h, level);
+    double cut = 0.0;
+    *edges = 0;
+    for (size_t u = 0; u < n; u++) {
+        const uint32_t *ids;
+        const double *w;
+        size_t deg = ch_neighbors(h, level, (uint32_t)u, &ids, &w);
+        for (size_t j = 0; j < deg; j++) {
+            if (ids[j] > u && part[ids[j]] != part[u]) {
+                cut += w[j];
+                (*edges)++;
+            }
+        }
+    }
+    return cut;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+bool pt_partition(const CHierarchy *h, uint32_t k, double imbalance, uint64_t seed,
+                  uint32_t *part, PTStats *stats)
+{
+    if (!k || !(imbalance >= 0.0))
+        return false;
+    size_t levels = ch_levels(h);
+    size_t n0 = ch_level_size(h, 0);
+    size_t m = n0 ? n0 : 1;
+
+    Refiner r = { .k = k, .rng = seed };
+    r.size = calloc(k, sizeof *r.size);
+    r.conn = calloc(k, sizeof *r.conn);
+    r.seen = calloc(k, sizeof *r.seen);
+    r.touched = malloc(k * sizeof *r.touched);
+    r.order = malloc(m * sizeof *r.order);
+    uint64_t *best_size = malloc(k * sizeof *best_size);
+    uint32_t *other = malloc(m * sizeof *other);
+    bool ok = false;
+    if (!r.size || !r.conn || !r.seen || !r.touched || !r.order || !best_size || !other)
+        goto out;
+
+    const uint32_t *sizes0 = ch_sizes(h, 0);
+    uint64_t total = 0;
+    for (size_t u = 0; u < n0; u++)
+        total += sizes0[u];
+    double limit = ceil((1.0 + imbalance) * (double)total / k);
+    r.limit = limit < (double)total ? (uint64_t)limit : total;
+
+    /* Coarsest level first, keeping the best of a few initial partitions;
+     * arrange the swaps so level 0 lands in part */
+    size_t top = levels - 1, top_n = ch_level_size(h, top), cut_edges;
+    uint32_t *cur = top % 2 ? other : part;
+    uint32_t *next = cur == part ? other : part;
+    double best_cut = INFINITY;
+    size_t best_moves = 0;
+    for (int try = 0; try < PT_INIT_TRIES; try++) {
+        memset(r.size, 0, k * sizeof *r.size);
+        r.moves = 0;
+        if (!initial(h, top, &r, next))
+            goto out;
+        refine(h, top, &r, next);
+        double cut = level_cut(h, top, next, &cut_edges);
+        if (cut < best_cut) {
+            best_cut = cut;
+            best_moves = r.moves;
+            memcpy(cur, next, top_n * sizeof *cur);
+            memcpy(best_size, r.size, k * sizeof *best_size);
+        }
+        if (cut == 0.0)
+            break;
+    }
+    memcpy(r.size, best_size, k * sizeof *r.size);
+    r.moves = best_moves;
+
+    for (size_t level = levels - 1; level-- > 0;) {
+        const uint32_t *parents = ch_parents(h, level);
+        size_t n = ch_level_size(h, level);
+        for (size_t u = 0; u < n; u++)
+            next[u] = parents[u] == CH_NONE ? CH_NONE : cur[parents[u]];
+        uint32_t *t = cur;
+        cur = next;
+        next = t;
+        refine(h, level, &r, cur);
+    }
+
+    /* Nodes without edges fill up the smallest parts */
+    for (size_t u = 0; u < n0; u++) {
+        if (part[u] != CH_NONE)
+            continue;
+        uint32_t smallest = 0;
+        for (uint32_t p = 1; p < k; p++)
+            if (r.size[p] < r.size[smallest])
+                smallest = p;
+        part[u] = smallest;
+        r.size[smallest]++;
+    }
+
+    if (stats) {
+        memset(stats, 0, sizeof *stats);
+        stats->cut = level_cut(h, 0, part, &stats->cut_edges);
+        stats->smallest = SIZE_MAX;
+        for (uint32_t p = 0; p < k; p++) {
+            if (r.size[p] > stats->largest)
+                stats->largest = r.size[p];
+            if (r.size[p] < stats->smallest)
+                stats->smallest = r.size[p];
+        }
+        stats->moves = r.moves;
+    }
+    ok = true;
+
+out:
+    free(r.size);
+    free(r.conn);
+    free(r.seen);
+    free(r.touched);
+    free(r.order);
+    free(best_size);
+    free(other);
+    return ok;
+}
@@ -0,0 +1,61 @@
+/**
+ * partition.h — Multilevel K-way graph partitioning
+ *
+ * pt_partition splits the nodes of a coarsening hierarchy (coarsen.h) into
+ * k parts of similar size with few edges between them, METIS-style:
+ *
+ *   1. Initial partition of the coarsest level by greedy graph growing:
+ *      part 0, 1, ... in turn grows from a seeded random cluster, always
+ *      taking the unassigned cluster with the most edge weight into the
+ *      part, until it holds total / k level-0 nodes.  Several seeds are
+ *      tried and refined; the partition cutting least is kept.
+ *   2. Uncoarsening: the partition is projected one level down (a node
+ *      joins its cluster's part) and refined there by greedy boundary
+ *      passes.  A node moves to the neighbouring part it has the most edge
+ *      weight to when that lowers the cut without overfilling the target,
+ *      or keeps the cut and evens out the sizes.  Nodes of a part over the
+ *      limit move to the best part with room, even at a cost.
+ *
+ * Part sizes count level-0 nodes; the limit is (1 + imbalance) * total / k
+ * rounded up (a cluster larger than that can only be split further down).
+ * Level-0 nodes without edges, which the hierarchy leaves out, are dealt
+ * to the smallest parts at the end.
+ */
+
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "coarsen.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PT_MAX_PASSES 8         /* refinement passes per level */
+#define PT_INIT_TRIES 8         /* initial partitions tried (the best is kept) */
+
+typedef struct {
+    double   cut;               /* level-0 edge weight between parts */
+    size_t   cut_edges;         /* level-0 (undirected) edges between parts */
+    size_t   largest;           /* level-0 nodes of the largest part */
+    size_t   smallest;          /* ... and of the smallest */
+    size_t   moves;             /* refinement moves over all levels */
+} PTStats;
+
+/**
+ * Partition the level-0 nodes into k parts.  part holds
+ * ch_level_size(h, 0) entries and receives each node's part (0 .. k - 1).
+ * Returns false for k == 0, a negative or NaN imbalance, or lack of memory.
+ */
+bool pt_partition(const CHierarchy *h, uint32_t k, double imbalance, uint64_t seed,
+                  uint32_t *part, PTStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PARTITION_H */
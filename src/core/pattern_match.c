@@ -0,0 +1,706 @@
+/**
+ * pattern_match.c — Subgraph pattern matching over graph_store views
+ *
+ * pm_match compiles the pattern into a Plan: one Step per variable in
+ * binding order, each listing the adjacency lists to intersect (Links),
+ * self-loops to test, degree lower bounds and the symmetry-breaking order
+ * constraints against variables bound earlier.  Workers then run the
+ * generic join depth-first from their share of the root candidates.
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   /* sysconf */
+#endif
+
+#include "pattern_match.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define ROOT_CHUNK        16u     /* root candidates claimed at a time      */
+#define ROW_BATCH         256u    /* matches per callback                   */
+#define MAX_THREADS       64u
+#define SYMMETRY_MAX_VARS 8u      /* automorphisms enumerated up to this    */
+
+/* Which adjacency list of a node: its out-, in- or both neighbours. */
+enum { DIR_OUT = 0, DIR_IN = 1, DIR_BOTH = 2 };
+
+typedef struct {
+    uint8_t       other;          /* bound variable whose list is used */
+    uint8_t       dir;
+    const GSView *view;
+} Link;
+
+typedef struct {
+    const GSView *view;
+    uint8_t       dir;
+    uint32_t      need;           /* minimum degree in view / dir */
+} DegreeBound;
+
+typedef struct {
+    uint8_t         var;
+    uint8_t         n_links, n_loops, n_degree, n_above, n_below;
+    Link            links[PM_MAX_EDGES];
+    const GSView   *loops[PM_MAX_EDGES];
+    DegreeBound     degree[PM_MAX_EDGES];
+    uint8_t         above[PM_MAX_VARS];   /* node ID > that variable's */
+    uint8_t         below[PM_MAX_VARS];   /* node ID < that variable's */
+    const uint32_t *cand;
+    size_t          n_cand;
+} Step;
+
+typedef struct {
+    size_t n_vars;
+    size_t node_count;            /* "any node" ranges over [0, node_count) */
+    size_t automorphisms;
+    Step   steps[PM_MAX_VARS];
+} Plan;
+
+typedef struct {
+    const Plan     *plan;
+    PMCallback      cb;
+    void           *ctx;
+    size_t          limit;
+    size_t          root_count;
+    _Atomic size_t  next_root;
+    atomic_bool     stop;
+    atomic_bool     failed;       /* out of memory in a worker */
+    pthread_mutex_t emit_lock;
+    size_t          emitted;      /* guarded by emit_lock */
+    bool            stopped;      /* guarded by emit_lock */
+} Run;
+
+typedef struct {
+    Run      *run;
+    uint32_t  bind[PM_MAX_VARS];  /* indexed by variable */
+    uint32_t *found[PM_MAX_VARS]; /* intersection result per depth */
+    size_t    found_cap[PM_MAX_VARS];
+    uint32_t *merged[PM_MAX_VARS];/* out + in unions per depth */
+    size_t    merged_cap[PM_MAX_VARS];
+    uint32_t *rows;
+    size_t    n_rows;
+} Worker;
+
+static bool grow(uint32_t **buf, size_t *cap, size_t need)
+{
+    if (need <= *cap)
+        return true;
+    size_t n = *cap ? *cap : 64;
+    while (n < need)
+        n *= 2;
+    uint32_t *p = realloc(*buf, n * sizeof *p);
+    if (!p)
+        return false;
+    *buf = p;
+    *cap = n;
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Adjacency access
+ * ---------------------------------------------------------------------- */
+
+static size_t degree_of(const GSView *v, uint32_t node, uint8_t dir)
+{
+    size_t d = 0;
+    if (dir != DIR_IN)
+        d += gs_view_neighbors(v, node, NULL, NULL);
+    if (dir != DIR_OUT)
+        d += gs_view_in_neighbors(v, node, NULL, NULL);
+    return d;
+}
+
+/* Merge two sorted lists, dropping duplicates.  Returns the length. */
+static size_t merge_union(const uint32_t *a, size_t na, const uint32_t *b, size_t nb,
+                          uint32_t *out)
+{
+    size_t i = 0, j = 0, n = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j])
+            out[n++] = a[i++];
+        else if (b[j] < a[i])
+            out[n++] = b[j++];
+        else {
+            out[n++] = a[i++];
+            j++;
+        }
+    }
+    while (i < na)
+        out[n++] = a[i++];
+    while (j < nb)
+        out[n++] = b[j++];
+    return n;
+}
+
+/* First index >= from with list[index] >= x, by exponential then binary search. */
+static size_t gallop(const uint32_t *list, size_t n, size_t from, uint32_t x)
+{
+    size_t step = 1, lo = from, hi = from;
+    while (hi < n && list[hi] < x) {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    if (hi > n)
+        hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (list[mid] < x)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/*
+ * Intersect k sorted lists into out (room for the shortest).  The shortest
+ * list drives; every other list is advanced by galloping, so each step
+ * costs O(log gap) rather than O(gap).
+ */
+static size_t intersect(const uint32_t **lists, const size_t *lens, size_t k, uint32_t *out)
+{
+    size_t first = 0;
+    for (size_t i = 1; i < k; i++)
+        if (lens[i] < lens[first])
+            first = i;
+
+    size_t pos[PM_MAX_EDGES + 1] = {0};
+    size_t n = 0;
+    for (size_t a = 0; a < lens[first]; a++) {
+        uint32_t x = lists[first][a];
+        bool all = true;
+        for (size_t i = 0; i < k; i++) {
+            if (i == first)
+                continue;
+            pos[i] = gallop(lists[i], lens[i], pos[i], x);
+            if (pos[i] == lens[i])
+                return n;
+            if (lists[i][pos[i]] != x) {
+                all = false;
+                break;
+            }
+        }
+        if (all)
+            out[n++] = x;
+    }
+    return n;
+}
+
+/* -------------------------------------------------------------------------
+ * Search
+ * ---------------------------------------------------------------------- */
+
+static void flush_rows(Worker *w)
+{
+    Run *r = w->run;
+    if (w->n_rows == 0)
+        return;
+
+    pthread_mutex_lock(&r->emit_lock);
+    if (!atomic_load_explicit(&r->stop, memory_order_relaxed)) {
+        size_t n = w->n_rows;
+        if (r->limit && n > r->limit - r->emitted)
+            n = r->limit - r->emitted;
+        bool more = r->cb(w->rows, n, r->ctx);
+        r->emitted += n;
+        if (!more || (r->limit && r->emitted >= r->limit)) {
+            r->stopped = true;
+            atomic_store(&r->stop, true);
+        }
+    }
+    pthread_mutex_unlock(&r->emit_lock);
+    w->n_rows = 0;
+}
+
+static void emit(Worker *w)
+{
+    size_t n_vars = w->run->plan->n_vars;
+    memcpy(w->rows + w->n_rows * n_vars, w->bind, n_vars * sizeof(uint32_t));
+    if (++w->n_rows == ROW_BATCH)
+        flush_rows(w);
+}
+
+/* Checks on node x for the step at depth, beyond membership in its lists. */
+static bool admit(const Worker *w, const Step *s, size_t depth, uint32_t x)
+{
+    const Plan *p = w->run->plan;
+    for (size_t i = 0; i < depth; i++)
+        if (w->bind[p->steps[i].var] == x)
+            return false;
+    for (uint8_t i = 0; i < s->n_above; i++)
+        if (x <= w->bind[s->above[i]])
+            return false;
+    for (uint8_t i = 0; i < s->n_below; i++)
+        if (x >= w->bind[s->below[i]])
+            return false;
+    for (uint8_t i = 0; i < s->n_degree; i++)
+        if (degree_of(s->degree[i].view, x, s->degree[i].dir) < s->degree[i].need)
+            return false;
+    for (uint8_t i = 0; i < s->n_loops; i++)
+        if (!gs_view_has_edge(s->loops[i], x, x, NULL))
+            return false;
+    return true;
+}
+
+static void extend(Worker *w, size_t depth);
+
+static void try_bind(Worker *w, const Step *s, size_t depth, uint32_t x)
+{
+    if (!admit(w, s, depth, x))
+        return;
+    w->bind[s->var] = x;
+    extend(w, depth + 1);
+}
+
+static void extend(Worker *w, size_t depth)
+{
+    Run *r = w->run;
+    const Plan *p = r->plan;
+    if (depth == p->n_vars) {
+        emit(w);
+        return;
+    }
+
+    const Step *s = &p->steps[depth];
+    const uint32_t *lists[PM_MAX_EDGES + 1];
+    size_t lens[PM_MAX_EDGES + 1];
+    const uint32_t *out_l[PM_MAX_EDGES], *in_l[PM_MAX_EDGES];
+    size_t out_n[PM_MAX_EDGES], in_n[PM_MAX_EDGES];
+    size_t k = 0, union_total = 0;
+
+    if (s->cand) {
+        if (s->n_cand == 0)
+            return;
+        lists[k] = s->cand;
+        lens[k++] = s->n_cand;
+    }
+
+    /* Fetch the neighbour lists; a single empty one ends this branch. */
+    for (uint8_t i = 0; i < s->n_links; i++) {
+        const Link *l = &s->links[i];
+        uint32_t u = w->bind[l->other];
+        out_n[i] = in_n[i] = 0;
+        if (l->dir != DIR_IN)
+            out_n[i] = gs_view_neighbors(l->view, u, &out_l[i], NULL);
+        if (l->dir != DIR_OUT)
+            in_n[i] = gs_view_in_neighbors(l->view, u, &in_l[i], NULL);
+        if (out_n[i] + in_n[i] == 0)
+            return;
+        if (l->dir == DIR_BOTH)
+            union_total += out_n[i] + in_n[i];
+    }
+    if (union_total && !grow(&w->merged[depth], &w->merged_cap[depth], union_total)) {
+        atomic_store(&r->failed, true);
+        atomic_store(&r->stop, true);
+        return;
+    }
+
+    uint32_t *next = w->merged[depth];
+    for (uint8_t i = 0; i < s->n_links; i++) {
+        const Link *l = &s->links[i];
+        if (l->dir == DIR_OUT) {
+            lists[k] = out_l[i];
+            lens[k++] = out_n[i];
+        } else if (l->dir == DIR_IN) {
+            lists[k] = in_l[i];
+            lens[k++] = in_n[i];
+        } else {
+            size_t n = merge_union(out_n[i] ? out_l[i] : NULL, out_n[i],
+                                   in_n[i] ? in_l[i] : NULL, in_n[i], next);
+            lists[k] = next;
+            lens[k++] = n;
+            next += n;
+        }
+    }
+
+    if (k == 0) {
+        /* Unconstrained and disconnected from the bound variables. */
+        for (size_t x = 0; x < p->node_count; x++) {
+            if (atomic_load_explicit(&r->stop, memory_order_relaxed))
+                return;
+            try_bind(w, s, depth, (uint32_t)x);
+        }
+        return;
+    }
+
+    const uint32_t *cands = lists[0];
+    size_t n = lens[0];
+    if (k > 1) {
+        size_t shortest = lens[0];
+        for (size_t i = 1; i < k; i++)
+            if (lens[i] < shortest)
+                shortest = lens[i];
+        if (!grow(&w->found[depth], &w->found_cap[depth], shortest)) {
+            atomic_store(&r->failed, true);
+            atomic_store(&r->stop, true);
+            return;
+        }
+        n = intersect(lists, lens, k, w->found[depth]);
+        cands = w->found[depth];
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (atomic_load_explicit(&r->stop, memory_order_relaxed))
+            return;
+        try_bind(w, s, depth, cands[i]);
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    Worker *w = arg;
+    Run *r = w->run;
+    const Step *root = &r->plan->steps[0];
+
+    while (!atomic_load_explicit(&r->stop, memory_order_relaxed)) {
+        size_t start = atomic_fetch_add(&r->next_root, ROOT_CHUNK);
+        if (start >= r->root_count)
+            break;
+        size_t end = start + ROOT_CHUNK < r->root_count ? start + ROOT_CHUNK : r->root_count;
+        for (size_t i = start; i < end; i++) {
+            if (atomic_load_explicit(&r->stop, memory_order_relaxed))
+                break;
+            try_bind(w, root, 0, root->cand ? root->cand[i] : (uint32_t)i);
+        }
+    }
+    flush_rows(w);
+    return NULL;
+}
+
+static void worker_free(Worker *w)
+{
+    for (size_t i = 0; i < PM_MAX_VARS; i++) {
+        free(w->found[i]);
+        free(w->merged[i]);
+    }
+    free(w->rows);
+}
+
+/* -------------------------------------------------------------------------
+ * Symmetry breaking
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const PMVar  *vars;
+    size_t        n_vars;
+    const PMEdge *edges;
+    size_t        n_edges;
+    size_t        degree[PM_MAX_VARS];
+    uint8_t       perm[PM_MAX_VARS];
+    bool          used[PM_MAX_VARS];
+    uint8_t      *autos;          /* n_autos permutations of n_vars */
+    size_t        n_autos, cap;
+    bool          failed;
+} AutoSearch;
+
+static bool same_edge(const PMEdge *e, uint32_t src, uint32_t dst, const GSView *view,
+                      bool undirected)
+{
+    if (e->view != view || e->undirected != undirected)
+        return false;
+    return (e->src == src && e->dst == dst) ||
+           (undirected && e->src == dst && e->dst == src);
+}
+
+static bool has_pattern_edge(const AutoSearch *a, uint32_t src, uint32_t dst,
+                             const GSView *view, bool undirected)
+{
+    for (size_t i = 0; i < a->n_edges; i++)
+        if (same_edge(&a->edges[i], src, dst, view, undirected))
+            return true;
+    return false;
+}
+
+/* Extend a partial automorphism perm[0..v) with an image for variable v. */
+static void find_autos(AutoSearch *a, uint32_t v)
+{
+    if (a->failed)
+        return;
+    if (v == a->n_vars) {
+        if (a->n_autos == a->cap) {
+            size_t cap = a->cap ? a->cap * 2 : 16;
+            uint8_t *p = realloc(a->autos, cap * a->n_vars);
+            if (!p) {
+                a->failed = true;
+                return;
+            }
+            a->autos = p;
+            a->cap = cap;
+        }
+        memcpy(a->autos + a->n_autos++ * a->n_vars, a->perm, a->n_vars);
+        return;
+    }
+
+    for (uint32_t img = 0; img < a->n_vars; img++) {
+        if (a->used[img] || a->vars[img].klass != a->vars[v].klass ||
+            a->degree[img] != a->degree[v])
+            continue;
+        a->perm[v] = (uint8_t)img;
+        bool ok = true;
+        for (size_t i = 0; ok && i < a->n_edges; i++) {
+            const PMEdge *e = &a->edges[i];
+            uint32_t hi = e->src > e->dst ? e->src : e->dst;
+            if (hi != v)
+                continue;   /* checked once both endpoints are mapped */
+            ok = has_pattern_edge(a, a->perm[e->src], a->perm[e->dst], e->view, e->undirected);
+        }
+        if (!ok)
+            continue;
+        a->used[img] = true;
+        find_autos(a, v + 1);
+        a->used[img] = false;
+    }
+}
+
+/*
+ * Order constraints lo < hi such that exactly one member of every orbit of
+ * matches under the automorphism group satisfies them: repeatedly take the
+ * first variable v moved by the remaining group, require v below every
+ * other variable in its orbit, then keep only automorphisms fixing v.
+ */
+static bool break_symmetry(const PMVar *vars, size_t n_vars,
+                           const PMEdge *edges, size_t n_edges, Plan *plan,
+                           uint8_t (*pairs)[2], size_t *n_pairs)
+{
+    AutoSearch a = { .vars = vars, .n_vars = n_vars, .edges = edges, .n_edges = n_edges };
+    for (size_t i = 0; i < n_edges; i++) {
+        a.degree[edges[i].src]++;
+        a.degree[edges[i].dst]++;
+    }
+    find_autos(&a, 0);
+    if (a.failed) {
+        free(a.autos);
+        return false;
+    }
+    plan->automorphisms = a.n_autos;
+
+    bool *alive = malloc(a.n_autos ? a.n_autos : 1);
+    if (!alive) {
+        free(a.autos);
+        return false;
+    }
+    memset(alive, 1, a.n_autos);
+
+    *n_pairs = 0;
+    for (size_t v = 0; v < n_vars; v++) {
+        bool orbit[PM_MAX_VARS] = {false};
+        for (size_t g = 0; g < a.n_autos; g++)
+            if (alive[g])
+                orbit[a.autos[g * n_vars + v]] = true;
+        for (size_t w = 0; w < n_vars; w++) {
+            if (w != v && orbit[w]) {
+                pairs[*n_pairs][0] = (uint8_t)v;
+                pairs[*n_pairs][1] = (uint8_t)w;
+                (*n_pairs)++;
+            }
+        }
+        for (size_t g = 0; g < a.n_autos; g++)
+            if (a.autos[g * n_vars + v] != v)
+                alive[g] = false;
+    }
+    free(alive);
+    free(a.autos);
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Planning
+ * ---------------------------------------------------------------------- */
+
+static void add_degree(Step *s, const GSView *view, uint8_t dir)
+{
+    for (uint8_t i = 0; i < s->n_degree; i++) {
+        if (s->degree[i].view == view && s->degree[i].dir == dir) {
+            s->degree[i].need++;
+            return;
+        }
+    }
+    s->degree[s->n_degree++] = (DegreeBound){ view, dir, 1 };
+}
+
+static bool build_plan(const PMVar *vars, size_t n_vars, const PMEdge *in_edges,
+                       size_t n_in, unsigned flags, Plan *plan)
+{
+    /* Validate and drop duplicate pattern edges. */
+    PMEdge edges[PM_MAX_EDGES];
+    size_t n_edges = 0;
+    for (size_t i = 0; i < n_in; i++) {
+        const PMEdge *e = &in_edges[i];
+        if (e->src >= n_vars || e->dst >= n_vars || !e->view || !gs_view_tracks_in(e->view))
+            return false;
+        bool dup = false;
+        for (size_t j = 0; j < n_edges && !dup; j++)
+            dup = same_edge(&edges[j], e->src, e->dst, e->view, e->undirected);
+        if (!dup)
+            edges[n_edges++] = *e;
+        size_t nodes = gs_view_node_count(e->view);
+        if (nodes > plan->node_count)
+            plan->node_count = nodes;
+    }
+    for (size_t v = 0; v < n_vars; v++)
+        for (size_t i = 1; vars[v].candidates && i < vars[v].n_candidates; i++)
+            if (vars[v].candidates[i - 1] >= vars[v].candidates[i])
+                return false;
+    plan->n_vars = n_vars;
+
+    /* Binding order: smallest candidate set first, then most-connected. */
+    size_t size[PM_MAX_VARS], degree[PM_MAX_VARS] = {0};
+    for (size_t v = 0; v < n_vars; v++)
+        size[v] = vars[v].candidates ? vars[v].n_candidates : plan->node_count;
+    for (size_t i = 0; i < n_edges; i++) {
+        degree[edges[i].src]++;
+        degree[edges[i].dst]++;
+    }
+
+    int depth_of[PM_MAX_VARS];
+    for (size_t v = 0; v < n_vars; v++)
+        depth_of[v] = -1;
+    for (size_t d = 0; d < n_vars; d++) {
+        int best = -1;
+        size_t best_links = 0;
+        for (size_t v = 0; v < n_vars; v++) {
+            if (depth_of[v] >= 0)
+                continue;
+            size_t links = 0;
+            for (size_t i = 0; i < n_edges; i++) {
+                const PMEdge *e = &edges[i];
+                if ((e->src == v && e->dst != v && depth_of[e->dst] >= 0) ||
+                    (e->dst == v && e->src != v && depth_of[e->src] >= 0))
+                    links++;
+            }
+            if (best < 0 || links > best_links ||
+                (links == best_links && (size[v] < size[best] ||
+                 (size[v] == size[best] && degree[v] > degree[best])))) {
+                best = (int)v;
+                best_links = links;
+            }
+        }
+        depth_of[best] = (int)d;
+        plan->steps[d].var = (uint8_t)best;
+        plan->steps[d].cand = vars[best].candidates;
+        plan->steps[d].n_cand = vars[best].n_candidates;
+    }
+
+    /* Links, loops and degree bounds. */
+    for (size_t i = 0; i < n_edges; i++) {
+        const PMEdge *e = &edges[i];
+        if (e->src == e->dst) {
+            Step *s = &plan->steps[depth_of[e->src]];
+            s->loops[s->n_loops++] = e->view;
+            continue;
+        }
+        Step *ss = &plan->steps[depth_of[e->src]];
+        Step *ds = &plan->steps[depth_of[e->dst]];
+        add_degree(ss, e->view, e->undirected ? DIR_BOTH : DIR_OUT);
+        add_degree(ds, e->view, e->undirected ? DIR_BOTH : DIR_IN);
+        if (depth_of[e->src] < depth_of[e->dst])
+            ds->links[ds->n_links++] = (Link){ (uint8_t)e->src,
+                                               e->undirected ? DIR_BOTH : DIR_OUT, e->view };
+        else
+            ss->links[ss->n_links++] = (Link){ (uint8_t)e->dst,
+                                               e->undirected ? DIR_BOTH : DIR_IN, e->view };
+    }
+
+    /* Symmetry constraints go to whichever variable is bound second. */
+    if ((flags & PM_BREAK_SYMMETRY) && n_vars <= SYMMETRY_MAX_VARS) {
+        uint8_t pairs[PM_MAX_VARS * PM_MAX_VARS][2];
+        size_t n_pairs;
+        if (!break_symmetry(vars, n_vars, edges, n_edges, plan, pairs, &n_pairs))
+            return false;
+        for (size_t i = 0; i < n_pairs; i++) {
+            uint8_t lo = pairs[i][0], hi = pairs[i][1];
+            if (depth_of[lo] < depth_of[hi]) {
+                Step *s = &plan->steps[depth_of[hi]];
+                s->above[s->n_above++] = lo;
+            } else {
+                Step *s = &plan->steps[depth_of[lo]];
+                s->below[s->n_below++] = hi;
+            }
+        }
+    }
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+int64_t pm_match(const PMVar *vars, size_t n_vars,
+                 const PMEdge *edges, size_t n_edges,
+                 unsigned flags, unsigned threads, size_t limit,
+                 PMCallback cb, void *ctx, PMStats *stats)
+{
+    if (!vars || n_vars == 0 || n_vars > PM_MAX_VARS || n_edges > PM_MAX_EDGES ||
+        (n_edges && !edges) || !cb)
+        return -1;
+
+    Plan *plan = calloc(1, sizeof *plan);
+    if (!plan)
+        return -1;
+    if (!build_plan(vars, n_vars, edges, n_edges, flags, plan)) {
+        free(plan);
+        return -1;
+    }
+
+    Run run = { .plan = plan, .cb = cb, .ctx = ctx, .limit = limit };
+    const Step *root = &plan->steps[0];
+    run.root_count = root->cand ? root->n_cand : plan->node_count;
+    atomic_init(&run.next_root, 0);
+    atomic_init(&run.stop, false);
+    atomic_init(&run.failed, false);
+    pthread_mutex_init(&run.emit_lock, NULL);
+
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    size_t chunks = (run.root_count + ROOT_CHUNK - 1) / ROOT_CHUNK;
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads > chunks)
+        threads = chunks ? (unsigned)chunks : 1;
+
+    Worker *workers = calloc(threads, sizeof *workers);
+    pthread_t *tids = calloc(threads, sizeof *tids);
+    bool ok = workers && tids;
+    unsigned started = 0;
+    for (unsigned t = 0; ok && t < threads; t++) {
+        workers[t].run = &run;
+        workers[t].rows = malloc((size_t)ROW_BATCH * n_vars * sizeof(uint32_t));
+        ok = workers[t].rows != NULL;
+    }
+
+    if (ok) {
+        /* Worker 0 runs on the calling thread. */
+        for (started = 1; started < threads; started++)
+            if (pthread_create(&tids[started], NULL, worker_main, &workers[started]) != 0)
+                break;
+        worker_main(&workers[0]);
+        for (unsigned t = 1; t < started; t++)
+            pthread_join(tids[t], NULL);
+    }
+
+    if (stats) {
+        stats->matches = run.emitted;
+        stats->automorphisms = plan->automorphisms;
+        stats->threads = started;
+        stats->stopped = run.stopped;
+    }
+    int64_t result = ok && !atomic_load(&run.failed) ? (int64_t)run.emitted : -1;
+
+    for (unsigned t = 0; workers && t < threads; t++)
+        worker_free(&workers[t]);
+    free(workers);
+    free(tids);
+    pthread_mutex_destroy(&run.emit_lock);
+    free(plan);
+    return result;
+}
@@ -0,0 +1,99 @@
+/**
+ * pattern_match.h — Subgraph pattern matching over graph_store views
+ *
+ * A pattern is a small graph of variables (at most PM_MAX_VARS) joined by
+ * pattern edges.  Each pattern edge names the GSView its data edges come
+ * from, so edge labels are modelled as one view per label.  A match binds
+ * every variable to a distinct node such that every pattern edge exists.
+ *
+ * Join:
+ *   Variables are bound one at a time (generic join).  The candidates for
+ *   the next variable are the intersection of the sorted adjacency lists
+ *   of its already-bound pattern neighbours and of its own candidate list,
+ *   computed by galloping from the shortest list, so the work is bounded
+ *   by the smallest list rather than by the product of intermediate
+ *   results (worst-case optimal for the pattern).  The binding order is
+ *   greedy: most constrained variable first, then the one with the most
+ *   edges into the bound set.
+ *
+ * Pruning:
+ *   Candidate lists carry node predicates (labels, properties) resolved by
+ *   the caller.  Every binding is also checked against the degree the
+ *   variable needs in each view.  With PM_BREAK_SYMMETRY, automorphisms of
+ *   the pattern (permutations preserving its edges and variable classes)
+ *   are enumerated (patterns of up to 8 variables) and turned into
+ *   ordering constraints on node IDs (Grochow and Kellis), so each matching
+ *   subgraph is reported once instead of once per automorphism.
+ *
+ * Execution:
+ *   Worker threads claim root candidates from a shared counter; matches
+ *   are streamed to the callback in batches (one callback at a time, in no
+ *   particular order).  The callback returning false stops the search.
+ *
+ * Views must track in-adjacency (GS_TRACK_IN) and stay acquired for the
+ * duration of pm_match.
+ */
+
+#ifndef PATTERN_MATCH_H
+#define PATTERN_MATCH_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "graph_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PM_MAX_VARS   16
+#define PM_MAX_EDGES  64
+
+/** pm_match flags. */
+#define PM_BREAK_SYMMETRY  0x1u   /* report each subgraph once, not once per automorphism */
+
+typedef struct {
+    const uint32_t *candidates;   /* sorted node IDs, NULL = any node          */
+    size_t          n_candidates; /* 0 with non-NULL candidates = no node      */
+    uint32_t        klass;        /* symmetry breaking only swaps equal classes;
+                                     equal classes need equal candidates       */
+} PMVar;
+
+typedef struct {
+    uint32_t      src, dst;       /* variable indices                          */
+    const GSView *view;           /* data edges come from this view            */
+    bool          undirected;     /* src -> dst or dst -> src                  */
+} PMEdge;
+
+typedef struct {
+    size_t   matches;             /* rows passed to the callback               */
+    size_t   automorphisms;       /* of the pattern; 0 if not enumerated       */
+    unsigned threads;
+    bool     stopped;             /* callback or limit ended the search early  */
+} PMStats;
+
+/**
+ * Receives n_rows matches, each n_vars node IDs in variable order.  The
+ * array is only valid during the call.  Return false to stop matching.
+ */
+typedef bool (*PMCallback)(const uint32_t *rows, size_t n_rows, void *ctx);
+
+/**
+ * Find all matches of the pattern.
+ *
+ * threads 0 = one per online CPU; limit 0 = unlimited.  stats may be NULL.
+ * Returns the number of matches delivered, or -1 if the pattern is invalid
+ * (too many variables or edges, an index out of range, a view without
+ * in-adjacency, or unsorted candidates) or memory runs out.
+ */
+int64_t pm_match(const PMVar *vars, size_t n_vars,
+                 const PMEdge *edges, size_t n_edges,
+                 unsigned flags, unsigned threads, size_t limit,
+                 PMCallback cb, void *ctx, PMStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PATTERN_MATCH_H */
@@ -0,0 +1,770 @@
+/**
+ * shapes.c — Compiled shape validation for bulk instance checks
+ *
+ * Before compile, parent edges, class sets and rules are appended to
+ * growable arrays.  shp_compile builds three CSR tables over classes:
+ * parents, the sorted ancestor closure (an explicit-stack DFS with a
+ * per-class stamp, so shared ancestors and cycles are visited once) and
+ * the flattened rule IDs of all ancestors, sorted.
+ *
+ * shp_validate gives each worker stamp arrays over rules and properties:
+ * per instance it counts the values of every property once, then
+ * evaluates each rule of the instance's classes, skipping rules already
+ * met through another class.  Each chunk of instances collects its own
+ * violations, and the chunks are concatenated in order at the end.
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   /* sysconf */
+#endif
+
+#include "shapes.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define CHUNK        512u       /* instances claimed at a time */
+#define PAR_MIN      4096u      /* smaller batches run on one thread */
+#define MAX_THREADS  64u
+
+typedef struct {
+    uint32_t cls, op, prop, arg;
+} Rule;
+
+struct ShpProgram {
+    size_t    classes;
+    bool      compiled;
+
+    uint32_t *edge_cls, *edge_parent;   /* subclass edges */
+    size_t    n_edges, cap_edge_cls, cap_edge_parent;
+    Rule     *rules;
+    size_t    n_rules, cap_rules;
+    size_t   *set_off;                  /* class sets, CSR: n_sets + 1 */
+    uint32_t *set_cls;
+    size_t    n_sets, cap_set_off, n_set_cls, cap_set_cls;
+    uint32_t  n_props;                  /* highest rule property + 1 */
+
+    /* compiled */
+    size_t   *anc_off;                  /* classes + 1 */
+    uint32_t *anc;                      /* sorted, self included */
+    size_t   *flat_off;                 /* classes + 1 */
+    uint32_t *flat;                     /* sorted rule IDs */
+    uint32_t *global;                   /* SHP_ALL rules */
+    size_t    n_global;
+};
+
+typedef struct {
+    ShpViolation *v;
+    size_t        n, cap;
+} VioList;
+
+static bool grow(void **arr, size_t *cap, size_t need, size_t size)
+{
+    if (need <= *cap)
+        return true;
+    size_t next = *cap ? *cap * 2 : 16;
+    while (next < need)
+        next *= 2;
+    void *p = realloc(*arr, next * size);
+    if (!p)
+        return false;
+    *arr = p;
+    *cap = next;
+    return true;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static bool contains(const uint32_t *sorted, size_t n, uint32_t key)
+{
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (sorted[mid] < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < n && sorted[lo] == key;
+}
+
+/* -------------------------------------------------------------------------
+ * Program construction
+ * ---------------------------------------------------------------------- */
+
+ShpProgram *shp_program_create(size_t classes)
+{
+    if (classes >= SHP_ALL)
+        return NULL;
+    ShpProgram *p = calloc(1, sizeof *p);
+    if (!p)
+        return NULL;
+    p->classes = classes;
+    if (!grow((void **)&p->set_off, &p->cap_set_off, 1, sizeof *p->set_off)) {
+        free(p);
+        return NULL;
+    }
+    p->set_off[0] = 0;
+    return p;
+}
+
+void shp_program_free(ShpProgram *p)
+{
+    if (!p)
+        return;
+    free(p->edge_cls);
+    free(p->edge_parent);
+    free(p->rules);
+    free(p->set_cls);
+    free(p->set_off);
+    free(p->anc_off);
+    free(p->anc);
+    free(p->flat_off);
+    free(p->flat);
+    free(p->global);
+    free(p);
+}
+
+bool shp_add_parent(ShpProgram *p, uint32_t cls, uint32_t parent)
+{
+    if (p->compiled || cls >= p->classes || parent >= p->classes)
+        return false;
+    if (!grow((void **)&p->edge_cls, &p->cap_edge_cls, p->n_edges + 1, sizeof *p->edge_cls) ||
+        !grow((void **)&p->edge_parent, &p->cap_edge_parent, p->n_edges + 1,
+              sizeof *p->edge_parent))
+        return false;
+    p->edge_cls[p->n_edges] = cls;
+    p->edge_parent[p->n_edges++] = parent;
+    return true;
+}
+
+int64_t shp_add_class_set(ShpProgram *p, const uint32_t *classes, size_t n)
+{
+    if (p->compiled || (n && !classes))
+        return -1;
+    for (size_t i = 0; i < n; i++)
+        if (classes[i] >= p->classes)
+            return -1;
+    if (!grow((void **)&p->set_off, &p->cap_set_off, p->n_sets + 2, sizeof *p->set_off) ||
+        !grow((void **)&p->set_cls, &p->cap_set_cls, p->n_set_cls + n, sizeof *p->set_cls))
+        return -1;
+    if (n)
+        memcpy(p->set_cls + p->n_set_cls, classes, n * sizeof *classes);
+    p->n_set_cls += n;
+    p->set_off[++p->n_sets] = p->n_set_cls;
+    return (int64_t)(p->n_sets - 1);
+}
+
+int64_t shp_add_rule(ShpProgram *p, uint32_t cls, uint32_t op, uint32_t prop, uint32_t arg)
+{
+    if (p->compiled || (cls != SHP_ALL && cls >= p->classes) || prop == UINT32_MAX)
+        return -1;
+    if (op < SHP_MIN_COUNT || op > SHP_RANGE || (op == SHP_RANGE && arg >= p->n_sets))
+        return -1;
+    if (p->n_rules >= UINT32_MAX - 1 ||
+        !grow((void **)&p->rules, &p->cap_rules, p->n_rules + 1, sizeof *p->rules))
+        return -1;
+    p->rules[p->n_rules] = (Rule){ cls, op, prop, arg };
+    if (prop >= p->n_props)
+        p->n_props = prop + 1;
+    return (int64_t)p->n_rules++;
+}
+
+/* -------------------------------------------------------------------------
+ * Compilation
+ * ---------------------------------------------------------------------- */
+
+/* CSR of keys[i] -> vals[i] over n_keys keys. */
+static bool build_csr(size_t n_keys, const uint32_t *keys, const uint32_t *vals, size_t n,
+                      size_t **off_out, uint32_t **adj_out)
+{
+    size_t *off = calloc(n_keys + 1, sizeof *off);
+    uint32_t *adj = malloc((n ? n : 1) * sizeof *adj);
+    size_t *pos = malloc((n_keys ? n_keys : 1) * sizeof *pos);
+    if (!off || !adj || !pos) {
+        free(off);
+        free(adj);
+        free(pos);
+        return false;
+    }
+    for (size_t i = 0; i < n; i++)
+        off[keys[i] + 1]++;
+    for (size_t k = 0; k < n_keys; k++)
+        off[k + 1] += off[k];
+    memcpy(pos, off, n_keys * sizeof *pos);
+    for (size_t i = 0; i < n; i++)
+        adj[pos[keys[i]]++] = vals[i];
+    free(pos);
+    *off_out = off;
+    *adj_out = adj;
+    return true;
+}
+
+bool shp_compile(ShpProgram *p)
+{
+    if (p->compiled)
+        return true;
+    size_t nc = p->classes;
+    size_t *par_off = NULL, *own_off = NULL;
+    uint32_t *par = NULL, *own = NULL, *rule_cls = NULL, *mark = NULL, *stack = NULL;
+    size_t anc_cap = 0, flat_cap = 0, n_anc = 0, n_flat = 0;
+    bool ok = false;
+
+    /* Rules grouped by class; SHP_ALL rules apart */
+    size_t n_own = 0;
+    rule_cls = malloc((p->n_rules ? p->n_rules : 1) * sizeof *rule_cls);
+    uint32_t *own_ids = malloc((p->n_rules ? p->n_rules : 1) * sizeof *own_ids);
+    p->global = malloc((p->n_rules ? p->n_rules : 1) * sizeof *p->global);
+    if (!rule_cls || !own_ids || !p->global) {
+        free(own_ids);
+        goto out;
+    }
+    for (size_t r = 0; r < p->n_rules; r++) {
+        if (p->rules[r].cls == SHP_ALL) {
+            p->global[p->n_global++] = (uint32_t)r;
+        } else {
+            rule_cls[n_own] = p->rules[r].cls;
+            own_ids[n_own++] = (uint32_t)r;
+        }
+    }
+    bool built = build_csr(nc, rule_cls, own_ids, n_own, &own_off, &own);
+    free(own_ids);
+    if (!built || !build_csr(nc, p->edge_cls, p->edge_parent, p->n_edges, &par_off, &par))
+        goto out;
+
+    p->anc_off = malloc((nc + 1) * sizeof *p->anc_off);
+    p->flat_off = malloc((nc + 1) * sizeof *p->flat_off);
+    mark = calloc(nc ? nc : 1, sizeof *mark);
+    stack = malloc((nc ? nc : 1) * sizeof *stack);
+    if (!p->anc_off || !p->flat_off || !mark || !stack)
+        goto out;
+
+    p->anc_off[0] = p->flat_off[0] = 0;
+    for (size_t c = 0; c < nc; c++) {
+        /* Ancestors: each class is pushed once per closure (stamp c + 1) */
+        uint32_t stamp = (uint32_t)c + 1;
+        size_t top = 0, first = n_anc;
+        stack[top++] = (uint32_t)c;
+        mark[c] = stamp;
+        while (top) {
+            uint32_t u = stack[--top];
+            if (!grow((void **)&p->anc, &anc_cap, n_anc + 1, sizeof *p->anc))
+                goto out;
+            p->anc[n_anc++] = u;
+            for (size_t i = par_off[u]; i < par_off[u + 1]; i++) {
+                if (mark[par[i]] != stamp) {
+                    mark[par[i]] = stamp;
+                    stack[top++] = par[i];
+                }
+            }
+        }
+        qsort(p->anc + first, n_anc - first, sizeof *p->anc, cmp_u32);
+        p->anc_off[c + 1] = n_anc;
+
+        /* Rules of every ancestor; each rule has one class, so no repeats */
+        size_t flat_first = n_flat;
+        for (size_t i = first; i < n_anc; i++) {
+            uint32_t a = p->anc[i];
+            size_t k = own_off[a + 1] - own_off[a];
+            if (!grow((void **)&p->flat, &flat_cap, n_flat + k, sizeof *p->flat))
+                goto out;
+            memcpy(p->flat + n_flat, own + own_off[a], k * sizeof *own);
+            n_flat += k;
+        }
+        qsort(p->flat + flat_first, n_flat - flat_first, sizeof *p->flat, cmp_u32);
+        p->flat_off[c + 1] = n_flat;
+    }
+    p->compiled = true;
+    ok = true;
+
+out:
+    if (!ok) {
+        free(p->anc_off);
+        free(p->anc);
+        free(p->flat_off);
+        free(p->flat);
+        free(p->global);
+        p->anc_off = p->flat_off = NULL;
+        p->anc = p->flat = p->global = NULL;
+        p->n_global = 0;
+    }
+    free(par_off);
+    free(par);
+    free(own_off);
+    free(own);
+    free(rule_cls);
+    free(mark);
+    free(stack);
+    return ok;
+}
+
+size_t shp_flat_rules(const ShpProgram *p)
+{
+    return p->compiled ? p->flat_off[p->classes] : 0;
+}
+
+bool shp_is_a(const ShpProgram *p, uint32_t a, uint32_t b)
+{
+    if (!p->compiled || a >= p->classes)
+        return false;
+    return contains(p->anc + p->anc_off[a], p->anc_off[a + 1] - p->anc_off[a], b);
+}
+
+/* -------------------------------------------------------------------------
+ * Lexical forms
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const char *s, *end;
+} Lex;
+
+/* Exactly width digits; -1 if not. */
+static int lex_digits(Lex *l, int width)
+{
+    int v = 0;
+    for (int i = 0; i < width; i++, l->s++) {
+        if (l->s >= l->end || *l->s < '0' || *l->s > '9')
+            return -1;
+        v = v * 10 + (*l->s - '0');
+    }
+    return v;
+}
+
+static bool lex_char(Lex *l, char c)
+{
+    if (l->s < l->end && *l->s == c) {
+        l->s++;
+        return true;
+    }
+    return false;
+}
+
+/* Optional Z or +hh:mm / -hh:mm, then the end of the text. */
+static bool lex_zone_end(Lex *l)
+{
+    if (lex_char(l, 'Z'))
+        return l->s == l->end;
+    if (l->s < l->end && (*l->s == '+' || *l->s == '-')) {
+        l->s++;
+        int hh = lex_digits(l, 2);
+        if (hh < 0 || !lex_char(l, ':'))
+            return false;
+        int mm = lex_digits(l, 2);
+        if (mm < 0 || hh > 14 || mm > 59 || (hh == 14 && mm))
+            return false;
+    }
+    return l->s == l->end;
+}
+
+static bool lex_date(Lex *l)
+{
+    static const int days[12] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    lex_char(l, '-');
+    long year = 0;
+    int width = 0;
+    while (l->s < l->end && *l->s >= '0' && *l->s <= '9') {
+        if (year < 100000000)
+            year = year * 10 + (*l->s - '0');
+        l->s++;
+        width++;
+    }
+    if (width < 4 || !lex_char(l, '-'))
+        return false;
+    int month = lex_digits(l, 2);
+    if (month < 1 || month > 12 || !lex_char(l, '-'))
+        return false;
+    int day = lex_digits(l, 2);
+    if (day < 1 || day > days[month - 1])
+        return false;
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return !(month == 2 && day == 29 && !leap);
+}
+
+static bool lex_time(Lex *l)
+{
+    int hh = lex_digits(l, 2);
+    if (hh < 0 || !lex_char(l, ':'))
+        return false;
+    int mm = lex_digits(l, 2);
+    if (mm < 0 || !lex_char(l, ':'))
+        return false;
+    int ss = lex_digits(l, 2);
+    if (ss < 0)
+        return false;
+    bool fraction = false;
+    if (lex_char(l, '.')) {
+        int first = lex_digits(l, 1);
+        if (first < 0)
+            return false;
+        fraction = first != 0;  /* 24:00:00.000 is still midnight */
+        while (l->s < l->end && *l->s >= '0' && *l->s <= '9') {
+            if (*l->s != '0')
+                fraction = true;
+            l->s++;
+        }
+    }
+    if (hh == 24)
+        return mm == 0 && ss == 0 && !fraction;
+    return hh < 24 && mm < 60 && ss < 60;
+}
+
+static bool lex_integer(const char *s, const char *end)
+{
+    if (s < end && (*s == '+' || *s == '-'))
+        s++;
+    if (s == end)
+        return false;
+    for (; s < end; s++)
+        if (*s < '0' || *s > '9')
+            return false;
+    return true;
+}
+
+static bool lex_decimal(const char *s, const char *end)
+{
+    size_t n = (size_t)(end - s);
+    if ((n == 3 && (!memcmp(s, "INF", 3) || !memcmp(s, "NaN", 3))) ||
+        (n == 4 && (!memcmp(s, "-INF", 4) || !memcmp(s, "+INF", 4))))
+        return true;
+    if (s < end && (*s == '+' || *s == '-'))
+        s++;
+    size_t digits = 0;
+    for (; s < end && *s >= '0' && *s <= '9'; s++)
+        digits++;
+    if (s < end && *s == '.')
+        for (s++; s < end && *s >= '0' && *s <= '9'; s++)
+            digits++;
+    if (!digits)
+        return false;
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        s++;
+        return lex_integer(s, end);
+    }
+    return s == end;
+}
+
+static bool lex_ok(uint8_t kind, const char *s, const char *end, uint32_t mask)
+{
+    size_t n = (size_t)(end - s);
+    bool text = kind == SHP_STRING || kind == SHP_REF;
+
+    if ((mask & SHP_XSD_STRING) && text)
+        return true;
+    if ((mask & SHP_XSD_INTEGER) && (kind == SHP_INTEGER || (text && lex_integer(s, end))))
+        return true;
+    if ((mask & SHP_XSD_DECIMAL) &&
+        (kind == SHP_INTEGER || kind == SHP_NUMBER || (text && lex_decimal(s, end))))
+        return true;
+    if ((mask & SHP_XSD_BOOLEAN) &&
+        (kind == SHP_BOOLEAN ||
+         (text && ((n == 4 && !memcmp(s, "true", 4)) || (n == 5 && !memcmp(s, "false", 5)) ||
+                   (n == 1 && (*s == '0' || *s == '1'))))))
+        return true;
+    if (!text)
+        return false;
+    if (mask & SHP_XSD_DATE) {
+        Lex l = { s, end };
+        if (lex_date(&l) && lex_zone_end(&l))
+            return true;
+    }
+    if (mask & SHP_XSD_DATETIME) {
+        Lex l = { s, end };
+        if (lex_date(&l) && lex_char(&l, 'T') && lex_time(&l) && lex_zone_end(&l))
+            return true;
+    }
+    if (mask & SHP_XSD_TIME) {
+        Lex l = { s, end };
+        if (lex_time(&l) && lex_zone_end(&l))
+            return true;
+    }
+    if (mask & SHP_XSD_ANY_URI) {
+        for (; s < end; s++)
+            if ((unsigned char)*s <= ' ')
+                return false;
+        return true;
+    }
+    return false;
+}
+
+/* -------------------------------------------------------------------------
+ * Validation
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const ShpProgram *p;
+    const ShpBatch   *b;
+    VioList          *chunks;       /* one list per chunk */
+    uint32_t         *seen[MAX_THREADS];        /* rules */
+    uint32_t         *prop_stamp[MAX_THREADS];
+    uint32_t         *prop_count[MAX_THREADS];
+    uint64_t          checks[MAX_THREADS];
+    uint64_t          invalid[MAX_THREADS];
+    _Atomic bool      oom;
+} Check;
+
+typedef void (*RangeFn)(void *ctx, unsigned worker, size_t begin, size_t end);
+
+typedef struct {
+    RangeFn         fn;
+    void           *ctx;
+    size_t          n, chunk;
+    _Atomic size_t  next;
+} Ranges;
+
+typedef struct {
+    Ranges  *r;
+    unsigned worker;
+} RangeWorker;
+
+static unsigned thread_count(unsigned threads, size_t chunks)
+{
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads > chunks)
+        threads = chunks ? (unsigned)chunks : 1;
+    return threads;
+}
+
+static void *range_main(void *arg)
+{
+    RangeWorker *w = arg;
+    Ranges *r = w->r;
+    for (;;) {
+        size_t begin = atomic_fetch_add(&r->next, r->chunk);
+        if (begin >= r->n)
+            break;
+        size_t end = begin + r->chunk < r->n ? begin + r->chunk : r->n;
+        r->fn(r->ctx, w->worker, begin, end);
+    }
+    return NULL;
+}
+
+/*
+ * Run fn over [0, n) in chunks on `threads` workers (the caller is worker
+ * 0).  If a thread cannot be started its share falls to the others.
+ */
+static void parallel_ranges(size_t n, size_t chunk, unsigned threads, RangeFn fn, void *ctx)
+{
+    Ranges r = { .fn = fn, .ctx = ctx, .n = n, .chunk = chunk };
+    atomic_init(&r.next, 0);
+    RangeWorker workers[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    unsigned started = 1;
+
+    for (unsigned t = 0; t < threads; t++)
+        workers[t] = (RangeWorker){ &r, t };
+    for (; started < threads; started++)
+        if (pthread_create(&tids[started], NULL, range_main, &workers[started]) != 0)
+            break;
+    range_main(&workers[0]);
+    for (unsigned t = 1; t < started; t++)
+        pthread_join(tids[t], NULL);
+}
+
+static bool report(VioList *list, uint32_t inst, uint32_t rule, uint32_t value, uint32_t count)
+{
+    if (!grow((void **)&list->v, &list->cap, list->n + 1, sizeof *list->v))
+        return false;
+    list->v[list->n++] = (ShpViolation){ inst, rule, value, count };
+    return true;
+}
+
+/* True if entity e belongs to a class of set s. */
+static bool member(const ShpProgram *p, const ShpBatch *b, uint32_t e, uint32_t s)
+{
+    for (uint64_t i = b->type_off[e]; i < b->type_off[e + 1]; i++) {
+        uint32_t t = b->types[i];
+        const uint32_t *anc = p->anc + p->anc_off[t];
+        size_t n = p->anc_off[t + 1] - p->anc_off[t];
+        for (size_t k = p->set_off[s]; k < p->set_off[s + 1]; k++)
+            if (contains(anc, n, p->set_cls[k]))
+                return true;
+    }
+    return false;
+}
+
+/* Evaluate one rule on instance i; false on OOM. */
+static bool eval_rule(Check *c, unsigned w, uint32_t i, uint32_t r, VioList *out, bool *bad)
+{
+    const ShpProgram *p = c->p;
+    const ShpBatch *b = c->b;
+    const Rule *rule = &p->rules[r];
+    uint32_t count = c->prop_stamp[w][rule->prop] == i + 1 ? c->prop_count[w][rule->prop] : 0;
+    c->checks[w]++;
+
+    if (rule->op == SHP_MIN_COUNT || rule->op == SHP_MAX_COUNT) {
+        bool fail = rule->op == SHP_MIN_COUNT ? count < rule->arg : count > rule->arg;
+        if (fail) {
+            *bad = true;
+            return report(out, i, r, SHP_NONE, count);
+        }
+        return true;
+    }
+    if (count == 0)
+        return true;
+    for (uint64_t v = b->value_off[i]; v < b->value_off[i + 1]; v++) {
+        if (b->value_prop[v] != rule->prop)
+            continue;
+        bool fail;
+        if (rule->op == SHP_DATATYPE) {
+            const char *start = b->text + (v ? b->text_end[v - 1] : 0);
+            fail = !lex_ok(b->value_kind[v], start, b->text + b->text_end[v], rule->arg);
+        } else {
+            fail = b->value_kind[v] != SHP_REF || !member(p, b, b->value_target[v], rule->arg);
+        }
+        if (fail) {
+            *bad = true;
+            if (!report(out, i, r, (uint32_t)v, count))
+                return false;
+        }
+    }
+    return true;
+}
+
+static void check_range(void *ctx, unsigned w, size_t begin, size_t end)
+{
+    Check *c = ctx;
+    const ShpProgram *p = c->p;
+    const ShpBatch *b = c->b;
+    VioList *out = &c->chunks[begin / CHUNK];
+
+    for (size_t i = begin; i < end; i++) {
+        uint32_t stamp = (uint32_t)i + 1;
+        bool bad = false;
+        for (uint64_t v = b->value_off[i]; v < b->value_off[i + 1]; v++) {
+            uint32_t prop = b->value_prop[v];
+            if (prop >= p->n_props)
+                continue;
+            if (c->prop_stamp[w][prop] != stamp) {
+                c->prop_stamp[w][prop] = stamp;
+                c->prop_count[w][prop] = 0;
+            }
+            c->prop_count[w][prop]++;
+        }
+        for (uint64_t t = b->type_off[i]; t < b->type_off[i + 1]; t++) {
+            uint32_t cls = b->types[t];
+            for (size_t k = p->flat_off[cls]; k < p->flat_off[cls + 1]; k++) {
+                uint32_t r = p->flat[k];
+                if (c->seen[w][r] == stamp)
+                    continue;
+                c->seen[w][r] = stamp;
+                if (!eval_rule(c, w, (uint32_t)i, r, out, &bad))
+                    goto oom;
+            }
+        }
+        for (size_t k = 0; k < p->n_global; k++)
+            if (!eval_rule(c, w, (uint32_t)i, p->global[k], out, &bad))
+                goto oom;
+        c->invalid[w] += bad;
+    }
+    return;
+
+oom:
+    atomic_store(&c->oom, true);
+}
+
+static bool batch_ok(const ShpProgram *p, const ShpBatch *b)
+{
+    if (b->instances > b->entities || b->entities >= SHP_NONE)
+        return false;
+    if (b->entities && (!b->type_off || b->type_off[0] != 0))
+        return false;
+    for (size_t e = 0; e < b->entities; e++) {
+        if (b->type_off[e + 1] < b->type_off[e])
+            return false;
+        for (uint64_t t = b->type_off[e]; t < b->type_off[e + 1]; t++)
+            if (b->types[t] >= p->classes)
+                return false;
+    }
+    if (b->instances && (!b->value_off || b->value_off[0] != 0 ||
+                         b->value_off[b->instances] >= SHP_NONE))
+        return false;
+    uint64_t prev = 0;
+    for (size_t i = 0; i < b->instances; i++) {
+        if (b->value_off[i + 1] < b->value_off[i])
+            return false;
+        for (uint64_t v = b->value_off[i]; v < b->value_off[i + 1]; v++) {
+            if (b->value_kind[v] > SHP_REF || b->text_end[v] < prev)
+                return false;
+            if (b->value_kind[v] == SHP_REF && b->value_target[v] >= b->entities)
+                return false;
+            prev = b->text_end[v];
+        }
+    }
+    return true;
+}
+
+int64_t shp_validate(const ShpProgram *p, const ShpBatch *b, unsigned threads,
+                     ShpViolation *out, size_t cap, ShpStats *stats)
+{
+    if (!p->compiled || !batch_ok(p, b))
+        return -1;
+
+    size_t n = b->instances;
+    size_t n_chunks = (n + CHUNK - 1) / CHUNK;
+    if (n < PAR_MIN)
+        threads = 1;
+    threads = thread_count(threads, n_chunks);
+
+    Check c;
+    memset(&c, 0, sizeof c);
+    c.p = p;
+    c.b = b;
+    atomic_init(&c.oom, false);
+    c.chunks = calloc(n_chunks ? n_chunks : 1, sizeof *c.chunks);
+    bool ok = c.chunks != NULL;
+    for (unsigned t = 0; ok && t < threads; t++) {
+        c.seen[t] = calloc(p->n_rules ? p->n_rules : 1, sizeof **c.seen);
+        c.prop_stamp[t] = calloc(p->n_props ? p->n_props : 1, sizeof **c.prop_stamp);
+        c.prop_count[t] = malloc((p->n_props ? p->n_props : 1) * sizeof **c.prop_count);
+        ok = c.seen[t] && c.prop_stamp[t] && c.prop_count[t];
+    }
+    int64_t written = -1;
+    if (ok) {
+        parallel_ranges(n, CHUNK, threads, check_range, &c);
+        ok = !atomic_load(&c.oom);
+    }
+    if (ok) {
+        ShpStats s = { 0, 0, 0, threads };
+        written = 0;
+        for (size_t k = 0; k < n_chunks; k++) {
+            VioList *l = &c.chunks[k];
+            s.violations += l->n;
+            size_t take = cap - (size_t)written < l->n ? cap - (size_t)written : l->n;
+            if (take)
+                memcpy(out + written, l->v, take * sizeof *l->v);
+            written += (int64_t)take;
+        }
+        for (unsigned t = 0; t < threads; t++) {
+            s.checks += c.checks[t];
+            s.invalid += c.invalid[t];
+        }
+        if (stats)
+            *stats = s;
+    }
+
+    for (size_t k = 0; c.chunks && k < n_chunks; k++)
+        free(c.chunks[k].v);
+    free(c.chunks);
+    for (unsigned t = 0; t < MAX_THREADS; t++) {
+        free(c.seen[t]);
+        free(c.prop_stamp[t]);
+        free(c.prop_count[t]);
+    }
+    return written;
+}
@@ -0,0 +1,143 @@
+/**
+ * shapes.h — Compiled shape validation for bulk instance checks
+ *
+ * A program holds the constraints of an ontology's classes as flat rules
+ * over integer IDs (classes, properties and class sets are numbered by
+ * the caller):
+ *
+ *   SHP_MIN_COUNT  the instance has at least arg values of prop
+ *                  (arg 1 = required)
+ *   SHP_MAX_COUNT  it has at most arg values of prop
+ *   SHP_DATATYPE   every value of prop is a lexically valid literal of
+ *                  one of the XSD types in the mask arg
+ *   SHP_RANGE      every value of prop refers to an entity that belongs
+ *                  to a class of set arg, directly or through a subclass
+ *
+ * Rules attach to a class, or to SHP_ALL for every instance.  Rules are
+ * inherited: shp_compile closes the subclass edges into each class's
+ * sorted ancestor list (itself included; cycles are harmless) and
+ * flattens the rules of all its ancestors into one list per class, so
+ * checking an instance is a walk over the lists of its classes, with no
+ * hierarchy lookups.  Membership tests for SHP_RANGE binary-search the
+ * ancestor lists.
+ *
+ * A batch is a table of entities in CSR form: every entity has classes,
+ * and the first `instances` entities, the ones checked, have values.  A
+ * value names its property, a kind, the entity it refers to (for
+ * SHP_REF) and its lexical form.  Instances are split into chunks that
+ * worker threads claim from a shared counter; violations come back in
+ * instance order however many threads ran.
+ */
+
+#ifndef SHAPES_H
+#define SHAPES_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHP_ALL   UINT32_MAX    /* rule class: every instance           */
+#define SHP_NONE  UINT32_MAX    /* no target entity / no single value   */
+
+/* Rule operators */
+enum {
+    SHP_MIN_COUNT = 1,
+    SHP_MAX_COUNT = 2,
+    SHP_DATATYPE  = 3,
+    SHP_RANGE     = 4,
+};
+
+/* SHP_DATATYPE masks */
+enum {
+    SHP_XSD_STRING   = 1u << 0,
+    SHP_XSD_INTEGER  = 1u << 1,
+    SHP_XSD_DECIMAL  = 1u << 2,   /* decimal, float, double */
+    SHP_XSD_BOOLEAN  = 1u << 3,
+    SHP_XSD_DATE     = 1u << 4,
+    SHP_XSD_DATETIME = 1u << 5,
+    SHP_XSD_TIME     = 1u << 6,
+    SHP_XSD_ANY_URI  = 1u << 7,
+};
+
+/* Value kinds (how the value was written, before its lexical form) */
+enum {
+    SHP_STRING  = 0,
+    SHP_INTEGER = 1,
+    SHP_NUMBER  = 2,
+    SHP_BOOLEAN = 3,
+    SHP_REF     = 4,            /* names an entity of the batch */
+};
+
+typedef struct ShpProgram ShpProgram;
+
+typedef struct {
+    size_t          instances;  /* entities 0 .. instances - 1 are checked */
+    size_t          entities;
+    const uint64_t *type_off;   /* entities + 1 */
+    const uint32_t *types;      /* class IDs */
+    const uint64_t *value_off;  /* instances + 1 */
+    const uint32_t *value_prop;
+    const uint8_t  *value_kind;
+    const uint32_t *value_target;   /* entity of a SHP_REF value, else SHP_NONE */
+    const uint64_t *text_end;   /* value i's text ends at text_end[i] and
+                                   starts where value i - 1's ends */
+    const char     *text;
+} ShpBatch;
+
+typedef struct {
+    uint32_t instance;
+    uint32_t rule;              /* ID from shp_add_rule */
+    uint32_t value;             /* offending value (index into the batch's
+                                   values), SHP_NONE for count rules */
+    uint32_t count;             /* values of the rule's property */
+} ShpViolation;
+
+typedef struct {
+    uint64_t violations;        /* all found, including those past cap */
+    uint64_t invalid;           /* instances with a violation */
+    uint64_t checks;            /* rules evaluated */
+    unsigned threads;
+} ShpStats;
+
+ShpProgram *shp_program_create(size_t classes);
+void shp_program_free(ShpProgram *p);
+
+/** Subclass edge.  False for IDs out of range, after compile or OOM. */
+bool shp_add_parent(ShpProgram *p, uint32_t cls, uint32_t parent);
+
+/** Union of classes for SHP_RANGE.  Returns its ID, or -1. */
+int64_t shp_add_class_set(ShpProgram *p, const uint32_t *classes, size_t n);
+
+/**
+ * Rule on cls (or SHP_ALL).  Returns its ID, or -1 for an unknown class,
+ * operator or class set, a rule added after compile, or OOM.
+ */
+int64_t shp_add_rule(ShpProgram *p, uint32_t cls, uint32_t op, uint32_t prop, uint32_t arg);
+
+/** Close the hierarchy and flatten the rules.  Nothing can be added after. */
+bool shp_compile(ShpProgram *p);
+
+/** Rules in the flattened lists (inherited rules counted per class). */
+size_t shp_flat_rules(const ShpProgram *p);
+
+/** True if a is b or one of its ancestors (compiled programs only). */
+bool shp_is_a(const ShpProgram *p, uint32_t a, uint32_t b);
+
+/**
+ * Check a batch.  Writes up to cap violations to out, in instance order,
+ * and the totals to stats (may be NULL).  threads 0 = one per online CPU.
+ * Returns the number written, or -1 for an uncompiled program, a batch
+ * with class or entity IDs out of range or decreasing offsets, or OOM.
+ */
+int64_t shp_validate(const ShpProgram *p, const ShpBatch *b, unsigned threads,
+                     ShpViolation *out, size_t cap, ShpStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHAPES_H */
@@ -6,14 +6,52 @@
  *   - FNV-1a 64-bit hash
  *   - Automatic resize at load factor > 0.75 (doubles capacity)
  *   - All keys and values are heap-allocated copies
+ *   - Multi-version values: every write commits a new version number and,
+ *     while snapshots are held, pushes onto a per-key version chain
+ *     (newest first) instead of overwriting.  Deletes push a tombstone.
+ *   - Garbage collection by watermark: a chain keeps every version newer
+ *     than the oldest live snapshot plus the one that snapshot sees.
+ *     Entries with retained history sit on an intrusive GC list that is
+ *     swept whenever the oldest snapshot is released.
+ *   - Temporal history (db_history_enable): the watermark additionally
+ *     stops at a history floor, so every version since the floor stays on
+ *     its chain and db_snapshot_at can pin any of them.  Each version has a
+ *     skew-binary jump pointer (Myers' random-access lists), so finding
+ *     the version visible at an old commit is O(log chain length) instead
+ *     of a walk over every later change.  db_compact raises the floor and
+ *     sweeps.  A time index maps wall-clock milliseconds to commits.
+ *   - Entry and Version nodes come from per-table slabs; the bucket array
+ *     and slab chunks are "regions" that may be backed by 2MB pages and
+ *     bound or interleaved across NUMA nodes (see DBOptions).  Huge pages
+ *     cut TLB misses on random lookups once the table spans gigabytes.
+ *   - Replication log (db_log_enable): committed writes are also copied
+ *     onto a ring of records tagged with their version, trimmed a whole
+ *     commit at a time from the oldest end to stay under a byte limit.
+ *     Followers read it from their position and replay it commit by
+ *     commit; a dump of a snapshot seeds followers the log cannot serve.
+ *
+ * Invariant: with no snapshots held and history off, every entry has
+ * exactly one version and it is not a tombstone — the single-version fast
+ * path is the original update-in-place table.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  /* MAP_ANONYMOUS, MAP_HUGETLB, MADV_HUGEPAGE, syscall */
+#endif
+
 #include "simple_db.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 /* -------------------------------------------------------------------------
  * Internal structures
@@ -22,16 +60,109 @@
 #define INITIAL_CAPACITY  64u
 #define LOAD_FACTOR_MAX   0.75
 
+#define HUGE_PAGE_SIZE    ((size_t)2 << 20)
+#define HEAP_SLAB_SIZE    ((size_t)64 << 10)   /* chunk size without policies */
+#define SLAB_HEADER_SIZE  64u                  /* keeps objects cache-aligned */
+#define NUMA_MAX_NODES    64u                  /* one unsigned long nodemask  */
+
+/* Linux mempolicy modes (numaif.h), so libnuma is not a build dependency */
+#define MPOL_BIND_MODE        2
+#define MPOL_INTERLEAVE_MODE  3
+
+/* A bucket array or slab chunk obtained from region_alloc. */
+typedef struct {
+    size_t len;               /* bytes reserved                     */
+    bool   huge;              /* backed by huge pages               */
+} Region;
+
+typedef struct SlabChunk {
+    struct SlabChunk *next;
+    Region            region;
+} SlabChunk;
+
+/* Fixed-size object allocator carving chunks into a free list. */
+typedef struct {
+    size_t     obj_size;
+    void      *free_list;     /* first word of a free object links  */
+    SlabChunk *chunks;
+} SlabPool;
+
+typedef struct Version {
+    char           *value;    /* NULL marks a deletion (tombstone) */
+    uint64_t        version;  /* commit that wrote this value      */
+    struct Version *older;
+    struct Version *jump;     /* some older version (skip pointer)  */
+    uint32_t        depth;    /* position in the chain, oldest = 0  */
+} Version;
+
 typedef struct Entry {
-    char        *key;
-    char        *value;
+    char         *key;
+    Version      *head;       /* newest version first */
     struct Entry *next;       /* chained collision list */
+    struct Entry *gc_next;    /* link on SimpleDB.gc_list */
+    bool          on_gc;
 } Entry;
 
+struct DBSnapshot {
+    SimpleDB   *db;
+    uint64_t    version;
+    DBSnapshot *prev;
+    DBSnapshot *next;
+};
+
+/* One logged write; key == NULL clears the table, value == NULL deletes. */
+typedef struct {
+    uint64_t version;
+    char    *key;
+    char    *value;
+    size_t   bytes;           /* encoded size                       */
+} LogRecord;
+
+/* First commit made in a wall-clock millisecond (history mode). */
+typedef struct {
+    uint64_t version;
+    int64_t  ms;
+} TimeMark;
+
 struct SimpleDB {
     Entry  **buckets;
     size_t   capacity;
-    size_t   count;
+    size_t   count;           /* keys live in the current version   */
+    size_t   slots;           /* Entry objects, live or tombstoned  */
+    size_t   versions;        /* Version objects across all chains  */
+    uint64_t version;         /* last committed version             */
+
+    DBSnapshot *snap_oldest;  /* sorted by version                  */
+    DBSnapshot *snap_newest;
+    size_t      n_snapshots;
+
+    bool      history;        /* keep versions back to floor        */
+    uint64_t  floor;          /* oldest commit history can read     */
+    TimeMark *marks;          /* ascending in version and ms        */
+    size_t    n_marks;
+    size_t    cap_marks;
+
+    bool       logging;       /* replication log enabled            */
+    uint64_t   log_floor;     /* last commit before the oldest record */
+    size_t     log_limit;     /* encoded bytes kept                 */
+    size_t     log_bytes;
+    LogRecord *log;           /* ring, oldest at log_head           */
+    size_t     log_head;
+    size_t     log_len;
+    size_t     log_cap;
+
+    Entry  *gc_list;          /* entries carrying history           */
+    pthread_mutex_t lock;
+
+    DBOptions     opts;       /* requested policies                 */
+    DBPagePolicy  eff_pages;  /* weakest page policy obtained       */
+    DBNumaPolicy  eff_numa;   /* weakest NUMA policy obtained       */
+    unsigned long numa_mask;  /* online nodes, for interleave       */
+    Region        bucket_region;
+    SlabPool      entry_pool;
+    SlabPool      version_pool;
+    size_t        table_bytes;
+    size_t        huge_bytes;
 };
 
 /* -------------------------------------------------------------------------
@@ -66,15 +197,219 @@ static char *dup_str(const char *s)
     return d;
 }
 
-static void free_entries(Entry **buckets, size_t capacity)
+/* -------------------------------------------------------------------------
+ * Memory regions (huge pages / NUMA placement)
+ * ---------------------------------------------------------------------- */
+
+static inline bool heap_only(const SimpleDB *db)
+{
+    return db->opts.pages == DB_PAGES_DEFAULT && db->opts.numa == DB_NUMA_DEFAULT;
+}
+
+/* Parse /sys/devices/system/node/online ("0", "0-1", "0,2-3"). */
+static unsigned long online_numa_nodes(void)
+{
+    unsigned long mask = 0;
+    FILE *f = fopen("/sys/devices/system/node/online", "r");
+    if (f) {
+        unsigned lo, hi;
+        int c;
+        while (fscanf(f, "%u", &lo) == 1) {
+            hi = lo;
+            if ((c = fgetc(f)) == '-') {
+                if (fscanf(f, "%u", &hi) != 1) break;
+                c = fgetc(f);
+            }
+            for (unsigned n = lo; n <= hi && n < NUMA_MAX_NODES; n++) mask |= 1UL << n;
+            if (c != ',') break;
+        }
+        fclose(f);
+    }
+    return mask ? mask : 1UL;
+}
+
+/* Apply the NUMA policy to a fresh, untouched mapping. */
+static bool numa_place(const SimpleDB *db, void *p, size_t len)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    unsigned long mask;
+    int mode;
+    if (db->opts.numa == DB_NUMA_BIND) {
+        if (db->opts.numa_node < 0 || (unsigned)db->opts.numa_node >= NUMA_MAX_NODES) {
+            return false;
+        }
+        mask = 1UL << db->opts.numa_node;
+        mode = MPOL_BIND_MODE;
+    } else {
+        mask = db->numa_mask;
+        mode = MPOL_INTERLEAVE_MODE;
+    }
+    return syscall(SYS_mbind, p, len, mode, &mask, NUMA_MAX_NODES + 1, 0) == 0;
+#else
+    (void)db; (void)p; (void)len;
+    return false;
+#endif
+}
+
+/*
+ * Zeroed memory placed according to the table's policies.  Without
+ * policies this is plain calloc; otherwise an anonymous mapping, rounded to
+ * the huge page size when huge pages are requested.  Failures to obtain a
+ * policy degrade eff_pages / eff_numa instead of failing the allocation.
+ * For DB_PAGES_TRANSPARENT a successful madvise counts as huge: the kernel
+ * backs the range with 2MB pages whenever it can.
+ */
+static void *region_alloc(SimpleDB *db, size_t bytes, Region *r)
+{
+    r->huge = false;
+    if (heap_only(db)) {
+        r->len = bytes;
+        void *p = calloc(1, bytes);
+        if (p) db->table_bytes += bytes;
+        return p;
+    }
+
+    bool   want_huge = db->opts.pages != DB_PAGES_DEFAULT;
+    size_t align     = want_huge ? HUGE_PAGE_SIZE : (size_t)sysconf(_SC_PAGESIZE);
+    size_t len       = (bytes + align - 1) & ~(align - 1);
+    DBPagePolicy got = DB_PAGES_DEFAULT;
+    void  *p         = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    if (db->opts.pages == DB_PAGES_HUGETLB) {
+        p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) got = DB_PAGES_HUGETLB;
+    }
+#endif
+    if (p == MAP_FAILED) {
+        p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+        if (want_huge && madvise(p, len, MADV_HUGEPAGE) == 0) got = DB_PAGES_TRANSPARENT;
+#endif
+    }
+    if (got < db->eff_pages) db->eff_pages = got;
+
+    if (db->opts.numa != DB_NUMA_DEFAULT && !numa_place(db, p, len)) {
+        db->eff_numa = DB_NUMA_DEFAULT;
+    }
+
+    r->len  = len;
+    r->huge = got != DB_PAGES_DEFAULT;
+    db->table_bytes += len;
+    if (r->huge) db->huge_bytes += len;
+    return p;
+}
+
+static void region_free(SimpleDB *db, void *p, const Region *r)
+{
+    if (!p) return;
+    db->table_bytes -= r->len;
+    if (r->huge) db->huge_bytes -= r->len;
+    if (heap_only(db)) free(p);
+    else               munmap(p, r->len);
+}
+
+/* -------------------------------------------------------------------------
+ * Slabs for Entry / Version nodes
+ * ---------------------------------------------------------------------- */
+
+static void slab_init(SlabPool *pool, size_t obj_size)
+{
+    pool->obj_size  = (obj_size + 7u) & ~(size_t)7u;
+    pool->free_list = NULL;
+    pool->chunks    = NULL;
+}
+
+static bool slab_grow(SimpleDB *db, SlabPool *pool)
+{
+    Region r;
+    size_t want = heap_only(db) ? HEAP_SLAB_SIZE : HUGE_PAGE_SIZE;
+    SlabChunk *c = region_alloc(db, want, &r);
+    if (!c) return false;
+
+    c->region    = r;
+    c->next      = pool->chunks;
+    pool->chunks = c;
+
+    /* Thread back to front so allocation walks the chunk forwards */
+    char  *base = (char *)c + SLAB_HEADER_SIZE;
+    size_t n    = (r.len - SLAB_HEADER_SIZE) / pool->obj_size;
+    for (size_t i = n; i-- > 0; ) {
+        void *obj = base + i * pool->obj_size;
+        *(void **)obj   = pool->free_list;
+        pool->free_list = obj;
+    }
+    return true;
+}
+
+static void *slab_alloc(SimpleDB *db, SlabPool *pool)
+{
+    if (!pool->free_list && !slab_grow(db, pool)) return NULL;
+    void *obj = pool->free_list;
+    pool->free_list = *(void **)obj;
+    return obj;
+}
+
+static inline void slab_free(SlabPool *pool, void *obj)
+{
+    *(void **)obj   = pool->free_list;
+    pool->free_list = obj;
+}
+
+static void slab_release(SimpleDB *db, SlabPool *pool)
+{
+    SlabChunk *c = pool->chunks;
+    while (c) {
+        SlabChunk *next = c->next;
+        Region r = c->region;
+        region_free(db, c, &r);
+        c = next;
+    }
+    pool->chunks    = NULL;
+    pool->free_list = NULL;
+}
+
+static inline Version *version_alloc(SimpleDB *db)
+{
+    return slab_alloc(db, &db->version_pool);
+}
+
+static void free_chain(SimpleDB *db, Version *v)
+{
+    while (v) {
+        Version *older = v->older;
+        free(v->value);
+        slab_free(&db->version_pool, v);
+        v = older;
+    }
+}
+
+/* Free every key and value, then hand all slab chunks back at once. */
+static void free_entries(SimpleDB *db)
 {
-    for (size_t i = 0; i < capacity; i++) {
-        Entry *e = buckets[i];
+    for (size_t i = 0; i < db->capacity; i++) {
+        for (Entry *e = db->buckets[i]; e; e = e->next) {
+            free(e->key);
+            for (Version *v = e->head; v; v = v->older) free(v->value);
+        }
+    }
+    slab_release(db, &db->entry_pool);
+    slab_release(db, &db->version_pool);
+}
+
+/* Free every entry back to its pool, keeping the slab chunks (they may
+ * hold objects set aside for prepared writes). */
+static void drop_entries(SimpleDB *db)
+{
+    for (size_t i = 0; i < db->capacity; i++) {
+        Entry *e = db->buckets[i];
         while (e) {
             Entry *next = e->next;
+            free_chain(db, e->head);
             free(e->key);
-            free(e->value);
-            free(e);
+            slab_free(&db->entry_pool, e);
             e = next;
         }
     }
@@ -83,7 +418,8 @@ static void free_entries(Entry **buckets, size_t capacity)
 /* Resize: rehash all entries into a new bucket array of new_cap (must be power-of-2). */
 static bool rehash(SimpleDB *db, size_t new_cap)
 {
-    Entry **new_buckets = calloc(new_cap, sizeof(Entry *));
+    Region  new_region;
+    Entry **new_buckets = region_alloc(db, new_cap * sizeof(Entry *), &new_region);
     if (!new_buckets) return false;
 
     for (size_t i = 0; i < db->capacity; i++) {
@@ -97,207 +433,1568 @@ static bool rehash(SimpleDB *db, size_t new_cap)
         }
     }
 
-    free(db->buckets);
-    db->buckets  = new_buckets;
-    db->capacity = new_cap;
+    region_free(db, db->buckets, &db->bucket_region);
+    db->buckets       = new_buckets;
+    db->bucket_region = new_region;
+    db->capacity      = new_cap;
     return true;
 }
 
-/* -------------------------------------------------------------------------
- * Lifecycle
- * ---------------------------------------------------------------------- */
+static Entry *find_entry(const SimpleDB *db, const char *key, size_t idx)
+{
+    Entry *e = db->buckets[idx];
+    while (e) {
+        if (strcmp(e->key, key) == 0) return e;
+        e = e->next;
+    }
+    return NULL;
+}
 
-SimpleDB *db_create(void)
+/* Step from v (committed after `at`) towards older versions, taking the
+ * jump pointer when it does not overshoot. */
+static inline Version *step_back(const Version *v, uint64_t at)
 {
-    SimpleDB *db = malloc(sizeof(SimpleDB));
-    if (!db) return NULL;
+    return v->jump && v->jump->version > at ? v->jump : v->older;
+}
 
-    db->buckets = calloc(INITIAL_CAPACITY, sizeof(Entry *));
-    if (!db->buckets) { free(db); return NULL; }
+/* Newest version of e committed at or before `at`, or NULL. */
+static const Version *visible(const Entry *e, uint64_t at)
+{
+    const Version *v = e->head;
+    while (v && v->version > at) v = step_back(v, at);
+    return v;
+}
 
-    db->capacity = INITIAL_CAPACITY;
-    db->count    = 0;
-    return db;
+/* Make v the head of e's chain and set its jump pointer: if the parent's
+ * jump spans as many versions as the jump after it, skip both. */
+static void link_version(Entry *e, Version *v)
+{
+    Version *p = e->head;
+    v->older = p;
+    v->depth = p ? p->depth + 1 : 0;
+    if (p && p->jump && p->jump->jump &&
+        p->depth - p->jump->depth == p->jump->depth - p->jump->jump->depth) {
+        v->jump = p->jump->jump;
+    } else {
+        v->jump = p;
+    }
+    e->head = v;
 }
 
-void db_destroy(SimpleDB *db)
+static inline bool single_version(const SimpleDB *db)
 {
-    if (!db) return;
-    free_entries(db->buckets, db->capacity);
-    free(db->buckets);
-    free(db);
+    return db->n_snapshots == 0 && !db->history;
 }
 
-/* -------------------------------------------------------------------------
- * CRUD
- * ---------------------------------------------------------------------- */
+/* Oldest commit every chain can still answer for. */
+static uint64_t watermark(const SimpleDB *db)
+{
+    uint64_t w = db->version;
+    if (db->history && db->floor < w) w = db->floor;
+    if (db->snap_oldest && db->snap_oldest->version < w) w = db->snap_oldest->version;
+    return w;
+}
 
-bool db_set(SimpleDB *db, const char *key, const char *value)
+static void mark_time(SimpleDB *db)
 {
-    if (!db || !key || !value) return false;
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    int64_t ms = (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 
-    /* Resize if load factor exceeded */
-    if ((double)(db->count + 1) / (double)db->capacity > LOAD_FACTOR_MAX) {
-        if (!rehash(db, db->capacity * 2)) return false;
+    if (db->n_marks && db->marks[db->n_marks - 1].ms >= ms) return;
+    if (db->n_marks == db->cap_marks) {
+        size_t    cap = db->cap_marks ? db->cap_marks * 2 : 64;
+        TimeMark *m   = realloc(db->marks, cap * sizeof(TimeMark));
+        if (!m) return;   /* coarser time resolution, nothing lost */
+        db->marks     = m;
+        db->cap_marks = cap;
     }
+    db->marks[db->n_marks].version = db->version;
+    db->marks[db->n_marks].ms      = ms;
+    db->n_marks++;
+}
 
-    uint64_t hash = fnv1a(key);
-    size_t   idx  = bucket_index(hash, db->capacity);
-    Entry   *e    = db->buckets[idx];
+/* Allocate the next commit number. */
+static inline uint64_t commit(SimpleDB *db)
+{
+    ++db->version;
+    if (db->history) mark_time(db);
+    return db->version;
+}
 
-    /* Update existing entry */
-    while (e) {
-        if (strcmp(e->key, key) == 0) {
-            char *new_val = dup_str(value);
-            if (!new_val) return false;
-            free(e->value);
-            e->value = new_val;
-            return true;
+static inline bool live_now(const Entry *e)
+{
+    return e->head->value != NULL;
+}
+
+static inline bool live_at(const Entry *e, const DBSnapshot *snap)
+{
+    if (!snap) return live_now(e);
+    const Version *v = visible(e, snap->version);
+    return v && v->value;
+}
+
+/* -------------------------------------------------------------------------
+ * Version-chain garbage collection
+ * ---------------------------------------------------------------------- */
+
+/*
+ * Drop versions no reader can reach.  Keeps everything newer than the
+ * watermark (oldest snapshot or history floor) plus the version visible
+ * there; with neither only the head survives.  Returns true if the entry is
+ * now invisible to every reader (all surviving versions are tombstones) and
+ * can be unlinked.
+ */
+static bool prune_entry(SimpleDB *db, Entry *e)
+{
+    uint64_t at   = watermark(db);
+    Version *keep = e->head;
+    while (keep->older && keep->version > at) keep = step_back(keep, at);
+
+    Version *dead = keep->older;
+    if (dead) {
+        /* Survivors must not jump into the freed tail.  Compare chain
+         * positions: one commit may leave two versions with one number. */
+        for (Version *v = e->head; v != keep; v = v->older) {
+            if (v->jump && v->jump->depth < keep->depth) v->jump = keep;
         }
-        e = e->next;
+        keep->jump = NULL;
+    }
+    keep->older = NULL;
+    while (dead) {
+        Version *older = dead->older;
+        free(dead->value);
+        slab_free(&db->version_pool, dead);
+        db->versions--;
+        dead = older;
     }
 
-    /* Insert new entry at head of chain */
-    Entry *ne = malloc(sizeof(Entry));
-    if (!ne) return false;
+    for (const Version *v = e->head; v; v = v->older) {
+        if (v->value) return false;
+    }
+    return true;
+}
 
-    ne->key = dup_str(key);
-    if (!ne->key) { free(ne); return false; }
+static void unlink_entry(SimpleDB *db, Entry *target)
+{
+    size_t  idx  = bucket_index(fnv1a(target->key), db->capacity);
+    Entry **prev = &db->buckets[idx];
+    while (*prev && *prev != target) prev = &(*prev)->next;
+    if (*prev) *prev = target->next;
 
-    ne->value = dup_str(value);
-    if (!ne->value) { free(ne->key); free(ne); return false; }
+    for (Version *v = target->head; v; v = v->older) db->versions--;
+    free(target->key);
+    free_chain(db, target->head);
+    slab_free(&db->entry_pool, target);
+    db->slots--;
+}
 
-    ne->next          = db->buckets[idx];
-    db->buckets[idx]  = ne;
-    db->count++;
-    return true;
+static inline bool has_history(const Entry *e)
+{
+    return e->head->older != NULL || e->head->value == NULL;
 }
 
-const char *db_get(SimpleDB *db, const char *key)
+static void track_history(SimpleDB *db, Entry *e)
 {
-    if (!db || !key) return NULL;
+    if (e->on_gc || !has_history(e)) return;
+    e->on_gc   = true;
+    e->gc_next = db->gc_list;
+    db->gc_list = e;
+}
 
-    size_t  idx = bucket_index(fnv1a(key), db->capacity);
-    Entry  *e   = db->buckets[idx];
+/* Re-prune every entry with history against the current watermark. */
+static void gc_sweep(SimpleDB *db)
+{
+    Entry *e = db->gc_list;
+    db->gc_list = NULL;
 
     while (e) {
-        if (strcmp(e->key, key) == 0) return e->value;
-        e = e->next;
+        Entry *next = e->gc_next;
+        e->on_gc   = false;
+        e->gc_next = NULL;
+
+        if (prune_entry(db, e)) {
+            unlink_entry(db, e);
+        } else {
+            track_history(db, e);
+        }
+        e = next;
     }
-    return NULL;
 }
 
-bool db_delete(SimpleDB *db, const char *key)
+/* Push v as the new head version committed at `version` (0 = a new
+ * commit).  value == NULL records a deletion. */
+static void push_version(SimpleDB *db, Entry *e, Version *v, char *value, uint64_t version)
 {
-    if (!db || !key) return false;
+    v->value   = value;
+    v->version = version ? version : commit(db);
+    link_version(e, v);
+    db->versions++;
 
-    size_t  idx  = bucket_index(fnv1a(key), db->capacity);
-    Entry **prev = &db->buckets[idx];
-    Entry  *e    = *prev;
+    if (prune_entry(db, e)) {
+        unlink_entry(db, e);
+    } else {
+        track_history(db, e);
+    }
+}
 
-    while (e) {
-        if (strcmp(e->key, key) == 0) {
-            *prev = e->next;
-            free(e->key);
-            free(e->value);
-            free(e);
-            db->count--;
-            return true;
+/* -------------------------------------------------------------------------
+ * Replication log records
+ * ---------------------------------------------------------------------- */
+
+#define LOG_RECORD_HEADER 16u   /* u64 version, u32 key bytes, u32 value bytes */
+
+static inline LogRecord *log_at(const SimpleDB *db, size_t i)
+{
+    return &db->log[(db->log_head + i) % db->log_cap];
+}
+
+static void log_free_record(LogRecord *r)
+{
+    free(r->key);
+    free(r->value);
+}
+
+/* Drop every record; followers behind the current version must resync
+ * from a dump. */
+static void log_reset(SimpleDB *db)
+{
+    for (size_t i = 0; i < db->log_len; i++) log_free_record(log_at(db, i));
+    db->log_head  = 0;
+    db->log_len   = 0;
+    db->log_bytes = 0;
+    db->log_floor = db->version;
+}
+
+/* Drop the oldest commits until the log fits its limit.  Called once a
+ * commit is complete, so no commit is ever kept in part. */
+static void log_trim(SimpleDB *db)
+{
+    while (db->log_len && db->log_bytes > db->log_limit) {
+        uint64_t oldest = log_at(db, 0)->version;
+        while (db->log_len && log_at(db, 0)->version == oldest) {
+            LogRecord *r = log_at(db, 0);
+            db->log_bytes -= r->bytes;
+            log_free_record(r);
+            db->log_head = (db->log_head + 1) % db->log_cap;
+            db->log_len--;
         }
-        prev = &e->next;
-        e    = e->next;
+        db->log_floor = oldest;
     }
-    return false;
 }
 
-bool db_exists(SimpleDB *db, const char *key)
+/* Log one write of commit `version` (key == NULL: clear, value == NULL:
+ * delete).  Without memory the log is reset rather than left with a hole. */
+static void log_write(SimpleDB *db, uint64_t version, const char *key, const char *value)
 {
-    return db_get(db, key) != NULL;
+    if (!db->logging) return;
+
+    size_t klen = key ? strlen(key) + 1 : 0;
+    size_t vlen = value ? strlen(value) + 1 : 0;
+    if (klen > UINT32_MAX || vlen > UINT32_MAX) goto fail;
+
+    if (db->log_len == db->log_cap) {
+        size_t     cap  = db->log_cap ? db->log_cap * 2 : 256;
+        LogRecord *ring = malloc(cap * sizeof(LogRecord));
+        if (!ring) goto fail;
+        for (size_t i = 0; i < db->log_len; i++) ring[i] = *log_at(db, i);
+        free(db->log);
+        db->log      = ring;
+        db->log_head = 0;
+        db->log_cap  = cap;
+    }
+
+    LogRecord r = { version, NULL, NULL, LOG_RECORD_HEADER + klen + vlen };
+    if ((key && !(r.key = dup_str(key))) || (value && !(r.value = dup_str(value)))) {
+        log_free_record(&r);
+        goto fail;
+    }
+    *log_at(db, db->log_len) = r;
+    db->log_len++;
+    db->log_bytes += r.bytes;
+    return;
+
+fail:
+    log_reset(db);
 }
 
 /* -------------------------------------------------------------------------
- * Utility
+ * Lifecycle
  * ---------------------------------------------------------------------- */
 
-size_t db_count(SimpleDB *db)
+DBOptions db_options_default(void)
 {
-    return db ? db->count : 0;
+    DBOptions o = { 0, DB_PAGES_DEFAULT, DB_NUMA_DEFAULT, 0 };
+    return o;
 }
 
-void db_clear(SimpleDB *db)
+SimpleDB *db_create(void)
 {
-    if (!db) return;
-    free_entries(db->buckets, db->capacity);
-    memset(db->buckets, 0, db->capacity * sizeof(Entry *));
-    db->count = 0;
+    return db_create_with_options(NULL);
 }
 
-char **db_keys(SimpleDB *db, size_t *out_count)
+SimpleDB *db_create_with_options(const DBOptions *opts)
 {
-    if (!db || !out_count) return NULL;
-    *out_count = 0;
+    DBOptions o = opts ? *opts : db_options_default();
+    if ((unsigned)o.pages > DB_PAGES_HUGETLB || (unsigned)o.numa > DB_NUMA_BIND) {
+        return NULL;
+    }
 
-    if (db->count == 0) return NULL;
+    size_t capacity = INITIAL_CAPACITY;
+    while (capacity < o.initial_capacity && capacity <= SIZE_MAX / 4) capacity *= 2;
 
-    char **arr = malloc(db->count * sizeof(char *));
-    if (!arr) return NULL;
+    SimpleDB *db = malloc(sizeof(SimpleDB));
+    if (!db) return NULL;
 
-    size_t pos = 0;
-    for (size_t i = 0; i < db->capacity && pos < db->count; i++) {
-        Entry *e = db->buckets[i];
-        while (e) {
-            arr[pos] = dup_str(e->key);
-            if (!arr[pos]) {
-                /* allocation failure: free what we have */
-                for (size_t j = 0; j < pos; j++) free(arr[j]);
-                free(arr);
-                return NULL;
-            }
-            pos++;
-            e = e->next;
-        }
+    db->opts        = o;
+    db->eff_pages   = o.pages;
+    db->eff_numa    = o.numa;
+    db->numa_mask   = o.numa == DB_NUMA_INTERLEAVE ? online_numa_nodes() : 0;
+    db->table_bytes = 0;
+    db->huge_bytes  = 0;
+    slab_init(&db->entry_pool, sizeof(Entry));
+    slab_init(&db->version_pool, sizeof(Version));
+
+    db->buckets = region_alloc(db, capacity * sizeof(Entry *), &db->bucket_region);
+    if (!db->buckets) { free(db); return NULL; }
+
+    if (pthread_mutex_init(&db->lock, NULL) != 0) {
+        region_free(db, db->buckets, &db->bucket_region);
+        free(db);
+        return NULL;
     }
 
-    *out_count = pos;
-    return arr;
+    db->capacity    = capacity;
+    db->count       = 0;
+    db->slots       = 0;
+    db->versions    = 0;
+    db->version     = 0;
+    db->snap_oldest = NULL;
+    db->snap_newest = NULL;
+    db->n_snapshots = 0;
+    db->history     = false;
+    db->floor       = 0;
+    db->marks       = NULL;
+    db->n_marks     = 0;
+    db->cap_marks   = 0;
+    db->logging     = false;
+    db->log_floor   = 0;
+    db->log_limit   = DB_LOG_DEFAULT_BYTES;
+    db->log_bytes   = 0;
+    db->log         = NULL;
+    db->log_head    = 0;
+    db->log_len     = 0;
+    db->log_cap     = 0;
+    db->gc_list     = NULL;
+    return db;
 }
 
-DBStats db_stats(SimpleDB *db)
+void db_destroy(SimpleDB *db)
 {
-    DBStats s = {0, 0, 0, 0};
-    if (!db) return s;
+    if (!db) return;
 
-    s.total_entries = db->count;
+    DBSnapshot *s = db->snap_oldest;
+    while (s) {
+        DBSnapshot *next = s->next;
+        free(s);
+        s = next;
+    }
 
-    for (size_t i = 0; i < db->capacity; i++) {
-        Entry  *e     = db->buckets[i];
-        if (!e) continue;
+    free_entries(db);
+    region_free(db, db->buckets, &db->bucket_region);
+    free(db->marks);
+    log_reset(db);
+    free(db->log);
+    pthread_mutex_destroy(&db->lock);
+    free(db);
+}
 
-        size_t chain = 0;
-        s.used_buckets++;
+/* -------------------------------------------------------------------------
+ * CRUD
+ * ---------------------------------------------------------------------- */
 
-        while (e) {
-            chain++;
-            e = e->next;
-        }
+/*
+ * Memory one write needs, allocated before it touches the table so that
+ * applying it cannot fail.  Fields a write does not use are released.
+ */
+typedef struct {
+    char    *value;     /* copy of the new value; NULL for a delete    */
+    Version *ver;       /* version to push, or a new entry's head       */
+    Entry   *entry;     /* entry (with key) in case the key is absent   */
+} PreparedWrite;
 
-        if (chain > 1) s.total_collisions += (chain - 1);
-        if (chain > s.max_chain_length) s.max_chain_length = chain;
+/* Allocate what writing key = value (NULL: delete) may need.  absent says
+ * the key may have no entry by the time the write is applied. */
+static bool prepare_write(SimpleDB *db, const char *key, const char *value, bool absent,
+                          PreparedWrite *p)
+{
+    p->value = NULL;
+    p->ver   = NULL;
+    p->entry = NULL;
+
+    if (value && !(p->value = dup_str(value))) return false;
+    if ((!single_version(db) || (value && absent)) && !(p->ver = version_alloc(db))) {
+        return false;
+    }
+    if (value && absent) {
+        if (!(p->entry = slab_alloc(db, &db->entry_pool))) return false;
+        if (!(p->entry->key = dup_str(key))) {
+            slab_free(&db->entry_pool, p->entry);
+            p->entry = NULL;
+            return false;
+        }
     }
+    return true;
+}
 
-    return s;
+static void release_write(SimpleDB *db, PreparedWrite *p)
+{
+    free(p->value);
+    if (p->ver) slab_free(&db->version_pool, p->ver);
+    if (p->entry) {
+        free(p->entry->key);
+        slab_free(&db->entry_pool, p->entry);
+    }
 }
 
-void db_print(SimpleDB *db)
+/*
+ * Apply a prepared write under commit `version` (0 = a new commit), lock
+ * held; takes the parts of p it uses.  A key written twice by one commit
+ * keeps two versions with the same number; readers see the later one.
+ * Returns false only for a delete of an absent key.
+ */
+static bool apply_write(SimpleDB *db, const char *key, PreparedWrite *p, uint64_t version)
 {
-    if (!db) { printf("(null database)\n"); return; }
+    size_t  idx = bucket_index(fnv1a(key), db->capacity);
+    Entry  *e   = find_entry(db, key, idx);
+    char   *val = p->value;
 
-    printf("Database Contents (%zu entries):\n", db->count);
-    for (size_t i = 0; i < db->capacity; i++) {
-        Entry *e = db->buckets[i];
-        while (e) {
-            printf("  %s -> %s\n", e->key, e->value);
-            e = e->next;
+    if (!val) {
+        if (!e || !live_now(e)) return false;
+        if (single_version(db)) {
+            if (!version) commit(db);
+            unlink_entry(db, e);
+        } else {
+            push_version(db, e, p->ver, NULL, version);
+            p->ver = NULL;
+        }
+        db->count--;
+        return true;
+    }
+    p->value = NULL;
+
+    if (e) {
+        bool was_live = live_now(e);
+        if (single_version(db)) {
+            /* Single-version fast path: nobody can see the old value */
+            free(e->head->value);
+            e->head->value   = val;
+            e->head->version = version ? version : commit(db);
+        } else {
+            push_version(db, e, p->ver, val, version);
+            p->ver = NULL;
         }
+        if (!was_live) db->count++;
+        return true;
     }
+
+    /* Insert new entry at head of chain */
+    Entry *ne = p->entry;
+    ne->head  = p->ver;
+    p->entry  = NULL;
+    p->ver    = NULL;
+
+    ne->head->value   = val;
+    ne->head->version = version ? version : commit(db);
+    ne->head->older   = NULL;
+    ne->head->jump    = NULL;
+    ne->head->depth   = 0;
+    ne->gc_next       = NULL;
+    ne->on_gc         = false;
+
+    ne->next          = db->buckets[idx];
+    db->buckets[idx]  = ne;
+    db->count++;
+    db->slots++;
+    db->versions++;
+    return true;
+}
+
+/* Write key under commit `version` (0 = a new commit), lock held. */
+static bool set_locked(SimpleDB *db, const char *key, const char *value, uint64_t version)
+{
+    /* Resize if load factor exceeded */
+    if ((double)(db->slots + 1) / (double)db->capacity > LOAD_FACTOR_MAX) {
+        if (!rehash(db, db->capacity * 2)) return false;
+    }
+
+    bool          absent = !find_entry(db, key, bucket_index(fnv1a(key), db->capacity));
+    PreparedWrite p;
+    bool          ok = prepare_write(db, key, value, absent, &p);
+    if (ok) apply_write(db, key, &p, version);
+    release_write(db, &p);
+    return ok;
+}
+
+/* Delete key under commit `version` (0 = a new commit), lock held.
+ * Returns 1 if deleted, 0 if absent, -1 on allocation failure. */
+static int delete_locked(SimpleDB *db, const char *key, uint64_t version)
+{
+    Entry *e = find_entry(db, key, bucket_index(fnv1a(key), db->capacity));
+    if (!e || !live_now(e)) return 0;
+
+    PreparedWrite p;
+    int           r = prepare_write(db, key, NULL, false, &p) ? 1 : -1;
+    if (r > 0) apply_write(db, key, &p, version);
+    release_write(db, &p);
+    return r;
+}
+
+bool db_set(SimpleDB *db, const char *key, const char *value)
+{
+    if (!db || !key || !value) return false;
+
+    pthread_mutex_lock(&db->lock);
+    bool ok = set_locked(db, key, value, 0);
+    if (ok) {
+        log_write(db, db->version, key, value);
+        log_trim(db);
+    }
+    pthread_mutex_unlock(&db->lock);
+    return ok;
+}
+
+const char *db_get(SimpleDB *db, const char *key)
+{
+    return db_get_at(db, NULL, key);
+}
+
+bool db_delete(SimpleDB *db, const char *key)
+{
+    if (!db || !key) return false;
+
+    pthread_mutex_lock(&db->lock);
+    bool ok = delete_locked(db, key, 0) > 0;
+    if (ok) {
+        log_write(db, db->version, key, NULL);
+        log_trim(db);
+    }
+    pthread_mutex_unlock(&db->lock);
+    return ok;
+}
+
+/* Grow the table for n more keys up front, so a batch rehashes at most
+ * once and never midway.  Lock held. */
+static bool reserve_slots(SimpleDB *db, size_t n)
+{
+    size_t cap = db->capacity;
+    while ((double)(db->slots + n) / (double)cap > LOAD_FACTOR_MAX && cap <= SIZE_MAX / 4) {
+        cap *= 2;
+    }
+    return cap == db->capacity || rehash(db, cap);
+}
+
+static int cmp_hash(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Prepare every write of a batch, lock held.  A set needs a new entry if
+ * its key is absent now or may be unlinked by a delete earlier in the
+ * batch; keys deleted anywhere in it are matched (conservatively) by hash.
+ * cleared says the table is cleared before the batch is applied, which
+ * may unlink every entry.
+ */
+static bool prepare_batch(SimpleDB *db, const char *const *keys, const char *const *values,
+                          size_t n, bool cleared, PreparedWrite *pw)
+{
+    size_t ndel = 0;
+    for (size_t i = 0; i < n; i++) ndel += values[i] == NULL;
+
+    uint64_t *dels = ndel ? malloc(ndel * sizeof(uint64_t)) : NULL;
+    if (ndel && !dels) return false;
+    for (size_t i = 0, d = 0; i < n; i++) {
+        if (!values[i]) dels[d++] = fnv1a(keys[i]);
+    }
+    if (ndel) qsort(dels, ndel, sizeof(uint64_t), cmp_hash);
+
+    bool ok = true;
+    for (size_t i = 0; i < n && ok; i++) {
+        uint64_t h      = fnv1a(keys[i]);
+        bool     absent = values[i] &&
+                          (cleared || !find_entry(db, keys[i], bucket_index(h, db->capacity)) ||
+                           (ndel && bsearch(&h, dels, ndel, sizeof(uint64_t), cmp_hash)));
+        ok = prepare_write(db, keys[i], values[i], absent, &pw[i]);
+    }
+    free(dels);
+    return ok;
+}
+
+/* db_apply / db_apply_if: 1 applied, 0 version moved past expected
+ * (only when check is set), -1 bad keys or out of memory. */
+static int apply_batch(SimpleDB *db, bool check, uint64_t expected,
+                       const char *const *keys, const char *const *values, size_t n)
+{
+    if (!db || (n && (!keys || !values))) return -1;
+    for (size_t i = 0; i < n; i++) {
+        if (!keys[i]) return -1;
+    }
+
+    PreparedWrite *pw = NULL;
+    if (n) {
+        pw = n <= SIZE_MAX / sizeof(PreparedWrite) ? calloc(n, sizeof(PreparedWrite)) : NULL;
+        if (!pw) return -1;
+    }
+
+    pthread_mutex_lock(&db->lock);
+    int r = 1;
+    if (check && db->version != expected) {
+        r = 0;
+    } else if (n && !(reserve_slots(db, n) && prepare_batch(db, keys, values, n, false, pw))) {
+        r = -1;
+    } else if (n) {
+        /* Everything is allocated: from here on the batch cannot fail */
+        uint64_t version = commit(db);
+        for (size_t i = 0; i < n; i++) {
+            if (apply_write(db, keys[i], &pw[i], version)) {
+                log_write(db, version, keys[i], values[i]);
+            }
+        }
+        log_trim(db);
+    }
+    for (size_t i = 0; i < n; i++) release_write(db, &pw[i]);
+
+    pthread_mutex_unlock(&db->lock);
+    free(pw);
+    return r;
+}
+
+bool db_apply(SimpleDB *db, const char *const *keys, const char *const *values, size_t n)
+{
+    return apply_batch(db, false, 0, keys, values, n) > 0;
+}
+
+int db_apply_if(SimpleDB *db, uint64_t version, const char *const *keys,
+                const char *const *values, size_t n)
+{
+    return apply_batch(db, true, version, keys, values, n);
+}
+
+bool db_exists(SimpleDB *db, const char *key)
+{
+    return db_exists_at(db, NULL, key);
+}
+
+/* -------------------------------------------------------------------------
+ * Batched lookup (asynchronous memory access chaining)
+ *
+ * A chained lookup is a sequence of dependent loads: bucket slot -> entry
+ * -> key string -> next entry ...  Each lane below runs one lookup as a
+ * state machine; every step prefetches the next line and moves on to the
+ * next lane, so by the time a lane is revisited its line is (likely) in
+ * cache.  A finished lane immediately starts the next pending key, which
+ * keeps batch_size misses in flight even when chain lengths differ.
+ * ---------------------------------------------------------------------- */
+
+#define MGET_MAX_BATCH 64u
+
+enum { LANE_IDLE, LANE_BUCKET, LANE_ENTRY, LANE_KEY };
+
+typedef struct {
+    int           stage;
+    size_t        idx;      /* index into keys / values */
+    Entry *const *slot;     /* LANE_BUCKET              */
+    const Entry  *e;        /* LANE_ENTRY / LANE_KEY    */
+} MGetLane;
+
+static void lane_start(const SimpleDB *db, MGetLane *l, const char *const *keys,
+                       const char **values, size_t *next, size_t n)
+{
+    while (*next < n && !keys[*next]) values[(*next)++] = NULL;
+    if (*next >= n) { l->stage = LANE_IDLE; return; }
+    l->idx   = (*next)++;
+    l->slot  = &db->buckets[bucket_index(fnv1a(keys[l->idx]), db->capacity)];
+    l->stage = LANE_BUCKET;
+    __builtin_prefetch(l->slot);
+}
+
+/* Body of db_mget, lock held. */
+static size_t mget_locked(const SimpleDB *db, const DBSnapshot *snap, const char *const *keys,
+                          size_t n, const char **values, size_t batch_size)
+{
+    if (batch_size == 0) batch_size = DB_MGET_DEFAULT_BATCH;
+    if (batch_size > MGET_MAX_BATCH) batch_size = MGET_MAX_BATCH;
+    if (batch_size > n) batch_size = n;
+
+    MGetLane lanes[MGET_MAX_BATCH];
+    size_t   next = 0, active = 0, found = 0;
+
+    for (size_t b = 0; b < batch_size; b++) {
+        lane_start(db, &lanes[b], keys, values, &next, n);
+        if (lanes[b].stage != LANE_IDLE) active++;
+    }
+
+    while (active) {
+        for (size_t b = 0; b < batch_size; b++) {
+            MGetLane   *l   = &lanes[b];
+            const char *hit = NULL;
+            bool        done = false;
+
+            switch (l->stage) {
+            case LANE_IDLE:
+                continue;
+
+            case LANE_BUCKET:
+                l->e = *l->slot;
+                if (!l->e) { done = true; break; }
+                __builtin_prefetch(l->e);
+                l->stage = LANE_ENTRY;
+                continue;
+
+            case LANE_ENTRY:
+                __builtin_prefetch(l->e->key);
+                __builtin_prefetch(l->e->head);
+                l->stage = LANE_KEY;
+                continue;
+
+            case LANE_KEY:
+                if (strcmp(l->e->key, keys[l->idx]) == 0) {
+                    const Version *v = snap ? visible(l->e, snap->version) : l->e->head;
+                    hit  = v ? v->value : NULL;
+                    done = true;
+                    break;
+                }
+                l->e = l->e->next;
+                if (!l->e) { done = true; break; }
+                __builtin_prefetch(l->e);
+                l->stage = LANE_ENTRY;
+                continue;
+            }
+
+            if (done) {
+                values[l->idx] = hit;
+                if (hit) found++;
+                lane_start(db, l, keys, values, &next, n);
+                if (l->stage == LANE_IDLE) active--;
+            }
+        }
+    }
+    return found;
+}
+
+size_t db_mget(SimpleDB *db, const DBSnapshot *snap, const char *const *keys,
+               size_t n, const char **values, size_t batch_size)
+{
+    if (!db || !keys || !values) return 0;
+
+    pthread_mutex_lock(&db->lock);
+    size_t found = mget_locked(db, snap, keys, n, values, batch_size);
+    pthread_mutex_unlock(&db->lock);
+    return found;
+}
+
+#define MGET_COPY_CHUNK 256u    /* lookups resolved before their values are copied */
+
+size_t db_mget_copy(SimpleDB *db, const DBSnapshot *snap, const char *const *keys,
+                    size_t n, char **values, size_t batch_size)
+{
+    if (!db || !keys || !values) return 0;
+
+    const char *hits[MGET_COPY_CHUNK];
+    size_t      found = 0;
+    size_t      done  = 0;
+
+    pthread_mutex_lock(&db->lock);
+    while (done < n) {
+        size_t m = n - done < MGET_COPY_CHUNK ? n - done : MGET_COPY_CHUNK;
+        found += mget_locked(db, snap, keys + done, m, hits, batch_size);
+        for (size_t i = 0; i < m; i++) {
+            values[done + i] = NULL;
+            if (hits[i] && !(values[done + i] = dup_str(hits[i]))) {
+                db_free_values(values, done + i);
+                found = SIZE_MAX;
+                goto out;
+            }
+        }
+        done += m;
+    }
+
+out:
+    pthread_mutex_unlock(&db->lock);
+    return found;
+}
+
+void db_free_values(char **values, size_t n)
+{
+    if (!values) return;
+    for (size_t i = 0; i < n; i++) {
+        free(values[i]);
+        values[i] = NULL;
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Utility
+ * ---------------------------------------------------------------------- */
+
+size_t db_count(SimpleDB *db)
+{
+    return db_count_at(db, NULL);
+}
+
+static void release_tombstones(SimpleDB *db, Version *tombs)
+{
+    while (tombs) {
+        Version *older = tombs->older;
+        slab_free(&db->version_pool, tombs);
+        tombs = older;
+    }
+}
+
+/* Tombstones (chained through ->older) for every live key, so that a
+ * clear cannot fail halfway; single-version tables need none.  Lock held. */
+static bool prepare_clear(SimpleDB *db, Version **tombs)
+{
+    *tombs = NULL;
+    if (single_version(db)) return true;
+    for (size_t i = 0; i < db->count; i++) {
+        Version *v = version_alloc(db);
+        if (!v) {
+            release_tombstones(db, *tombs);
+            *tombs = NULL;
+            return false;
+        }
+        v->older = *tombs;
+        *tombs   = v;
+    }
+    return true;
+}
+
+/* Remove every key under commit `version` (0 = a new commit), lock held;
+ * takes the tombstones it uses from *tombs.  prepared says writes are
+ * prepared to follow, so their slab objects must survive. */
+static void apply_clear(SimpleDB *db, uint64_t version, Version **tombs, bool prepared)
+{
+    if (single_version(db)) {
+        if (prepared) {
+            drop_entries(db);
+        } else {
+            free_entries(db);
+        }
+        memset(db->buckets, 0, db->capacity * sizeof(Entry *));
+        db->count    = 0;
+        db->slots    = 0;
+        db->versions = 0;
+        if (!version) commit(db);
+    } else {
+        /* One commit tombstones every live key, so snapshots taken
+         * afterwards never observe a half-cleared table. */
+        uint64_t cleared = version ? version : commit(db);
+        for (size_t i = 0; i < db->capacity; i++) {
+            for (Entry *e = db->buckets[i]; e; e = e->next) {
+                if (!live_now(e)) continue;
+                Version *v = *tombs;
+                *tombs     = v->older;
+                v->value   = NULL;
+                v->version = cleared;
+                link_version(e, v);
+                db->versions++;
+                db->count--;
+                track_history(db, e);
+            }
+        }
+        gc_sweep(db);
+    }
+}
+
+bool db_clear(SimpleDB *db)
+{
+    if (!db) return false;
+
+    pthread_mutex_lock(&db->lock);
+    Version *tombs;
+    bool     ok = prepare_clear(db, &tombs);
+    if (ok) {
+        apply_clear(db, 0, &tombs, false);
+        log_write(db, db->version, NULL, NULL);
+        log_trim(db);
+    }
+    release_tombstones(db, tombs);
+    pthread_mutex_unlock(&db->lock);
+    return ok;
+}
+
+char **db_keys(SimpleDB *db, size_t *out_count)
+{
+    return db_keys_at(db, NULL, out_count);
+}
+
+void db_free_keys(char **keys, size_t count)
+{
+    if (!keys) return;
+    for (size_t i = 0; i < count; i++) free(keys[i]);
+    free(keys);
+}
+
+DBStats db_stats(SimpleDB *db)
+{
+    DBStats s = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    if (!db) return s;
+
+    pthread_mutex_lock(&db->lock);
+
+    s.total_entries     = db->count;
+    s.active_snapshots  = db->n_snapshots;
+    s.retained_versions = db->versions - db->count;
+    s.page_policy       = db->eff_pages;
+    s.numa_policy       = db->eff_numa;
+    s.table_bytes       = db->table_bytes;
+    s.huge_page_bytes   = db->huge_bytes;
+    s.log_records       = db->log_len;
+    s.log_bytes         = db->log_bytes;
+
+    for (size_t i = 0; i < db->capacity; i++) {
+        Entry  *e     = db->buckets[i];
+        if (!e) continue;
+
+        size_t chain = 0;
+        s.used_buckets++;
+
+        while (e) {
+            chain++;
+            e = e->next;
+        }
+
+        if (chain > 1) s.total_collisions += (chain - 1);
+        if (chain > s.max_chain_length) s.max_chain_length = chain;
+    }
+
+    pthread_mutex_unlock(&db->lock);
+    return s;
+}
+
+void db_print(SimpleDB *db)
+{
+    if (!db) { printf("(null database)\n"); return; }
+
+    pthread_mutex_lock(&db->lock);
+    printf("Database Contents (%zu entries):\n", db->count);
+    for (size_t i = 0; i < db->capacity; i++) {
+        Entry *e = db->buckets[i];
+        while (e) {
+            if (live_now(e)) printf("  %s -> %s\n", e->key, e->head->value);
+            e = e->next;
+        }
+    }
+    pthread_mutex_unlock(&db->lock);
+}
+
+/* -------------------------------------------------------------------------
+ * Snapshots
+ * ---------------------------------------------------------------------- */
+
+/* Insert snap into the version-sorted list (usually at the newest end). */
+static void snapshot_link(SimpleDB *db, DBSnapshot *snap)
+{
+    DBSnapshot *after = db->snap_newest;
+    while (after && after->version > snap->version) after = after->prev;
+
+    snap->db   = db;
+    snap->prev = after;
+    snap->next = after ? after->next : db->snap_oldest;
+    if (snap->next) snap->next->prev = snap;
+    else            db->snap_newest  = snap;
+    if (after) after->next    = snap;
+    else       db->snap_oldest = snap;
+    db->n_snapshots++;
+}
+
+DBSnapshot *db_snapshot_acquire(SimpleDB *db)
+{
+    if (!db) return NULL;
+
+    DBSnapshot *snap = malloc(sizeof(DBSnapshot));
+    if (!snap) return NULL;
+
+    pthread_mutex_lock(&db->lock);
+    snap->version = db->version;
+    snapshot_link(db, snap);
+    pthread_mutex_unlock(&db->lock);
+
+    return snap;
+}
+
+void db_snapshot_release(DBSnapshot *snap)
+{
+    if (!snap) return;
+    SimpleDB *db = snap->db;
+
+    pthread_mutex_lock(&db->lock);
+    bool was_oldest = (db->snap_oldest == snap);
+
+    if (snap->prev) snap->prev->next = snap->next;
+    else            db->snap_oldest  = snap->next;
+    if (snap->next) snap->next->prev = snap->prev;
+    else            db->snap_newest  = snap->prev;
+    db->n_snapshots--;
+
+    /* Only the oldest snapshot holds the watermark back */
+    if (was_oldest) gc_sweep(db);
+    pthread_mutex_unlock(&db->lock);
+
+    free(snap);
+}
+
+uint64_t db_snapshot_version(const DBSnapshot *snap)
+{
+    return snap ? snap->version : 0;
+}
+
+uint64_t db_version(SimpleDB *db)
+{
+    if (!db) return 0;
+    pthread_mutex_lock(&db->lock);
+    uint64_t v = db->version;
+    pthread_mutex_unlock(&db->lock);
+    return v;
+}
+
+const char *db_get_at(SimpleDB *db, const DBSnapshot *snap, const char *key)
+{
+    if (!db || !key) return NULL;
+
+    pthread_mutex_lock(&db->lock);
+    const char *result = NULL;
+
+    size_t idx = bucket_index(fnv1a(key), db->capacity);
+    Entry *e   = find_entry(db, key, idx);
+    if (e) {
+        const Version *v = snap ? visible(e, snap->version) : e->head;
+        if (v) result = v->value;
+    }
+
+    pthread_mutex_unlock(&db->lock);
+    return result;
+}
+
+bool db_get_copy(SimpleDB *db, const DBSnapshot *snap, const char *key, char **value)
+{
+    if (!value) return false;
+    *value = NULL;
+    if (!db || !key) return true;
+
+    pthread_mutex_lock(&db->lock);
+    bool ok = true;
+
+    size_t idx = bucket_index(fnv1a(key), db->capacity);
+    Entry *e   = find_entry(db, key, idx);
+    if (e) {
+        const Version *v = snap ? visible(e, snap->version) : e->head;
+        if (v && v->value) ok = (*value = dup_str(v->value)) != NULL;
+    }
+
+    pthread_mutex_unlock(&db->lock);
+    return ok;
+}
+
+bool db_exists_at(SimpleDB *db, const DBSnapshot *snap, const char *key)
+{
+    return db_get_at(db, snap, key) != NULL;
+}
+
+size_t db_count_at(SimpleDB *db, const DBSnapshot *snap)
+{
+    if (!db) return 0;
+
+    pthread_mutex_lock(&db->lock);
+    size_t n = 0;
+    if (!snap) {
+        n = db->count;
+    } else {
+        for (size_t i = 0; i < db->capacity; i++) {
+            for (Entry *e = db->buckets[i]; e; e = e->next) {
+                if (live_at(e, snap)) n++;
+            }
+        }
+    }
+    pthread_mutex_unlock(&db->lock);
+    return n;
+}
+
+char **db_keys_at(SimpleDB *db, const DBSnapshot *snap, size_t *out_count)
+{
+    if (!db || !out_count) return NULL;
+    *out_count = 0;
+
+    pthread_mutex_lock(&db->lock);
+    char **arr = NULL;
+
+    if (db->slots == 0) goto out;
+
+    arr = malloc(db->slots * sizeof(char *));
+    if (!arr) goto out;
+
+    size_t pos = 0;
+    for (size_t i = 0; i < db->capacity; i++) {
+        Entry *e = db->buckets[i];
+        while (e) {
+            if (live_at(e, snap)) {
+                arr[pos] = dup_str(e->key);
+                if (!arr[pos]) {
+                    /* allocation failure: free what we have */
+                    db_free_keys(arr, pos);
+                    arr = NULL;
+                    goto out;
+                }
+                pos++;
+            }
+            e = e->next;
+        }
+    }
+
+    if (pos == 0) {
+        free(arr);
+        arr = NULL;
+    }
+    *out_count = pos;
+
+out:
+    pthread_mutex_unlock(&db->lock);
+    return arr;
+}
+
+/* -------------------------------------------------------------------------
+ * Temporal history
+ * ---------------------------------------------------------------------- */
+
+bool db_history_enable(SimpleDB *db)
+{
+    if (!db) return false;
+
+    pthread_mutex_lock(&db->lock);
+    if (!db->history) {
+        db->history = true;
+        db->floor   = db->version;
+        mark_time(db);    /* anchor: db->version is current as of now */
+    }
+    pthread_mutex_unlock(&db->lock);
+    return true;
+}
+
+bool db_history_enabled(SimpleDB *db)
+{
+    if (!db) return false;
+    pthread_mutex_lock(&db->lock);
+    bool on = db->history;
+    pthread_mutex_unlock(&db->lock);
+    return on;
+}
+
+uint64_t db_history_floor(SimpleDB *db)
+{
+    if (!db) return 0;
+    pthread_mutex_lock(&db->lock);
+    uint64_t w = watermark(db);
+    pthread_mutex_unlock(&db->lock);
+    return w;
+}
+
+/* Index of the last mark with ms <= unix_ms, or n_marks if none. */
+static size_t mark_before(const SimpleDB *db, int64_t unix_ms)
+{
+    size_t lo = 0, hi = db->n_marks;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (db->marks[mid].ms <= unix_ms) lo = mid + 1;
+        else                              hi = mid;
+    }
+    return lo ? lo - 1 : db->n_marks;
+}
+
+uint64_t db_version_at_time(SimpleDB *db, int64_t unix_ms)
+{
+    if (!db) return 0;
+
+    pthread_mutex_lock(&db->lock);
+    uint64_t v = 0;
+    size_t   i = mark_before(db, unix_ms);
+    if (i < db->n_marks) {
+        v = i + 1 < db->n_marks ? db->marks[i + 1].version - 1 : db->version;
+    }
+    pthread_mutex_unlock(&db->lock);
+    return v;
+}
+
+int64_t db_version_time(SimpleDB *db, uint64_t version)
+{
+    if (!db) return -1;
+
+    pthread_mutex_lock(&db->lock);
+    int64_t ms = -1;
+    size_t lo = 0, hi = db->n_marks;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (db->marks[mid].version <= version) lo = mid + 1;
+        else                                   hi = mid;
+    }
+    if (lo && version <= db->version) ms = db->marks[lo - 1].ms;
+    pthread_mutex_unlock(&db->lock);
+    return ms;
+}
+
+DBSnapshot *db_snapshot_at(SimpleDB *db, uint64_t version)
+{
+    if (!db) return NULL;
+
+    DBSnapshot *snap = malloc(sizeof(DBSnapshot));
+    if (!snap) return NULL;
+
+    pthread_mutex_lock(&db->lock);
+    bool ok = version <= db->version && version >= watermark(db);
+    if (ok) {
+        snap->version = version;
+        snapshot_link(db, snap);
+    }
+    pthread_mutex_unlock(&db->lock);
+
+    if (!ok) {
+        free(snap);
+        return NULL;
+    }
+    return snap;
+}
+
+size_t db_compact(SimpleDB *db, uint64_t floor)
+{
+    if (!db) return 0;
+
+    pthread_mutex_lock(&db->lock);
+    size_t freed = 0;
+    if (!db->history) goto out;
+
+    if (floor > db->version) floor = db->version;
+    if (floor <= db->floor) goto out;
+    db->floor = floor;
+
+    size_t before = db->versions;
+    gc_sweep(db);
+    freed = before - db->versions;
+
+    /* Keep the mark covering the floor and everything after it */
+    size_t first = 0;
+    while (first + 1 < db->n_marks && db->marks[first + 1].version <= floor) first++;
+    if (first) {
+        memmove(db->marks, db->marks + first, (db->n_marks - first) * sizeof(TimeMark));
+        db->n_marks -= first;
+    }
+
+out:
+    pthread_mutex_unlock(&db->lock);
+    return freed;
+}
+
+/* -------------------------------------------------------------------------
+ * Replication log
+ * ---------------------------------------------------------------------- */
+
+/* Growable output buffer for db_log_read / db_dump. */
+typedef struct {
+    char  *data;
+    size_t len;
+    size_t cap;
+} Buffer;
+
+static bool buf_reserve(Buffer *b, size_t extra)
+{
+    if (b->len + extra <= b->cap) return true;
+    size_t cap = b->cap ? b->cap : 4096;
+    while (cap < b->len + extra) cap *= 2;
+    char *p = realloc(b->data, cap);
+    if (!p) return false;
+    b->data = p;
+    b->cap  = cap;
+    return true;
+}
+
+static inline void put_u32(char *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = (char)(v >> (8 * i));
+}
+
+static inline void put_u64(char *p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) p[i] = (char)(v >> (8 * i));
+}
+
+static inline uint32_t get_u32(const char *p)
+{
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | (uint8_t)p[i];
+    return v;
+}
+
+static inline uint64_t get_u64(const char *p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | (uint8_t)p[i];
+    return v;
+}
+
+/* Append one record in the wire format (see simple_db.h). */
+static bool buf_record(Buffer *b, uint64_t version, const char *key, const char *value)
+{
+    size_t klen = key ? strlen(key) + 1 : 0;
+    size_t vlen = value ? strlen(value) + 1 : 0;
+    if (klen > UINT32_MAX || vlen > UINT32_MAX) return false;
+    if (!buf_reserve(b, LOG_RECORD_HEADER + klen + vlen)) return false;
+
+    char *p = b->data + b->len;
+    put_u64(p, version);
+    put_u32(p + 8, (uint32_t)klen);
+    put_u32(p + 12, (uint32_t)vlen);
+    if (klen) memcpy(p + LOG_RECORD_HEADER, key, klen);
+    if (vlen) memcpy(p + LOG_RECORD_HEADER + klen, value, vlen);
+    b->len += LOG_RECORD_HEADER + klen + vlen;
+    return true;
+}
+
+/* Hand out the buffer (never NULL for an empty result); NULL on failure. */
+static char *buf_finish(Buffer *b, size_t *len)
+{
+    if (!b->data && !(b->data = malloc(1))) return NULL;
+    *len = b->len;
+    return b->data;
+}
+
+bool db_log_enable(SimpleDB *db, size_t max_bytes)
+{
+    if (!db) return false;
+
+    pthread_mutex_lock(&db->lock);
+    if (!db->logging) {
+        db->logging   = true;
+        db->log_floor = db->version;
+    }
+    db->log_limit = max_bytes ? max_bytes : DB_LOG_DEFAULT_BYTES;
+    log_trim(db);
+    pthread_mutex_unlock(&db->lock);
+    return true;
+}
+
+bool db_log_enabled(SimpleDB *db)
+{
+    if (!db) return false;
+    pthread_mutex_lock(&db->lock);
+    bool on = db->logging;
+    pthread_mutex_unlock(&db->lock);
+    return on;
+}
+
+uint64_t db_log_floor(SimpleDB *db)
+{
+    if (!db) return 0;
+    pthread_mutex_lock(&db->lock);
+    uint64_t floor = db->log_floor;
+    pthread_mutex_unlock(&db->lock);
+    return floor;
+}
+
+char *db_log_read(SimpleDB *db, uint64_t after, size_t max_bytes,
+                  size_t *len, uint64_t *through)
+{
+    if (!db || !len || !through) return NULL;
+    *len = 0;
+
+    Buffer b      = { NULL, 0, 0 };
+    char  *result = NULL;
+
+    pthread_mutex_lock(&db->lock);
+    if (!db->logging || after < db->log_floor || after > db->version) goto out;
+
+    /* First record past the position */
+    size_t lo = 0, hi = db->log_len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (log_at(db, mid)->version <= after) lo = mid + 1;
+        else                                    hi = mid;
+    }
+
+    /* Whole commits only; commits without records (nothing changed) are
+     * covered by whichever position comes next. */
+    uint64_t reached = db->version;
+    for (size_t i = lo; i < db->log_len; ) {
+        uint64_t v     = log_at(db, i)->version;
+        size_t   end   = i;
+        size_t   bytes = 0;
+        while (end < db->log_len && log_at(db, end)->version == v) {
+            bytes += log_at(db, end++)->bytes;
+        }
+        if (max_bytes && b.len && b.len + bytes > max_bytes) {
+            reached = v - 1;
+            break;
+        }
+        for (; i < end; i++) {
+            const LogRecord *r = log_at(db, i);
+            if (!buf_record(&b, r->version, r->key, r->value)) goto out;
+        }
+    }
+
+    *through = reached;
+    result   = buf_finish(&b, len);
+
+out:
+    pthread_mutex_unlock(&db->lock);
+    if (!result) free(b.data);
+    return result;
+}
+
+char *db_dump(SimpleDB *db, const DBSnapshot *snap, size_t *len, uint64_t *version)
+{
+    if (!db || !len || !version) return NULL;
+    *len = 0;
+
+    Buffer b      = { NULL, 0, 0 };
+    char  *result = NULL;
+
+    pthread_mutex_lock(&db->lock);
+    uint64_t at = snap ? snap->version : db->version;
+    if (!buf_record(&b, at, NULL, NULL)) goto out;
+
+    for (size_t i = 0; i < db->capacity; i++) {
+        for (Entry *e = db->buckets[i]; e; e = e->next) {
+            const Version *v = snap ? visible(e, at) : e->head;
+            if (v && v->value && !buf_record(&b, at, e->key, v->value)) goto out;
+        }
+    }
+
+    *version = at;
+    result   = buf_finish(&b, len);
+
+out:
+    pthread_mutex_unlock(&db->lock);
+    if (!result) free(b.data);
+    return result;
+}
+
+/* A field of n bytes (0 = absent) holding exactly one NUL, at its end. */
+static inline bool terminated(const char *p, size_t n)
+{
+    return n == 0 || memchr(p, '\0', n) == p + n - 1;
+}
+
+/* Check framing, NULs and version order before anything is applied. */
+static bool replay_valid(const char *buf, size_t len)
+{
+    uint64_t last = 0;
+    size_t   pos  = 0;
+    while (pos < len) {
+        if (len - pos < LOG_RECORD_HEADER) return false;
+        uint64_t v    = get_u64(buf + pos);
+        size_t   klen = get_u32(buf + pos + 8);
+        size_t   vlen = get_u32(buf + pos + 12);
+        pos += LOG_RECORD_HEADER;
+
+        if (v < last || klen + vlen > len - pos || (!klen && vlen)) return false;
+        if (!terminated(buf + pos, klen) || !terminated(buf + pos + klen, vlen)) return false;
+        pos += klen + vlen;
+        last = v;
+    }
+    return true;
+}
+
+static inline size_t record_size(const char *p)
+{
+    return LOG_RECORD_HEADER + get_u32(p + 8) + get_u32(p + 12);
+}
+
+/*
+ * Apply one leader commit, lock held: a clear if `cleared`, then the n
+ * keyed records in [p, end).  Everything is allocated before the table
+ * is touched, so the commit is applied whole or not at all.
+ */
+static bool replay_commit(SimpleDB *db, const char *p, const char *end, size_t n,
+                          bool cleared)
+{
+    const char   **keys   = n ? calloc(n, sizeof(char *)) : NULL;
+    const char   **values = n ? calloc(n, sizeof(char *)) : NULL;
+    PreparedWrite *pw     = n ? calloc(n, sizeof(PreparedWrite)) : NULL;
+    Version       *tombs  = NULL;
+    bool           ok     = false;
+
+    if (n && !(keys && values && pw)) goto out;
+    for (size_t i = 0; p < end; i++) {
+        size_t klen = get_u32(p + 8);
+        size_t vlen = get_u32(p + 12);
+        keys[i]   = p + LOG_RECORD_HEADER;
+        values[i] = vlen ? p + LOG_RECORD_HEADER + klen : NULL;
+        p += LOG_RECORD_HEADER + klen + vlen;
+    }
+    if (cleared && !prepare_clear(db, &tombs)) goto out;
+    if (!reserve_slots(db, n) || (n && !prepare_batch(db, keys, values, n, cleared, pw))) {
+        goto out;
+    }
+
+    /* Everything is allocated: from here on the commit cannot fail */
+    uint64_t version = commit(db);
+    if (cleared) {
+        apply_clear(db, version, &tombs, n > 0);
+        log_write(db, version, NULL, NULL);
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (apply_write(db, keys[i], &pw[i], version)) {
+            log_write(db, version, keys[i], values[i]);
+        }
+    }
+    log_trim(db);
+    ok = true;
+
+out:
+    for (size_t i = 0; pw && i < n; i++) release_write(db, &pw[i]);
+    release_tombstones(db, tombs);
+    free(keys);
+    free(values);
+    free(pw);
+    return ok;
+}
+
+bool db_log_replay(SimpleDB *db, const char *buf, size_t len)
+{
+    if (!db || (len && !buf)) return false;
+    if (!replay_valid(buf, len)) return false;
+
+    pthread_mutex_lock(&db->lock);
+    bool   ok  = true;
+    size_t pos = 0;
+
+    while (pos < len && ok) {
+        /* One leader commit: its records share a version.  A clear hides
+         * whatever the commit wrote before it, so only the last clear and
+         * the records after it are applied. */
+        uint64_t v       = get_u64(buf + pos);
+        size_t   start   = pos;
+        size_t   n       = 0;
+        bool     cleared = false;
+        while (pos < len && get_u64(buf + pos) == v) {
+            bool keyed = get_u32(buf + pos + 8) != 0;
+            pos += record_size(buf + pos);
+            if (keyed) {
+                n++;
+            } else {
+                start   = pos;
+                n       = 0;
+                cleared = true;
+            }
+        }
+        ok = replay_commit(db, buf + start, buf + pos, n, cleared);
+    }
+
+    pthread_mutex_unlock(&db->lock);
+    return ok;
+}
+
+void db_free_buffer(char *buf)
+{
+    free(buf);
 }
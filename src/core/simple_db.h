@@ -2,7 +2,11 @@
  * simple_db.h — Chained hash-table key-value store
  *
  * All keys and values are NUL-terminated UTF-8 strings.
- * Thread-safety: NOT thread-safe (single-threaded use only).
+ * Thread-safety: every call takes the database lock, so calls may be made
+ * from several threads.  Pointers returned by db_get / db_get_at (without
+ * a snapshot) / db_mget are only stable until the next write to the same
+ * key, which another thread may make at any time; concurrent readers use
+ * the copying db_get_copy / db_mget_copy, or read through a snapshot.
  */
 
 #ifndef SIMPLE_DB_H
@@ -10,6 +14,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,11 +26,44 @@ extern "C" {
 
 typedef struct SimpleDB SimpleDB;
 
+/** Point-in-time read view (see db_snapshot_acquire). */
+typedef struct DBSnapshot DBSnapshot;
+
+/** Page size backing the bucket array and entry slabs. */
+typedef enum {
+    DB_PAGES_DEFAULT     = 0,  /* plain heap allocation                    */
+    DB_PAGES_TRANSPARENT = 1,  /* anonymous mmap + madvise(MADV_HUGEPAGE)  */
+    DB_PAGES_HUGETLB     = 2   /* explicit 2MB hugetlbfs pages (MAP_HUGETLB),
+                                  falling back to transparent huge pages   */
+} DBPagePolicy;
+
+/** NUMA placement of the bucket array and entry slabs. */
+typedef enum {
+    DB_NUMA_DEFAULT    = 0,    /* first-touch (kernel default)             */
+    DB_NUMA_INTERLEAVE = 1,    /* round-robin pages over all online nodes  */
+    DB_NUMA_BIND       = 2     /* all pages on DBOptions.numa_node         */
+} DBNumaPolicy;
+
+typedef struct {
+    size_t       initial_capacity;  /* buckets to presize; 0 = default     */
+    DBPagePolicy pages;
+    DBNumaPolicy numa;
+    int          numa_node;         /* used with DB_NUMA_BIND              */
+} DBOptions;
+
 typedef struct {
     size_t total_entries;
     size_t total_collisions;
     size_t max_chain_length;
     size_t used_buckets;
+    size_t active_snapshots;   /* snapshots currently held            */
+    size_t retained_versions;  /* superseded versions kept for them   */
+    size_t page_policy;        /* DBPagePolicy actually in effect     */
+    size_t numa_policy;        /* DBNumaPolicy actually in effect     */
+    size_t table_bytes;        /* bucket array + entry slab memory    */
+    size_t huge_page_bytes;    /* part of table_bytes on huge pages   */
+    size_t log_records;        /* writes held by the replication log  */
+    size_t log_bytes;          /* ... and their encoded size          */
 } DBStats;
 
 /* -------------------------------------------------------------------------
@@ -35,7 +73,26 @@ typedef struct {
 /** Create a new database.  Returns NULL on allocation failure. */
 SimpleDB *db_create(void);
 
-/** Destroy database and free ALL memory (including stored strings). */
+/** Options equivalent to db_create(): heap pages, first-touch NUMA. */
+DBOptions db_options_default(void);
+
+/**
+ * Create a database with explicit allocation policies.
+ *
+ * Meant for large tables: with huge pages every region (bucket array, slab
+ * chunk) is rounded up to 2MB, so small tables should keep the defaults.
+ *
+ * Policies are best effort: when the kernel refuses huge pages or NUMA
+ * binding the table falls back to the next weaker policy, and db_stats
+ * reports the policy actually in effect.  opts == NULL behaves like
+ * db_create().  Returns NULL on allocation failure.
+ */
+SimpleDB *db_create_with_options(const DBOptions *opts);
+
+/**
+ * Destroy database and free ALL memory (including stored strings).
+ * Any snapshots still held are invalidated.
+ */
 void db_destroy(SimpleDB *db);
 
 /* -------------------------------------------------------------------------
@@ -58,6 +115,61 @@ bool db_delete(SimpleDB *db, const char *key);
 /** Return true if key exists. */
 bool db_exists(SimpleDB *db, const char *key);
 
+/**
+ * Apply n writes as one commit: keys[i] is set to values[i], or deleted
+ * when values[i] is NULL (deleting an absent key is not an error).
+ *
+ * The whole batch runs under the lock and shares one version number, so
+ * no reader or snapshot ever observes part of it.  When a key appears
+ * more than once the last write wins.  Memory for every write is
+ * allocated before the first is applied, so the batch is all or nothing:
+ * returns false, with nothing applied, for NULL keys or on allocation
+ * failure.
+ */
+bool db_apply(SimpleDB *db, const char *const *keys, const char *const *values, size_t n);
+
+/**
+ * db_apply only if the database is still at `version` (db_version), checked
+ * under the lock: an optimistic read-modify-write for batches computed from
+ * a snapshot.  Returns 1 if applied, 0 if another commit came first, -1 for
+ * NULL keys or on allocation failure; nothing is applied unless 1.
+ */
+int db_apply_if(SimpleDB *db, uint64_t version, const char *const *keys,
+                const char *const *values, size_t n);
+
+/* -------------------------------------------------------------------------
+ * Batched lookup
+ * ---------------------------------------------------------------------- */
+
+/** batch_size used by db_mget when 0 is passed. */
+#define DB_MGET_DEFAULT_BATCH 16
+
+/**
+ * Look up n keys in one call, as of snap (NULL = current state).
+ *
+ * values[i] receives the value for keys[i] or NULL; pointer validity is as
+ * for db_get_at.  Up to batch_size lookups are in flight at once: each is
+ * a small state machine that issues a prefetch for its next bucket, entry
+ * or key and yields to the others until the line arrives, so independent
+ * cache misses overlap instead of stalling one at a time.  batch_size 0
+ * selects DB_MGET_DEFAULT_BATCH; 1 degenerates to sequential gets.
+ * Returns the number of keys found.
+ */
+size_t db_mget(SimpleDB *db, const DBSnapshot *snap, const char *const *keys,
+               size_t n, const char **values, size_t batch_size);
+
+/**
+ * db_mget returning heap copies made under the lock, so the values stay
+ * valid whatever other threads write.  Free them with db_free_values.
+ * Returns the number of keys found, or SIZE_MAX on allocation failure
+ * (values all NULL then).
+ */
+size_t db_mget_copy(SimpleDB *db, const DBSnapshot *snap, const char *const *keys,
+                    size_t n, char **values, size_t batch_size);
+
+/** Free the n values of db_mget_copy (NULL entries are skipped). */
+void db_free_values(char **values, size_t n);
+
 /* -------------------------------------------------------------------------
  * Utility
  * ---------------------------------------------------------------------- */
@@ -65,22 +177,182 @@ bool db_exists(SimpleDB *db, const char *key);
 /** Return number of stored entries. */
 size_t db_count(SimpleDB *db);
 
-/** Remove all entries. */
-void db_clear(SimpleDB *db);
+/** Remove all entries.  Returns false, with nothing removed, if memory runs out. */
+bool db_clear(SimpleDB *db);
 
 /**
  * Return an array of *count keys (heap-allocated copies).
- * The caller is responsible for freeing each string and the array itself.
+ * The caller is responsible for freeing the result with db_free_keys.
  * Returns NULL if the database is empty or allocation fails.
  */
 char **db_keys(SimpleDB *db, size_t *count);
 
+/** Free an array returned by db_keys / db_keys_at. */
+void db_free_keys(char **keys, size_t count);
+
 /** Return statistics about the hash table. */
 DBStats db_stats(SimpleDB *db);
 
 /** Print all key-value pairs to stdout (debugging). */
 void db_print(SimpleDB *db);
 
+/* -------------------------------------------------------------------------
+ * Snapshots (multi-version reads)
+ *
+ * Every write commits a new version number.  A snapshot pins the version
+ * current at acquire time: reads through it see exactly the committed state
+ * of that moment, regardless of later writes.  Superseded values are kept
+ * on per-key version chains only while some snapshot can still see them
+ * and are freed once the last such snapshot is released.
+ *
+ * Every *_at read accepts snap == NULL, meaning "the current state".
+ * ---------------------------------------------------------------------- */
+
+/** Pin the current version.  Returns NULL on allocation failure. */
+DBSnapshot *db_snapshot_acquire(SimpleDB *db);
+
+/** Release a snapshot and reclaim versions no other snapshot needs. */
+void db_snapshot_release(DBSnapshot *snap);
+
+/** Version number a snapshot reads at. */
+uint64_t db_snapshot_version(const DBSnapshot *snap);
+
+/** Version number of the most recent committed write. */
+uint64_t db_version(SimpleDB *db);
+
+/**
+ * Return value for key as of snap.  With a snapshot the pointer stays valid
+ * until the snapshot is released; with snap == NULL it behaves like db_get.
+ */
+const char *db_get_at(SimpleDB *db, const DBSnapshot *snap, const char *key);
+
+/**
+ * Copy the value for key as of snap (NULL = current) into *value, which
+ * receives NULL when the key is absent.  The copy is made under the lock,
+ * so it is safe against concurrent writers; free it with db_free_buffer.
+ * Returns false only on allocation failure.
+ */
+bool db_get_copy(SimpleDB *db, const DBSnapshot *snap, const char *key, char **value);
+
+/** Return true if key existed as of snap. */
+bool db_exists_at(SimpleDB *db, const DBSnapshot *snap, const char *key);
+
+/** Number of entries as of snap. */
+size_t db_count_at(SimpleDB *db, const DBSnapshot *snap);
+
+/** Keys as of snap; free with db_free_keys. */
+char **db_keys_at(SimpleDB *db, const DBSnapshot *snap, size_t *count);
+
+/* -------------------------------------------------------------------------
+ * Temporal history (time travel)
+ *
+ * With history enabled every committed version is kept, not just those a
+ * live snapshot needs, so any commit since the history floor can be read
+ * again through db_snapshot_at.  Memory grows with the number of writes
+ * (one version per write), never with copies of the table.  A time index
+ * maps wall-clock milliseconds to commit numbers.  db_compact drops the
+ * history older than a new floor (retention).
+ * ---------------------------------------------------------------------- */
+
+/** Start keeping history from the current version on.  Cannot be undone. */
+bool db_history_enable(SimpleDB *db);
+
+bool db_history_enabled(SimpleDB *db);
+
+/** Oldest version db_snapshot_at accepts (the current one without history). */
+uint64_t db_history_floor(SimpleDB *db);
+
+/**
+ * Last version committed at or before unix_ms (milliseconds since the
+ * epoch).  Returns 0 if unix_ms predates the recorded history.
+ */
+uint64_t db_version_at_time(SimpleDB *db, int64_t unix_ms);
+
+/** Commit time of version in unix milliseconds, or -1 if unknown. */
+int64_t db_version_time(SimpleDB *db, uint64_t version);
+
+/**
+ * Pin an arbitrary version: reads see the state right after that commit.
+ * Release with db_snapshot_release.  Returns NULL if version is newer than
+ * the current one or older than db_history_floor.
+ */
+DBSnapshot *db_snapshot_at(SimpleDB *db, uint64_t version);
+
+/**
+ * Raise the history floor to `floor` (clamped to the current version) and
+ * free every version no longer visible from it or a held snapshot.
+ * Returns the number of versions freed (0 without history).
+ */
+size_t db_compact(SimpleDB *db, uint64_t floor);
+
+/* -------------------------------------------------------------------------
+ * Replication log (leader-follower log shipping)
+ *
+ * With the log enabled every committed write is also appended to an
+ * in-memory mutation log, tagged with its commit version.  The log keeps
+ * whole commits and drops the oldest once it holds more than its byte
+ * limit; db_log_floor is the oldest position it can still serve from.
+ *
+ * A follower holds a replica position (the leader version its replica
+ * reflects).  It catches up with db_log_read from that position, or, when
+ * the position has fallen below the floor, with a db_dump of a snapshot
+ * followed by the log after the snapshot's version.  db_log_replay applies
+ * either on the replica, one local commit per leader commit, so readers
+ * of the replica never observe part of a leader commit.
+ *
+ * Wire format (little-endian), one record after another:
+ *   u64 version | u32 key bytes | u32 value bytes | key | value
+ * Key and value lengths include their terminating NUL; a value length of
+ * 0 records a deletion, and a record with both lengths 0 clears the table.
+ * ---------------------------------------------------------------------- */
+
+/** Log size limit used when db_log_enable is passed 0. */
+#define DB_LOG_DEFAULT_BYTES ((size_t)64 << 20)
+
+/**
+ * Start logging commits from the current version on, keeping at most
+ * max_bytes (0 = DB_LOG_DEFAULT_BYTES) of encoded records.  Calling it
+ * again only changes the limit.  Cannot be undone.
+ */
+bool db_log_enable(SimpleDB *db, size_t max_bytes);
+
+bool db_log_enabled(SimpleDB *db);
+
+/** Oldest position db_log_read accepts (the version before the first logged commit). */
+uint64_t db_log_floor(SimpleDB *db);
+
+/**
+ * Encode the commits after position `after`, stopping before a commit
+ * that would take the buffer past max_bytes (0 = no limit; the first
+ * commit is always included).  *through receives the position the
+ * buffer brings a replica to.  An up-to-date position yields an empty
+ * buffer (*len == 0).  Returns NULL without a log, for a position below
+ * db_log_floor or above the current version, or on allocation failure.
+ * Free the result with db_free_buffer.
+ */
+char *db_log_read(SimpleDB *db, uint64_t after, size_t max_bytes,
+                  size_t *len, uint64_t *through);
+
+/**
+ * Encode the state as of snap (NULL = current) as one clearing commit
+ * tagged with that version, which *version receives.  Replaying it
+ * replaces a replica's contents.  Free the result with db_free_buffer.
+ */
+char *db_dump(SimpleDB *db, const DBSnapshot *snap, size_t *len, uint64_t *version);
+
+/**
+ * Apply records from db_log_read / db_dump: each run of records sharing a
+ * version becomes one local commit (and is logged locally when this
+ * database has a log, so replicas can be chained or promoted).  Returns
+ * false for a malformed buffer (nothing applied) or on allocation
+ * failure (the commits before the failing one have been applied; none
+ * is applied in part).
+ */
+bool db_log_replay(SimpleDB *db, const char *buf, size_t len);
+
+/** Free a buffer returned by db_get_copy / db_log_read / db_dump. */
+void db_free_buffer(char *buf);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,703 @@
+/**
+ * simple_db.hpp — Header-only C++17 front-end for simple_db
+ *
+ * Optional typed layer for native modules written in C++.  Nothing here
+ * is compiled into libsimpledb; include it and link the library.
+ *
+ *   simpledb::Database         move-only RAII handle over SimpleDB with
+ *                              std::string_view keys and values
+ *   simpledb::Snapshot         RAII point-in-time view; values are
+ *                              zero-copy string_views valid for its life
+ *   simpledb::KeyList          RAII key array with iterators
+ *   simpledb::Store<K, V>      typed store on a Database (codec per type,
+ *                              allocator for its encode buffers)
+ *   simpledb::FlatMap<K, V>    in-process open-addressing table with
+ *                              compile-time selected hash / equality and
+ *                              a pluggable allocator — fully inlined, no
+ *                              indirect calls on the probe path
+ *
+ * Hash<K> / Equal<K> pick their implementation with if constexpr:
+ * integers and enums use Fibonacci hashing, string-like keys FNV-1a (the
+ * engine's hash), other trivially copyable keys hash / compare their
+ * object bytes with a size known at compile time.
+ *
+ * Errors: allocation failures throw std::bad_alloc; lookups of missing
+ * keys return std::nullopt / end().
+ */
+
+#ifndef SIMPLE_DB_HPP
+#define SIMPLE_DB_HPP
+
+#include "simple_db.h"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace simpledb {
+
+/* -------------------------------------------------------------------------
+ * Hash and equality policies
+ * ---------------------------------------------------------------------- */
+
+namespace detail {
+
+constexpr std::uint64_t fnv1a(const unsigned char *p, std::size_t n) noexcept
+{
+    std::uint64_t h = 14695981039346656037ull;
+    for (std::size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+constexpr std::uint64_t fibonacci(std::uint64_t x) noexcept
+{
+    return x * 0x9E3779B97F4A7C15ull;
+}
+
+template <class K>
+inline constexpr bool is_string_like_v =
+    std::is_convertible_v<const K &, std::string_view>;
+
+template <class K>
+inline constexpr bool is_bytewise_v =
+    std::is_trivially_copyable_v<K> && std::has_unique_object_representations_v<K>;
+
+} // namespace detail
+
+template <class K>
+struct Hash {
+    using is_transparent = void;
+
+    template <class Q>
+    std::uint64_t operator()(const Q &key) const noexcept
+    {
+        if constexpr (std::is_integral_v<Q> || std::is_enum_v<Q>) {
+            return detail::fibonacci(static_cast<std::uint64_t>(key));
+        } else if constexpr (detail::is_string_like_v<Q>) {
+            std::string_view s(key);
+            return detail::fnv1a(reinterpret_cast<const unsigned char *>(s.data()), s.size());
+        } else {
+            static_assert(detail::is_bytewise_v<Q>,
+                          "Hash<K>: provide a hash policy for this key type");
+            if constexpr (sizeof(Q) <= sizeof(std::uint64_t)) {
+                std::uint64_t x = 0;
+                std::memcpy(&x, &key, sizeof(Q));
+                return detail::fibonacci(x);
+            } else {
+                return detail::fnv1a(reinterpret_cast<const unsigned char *>(&key), sizeof(Q));
+            }
+        }
+    }
+};
+
+template <class K>
+struct Equal {
+    using is_transparent = void;
+
+    template <class A, class B>
+    bool operator()(const A &a, const B &b) const noexcept
+    {
+        if constexpr (detail::is_string_like_v<A> && detail::is_string_like_v<B>) {
+            return std::string_view(a) == std::string_view(b);
+        } else if constexpr (std::is_integral_v<A> || std::is_enum_v<A>) {
+            return a == b;
+        } else {
+            static_assert(std::is_same_v<A, B> && detail::is_bytewise_v<A>,
+                          "Equal<K>: provide an equality policy for this key type");
+            return std::memcmp(&a, &b, sizeof(A)) == 0;
+        }
+    }
+};
+
+/* -------------------------------------------------------------------------
+ * Engine handles
+ * ---------------------------------------------------------------------- */
+
+namespace detail {
+
+/* NUL-terminated copy of a string_view for the C API; no heap for short keys. */
+class CString {
+public:
+    explicit CString(std::string_view s)
+    {
+        if (s.size() < sizeof(small_)) {
+            std::memcpy(small_, s.data(), s.size());
+            small_[s.size()] = '\0';
+            ptr_ = small_;
+        } else {
+            big_.assign(s.data(), s.size());
+            ptr_ = big_.c_str();
+        }
+    }
+    CString(const CString &) = delete;
+    CString &operator=(const CString &) = delete;
+
+    const char *c_str() const noexcept { return ptr_; }
+
+private:
+    char        small_[128];
+    std::string big_;
+    const char *ptr_;
+};
+
+} // namespace detail
+
+/** Key array returned by the engine, freed on destruction. */
+class KeyList {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = std::string_view;
+
+        explicit iterator(char *const *p) noexcept : p_(p) {}
+        std::string_view operator*() const noexcept { return *p_; }
+        iterator &operator++() noexcept { ++p_; return *this; }
+        iterator  operator++(int) noexcept { iterator t = *this; ++p_; return t; }
+        difference_type operator-(const iterator &o) const noexcept { return p_ - o.p_; }
+        bool operator==(const iterator &o) const noexcept { return p_ == o.p_; }
+        bool operator!=(const iterator &o) const noexcept { return p_ != o.p_; }
+
+    private:
+        char *const *p_;
+    };
+
+    KeyList() noexcept = default;
+    KeyList(char **keys, std::size_t n) noexcept : keys_(keys), n_(n) {}
+    KeyList(KeyList &&o) noexcept
+        : keys_(std::exchange(o.keys_, nullptr)), n_(std::exchange(o.n_, 0)) {}
+    KeyList &operator=(KeyList &&o) noexcept
+    {
+        if (this != &o) {
+            db_free_keys(keys_, n_);
+            keys_ = std::exchange(o.keys_, nullptr);
+            n_    = std::exchange(o.n_, 0);
+        }
+        return *this;
+    }
+    KeyList(const KeyList &) = delete;
+    KeyList &operator=(const KeyList &) = delete;
+    ~KeyList() { db_free_keys(keys_, n_); }
+
+    std::size_t size() const noexcept { return n_; }
+    bool empty() const noexcept { return n_ == 0; }
+    std::string_view operator[](std::size_t i) const noexcept { return keys_[i]; }
+    iterator begin() const noexcept { return iterator(keys_); }
+    iterator end() const noexcept { return iterator(keys_ + n_); }
+
+private:
+    char      **keys_ = nullptr;
+    std::size_t n_    = 0;
+};
+
+/**
+ * RAII point-in-time view (see db_snapshot_acquire).  Must not be read
+ * after release() or after being moved from.
+ */
+class Snapshot {
+public:
+    Snapshot(SimpleDB *db, DBSnapshot *snap) noexcept : db_(db), snap_(snap) {}
+    Snapshot(Snapshot &&o) noexcept
+        : db_(o.db_), snap_(std::exchange(o.snap_, nullptr)) {}
+    Snapshot &operator=(Snapshot &&o) noexcept
+    {
+        if (this != &o) {
+            release();
+            db_   = o.db_;
+            snap_ = std::exchange(o.snap_, nullptr);
+        }
+        return *this;
+    }
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+    ~Snapshot() { release(); }
+
+    /** Zero-copy: the view stays valid until this snapshot is released. */
+    std::optional<std::string_view> get(std::string_view key) const
+    {
+        const char *v = db_get_at(db_, snap_, detail::CString(key).c_str());
+        if (!v) return std::nullopt;
+        return std::string_view(v);
+    }
+
+    bool contains(std::string_view key) const
+    {
+        return db_exists_at(db_, snap_, detail::CString(key).c_str());
+    }
+
+    std::size_t size() const { return db_count_at(db_, snap_); }
+
+    KeyList keys() const
+    {
+        std::size_t n = 0;
+        char **k = db_keys_at(db_, snap_, &n);
+        return KeyList(k, n);
+    }
+
+    std::uint64_t version() const noexcept { return db_snapshot_version(snap_); }
+
+    void release() noexcept
+    {
+        if (snap_) db_snapshot_release(std::exchange(snap_, nullptr));
+    }
+
+private:
+    SimpleDB   *db_;
+    DBSnapshot *snap_;
+};
+
+/** Move-only owner of a SimpleDB. */
+class Database {
+public:
+    Database() : db_(db_create())
+    {
+        if (!db_) throw std::bad_alloc();
+    }
+
+    explicit Database(const DBOptions &opts) : db_(db_create_with_options(&opts))
+    {
+        if (!db_) throw std::bad_alloc();
+    }
+
+    Database(Database &&o) noexcept : db_(std::exchange(o.db_, nullptr)) {}
+    Database &operator=(Database &&o) noexcept
+    {
+        if (this != &o) {
+            db_destroy(db_);
+            db_ = std::exchange(o.db_, nullptr);
+        }
+        return *this;
+    }
+    Database(const Database &) = delete;
+    Database &operator=(const Database &) = delete;
+    ~Database() { db_destroy(db_); }
+
+    bool set(std::string_view key, std::string_view value)
+    {
+        return db_set(db_, detail::CString(key).c_str(), detail::CString(value).c_str());
+    }
+
+    /** Copies the value under the engine lock, so concurrent writers cannot free it. */
+    std::optional<std::string> get(std::string_view key) const
+    {
+        char *v = nullptr;
+        if (!db_get_copy(db_, nullptr, detail::CString(key).c_str(), &v)) throw std::bad_alloc();
+        if (!v) return std::nullopt;
+        std::unique_ptr<char, void (*)(char *)> owned(v, &db_free_buffer);
+        return std::string(owned.get());
+    }
+
+    bool erase(std::string_view key) { return db_delete(db_, detail::CString(key).c_str()); }
+    bool contains(std::string_view key) const { return db_exists(db_, detail::CString(key).c_str()); }
+    std::size_t size() const { return db_count(db_); }
+    bool clear() { return db_clear(db_); }
+    DBStats stats() const { return db_stats(db_); }
+    std::uint64_t version() const { return db_version(db_); }
+
+    KeyList keys() const
+    {
+        std::size_t n = 0;
+        char **k = db_keys(db_, &n);
+        return KeyList(k, n);
+    }
+
+    Snapshot snapshot() const
+    {
+        DBSnapshot *s = db_snapshot_acquire(db_);
+        if (!s) throw std::bad_alloc();
+        return Snapshot(db_, s);
+    }
+
+    SimpleDB *native() const noexcept { return db_; }
+
+private:
+    SimpleDB *db_;
+};
+
+/* -------------------------------------------------------------------------
+ * Typed store on the engine
+ * ---------------------------------------------------------------------- */
+
+/**
+ * Text encoding of a type for the engine: strings pass through, numbers use
+ * to_chars.  encode may use buf (any std::basic_string<char, ...>) as scratch.
+ */
+template <class T, class = void>
+struct Codec;
+
+template <class T>
+struct Codec<T, std::enable_if_t<detail::is_string_like_v<T>>> {
+    template <class Buf>
+    static std::string_view encode(const T &v, Buf &) { return std::string_view(v); }
+    static std::optional<std::string> decode(std::string_view s) { return std::string(s); }
+};
+
+template <class T>
+struct Codec<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    template <class Buf>
+    static std::string_view encode(T v, Buf &buf)
+    {
+        char tmp[24];
+        auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+        buf.assign(tmp, r.ptr);
+        return std::string_view(buf.data(), buf.size());
+    }
+    static std::optional<T> decode(std::string_view s)
+    {
+        T v{};
+        auto r = std::from_chars(s.data(), s.data() + s.size(), v);
+        if (r.ec != std::errc() || r.ptr != s.data() + s.size()) return std::nullopt;
+        return v;
+    }
+};
+
+/**
+ * Typed view over a Database.  Values that fail to decode read as absent,
+ * so a Store can share a Database with string-keyed users.
+ *
+ * Alloc supplies the scratch buffers keys and values are encoded into.
+ * There is no hash policy: the engine hashes the encoded key itself (use
+ * FlatMap for an in-process table with its own hash and equality).
+ */
+template <class K, class V, class KeyCodec = Codec<K>, class ValueCodec = Codec<V>,
+          class Alloc = std::allocator<char>>
+class Store {
+    using char_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<char>;
+    using buffer     = std::basic_string<char, std::char_traits<char>, char_alloc>;
+
+public:
+    explicit Store(Database &db, const Alloc &alloc = Alloc()) noexcept
+        : db_(&db), alloc_(alloc) {}
+
+    bool set(const K &key, const V &value)
+    {
+        buffer kb(alloc_), vb(alloc_);
+        return db_->set(KeyCodec::encode(key, kb), ValueCodec::encode(value, vb));
+    }
+
+    auto get(const K &key) const -> decltype(ValueCodec::decode(std::string_view()))
+    {
+        buffer kb(alloc_);
+        auto raw = db_->get(KeyCodec::encode(key, kb));
+        if (!raw) return std::nullopt;
+        return ValueCodec::decode(*raw);
+    }
+
+    bool erase(const K &key)
+    {
+        buffer kb(alloc_);
+        return db_->erase(KeyCodec::encode(key, kb));
+    }
+
+    bool contains(const K &key) const
+    {
+        buffer kb(alloc_);
+        return db_->contains(KeyCodec::encode(key, kb));
+    }
+
+private:
+    Database  *db_;
+    char_alloc alloc_;
+};
+
+/* -------------------------------------------------------------------------
+ * FlatMap: header-only open-addressing table
+ * ---------------------------------------------------------------------- */
+
+/**
+ * Linear-probing hash map with inline keys and values.
+ *
+ * Hash, KeyEqual and Alloc are template parameters, so the whole probe
+ * loop inlines.  Keys may be any type the policies accept; K need not be
+ * default-constructible.  Iterators are invalidated by insertion and
+ * erase; references by insertion (rehash).  A moved-from map is empty and
+ * usable; it allocates again on its first insertion.
+ */
+template <class K, class V,
+          class H     = Hash<K>,
+          class Eq    = Equal<K>,
+          class Alloc = std::allocator<std::pair<K, V>>>
+class FlatMap {
+    using value_type = std::pair<K, V>;
+    using slot_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
+    using ctrl_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::uint8_t>;
+    using slot_traits = std::allocator_traits<slot_alloc>;
+    using ctrl_traits = std::allocator_traits<ctrl_alloc>;
+
+    static constexpr std::uint8_t kEmpty   = 0;
+    static constexpr std::uint8_t kFull    = 1;
+    static constexpr std::uint8_t kDeleted = 2;
+
+    static constexpr std::size_t kMinCapacity = 16;
+
+public:
+    template <bool Const>
+    class basic_iterator {
+        using map_ptr = std::conditional_t<Const, const FlatMap *, FlatMap *>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename FlatMap::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::conditional_t<Const, const value_type &, value_type &>;
+        using pointer           = std::conditional_t<Const, const value_type *, value_type *>;
+
+        basic_iterator(map_ptr m, std::size_t i) noexcept : m_(m), i_(i) { skip(); }
+        reference operator*() const noexcept { return m_->slots_[i_]; }
+        pointer operator->() const noexcept { return &m_->slots_[i_]; }
+        basic_iterator &operator++() noexcept { ++i_; skip(); return *this; }
+        basic_iterator operator++(int) noexcept { auto t = *this; ++*this; return t; }
+        bool operator==(const basic_iterator &o) const noexcept { return i_ == o.i_; }
+        bool operator!=(const basic_iterator &o) const noexcept { return i_ != o.i_; }
+
+    private:
+        friend class FlatMap;
+        void skip() noexcept
+        {
+            while (i_ < m_->cap_ && m_->ctrl_[i_] != kFull) ++i_;
+        }
+        map_ptr     m_;
+        std::size_t i_;
+    };
+
+    using iterator       = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    explicit FlatMap(std::size_t capacity_hint = 0, const Alloc &alloc = Alloc())
+        : slot_alloc_(alloc), ctrl_alloc_(alloc)
+    {
+        std::size_t cap = kMinCapacity;
+        while (cap - cap / 4 < capacity_hint) cap *= 2;
+        allocate(cap);
+    }
+
+    FlatMap(FlatMap &&o) noexcept
+        : slot_alloc_(std::move(o.slot_alloc_)), ctrl_alloc_(std::move(o.ctrl_alloc_)),
+          slots_(std::exchange(o.slots_, nullptr)), ctrl_(std::exchange(o.ctrl_, nullptr)),
+          cap_(std::exchange(o.cap_, 0)), size_(std::exchange(o.size_, 0)),
+          used_(std::exchange(o.used_, 0)), shift_(o.shift_) {}
+
+    FlatMap &operator=(FlatMap &&o) noexcept
+    {
+        if (this != &o) {
+            destroy();
+            slot_alloc_ = std::move(o.slot_alloc_);
+            ctrl_alloc_ = std::move(o.ctrl_alloc_);
+            slots_ = std::exchange(o.slots_, nullptr);
+            ctrl_  = std::exchange(o.ctrl_, nullptr);
+            cap_   = std::exchange(o.cap_, 0);
+            size_  = std::exchange(o.size_, 0);
+            used_  = std::exchange(o.used_, 0);
+            shift_ = o.shift_;
+        }
+        return *this;
+    }
+
+    FlatMap(const FlatMap &) = delete;
+    FlatMap &operator=(const FlatMap &) = delete;
+    ~FlatMap() { destroy(); }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    std::size_t capacity() const noexcept { return cap_; }
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, cap_); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, cap_); }
+
+    template <class Q>
+    iterator find(const Q &key) noexcept { return iterator(this, locate(key)); }
+
+    template <class Q>
+    const_iterator find(const Q &key) const noexcept { return const_iterator(this, locate(key)); }
+
+    template <class Q>
+    bool contains(const Q &key) const noexcept { return locate(key) != cap_; }
+
+    /** Insert if absent; returns the element and whether it was inserted. */
+    template <class KK, class... Args>
+    std::pair<iterator, bool> try_emplace(KK &&key, Args &&...args)
+    {
+        std::size_t i = locate(key);
+        if (i != cap_) return {iterator(this, i), false};
+
+        if (used_ + 1 > cap_ - cap_ / 4)
+            rehash(cap_ == 0 ? kMinCapacity : size_ + 1 > cap_ / 2 ? cap_ * 2 : cap_);
+
+        i = free_slot(H{}(key));
+        slot_traits::construct(slot_alloc_, slots_ + i,
+                               std::piecewise_construct,
+                               std::forward_as_tuple(std::forward<KK>(key)),
+                               std::forward_as_tuple(std::forward<Args>(args)...));
+        if (ctrl_[i] == kEmpty) used_++;
+        ctrl_[i] = kFull;
+        size_++;
+        return {iterator(this, i), true};
+    }
+
+    template <class KK, class VV>
+    std::pair<iterator, bool> insert_or_assign(KK &&key, VV &&value)
+    {
+        auto r = try_emplace(std::forward<KK>(key), std::forward<VV>(value));
+        if (!r.second) r.first->second = std::forward<VV>(value);
+        return r;
+    }
+
+    V &operator[](const K &key) { return try_emplace(key).first->second; }
+
+    template <class Q>
+    bool erase(const Q &key) noexcept
+    {
+        std::size_t i = locate(key);
+        if (i == cap_) return false;
+        slot_traits::destroy(slot_alloc_, slots_ + i);
+        ctrl_[i] = kDeleted;
+        size_--;
+        return true;
+    }
+
+    void clear() noexcept
+    {
+        for (std::size_t i = 0; i < cap_; i++) {
+            if (ctrl_[i] == kFull) slot_traits::destroy(slot_alloc_, slots_ + i);
+            ctrl_[i] = kEmpty;
+        }
+        size_ = used_ = 0;
+    }
+
+private:
+    template <class Q>
+    std::size_t locate(const Q &key) const noexcept
+    {
+        if (cap_ == 0) return cap_;   /* moved-from: no table yet */
+        const std::size_t mask = cap_ - 1;
+        std::size_t i = static_cast<std::size_t>(H{}(key) >> shift_) & mask;
+        for (;;) {
+            std::uint8_t c = ctrl_[i];
+            if (c == kEmpty) return cap_;
+            if (c == kFull && Eq{}(slots_[i].first, key)) return i;
+            i = (i + 1) & mask;
+        }
+    }
+
+    static std::size_t free_in(const std::uint8_t *ctrl, std::size_t cap, unsigned shift,
+                               std::uint64_t h) noexcept
+    {
+        const std::size_t mask = cap - 1;
+        std::size_t i = static_cast<std::size_t>(h >> shift) & mask;
+        while (ctrl[i] == kFull) i = (i + 1) & mask;
+        return i;
+    }
+
+    std::size_t free_slot(std::uint64_t h) const noexcept
+    {
+        return free_in(ctrl_, cap_, shift_, h);
+    }
+
+    /* Top hash bits select the slot. */
+    static unsigned shift_for(std::size_t cap) noexcept
+    {
+        unsigned bits = 0;
+        while ((std::size_t(1) << bits) < cap) bits++;
+        return 64u - bits;
+    }
+
+    /* Fresh arrays for cap slots, all empty; nothing is published on failure. */
+    std::pair<value_type *, std::uint8_t *> allocate_arrays(std::size_t cap)
+    {
+        value_type *slots = slot_traits::allocate(slot_alloc_, cap);
+        std::uint8_t *ctrl;
+        try {
+            ctrl = ctrl_traits::allocate(ctrl_alloc_, cap);
+        } catch (...) {
+            slot_traits::deallocate(slot_alloc_, slots, cap);
+            throw;
+        }
+        std::memset(ctrl, kEmpty, cap);
+        return {slots, ctrl};
+    }
+
+    void allocate(std::size_t cap)
+    {
+        std::tie(slots_, ctrl_) = allocate_arrays(cap);
+        shift_ = shift_for(cap);
+        cap_   = cap;
+        size_  = used_ = 0;
+    }
+
+    /*
+     * Strong guarantee: the new table is filled on the side and swapped in
+     * only once complete.  Elements whose move may throw are copied
+     * (move_if_noexcept), so a failure leaves the old table untouched.
+     */
+    void rehash(std::size_t new_cap)
+    {
+        auto [slots, ctrl] = allocate_arrays(new_cap);
+        const unsigned shift = shift_for(new_cap);
+
+        try {
+            for (std::size_t i = 0; i < cap_; i++) {
+                if (ctrl_[i] != kFull) continue;
+                std::size_t j = free_in(ctrl, new_cap, shift, H{}(slots_[i].first));
+                slot_traits::construct(slot_alloc_, slots + j, std::move_if_noexcept(slots_[i]));
+                ctrl[j] = kFull;
+            }
+        } catch (...) {
+            for (std::size_t j = 0; j < new_cap; j++) {
+                if (ctrl[j] == kFull) slot_traits::destroy(slot_alloc_, slots + j);
+            }
+            slot_traits::deallocate(slot_alloc_, slots, new_cap);
+            ctrl_traits::deallocate(ctrl_alloc_, ctrl, new_cap);
+            throw;
+        }
+
+        destroy();
+        slots_ = slots;
+        ctrl_  = ctrl;
+        cap_   = new_cap;
+        shift_ = shift;
+        used_  = size_;
+    }
+
+    void destroy() noexcept
+    {
+        if (!ctrl_) return;
+        for (std::size_t i = 0; i < cap_; i++) {
+            if (ctrl_[i] == kFull) slot_traits::destroy(slot_alloc_, slots_ + i);
+        }
+        slot_traits::deallocate(slot_alloc_, slots_, cap_);
+        ctrl_traits::deallocate(ctrl_alloc_, ctrl_, cap_);
+        slots_ = nullptr;
+        ctrl_  = nullptr;
+    }
+
+    slot_alloc    slot_alloc_;
+    ctrl_alloc    ctrl_alloc_;
+    value_type   *slots_ = nullptr;
+    std::uint8_t *ctrl_  = nullptr;
+    std::size_t   cap_   = 0;
+    std::size_t   size_  = 0;   /* full slots            */
+    std::size_t   used_  = 0;   /* full + deleted slots  */
+    unsigned      shift_ = 64;
+};
+
+} // namespace simpledb
+
+#endif /* SIMPLE_DB_HPP */
@@ -0,0 +1,624 @@
+/**
+ * spanning.c — Minimum spanning forests and approximate Steiner trees
+ *
+ * Both work on an undirected CSR copy of the view (off[u] .. off[u + 1]
+ * indexes u's neighbours in adj, with weights in w), built in parallel.
+ * Borůvka rounds reorder and shorten each node's list in place (deg[u]
+ * is its live length), which is why every call builds its own copy.
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   /* sysconf */
+#endif
+
+#include "spanning.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define CHUNK         256u      /* nodes claimed at a time */
+#define MAX_THREADS   64u
+#define NONE          UINT32_MAX
+
+typedef struct {
+    const GSView  *view;
+    bool           unweighted;
+    size_t         n;
+    size_t        *off;         /* n + 1 */
+    uint32_t      *adj;
+    float         *w;
+    uint32_t      *deg;         /* live list lengths (Borůvka) */
+    _Atomic bool   nan_weight;
+    _Atomic bool   negative_weight;
+} Topo;
+
+typedef void (*RangeFn)(void *ctx, unsigned worker, size_t begin, size_t end);
+
+typedef struct {
+    RangeFn         fn;
+    void           *ctx;
+    size_t          n, chunk;
+    _Atomic size_t  next;
+} Ranges;
+
+typedef struct {
+    Ranges  *r;
+    unsigned worker;
+} RangeWorker;
+
+static unsigned thread_count(unsigned threads, size_t chunks)
+{
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads > chunks)
+        threads = chunks ? (unsigned)chunks : 1;
+    return threads;
+}
+
+static void *range_main(void *arg)
+{
+    RangeWorker *w = arg;
+    Ranges *r = w->r;
+    for (;;) {
+        size_t begin = atomic_fetch_add(&r->next, r->chunk);
+        if (begin >= r->n)
+            break;
+        size_t end = begin + r->chunk < r->n ? begin + r->chunk : r->n;
+        r->fn(r->ctx, w->worker, begin, end);
+    }
+    return NULL;
+}
+
+/*
+ * Run fn over [0, n) in chunks on `threads` workers (the caller is worker
+ * 0).  If a thread cannot be started its share falls to the others.
+ */
+static void parallel_ranges(size_t n, size_t chunk, unsigned threads, RangeFn fn, void *ctx)
+{
+    Ranges r = { .fn = fn, .ctx = ctx, .n = n, .chunk = chunk };
+    atomic_init(&r.next, 0);
+    RangeWorker workers[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    unsigned started = 1;
+
+    for (unsigned t = 0; t < threads; t++)
+        workers[t] = (RangeWorker){ &r, t };
+    for (; started < threads; started++)
+        if (pthread_create(&tids[started], NULL, range_main, &workers[started]) != 0)
+            break;
+    range_main(&workers[0]);
+    for (unsigned t = 1; t < started; t++)
+        pthread_join(tids[t], NULL);
+}
+
+/* Total order on undirected edges: weight, then lower, then higher endpoint. */
+static inline bool edge_less(float w1, uint32_t a1, uint32_t b1,
+                             float w2, uint32_t a2, uint32_t b2)
+{
+    if (w1 != w2)
+        return w1 < w2;
+    uint32_t lo1 = a1 < b1 ? a1 : b1, hi1 = a1 < b1 ? b1 : a1;
+    uint32_t lo2 = a2 < b2 ? a2 : b2, hi2 = a2 < b2 ? b2 : a2;
+    return lo1 != lo2 ? lo1 < lo2 : hi1 < hi2;
+}
+
+static uint32_t uf_find(uint32_t *parent, uint32_t u)
+{
+    while (parent[u] != u) {
+        parent[u] = parent[parent[u]];      /* path halving */
+        u = parent[u];
+    }
+    return u;
+}
+
+/* -------------------------------------------------------------------------
+ * Undirected copy
+ * ---------------------------------------------------------------------- */
+
+/* Union of out- and in-neighbours without u, keeping the lighter weight of
+ * reciprocal edges; counts only if ids is NULL. */
+static size_t undirected_neighbors(Topo *t, uint32_t u, uint32_t *ids, float *w)
+{
+    const uint32_t *a = NULL, *b = NULL;
+    const float *wa = NULL, *wb = NULL;
+    size_t na = gs_view_neighbors(t->view, u, &a, &wa);
+    size_t nb = gs_view_in_neighbors(t->view, u, &b, &wb);
+    size_t i = 0, j = 0, n = 0;
+    while (i < na || j < nb) {
+        uint32_t x;
+        float weight;
+        if (j == nb || (i < na && a[i] < b[j])) {
+            x = a[i];
+            weight = wa[i++];
+        } else if (i == na || b[j] < a[i]) {
+            x = b[j];
+            weight = wb[j++];
+        } else {
+            x = a[i];
+            weight = wa[i] < wb[j] ? wa[i] : wb[j];
+            i++;
+            j++;
+        }
+        if (x == u)
+            continue;
+        if (ids) {
+            if (t->unweighted)
+                weight = 1.0f;
+            else if (isnan(weight))
+                atomic_store_explicit(&t->nan_weight, true, memory_order_relaxed);
+            else if (weight < 0.0f)
+                atomic_store_explicit(&t->negative_weight, true, memory_order_relaxed);
+            ids[n] = x;
+            w[n] = weight;
+        }
+        n++;
+    }
+    return n;
+}
+
+static void degree_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    Topo *t = ctx;
+    (void)worker;
+    for (size_t u = begin; u < end; u++)
+        t->off[u + 1] = undirected_neighbors(t, (uint32_t)u, NULL, NULL);
+}
+
+static void fill_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    Topo *t = ctx;
+    (void)worker;
+    for (size_t u = begin; u < end; u++) {
+        size_t base = t->off[u];
+        t->deg[u] = (uint32_t)undirected_neighbors(t, (uint32_t)u, t->adj + base, t->w + base);
+    }
+}
+
+static void topo_free(Topo *t)
+{
+    free(t->off);
+    free(t->adj);
+    free(t->w);
+    free(t->deg);
+}
+
+static bool topo_open(const GSView *v, unsigned flags, unsigned threads, Topo *t)
+{
+    memset(t, 0, sizeof *t);
+    atomic_init(&t->nan_weight, false);
+    atomic_init(&t->negative_weight, false);
+    if (!v || !gs_view_tracks_in(v))
+        return false;
+    t->view = v;
+    t->unweighted = flags & SP_UNWEIGHTED;
+    t->n = gs_view_node_count(v);
+    t->off = calloc(t->n + 1, sizeof *t->off);
+    t->deg = malloc((t->n ? t->n : 1) * sizeof *t->deg);
+    if (!t->off || !t->deg) {
+        topo_free(t);
+        return false;
+    }
+    threads = thread_count(threads, (t->n + CHUNK - 1) / CHUNK);
+    parallel_ranges(t->n, CHUNK, threads, degree_pass, t);
+    for (size_t u = 0; u < t->n; u++)
+        t->off[u + 1] += t->off[u];
+    size_t m = t->off[t->n] ? t->off[t->n] : 1;
+    t->adj = malloc(m * sizeof *t->adj);
+    t->w = malloc(m * sizeof *t->w);
+    if (!t->adj || !t->w) {
+        topo_free(t);
+        return false;
+    }
+    parallel_ranges(t->n, CHUNK, threads, fill_pass, t);
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Minimum spanning forest (Borůvka)
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    Topo           *t;
+    const uint32_t *comp;       /* component of every node this round */
+    uint32_t       *best;       /* lightest outgoing neighbour, or NONE */
+    float          *best_w;
+} ScanCtx;
+
+static void scan_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    ScanCtx *c = ctx;
+    Topo *t = c->t;
+    (void)worker;
+    for (size_t u = begin; u < end; u++) {
+        uint32_t cu = c->comp[u], d = t->deg[u], bx = NONE;
+        uint32_t *adj = t->adj + t->off[u];
+        float *w = t->w + t->off[u], bw = 0.0f;
+        for (uint32_t i = 0; i < d;) {
+            uint32_t x = adj[i];
+            if (c->comp[x] == cu) {             /* inside: never needed again */
+                d--;
+                adj[i] = adj[d];
+                w[i] = w[d];
+                continue;
+            }
+            if (bx == NONE || edge_less(w[i], (uint32_t)u, x, bw, (uint32_t)u, bx)) {
+                bx = x;
+                bw = w[i];
+            }
+            i++;
+        }
+        t->deg[u] = d;
+        c->best[u] = bx;
+        c->best_w[u] = bw;
+    }
+}
+
+bool sp_mst(const GSView *v, unsigned flags, unsigned threads,
+            uint32_t *out_a, uint32_t *out_b, double *out_w, SPStats *stats)
+{
+    Topo t;
+    uint32_t *comp = NULL, *parent = NULL, *best = NULL, *cbest = NULL;
+    float *best_w = NULL;
+    bool ok = false;
+
+    if (!topo_open(v, flags, threads, &t))
+        return false;
+    if (atomic_load(&t.nan_weight))
+        goto out;
+    size_t n = t.n, m = n ? n : 1;
+    comp = malloc(m * sizeof *comp);
+    parent = malloc(m * sizeof *parent);
+    best = malloc(m * sizeof *best);
+    cbest = malloc(m * sizeof *cbest);
+    best_w = malloc(m * sizeof *best_w);
+    if (!comp || !parent || !best || !cbest || !best_w)
+        goto out;
+
+    size_t linked = 0;
+    for (size_t u = 0; u < n; u++) {
+        comp[u] = parent[u] = (uint32_t)u;
+        cbest[u] = NONE;
+        linked += t.off[u + 1] > t.off[u];
+    }
+    threads = thread_count(threads, (n + CHUNK - 1) / CHUNK);
+    ScanCtx c = { .t = &t, .comp = comp, .best = best, .best_w = best_w };
+    size_t edges = 0;
+    double weight = 0.0;
+
+    for (;;) {
+        parallel_ranges(n, CHUNK, threads, scan_pass, &c);
+        for (size_t u = 0; u < n; u++) {
+            if (best[u] == NONE)
+                continue;
+            uint32_t cu = comp[u], cb = cbest[cu];
+            if (cb == NONE || edge_less(best_w[u], (uint32_t)u, best[u],
+                                        best_w[cb], cb, best[cb]))
+                cbest[cu] = (uint32_t)u;
+        }
+        size_t added = 0;
+        for (size_t r = 0; r < n; r++) {
+            if (comp[r] != r || cbest[r] == NONE)
+                continue;
+            uint32_t u = cbest[r], x = best[u];
+            cbest[r] = NONE;
+            uint32_t ru = uf_find(parent, u), rx = uf_find(parent, x);
+            if (ru == rx)
+                continue;                       /* chosen from both sides */
+            parent[ru > rx ? ru : rx] = ru < rx ? ru : rx;
+            out_a[edges] = u < x ? u : x;
+            out_b[edges] = u < x ? x : u;
+            out_w[edges] = best_w[u];
+            weight += best_w[u];
+            edges++;
+            added++;
+        }
+        if (added == 0)
+            break;
+        for (size_t u = 0; u < n; u++)
+            comp[u] = uf_find(parent, (uint32_t)u);
+    }
+
+    if (stats) {
+        stats->weight = weight;
+        stats->edges = edges;
+        stats->components = linked - edges;
+        stats->threads = threads;
+    }
+    ok = true;
+
+out:
+    free(comp);
+    free(parent);
+    free(best);
+    free(cbest);
+    free(best_w);
+    topo_free(&t);
+    return ok;
+}
+
+/* -------------------------------------------------------------------------
+ * Steiner tree (Mehlhorn)
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    double   d;
+    uint32_t u;
+} HeapItem;
+
+typedef struct {
+    HeapItem *a;
+    size_t    n, cap;
+} Heap;
+
+static bool heap_push(Heap *h, double d, uint32_t u)
+{
+    if (h->n == h->cap) {
+        size_t cap = h->cap ? 2 * h->cap : 1024;
+        HeapItem *a = realloc(h->a, cap * sizeof *a);
+        if (!a)
+            return false;
+        h->a = a;
+        h->cap = cap;
+    }
+    size_t i = h->n++;
+    while (i > 0 && h->a[(i - 1) / 2].d > d) {
+        h->a[i] = h->a[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->a[i] = (HeapItem){ d, u };
+    return true;
+}
+
+static HeapItem heap_pop(Heap *h)
+{
+    HeapItem top = h->a[0], last = h->a[--h->n];
+    size_t i = 0;
+    for (;;) {
+        size_t l = 2 * i + 1, m = l;
+        if (l >= h->n)
+            break;
+        if (l + 1 < h->n && h->a[l + 1].d < h->a[l].d)
+            m = l + 1;
+        if (h->a[m].d >= last.d)
+            break;
+        h->a[i] = h->a[m];
+        i = m;
+    }
+    if (h->n)
+        h->a[i] = last;
+    return top;
+}
+
+/* A candidate edge: a terminal path through graph edge (a, b), or an
+ * edge of the induced subgraph. */
+typedef struct {
+    double   w;
+    uint32_t a, b;
+} Cand;
+
+static int cand_cmp(const void *p, const void *q)
+{
+    const Cand *x = p, *y = q;
+    if (x->w != y->w)
+        return x->w < y->w ? -1 : 1;
+    if (x->a != y->a)
+        return x->a < y->a ? -1 : 1;
+    return (x->b > y->b) - (x->b < y->b);
+}
+
+typedef struct {
+    uint32_t a, b;
+    float    w;
+} TreeEdge;
+
+bool sp_steiner(const GSView *v, const uint32_t *terminals, size_t n_terminals,
+                unsigned flags, uint32_t *out_a, uint32_t *out_b, double *out_w,
+                SPStats *stats)
+{
+    Topo t;
+    double *dist = NULL;
+    uint32_t *base = NULL, *pred = NULL, *parent = NULL, *tree_deg = NULL;
+    uint32_t *inc = NULL, *stack = NULL;
+    size_t *inc_off = NULL;
+    float *pred_w = NULL;
+    uint8_t *mark = NULL;                  /* 1 terminal, 2 in the expansion */
+    uint8_t *alive = NULL;
+    Cand *cands = NULL;
+    TreeEdge *tree = NULL;
+    Heap heap = { 0 };
+    bool ok = false;
+
+    if (!topo_open(v, flags, 1, &t))
+        return false;
+    if (atomic_load(&t.nan_weight) || atomic_load(&t.negative_weight))
+        goto out;
+    size_t n = t.n, m = n ? n : 1;
+    for (size_t i = 0; i < n_terminals; i++)
+        if (terminals[i] >= n)
+            goto out;
+    dist = malloc(m * sizeof *dist);
+    base = malloc(m * sizeof *base);
+    pred = malloc(m * sizeof *pred);
+    pred_w = malloc(m * sizeof *pred_w);
+    parent = malloc(m * sizeof *parent);
+    mark = calloc(m, 1);
+    if (!dist || !base || !pred || !pred_w || !parent || !mark)
+        goto out;
+
+    /* Voronoi regions: nearest terminal (base), distance and predecessor */
+    size_t n_terms = 0;
+    for (size_t u = 0; u < n; u++) {
+        dist[u] = INFINITY;
+        base[u] = pred[u] = NONE;
+        parent[u] = (uint32_t)u;
+    }
+    for (size_t i = 0; i < n_terminals; i++) {
+        uint32_t s = terminals[i];
+        if (mark[s])
+            continue;
+        mark[s] = 1;
+        n_terms++;
+        dist[s] = 0.0;
+        base[s] = s;
+        if (!heap_push(&heap, 0.0, s))
+            goto out;
+    }
+    while (heap.n) {
+        HeapItem it = heap_pop(&heap);
+        uint32_t u = it.u;
+        if (it.d > dist[u])
+            continue;
+        for (size_t i = t.off[u]; i < t.off[u] + t.deg[u]; i++) {
+            uint32_t x = t.adj[i];
+            double nd = it.d + t.w[i];
+            if (nd < dist[x]) {
+                dist[x] = nd;
+                base[x] = base[u];
+                pred[x] = u;
+                pred_w[x] = t.w[i];
+                if (!heap_push(&heap, nd, x))
+                    goto out;
+            }
+        }
+    }
+
+    /* Edges between regions, as terminal-to-terminal path lengths.  Each
+     * undirected edge is listed at both ends, so off[n] / 2 bounds both
+     * this list and the induced subgraph's. */
+    cands = malloc((t.off[n] / 2 + 1) * sizeof *cands);
+    tree = malloc(m * sizeof *tree);
+    if (!cands || !tree)
+        goto out;
+    size_t n_cands = 0;
+    for (size_t u = 0; u < n; u++) {
+        for (size_t i = t.off[u]; i < t.off[u] + t.deg[u]; i++) {
+            uint32_t x = t.adj[i];
+            if (u < x && base[u] != NONE && base[x] != base[u])
+                cands[n_cands++] = (Cand){ dist[u] + t.w[i] + dist[x], (uint32_t)u, x };
+        }
+    }
+    qsort(cands, n_cands, sizeof *cands, cand_cmp);
+
+    /* Kruskal over terminals; expand each chosen path into graph nodes */
+    size_t joins = 0;
+    for (size_t k = 0; k < n_cands && joins + 1 < n_terms; k++) {
+        uint32_t ra = uf_find(parent, base[cands[k].a]), rb = uf_find(parent, base[cands[k].b]);
+        if (ra == rb)
+            continue;
+        parent[ra] = rb;
+        joins++;
+        for (int side = 0; side < 2; side++)
+            for (uint32_t u = side ? cands[k].b : cands[k].a; u != NONE && !mark[u]; u = pred[u])
+                mark[u] = 2;
+    }
+
+    /* Minimum spanning forest of the induced subgraph (Kruskal) */
+    n_cands = 0;
+    for (size_t u = 0; u < n; u++) {
+        if (!mark[u])
+            continue;
+        parent[u] = (uint32_t)u;
+        for (size_t i = t.off[u]; i < t.off[u] + t.deg[u]; i++) {
+            uint32_t x = t.adj[i];
+            if (u < x && mark[x])
+                cands[n_cands++] = (Cand){ t.w[i], (uint32_t)u, x };
+        }
+    }
+    qsort(cands, n_cands, sizeof *cands, cand_cmp);
+    size_t n_tree = 0;
+    for (size_t k = 0; k < n_cands; k++) {
+        uint32_t ra = uf_find(parent, cands[k].a), rb = uf_find(parent, cands[k].b);
+        if (ra == rb)
+            continue;
+        parent[ra] = rb;
+        tree[n_tree++] = (TreeEdge){ cands[k].a, cands[k].b, (float)cands[k].w };
+    }
+
+    /* Prune non-terminal leaves */
+    tree_deg = calloc(m, sizeof *tree_deg);
+    inc_off = calloc(n + 1, sizeof *inc_off);
+    inc = malloc((n_tree ? 2 * n_tree : 1) * sizeof *inc);
+    stack = malloc(m * sizeof *stack);
+    alive = malloc(n_tree ? n_tree : 1);
+    if (!tree_deg || !inc_off || !inc || !stack || !alive)
+        goto out;
+    for (size_t k = 0; k < n_tree; k++) {
+        tree_deg[tree[k].a]++;
+        tree_deg[tree[k].b]++;
+        alive[k] = 1;
+    }
+    for (size_t u = 0; u < n; u++)
+        inc_off[u + 1] = inc_off[u] + tree_deg[u];
+    for (size_t k = 0; k < n_tree; k++) {
+        inc[inc_off[tree[k].a] + --tree_deg[tree[k].a]] = (uint32_t)k;
+        inc[inc_off[tree[k].b] + --tree_deg[tree[k].b]] = (uint32_t)k;
+    }
+    size_t top = 0;
+    for (size_t u = 0; u < n; u++) {
+        tree_deg[u] = (uint32_t)(inc_off[u + 1] - inc_off[u]);
+        if (mark[u] == 2 && tree_deg[u] <= 1)
+            stack[top++] = (uint32_t)u;
+    }
+    while (top) {
+        uint32_t u = stack[--top];
+        for (size_t i = inc_off[u]; i < inc_off[u + 1]; i++) {
+            uint32_t k = inc[i];
+            if (!alive[k])
+                continue;
+            alive[k] = 0;
+            uint32_t x = tree[k].a == u ? tree[k].b : tree[k].a;
+            if (--tree_deg[x] == 1 && mark[x] == 2)
+                stack[top++] = x;
+        }
+        tree_deg[u] = 0;
+    }
+
+    size_t edges = 0;
+    double weight = 0.0;
+    for (size_t k = 0; k < n_tree; k++) {
+        if (!alive[k])
+            continue;
+        out_a[edges] = tree[k].a;
+        out_b[edges] = tree[k].b;
+        out_w[edges] = tree[k].w;
+        weight += tree[k].w;
+        edges++;
+    }
+    if (stats) {
+        stats->weight = weight;
+        stats->edges = edges;
+        stats->components = n_terms - joins;
+        stats->threads = 1;
+    }
+    ok = true;
+
+out:
+    free(dist);
+    free(base);
+    free(pred);
+    free(pred_w);
+    free(parent);
+    free(mark);
+    free(cands);
+    free(tree);
+    free(tree_deg);
+    free(inc_off);
+    free(inc);
+    free(stack);
+    free(alive);
+    free(heap.a);
+    topo_free(&t);
+    return ok;
+}
@@ -0,0 +1,74 @@
+/**
+ * spanning.h — Minimum spanning forests and approximate Steiner trees
+ *
+ * Both treat the graph as undirected: an edge {u, v} exists if either
+ * direction does, weighing the smaller of the two, and self-loops are
+ * ignored.  Views must track in-adjacency (GS_TRACK_IN).  With
+ * SP_UNWEIGHTED every edge weighs 1, so trees minimise hop counts.
+ *
+ * sp_mst runs Borůvka's algorithm: each round, threads find every node's
+ * lightest edge leaving its component, each component keeps the lightest
+ * of its nodes' edges, and the components joined by them are merged
+ * (union-find).  Ties are broken by endpoint IDs, so the forest is
+ * unique.  Edges inside a component are dropped from the scan lists as
+ * they are met, so later rounds only see the edges still between
+ * components.
+ *
+ * sp_steiner follows Mehlhorn's 2-approximation: a multi-source Dijkstra
+ * from all terminals splits the graph into Voronoi regions, each edge
+ * between two regions stands for a terminal-to-terminal path, and the
+ * minimum spanning tree of those paths (Kruskal) is expanded back into
+ * graph edges.  The result is tightened by taking the minimum spanning
+ * tree of the subgraph induced by its nodes and pruning non-terminal
+ * leaves.  Its weight is at most twice the optimum.
+ */
+
+#ifndef SPANNING_H
+#define SPANNING_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "graph_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SP_UNWEIGHTED 0x1       /* every edge weighs 1 */
+
+typedef struct {
+    double   weight;            /* total weight of the edges written */
+    size_t   edges;             /* edges written */
+    size_t   components;        /* mst: trees over nodes with edges;
+                                   steiner: groups of terminals that
+                                   could not be joined */
+    unsigned threads;
+} SPStats;
+
+/**
+ * Minimum spanning forest.  out_a / out_b / out_w hold
+ * gs_view_node_count(v) entries (a forest has fewer edges than nodes).
+ * threads 0 = one per online CPU.  Returns false for NaN weights (unless
+ * SP_UNWEIGHTED), a view without in-adjacency, or lack of memory.
+ */
+bool sp_mst(const GSView *v, unsigned flags, unsigned threads,
+            uint32_t *out_a, uint32_t *out_b, double *out_w, SPStats *stats);
+
+/**
+ * Approximate Steiner tree (a forest if some terminals are disconnected)
+ * joining the terminals; duplicates are ignored.  Outputs hold
+ * gs_view_node_count(v) entries.  Returns false for terminals out of
+ * range, negative or NaN weights (unless SP_UNWEIGHTED), a view without
+ * in-adjacency, or lack of memory.
+ */
+bool sp_steiner(const GSView *v, const uint32_t *terminals, size_t n_terminals,
+                unsigned flags, uint32_t *out_a, uint32_t *out_b, double *out_w,
+                SPStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPANNING_H */
@@ -0,0 +1,533 @@
+/**
+ * text_match.c — Dictionary phrase matching over free text
+ *
+ * Phrases are folded into one buffer as they are added.  tm_build maps
+ * the bytes they use to dense classes (class 0 is every other byte),
+ * inserts them into a trie stored as a states x classes table and turns
+ * it into an Aho-Corasick DFA breadth-first: a missing transition of
+ * state s becomes the transition of fail(s).  Trie edges stay
+ * recognisable afterwards because they are the only transitions that go
+ * one level deeper, which the fuzzy search relies on.
+ */
+
+#include "text_match.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define NONE        UINT32_MAX
+#define FUZZY_MIN   4u          /* shorter phrases only match exactly */
+#define FUZZY_TWO   8u          /* shorter phrases allow one edit */
+
+struct TMDict {
+    char      *text;            /* folded phrases, back to back */
+    size_t     text_len, text_cap;
+    size_t    *off;
+    uint32_t  *len, *value;
+    uint8_t   *kind;
+    size_t     n, cap;
+    uint32_t   max_len;
+    bool       built;
+
+    uint16_t   cls[256];        /* byte -> class */
+    uint32_t   n_classes;
+    uint32_t   n_states;
+    uint32_t  *next;            /* n_states x n_classes */
+    uint32_t  *depth;
+    uint32_t  *out;             /* first phrase ending at the state, or NONE */
+    uint32_t  *out_link;        /* nearest suffix state with phrases, or NONE */
+    uint32_t  *chain;           /* next phrase ending at the same state */
+};
+
+/* A match on the folded text: bytes [start, end). */
+typedef struct {
+    uint32_t start, end;
+    uint32_t phrase;
+    uint32_t distance;
+    bool     fuzzy;
+} Hit;
+
+typedef struct {
+    Hit    *a;
+    size_t  n, cap;
+} Hits;
+
+static bool hits_push(Hits *h, Hit hit)
+{
+    if (h->n == h->cap) {
+        size_t cap = h->cap ? 2 * h->cap : 64;
+        Hit *a = realloc(h->a, cap * sizeof *a);
+        if (!a)
+            return false;
+        h->a = a;
+        h->cap = cap;
+    }
+    h->a[h->n++] = hit;
+    return true;
+}
+
+/* Leftmost first, then longest, then in the order phrases were added. */
+static int hit_cmp(const void *p, const void *q)
+{
+    const Hit *x = p, *y = q;
+    if (x->start != y->start)
+        return x->start < y->start ? -1 : 1;
+    if (x->end != y->end)
+        return x->end > y->end ? -1 : 1;
+    return (x->phrase > y->phrase) - (x->phrase < y->phrase);
+}
+
+static inline bool clause_break(unsigned char c)
+{
+    return c == '.' || c == ';' || c == '!' || c == '?' || c == '\n';
+}
+
+/*
+ * Fold len bytes of src into dst (which needs room for len bytes) and
+ * return the folded length.  map receives the source offset of every
+ * folded byte and clause the number of clause breaks before it (both
+ * optional).  UTF-8 general punctuation and no-break spaces separate
+ * tokens like ASCII punctuation; U+2019 is an apostrophe.
+ */
+static size_t fold(const char *src, size_t len, char *dst, uint32_t *map, uint32_t *clause)
+{
+    size_t n = 0;
+    uint32_t clauses = 0;
+    bool gap = false;
+
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)src[i];
+        if (c == '\'')
+            continue;
+        if (c == 0xE2 && i + 2 < len && ((unsigned char)src[i + 1] & 0xFE) == 0x80) {
+            /* U+2000 .. U+207F: spaces, dashes, quotes, bullets */
+            bool apostrophe = (unsigned char)src[i + 1] == 0x80 && (unsigned char)src[i + 2] == 0x99;
+            i += 2;
+            gap |= !apostrophe;
+            continue;
+        }
+        if (c == 0xC2 && i + 1 < len && (unsigned char)src[i + 1] == 0xA0) {
+            i++;                                /* no-break space */
+            gap = true;
+            continue;
+        }
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+        if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80)) {
+            gap = true;
+            clauses += clause_break(c);
+            continue;
+        }
+        if (gap && n) {
+            dst[n] = ' ';
+            if (map)
+                map[n] = (uint32_t)i;
+            if (clause)
+                clause[n] = clauses;
+            n++;
+        }
+        gap = false;
+        dst[n] = (char)c;
+        if (map)
+            map[n] = (uint32_t)i;
+        if (clause)
+            clause[n] = clauses;
+        n++;
+    }
+    return n;
+}
+
+/* -------------------------------------------------------------------------
+ * Building
+ * ---------------------------------------------------------------------- */
+
+TMDict *tm_create(void)
+{
+    return calloc(1, sizeof(TMDict));
+}
+
+void tm_free(TMDict *d)
+{
+    if (!d)
+        return;
+    free(d->text);
+    free(d->off);
+    free(d->len);
+    free(d->value);
+    free(d->kind);
+    free(d->next);
+    free(d->depth);
+    free(d->out);
+    free(d->out_link);
+    free(d->chain);
+    free(d);
+}
+
+static bool reserve_phrase(TMDict *d, size_t bytes)
+{
+    if (d->text_len + bytes > d->text_cap) {
+        size_t cap = d->text_cap ? d->text_cap : 1024;
+        while (cap < d->text_len + bytes)
+            cap *= 2;
+        char *text = realloc(d->text, cap);
+        if (!text)
+            return false;
+        d->text = text;
+        d->text_cap = cap;
+    }
+    if (d->n == d->cap) {
+        size_t cap = d->cap ? 2 * d->cap : 64;
+        size_t *off = realloc(d->off, cap * sizeof *off);
+        if (off)
+            d->off = off;
+        uint32_t *len = realloc(d->len, cap * sizeof *len);
+        if (len)
+            d->len = len;
+        uint32_t *value = realloc(d->value, cap * sizeof *value);
+        if (value)
+            d->value = value;
+        uint8_t *kind = realloc(d->kind, cap);
+        if (kind)
+            d->kind = kind;
+        if (!off || !len || !value || !kind)
+            return false;
+        d->cap = cap;
+    }
+    return true;
+}
+
+bool tm_add(TMDict *d, const char *phrase, size_t len, uint32_t value, unsigned kind)
+{
+    if (!d || d->built || !phrase || kind > TM_TERMINATOR || len > UINT32_MAX)
+        return false;
+    if (!reserve_phrase(d, len))
+        return false;
+    size_t n = fold(phrase, len, d->text + d->text_len, NULL, NULL);
+    if (n == 0)
+        return false;
+    d->off[d->n] = d->text_len;
+    d->len[d->n] = (uint32_t)n;
+    d->value[d->n] = value;
+    d->kind[d->n] = (uint8_t)kind;
+    d->text_len += n;
+    d->n++;
+    if (n > d->max_len)
+        d->max_len = (uint32_t)n;
+    return true;
+}
+
+bool tm_build(TMDict *d)
+{
+    if (!d || d->built)
+        return false;
+
+    memset(d->cls, 0, sizeof d->cls);
+    d->n_classes = 1;
+    for (size_t i = 0; i < d->text_len; i++) {
+        unsigned char c = (unsigned char)d->text[i];
+        if (!d->cls[c])
+            d->cls[c] = (uint16_t)d->n_classes++;
+    }
+
+    size_t nc = d->n_classes, max_states = d->text_len + 1;
+    uint32_t *fail = NULL, *queue = NULL;
+    bool ok = false;
+    d->next = calloc(max_states * nc, sizeof *d->next);
+    d->depth = calloc(max_states, sizeof *d->depth);
+    d->out = malloc(max_states * sizeof *d->out);
+    d->out_link = malloc(max_states * sizeof *d->out_link);
+    d->chain = malloc((d->n ? d->n : 1) * sizeof *d->chain);
+    fail = calloc(max_states, sizeof *fail);
+    queue = malloc(max_states * sizeof *queue);
+    if (!d->next || !d->depth || !d->out || !d->out_link || !d->chain || !fail || !queue)
+        goto out;
+
+    /* Trie: 0 is the root, and never a child, so 0 marks a missing edge */
+    d->n_states = 1;
+    d->out[0] = NONE;
+    for (size_t p = 0; p < d->n; p++) {
+        uint32_t s = 0;
+        for (uint32_t i = 0; i < d->len[p]; i++) {
+            size_t at = (size_t)s * nc + d->cls[(unsigned char)d->text[d->off[p] + i]];
+            if (!d->next[at]) {
+                uint32_t t = d->n_states++;
+                d->next[at] = t;
+                d->depth[t] = d->depth[s] + 1;
+                d->out[t] = NONE;
+            }
+            s = d->next[at];
+        }
+        d->chain[p] = NONE;
+        if (d->out[s] == NONE) {
+            d->out[s] = (uint32_t)p;
+        } else {                                /* keep insertion order */
+            uint32_t q = d->out[s];
+            while (d->chain[q] != NONE)
+                q = d->chain[q];
+            d->chain[q] = (uint32_t)p;
+        }
+    }
+
+    /* Failure links breadth-first; fail(s) is shallower, so its row is
+     * complete by the time s is filled in */
+    size_t head = 0, tail = 0;
+    d->out_link[0] = NONE;
+    for (size_t c = 1; c < nc; c++)
+        if (d->next[c])
+            queue[tail++] = d->next[c];
+    while (head < tail) {
+        uint32_t s = queue[head++], f = fail[s];
+        d->out_link[s] = d->out[f] != NONE ? f : d->out_link[f];
+        for (size_t c = 0; c < nc; c++) {
+            size_t at = (size_t)s * nc + c;
+            uint32_t t = d->next[at];
+            if (t && d->depth[t] == d->depth[s] + 1) {
+                fail[t] = d->next[(size_t)f * nc + c];
+                queue[tail++] = t;
+            } else {
+                d->next[at] = d->next[(size_t)f * nc + c];
+            }
+        }
+    }
+    d->built = true;
+    ok = true;
+
+out:
+    free(fail);
+    free(queue);
+    return ok;
+}
+
+size_t tm_phrase_count(const TMDict *d)
+{
+    return d ? d->n : 0;
+}
+
+size_t tm_state_count(const TMDict *d)
+{
+    return d ? d->n_states : 0;
+}
+
+/* -------------------------------------------------------------------------
+ * Fuzzy search
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const TMDict *d;
+    const char   *q;            /* folded text from a token start */
+    uint32_t      qlen;         /* bytes the match may span */
+    uint32_t      avail;        /* bytes up to the end of the text */
+    uint32_t      max_edits;
+    uint32_t     *rows;         /* one Levenshtein row per trie depth */
+    Hit           best;
+    bool          found;
+} Fuzzy;
+
+static inline bool token_end(const Fuzzy *f, uint32_t j)
+{
+    return j == f->avail || f->q[j] == ' ';
+}
+
+static void fuzzy_walk(Fuzzy *f, uint32_t s)
+{
+    const TMDict *d = f->d;
+    uint32_t depth = d->depth[s], width = f->qlen + 1;
+    const uint32_t *row = f->rows + (size_t)depth * width;
+
+    if (depth >= FUZZY_MIN && d->out[s] != NONE) {
+        uint32_t k = depth < FUZZY_TWO ? 1 : f->max_edits;
+        if (k > f->max_edits)
+            k = f->max_edits;
+        for (uint32_t j = 1; j <= f->qlen; j++) {
+            if (row[j] > k || !token_end(f, j))
+                continue;
+            for (uint32_t p = d->out[s]; p != NONE; p = d->chain[p]) {
+                if (d->kind[p] != TM_TERM)
+                    continue;
+                Hit *b = &f->best;
+                if (!f->found || row[j] < b->distance ||
+                    (row[j] == b->distance && (j > b->end || (j == b->end && p < b->phrase)))) {
+                    *b = (Hit){ 0, j, p, row[j], true };
+                    f->found = true;
+                }
+            }
+        }
+    }
+    if (depth == d->max_len)
+        return;
+
+    uint32_t *child = f->rows + (size_t)(depth + 1) * width;
+    size_t nc = d->n_classes;
+    for (size_t c = 1; c < nc; c++) {
+        uint32_t t = d->next[(size_t)s * nc + c];
+        if (d->depth[t] != depth + 1)
+            continue;
+        if (depth == 0 && c != d->cls[(unsigned char)f->q[0]])
+            continue;                           /* first byte must match */
+        uint32_t lo = child[0] = row[0] + 1;
+        for (uint32_t j = 1; j <= f->qlen; j++) {
+            uint32_t v = row[j - 1] + (d->cls[(unsigned char)f->q[j - 1]] != c);
+            if (row[j] + 1 < v)
+                v = row[j] + 1;
+            if (child[j - 1] + 1 < v)
+                v = child[j - 1] + 1;
+            child[j] = v;
+            if (v < lo)
+                lo = v;
+        }
+        if (lo <= f->max_edits)
+            fuzzy_walk(f, t);
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Scanning
+ * ---------------------------------------------------------------------- */
+
+int64_t tm_scan(const TMDict *d, const char *text, size_t len, unsigned max_edits,
+                unsigned negation_window, TMMatch *out, size_t cap, TMStats *stats)
+{
+    if (!d || !d->built || (!text && len) || len > UINT32_MAX)
+        return -1;
+
+    size_t m = len ? len : 1, nc = d->n_classes;
+    char *norm = malloc(m);
+    uint32_t *map = malloc(m * sizeof *map);
+    uint32_t *clause = malloc(m * sizeof *clause);
+    uint32_t *tok = malloc(m * sizeof *tok);
+    uint32_t *tok_start = malloc(m * sizeof *tok_start);
+    uint8_t *covered = calloc(m, 1);
+    uint32_t *rows = NULL;
+    Hits hits = { 0 }, keep = { 0 };
+    int64_t found = -1;
+    if (!norm || !map || !clause || !tok || !tok_start || !covered)
+        goto out;
+
+    uint32_t n = (uint32_t)fold(text, len, norm, map, clause);
+    uint32_t tokens = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (i == 0 || norm[i - 1] == ' ')
+            tok_start[tokens++] = i;
+        tok[i] = norm[i] == ' ' ? tokens : tokens - 1;
+    }
+
+    /* Exact matches on token boundaries */
+    uint32_t s = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        s = d->next[(size_t)s * nc + d->cls[(unsigned char)norm[i]]];
+        uint32_t end = i + 1;
+        if (end < n && norm[end] != ' ')
+            continue;
+        for (uint32_t st = d->out[s] != NONE ? s : d->out_link[s]; st != NONE; st = d->out_link[st]) {
+            for (uint32_t p = d->out[st]; p != NONE; p = d->chain[p]) {
+                uint32_t start = end - d->len[p];
+                if (start > 0 && norm[start - 1] != ' ')
+                    continue;
+                if (!hits_push(&hits, (Hit){ start, end, p, 0, false }))
+                    goto out;
+            }
+        }
+    }
+    qsort(hits.a, hits.n, sizeof *hits.a, hit_cmp);
+    uint32_t last_start = 0, last_end = 0;
+    for (size_t k = 0; k < hits.n; k++) {
+        Hit h = hits.a[k];
+        bool same = keep.n && h.start == last_start && h.end == last_end;
+        if (!same && keep.n && h.start < last_end)
+            continue;
+        if (!hits_push(&keep, h))
+            goto out;
+        last_start = h.start;
+        last_end = h.end;
+        for (uint32_t t = tok[h.start]; t <= tok[h.end - 1]; t++)
+            covered[t] = 1;
+    }
+
+    /* Fuzzy matches on the tokens left over */
+    if (max_edits && d->max_len >= FUZZY_MIN) {
+        uint32_t qcap = d->max_len + max_edits;
+        rows = malloc((size_t)(d->max_len + 1) * (qcap + 1) * sizeof *rows);
+        if (!rows)
+            goto out;
+        for (uint32_t t = 0; t < tokens; t++) {
+            if (covered[t])
+                continue;
+            uint32_t start = tok_start[t], limit = n, u = t + 1;
+            while (u < tokens && !covered[u])
+                u++;
+            if (u < tokens)
+                limit = tok_start[u] - 1;
+            Fuzzy f = { .d = d, .q = norm + start, .avail = n - start,
+                        .max_edits = max_edits, .rows = rows };
+            f.qlen = limit - start < qcap ? limit - start : qcap;
+            for (uint32_t j = 0; j <= f.qlen; j++)
+                rows[j] = j;
+            fuzzy_walk(&f, 0);
+            if (!f.found)
+                continue;
+            f.best.start = start;
+            f.best.end += start;
+            if (!hits_push(&keep, f.best))
+                goto out;
+            for (uint32_t v = t; v <= tok[f.best.end - 1]; v++)
+                covered[v] = 1;
+            t = tok[f.best.end - 1];
+        }
+        qsort(keep.a, keep.n, sizeof *keep.a, hit_cmp);
+    }
+
+    /* Negation scopes, then output */
+    bool negating = false;
+    uint32_t cue_tok = 0, cue_clause = 0;
+    size_t terms = 0, spanned = 0;
+    for (size_t k = 0; k < keep.n; k++) {
+        Hit h = keep.a[k];
+        uint32_t first = tok[h.start], last = tok[h.end - 1];
+        spanned += last - first + 1;
+        if (d->kind[h.phrase] == TM_NEGATION) {
+            negating = true;
+            cue_tok = last;
+            cue_clause = clause[h.end - 1];
+            continue;
+        }
+        if (d->kind[h.phrase] == TM_TERMINATOR) {
+            negating = false;
+            continue;
+        }
+        if (terms < cap) {
+            bool negated = negating && clause[h.start] == cue_clause &&
+                           first - cue_tok <= negation_window;
+            out[terms] = (TMMatch){
+                .value = d->value[h.phrase],
+                .start = map[h.start],
+                .end = map[h.end - 1] + 1,
+                .flags = (negated ? TM_NEGATED : 0) | (h.fuzzy ? TM_FUZZY : 0),
+                .distance = h.distance,
+            };
+        }
+        terms++;
+    }
+
+    if (stats) {
+        stats->tokens = tokens;
+        stats->covered = spanned;
+        stats->terms = terms;
+    }
+    found = (int64_t)terms;
+
+out:
+    free(norm);
+    free(map);
+    free(clause);
+    free(tok);
+    free(tok_start);
+    free(covered);
+    free(rows);
+    free(hits.a);
+    free(keep.a);
+    return found;
+}
@@ -0,0 +1,102 @@
+/**
+ * text_match.h — Dictionary phrase matching over free text
+ *
+ * A dictionary maps phrases to caller values (e.g. symptom labels and
+ * synonyms to symptom IDs).  Phrases and text are folded the same way:
+ * ASCII letters lower-cased, apostrophes dropped, every run of other
+ * punctuation or whitespace a single token break.  Other UTF-8 text
+ * matches byte for byte, except that general punctuation (dashes, curly
+ * quotes) and no-break spaces break tokens too.  A phrase matches only
+ * on whole tokens: "ache" does not match inside "headache".
+ *
+ * Exact matches:
+ *   tm_build compiles the phrases into an Aho-Corasick automaton (a full
+ *   DFA over the byte classes the phrases use), so a scan is one table
+ *   lookup per byte however many phrases there are.  Overlapping matches
+ *   are resolved leftmost-longest: "severe headache" wins over
+ *   "headache".  Phrases folded to the same text all match.
+ *
+ * Fuzzy fallback:
+ *   With max_edits > 0, tokens not covered by an exact match are compared
+ *   with the dictionary by walking its trie with a Levenshtein row per
+ *   node (an edit-distance automaton simulated over the trie), pruning
+ *   branches once every cell exceeds the bound.  Phrases under 4 bytes
+ *   never match fuzzily, under 8 bytes allow one edit, longer ones
+ *   max_edits; the first byte must match.
+ *
+ * Negation:
+ *   Phrases added as TM_NEGATION cues ("no", "denies") negate the terms
+ *   that start within negation_window tokens after them in the same
+ *   clause; TM_TERMINATOR phrases ("but") and clause punctuation
+ *   (. ; ! ? and newlines) end the scope.  Commas do not, so "no fever,
+ *   cough or chills" negates all three.
+ *
+ * A built dictionary is immutable: scans may run from any thread.
+ */
+
+#ifndef TEXT_MATCH_H
+#define TEXT_MATCH_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** tm_add kinds. */
+#define TM_TERM        0u   /* reported by tm_scan          */
+#define TM_NEGATION    1u   /* negates the terms after it   */
+#define TM_TERMINATOR  2u   /* ends a negation scope        */
+
+/** TMMatch flags. */
+#define TM_NEGATED  0x1u
+#define TM_FUZZY    0x2u
+
+typedef struct TMDict TMDict;
+
+typedef struct {
+    uint32_t value;          /* tm_add value                         */
+    uint32_t start, end;     /* byte range in the scanned text       */
+    uint32_t flags;          /* TM_NEGATED, TM_FUZZY                 */
+    uint32_t distance;       /* edits (0 for exact matches)          */
+} TMMatch;
+
+typedef struct {
+    size_t tokens;           /* tokens in the text                   */
+    size_t covered;          /* tokens inside terms, cues and
+                                terminators                          */
+    size_t terms;            /* term matches (may exceed capacity)   */
+} TMStats;
+
+TMDict *tm_create(void);
+void    tm_free(TMDict *d);
+
+/**
+ * Add a phrase (len bytes, not NUL-terminated).  Returns false after
+ * tm_build, for an unknown kind, a phrase that folds to nothing, or
+ * lack of memory.
+ */
+bool tm_add(TMDict *d, const char *phrase, size_t len, uint32_t value, unsigned kind);
+
+/** Compile the automaton; no phrases can be added afterwards. */
+bool tm_build(TMDict *d);
+
+size_t tm_phrase_count(const TMDict *d);
+size_t tm_state_count(const TMDict *d);
+
+/**
+ * Find the terms in text, ordered by position.  Writes at most cap
+ * matches to out and returns the number found (larger than cap if out
+ * was too small), or -1 if the dictionary is not built, the text is
+ * longer than UINT32_MAX bytes, or memory runs out.
+ */
+int64_t tm_scan(const TMDict *d, const char *text, size_t len, unsigned max_edits,
+                unsigned negation_window, TMMatch *out, size_t cap, TMStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEXT_MATCH_H */
@@ -0,0 +1,583 @@
+/**
+ * triangles.c — Triangle counting and clustering coefficients
+ *
+ * Both entry points first build a compressed sparse row (CSR) copy of the
+ * undirected graph: off[u] .. off[u + 1] indexes u's sorted neighbours in
+ * adj.  tc_count additionally keeps the forward (higher-ranked) part of
+ * every list in a second CSR.  Each build step is a degree pass, a prefix
+ * sum and a fill pass, the passes running in parallel over vertices.
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   /* sysconf */
+#endif
+
+#include "triangles.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define CHUNK        256u       /* vertices claimed at a time            */
+#define SAMPLE_CHUNK 4096u      /* samples per RNG stream                */
+#define MAX_THREADS  64u
+#define HUB_MIN      64u        /* forward lists this long use a bitmap  */
+#define GALLOP_RATIO 32u        /* list length ratio that switches to galloping */
+
+typedef struct {
+    size_t    n;
+    size_t   *off;              /* n + 1 */
+    uint32_t *adj;
+    size_t   *foff;             /* forward lists (tc_count only) */
+    uint32_t *fwd;
+} Csr;
+
+typedef void (*RangeFn)(void *ctx, unsigned worker, size_t begin, size_t end);
+
+typedef struct {
+    RangeFn         fn;
+    void           *ctx;
+    size_t          n, chunk;
+    _Atomic size_t  next;
+} Ranges;
+
+typedef struct {
+    Ranges  *r;
+    unsigned worker;
+} RangeWorker;
+
+static unsigned thread_count(unsigned threads, size_t chunks)
+{
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads > chunks)
+        threads = chunks ? (unsigned)chunks : 1;
+    return threads;
+}
+
+static void *range_main(void *arg)
+{
+    RangeWorker *w = arg;
+    Ranges *r = w->r;
+    for (;;) {
+        size_t begin = atomic_fetch_add(&r->next, r->chunk);
+        if (begin >= r->n)
+            break;
+        size_t end = begin + r->chunk < r->n ? begin + r->chunk : r->n;
+        r->fn(r->ctx, w->worker, begin, end);
+    }
+    return NULL;
+}
+
+/*
+ * Run fn over [0, n) in chunks on `threads` workers (the caller is worker
+ * 0).  If a thread cannot be started its share falls to the others.
+ */
+static void parallel_ranges(size_t n, size_t chunk, unsigned threads, RangeFn fn, void *ctx)
+{
+    Ranges r = { .fn = fn, .ctx = ctx, .n = n, .chunk = chunk };
+    atomic_init(&r.next, 0);
+    RangeWorker workers[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    unsigned started = 1;
+
+    for (unsigned t = 0; t < threads; t++)
+        workers[t] = (RangeWorker){ &r, t };
+    for (; started < threads; started++)
+        if (pthread_create(&tids[started], NULL, range_main, &workers[started]) != 0)
+            break;
+    range_main(&workers[0]);
+    for (unsigned t = 1; t < started; t++)
+        pthread_join(tids[t], NULL);
+}
+
+/* -------------------------------------------------------------------------
+ * Undirected CSR
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const GSView *view;
+    Csr          *g;
+} BuildCtx;
+
+/* Sorted union of out- and in-neighbours without u; counts only if out is NULL. */
+static size_t undirected_neighbors(const GSView *v, uint32_t u, uint32_t *out)
+{
+    const uint32_t *a = NULL, *b = NULL;
+    size_t na = gs_view_neighbors(v, u, &a, NULL);
+    size_t nb = gs_view_in_neighbors(v, u, &b, NULL);
+    size_t i = 0, j = 0, n = 0;
+    while (i < na || j < nb) {
+        uint32_t x;
+        if (j == nb || (i < na && a[i] < b[j]))
+            x = a[i++];
+        else if (i == na || b[j] < a[i])
+            x = b[j++];
+        else {
+            x = a[i++];
+            j++;
+        }
+        if (x == u)
+            continue;
+        if (out)
+            out[n] = x;
+        n++;
+    }
+    return n;
+}
+
+static void degree_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    BuildCtx *c = ctx;
+    (void)worker;
+    for (size_t u = begin; u < end; u++)
+        c->g->off[u + 1] = undirected_neighbors(c->view, (uint32_t)u, NULL);
+}
+
+static void fill_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    BuildCtx *c = ctx;
+    (void)worker;
+    for (size_t u = begin; u < end; u++)
+        undirected_neighbors(c->view, (uint32_t)u, c->g->adj + c->g->off[u]);
+}
+
+static inline size_t degree(const Csr *g, uint32_t u)
+{
+    return g->off[u + 1] - g->off[u];
+}
+
+/* Orientation: u -> v if u ranks below v by (degree, ID). */
+static inline bool ranks_below(const Csr *g, uint32_t u, uint32_t v)
+{
+    size_t du = degree(g, u), dv = degree(g, v);
+    return du < dv || (du == dv && u < v);
+}
+
+static void forward_degree_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    Csr *g = ((BuildCtx *)ctx)->g;
+    (void)worker;
+    for (size_t u = begin; u < end; u++) {
+        size_t n = 0;
+        for (size_t i = g->off[u]; i < g->off[u + 1]; i++)
+            n += ranks_below(g, (uint32_t)u, g->adj[i]);
+        g->foff[u + 1] = n;
+    }
+}
+
+static void forward_fill_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    Csr *g = ((BuildCtx *)ctx)->g;
+    (void)worker;
+    for (size_t u = begin; u < end; u++) {
+        uint32_t *out = g->fwd + g->foff[u];
+        for (size_t i = g->off[u]; i < g->off[u + 1]; i++)
+            if (ranks_below(g, (uint32_t)u, g->adj[i]))
+                *out++ = g->adj[i];
+    }
+}
+
+static void csr_free(Csr *g)
+{
+    free(g->off);
+    free(g->adj);
+    free(g->foff);
+    free(g->fwd);
+}
+
+static void prefix_sum(size_t *off, size_t n)
+{
+    off[0] = 0;
+    for (size_t u = 0; u < n; u++)
+        off[u + 1] += off[u];
+}
+
+static bool csr_build(const GSView *v, unsigned threads, bool forward, Csr *g)
+{
+    memset(g, 0, sizeof *g);
+    if (!gs_view_tracks_in(v))
+        return false;
+    g->n = gs_view_node_count(v);
+    g->off = calloc(g->n + 1, sizeof *g->off);
+    if (!g->off)
+        return false;
+
+    BuildCtx ctx = { v, g };
+    parallel_ranges(g->n, CHUNK, threads, degree_pass, &ctx);
+    prefix_sum(g->off, g->n);
+    g->adj = malloc((g->off[g->n] ? g->off[g->n] : 1) * sizeof *g->adj);
+    if (!g->adj)
+        goto fail;
+    parallel_ranges(g->n, CHUNK, threads, fill_pass, &ctx);
+    if (!forward)
+        return true;
+
+    g->foff = calloc(g->n + 1, sizeof *g->foff);
+    if (!g->foff)
+        goto fail;
+    parallel_ranges(g->n, CHUNK, threads, forward_degree_pass, &ctx);
+    prefix_sum(g->foff, g->n);
+    g->fwd = malloc((g->foff[g->n] ? g->foff[g->n] : 1) * sizeof *g->fwd);
+    if (!g->fwd)
+        goto fail;
+    parallel_ranges(g->n, CHUNK, threads, forward_fill_pass, &ctx);
+    return true;
+
+fail:
+    csr_free(g);
+    return false;
+}
+
+/* Wedge totals and node counts shared by both entry points. */
+static void csr_summary(const Csr *g, TCResult *out)
+{
+    memset(out, 0, sizeof *out);
+    for (size_t u = 0; u < g->n; u++) {
+        uint64_t d = degree(g, (uint32_t)u);
+        out->wedges += d > 1 ? d * (d - 1) / 2 : 0;
+        out->nodes += d > 0;
+        out->clustered_nodes += d > 1;
+    }
+    out->edges = g->off[g->n] / 2;
+}
+
+/* -------------------------------------------------------------------------
+ * Intersection kernels
+ * ---------------------------------------------------------------------- */
+
+static size_t gallop_count(const uint32_t *small, size_t ns, const uint32_t *large, size_t nl)
+{
+    size_t count = 0, pos = 0;
+    for (size_t i = 0; i < ns && pos < nl; i++) {
+        uint32_t x = small[i];
+        size_t step = 1, lo = pos, hi = pos;
+        while (hi < nl && large[hi] < x) {
+            lo = hi + 1;
+            hi += step;
+            step *= 2;
+        }
+        if (hi > nl)
+            hi = nl;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (large[mid] < x)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        pos = lo;
+        count += pos < nl && large[pos] == x;
+    }
+    return count;
+}
+
+/* Size of the intersection of two sorted lists of distinct IDs. */
+static size_t intersect_count(const uint32_t *a, size_t na, const uint32_t *b, size_t nb)
+{
+    if (na * GALLOP_RATIO < nb)
+        return gallop_count(a, na, b, nb);
+    if (nb * GALLOP_RATIO < na)
+        return gallop_count(b, nb, a, na);
+
+    size_t i = 0, j = 0, count = 0;
+#if defined(__SSE2__)
+    /*
+     * Compare 4x4 blocks: a's block against the four rotations of b's.
+     * Advance whichever block ends lower (both on a tie); since IDs are
+     * distinct, every match is seen exactly once.
+     */
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + j));
+        __m128i m = _mm_cmpeq_epi32(va, vb);
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, vb));
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, vb));
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, vb));
+        count += (size_t)__builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(m)));
+        uint32_t amax = a[i + 3], bmax = b[j + 3];
+        if (amax <= bmax)
+            i += 4;
+        if (bmax <= amax)
+            j += 4;
+    }
+#endif
+    while (i < na && j < nb) {
+        if (a[i] < b[j])
+            i++;
+        else if (b[j] < a[i])
+            j++;
+        else {
+            count++;
+            i++;
+            j++;
+        }
+    }
+    return count;
+}
+
+/* -------------------------------------------------------------------------
+ * Exact counting
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const Csr        *g;
+    _Atomic uint64_t *per_node;        /* NULL for the global count only */
+    uint64_t         *bitmaps[MAX_THREADS];
+    _Atomic uint64_t  total;
+} CountCtx;
+
+static void count_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    CountCtx *c = ctx;
+    const Csr *g = c->g;
+    uint64_t *mark = c->bitmaps[worker];
+    uint64_t total = 0;
+
+    for (size_t u = begin; u < end; u++) {
+        const uint32_t *fu = g->fwd + g->foff[u];
+        size_t nu = g->foff[u + 1] - g->foff[u];
+        if (nu < 2)
+            continue;
+        uint64_t at_u = 0;
+
+        if (nu >= HUB_MIN || c->per_node) {
+            for (size_t i = 0; i < nu; i++)
+                mark[fu[i] >> 6] |= (uint64_t)1 << (fu[i] & 63);
+            for (size_t i = 0; i < nu; i++) {
+                uint32_t v = fu[i];
+                uint64_t at_v = 0;
+                for (size_t k = g->foff[v]; k < g->foff[v + 1]; k++) {
+                    uint32_t w = g->fwd[k];
+                    if (mark[w >> 6] >> (w & 63) & 1) {
+                        at_v++;
+                        if (c->per_node)
+                            atomic_fetch_add_explicit(&c->per_node[w], 1, memory_order_relaxed);
+                    }
+                }
+                if (at_v && c->per_node)
+                    atomic_fetch_add_explicit(&c->per_node[v], at_v, memory_order_relaxed);
+                at_u += at_v;
+            }
+            for (size_t i = 0; i < nu; i++)
+                mark[fu[i] >> 6] = 0;
+        } else {
+            for (size_t i = 0; i < nu; i++) {
+                uint32_t v = fu[i];
+                at_u += intersect_count(fu, nu, g->fwd + g->foff[v], g->foff[v + 1] - g->foff[v]);
+            }
+        }
+        if (at_u && c->per_node)
+            atomic_fetch_add_explicit(&c->per_node[u], at_u, memory_order_relaxed);
+        total += at_u;
+    }
+    atomic_fetch_add(&c->total, total);
+}
+
+bool tc_count(const GSView *v, unsigned threads,
+              uint64_t *triangles, double *clustering, TCResult *out)
+{
+    Csr g;
+    threads = thread_count(threads, (gs_view_node_count(v) + CHUNK - 1) / CHUNK);
+    if (!csr_build(v, threads, true, &g))
+        return false;
+
+    bool ok = false;
+    CountCtx c = { .g = &g };
+    atomic_init(&c.total, 0);
+    size_t words = g.n / 64 + 1;
+    for (unsigned t = 0; t < threads; t++)
+        if (!(c.bitmaps[t] = calloc(words, sizeof(uint64_t))))
+            goto out;
+    if (triangles || clustering) {
+        c.per_node = calloc(g.n ? g.n : 1, sizeof *c.per_node);
+        if (!c.per_node)
+            goto out;
+    }
+
+    parallel_ranges(g.n, CHUNK, threads, count_pass, &c);
+
+    TCResult r;
+    csr_summary(&g, &r);
+    r.triangles = atomic_load(&c.total);
+    r.transitivity = r.wedges ? 3.0 * (double)r.triangles / (double)r.wedges : 0.0;
+    double sum = 0.0;
+    for (size_t u = 0; u < g.n; u++) {
+        uint64_t d = degree(&g, (uint32_t)u);
+        uint64_t t = c.per_node ? atomic_load_explicit(&c.per_node[u], memory_order_relaxed) : 0;
+        double cc = d > 1 ? 2.0 * (double)t / ((double)d * (double)(d - 1)) : 0.0;
+        sum += cc;
+        if (triangles)
+            triangles[u] = t;
+        if (clustering)
+            clustering[u] = cc;
+    }
+    if (!c.per_node)
+        r.avg_clustering = -1.0;
+    else
+        r.avg_clustering = r.clustered_nodes ? sum / (double)r.clustered_nodes : 0.0;
+    if (out)
+        *out = r;
+    ok = true;
+
+out:
+    for (unsigned t = 0; t < threads; t++)
+        free(c.bitmaps[t]);
+    free(c.per_node);
+    csr_free(&g);
+    return ok;
+}
+
+/* -------------------------------------------------------------------------
+ * Wedge sampling
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const Csr        *g;
+    const uint64_t   *wedge_prefix;     /* wedges centred below each node */
+    const uint32_t   *clustered;        /* nodes with two or more neighbours */
+    size_t            n_clustered;
+    uint64_t          seed;
+    uint64_t          uniform;          /* samples [0, uniform) are wedge-uniform */
+    _Atomic uint64_t  closed_uniform;
+    _Atomic uint64_t  closed_node;
+} SampleCtx;
+
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static bool adjacent(const Csr *g, uint32_t a, uint32_t b)
+{
+    if (degree(g, a) > degree(g, b)) {
+        uint32_t t = a;
+        a = b;
+        b = t;
+    }
+    size_t lo = g->off[a], hi = g->off[a + 1];
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (g->adj[mid] < b)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < g->off[a + 1] && g->adj[lo] == b;
+}
+
+/* Draw a random wedge centred at u (degree >= 2); true if it closes. */
+static bool wedge_closed(const Csr *g, uint32_t u, uint64_t *rng)
+{
+    size_t d = degree(g, u);
+    size_t i = splitmix64(rng) % d;
+    size_t j = splitmix64(rng) % (d - 1);
+    if (j >= i)
+        j++;
+    return adjacent(g, g->adj[g->off[u] + i], g->adj[g->off[u] + j]);
+}
+
+static void sample_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    SampleCtx *c = ctx;
+    const Csr *g = c->g;
+    uint64_t total = c->wedge_prefix[g->n];
+    uint64_t rng = c->seed ^ ((uint64_t)(begin / SAMPLE_CHUNK) * 0xD1B54A32D192ED03ull);
+    uint64_t closed_uniform = 0, closed_node = 0;
+    (void)worker;
+
+    for (size_t s = begin; s < end; s++) {
+        if (s < c->uniform) {
+            /* Centre chosen with probability proportional to its wedges. */
+            uint64_t r = splitmix64(&rng) % total;
+            size_t lo = 0, hi = g->n;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (c->wedge_prefix[mid + 1] <= r)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            closed_uniform += wedge_closed(g, (uint32_t)lo, &rng);
+        } else {
+            uint32_t u = c->clustered[splitmix64(&rng) % c->n_clustered];
+            closed_node += wedge_closed(g, u, &rng);
+        }
+    }
+    atomic_fetch_add(&c->closed_uniform, closed_uniform);
+    atomic_fetch_add(&c->closed_node, closed_node);
+}
+
+bool tc_estimate(const GSView *v, uint64_t samples, uint64_t seed,
+                 unsigned threads, TCResult *out)
+{
+    Csr g;
+    threads = thread_count(threads, (gs_view_node_count(v) + CHUNK - 1) / CHUNK);
+    if (!csr_build(v, threads, false, &g))
+        return false;
+
+    TCResult r;
+    csr_summary(&g, &r);
+    uint64_t *prefix = malloc((g.n + 1) * sizeof *prefix);
+    uint32_t *clustered = malloc((r.clustered_nodes ? r.clustered_nodes : 1) * sizeof *clustered);
+    bool ok = prefix && clustered;
+
+    if (ok && r.wedges && samples) {
+        size_t k = 0;
+        prefix[0] = 0;
+        for (size_t u = 0; u < g.n; u++) {
+            uint64_t d = degree(&g, (uint32_t)u);
+            prefix[u + 1] = prefix[u] + (d > 1 ? d * (d - 1) / 2 : 0);
+            if (d > 1)
+                clustered[k++] = (uint32_t)u;
+        }
+
+        SampleCtx c = {
+            .g = &g, .wedge_prefix = prefix, .clustered = clustered,
+            .n_clustered = r.clustered_nodes, .seed = seed,
+            .uniform = (samples + 1) / 2,
+        };
+        atomic_init(&c.closed_uniform, 0);
+        atomic_init(&c.closed_node, 0);
+        parallel_ranges(samples, SAMPLE_CHUNK,
+                        thread_count(threads, (samples + SAMPLE_CHUNK - 1) / SAMPLE_CHUNK),
+                        sample_pass, &c);
+
+        r.samples = samples;
+        r.transitivity = (double)atomic_load(&c.closed_uniform) / (double)c.uniform;
+        r.triangles = (uint64_t)(r.transitivity * (double)r.wedges / 3.0 + 0.5);
+        if (samples > c.uniform)
+            r.avg_clustering = (double)atomic_load(&c.closed_node) / (double)(samples - c.uniform);
+        else
+            r.avg_clustering = r.transitivity;
+    } else if (ok) {
+        r.samples = samples;
+    }
+    if (ok && out)
+        *out = r;
+
+    free(prefix);
+    free(clustered);
+    csr_free(&g);
+    return ok;
+}
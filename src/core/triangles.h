@@ -0,0 +1,74 @@
+/**
+ * triangles.h — Triangle counting and clustering coefficients
+ *
+ * Works on the undirected simple graph underlying a graph_store view:
+ * edge directions are ignored, reciprocal edges count once and self-loops
+ * are dropped.  The view must track in-adjacency (GS_TRACK_IN).
+ *
+ * Exact counts:
+ *   Every edge is oriented from lower to higher (degree, ID) rank, which
+ *   bounds each forward list by O(sqrt(m)).  A triangle is then found
+ *   exactly once, at its lowest-ranked vertex u, as a common forward
+ *   neighbour w of u and one of u's forward neighbours v.  For totals,
+ *   common neighbours are counted by a SIMD block merge (SSE2), galloping
+ *   when one list is much shorter.  Hubs, and every vertex when per-node
+ *   counts are wanted (w must be identified), mark u's list in a bitmap
+ *   and probe v's.  Threads take vertices in chunks from a shared counter.
+ *
+ * Estimates:
+ *   tc_estimate samples wedges (paths a - u - b) and checks whether they
+ *   close.  Wedges drawn uniformly estimate transitivity and the triangle
+ *   count; wedges drawn at uniformly chosen vertices estimate the average
+ *   clustering coefficient.  The standard error is about 1/sqrt(samples)
+ *   and results only depend on the seed, not the thread count.
+ */
+
+#ifndef TRIANGLES_H
+#define TRIANGLES_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "graph_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint64_t triangles;        /* estimated when samples > 0                  */
+    uint64_t wedges;           /* connected triples (always exact)            */
+    double   transitivity;     /* 3 * triangles / wedges                      */
+    double   avg_clustering;   /* mean local coefficient over clustered_nodes;
+                                  negative if not computed (see tc_count)     */
+    size_t   nodes;            /* nodes with at least one neighbour           */
+    size_t   clustered_nodes;  /* nodes with at least two neighbours          */
+    size_t   edges;            /* undirected, without self-loops              */
+    uint64_t samples;          /* wedges sampled; 0 for exact counts          */
+} TCResult;
+
+/**
+ * Count triangles exactly.
+ *
+ * triangles / clustering (either may be NULL) receive per-node values and
+ * must hold gs_view_node_count(v) entries.  With both NULL only the totals
+ * are computed, using the counting-only intersection kernels, and
+ * out->avg_clustering is left negative.  threads 0 = one per online CPU.
+ * Returns false if the view lacks in-adjacency or memory runs out.
+ */
+bool tc_count(const GSView *v, unsigned threads,
+              uint64_t *triangles, double *clustering, TCResult *out);
+
+/**
+ * Estimate triangle statistics from `samples` wedges (split between the
+ * two estimators).  Same failure cases as tc_count.
+ */
+bool tc_estimate(const GSView *v, uint64_t samples, uint64_t seed,
+                 unsigned threads, TCResult *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRIANGLES_H */
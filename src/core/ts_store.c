@@ -0,0 +1,748 @@
+/**
+ * ts_store.c — Append-only time-series store for test results
+ *
+ * Design:
+ *   - Series are found through a chained hash table (FNV-1a, doubling at
+ *     load factor 0.75), as in simple_db.c
+ *   - A series owns an array of blocks in time order; only the last block
+ *     is open for appends, earlier ones are sealed (buffer trimmed)
+ *   - A block is one MSB-first bit stream plus its encoder state and a
+ *     running TSSummary
+ *   - Queries decode only blocks overlapping the requested range; whole
+ *     blocks inside a summarize range are merged from their summaries
+ */
+
+#include "ts_store.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define DEFAULT_BLOCK_SPAN  INT64_C(86400000)   /* one day in ms */
+#define INITIAL_CAPACITY    64u
+#define LOAD_FACTOR_MAX     0.75
+
+typedef struct {
+    uint8_t *buf;
+    size_t   nbits;
+    size_t   cap;            /* bytes */
+} BitBuf;
+
+typedef struct {
+    int64_t   start;
+    TSSummary sum;
+    BitBuf    bits;
+
+    /* encoder state: the last point written */
+    int64_t   prev_ts;
+    int64_t   prev_delta;
+    uint64_t  prev_dur;      /* IEEE-754 bits */
+    unsigned  prev_lead;     /* XOR window of the last explicit header */
+    unsigned  prev_trail;
+    bool      window;        /* prev_lead / prev_trail are valid        */
+    uint8_t   prev_status;
+    uint32_t  prev_ref;
+} Block;
+
+typedef struct Series {
+    char          *name;
+    Block        **blocks;
+    size_t         nblocks;
+    size_t         cap;
+    size_t         points;
+    struct Series *next;     /* hash chain */
+} Series;
+
+struct TSStore {
+    Series        **buckets;
+    size_t          capacity;
+    size_t          count;
+    int64_t         span;
+    pthread_mutex_t lock;
+};
+
+/* -------------------------------------------------------------------------
+ * Helpers
+ * ---------------------------------------------------------------------- */
+
+static uint64_t fnv1a(const char *s)
+{
+    uint64_t hash  = UINT64_C(14695981039346656037);
+    uint64_t prime = UINT64_C(1099511628211);
+    while (*s) {
+        hash ^= (uint8_t)(*s++);
+        hash *= prime;
+    }
+    return hash;
+}
+
+static inline size_t bucket_index(uint64_t hash, size_t capacity)
+{
+    return (size_t)(hash & (uint64_t)(capacity - 1));
+}
+
+static inline int64_t floor_to(int64_t ts, int64_t span)
+{
+    int64_t q = ts / span;
+    if (ts % span != 0 && ts < 0) q--;
+    return q * span;
+}
+
+static inline uint64_t dbl_bits(double d)
+{
+    uint64_t u;
+    memcpy(&u, &d, sizeof(u));
+    return u;
+}
+
+static inline double bits_dbl(uint64_t u)
+{
+    double d;
+    memcpy(&d, &u, sizeof(d));
+    return d;
+}
+
+/* -------------------------------------------------------------------------
+ * Bit streams
+ * ---------------------------------------------------------------------- */
+
+/* Append the low n bits of v, most significant first. */
+static bool bits_put(BitBuf *b, uint64_t v, unsigned n)
+{
+    size_t need = (b->nbits + n + 7) / 8;
+    if (need > b->cap) {
+        size_t cap = b->cap ? b->cap * 2 : 64;
+        while (cap < need) cap *= 2;
+        uint8_t *p = realloc(b->buf, cap);
+        if (!p) return false;
+        memset(p + b->cap, 0, cap - b->cap);
+        b->buf = p;
+        b->cap = cap;
+    }
+    for (unsigned i = n; i-- > 0; ) {
+        if ((v >> i) & 1u) b->buf[b->nbits >> 3] |= (uint8_t)(0x80u >> (b->nbits & 7));
+        b->nbits++;
+    }
+    return true;
+}
+
+typedef struct {
+    const uint8_t *buf;
+    size_t         pos;
+} BitReader;
+
+static uint64_t bits_get(BitReader *r, unsigned n)
+{
+    uint64_t v = 0;
+    for (unsigned i = 0; i < n; i++) {
+        v = (v << 1) | ((r->buf[r->pos >> 3] >> (7 - (r->pos & 7))) & 1u);
+        r->pos++;
+    }
+    return v;
+}
+
+static inline int64_t sign_extend(uint64_t v, unsigned bits)
+{
+    uint64_t m = UINT64_C(1) << (bits - 1);
+    return (int64_t)((v ^ m) - m);
+}
+
+/* -------------------------------------------------------------------------
+ * Point codec
+ * ---------------------------------------------------------------------- */
+
+/* Delta-of-delta buckets: prefix, payload width. */
+static bool put_dod(BitBuf *b, int64_t dod)
+{
+    if (dod == 0)                     return bits_put(b, 0x0, 1);
+    if (dod >= -64   && dod <= 63)    return bits_put(b, 0x2, 2) && bits_put(b, (uint64_t)dod, 7);
+    if (dod >= -256  && dod <= 255)   return bits_put(b, 0x6, 3) && bits_put(b, (uint64_t)dod, 9);
+    if (dod >= -2048 && dod <= 2047)  return bits_put(b, 0xE, 4) && bits_put(b, (uint64_t)dod, 12);
+    return bits_put(b, 0xF, 4) && bits_put(b, (uint64_t)dod, 64);
+}
+
+static int64_t get_dod(BitReader *r)
+{
+    if (!bits_get(r, 1)) return 0;
+    if (!bits_get(r, 1)) return sign_extend(bits_get(r, 7), 7);
+    if (!bits_get(r, 1)) return sign_extend(bits_get(r, 9), 9);
+    if (!bits_get(r, 1)) return sign_extend(bits_get(r, 12), 12);
+    return (int64_t)bits_get(r, 64);
+}
+
+static bool encode_point(Block *blk, int64_t ts, uint8_t status, double duration, uint32_t ref)
+{
+    BitBuf  *b   = &blk->bits;
+    uint64_t dur = dbl_bits(duration);
+
+    if (blk->sum.count == 0) {
+        if (!bits_put(b, (uint64_t)ts, 64) || !bits_put(b, dur, 64) ||
+            !bits_put(b, status, 2) || !bits_put(b, ref, 32)) return false;
+        blk->prev_delta = 0;
+    } else {
+        int64_t delta = ts - blk->prev_ts;
+        if (!put_dod(b, delta - blk->prev_delta)) return false;
+        blk->prev_delta = delta;
+
+        uint64_t x = dur ^ blk->prev_dur;
+        if (x == 0) {
+            if (!bits_put(b, 0x0, 1)) return false;
+        } else {
+            unsigned lead  = (unsigned)__builtin_clzll(x);
+            unsigned trail = (unsigned)__builtin_ctzll(x);
+            if (lead > 31) lead = 31;
+            if (blk->window && lead >= blk->prev_lead && trail >= blk->prev_trail) {
+                unsigned len = 64 - blk->prev_lead - blk->prev_trail;
+                if (!bits_put(b, 0x2, 2) || !bits_put(b, x >> blk->prev_trail, len)) return false;
+            } else {
+                unsigned len = 64 - lead - trail;
+                if (!bits_put(b, 0x3, 2) || !bits_put(b, lead, 5) ||
+                    !bits_put(b, len - 1, 6) || !bits_put(b, x >> trail, len)) return false;
+                blk->prev_lead  = lead;
+                blk->prev_trail = trail;
+                blk->window     = true;
+            }
+        }
+
+        if (status == blk->prev_status) {
+            if (!bits_put(b, 0x0, 1)) return false;
+        } else if (!bits_put(b, 0x1, 1) || !bits_put(b, status, 2)) {
+            return false;
+        }
+
+        if (ref == blk->prev_ref) {
+            if (!bits_put(b, 0x0, 1)) return false;
+        } else if (ref == blk->prev_ref + 1) {
+            if (!bits_put(b, 0x2, 2)) return false;
+        } else if (!bits_put(b, 0x3, 2) || !bits_put(b, ref, 32)) {
+            return false;
+        }
+    }
+
+    blk->prev_ts     = ts;
+    blk->prev_dur    = dur;
+    blk->prev_status = status;
+    blk->prev_ref    = ref;
+    return true;
+}
+
+/* Decoder state mirrors the encoder's. */
+typedef struct {
+    BitReader r;
+    size_t    left;
+    bool      first;
+    int64_t   ts, delta;
+    uint64_t  dur;
+    unsigned  lead, trail;
+    uint8_t   status;
+    uint32_t  ref;
+} Decoder;
+
+static void decoder_init(Decoder *d, const Block *blk)
+{
+    d->r.buf = blk->bits.buf;
+    d->r.pos = 0;
+    d->left  = blk->sum.count;
+    d->first = true;
+}
+
+static bool decode_next(Decoder *d, TSPoint *p)
+{
+    if (d->left == 0) return false;
+    d->left--;
+
+    if (d->first) {
+        d->first  = false;
+        d->ts     = (int64_t)bits_get(&d->r, 64);
+        d->dur    = bits_get(&d->r, 64);
+        d->status = (uint8_t)bits_get(&d->r, 2);
+        d->ref    = (uint32_t)bits_get(&d->r, 32);
+        d->delta  = 0;
+    } else {
+        d->delta += get_dod(&d->r);
+        d->ts    += d->delta;
+
+        if (bits_get(&d->r, 1)) {
+            if (bits_get(&d->r, 1)) {
+                d->lead  = (unsigned)bits_get(&d->r, 5);
+                unsigned len = (unsigned)bits_get(&d->r, 6) + 1;
+                d->trail = 64 - d->lead - len;
+            }
+            unsigned len = 64 - d->lead - d->trail;
+            d->dur ^= bits_get(&d->r, len) << d->trail;
+        }
+
+        if (bits_get(&d->r, 1)) d->status = (uint8_t)bits_get(&d->r, 2);
+
+        if (bits_get(&d->r, 1)) {
+            d->ref = bits_get(&d->r, 1) ? (uint32_t)bits_get(&d->r, 32) : d->ref + 1;
+        }
+    }
+
+    p->ts       = d->ts;
+    p->duration = bits_dbl(d->dur);
+    p->status   = d->status;
+    p->ref      = d->ref;
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Summaries
+ * ---------------------------------------------------------------------- */
+
+static void summary_reset(TSSummary *s, int64_t start, int64_t end)
+{
+    memset(s, 0, sizeof(*s));
+    s->start = start;
+    s->end   = end;
+}
+
+static void summary_add(TSSummary *s, uint8_t status, double duration)
+{
+    if (s->count == 0 || duration < s->duration_min) s->duration_min = duration;
+    if (s->count == 0 || duration > s->duration_max) s->duration_max = duration;
+    s->count++;
+    s->status_counts[status]++;
+    s->duration_sum += duration;
+}
+
+static void summary_merge(TSSummary *s, const TSSummary *o)
+{
+    if (o->count == 0) return;
+    if (s->count == 0 || o->duration_min < s->duration_min) s->duration_min = o->duration_min;
+    if (s->count == 0 || o->duration_max > s->duration_max) s->duration_max = o->duration_max;
+    s->count        += o->count;
+    s->duration_sum += o->duration_sum;
+    for (int i = 0; i < TS_STATUS_COUNT; i++) s->status_counts[i] += o->status_counts[i];
+}
+
+/* -------------------------------------------------------------------------
+ * Series table
+ * ---------------------------------------------------------------------- */
+
+static Series *find_series(const TSStore *st, const char *name)
+{
+    Series *s = st->buckets[bucket_index(fnv1a(name), st->capacity)];
+    while (s && strcmp(s->name, name) != 0) s = s->next;
+    return s;
+}
+
+static bool rehash(TSStore *st, size_t new_cap)
+{
+    Series **nb = calloc(new_cap, sizeof(Series *));
+    if (!nb) return false;
+
+    for (size_t i = 0; i < st->capacity; i++) {
+        Series *s = st->buckets[i];
+        while (s) {
+            Series *next = s->next;
+            size_t  idx  = bucket_index(fnv1a(s->name), new_cap);
+            s->next = nb[idx];
+            nb[idx] = s;
+            s = next;
+        }
+    }
+    free(st->buckets);
+    st->buckets  = nb;
+    st->capacity = new_cap;
+    return true;
+}
+
+static Series *get_or_create_series(TSStore *st, const char *name)
+{
+    Series *s = find_series(st, name);
+    if (s) return s;
+
+    if ((double)(st->count + 1) / (double)st->capacity > LOAD_FACTOR_MAX) {
+        if (!rehash(st, st->capacity * 2)) return NULL;
+    }
+
+    s = calloc(1, sizeof(Series));
+    if (!s) return NULL;
+    size_t n = strlen(name) + 1;
+    s->name = malloc(n);
+    if (!s->name) { free(s); return NULL; }
+    memcpy(s->name, name, n);
+
+    size_t idx = bucket_index(fnv1a(name), st->capacity);
+    s->next = st->buckets[idx];
+    st->buckets[idx] = s;
+    st->count++;
+    return s;
+}
+
+static void free_block(Block *b)
+{
+    free(b->bits.buf);
+    free(b);
+}
+
+static void free_series(Series *s)
+{
+    for (size_t i = 0; i < s->nblocks; i++) free_block(s->blocks[i]);
+    free(s->blocks);
+    free(s->name);
+    free(s);
+}
+
+static void unlink_series(TSStore *st, Series *target)
+{
+    Series **prev = &st->buckets[bucket_index(fnv1a(target->name), st->capacity)];
+    while (*prev && *prev != target) prev = &(*prev)->next;
+    if (*prev) *prev = target->next;
+    st->count--;
+    free_series(target);
+}
+
+/* Trim a finished block's buffer to its encoded size. */
+static void seal_block(Block *b)
+{
+    size_t used = (b->bits.nbits + 7) / 8;
+    if (used == 0 || used == b->bits.cap) return;
+    uint8_t *p = realloc(b->bits.buf, used);
+    if (p) {
+        b->bits.buf = p;
+        b->bits.cap = used;
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Lifecycle
+ * ---------------------------------------------------------------------- */
+
+TSStore *ts_create(int64_t block_span_ms)
+{
+    if (block_span_ms < 0) return NULL;
+
+    TSStore *st = malloc(sizeof(TSStore));
+    if (!st) return NULL;
+
+    st->buckets = calloc(INITIAL_CAPACITY, sizeof(Series *));
+    if (!st->buckets) { free(st); return NULL; }
+
+    if (pthread_mutex_init(&st->lock, NULL) != 0) {
+        free(st->buckets);
+        free(st);
+        return NULL;
+    }
+
+    st->capacity = INITIAL_CAPACITY;
+    st->count    = 0;
+    st->span     = block_span_ms ? block_span_ms : DEFAULT_BLOCK_SPAN;
+    return st;
+}
+
+void ts_destroy(TSStore *st)
+{
+    if (!st) return;
+    for (size_t i = 0; i < st->capacity; i++) {
+        Series *s = st->buckets[i];
+        while (s) {
+            Series *next = s->next;
+            free_series(s);
+            s = next;
+        }
+    }
+    free(st->buckets);
+    pthread_mutex_destroy(&st->lock);
+    free(st);
+}
+
+int64_t ts_block_span(const TSStore *st)
+{
+    return st ? st->span : 0;
+}
+
+/* -------------------------------------------------------------------------
+ * Writes
+ * ---------------------------------------------------------------------- */
+
+bool ts_append(TSStore *st, const char *series, int64_t ts,
+               uint8_t status, double duration, uint32_t ref)
+{
+    if (!st || !series || status >= TS_STATUS_COUNT) return false;
+
+    pthread_mutex_lock(&st->lock);
+    bool ok = false;
+
+    Series *s = get_or_create_series(st, series);
+    if (!s) goto out;
+
+    Block  *last  = s->nblocks ? s->blocks[s->nblocks - 1] : NULL;
+    int64_t start = floor_to(ts, st->span);
+
+    if (last && ts < last->prev_ts) goto out;   /* append-only */
+
+    if (!last || last->start != start) {
+        if (s->nblocks == s->cap) {
+            size_t  cap = s->cap ? s->cap * 2 : 8;
+            Block **nb  = realloc(s->blocks, cap * sizeof(Block *));
+            if (!nb) goto out;
+            s->blocks = nb;
+            s->cap    = cap;
+        }
+        Block *b = calloc(1, sizeof(Block));
+        if (!b) goto out;
+        b->start = start;
+        summary_reset(&b->sum, start, start + st->span);
+
+        if (last) seal_block(last);
+        s->blocks[s->nblocks++] = b;
+        last = b;
+    }
+
+    /* A failed grow can leave a partial point: restore the encoder state
+     * and clear the bits written after the mark. */
+    Block saved = *last;
+    if (!encode_point(last, ts, status, duration, ref)) {
+        size_t mark = saved.bits.nbits;
+        saved.bits  = last->bits;
+        *last       = saved;
+        for (size_t i = mark; i < last->bits.cap * 8; i++) {
+            last->bits.buf[i >> 3] &= (uint8_t)~(0x80u >> (i & 7));
+        }
+        last->bits.nbits = mark;
+        goto out;
+    }
+
+    summary_add(&last->sum, status, duration);
+    s->points++;
+    ok = true;
+
+out:
+    pthread_mutex_unlock(&st->lock);
+    return ok;
+}
+
+size_t ts_drop_before(TSStore *st, int64_t ts)
+{
+    if (!st) return 0;
+
+    pthread_mutex_lock(&st->lock);
+    size_t dropped = 0;
+
+    for (size_t i = 0; i < st->capacity; i++) {
+        Series *s = st->buckets[i];
+        while (s) {
+            Series *next = s->next;
+
+            size_t k = 0;
+            while (k < s->nblocks && s->blocks[k]->start + st->span <= ts) {
+                dropped   += s->blocks[k]->sum.count;
+                s->points -= s->blocks[k]->sum.count;
+                free_block(s->blocks[k]);
+                k++;
+            }
+            if (k) {
+                memmove(s->blocks, s->blocks + k, (s->nblocks - k) * sizeof(Block *));
+                s->nblocks -= k;
+            }
+            if (s->nblocks == 0) unlink_series(st, s);
+
+            s = next;
+        }
+    }
+
+    pthread_mutex_unlock(&st->lock);
+    return dropped;
+}
+
+/* -------------------------------------------------------------------------
+ * Queries
+ * ---------------------------------------------------------------------- */
+
+size_t ts_scan(TSStore *st, const char *series, int64_t from, int64_t to,
+               TSPoint *out, size_t max)
+{
+    if (!st || !series) return 0;
+
+    pthread_mutex_lock(&st->lock);
+    size_t  n = 0;
+    Series *s = find_series(st, series);
+
+    for (size_t i = 0; s && i < s->nblocks; i++) {
+        const Block *b = s->blocks[i];
+        if (b->start + st->span <= from) continue;
+        if (b->start >= to) break;
+
+        Decoder d;
+        TSPoint p;
+        decoder_init(&d, b);
+        while (decode_next(&d, &p)) {
+            if (p.ts < from) continue;
+            if (p.ts >= to) break;
+            if (n < max && out) out[n] = p;
+            n++;
+        }
+    }
+
+    pthread_mutex_unlock(&st->lock);
+    return n;
+}
+
+size_t ts_latest(TSStore *st, const char *series, size_t n, TSPoint *out)
+{
+    if (!st || !series || !out || n == 0) return 0;
+
+    pthread_mutex_lock(&st->lock);
+    size_t  written = 0;
+    Series *s       = find_series(st, series);
+    TSPoint *tmp    = NULL;
+    size_t   tmp_cap = 0;
+
+    for (size_t i = s ? s->nblocks : 0; i-- > 0 && written < n; ) {
+        const Block *b = s->blocks[i];
+        if (b->sum.count > tmp_cap) {
+            TSPoint *t = realloc(tmp, b->sum.count * sizeof(TSPoint));
+            if (!t) break;
+            tmp     = t;
+            tmp_cap = b->sum.count;
+        }
+
+        Decoder d;
+        size_t  m = 0;
+        decoder_init(&d, b);
+        while (decode_next(&d, &tmp[m])) m++;
+
+        while (m > 0 && written < n) out[written++] = tmp[--m];
+    }
+
+    free(tmp);
+    pthread_mutex_unlock(&st->lock);
+    return written;
+}
+
+size_t ts_summarize(TSStore *st, const char *series, int64_t from, int64_t to,
+                    int64_t bucket_ms, TSSummary *out, size_t max)
+{
+    if (!st || !series || bucket_ms < 0) return 0;
+    if (bucket_ms == 0) bucket_ms = st->span;
+
+    pthread_mutex_lock(&st->lock);
+    size_t    n       = 0;
+    bool      open    = false;
+    TSSummary cur;
+    Series   *s       = find_series(st, series);
+    bool      aligned = bucket_ms % st->span == 0;
+
+#define EMIT()                                           \
+    do {                                                 \
+        if (open && cur.count) {                         \
+            if (n < max && out) out[n] = cur;            \
+            n++;                                         \
+        }                                                \
+    } while (0)
+
+#define ENTER(bucket_start)                                          \
+    do {                                                             \
+        if (!open || cur.start != (bucket_start)) {                  \
+            EMIT();                                                  \
+            summary_reset(&cur, (bucket_start), (bucket_start) + bucket_ms); \
+            open = true;                                             \
+        }                                                            \
+    } while (0)
+
+    for (size_t i = 0; s && i < s->nblocks; i++) {
+        const Block *b   = s->blocks[i];
+        int64_t      end = b->start + st->span;
+        if (end <= from) continue;
+        if (b->start >= to) break;
+
+        if (aligned && b->start >= from && end <= to) {
+            ENTER(floor_to(b->start, bucket_ms));
+            summary_merge(&cur, &b->sum);
+            continue;
+        }
+
+        Decoder d;
+        TSPoint p;
+        decoder_init(&d, b);
+        while (decode_next(&d, &p)) {
+            if (p.ts < from) continue;
+            if (p.ts >= to) break;
+            ENTER(floor_to(p.ts, bucket_ms));
+            summary_add(&cur, p.status, p.duration);
+        }
+    }
+    EMIT();
+
+#undef ENTER
+#undef EMIT
+
+    pthread_mutex_unlock(&st->lock);
+    return n;
+}
+
+size_t ts_count(TSStore *st, const char *series)
+{
+    if (!st || !series) return 0;
+    pthread_mutex_lock(&st->lock);
+    Series *s = find_series(st, series);
+    size_t  n = s ? s->points : 0;
+    pthread_mutex_unlock(&st->lock);
+    return n;
+}
+
+char **ts_series(TSStore *st, size_t *count)
+{
+    if (!st || !count) return NULL;
+    *count = 0;
+
+    pthread_mutex_lock(&st->lock);
+    char **names = NULL;
+    if (st->count == 0) goto out;
+
+    names = malloc(st->count * sizeof(char *));
+    if (!names) goto out;
+
+    size_t pos = 0;
+    for (size_t i = 0; i < st->capacity; i++) {
+        for (Series *s = st->buckets[i]; s; s = s->next) {
+            size_t len = strlen(s->name) + 1;
+            names[pos] = malloc(len);
+            if (!names[pos]) {
+                ts_free_names(names, pos);
+                names = NULL;
+                goto out;
+            }
+            memcpy(names[pos++], s->name, len);
+        }
+    }
+    *count = pos;
+
+out:
+    pthread_mutex_unlock(&st->lock);
+    return names;
+}
+
+void ts_free_names(char **names, size_t count)
+{
+    if (!names) return;
+    for (size_t i = 0; i < count; i++) free(names[i]);
+    free(names);
+}
+
+TSStats ts_stats(TSStore *st)
+{
+    TSStats out = {0, 0, 0, 0, 0};
+    if (!st) return out;
+
+    pthread_mutex_lock(&st->lock);
+    out.series = st->count;
+    for (size_t i = 0; i < st->capacity; i++) {
+        for (Series *s = st->buckets[i]; s; s = s->next) {
+            out.blocks += s->nblocks;
+            out.points += s->points;
+            for (size_t k = 0; k < s->nblocks; k++) {
+                out.compressed_bytes += (s->blocks[k]->bits.nbits + 7) / 8;
+            }
+        }
+    }
+    out.raw_bytes = out.points * sizeof(TSPoint);
+    pthread_mutex_unlock(&st->lock);
+    return out;
+}
@@ -0,0 +1,142 @@
+/**
+ * ts_store.h — Append-only time-series store for test results
+ *
+ * Each named series (one per test, per layer, ...) is a list of
+ * time-partitioned blocks.  A block covers [start, start + block_span)
+ * and holds its points compressed in one bit stream:
+ *
+ *   timestamp  delta-of-delta, variable-width buckets (Gorilla)
+ *   duration   XOR with the previous value, leading/trailing-zero window
+ *   status     1 bit when unchanged, else 1 + 2 bits
+ *   ref        1 bit when unchanged, 2 bits for +1, else 2 + 32 bits
+ *
+ * Every block also keeps a summary (count, per-status counts, duration
+ * sum / min / max), so aggregate queries over whole blocks never decode
+ * points.  Retention drops whole blocks.
+ *
+ * Points must be appended in non-decreasing timestamp order per series.
+ * Thread-safety: every call takes the store lock.
+ */
+
+#ifndef TS_STORE_H
+#define TS_STORE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TSStore TSStore;
+
+typedef enum {
+    TS_PASSED  = 0,
+    TS_FAILED  = 1,
+    TS_SKIPPED = 2,
+    TS_ERROR   = 3
+} TSStatus;
+
+#define TS_STATUS_COUNT 4
+
+/** One decoded record. */
+typedef struct {
+    int64_t  ts;         /* milliseconds since the Unix epoch          */
+    double   duration;   /* seconds                                    */
+    uint32_t ref;        /* caller's link to a detail record (run no.) */
+    uint8_t  status;     /* TSStatus                                   */
+} TSPoint;
+
+/** Aggregate over a time bucket. */
+typedef struct {
+    int64_t start;                           /* bucket [start, end)  */
+    int64_t end;
+    size_t  count;
+    size_t  status_counts[TS_STATUS_COUNT];
+    double  duration_sum;
+    double  duration_min;
+    double  duration_max;
+} TSSummary;
+
+typedef struct {
+    size_t series;
+    size_t blocks;
+    size_t points;
+    size_t compressed_bytes;   /* encoded point streams               */
+    size_t raw_bytes;          /* the same points as TSPoint structs  */
+} TSStats;
+
+/* -------------------------------------------------------------------------
+ * Lifecycle
+ * ---------------------------------------------------------------------- */
+
+/**
+ * Create a store whose blocks span block_span_ms milliseconds (aligned to
+ * the epoch; 0 selects one day).  Returns NULL on allocation failure.
+ */
+TSStore *ts_create(int64_t block_span_ms);
+
+void ts_destroy(TSStore *store);
+
+/** Block span in milliseconds. */
+int64_t ts_block_span(const TSStore *store);
+
+/* -------------------------------------------------------------------------
+ * Writes
+ * ---------------------------------------------------------------------- */
+
+/**
+ * Append a point to series (created on first use).  Returns false on
+ * allocation failure, an invalid status, or a timestamp older than the
+ * series' latest point.
+ */
+bool ts_append(TSStore *store, const char *series, int64_t ts,
+               uint8_t status, double duration, uint32_t ref);
+
+/**
+ * Drop every block that ends at or before ts, in all series; series left
+ * empty are removed.  Returns the number of points dropped.
+ */
+size_t ts_drop_before(TSStore *store, int64_t ts);
+
+/* -------------------------------------------------------------------------
+ * Queries
+ * ---------------------------------------------------------------------- */
+
+/**
+ * Points of series with from <= ts < to, oldest first.  Writes at most max
+ * points to out; returns the number of matching points (which may exceed
+ * max, so a first call with max == 0 sizes the buffer).
+ */
+size_t ts_scan(TSStore *store, const char *series, int64_t from, int64_t to,
+               TSPoint *out, size_t max);
+
+/** The n most recent points of series, newest first.  Returns count written. */
+size_t ts_latest(TSStore *store, const char *series, size_t n, TSPoint *out);
+
+/**
+ * Aggregate series over [from, to) into epoch-aligned buckets of bucket_ms
+ * (0 = one bucket per block).  Only non-empty buckets are written, oldest
+ * first; returns the number of such buckets (may exceed max).  When
+ * bucket_ms is a multiple of the block span, blocks fully inside the range
+ * are answered from their summaries without decoding.
+ */
+size_t ts_summarize(TSStore *store, const char *series, int64_t from, int64_t to,
+                    int64_t bucket_ms, TSSummary *out, size_t max);
+
+/** Number of points in series (0 if unknown). */
+size_t ts_count(TSStore *store, const char *series);
+
+/** Names of all series; free with ts_free_names.  NULL if none. */
+char **ts_series(TSStore *store, size_t *count);
+
+void ts_free_names(char **names, size_t count);
+
+TSStats ts_stats(TSStore *store);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TS_STORE_H */
@@ -0,0 +1,584 @@
+/**
+ * walks.c — Random-walk sampling over a compact CSR copy
+ *
+ * The walk graph is a CSR (off[u] .. off[u + 1] indexes u's sorted
+ * neighbours in adj).  Weighted graphs add an alias table per node laid
+ * out parallel to adj: a step draws slot i uniformly and keeps it with
+ * probability prob[i], otherwise it takes slot alias[i] of the same list.
+ * One 64-bit draw yields both the slot (low 32 bits, by multiply-shift)
+ * and the coin (top 24 bits).
+ *
+ * Walks are independent, so threads claim them in chunks.  Proximity
+ * walks count visits into per-thread arrays that are summed at the end.
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   /* sysconf */
+#endif
+
+#include "walks.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * Internal structures
+ * ---------------------------------------------------------------------- */
+
+#define CHUNK         256u      /* nodes claimed at a time (graph build) */
+#define WALK_CHUNK    64u       /* walks claimed at a time */
+#define MAX_THREADS   64u
+
+struct RWGraph {
+    size_t    n;
+    size_t   *off;              /* n + 1 */
+    uint32_t *adj;
+    float    *prob;             /* RW_WEIGHTED: keep probability per slot */
+    uint32_t *alias;            /* RW_WEIGHTED: fallback slot in the list */
+};
+
+typedef void (*RangeFn)(void *ctx, unsigned worker, size_t begin, size_t end);
+
+typedef struct {
+    RangeFn         fn;
+    void           *ctx;
+    size_t          n, chunk;
+    _Atomic size_t  next;
+} Ranges;
+
+typedef struct {
+    Ranges  *r;
+    unsigned worker;
+} RangeWorker;
+
+static unsigned thread_count(unsigned threads, size_t chunks)
+{
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads > chunks)
+        threads = chunks ? (unsigned)chunks : 1;
+    return threads;
+}
+
+static void *range_main(void *arg)
+{
+    RangeWorker *w = arg;
+    Ranges *r = w->r;
+    for (;;) {
+        size_t begin = atomic_fetch_add(&r->next, r->chunk);
+        if (begin >= r->n)
+            break;
+        size_t end = begin + r->chunk < r->n ? begin + r->chunk : r->n;
+        r->fn(r->ctx, w->worker, begin, end);
+    }
+    return NULL;
+}
+
+/*
+ * Run fn over [0, n) in chunks on `threads` workers (the caller is worker
+ * 0).  If a thread cannot be started its share falls to the others.
+ */
+static void parallel_ranges(size_t n, size_t chunk, unsigned threads, RangeFn fn, void *ctx)
+{
+    Ranges r = { .fn = fn, .ctx = ctx, .n = n, .chunk = chunk };
+    atomic_init(&r.next, 0);
+    RangeWorker workers[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    unsigned started = 1;
+
+    for (unsigned t = 0; t < threads; t++)
+        workers[t] = (RangeWorker){ &r, t };
+    for (; started < threads; started++)
+        if (pthread_create(&tids[started], NULL, range_main, &workers[started]) != 0)
+            break;
+    range_main(&workers[0]);
+    for (unsigned t = 1; t < started; t++)
+        pthread_join(tids[t], NULL);
+}
+
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/* Independent RNG state for walk k. */
+static uint64_t walk_stream(uint64_t seed, uint64_t k)
+{
+    uint64_t s = seed ^ (k * 0xD1B54A32D192ED03ull);
+    return splitmix64(&s);
+}
+
+static inline double uniform01(uint64_t *rng)
+{
+    return (double)(splitmix64(rng) >> 11) * 0x1p-53;
+}
+
+/* -------------------------------------------------------------------------
+ * Walk graph
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const GSView *view;
+    RWGraph      *g;
+    bool          undirected;
+    double       *w;            /* edge weights while building (RW_WEIGHTED) */
+    size_t        max_degree;
+    uint32_t     *stack[MAX_THREADS];   /* alias build scratch, 2 * max_degree */
+    double       *scaled[MAX_THREADS];  /* max_degree */
+} Build;
+
+/* Out-list, or the union of out- and in-lists with weights summed; counts
+ * only if ids is NULL. */
+static size_t copy_neighbors(const Build *b, uint32_t u, uint32_t *ids, double *w)
+{
+    const uint32_t *a = NULL, *c = NULL;
+    const float *wa = NULL, *wc = NULL;
+    size_t na = gs_view_neighbors(b->view, u, &a, &wa);
+    if (!b->undirected) {
+        for (size_t i = 0; ids && i < na; i++) {
+            ids[i] = a[i];
+            if (w)
+                w[i] = wa[i];
+        }
+        return na;
+    }
+    size_t nc = gs_view_in_neighbors(b->view, u, &c, &wc);
+    size_t i = 0, j = 0, n = 0;
+    while (i < na || j < nc) {
+        uint32_t x;
+        double weight;
+        if (j == nc || (i < na && a[i] < c[j])) {
+            x = a[i];
+            weight = wa[i++];
+        } else if (i == na || c[j] < a[i]) {
+            x = c[j];
+            weight = wc[j++];
+        } else {
+            x = a[i];
+            weight = (double)wa[i++] + wc[j++];
+        }
+        if (ids) {
+            ids[n] = x;
+            if (w)
+                w[n] = weight;
+        }
+        n++;
+    }
+    return n;
+}
+
+static void degree_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    Build *b = ctx;
+    (void)worker;
+    for (size_t u = begin; u < end; u++)
+        b->g->off[u + 1] = copy_neighbors(b, (uint32_t)u, NULL, NULL);
+}
+
+/*
+ * Vose's alias method for one list.  Non-positive weights never get
+ * picked; a list without positive weights falls back to uniform.
+ */
+static void alias_build(const Build *b, unsigned worker, size_t base, size_t deg)
+{
+    RWGraph *g = b->g;
+    const double *w = b->w + base;
+    double *scaled = b->scaled[worker];
+    uint32_t *small = b->stack[worker], *large = small + deg;
+    size_t n_small = 0, n_large = 0;
+    double total = 0.0;
+
+    for (size_t i = 0; i < deg; i++)
+        total += w[i] > 0.0 ? w[i] : 0.0;
+    for (size_t i = 0; i < deg; i++) {
+        scaled[i] = total > 0.0 ? (w[i] > 0.0 ? w[i] : 0.0) * (double)deg / total : 1.0;
+        if (scaled[i] < 1.0)
+            small[n_small++] = (uint32_t)i;
+        else
+            large[n_large++] = (uint32_t)i;
+    }
+    while (n_small && n_large) {
+        uint32_t s = small[--n_small], l = large[n_large - 1];
+        g->prob[base + s] = (float)scaled[s];
+        g->alias[base + s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            n_large--;
+            small[n_small++] = l;
+        }
+    }
+    /* Leftovers are 1 up to rounding */
+    while (n_large) {
+        uint32_t l = large[--n_large];
+        g->prob[base + l] = 1.0f;
+        g->alias[base + l] = l;
+    }
+    while (n_small) {
+        uint32_t s = small[--n_small];
+        g->prob[base + s] = 1.0f;
+        g->alias[base + s] = s;
+    }
+}
+
+static void fill_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    Build *b = ctx;
+    RWGraph *g = b->g;
+    for (size_t u = begin; u < end; u++) {
+        size_t base = g->off[u];
+        copy_neighbors(b, (uint32_t)u, g->adj + base, b->w ? b->w + base : NULL);
+        if (b->w)
+            alias_build(b, worker, base, g->off[u + 1] - base);
+    }
+}
+
+void rw_free(RWGraph *g)
+{
+    if (!g)
+        return;
+    free(g->off);
+    free(g->adj);
+    free(g->prob);
+    free(g->alias);
+    free(g);
+}
+
+RWGraph *rw_prepare(const GSView *v, unsigned flags, unsigned threads)
+{
+    if (!v || ((flags & RW_UNDIRECTED) && !gs_view_tracks_in(v)))
+        return NULL;
+    RWGraph *g = calloc(1, sizeof *g);
+    Build b = { .view = v, .g = g, .undirected = flags & RW_UNDIRECTED };
+    bool ok = false;
+    if (!g)
+        return NULL;
+
+    g->n = gs_view_node_count(v);
+    g->off = calloc(g->n + 1, sizeof *g->off);
+    if (!g->off)
+        goto out;
+    threads = thread_count(threads, (g->n + CHUNK - 1) / CHUNK);
+    parallel_ranges(g->n, CHUNK, threads, degree_pass, &b);
+    for (size_t u = 0; u < g->n; u++) {
+        if (g->off[u + 1] > b.max_degree)
+            b.max_degree = g->off[u + 1];
+        g->off[u + 1] += g->off[u];
+    }
+
+    size_t m = g->off[g->n] ? g->off[g->n] : 1;
+    g->adj = malloc(m * sizeof *g->adj);
+    if (!g->adj)
+        goto out;
+    if (flags & RW_WEIGHTED) {
+        size_t d = b.max_degree ? b.max_degree : 1;
+        g->prob = malloc(m * sizeof *g->prob);
+        g->alias = malloc(m * sizeof *g->alias);
+        b.w = malloc(m * sizeof *b.w);
+        if (!g->prob || !g->alias || !b.w)
+            goto out;
+        for (unsigned t = 0; t < threads; t++) {
+            b.stack[t] = malloc(2 * d * sizeof *b.stack[t]);
+            b.scaled[t] = malloc(d * sizeof *b.scaled[t]);
+            if (!b.stack[t] || !b.scaled[t])
+                goto out;
+        }
+    }
+    parallel_ranges(g->n, CHUNK, threads, fill_pass, &b);
+    ok = true;
+
+out:
+    for (unsigned t = 0; t < MAX_THREADS; t++) {
+        free(b.stack[t]);
+        free(b.scaled[t]);
+    }
+    free(b.w);
+    if (!ok) {
+        rw_free(g);
+        return NULL;
+    }
+    return g;
+}
+
+size_t rw_node_count(const RWGraph *g)
+{
+    return g ? g->n : 0;
+}
+
+size_t rw_edge_count(const RWGraph *g)
+{
+    return g ? g->off[g->n] : 0;
+}
+
+/* -------------------------------------------------------------------------
+ * Steps
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    double inv_p, inv_q, bound; /* node2vec weights and their maximum */
+    bool   second_order;
+} Bias;
+
+static bool bias_init(const RWParams *params, Bias *bias)
+{
+    if (!(params->p > 0.0) || !(params->q > 0.0))
+        return false;
+    bias->inv_p = 1.0 / params->p;
+    bias->inv_q = 1.0 / params->q;
+    bias->bound = 1.0;
+    if (bias->inv_p > bias->bound)
+        bias->bound = bias->inv_p;
+    if (bias->inv_q > bias->bound)
+        bias->bound = bias->inv_q;
+    bias->second_order = params->p != 1.0 || params->q != 1.0;
+    return true;
+}
+
+/* First-order step from u (RW_END at a dead end). */
+static inline uint32_t step(const RWGraph *g, uint32_t u, uint64_t *rng)
+{
+    size_t base = g->off[u], deg = g->off[u + 1] - base;
+    if (deg == 0)
+        return RW_END;
+    uint64_t r = splitmix64(rng);
+    size_t i = (size_t)(((r & 0xFFFFFFFFull) * deg) >> 32);
+    if (g->prob && (float)(r >> 40) * 0x1p-24f >= g->prob[base + i])
+        i = g->alias[base + i];
+    return g->adj[base + i];
+}
+
+static bool has_edge(const RWGraph *g, uint32_t t, uint32_t x)
+{
+    size_t lo = g->off[t], hi = g->off[t + 1];
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (g->adj[mid] < x)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < g->off[t + 1] && g->adj[lo] == x;
+}
+
+/* Step from u having arrived from prev (RW_END at the start). */
+static inline uint32_t step2(const RWGraph *g, const Bias *bias, uint32_t prev, uint32_t u,
+                             uint64_t *rng)
+{
+    if (!bias->second_order || prev == RW_END)
+        return step(g, u, rng);
+    for (;;) {
+        uint32_t x = step(g, u, rng);
+        if (x == RW_END)
+            return x;
+        double f = x == prev ? bias->inv_p : has_edge(g, prev, x) ? 1.0 : bias->inv_q;
+        if (f >= bias->bound || uniform01(rng) * bias->bound < f)
+            return x;
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Walk corpora
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const RWGraph  *g;
+    const RWParams *params;
+    Bias            bias;
+    const uint32_t *starts;
+    size_t          n_starts;
+    uint32_t       *out;
+} WalkCtx;
+
+static void walk_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    WalkCtx *c = ctx;
+    size_t stride = (size_t)c->params->length + 1;
+    (void)worker;
+    for (size_t k = begin; k < end; k++) {
+        uint64_t rng = walk_stream(c->params->seed, k);
+        uint32_t *walk = c->out + k * stride;
+        uint32_t prev = RW_END, u = c->starts[k % c->n_starts];
+        size_t i = 0;
+        walk[i++] = u;
+        while (i < stride) {
+            uint32_t x = step2(c->g, &c->bias, prev, u, &rng);
+            if (x == RW_END)
+                break;
+            walk[i++] = x;
+            prev = u;
+            u = x;
+        }
+        for (; i < stride; i++)
+            walk[i] = RW_END;
+    }
+}
+
+bool rw_walks(const RWGraph *g, const uint32_t *starts, size_t n_starts,
+              uint32_t walks_per_start, const RWParams *params, uint32_t *out)
+{
+    WalkCtx c = { .g = g, .params = params, .starts = starts, .n_starts = n_starts, .out = out };
+    if (!g || !params || !bias_init(params, &c.bias))
+        return false;
+    for (size_t i = 0; i < n_starts; i++)
+        if (starts[i] >= g->n)
+            return false;
+    size_t walks = n_starts * walks_per_start;
+    if (walks == 0)
+        return true;
+    unsigned threads = thread_count(params->threads, (walks + WALK_CHUNK - 1) / WALK_CHUNK);
+    parallel_ranges(walks, WALK_CHUNK, threads, walk_pass, &c);
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Restart proximity
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const RWGraph  *g;
+    const RWParams *params;
+    Bias            bias;
+    const uint32_t *sources;
+    size_t          n_sources;
+    uint32_t       *visits[MAX_THREADS];
+    uint64_t        total[MAX_THREADS];
+} ProxCtx;
+
+static void proximity_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    ProxCtx *c = ctx;
+    uint32_t *visits = c->visits[worker];
+    uint64_t total = 0;
+    for (size_t k = begin; k < end; k++) {
+        uint64_t rng = walk_stream(c->params->seed, k);
+        uint32_t prev = RW_END;
+        uint32_t u = c->sources[(size_t)(((splitmix64(&rng) & 0xFFFFFFFFull) * c->n_sources) >> 32)];
+        visits[u]++;
+        total++;
+        for (uint32_t s = 0; s < c->params->length; s++) {
+            if (uniform01(&rng) < c->params->restart)
+                break;
+            uint32_t x = step2(c->g, &c->bias, prev, u, &rng);
+            if (x == RW_END)
+                break;
+            visits[x]++;
+            total++;
+            prev = u;
+            u = x;
+        }
+    }
+    c->total[worker] += total;
+}
+
+static void merge_pass(void *ctx, unsigned worker, size_t begin, size_t end)
+{
+    ProxCtx *c = ctx;
+    (void)worker;
+    for (unsigned t = 1; t < MAX_THREADS && c->visits[t]; t++)
+        for (size_t u = begin; u < end; u++)
+            c->visits[0][u] += c->visits[t][u];
+}
+
+/* Min-heap on (visits, -id): the root is the weakest of the best k. */
+static inline bool weaker(const uint32_t *visits, uint32_t a, uint32_t b)
+{
+    return visits[a] < visits[b] || (visits[a] == visits[b] && a > b);
+}
+
+static void sift_down(uint32_t *heap, size_t n, size_t i, const uint32_t *visits)
+{
+    for (;;) {
+        size_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < n && weaker(visits, heap[l], heap[m]))
+            m = l;
+        if (r < n && weaker(visits, heap[r], heap[m]))
+            m = r;
+        if (m == i)
+            return;
+        uint32_t tmp = heap[i];
+        heap[i] = heap[m];
+        heap[m] = tmp;
+        i = m;
+    }
+}
+
+static size_t top_k(const uint32_t *visits, size_t n, size_t k, uint32_t *heap)
+{
+    size_t size = 0;
+    if (k == 0)
+        return 0;
+    for (size_t u = 0; u < n; u++) {
+        if (visits[u] == 0)
+            continue;
+        if (size < k) {
+            heap[size++] = (uint32_t)u;
+            if (size == k)
+                for (size_t i = k / 2; i-- > 0;)
+                    sift_down(heap, size, i, visits);
+        } else if (weaker(visits, heap[0], (uint32_t)u)) {
+            heap[0] = (uint32_t)u;
+            sift_down(heap, size, 0, visits);
+        }
+    }
+    if (size < k)
+        for (size_t i = size / 2; i-- > 0;)
+            sift_down(heap, size, i, visits);
+    /* Heap sort, weakest to the back */
+    for (size_t end = size; end > 1; end--) {
+        uint32_t tmp = heap[0];
+        heap[0] = heap[end - 1];
+        heap[end - 1] = tmp;
+        sift_down(heap, end - 1, 0, visits);
+    }
+    return size;
+}
+
+int64_t rw_proximity(const RWGraph *g, const uint32_t *sources, size_t n_sources,
+                     uint64_t walks, const RWParams *params, size_t k,
+                     uint32_t *out_ids, double *out_scores)
+{
+    ProxCtx c = { .g = g, .params = params, .sources = sources, .n_sources = n_sources };
+    int64_t found = -1;
+    if (!g || !params || !bias_init(params, &c.bias) || n_sources == 0 || n_sources > UINT32_MAX)
+        return -1;
+    if (!(params->restart >= 0.0 && params->restart <= 1.0))
+        return -1;
+    if (walks > UINT32_MAX / ((uint64_t)params->length + 1))
+        return -1;
+    for (size_t i = 0; i < n_sources; i++)
+        if (sources[i] >= g->n)
+            return -1;
+
+    unsigned threads = thread_count(params->threads, (walks + WALK_CHUNK - 1) / WALK_CHUNK);
+    for (unsigned t = 0; t < threads; t++)
+        if (!(c.visits[t] = calloc(g->n, sizeof *c.visits[t])))
+            goto out;
+    parallel_ranges(walks, WALK_CHUNK, threads, proximity_pass, &c);
+    if (threads > 1)
+        parallel_ranges(g->n, 4096, thread_count(params->threads, (g->n + 4095) / 4096),
+                        merge_pass, &c);
+
+    uint64_t total = 0;
+    for (unsigned t = 0; t < threads; t++)
+        total += c.total[t];
+    for (size_t i = 0; i < n_sources; i++)
+        c.visits[0][sources[i]] = 0;
+    size_t n_found = top_k(c.visits[0], g->n, k, out_ids);
+    for (size_t i = 0; i < n_found; i++)
+        out_scores[i] = (double)c.visits[0][out_ids[i]] / (double)total;
+    found = (int64_t)n_found;
+
+out:
+    for (unsigned t = 0; t < threads; t++)
+        free(c.visits[t]);
+    return found;
+}
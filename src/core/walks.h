@@ -0,0 +1,92 @@
+/**
+ * walks.h — Random-walk sampling: walk corpora and restart proximity
+ *
+ * rw_prepare copies the topology of a graph_store view into a compact
+ * walk graph (the view may be released afterwards):
+ *   - steps follow out-edges, or edges in both directions with
+ *     RW_UNDIRECTED (parallel weights summed);
+ *   - with RW_WEIGHTED a step picks a neighbour with probability
+ *     proportional to edge weight, in O(1) through a per-node alias table
+ *     (Vose); otherwise neighbours are equally likely.
+ *
+ * Second-order (node2vec) walks take parameters p and q: returning to the
+ * previous node t is weighted 1/p, moving to a neighbour of t 1, moving
+ * farther away 1/q.  Candidates are drawn from the first-order
+ * distribution and accepted with probability weight / max weight
+ * (rejection sampling), so no per-edge-pair tables are built.  p = q = 1
+ * gives first-order walks at no extra cost.
+ *
+ * Walk k uses its own RNG stream derived from (seed, k): results depend
+ * on the seed only, never on the thread count.
+ */
+
+#ifndef WALKS_H
+#define WALKS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "graph_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RW_UNDIRECTED 0x1       /* walk edges in both directions (GS_TRACK_IN) */
+#define RW_WEIGHTED   0x2       /* step probability proportional to weight */
+
+#define RW_END        UINT32_MAX   /* corpus padding after a dead end */
+
+typedef struct RWGraph RWGraph;
+
+typedef struct {
+    uint32_t length;            /* steps per walk (proximity: the cap) */
+    double   p, q;              /* node2vec return / in-out parameters */
+    double   restart;           /* proximity: chance to end the walk per step */
+    uint64_t seed;
+    unsigned threads;           /* 0 = one per online CPU */
+} RWParams;
+
+/**
+ * Build the walk graph.  threads 0 = one per online CPU.  Returns NULL if
+ * RW_UNDIRECTED is given for a view without in-adjacency or memory runs
+ * out.
+ */
+RWGraph *rw_prepare(const GSView *v, unsigned flags, unsigned threads);
+
+void rw_free(RWGraph *g);
+
+size_t rw_node_count(const RWGraph *g);
+
+size_t rw_edge_count(const RWGraph *g);
+
+/**
+ * walks_per_start walks from every start node.  Walk k begins at
+ * starts[k % n_starts] and fills out[k * (length + 1) ...] with
+ * length + 1 nodes, padded with RW_END after a dead end.  Returns false
+ * for unknown start nodes, p or q <= 0, or lack of memory.
+ */
+bool rw_walks(const RWGraph *g, const uint32_t *starts, size_t n_starts,
+              uint32_t walks_per_start, const RWParams *params, uint32_t *out);
+
+/**
+ * Personalised proximity by random walk with restart.  `walks` walks each
+ * begin at a random source and end at every step with probability
+ * params->restart (or at a dead end, or after params->length steps);
+ * a node's score is its share of all visits, which estimates personalised
+ * PageRank with teleport probability restart.
+ *
+ * Writes the k best-scoring nodes other than the sources (best first,
+ * ties by ID) and returns their number, or -1 for invalid arguments
+ * (including walks * (length + 1) >= 2^32) or lack of memory.
+ */
+int64_t rw_proximity(const RWGraph *g, const uint32_t *sources, size_t n_sources,
+                     uint64_t walks, const RWParams *params, size_t k,
+                     uint32_t *out_ids, double *out_scores);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WALKS_H */
@@ -6,6 +6,16 @@ Services are framework-agnostic and can be used by Flask, CLI, or other interfac
 """
 
 from src.services.graph_service import GraphService
+from src.services.pattern_service import PatternService
+from src.services.centrality_service import CentralityService
+from src.services.lod_service import LODService
+from src.services.walk_service import WalkService
+from src.services.symptom_service import SymptomService
+from src.services.diagnosis_service import DiagnosisService
+from src.services.vocabulary_service import VocabularyService
+from src.services.hierarchy_service import HierarchyService
+from src.services.ontology_stats_service import OntologyStatsService
+from src.services.shape_validation_service import ShapeValidationService
 from src.services.base_service import (
     BaseService,
     ServiceError,
@@ -20,14 +30,37 @@ from src.services.models import (
     PathResult,
     TraversalResult,
     GraphStats,
+    TriangleStats,
+    CentralityResult,
+    RelatedNodes,
+    TreeResult,
+    SymptomExtraction,
+    Differential,
+    NextQuestions,
+    HierarchyNode,
+    HierarchyPage,
+    TriplePage,
+    ShapeViolation,
+    ShapeReport,
     SearchCriteria,
     SearchResult,
     ImportResult,
+    PatternMatchResult,
 )
 
 __all__ = [
     # Services
     'GraphService',
+    'PatternService',
+    'CentralityService',
+    'LODService',
+    'WalkService',
+    'SymptomService',
+    'DiagnosisService',
+    'VocabularyService',
+    'HierarchyService',
+    'OntologyStatsService',
+    'ShapeValidationService',
     'BaseService',
     # Exceptions
     'ServiceError',
@@ -41,7 +74,20 @@ __all__ = [
     'PathResult',
     'TraversalResult',
     'GraphStats',
+    'TriangleStats',
+    'CentralityResult',
+    'RelatedNodes',
+    'TreeResult',
+    'SymptomExtraction',
+    'Differential',
+    'NextQuestions',
+    'HierarchyNode',
+    'HierarchyPage',
+    'TriplePage',
+    'ShapeViolation',
+    'ShapeReport',
     'SearchCriteria',
     'SearchResult',
     'ImportResult',
+    'PatternMatchResult',
 ]
@@ -0,0 +1,187 @@
+"""
+Centrality Service
+
+Betweenness and harmonic closeness centrality, computed natively over the
+graph's topology mirror (see src/core/centrality.h).
+
+Shortest paths are unweighted. Results are cached per graph: a cached
+entry is reused while the topology version and node count are unchanged
+and the graph was not cleared or reimported (see GraphDB.generation), so
+repeated overlay requests on an unchanged graph are free.
+"""
+
+import threading
+from collections import OrderedDict
+from dataclasses import replace
+from typing import Dict, Iterable, Optional, Tuple
+from weakref import WeakKeyDictionary
+from graph_db import GraphDB
+from src.adapters.centrality import betweenness, betweenness_sample, harmonic_closeness
+from src.services.base_service import BaseService, ValidationError
+from src.services.models import CentralityResult
+
+
+class CentralityService(BaseService):
+    """
+    Service for node centrality measures
+
+    Handles:
+    - Exact (Brandes) and sampled (Riondato-Kornaropoulos) betweenness
+    - Harmonic closeness for all nodes or a subset
+    - Normalisation and mapping of native node IDs to node names
+    - Per-graph-version result caching
+    """
+
+    # betweenness() samples instead of running Brandes when
+    # nodes * edges exceeds this (about a second of native work)
+    EXACT_WORK_LIMIT = 50_000_000
+    CACHE_SIZE = 16
+
+    _caches: "WeakKeyDictionary[GraphDB, OrderedDict]" = WeakKeyDictionary()
+    _cache_lock = threading.Lock()
+
+    def __init__(self, graph_db: Optional[GraphDB] = None):
+        """
+        Initialize centrality service
+
+        Args:
+            graph_db: GraphDB instance to analyse (creates a new one if None)
+        """
+        super().__init__()
+        self.graph = graph_db or GraphDB()
+
+    # ========================================================================
+    # MEASURES
+    # ========================================================================
+
+    def betweenness(self, normalized: bool = True, approximate: Optional[bool] = None,
+                    epsilon: float = 0.01, delta: float = 0.1, seed: int = 0,
+                    max_samples: int = 0, ignore_direction: bool = False,
+                    threads: int = 0) -> CentralityResult:
+        """
+        Betweenness centrality of every node
+
+        Args:
+            normalized: Divide by (n-1)(n-2), the number of ordered pairs of
+                other nodes (as networkx does)
+            approximate: Sample shortest paths; None chooses sampling when
+                nodes * edges exceeds EXACT_WORK_LIMIT
+            epsilon: Sampling error bound, as a fraction of n(n-1)
+            delta: Probability that some value exceeds the bound
+            seed: Sampling seed (results are reproducible per seed)
+            max_samples: Cap on sampled paths (0 = none); the result's
+                epsilon then reports the weaker bound achieved
+            ignore_direction: Treat directed edges as undirected
+            threads: Worker threads (0 = one per CPU)
+
+        Returns:
+            CentralityResult
+
+        Raises:
+            ValidationError: If epsilon or delta is out of range
+        """
+        if not (epsilon > 0 and 0 < delta < 1):
+            raise ValidationError("epsilon must be positive and delta in (0, 1)")
+        self._log_operation("betweenness", approximate=approximate, epsilon=epsilon)
+
+        def compute(view, names, node_count):
+            sample = approximate
+            if sample is None:
+                sample = node_count * view.edge_count > self.EXACT_WORK_LIMIT
+            if sample:
+                raw, stats = betweenness_sample(view, epsilon=epsilon, delta=delta, seed=seed,
+                                                max_samples=max_samples,
+                                                undirected=ignore_direction, threads=threads)
+            else:
+                raw, stats = betweenness(view, undirected=ignore_direction, threads=threads)
+
+            n = node_count
+            if normalized:
+                scale = 1.0 / ((n - 1) * (n - 2)) if n > 2 else 0.0
+            elif not self.graph.directed or ignore_direction:
+                scale = 0.5         # each unordered pair was counted twice
+            else:
+                scale = 1.0
+            return CentralityResult(
+                measure='betweenness',
+                values=self._by_name(raw, names, scale),
+                normalized=normalized,
+                approximate=bool(sample),
+                samples=stats['samples'] if sample else 0,
+                epsilon=stats['epsilon'],
+            )
+
+        key = ('betweenness', normalized, approximate, epsilon, delta, seed, max_samples,
+               ignore_direction)
+        return self._cached(key, compute)
+
+    def closeness(self, nodes: Optional[Iterable[str]] = None, normalized: bool = False,
+                  ignore_direction: bool = False, threads: int = 0) -> CentralityResult:
+        """
+        Harmonic closeness: sum of 1/d(u, v) over the nodes u that reach v
+
+        Unreachable nodes contribute 0, so the measure is well defined on
+        disconnected graphs.
+
+        Args:
+            nodes: Only score these nodes (e.g. those on screen); None for all
+            normalized: Divide by n - 1
+            ignore_direction: Treat directed edges as undirected
+            threads: Worker threads (0 = one per CPU)
+
+        Returns:
+            CentralityResult with values for the requested nodes
+        """
+        wanted = None if nodes is None else sorted(set(nodes))
+        self._log_operation("closeness", nodes=len(wanted) if wanted is not None else None)
+
+        def compute(view, names, node_count):
+            targets = None
+            if wanted is not None:
+                ids = (self.graph.topology_id(node_id) for node_id in wanted)
+                targets = [idx for idx in ids if idx is not None and idx < view.node_count]
+            raw = harmonic_closeness(view, targets=targets, undirected=ignore_direction,
+                                     threads=threads)
+            scale = 1.0 / (node_count - 1) if normalized and node_count > 1 else 1.0
+            values = self._by_name(raw, names, scale)
+            if wanted is not None:
+                values = {node_id: values[node_id] for node_id in wanted if node_id in values}
+            return CentralityResult(measure='closeness', values=values, normalized=normalized)
+
+        key = ('closeness', tuple(wanted) if wanted is not None else None, normalized,
+               ignore_direction)
+        return self._cached(key, compute)
+
+    # ========================================================================
+    # HELPERS
+    # ========================================================================
+
+    def _by_name(self, raw, names, scale: float) -> Dict[str, float]:
+        """Map native values to existing node names (unlinked nodes score 0)"""
+        values = {node_id: 0.0 for node_id in self.graph.get_all_nodes()}
+        for idx, value in enumerate(raw):
+            if idx < len(names) and names[idx] in values:
+                values[names[idx]] = value * scale
+        return values
+
+    def _cached(self, key: Tuple, compute) -> CentralityResult:
+        """Return the cached result for key at the current graph version, or compute it"""
+        generation = self.graph.generation()
+        node_count = len(self.graph.get_all_nodes())
+        view, names = self.graph.topology()
+        with view:
+            full_key = key + (generation, view.version, node_count)
+            with self._cache_lock:
+                cache = self._caches.setdefault(self.graph, OrderedDict())
+                hit = cache.get(full_key)
+                if hit is not None:
+                    cache.move_to_end(full_key)
+                    return replace(hit, values=dict(hit.values), cached=True)
+            result = compute(view, names, node_count)
+
+        with self._cache_lock:
+            cache = self._caches.setdefault(self.graph, OrderedDict())
+            cache[full_key] = result
+            while len(cache) > self.CACHE_SIZE:
+                cache.popitem(last=False)
+        return result
@@ -0,0 +1,353 @@
+"""
+Diagnosis Service
+
+Differential diagnosis over the medical ontology's weighted symptom links
+(see src/core/diagnosis.h): each med:hasSymptomWeight value is read as
+the probability that the disease produces the symptom, and a noisy-OR
+model with a small leak turns present and absent symptoms into a
+posterior over every disease in one native pass. Posteriors are also
+rolled up the med:parent classification tree, so callers can report
+"probably a lower respiratory infection" when no single disease stands
+out.
+
+The model is compiled once per ontology; a diagnosis then takes
+microseconds, cheap enough to rank candidates before (or instead of)
+asking the LLM.
+
+For interactive triage, next_questions ranks the symptoms not yet asked
+by how much their answer is expected to narrow the differential
+(information gain). Posteriors are cached by evidence set, so when an
+interview adds one answer the previous posterior is updated in place of
+rescoring everything.
+"""
+
+import heapq
+import threading
+from collections import OrderedDict
+from typing import Any, Dict, Iterable, List, Optional, Tuple
+from src.adapters.diagnosis import DiagnosisModel, rollup_posterior, entropy, DX_NONE
+from src.services.base_service import BaseService, ValidationError
+from src.services.models import Differential, NextQuestions
+
+
+class DiagnosisService(BaseService):
+    """
+    Service for ranking diseases from symptom evidence
+
+    Handles:
+    - Compiling disease-symptom weights into a native noisy-OR model
+    - Resolving symptoms by ID or label
+    - Ranked differentials with hierarchy roll-ups
+    - Next-question suggestions by expected information gain
+    """
+
+    # Probability of a symptom with no modelled cause
+    LEAK = 0.01
+    # Weight of a med:hasSymptom link without a med:hasSymptomWeight
+    DEFAULT_WEIGHT = 0.5
+    MAX_TOP_K = 100
+    # Posteriors kept for incremental interview updates
+    CACHE_SIZE = 1024
+
+    def __init__(self, diseases: Dict[str, Dict[str, Any]],
+                 symptoms: Optional[Dict[str, Dict[str, Any]]] = None,
+                 hierarchy: Optional[Dict[str, Dict[str, Any]]] = None,
+                 leak: float = LEAK):
+        """
+        Initialize diagnosis service
+
+        Args:
+            diseases: Disease ID -> {'label', 'parent', 'severity', 'prior',
+                'symptoms': {symptom ID: weight}}; all but 'symptoms' are
+                optional and a weight of None means DEFAULT_WEIGHT
+            symptoms: Symptom ID -> {'label'} (symptoms only named by
+                diseases are labelled with their ID)
+            hierarchy: Group ID -> {'label', 'parent'} for the classification
+                tree above the diseases
+            leak: Probability of a symptom with no modelled cause
+
+        Raises:
+            ValidationError: For weights outside [0, 1], non-positive
+                priors, a leak outside (0, 1) or a cycle in the hierarchy
+        """
+        super().__init__()
+        self._cache: "OrderedDict[Tuple[frozenset, frozenset], Any]" = OrderedDict()
+        self._cache_lock = threading.Lock()
+        self._diseases = list(diseases)
+        self._disease_info = [diseases[d] for d in self._diseases]
+        symptom_labels = {sid: (info or {}).get('label') or sid
+                          for sid, info in (symptoms or {}).items()}
+        for info in self._disease_info:
+            for sid in info.get('symptoms') or {}:
+                symptom_labels.setdefault(sid, sid)
+        self._symptoms = list(symptom_labels)
+        self._symptom_labels = [symptom_labels[sid] for sid in self._symptoms]
+        self._symptom_index = {sid: i for i, sid in enumerate(self._symptoms)}
+        self._by_label = {}
+        for i, label in enumerate(self._symptom_labels):
+            self._by_label.setdefault(str(label).strip().lower(), i)
+
+        links = []
+        self._links: List[Dict[int, float]] = []
+        for d, info in enumerate(self._disease_info):
+            weights = {}
+            for sid, weight in (info.get('symptoms') or {}).items():
+                weight = self.DEFAULT_WEIGHT if weight is None else float(weight)
+                weights[self._symptom_index[sid]] = weight
+                links.append((d, self._symptom_index[sid], weight))
+            self._links.append(weights)
+        priors = None
+        if any(info.get('prior') is not None for info in self._disease_info):
+            priors = [float(info.get('prior') or 1.0) for info in self._disease_info]
+        try:
+            self._model = DiagnosisModel(len(self._diseases), len(self._symptoms), links,
+                                         priors=priors, leak=leak)
+        except ValueError as e:
+            raise ValidationError(str(e)) from None
+
+        self._hierarchy = hierarchy or {}
+        self._groups = list(self._hierarchy)
+        group_index = {gid: g for g, gid in enumerate(self._groups)}
+        self._group_parent = [group_index.get((self._hierarchy[gid] or {}).get('parent'), DX_NONE)
+                              for gid in self._groups]
+        self._group_of = [group_index.get(info.get('parent'), DX_NONE)
+                          for info in self._disease_info]
+        try:
+            rollup_posterior([0.0] * len(self._diseases), self._group_of, self._group_parent)
+        except ValueError as e:
+            raise ValidationError(str(e)) from None
+        self._log_debug(f"DiagnosisService compiled {len(self._diseases)} diseases, "
+                        f"{len(self._symptoms)} symptoms, {self._model.link_count} links")
+
+    @classmethod
+    def from_ontology(cls, ttl_path: str, leak: float = LEAK) -> "DiagnosisService":
+        """
+        Build from a Turtle ontology: med:Disease individuals (med:id,
+        rdfs:label, med:parent, med:severity, med:hasSymptom), the
+        med:hasSymptomWeight blank nodes on med:Symptom individuals
+        (med:weightDisease, med:weightValue) and med:HierarchyNode
+        individuals (med:id, rdfs:label, med:parent)
+        """
+        from rdflib import Graph as RDFGraph, Namespace, RDF, RDFS
+
+        g = RDFGraph()
+        g.parse(ttl_path, format='turtle')
+        MED = Namespace('http://wally.io/medical#')
+
+        def value(subject, predicate):
+            found = next(g.objects(subject, predicate), None)
+            return str(found) if found is not None else None
+
+        symptoms = {}
+        for s in g.subjects(RDF.type, MED.Symptom):
+            symptom_id = value(s, MED.id)
+            if symptom_id:
+                symptoms[symptom_id] = {'label': value(s, RDFS.label) or symptom_id}
+
+        diseases = {}
+        for s in g.subjects(RDF.type, MED.Disease):
+            disease_id = value(s, MED.id)
+            if not disease_id:
+                continue
+            diseases[disease_id] = {
+                'label': value(s, RDFS.label) or disease_id,
+                'parent': value(s, MED.parent),
+                'severity': value(s, MED.severity),
+                'symptoms': {value(sym, MED.id): None for sym in g.objects(s, MED.hasSymptom)
+                             if value(sym, MED.id)},
+            }
+        for s in g.subjects(RDF.type, MED.Symptom):
+            symptom_id = value(s, MED.id)
+            for link in g.objects(s, MED.hasSymptomWeight):
+                disease_id = value(link, MED.weightDisease)
+                weight = value(link, MED.weightValue)
+                if symptom_id and disease_id in diseases and weight is not None:
+                    diseases[disease_id]['symptoms'][symptom_id] = float(weight)
+
+        hierarchy = {}
+        for s in g.subjects(RDF.type, MED.HierarchyNode):
+            group_id = value(s, MED.id)
+            if group_id:
+                hierarchy[group_id] = {'label': value(s, RDFS.label) or group_id,
+                                       'parent': value(s, MED.parent)}
+        return cls(diseases, symptoms, hierarchy, leak=leak)
+
+    # ========================================================================
+    # DIAGNOSIS
+    # ========================================================================
+
+    def diagnose(self, present: Iterable[str], absent: Iterable[str] = (),
+                 top_k: int = 5) -> Differential:
+        """
+        Diseases ranked by posterior probability
+
+        Assumes one of the modelled diseases is present; symptoms not
+        mentioned either way don't count.
+
+        Args:
+            present: Symptoms observed (IDs or case-insensitive labels)
+            absent: Symptoms known not to be there; a symptom in both
+                lists counts as present
+            top_k: Diseases to rank
+
+        Returns:
+            Differential: ranked {'id', 'label', 'probability', 'severity',
+            'matched' (present symptoms it explains), 'symptoms' (labels of
+            all its symptoms)} entries, groups with their summed
+            probability, and the symptoms not in the model
+
+        Raises:
+            ValidationError: If no evidence is given or top_k is out of range
+        """
+        present_ids, absent_ids, unknown = self._evidence(present, absent, top_k)
+        self._log_operation("diagnose", present=len(present_ids), absent=len(absent_ids))
+
+        ranked, posterior = self._model.diagnose(present_ids, absent_ids, top_k=top_k)
+        self._remember((frozenset(present_ids), frozenset(absent_ids)), posterior)
+        result = Differential(
+            present=[self._symptoms[s] for s in present_ids],
+            absent=[self._symptoms[s] for s in absent_ids],
+            unknown=unknown,
+        )
+        for d, probability in ranked:
+            info = self._disease_info[d]
+            links = self._links[d]
+            result.ranked.append({
+                'id': self._diseases[d],
+                'label': info.get('label') or self._diseases[d],
+                'probability': probability,
+                'severity': info.get('severity'),
+                'matched': [self._symptoms[s] for s in present_ids if s in links],
+                'symptoms': [self._symptom_labels[s] for s in links],
+            })
+        if self._groups:
+            totals = rollup_posterior(posterior, self._group_of, self._group_parent)
+            groups = sorted(range(len(self._groups)), key=lambda g: (-totals[g], g))
+            result.groups = [{
+                'id': self._groups[g],
+                'label': (self._hierarchy[self._groups[g]] or {}).get('label') or self._groups[g],
+                'probability': totals[g],
+            } for g in groups if totals[g] > 0]
+        return result
+
+    def next_questions(self, present: Iterable[str] = (), absent: Iterable[str] = (),
+                       top_k: int = 5, candidates: int = 3) -> NextQuestions:
+        """
+        Symptoms worth asking about next
+
+        Each symptom not yet answered is scored by the expected drop in
+        the differential's entropy once its answer is known (in bits):
+        high when the likely diseases disagree about it and the answer is
+        uncertain.
+
+        Args:
+            present: Symptoms confirmed so far (IDs or labels)
+            absent: Symptoms ruled out so far
+            top_k: Questions to rank
+            candidates: Most likely diseases to report alongside
+
+        Returns:
+            NextQuestions: ranked {'id', 'label', 'gain', 'p_present'}
+            entries, the entropy left and the leading candidates
+
+        Raises:
+            ValidationError: If top_k or candidates is out of range
+        """
+        present_ids, absent_ids, unknown = self._evidence(present, absent, top_k,
+                                                          allow_empty=True)
+        if not 0 <= candidates <= self.MAX_TOP_K:
+            raise ValidationError(f"candidates must be in 0..{self.MAX_TOP_K}")
+        self._log_operation("next_questions", present=len(present_ids), absent=len(absent_ids))
+
+        posterior = self._posterior(present_ids, absent_ids)
+        ranked, p_present = self._model.questions(posterior, skip=present_ids + absent_ids,
+                                                  top_k=top_k)
+        result = NextQuestions(
+            present=[self._symptoms[s] for s in present_ids],
+            absent=[self._symptoms[s] for s in absent_ids],
+            unknown=unknown,
+            entropy=entropy(posterior),
+        )
+        result.questions = [{
+            'id': self._symptoms[s],
+            'label': self._symptom_labels[s],
+            'gain': gain,
+            'p_present': p_present[s],
+        } for s, gain in ranked]
+        best = heapq.nlargest(candidates, range(len(posterior)), key=lambda d: (posterior[d], -d))
+        result.candidates = [{
+            'id': self._diseases[d],
+            'label': self._disease_info[d].get('label') or self._diseases[d],
+            'probability': posterior[d],
+        } for d in best]
+        return result
+
+    # ========================================================================
+    # HELPERS
+    # ========================================================================
+
+    def _evidence(self, present: Iterable[str], absent: Iterable[str], top_k: int,
+                  allow_empty: bool = False) -> Tuple[List[int], List[int], List[str]]:
+        """Resolved present and absent symptom indices, and unknown names"""
+        if isinstance(present, str) or isinstance(absent, str):
+            raise ValidationError("present and absent must be lists of symptoms")
+        if not 1 <= top_k <= self.MAX_TOP_K:
+            raise ValidationError(f"top_k must be in 1..{self.MAX_TOP_K}")
+        unknown = []
+        present_ids = self._resolve(present, unknown)
+        absent_ids = [s for s in self._resolve(absent, unknown) if s not in present_ids]
+        if not allow_empty and not present_ids and not absent_ids and not unknown:
+            raise ValidationError("At least one symptom is required")
+        return present_ids, absent_ids, unknown
+
+    def _posterior(self, present_ids: List[int], absent_ids: List[int]):
+        """
+        Posterior for the evidence, updated from a cached posterior of the
+        same evidence minus one answer when there is one
+        """
+        key = (frozenset(present_ids), frozenset(absent_ids))
+        with self._cache_lock:
+            hit = self._cache.get(key)
+            if hit is not None:
+                self._cache.move_to_end(key)
+                return hit
+            previous = None
+            for s in present_ids:
+                previous = self._cache.get((key[0] - {s}, key[1]))
+                if previous is not None:
+                    answer = (s, True)
+                    break
+            else:
+                for s in absent_ids:
+                    previous = self._cache.get((key[0], key[1] - {s}))
+                    if previous is not None:
+                        answer = (s, False)
+                        break
+
+        if previous is not None:
+            posterior = self._model.observe(previous, *answer)
+        else:
+            _, posterior = self._model.diagnose(present_ids, absent_ids, top_k=0)
+        self._remember(key, posterior)
+        return posterior
+
+    def _remember(self, key: Tuple[frozenset, frozenset], posterior) -> None:
+        with self._cache_lock:
+            self._cache[key] = posterior
+            self._cache.move_to_end(key)
+            while len(self._cache) > self.CACHE_SIZE:
+                self._cache.popitem(last=False)
+
+    def _resolve(self, names: Iterable[str], unknown: List[str]) -> List[int]:
+        """Symptom indices for IDs or labels, in order and each once"""
+        found = []
+        for name in names:
+            s = self._symptom_index.get(name)
+            if s is None:
+                s = self._by_label.get(str(name).strip().lower())
+            if s is None:
+                if name not in unknown:
+                    unknown.append(name)
+            elif s not in found:
+                found.append(s)
+        return found
@@ -7,6 +7,8 @@ Provides a clean interface between API routes and GraphDB.
 
 from typing import List, Optional, Dict, Any
 from graph_db import GraphDB
+from src.adapters.triangles import count_triangles, estimate_triangles
+from src.adapters.spanning import minimum_spanning_tree, steiner_tree
 from src.services.base_service import (
     BaseService,
     NodeNotFoundError,
@@ -20,6 +22,8 @@ from src.services.models import (
     PathResult,
     TraversalResult,
     GraphStats,
+    TriangleStats,
+    TreeResult,
     SearchCriteria,
     SearchResult,
 )
@@ -36,6 +40,9 @@ class GraphService(BaseService):
     - Data validation
     """
     
+    # get_triangle_stats samples instead of counting above this many edges
+    APPROXIMATE_TRIANGLES_ABOVE = 20_000_000
+    
     def __init__(self, graph_db: Optional[GraphDB] = None):
         """
         Initialize graph service
@@ -405,14 +412,101 @@ class GraphService(BaseService):
         
         return results
     
+    def explain_connection(self, node_ids: List[str], weighted: Optional[bool] = None) -> TreeResult:
+        """
+        Smallest subgraph connecting a set of nodes (approximate Steiner tree)
+        
+        Replaces enumerating paths between every pair: the tree joins all
+        the nodes at once, sharing intermediate nodes, and weighs at most
+        twice the optimum. Edge directions are ignored while searching;
+        returned edges keep the direction they have in the graph.
+        
+        Args:
+            node_ids: Nodes to connect (e.g. symptoms and a candidate disease)
+            weighted: Minimise total edge weight; False minimises hops.
+                None follows the graph's weighted flag
+            
+        Returns:
+            TreeResult; components > 1 if some nodes cannot be reached
+            from the others
+            
+        Raises:
+            ValidationError: If no nodes are given or weights are negative
+            NodeNotFoundError: If a node doesn't exist
+        """
+        terminals = list(dict.fromkeys(node_ids or []))
+        if not terminals:
+            raise ValidationError("At least one node is required")
+        for node_id in terminals:
+            self._validate_node_id(node_id)
+            if not self.graph.node_exists(node_id):
+                raise NodeNotFoundError(f"Node '{node_id}' not found")
+        if weighted is None:
+            weighted = self.graph.weighted
+        
+        self._log_operation("explain_connection", nodes=len(terminals), weighted=weighted)
+        
+        ids = [self.graph.topology_id(node_id) for node_id in terminals]
+        linked = [idx for idx in ids if idx is not None]
+        view, names = self.graph.topology()
+        with view:
+            try:
+                raw, stats = steiner_tree(view, linked, unweighted=not weighted)
+            except ValueError as e:
+                raise ValidationError(str(e))
+        
+        # Never-linked nodes are trees of their own
+        components = stats['components'] + len(ids) - len(linked)
+        return self._tree_result(terminals, raw, stats['weight'], components, names)
+    
+    def minimum_spanning_tree(self, weighted: Optional[bool] = None) -> TreeResult:
+        """
+        Minimum spanning forest of the graph, computed natively
+        
+        Args:
+            weighted: Minimise total edge weight; False gives any spanning
+                forest. None follows the graph's weighted flag
+            
+        Returns:
+            TreeResult with no terminals; components is the number of
+            trees over nodes that have edges
+        """
+        if weighted is None:
+            weighted = self.graph.weighted
+        self._log_operation("minimum_spanning_tree", weighted=weighted)
+        
+        view, names = self.graph.topology()
+        with view:
+            raw, stats = minimum_spanning_tree(view, unweighted=not weighted)
+        return self._tree_result([], raw, stats['weight'], stats['components'], names)
+    
+    def _tree_result(self, terminals: List[str], raw, cost: float, components: int,
+                     names: List[str]) -> TreeResult:
+        """Map native (a, b, weight) edges to node IDs, in stored direction"""
+        edges = []
+        nodes = dict.fromkeys(terminals)
+        for a, b, weight in raw:
+            from_node, to_node = names[a], names[b]
+            if self.graph.directed and not self.graph.edge_exists(from_node, to_node):
+                from_node, to_node = to_node, from_node
+            edges.append(EdgeResult(from_node=from_node, to_node=to_node, weight=weight))
+            nodes.setdefault(from_node)
+            nodes.setdefault(to_node)
+        return TreeResult(terminals=terminals, nodes=list(nodes), edges=edges,
+                          cost=cost, components=components)
+    
     # ========================================================================
     # QUERIES & STATISTICS
     # ========================================================================
     
-    def get_stats(self) -> GraphStats:
+    def get_stats(self, include_triangles: bool = False) -> GraphStats:
         """
         Get graph statistics
         
+        Args:
+            include_triangles: Also compute triangle count, transitivity and
+                average clustering (see get_triangle_stats)
+        
         Returns:
             GraphStats object with graph metrics
         """
@@ -429,13 +523,79 @@ class GraphService(BaseService):
         else:
             avg_degree = 0.0
         
-        return GraphStats(
+        stats = GraphStats(
             node_count=node_count,
             edge_count=edge_count,
             avg_degree=avg_degree,
             is_directed=self.graph.directed,
             is_weighted=self.graph.weighted
         )
+        if include_triangles:
+            triangles = self.get_triangle_stats()
+            stats.triangles = triangles.triangles
+            stats.transitivity = triangles.transitivity
+            stats.avg_clustering = triangles.avg_clustering
+        return stats
+    
+    def get_triangle_stats(self, per_node: bool = False, approximate: Optional[bool] = None,
+                           samples: int = 200000, seed: int = 0) -> TriangleStats:
+        """
+        Triangle counts and clustering coefficients, computed natively
+        
+        Edge directions are ignored and reciprocal edges count once. The
+        average clustering coefficient is taken over all nodes, counting
+        nodes with fewer than two neighbours as 0.
+        
+        Args:
+            per_node: Include each node's triangle count and local clustering
+                coefficient (exact mode only)
+            approximate: Estimate by wedge sampling; None chooses sampling
+                for graphs above APPROXIMATE_TRIANGLES_ABOVE edges
+            samples: Wedges sampled in approximate mode
+            seed: Sampling seed (results are reproducible per seed)
+        
+        Returns:
+            TriangleStats
+        
+        Raises:
+            ValidationError: If per_node is combined with approximate mode
+        """
+        self._log_operation("triangle_stats", per_node=per_node, approximate=approximate)
+        
+        all_nodes = self.graph.get_all_nodes()
+        node_count = len(all_nodes)
+        view, _names = self.graph.topology()
+        with view:
+            if approximate is None:
+                approximate = view.edge_count > self.APPROXIMATE_TRIANGLES_ABOVE
+            if approximate and per_node:
+                raise ValidationError("Per-node triangle counts are only available in exact mode")
+            
+            if approximate:
+                raw = estimate_triangles(view, samples=samples, seed=seed)
+                # Estimate covers nodes with two or more neighbours only
+                avg = raw['avg_clustering'] * raw['clustered_nodes'] / node_count if node_count else 0.0
+                return TriangleStats(
+                    triangles=raw['triangles'], wedges=raw['wedges'],
+                    transitivity=raw['transitivity'], avg_clustering=avg,
+                    approximate=True, samples=raw['samples'],
+                )
+            
+            raw, triangles, clustering = count_triangles(view, per_node=True)
+        
+        nodes = {}
+        for node_id in all_nodes:
+            idx = self.graph.topology_id(node_id)
+            if idx is not None and idx < len(triangles):
+                nodes[node_id] = {'triangles': triangles[idx], 'clustering': clustering[idx]}
+            else:
+                nodes[node_id] = {'triangles': 0, 'clustering': 0.0}
+        avg = sum(n['clustering'] for n in nodes.values()) / len(nodes) if nodes else 0.0
+        return TriangleStats(
+            triangles=raw['triangles'], wedges=raw['wedges'],
+            transitivity=raw['transitivity'], avg_clustering=avg,
+            per_node=nodes if per_node else None,
+        )
     
     def get_neighbors(self, node_id: str) -> List[str]:
         """
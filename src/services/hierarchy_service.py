@@ -0,0 +1,203 @@
+"""
+Hierarchy Service
+
+Lazy, depth-limited views of the class hierarchy for trees that expand
+on demand. A request returns a root and at most `depth` levels below it;
+every class carries its direct subclass and instance counts, and the
+children of wide classes come one page at a time behind a cursor.
+
+Counts and child lists come from the graph's native rdfs:subClassOf and
+rdf:type layers (see GraphDB.topology_view): a class's subclasses are
+its in-neighbors in the first, its instances in the second, and the
+store keeps each list's length, so a response costs O(visible classes)
+instead of rescanning every edge for every class. Node data is read in
+one batch per page.
+
+Children are ordered by topology ID (roughly creation order). A cursor is
+the ID to resume from, so paging stays consistent while classes are
+added. Levels are filled breadth-first within a node budget; a class
+left collapsed keeps children == [] and a cursor to load them with.
+"""
+
+from contextlib import contextmanager
+from typing import List, Optional, Tuple
+from graph_db import GraphDB
+from src.services.base_service import BaseService, NodeNotFoundError, ValidationError
+from src.services.models import HierarchyNode, HierarchyPage
+
+
+class HierarchyService(BaseService):
+    """
+    Service for on-demand class hierarchy trees
+
+    Handles:
+    - Depth-limited trees from any root class
+    - Direct subclass and instance counts per class
+    - Cursor paging through the subclasses of wide classes
+    """
+
+    CLASS_TYPE = "owl:Class"
+    SUBCLASS_RELATION = "rdfs:subClassOf"
+    TYPE_RELATION = "rdf:type"
+
+    DEFAULT_DEPTH = 2
+    MAX_DEPTH = 10
+    DEFAULT_LIMIT = 50
+    MAX_LIMIT = 500
+    # Classes per response; deeper levels stay collapsed past it
+    MAX_NODES = 2000
+
+    def __init__(self, graph_db: Optional[GraphDB] = None):
+        """
+        Initialize hierarchy service
+
+        Args:
+            graph_db: Directed graph holding the ontology (subclass edges
+                point from child to parent, type edges from instance to class)
+        """
+        super().__init__()
+        self.graph = graph_db or GraphDB()
+
+    # ========================================================================
+    # QUERIES
+    # ========================================================================
+
+    def tree(self, root_id: str = "owl:Thing", depth: int = DEFAULT_DEPTH,
+             limit: int = DEFAULT_LIMIT) -> HierarchyNode:
+        """
+        A class and up to depth levels of subclasses
+
+        Args:
+            root_id: Root class
+            depth: Levels to expand below the root (0 = the root alone)
+            limit: Children loaded per class (the rest behind next_cursor)
+
+        Returns:
+            HierarchyNode tree
+
+        Raises:
+            NodeNotFoundError: If the root does not exist
+            ValidationError: If it is not a class, or for bad depth or limit
+        """
+        self._check(depth, limit)
+        with self.graph.snapshot(), self._views() as (subclasses, types):
+            label = self._class_label(root_id)
+            tid = self.graph.topology_id(root_id)
+            root = self._node(subclasses, types, tid, root_id, label, None, 0)
+            self._expand([(root, tid)], subclasses, types, depth, limit)
+        self._log_operation("hierarchy_tree", root=root_id, depth=depth)
+        return root
+
+    def children(self, class_id: str, cursor: Optional[str] = None,
+                 limit: int = DEFAULT_LIMIT, depth: int = 0) -> HierarchyPage:
+        """
+        One page of a class's direct subclasses
+
+        Args:
+            class_id: Parent class
+            cursor: next_cursor of a previous response (None = first page)
+            limit: Subclasses per page
+            depth: Levels to expand below each subclass
+
+        Raises:
+            NodeNotFoundError: If the class does not exist
+            ValidationError: If it is not a class, or for a bad cursor,
+                depth or limit
+        """
+        self._check(depth, limit)
+        try:
+            start = int(cursor) if cursor else 0
+        except ValueError:
+            start = -1
+        if start < 0:
+            raise ValidationError(f"Invalid cursor '{cursor}'")
+
+        with self.graph.snapshot(), self._views() as (subclasses, types):
+            label = self._class_label(class_id)
+            tid = self.graph.topology_id(class_id)
+            parent = self._node(subclasses, types, tid, class_id, label, None, 0)
+            page, parent.next_cursor = self._page(subclasses, types, parent, tid, start, limit)
+            parent.children = [child for child, _ in page]
+            self._expand(page, subclasses, types, depth, limit)
+        return HierarchyPage(parent_id=class_id, total=parent.child_count,
+                             children=parent.children, next_cursor=parent.next_cursor)
+
+    # ========================================================================
+    # HELPERS
+    # ========================================================================
+
+    def _check(self, depth: int, limit: int):
+        if not 0 <= depth <= self.MAX_DEPTH:
+            raise ValidationError(f"depth must be between 0 and {self.MAX_DEPTH}")
+        if not 1 <= limit <= self.MAX_LIMIT:
+            raise ValidationError(f"limit must be between 1 and {self.MAX_LIMIT}")
+
+    @contextmanager
+    def _views(self):
+        """Subclass and type layers (None for a label without edges yet)"""
+        views = []
+        try:
+            for label in (self.SUBCLASS_RELATION, self.TYPE_RELATION):
+                try:
+                    views.append(self.graph.topology_view(label))
+                except KeyError:
+                    views.append(None)
+            yield views
+        finally:
+            for view in views:
+                if view is not None:
+                    view.release()
+
+    def _class_label(self, class_id: str) -> str:
+        data = self.graph.get_nodes([class_id])[0]
+        if data is None:
+            raise NodeNotFoundError(f"Class '{class_id}' not found")
+        if data.get('node_type') != self.CLASS_TYPE:
+            raise ValidationError(f"Node '{class_id}' is not a class")
+        return data.get('label', class_id)
+
+    @staticmethod
+    def _node(subclasses, types, tid: Optional[int], class_id: str, label: str,
+              parent_id: Optional[str], depth: int) -> HierarchyNode:
+        """A collapsed node with its counts"""
+        child_count = subclasses.in_degree(tid) if subclasses is not None and tid is not None else 0
+        return HierarchyNode(
+            class_id=class_id, label=label, parent_id=parent_id, depth=depth,
+            child_count=child_count,
+            instance_count=types.in_degree(tid) if types is not None and tid is not None else 0,
+            next_cursor="0" if child_count else None,
+        )
+
+    def _page(self, subclasses, types, parent: HierarchyNode, tid: Optional[int],
+              start: int, limit: int) -> Tuple[List[Tuple[HierarchyNode, int]], Optional[str]]:
+        """(subclass, topology ID) pairs from topology ID start, and the cursor after them"""
+        if subclasses is None or tid is None:
+            return [], None
+        ids = subclasses.in_neighbors_from(tid, start, limit + 1)
+        more = len(ids) > limit
+        ids = ids[:limit]
+        names = self.graph.topology_names(ids)
+        children = []
+        for child_tid, name, data in zip(ids, names, self.graph.get_nodes(names)):
+            if data is None:
+                continue
+            children.append((self._node(subclasses, types, child_tid, name,
+                                        data.get('label', name), parent.class_id,
+                                        parent.depth + 1), child_tid))
+        return children, str(ids[-1] + 1) if more else None
+
+    def _expand(self, frontier: List[Tuple[HierarchyNode, Optional[int]]],
+                subclasses, types, depth: int, limit: int):
+        """Load depth levels of children below the frontier, breadth-first"""
+        budget = self.MAX_NODES - len(frontier)
+        for _ in range(depth):
+            below = []
+            for node, tid in frontier:
+                if node.child_count == 0 or budget <= 0:
+                    continue
+                page, node.next_cursor = self._page(
+                    subclasses, types, node, tid, 0, min(limit, budget))
+                node.children = [child for child, _ in page]
+                budget -= len(page)
+                below += page
+            frontier = below
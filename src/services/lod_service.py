@@ -0,0 +1,250 @@
+"""
+Level-of-Detail Service
+
+Fish-eye viewports over a multilevel coarsening of the graph (see
+src/core/coarsen.h): full detail near the focus node, aggregated
+super-nodes with counts and representative labels farther out, and a
+payload bounded by an item budget whatever the graph size.
+
+The hierarchy is built once per graph version and shared by all
+viewport requests until the graph changes. Viewport edges are undirected;
+their weight sums the weights of the graph edges between the items they
+join (each undirected graph edge counted once).
+"""
+
+import heapq
+import threading
+from array import array
+from dataclasses import dataclass
+from typing import Any, Dict, List, Optional, Tuple
+from weakref import WeakKeyDictionary
+from graph_db import GraphDB
+from src.adapters.coarsen import Hierarchy, CH_NONE
+from src.services.base_service import BaseService, NodeNotFoundError, ValidationError
+
+
+@dataclass
+class _LODState:
+    """A hierarchy together with the topology it was built from"""
+    generation: int
+    version: int
+    hierarchy: Hierarchy
+    names: List[str]
+    parents: list
+    sizes: list
+    reps: list
+
+
+class LODService(BaseService):
+    """
+    Service for level-of-detail graph viewports
+
+    Handles:
+    - Building and caching the coarsening hierarchy per graph version
+    - Choosing a cut through the hierarchy around a focus node
+    - Formatting detailed nodes, super-nodes and aggregated edges
+    """
+
+    DEFAULT_BUDGET = 150
+    # Coarsening stops at this many super-nodes (the most distant context)
+    TOP_LEVEL_NODES = 8
+
+    _states: "WeakKeyDictionary[GraphDB, _LODState]" = WeakKeyDictionary()
+    _lock = threading.Lock()
+
+    def __init__(self, graph_db: Optional[GraphDB] = None):
+        """
+        Initialize level-of-detail service
+
+        Args:
+            graph_db: GraphDB instance to view (creates a new one if None)
+        """
+        super().__init__()
+        self.graph = graph_db or GraphDB()
+
+    # ========================================================================
+    # HIERARCHY
+    # ========================================================================
+
+    def _state(self) -> _LODState:
+        """
+        Hierarchy for the current topology, built on first use
+
+        Only edges shape the hierarchy (node data is read per request), so
+        the topology version and the graph generation (which moves when the
+        graph is cleared or reimported) decide whether it is still current.
+        """
+        generation = self.graph.generation()
+        view, names = self.graph.topology()
+        with view:
+            with self._lock:
+                state = self._states.get(self.graph)
+                if (state is not None and state.generation == generation
+                        and state.version == view.version):
+                    return state
+                self._log_operation("lod_build", nodes=view.node_count, edges=view.edge_count)
+                h = Hierarchy(view, min_nodes=self.TOP_LEVEL_NODES)
+                state = _LODState(
+                    generation=generation, version=view.version, hierarchy=h, names=names,
+                    parents=[h.parents(level) for level in range(h.levels)],
+                    sizes=[h.sizes(level) for level in range(h.levels)],
+                    reps=[h.reps(level) for level in range(h.levels)],
+                )
+                self._states[self.graph] = state
+                return state
+
+    def get_hierarchy_stats(self) -> Dict[str, Any]:
+        """Node counts per hierarchy level (level 0 = the graph itself)"""
+        state = self._state()
+        return {
+            'levels': state.hierarchy.levels,
+            'level_sizes': [state.hierarchy.level_size(level)
+                            for level in range(state.hierarchy.levels)],
+        }
+
+    # ========================================================================
+    # VIEWPORTS
+    # ========================================================================
+
+    def get_viewport(self, center_id: str, budget: int = DEFAULT_BUDGET) -> Dict[str, Any]:
+        """
+        Fish-eye viewport around a node
+
+        Starting from the coarsest level, the super-node nearest the focus
+        (by hops to its nearest member) is repeatedly replaced by its
+        members while the item count stays within budget. The focus's own
+        ancestors come first, so the focus and its surroundings reach full
+        detail and the rest of the graph stays summarised.
+
+        Args:
+            center_id: Focus node
+            budget: Maximum number of nodes plus super-nodes returned
+
+        Returns:
+            {
+                'center': str,
+                'nodes': [...],       # detailed nodes and super-nodes
+                'edges': [...],       # aggregated, undirected
+                'levels': {level: items},
+                'total_nodes': int,
+                'represented_nodes': int,
+                'hierarchy_levels': int
+            }
+
+        Raises:
+            NodeNotFoundError: If the center node doesn't exist
+            ValidationError: If budget is not positive
+        """
+        if not self.graph.node_exists(center_id):
+            raise NodeNotFoundError(f"Node '{center_id}' not found")
+        if budget < 1:
+            raise ValidationError("budget must be positive")
+        self._log_operation("lod_viewport", center=center_id, budget=budget)
+
+        state = self._state()
+        h = state.hierarchy
+        top = h.levels - 1
+        focus = self.graph.topology_id(center_id)
+        linked = focus is not None and focus < len(state.sizes[0]) and state.sizes[0][focus] > 0
+
+        # Hops from the focus to the nearest member of every node, per level
+        if linked:
+            dist = [h.distances(0, focus)]
+            for level in range(1, h.levels):
+                dist.append(h.lift_min(level, dist[-1]))
+        else:
+            dist = [array('I', [CH_NONE]) * h.level_size(level) for level in range(h.levels)]
+
+        sizes = state.sizes[top]
+        cut = {(top, c) for c in range(len(sizes)) if sizes[c] > 0}
+        reserved = 0 if linked else 1        # an unlinked focus is shown on its own
+        # Nearest first; among equals, coarser clusters open before finer ones
+        heap = [(dist[top][c], -top, c) for _, c in cut] if top > 0 else []
+        heapq.heapify(heap)
+        while heap:
+            _, neg_level, node = heapq.heappop(heap)
+            level = -neg_level
+            children = h.children(level, node)
+            if len(cut) - 1 + len(children) + reserved > budget:
+                continue
+            cut.remove((level, node))
+            for child in children:
+                cut.add((level - 1, child))
+                if level > 1:
+                    heapq.heappush(heap, (dist[level - 1][child], 1 - level, child))
+
+        # Too many top-level super-nodes for the budget: keep the nearest
+        items = sorted(cut, key=lambda item: (dist[item[0]][item[1]], -item[0], item[1]))
+        items = items[:max(0, budget - reserved)]
+        return self._format_viewport(center_id, state, items, dist, linked)
+
+    def _format_viewport(self, center_id: str, state: _LODState, items: List[Tuple[int, int]],
+                         dist: List[array], linked: bool) -> Dict[str, Any]:
+        """Node dicts (details fetched in one batch) and aggregated edges"""
+        names = state.names
+        wanted = {names[state.reps[level][node]] for level, node in items}
+        if not linked:
+            wanted.add(center_id)
+        order = sorted(wanted)
+        node_data = dict(zip(order, self.graph.get_nodes(order)))
+
+        def label_of(node_id: str) -> str:
+            return (node_data.get(node_id) or {}).get('label', node_id)
+
+        def detail(node_id: str, hops: Optional[int]) -> Dict[str, Any]:
+            data = node_data.get(node_id) or {}
+            return {
+                'id': node_id,
+                'label': data.get('label', node_id),
+                'type': data.get('node_type', 'unknown'),
+                'data': data,
+                'level': 0,
+                'count': 1,
+                'distance_from_center': hops,
+            }
+
+        nodes, item_ids, levels = [], [], {}
+        for level, node in items:
+            hops = dist[level][node]
+            hops = None if hops == CH_NONE else hops
+            levels[level] = levels.get(level, 0) + 1
+            if level == 0:
+                item_ids.append(names[node])
+                nodes.append(detail(names[node], hops))
+                continue
+            rep = names[state.reps[level][node]]
+            count = state.sizes[level][node]
+            item_ids.append(f"cluster:{level}:{node}")
+            nodes.append({
+                'id': item_ids[-1],
+                'label': f"{label_of(rep)} (+{count - 1})",
+                'type': 'cluster',
+                'level': level,
+                'count': count,
+                'representative': rep,
+                'distance_from_center': hops,
+            })
+        if not linked:
+            nodes.append(detail(center_id, 0))
+            levels[0] = levels.get(0, 0) + 1
+
+        # Undirected graphs store each edge in both directions
+        scale = 1.0 if self.graph.directed else 0.5
+        edges = [
+            {
+                'source': item_ids[a],
+                'target': item_ids[b],
+                'weight': weight * scale,
+                'aggregated': items[a][0] > 0 or items[b][0] > 0,
+            }
+            for a, b, weight in state.hierarchy.cut_edges(items)
+        ]
+        return {
+            'center': center_id,
+            'nodes': nodes,
+            'edges': edges,
+            'levels': levels,
+            'total_nodes': len(nodes),
+            'represented_nodes': sum(node['count'] for node in nodes),
+            'hierarchy_levels': state.hierarchy.levels,
+        }
@@ -91,6 +91,9 @@ class GraphStats:
     is_weighted: bool = False
     is_connected: Optional[bool] = None
     diameter: Optional[int] = None
+    triangles: Optional[int] = None
+    transitivity: Optional[float] = None
+    avg_clustering: Optional[float] = None
     
     def to_dict(self) -> dict:
         """Convert to dictionary"""
@@ -105,9 +108,294 @@ class GraphStats:
             result['connected'] = self.is_connected
         if self.diameter is not None:
             result['diameter'] = self.diameter
+        if self.triangles is not None:
+            result['triangles'] = self.triangles
+            result['transitivity'] = self.transitivity
+            result['avg_clustering'] = self.avg_clustering
         return result
 
 
+@dataclass
+class TriangleStats:
+    """Triangle counts and clustering coefficients (edge directions ignored)"""
+    triangles: int
+    wedges: int
+    transitivity: float
+    avg_clustering: float
+    approximate: bool = False
+    samples: int = 0
+    per_node: Optional[Dict[str, Dict[str, float]]] = None
+    
+    def top_nodes(self, limit: int = 20) -> List[Dict[str, Any]]:
+        """Nodes in the most triangles (per_node results only)"""
+        ranked = sorted((self.per_node or {}).items(),
+                        key=lambda item: (-item[1]['triangles'], item[0]))
+        return [{'node_id': node_id, **values} for node_id, values in ranked[:limit]]
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        result = {
+            'triangles': self.triangles,
+            'wedges': self.wedges,
+            'transitivity': self.transitivity,
+            'avg_clustering': self.avg_clustering,
+            'approximate': self.approximate,
+        }
+        if self.approximate:
+            result['samples'] = self.samples
+        if self.per_node is not None:
+            result['per_node'] = self.per_node
+        return result
+
+
+@dataclass
+class CentralityResult:
+    """Per-node centrality values"""
+    measure: str
+    values: Dict[str, float]
+    normalized: bool = True
+    approximate: bool = False
+    samples: int = 0
+    epsilon: float = 0.0
+    cached: bool = False
+    
+    def top_nodes(self, limit: int = 20) -> List[Dict[str, Any]]:
+        """Highest-scoring nodes"""
+        ranked = sorted(self.values.items(), key=lambda item: (-item[1], item[0]))
+        return [{'node_id': node_id, 'value': value} for node_id, value in ranked[:limit]]
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        result = {
+            'measure': self.measure,
+            'values': self.values,
+            'normalized': self.normalized,
+            'approximate': self.approximate,
+            'cached': self.cached,
+        }
+        if self.approximate:
+            result['samples'] = self.samples
+            result['epsilon'] = self.epsilon
+        return result
+
+
+@dataclass
+class RelatedNodes:
+    """Nodes related to a set of source nodes by random-walk proximity"""
+    sources: List[str]
+    related: List[Dict[str, Any]] = field(default_factory=list)   # best first
+    walks: int = 0
+    restart: float = 0.15
+    p: float = 1.0
+    q: float = 1.0
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'sources': self.sources,
+            'related': self.related,
+            'walks': self.walks,
+            'restart': self.restart,
+            'p': self.p,
+            'q': self.q,
+        }
+
+
+@dataclass
+class TreeResult:
+    """Tree (or forest) of edges joining a set of nodes"""
+    terminals: List[str]
+    nodes: List[str] = field(default_factory=list)
+    edges: List[EdgeResult] = field(default_factory=list)
+    cost: float = 0.0
+    components: int = 1     # groups of terminals (or trees) left unjoined
+    
+    @property
+    def connected(self) -> bool:
+        """True if everything is joined into one tree"""
+        return self.components <= 1
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'terminals': self.terminals,
+            'nodes': self.nodes,
+            'edges': [e.to_dict() for e in self.edges],
+            'cost': self.cost,
+            'connected': self.connected,
+            'components': self.components,
+        }
+
+
+@dataclass
+class SymptomExtraction:
+    """Symptoms found in free text by dictionary matching"""
+    symptoms: List[Dict[str, Any]] = field(default_factory=list)   # text order
+    negated: List[Dict[str, Any]] = field(default_factory=list)
+    coverage: float = 0.0       # share of content words explained
+    needs_llm: bool = True
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'symptoms': self.symptoms,
+            'negated': self.negated,
+            'coverage': self.coverage,
+            'needs_llm': self.needs_llm,
+        }
+
+
+@dataclass
+class Differential:
+    """Diseases ranked by posterior probability given symptom evidence"""
+    present: List[str] = field(default_factory=list)     # symptom IDs used
+    absent: List[str] = field(default_factory=list)
+    unknown: List[str] = field(default_factory=list)     # not in the model
+    ranked: List[Dict[str, Any]] = field(default_factory=list)   # best first
+    groups: List[Dict[str, Any]] = field(default_factory=list)   # hierarchy roll-up
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'present': self.present,
+            'absent': self.absent,
+            'unknown': self.unknown,
+            'ranked': self.ranked,
+            'groups': self.groups,
+        }
+
+
+@dataclass
+class NextQuestions:
+    """Symptoms to ask about next, ranked by expected information gain"""
+    present: List[str] = field(default_factory=list)
+    absent: List[str] = field(default_factory=list)
+    unknown: List[str] = field(default_factory=list)
+    entropy: float = 0.0        # bits of uncertainty left over the diseases
+    questions: List[Dict[str, Any]] = field(default_factory=list)    # best first
+    candidates: List[Dict[str, Any]] = field(default_factory=list)   # most likely diseases
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'present': self.present,
+            'absent': self.absent,
+            'unknown': self.unknown,
+            'entropy': self.entropy,
+            'questions': self.questions,
+            'candidates': self.candidates,
+        }
+
+
+@dataclass
+class HierarchyNode:
+    """A class in a lazily expanded hierarchy"""
+    class_id: str
+    label: str
+    parent_id: Optional[str] = None
+    depth: int = 0
+    child_count: int = 0        # direct subclasses
+    instance_count: int = 0     # direct instances
+    children: List['HierarchyNode'] = field(default_factory=list)   # loaded so far
+    next_cursor: Optional[str] = None   # loads more children (None = all loaded)
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'class_id': self.class_id,
+            'label': self.label,
+            'parent_id': self.parent_id,
+            'depth': self.depth,
+            'child_count': self.child_count,
+            'instance_count': self.instance_count,
+            'children': [child.to_dict() for child in self.children],
+            'next_cursor': self.next_cursor,
+        }
+
+
+@dataclass
+class HierarchyPage:
+    """One page of a class's direct subclasses"""
+    parent_id: str
+    total: int = 0              # direct subclasses over all pages
+    children: List[HierarchyNode] = field(default_factory=list)
+    next_cursor: Optional[str] = None
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'parent_id': self.parent_id,
+            'total': self.total,
+            'children': [child.to_dict() for child in self.children],
+            'next_cursor': self.next_cursor,
+        }
+
+
+@dataclass
+class TriplePage:
+    """One page of the triples matching a pattern"""
+    pattern: Dict[str, Optional[str]] = field(default_factory=dict)   # None = any term
+    total: int = 0              # matches over all pages
+    offset: int = 0
+    triples: List[Dict[str, str]] = field(default_factory=list)
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'pattern': self.pattern,
+            'total': self.total,
+            'offset': self.offset,
+            'triples': self.triples,
+        }
+
+
+@dataclass
+class ShapeViolation:
+    """One instance breaking one class constraint"""
+    instance_id: str
+    property_id: Optional[str]
+    constraint: str             # min_count, max_count, datatype, range or class
+    message: str
+    class_id: Optional[str] = None      # class the constraint belongs to (None = all)
+    value: Optional[str] = None         # offending value
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'instance_id': self.instance_id,
+            'property_id': self.property_id,
+            'constraint': self.constraint,
+            'message': self.message,
+            'class_id': self.class_id,
+            'value': self.value,
+        }
+
+
+@dataclass
+class ShapeReport:
+    """Violations found validating a batch of instances"""
+    checked: int = 0            # instances validated
+    invalid: int = 0            # instances with at least one violation
+    total_violations: int = 0   # violations found (violations may hold fewer)
+    violations: List[ShapeViolation] = field(default_factory=list)
+    threads: int = 1
+    
+    @property
+    def valid(self) -> bool:
+        return self.total_violations == 0
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'valid': self.valid,
+            'checked': self.checked,
+            'invalid': self.invalid,
+            'total_violations': self.total_violations,
+            'violations': [v.to_dict() for v in self.violations],
+            'threads': self.threads,
+        }
+
+
 @dataclass
 class SearchCriteria:
     """Criteria for searching nodes"""
@@ -154,3 +442,22 @@ class ImportResult:
             'success': self.success,
             'error_count': len(self.errors),
         }
+
+
+@dataclass
+class PatternMatchResult:
+    """Result of a pattern query"""
+    columns: List[str]
+    rows: List[List[Any]]
+    truncated: bool = False
+    automorphisms: int = 0
+    
+    def to_dict(self) -> dict:
+        """Convert to dictionary"""
+        return {
+            'columns': self.columns,
+            'rows': self.rows,
+            'count': len(self.rows),
+            'truncated': self.truncated,
+            'automorphisms': self.automorphisms,
+        }
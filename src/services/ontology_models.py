@@ -67,6 +67,9 @@ class OntologyProperty:
     inverse_of: Optional[str] = None  # Inverse property
     characteristics: Set[PropertyCharacteristic] = field(default_factory=set)
     annotations: Dict[str, str] = field(default_factory=dict)
+    required: bool = False  # Instances of the domain must have a value
+    min_cardinality: int = 0  # Fewest values per instance
+    max_cardinality: Optional[int] = None  # Most values per instance (None = any)
     
     def __post_init__(self):
         if not self.label:
@@ -145,6 +148,14 @@ class OntologyStats:
     total_data_properties: int = 0
     total_annotation_properties: int = 0
     max_hierarchy_depth: int = 0
+    avg_hierarchy_depth: float = 0.0
+    avg_branching_factor: float = 0.0
+    max_branching_factor: int = 0
+    root_classes: int = 0
+    leaf_classes: int = 0
+    multi_parent_classes: int = 0
+    cyclic_classes: int = 0
+    version: int = 0
     total_axioms: int = 0
     consistency_status: str = "unknown"
 
@@ -5,8 +5,11 @@ Service layer for ontology operations, built on top of GraphService.
 Provides semantic capabilities like class hierarchies, properties, and reasoning.
 """
 
-from typing import List, Optional, Dict, Any, Set
+import functools
+from typing import Callable, List, Optional, Dict, Any, Set, Tuple
 from src.services.graph_service import GraphService
+from src.services.ontology_stats_service import OntologyStatsService
+from src.services.shape_validation_service import ShapeValidationService
 from src.services.base_service import (
     NodeNotFoundError,
     ValidationError,
@@ -30,6 +33,15 @@ from src.services.ontology_models import (
 from graph_db import GraphDB
 
 
+def _consistent_read(method):
+    """Run a multi-read method against one pinned snapshot of the graph"""
+    @functools.wraps(method)
+    def wrapper(self, *args, **kwargs):
+        with self.graph.snapshot():
+            return method(self, *args, **kwargs)
+    return wrapper
+
+
 class OntologyService:
     """
     Service for ontology operations
@@ -60,6 +72,8 @@ class OntologyService:
         """
         self.graph_service = GraphService(graph_db)
         self.graph = self.graph_service.graph
+        self.stats_service = OntologyStatsService(self.graph)
+        self.shape_service = ShapeValidationService(self.graph)
         self._initialize_ontology()
     
     def _get_node_data(self, node_id: str) -> Dict[str, Any]:
@@ -82,6 +96,47 @@ class OntologyService:
                 }
             )
     
+    def _class_record(self, class_obj: OntologyClass) -> Tuple[Dict[str, Any], List[Tuple]]:
+        """Node data and outgoing (from, to, weight, label) edges of a class"""
+        node_data = {
+            "label": class_obj.label,
+            "node_type": self.CLASS_TYPE,
+            "description": class_obj.description or "",
+            "is_abstract": class_obj.is_abstract,
+        }
+        node_data.update(class_obj.properties)
+        
+        edges = [(class_obj.id, parent_id, 1.0, self.SUBCLASS_RELATION)
+                 for parent_id in class_obj.parent_classes or ["owl:Thing"]]
+        # Equivalent and disjoint class relationships
+        edges += [(class_obj.id, equiv_id, 1.0, "owl:equivalentClass")
+                  for equiv_id in class_obj.equivalent_classes]
+        edges += [(class_obj.id, disj_id, 1.0, "owl:disjointWith")
+                  for disj_id in class_obj.disjoint_classes]
+        return node_data, edges
+    
+    def _property_record(self, prop_obj: OntologyProperty,
+                         is_node: Callable[[str], bool]) -> Tuple[Dict[str, Any], List[Tuple]]:
+        """Node data and domain/range edges of a property (ranges that are not nodes are datatypes)"""
+        node_data = {
+            "label": prop_obj.label,
+            "node_type": self.PROPERTY_TYPE,
+            "property_type": prop_obj.property_type.value,
+            "description": prop_obj.description or "",
+            "inverse_of": prop_obj.inverse_of or "",
+            "characteristics": ",".join(c.value for c in prop_obj.characteristics),
+            "required": prop_obj.required,
+            "min_cardinality": prop_obj.min_cardinality,
+            "max_cardinality": prop_obj.max_cardinality,
+            # Ranges that are not nodes (datatypes such as xsd:string)
+            "datatype_range": ",".join(r for r in prop_obj.range if not is_node(r)),
+        }
+        edges = [(prop_obj.id, domain_class, 1.0, self.DOMAIN_RELATION)
+                 for domain_class in prop_obj.domain if is_node(domain_class)]
+        edges += [(prop_obj.id, range_class, 1.0, self.RANGE_RELATION)
+                  for range_class in prop_obj.range if is_node(range_class)]
+        return node_data, edges
+    
     # ========================================================================
     # Class Operations
     # ========================================================================
@@ -107,37 +162,16 @@ class OntologyService:
             if not self.graph.node_exists(parent_id):
                 raise NodeNotFoundError(f"Parent class '{parent_id}' not found")
         
-        # Create class node
-        node_data = {
-            "label": class_obj.label,
-            "node_type": self.CLASS_TYPE,
-            "description": class_obj.description or "",
-            "is_abstract": class_obj.is_abstract,
-        }
-        node_data.update(class_obj.properties)
-        self.graph.add_node(class_obj.id, data=node_data)
-        
-        # Add parent relationships (if no parents, default to owl:Thing)
+        # Parent relationships (if no parents, default to owl:Thing)
         if not class_obj.parent_classes:
             class_obj.parent_classes = ["owl:Thing"]
         
-        for parent_id in class_obj.parent_classes:
-            self.graph.add_edge(
-                class_obj.id,
-                parent_id,
-                label=self.SUBCLASS_RELATION,
-                weight=1.0
-            )
-        
-        # Add equivalent class relationships
-        for equiv_id in class_obj.equivalent_classes:
-            if self.graph.node_exists(equiv_id):
-                self.graph.add_edge(class_obj.id, equiv_id, label="owl:equivalentClass")
+        node_data, edges = self._class_record(class_obj)
+        self.graph.add_node(class_obj.id, data=node_data)
         
-        # Add disjoint class relationships
-        for disj_id in class_obj.disjoint_classes:
-            if self.graph.node_exists(disj_id):
-                self.graph.add_edge(class_obj.id, disj_id, label="owl:disjointWith")
+        # One adjacency rewrite for all of the class's relationships
+        # (add_edges skips targets that do not exist yet)
+        self.graph.add_edges(edges)
         
         return class_obj
     
@@ -204,6 +238,7 @@ class OntologyService:
         
         self.graph_service.delete_node(class_id)
     
+    @_consistent_read
     def get_class_hierarchy(self, root_id: Optional[str] = None) -> ClassHierarchy:
         """
         Get class hierarchy tree
@@ -297,29 +332,11 @@ class OntologyService:
         if self.graph.node_exists(prop_obj.id):
             raise ValidationError(f"Property '{prop_obj.id}' already exists")
         
-        # Create property node
-        self.graph.add_node(
-            prop_obj.id,
-            data={
-                "label": prop_obj.label,
-                "node_type": self.PROPERTY_TYPE,
-                "property_type": prop_obj.property_type.value,
-                "description": prop_obj.description or "",
-                "inverse_of": prop_obj.inverse_of or "",
-                "characteristics": ",".join(c.value for c in prop_obj.characteristics)
-            }
-        )
+        node_data, edges = self._property_record(prop_obj, self.graph.node_exists)
+        self.graph.add_node(prop_obj.id, data=node_data)
         
-        # Add domain relationships
-        for domain_class in prop_obj.domain:
-            if self.graph.node_exists(domain_class):
-                self.graph.add_edge(prop_obj.id, domain_class, label=self.DOMAIN_RELATION)
-        
-        # Add range relationships
-        for range_class in prop_obj.range:
-            # Range can be class or datatype
-            if self.graph.node_exists(range_class):
-                self.graph.add_edge(prop_obj.id, range_class, label=self.RANGE_RELATION)
+        # Domain and range relationships
+        self.graph.add_edges(edges)
         
         return prop_obj
     
@@ -347,6 +364,9 @@ class OntologyService:
                         domain.append(to_node)
                     elif label == self.RANGE_RELATION:
                         range_list.append(to_node)
+        datatypes = node_data.get('datatype_range', '')
+        if datatypes:
+            range_list.extend(datatypes.split(','))
         
         # Get characteristics
         char_str = node_data.get('characteristics', '')
@@ -366,7 +386,10 @@ class OntologyService:
             domain=domain,
             range=range_list,
             inverse_of=node_data.get('inverse_of') or None,
-            characteristics=characteristics
+            characteristics=characteristics,
+            required=bool(node_data.get('required', False)),
+            min_cardinality=node_data.get('min_cardinality') or 0,
+            max_cardinality=node_data.get('max_cardinality')
         )
     
     def get_all_properties(self) -> List[OntologyProperty]:
@@ -463,6 +486,7 @@ class OntologyService:
     # Reasoning Operations
     # ========================================================================
     
+    @_consistent_read
     def check_consistency(self) -> ReasoningResult:
         """
         Check ontology consistency
@@ -522,7 +546,7 @@ class OntologyService:
                     'property_type': prop.property_type.value,
                     'description': prop.description,
                     'range': prop.range,
-                    'required': False,  # Default - can be enhanced later
+                    'required': prop.required,
                     'source': 'direct'
                 })
         
@@ -635,67 +659,23 @@ class OntologyService:
             
         Returns:
             List of validation error messages (empty if valid)
+            
+        Raises:
+            NodeNotFoundError: If the class doesn't exist
         """
-        errors = []
-        
-        # Get all properties (direct + inherited)
-        class_full = self.get_class_full(class_id)
-        all_props = class_full['all_properties']
-        
-        # Check required properties
-        for prop in all_props:
-            if prop.get('required', False):
-                prop_name = prop['id']
-                if prop_name not in properties or properties[prop_name] is None:
-                    source_info = f" (inherited from {prop['source']})" if prop['source'] != 'direct' else ""
-                    errors.append(
-                        f"Missing required property '{prop['label']}'{source_info}"
-                    )
+        self.get_class(class_id)
         
-        # Type validation can be added here in future
-        # For now, we just check required fields
-        
-        return errors
+        # Checked against the compiled constraints, inherited ones included
+        report = self.shape_service.validate([
+            OntologyInstance(id="", label="", class_ids=[class_id], properties=properties)
+        ])
+        return [violation.message for violation in report.violations]
     
     def get_statistics(self) -> OntologyStats:
-        """Get ontology statistics"""
-        all_classes = self.get_all_classes()
-        all_properties = self.get_all_properties()
-        
-        # Count instances
-        total_instances = 0
-        for node_id in self.graph.get_all_nodes():
-            node_data = self._get_node_data(node_id)
-            if node_data and node_data.get('node_type') == self.INSTANCE_TYPE:
-                total_instances += 1
-        
-        # Count by property type
-        obj_props = sum(1 for p in all_properties if p.property_type == PropertyType.OBJECT)
-        data_props = sum(1 for p in all_properties if p.property_type == PropertyType.DATA)
-        annot_props = sum(1 for p in all_properties if p.property_type == PropertyType.ANNOTATION)
-        
-        # Calculate max hierarchy depth
-        def get_depth(class_id: str) -> int:
-            superclasses = self.get_superclasses(class_id, direct_only=True)
-            if not superclasses:
-                return 0
-            return 1 + max(get_depth(sc.id) for sc in superclasses)
-        
-        max_depth = 0
-        for class_obj in all_classes:
-            depth = get_depth(class_obj.id)
-            max_depth = max(max_depth, depth)
-        
-        return OntologyStats(
-            total_classes=len(all_classes),
-            total_properties=len(all_properties),
-            total_instances=total_instances,
-            total_object_properties=obj_props,
-            total_data_properties=data_props,
-            total_annotation_properties=annot_props,
-            max_hierarchy_depth=max_depth
-        )
+        """Get ontology statistics (cached per graph version)"""
+        return self.stats_service.statistics()
     
+    @_consistent_read
     def validate_ontology(self) -> ValidationResult:
         """Validate entire ontology structure"""
         result = ValidationResult(valid=True)
@@ -706,6 +686,15 @@ class OntologyService:
             for error in consistency.errors:
                 result.add_error(error, error_type="consistency")
 
+        # Check stored instances against their classes' constraints
+        shapes = self.shape_service.validate_graph()
+        for violation in shapes.violations:
+            result.add_error(violation.message, violation.instance_id, "shape")
+        if shapes.total_violations > len(shapes.violations):
+            result.add_warning(
+                f"{shapes.total_violations - len(shapes.violations)} more shape violations "
+                "not listed", None, "shape")
+
         # Check for orphan classes (no parent except owl:Thing)
         for class_obj in self.get_all_classes():
             if class_obj.id != "owl:Thing":
@@ -722,6 +711,7 @@ class OntologyService:
     # Import/Export Operations
     # ========================================================================
 
+    @_consistent_read
     def export_to_rdf(self, format: str = "xml") -> str:
         """
         Export ontology to RDF format
@@ -833,10 +823,13 @@ class OntologyService:
         Args:
             rdf_content: RDF content as string
             format: Input format (xml, turtle, n3, nt)
-            clear_existing: Whether to clear existing ontology first
+            clear_existing: Make the ontology's classes and properties
+                exactly those of the document (see replace_schema) instead
+                of adding the missing ones
 
         Returns:
-            Dictionary with counts of imported elements
+            Dictionary with counts of imported elements (with
+            clear_existing, also the node and edge changes written)
         """
         from rdflib import Graph, RDF, RDFS, OWL
 
@@ -858,17 +851,14 @@ class OntologyService:
         except Exception as e:
             raise ValidationError(f"Failed to parse RDF: {str(e)}")
 
-        # Clear existing data if requested
-        if clear_existing:
-            # Note: This is destructive! In production, you might want to backup first
-            pass
-
         counts = {
             "classes": 0,
             "properties": 0,
             "instances": 0,
             "errors": 0
         }
+        classes: List[OntologyClass] = []
+        properties: List[OntologyProperty] = []
 
         # Helper to convert URI to ID
         def uri_to_id(uri):
@@ -882,7 +872,7 @@ class OntologyService:
                 return uri_str.split("/")[-1]
             return uri_str.replace("_", ":")
 
-        # Import classes
+        # Classes
         for class_uri in g.subjects(RDF.type, OWL.Class):
             try:
                 class_id = uri_to_id(class_uri)
@@ -902,68 +892,93 @@ class OntologyService:
                 if not parent_classes:
                     parent_classes = ["owl:Thing"]
 
-                # Create class if it doesn't exist
-                if not self.graph.node_exists(class_id):
-                    class_obj = OntologyClass(
-                        id=class_id,
-                        label=label,
-                        description=description if description else None,
-                        parent_classes=parent_classes
-                    )
-                    self.create_class(class_obj)
-                    counts["classes"] += 1
+                classes.append(OntologyClass(
+                    id=class_id,
+                    label=label,
+                    description=description if description else None,
+                    parent_classes=parent_classes
+                ))
             except Exception as e:
                 counts["errors"] += 1
                 print(f"Error importing class {class_uri}: {e}")
 
-        # Import properties
-        for prop_uri in g.subjects(RDF.type, OWL.ObjectProperty):
-            try:
-                prop_id = uri_to_id(prop_uri)
-                label = str(g.value(prop_uri, RDFS.label) or prop_id)
-                description = str(g.value(prop_uri, RDFS.comment) or "")
+        # Object and datatype properties
+        for rdf_type, property_type in ((OWL.ObjectProperty, PropertyType.OBJECT),
+                                        (OWL.DatatypeProperty, PropertyType.DATA)):
+            for prop_uri in g.subjects(RDF.type, rdf_type):
+                try:
+                    prop_id = uri_to_id(prop_uri)
+                    label = str(g.value(prop_uri, RDFS.label) or prop_id)
+                    description = str(g.value(prop_uri, RDFS.comment) or "")
 
-                # Get domain and range
-                domain = [uri_to_id(d) for d in g.objects(prop_uri, RDFS.domain)]
-                range_vals = [uri_to_id(r) for r in g.objects(prop_uri, RDFS.range)]
+                    # Get domain and range
+                    domain = [uri_to_id(d) for d in g.objects(prop_uri, RDFS.domain)]
+                    range_vals = [uri_to_id(r) for r in g.objects(prop_uri, RDFS.range)]
 
-                if not self.graph.node_exists(prop_id):
-                    prop_obj = OntologyProperty(
+                    properties.append(OntologyProperty(
                         id=prop_id,
                         label=label,
-                        property_type=PropertyType.OBJECT,
+                        property_type=property_type,
                         description=description if description else None,
                         domain=domain,
                         range=range_vals
-                    )
-                    self.create_property(prop_obj)
-                    counts["properties"] += 1
+                    ))
+                except Exception as e:
+                    counts["errors"] += 1
+                    print(f"Error importing {property_type.value} property {prop_uri}: {e}")
+
+        if clear_existing:
+            counts.update(self.replace_schema(classes, properties))
+            counts["classes"] = len(classes)
+            counts["properties"] = len(properties)
+            return counts
+
+        # Create the classes and properties that don't exist yet
+        for class_obj in classes:
+            try:
+                if not self.graph.node_exists(class_obj.id):
+                    self.create_class(class_obj)
+                    counts["classes"] += 1
             except Exception as e:
                 counts["errors"] += 1
-                print(f"Error importing object property {prop_uri}: {e}")
+                print(f"Error importing class {class_obj.id}: {e}")
 
-        for prop_uri in g.subjects(RDF.type, OWL.DatatypeProperty):
+        for prop_obj in properties:
             try:
-                prop_id = uri_to_id(prop_uri)
-                label = str(g.value(prop_uri, RDFS.label) or prop_id)
-                description = str(g.value(prop_uri, RDFS.comment) or "")
-
-                domain = [uri_to_id(d) for d in g.objects(prop_uri, RDFS.domain)]
-                range_vals = [uri_to_id(r) for r in g.objects(prop_uri, RDFS.range)]
-
-                if not self.graph.node_exists(prop_id):
-                    prop_obj = OntologyProperty(
-                        id=prop_id,
-                        label=label,
-                        property_type=PropertyType.DATA,
-                        description=description if description else None,
-                        domain=domain,
-                        range=range_vals
-                    )
+                if not self.graph.node_exists(prop_obj.id):
                     self.create_property(prop_obj)
                     counts["properties"] += 1
             except Exception as e:
                 counts["errors"] += 1
-                print(f"Error importing data property {prop_uri}: {e}")
+                print(f"Error importing {prop_obj.property_type.value} property {prop_obj.id}: {e}")
 
         return counts
+
+    def replace_schema(self, classes: List[OntologyClass],
+                       properties: List[OntologyProperty]) -> Dict[str, int]:
+        """
+        Make the ontology's classes and properties exactly these ones
+
+        Only the difference from the stored schema is written, in one atomic
+        batch (see GraphDB.import_diff): refreshing a reference ontology
+        with a few changes touches a few nodes, and re-importing an
+        unchanged one writes nothing, so caches stay warm. Classes and
+        properties not listed are deleted along with their edges (owl:Thing
+        is kept); instances are kept, minus type edges to deleted classes.
+
+        Returns:
+            Counts of nodes and edges added, updated, deleted and unchanged
+        """
+        schema_types = (self.CLASS_TYPE, self.PROPERTY_TYPE)
+        ids = {"owl:Thing"} | {c.id for c in classes} | {p.id for p in properties}
+        nodes: Dict[str, Optional[Dict[str, Any]]] = {"owl:Thing": None}
+        edges: List[Tuple] = []
+        for class_obj in classes:
+            nodes[class_obj.id], class_edges = self._class_record(class_obj)
+            edges += class_edges
+        for prop_obj in properties:
+            nodes[prop_obj.id], prop_edges = self._property_record(prop_obj, ids.__contains__)
+            edges += prop_edges
+
+        return self.graph.import_diff(
+            nodes, edges, owned=lambda _, data: data.get('node_type') in schema_types)
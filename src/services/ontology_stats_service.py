@@ -0,0 +1,118 @@
+"""
+Ontology Statistics Service
+
+Ontology statistics that cost the same however large the ontology is.
+
+Class, property and instance counts are counters the graph maintains as
+nodes are written (see GraphDB.count_values), so reading them is one
+lookup. Hierarchy figures - maximum and average depth, branching, roots,
+leaves, classes with several parents - come from one pass in topological
+order over the native rdfs:subClassOf layer (see src/core/dag.h): a class
+sits one level below its deepest superclass, computed once per class
+however many paths lead to it, and classes on a subclass cycle are
+counted instead of recursing forever.
+
+Results are cached per graph version: repeated requests between two
+writes return the cached statistics without touching the graph.
+"""
+
+import dataclasses
+import threading
+from typing import Optional, Tuple
+from graph_db import GraphDB
+from src.adapters.dag import hierarchy_levels
+from src.services.base_service import BaseService
+from src.services.ontology_models import OntologyStats
+
+
+class OntologyStatsService(BaseService):
+    """
+    Service for ontology statistics
+
+    Handles:
+    - Class, property and instance counts from maintained counters
+    - Hierarchy depth and branching in one topological pass
+    - Caching per graph version
+    """
+
+    CLASS_TYPE = "owl:Class"
+    PROPERTY_TYPE = "owl:Property"
+    INSTANCE_TYPE = "owl:Individual"
+    SUBCLASS_RELATION = "rdfs:subClassOf"
+    COUNTED_FIELDS = ("node_type", "property_type")
+
+    def __init__(self, graph_db: Optional[GraphDB] = None):
+        """
+        Initialize statistics service
+
+        Args:
+            graph_db: Graph holding the ontology; its node types start
+                being counted here (a one-time scan)
+        """
+        super().__init__()
+        self.graph = graph_db or GraphDB()
+        for field in self.COUNTED_FIELDS:
+            self.graph.count_values(field)
+        self._cache: Optional[Tuple[int, OntologyStats]] = None
+        self._lock = threading.Lock()
+
+    def statistics(self) -> OntologyStats:
+        """
+        Statistics of the current graph version
+
+        Returns:
+            OntologyStats (a copy; the cached value is never shared)
+        """
+        with self.graph.snapshot() as snap:
+            version = snap.version
+            cached = self._cache
+            if cached is None or cached[0] != version:
+                cached = (version, self._compute(version))
+                with self._lock:
+                    if self._cache is None or self._cache[0] < version:
+                        self._cache = cached
+        return dataclasses.replace(cached[1])
+
+    def _compute(self, version: int) -> OntologyStats:
+        types = self.graph.value_counts("node_type")
+        property_types = self.graph.value_counts("property_type")
+        classes = types.get(self.CLASS_TYPE, 0)
+        properties = types.get(self.PROPERTY_TYPE, 0)
+        data_props = property_types.get("data", 0)
+        annot_props = property_types.get("annotation", 0)
+
+        try:
+            view = self.graph.topology_view(self.SUBCLASS_RELATION)
+        except KeyError:
+            view = None
+        if view is not None:
+            with view:
+                _, shape = hierarchy_levels(view, depths=False)
+        else:
+            shape = dict(nodes=0, edges=0, roots=0, leaves=0, multi_parent=0,
+                         cyclic=0, max_depth=0, max_children=0, depth_sum=0)
+
+        # Classes without subclass edges are depth-0 roots and leaves
+        unlinked = max(classes - shape['nodes'], 0)
+        settled = classes - shape['cyclic']
+        parents = shape['nodes'] - shape['leaves']
+        stats = OntologyStats(
+            total_classes=classes,
+            total_properties=properties,
+            total_instances=types.get(self.INSTANCE_TYPE, 0),
+            # Properties without a type default to object properties
+            total_object_properties=max(properties - data_props - annot_props, 0),
+            total_data_properties=data_props,
+            total_annotation_properties=annot_props,
+            max_hierarchy_depth=shape['max_depth'],
+            avg_hierarchy_depth=shape['depth_sum'] / settled if settled > 0 else 0.0,
+            avg_branching_factor=shape['edges'] / parents if parents > 0 else 0.0,
+            max_branching_factor=shape['max_children'],
+            root_classes=shape['roots'] + unlinked,
+            leaf_classes=shape['leaves'] + unlinked,
+            multi_parent_classes=shape['multi_parent'],
+            cyclic_classes=shape['cyclic'],
+            version=version,
+        )
+        self._log_debug("ontology_statistics", version=version, classes=classes)
+        return stats
@@ -0,0 +1,394 @@
+"""
+Parallel Test Service
+
+Runs a pytest selection sharded across worker processes.
+
+- Collection: one worker collects the node IDs of the selection
+- Planning: node IDs are spread over the workers longest-processing-time
+  first, using historical durations supplied by the caller
+- Execution: each worker runs pytest in-process on its shard and writes one
+  JSON line per finished test to its stdout, so results stream back while
+  the other shards are still running
+- Jobs: TestJobManager runs a whole sharded run on a background thread and
+  exposes its progress for polling (the QC dashboard uses this)
+
+Workers run this file as a script (see _worker_main), so it only imports
+the standard library and pytest at module level.
+"""
+
+import heapq
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import threading
+import uuid
+from dataclasses import dataclass, field
+from datetime import datetime
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional
+
+
+# Default duration (seconds) for tests with no history and no peers to average
+DEFAULT_TEST_DURATION = 1.0
+
+# pytest exit code for a selection that matched no tests (not an error here)
+_NO_TESTS_COLLECTED = 5
+
+# Characters of worker stderr kept in a collection failure message
+_STDERR_TAIL = 2000
+
+
+# ============================================================================
+# SHARD PLANNING
+# ============================================================================
+
+def plan_shards(test_ids: List[str], durations: Dict[str, float], workers: int) -> List[List[str]]:
+    """
+    Split test IDs into at most `workers` shards of similar total duration.
+
+    Longest-processing-time first: tests are taken in decreasing expected
+    duration and each goes to the currently lightest shard.  Tests without
+    history count as the mean known duration.  Within a shard, tests keep
+    their collection order so module and class fixtures are still shared.
+
+    Returns:
+        Non-empty shards
+    """
+    if not test_ids:
+        return []
+    workers = max(1, min(workers, len(test_ids)))
+
+    known = [durations[t] for t in test_ids if durations.get(t) is not None]
+    default = sum(known) / len(known) if known else DEFAULT_TEST_DURATION
+    cost = {t: durations.get(t) if durations.get(t) is not None else default for t in test_ids}
+
+    shards: List[List[str]] = [[] for _ in range(workers)]
+    loads = [(0.0, i) for i in range(workers)]
+    for test_id in sorted(test_ids, key=lambda t: cost[t], reverse=True):
+        load, i = heapq.heappop(loads)
+        shards[i].append(test_id)
+        heapq.heappush(loads, (load + cost[test_id], i))
+
+    position = {t: n for n, t in enumerate(test_ids)}
+    return [sorted(s, key=position.__getitem__) for s in shards if s]
+
+
+# ============================================================================
+# SHARDED RUNNER
+# ============================================================================
+
+class ShardedTestRunner:
+    """
+    Collects a pytest selection and runs it across worker processes
+
+    Result records have the shape used by the in-process collectors:
+    {'nodeid', 'outcome', 'duration', 'longrepr'}.
+    """
+
+    def __init__(self, project_root: Path, workers: Optional[int] = None):
+        """
+        Args:
+            project_root: Directory pytest runs from (holds pytest.ini)
+            workers: Worker process count (defaults to the CPU count)
+        """
+        self.project_root = Path(project_root)
+        self.workers = workers or os.cpu_count() or 1
+
+    def _spawn(self, args: List[str], stderr=subprocess.DEVNULL) -> subprocess.Popen:
+        return subprocess.Popen(
+            [sys.executable, os.path.abspath(__file__)] + args,
+            cwd=self.project_root,
+            stdout=subprocess.PIPE,
+            stderr=stderr,
+            text=True,
+        )
+
+    def collect(self, selection: List[str]) -> List[str]:
+        """
+        Node IDs selected by pytest arguments (paths, -m markers, ...).
+
+        Raises:
+            RuntimeError: If collection fails (a test module does not import,
+                bad arguments, a crashed worker); the message holds pytest's
+                collection errors, or the tail of the worker's stderr
+        """
+        proc = self._spawn(["collect", "--"] + selection, stderr=subprocess.PIPE)
+        out, err = proc.communicate()
+        records = [json.loads(line) for line in out.splitlines() if line.strip()]
+        errors = [r for r in records if r.get("outcome") == "error"]
+        if errors or proc.returncode not in (0, _NO_TESTS_COLLECTED):
+            detail = "\n".join(f"{r['nodeid']}: {r['longrepr']}" for r in errors)
+            detail = detail or err.strip()[-_STDERR_TAIL:]
+            raise RuntimeError(f"Test collection failed (exit code {proc.returncode})"
+                               + (f"\n{detail}" if detail else ""))
+        return [r["nodeid"] for r in records]
+
+    def run(
+        self,
+        selection: List[str],
+        durations: Optional[Callable[[List[str]], Dict[str, float]]] = None,
+        on_collected: Optional[Callable[[List[str]], None]] = None,
+        on_result: Optional[Callable[[Dict[str, Any]], None]] = None,
+    ) -> List[Dict[str, Any]]:
+        """
+        Run a selection sharded across the workers.
+
+        Args:
+            selection: pytest arguments choosing the tests
+            durations: Maps collected node IDs to historical seconds
+            on_collected: Called once with the collected node IDs
+            on_result: Called (from reader threads) for every finished test
+
+        Returns:
+            Result records in collection order; tests a crashed worker never
+            reported are included as errors
+
+        Raises:
+            RuntimeError: If collecting the selection fails (see collect)
+        """
+        test_ids = self.collect(selection)
+        if on_collected:
+            on_collected(test_ids)
+        if not test_ids:
+            return []
+
+        history = durations(test_ids) if durations else {}
+        shards = plan_shards(test_ids, history, self.workers)
+
+        results: Dict[str, Dict[str, Any]] = {}
+        lock = threading.Lock()
+
+        def record(result: Dict[str, Any]):
+            with lock:
+                if result["nodeid"] in results:
+                    return
+                results[result["nodeid"]] = result
+            if on_result:
+                on_result(result)
+
+        def drain(proc: subprocess.Popen, shard: List[str], collect_errors: List[str]):
+            wanted = set(shard)
+            for line in proc.stdout:
+                if line.strip():
+                    result = json.loads(line)
+                    if result["nodeid"] in wanted:
+                        record(result)
+                    else:
+                        # A module that failed to import in this worker
+                        collect_errors.append(f"{result['nodeid']}: {result['longrepr']}")
+
+        with tempfile.TemporaryDirectory(prefix="qc_shards_") as tmp:
+            procs, readers, collect_errors = [], [], []
+            for n, shard in enumerate(shards):
+                ids_path = os.path.join(tmp, f"shard_{n}.json")
+                with open(ids_path, "w") as f:
+                    json.dump(shard, f)
+                proc = self._spawn(["run", ids_path])
+                errors: List[str] = []
+                reader = threading.Thread(target=drain, args=(proc, shard, errors), daemon=True)
+                reader.start()
+                procs.append(proc)
+                readers.append(reader)
+                collect_errors.append(errors)
+
+            for proc, reader, shard, errors in zip(procs, readers, shards, collect_errors):
+                code = proc.wait()
+                reader.join()
+                for test_id in shard:
+                    if test_id not in results:
+                        record({
+                            "nodeid": test_id,
+                            "outcome": "error",
+                            "duration": 0.0,
+                            "longrepr": "\n".join(
+                                [f"Worker exited with code {code} before reporting this test"]
+                                + errors),
+                        })
+
+        return [results[t] for t in test_ids if t in results]
+
+
+# ============================================================================
+# BACKGROUND JOBS
+# ============================================================================
+
+@dataclass
+class TestJob:
+    """A test run executing on a background thread"""
+    __test__ = False   # not a pytest test class
+
+    job_id: str
+    description: str
+    state: str = "queued"            # queued, running, completed, failed
+    total: int = 0
+    completed: int = 0
+    counts: Dict[str, int] = field(default_factory=dict)
+    result: Any = None
+    error: Optional[str] = None
+    created_at: str = field(default_factory=lambda: datetime.now().isoformat())
+    finished_at: Optional[str] = None
+
+    def __post_init__(self):
+        self._lock = threading.Lock()
+
+    def set_total(self, test_ids: List[str]):
+        """on_collected callback for ShardedTestRunner.run."""
+        with self._lock:
+            self.total = len(test_ids)
+
+    def record(self, result: Dict[str, Any]):
+        """on_result callback for ShardedTestRunner.run."""
+        with self._lock:
+            self.completed += 1
+            outcome = result.get("outcome", "error")
+            self.counts[outcome] = self.counts.get(outcome, 0) + 1
+
+    def to_dict(self) -> Dict[str, Any]:
+        with self._lock:
+            return {
+                "job_id": self.job_id,
+                "description": self.description,
+                "state": self.state,
+                "total": self.total,
+                "completed": self.completed,
+                "progress": round(100.0 * self.completed / self.total, 1) if self.total else 0.0,
+                "counts": dict(self.counts),
+                "result": self.result,
+                "error": self.error,
+                "created_at": self.created_at,
+                "finished_at": self.finished_at,
+            }
+
+
+class TestJobManager:
+    """Starts test jobs on daemon threads and keeps recent ones for polling"""
+    __test__ = False
+
+    def __init__(self, keep: int = 50):
+        """
+        Args:
+            keep: Number of finished jobs retained for polling
+        """
+        self.keep = keep
+        self._jobs: Dict[str, TestJob] = {}
+        self._lock = threading.Lock()
+
+    def submit(self, description: str, work: Callable[[TestJob], Any]) -> TestJob:
+        """
+        Start work(job) in the background; its return value becomes job.result.
+
+        Returns:
+            The job (already registered, possibly still queued)
+        """
+        job = TestJob(job_id=uuid.uuid4().hex[:12], description=description)
+        with self._lock:
+            self._jobs[job.job_id] = job
+            self._prune()
+
+        def target():
+            job.state = "running"
+            try:
+                job.result = work(job)
+                job.state = "completed"
+            except Exception as e:
+                job.error = str(e)
+                job.state = "failed"
+            finally:
+                job.finished_at = datetime.now().isoformat()
+
+        threading.Thread(target=target, name=f"test-job-{job.job_id}", daemon=True).start()
+        return job
+
+    def get(self, job_id: str) -> Optional[TestJob]:
+        with self._lock:
+            return self._jobs.get(job_id)
+
+    def list(self) -> List[TestJob]:
+        """Jobs, newest first."""
+        with self._lock:
+            return sorted(self._jobs.values(), key=lambda j: j.created_at, reverse=True)
+
+    def _prune(self):
+        finished = [j for j in self._jobs.values() if j.state in ("completed", "failed")]
+        finished.sort(key=lambda j: j.created_at)
+        for job in finished[:max(0, len(finished) - self.keep)]:
+            del self._jobs[job.job_id]
+
+
+# ============================================================================
+# WORKER PROCESS
+# ============================================================================
+
+class _ShardReporter:
+    """pytest plugin writing one JSON line per collected / finished test"""
+
+    def __init__(self, channel, collect_only: bool = False):
+        self.channel = channel
+        self.collect_only = collect_only
+
+    def _emit(self, record: Dict[str, Any]):
+        self.channel.write(json.dumps(record) + "\n")
+        self.channel.flush()
+
+    def pytest_collection_finish(self, session):
+        if self.collect_only:
+            for item in session.items:
+                self._emit({"nodeid": item.nodeid})
+
+    def pytest_collectreport(self, report):
+        # A module or package that failed to import or to collect
+        if report.failed:
+            self._emit({
+                "nodeid": report.nodeid,
+                "outcome": "error",
+                "duration": 0.0,
+                "longrepr": str(report.longrepr) if report.longrepr else None,
+            })
+
+    def pytest_runtest_logreport(self, report):
+        # Same reports as the in-process collectors, plus setup errors
+        if report.when == "call" or (report.when == "setup" and not report.passed):
+            outcome = report.outcome
+            if report.when == "setup" and report.failed:
+                outcome = "error"
+            self._emit({
+                "nodeid": report.nodeid,
+                "outcome": outcome,
+                "duration": report.duration,
+                "longrepr": str(report.longrepr) if report.longrepr else None,
+            })
+
+
+def _worker_main(argv: List[str]) -> int:
+    """
+    Worker entry point.
+
+        collect -- <pytest args>    emit {"nodeid"} per selected test
+        run <ids.json>              run those node IDs, emit result records
+
+    Both also emit an error record for each module that failed to collect.
+
+    Records go to the original stdout; pytest's own output is discarded.
+    """
+    import pytest
+
+    channel = os.fdopen(os.dup(1), "w", buffering=1)
+    devnull = os.open(os.devnull, os.O_WRONLY)
+    os.dup2(devnull, 1)
+
+    if argv[0] == "collect":
+        args = argv[2:] if argv[1:2] == ["--"] else argv[1:]
+        reporter = _ShardReporter(channel, collect_only=True)
+        return pytest.main(["--collect-only", "-q", "-p", "no:cacheprovider"] + args,
+                           plugins=[reporter])
+
+    with open(argv[1]) as f:
+        test_ids = json.load(f)
+    reporter = _ShardReporter(channel)
+    return pytest.main(["-q", "-p", "no:cacheprovider"] + test_ids, plugins=[reporter])
+
+
+if __name__ == "__main__":
+    sys.exit(_worker_main(sys.argv[1:]))
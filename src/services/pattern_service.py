@@ -0,0 +1,494 @@
+"""
+Pattern Service
+
+Subgraph pattern queries in a small Cypher-like syntax, matched natively
+over the graph's topology mirror (see src/core/pattern_match.h).
+
+    MATCH (d1:Disease)-[:HAS_SYMPTOM]->(s)<-[:HAS_SYMPTOM]-(d2:Disease)
+    WHERE s.severity = "high"
+    RETURN d1, d2, s.name
+    LIMIT 50
+
+- Nodes: (var:Label {key: value, ...}); var, label and properties are all
+  optional.  A label matches a node whose type, node_type or label field
+  equals it, or whose labels list contains it.  Quote labels with
+  backticks when they contain other characters: (c:`owl:Class`).
+- Edges: -[:LABEL]-> or <-[:LABEL]-; -[:LABEL]- and -- match either
+  direction; the label may be omitted.  Edge variables are accepted but
+  cannot be returned.
+- WHERE: conditions joined by AND, comparing var.property with a literal
+  or another var.property using = != <> < > <= >= CONTAINS.  The property
+  `id` is the node's ID.  A condition on a missing property is false.
+- RETURN: variables (node IDs) and var.property values; defaults to every
+  named variable.
+
+Node predicates that involve one variable are resolved up front into
+candidate lists for the matcher; conditions across variables are checked
+as matches stream back.  Distinct variables always bind distinct nodes.
+By default each matching subgraph is reported once: (a)-->(s)<--(b) with
+identical constraints on a and b returns {x, y} once, not also as {y, x}.
+"""
+
+import re
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional, Tuple
+from graph_db import GraphDB
+from src.adapters.pattern_match import Pattern, PM_MAX_VARS
+from src.services.base_service import BaseService, ValidationError
+from src.services.models import PatternMatchResult
+
+
+# Rows returned when a query has no LIMIT
+DEFAULT_MAX_ROWS = 10000
+
+_TOKEN = re.compile(r'''\s*(?:
+    (?P<string>"(?:[^"\\]|\\.)*"|'(?:[^'\\]|\\.)*')
+  | (?P<number>-?\d+(?:\.\d+)?)
+  | (?P<ident>[A-Za-z_][A-Za-z0-9_]*|`[^`]+`)
+  | (?P<op><-|->|<=|>=|<>|!=|[-=<>()\[\]{}:,.])
+)''', re.VERBOSE)
+
+_KEYWORDS = {'MATCH', 'WHERE', 'AND', 'RETURN', 'LIMIT', 'CONTAINS', 'TRUE', 'FALSE', 'NULL'}
+_COMPARISONS = {'=', '!=', '<>', '<', '>', '<=', '>=', 'CONTAINS'}
+
+
+# ============================================================================
+# QUERY MODEL
+# ============================================================================
+
+@dataclass
+class NodePattern:
+    """A pattern variable with its label and inline property constraints"""
+    var: str
+    labels: List[str] = field(default_factory=list)
+    props: Dict[str, Any] = field(default_factory=dict)
+
+
+@dataclass
+class EdgePattern:
+    """A pattern edge between two variables"""
+    src: str
+    dst: str
+    label: Optional[str] = None
+    undirected: bool = False
+
+
+@dataclass
+class Condition:
+    """left op right; operands are (var, prop) references or literals"""
+    left: Any
+    op: str
+    right: Any
+
+    def variables(self) -> List[str]:
+        return sorted({o[0] for o in (self.left, self.right) if isinstance(o, PropRef)})
+
+
+class PropRef(tuple):
+    """(var, prop) reference in a condition or RETURN item"""
+    pass
+
+
+@dataclass
+class PatternQuery:
+    """Parsed MATCH ... WHERE ... RETURN ... LIMIT query"""
+    nodes: Dict[str, NodePattern]
+    edges: List[EdgePattern]
+    conditions: List[Condition]
+    returns: List[PropRef]
+    limit: Optional[int]
+
+
+# ============================================================================
+# PARSER
+# ============================================================================
+
+def _tokenize(text: str) -> List[Tuple[str, str]]:
+    tokens, pos = [], 0
+    text = text.strip()
+    while pos < len(text):
+        m = _TOKEN.match(text, pos)
+        if not m or m.end() == pos:
+            raise ValidationError(f"Unexpected character at position {pos}: {text[pos:pos + 10]!r}")
+        kind = m.lastgroup
+        value = m.group(kind)
+        if kind == 'ident' and value.upper() in _KEYWORDS:
+            kind, value = 'keyword', value.upper()
+        tokens.append((kind, value))
+        pos = m.end()
+    return tokens
+
+
+class _Parser:
+    """Recursive-descent parser for the query syntax in the module docstring"""
+
+    def __init__(self, text: str):
+        self.tokens = _tokenize(text)
+        self.pos = 0
+        self.nodes: Dict[str, NodePattern] = {}
+        self.anonymous = 0
+
+    def peek(self, offset: int = 0) -> Tuple[str, str]:
+        i = self.pos + offset
+        return self.tokens[i] if i < len(self.tokens) else ('end', '')
+
+    def accept(self, value: str) -> bool:
+        kind, tok = self.peek()
+        if kind in ('op', 'keyword') and tok == value:
+            self.pos += 1
+            return True
+        return False
+
+    def expect(self, value: str):
+        if not self.accept(value):
+            found = self.peek()[1] or 'end of query'
+            raise ValidationError(f"Expected {value!r} but found {found!r}")
+
+    def ident(self) -> str:
+        kind, tok = self.peek()
+        if kind != 'ident':
+            raise ValidationError(f"Expected a name but found {tok or 'end of query'!r}")
+        self.pos += 1
+        return tok[1:-1] if tok.startswith('`') else tok
+
+    def literal(self) -> Any:
+        kind, tok = self.peek()
+        self.pos += 1
+        if kind == 'string':
+            return re.sub(r'\\(.)', r'\1', tok[1:-1])
+        if kind == 'number':
+            return float(tok) if '.' in tok else int(tok)
+        if kind == 'keyword' and tok in ('TRUE', 'FALSE', 'NULL'):
+            return {'TRUE': True, 'FALSE': False, 'NULL': None}[tok]
+        raise ValidationError(f"Expected a value but found {tok or 'end of query'!r}")
+
+    def parse(self) -> PatternQuery:
+        self.expect('MATCH')
+        edges: List[EdgePattern] = []
+        while True:
+            edges.extend(self.path())
+            if not self.accept(','):
+                break
+
+        conditions = []
+        if self.accept('WHERE'):
+            conditions.append(self.condition())
+            while self.accept('AND'):
+                conditions.append(self.condition())
+
+        returns = []
+        if self.accept('RETURN'):
+            returns.append(self.return_item())
+            while self.accept(','):
+                returns.append(self.return_item())
+        else:
+            returns = [PropRef((v, None)) for v in self.nodes if not v.startswith('_')]
+
+        limit = None
+        if self.accept('LIMIT'):
+            limit = self.literal()
+            if not isinstance(limit, int) or limit < 0:
+                raise ValidationError("LIMIT must be a non-negative integer")
+        if self.peek()[0] != 'end':
+            raise ValidationError(f"Unexpected {self.peek()[1]!r}")
+
+        for cond in conditions:
+            for var in cond.variables():
+                if var not in self.nodes:
+                    raise ValidationError(f"Unknown variable {var!r} in WHERE")
+        for var, _ in returns:
+            if var not in self.nodes:
+                raise ValidationError(f"Unknown variable {var!r} in RETURN")
+        if len(self.nodes) > PM_MAX_VARS:
+            raise ValidationError(f"Patterns are limited to {PM_MAX_VARS} nodes")
+        return PatternQuery(self.nodes, edges, conditions, returns, limit)
+
+    def path(self) -> List[EdgePattern]:
+        edges = []
+        left = self.node()
+        while self.peek()[1] in ('-', '<-'):
+            incoming = self.accept('<-')
+            if not incoming:
+                self.expect('-')
+            label = None
+            if self.accept('['):
+                if self.peek()[0] == 'ident':
+                    self.ident()                 # edge variable, not bound
+                if self.accept(':'):
+                    label = self.ident()
+                self.expect(']')
+            if incoming:
+                self.expect('-')
+                outgoing = False
+            else:
+                outgoing = self.accept('->')
+                if not outgoing:
+                    self.expect('-')
+            right = self.node()
+            if incoming:
+                edges.append(EdgePattern(right, left, label))
+            else:
+                edges.append(EdgePattern(left, right, label, undirected=not outgoing))
+            left = right
+        return edges
+
+    def node(self) -> str:
+        self.expect('(')
+        if self.peek()[0] == 'ident':
+            var = self.ident()
+        else:
+            var = f"_{self.anonymous}"
+            self.anonymous += 1
+        node = self.nodes.setdefault(var, NodePattern(var))
+        while self.accept(':'):
+            node.labels.append(self.ident())
+        if self.accept('{'):
+            while True:
+                key = self.ident()
+                self.expect(':')
+                node.props[key] = self.literal()
+                if not self.accept(','):
+                    break
+            self.expect('}')
+        self.expect(')')
+        return var
+
+    def operand(self) -> Any:
+        if self.peek()[0] == 'ident':
+            var = self.ident()
+            self.expect('.')
+            return PropRef((var, self.ident()))
+        return self.literal()
+
+    def condition(self) -> Condition:
+        left = self.operand()
+        kind, op = self.peek()
+        if op not in _COMPARISONS:
+            raise ValidationError(f"Expected a comparison but found {op or 'end of query'!r}")
+        self.pos += 1
+        return Condition(left, '!=' if op == '<>' else op, self.operand())
+
+    def return_item(self) -> PropRef:
+        var = self.ident()
+        if self.accept('.'):
+            return PropRef((var, self.ident()))
+        return PropRef((var, None))
+
+
+def parse_pattern_query(text: str) -> PatternQuery:
+    """Parse a pattern query; raises ValidationError on syntax errors."""
+    return _Parser(text).parse()
+
+
+# ============================================================================
+# EVALUATION HELPERS
+# ============================================================================
+
+def _has_label(data: Dict[str, Any], label: str) -> bool:
+    if label in (data.get('type'), data.get('node_type'), data.get('label')):
+        return True
+    labels = data.get('labels')
+    return isinstance(labels, list) and label in labels
+
+
+def _property(node_id: str, data: Optional[Dict[str, Any]], prop: str) -> Any:
+    if prop == 'id':
+        return node_id
+    return (data or {}).get(prop)
+
+
+def _unbound(operand: Any) -> Any:
+    """Operand with its variable name dropped, to compare constraints across variables"""
+    return ('.', operand[1]) if isinstance(operand, PropRef) else operand
+
+
+def _compare(left: Any, op: str, right: Any) -> bool:
+    if left is None or right is None:
+        return False
+    try:
+        if op == '=':
+            return left == right
+        if op == '!=':
+            return left != right
+        if op == '<':
+            return left < right
+        if op == '>':
+            return left > right
+        if op == '<=':
+            return left <= right
+        if op == '>=':
+            return left >= right
+        if isinstance(left, (list, tuple)):
+            return right in left
+        return str(right) in str(left)
+    except TypeError:
+        return False
+
+
+class PatternService(BaseService):
+    """
+    Service for subgraph pattern queries
+
+    Handles:
+    - Parsing the query syntax
+    - Resolving node predicates into candidate lists
+    - Running the native matcher over per-label topology views
+    - Cross-variable conditions and projection of the returned columns
+    """
+
+    def __init__(self, graph_db: Optional[GraphDB] = None):
+        """
+        Initialize pattern service
+
+        Args:
+            graph_db: GraphDB instance to query (creates a new one if None)
+        """
+        super().__init__()
+        self.graph = graph_db or GraphDB(directed=True, weighted=True)
+
+    def query(self, text: str, limit: Optional[int] = None, all_orderings: bool = False,
+              threads: int = 0) -> PatternMatchResult:
+        """
+        Run a pattern query
+
+        Args:
+            text: MATCH ... [WHERE ...] [RETURN ...] [LIMIT n]
+            limit: Row cap when the query has no LIMIT (DEFAULT_MAX_ROWS if None)
+            all_orderings: Report symmetric matches once per automorphism
+                (every assignment of interchangeable variables) instead of once
+            threads: Matcher threads (0 = one per CPU)
+
+        Returns:
+            PatternMatchResult; rows come in no particular order
+
+        Raises:
+            ValidationError: If the query does not parse or limit is negative
+        """
+        q = parse_pattern_query(text)
+        self._log_operation("pattern_query", query=text)
+
+        if limit is not None and limit < 0:
+            raise ValidationError("limit must be a non-negative integer")
+        max_rows = q.limit if q.limit is not None else (
+            DEFAULT_MAX_ROWS if limit is None else limit)
+        columns = [var if prop is None else f"{var}.{prop}" for var, prop in q.returns]
+        result = PatternMatchResult(columns=columns, rows=[])
+        if max_rows == 0:
+            return result
+
+        # Literal-only conditions decide the whole query
+        for cond in q.conditions:
+            if not cond.variables() and not _compare(cond.left, cond.op, cond.right):
+                return result
+
+        local = {v: [] for v in q.nodes}
+        cross = []
+        for cond in q.conditions:
+            refs = cond.variables()
+            if len(refs) == 1:
+                local[refs[0]].append(cond)
+            elif len(refs) > 1:
+                cross.append(cond)
+
+        # Candidate lists: filtered variables, and variables with no edges
+        linked = {e.src for e in q.edges} | {e.dst for e in q.edges}
+        constrained = [v for v, n in q.nodes.items()
+                       if n.labels or n.props or local[v] or v not in linked]
+        candidates: Dict[str, List[str]] = {}
+        node_data: Dict[str, Optional[Dict[str, Any]]] = {}
+        if constrained:
+            all_nodes = self.graph.get_all_nodes()
+            node_data = dict(zip(all_nodes, self.graph.get_nodes(all_nodes)))
+            for var in constrained:
+                candidates[var] = [n for n in all_nodes
+                                   if self._accepts(q.nodes[var], local[var], n, node_data[n])]
+                if not candidates[var]:
+                    return result
+
+        labels = {e.label for e in q.edges}
+        known = set(self.graph.edge_labels())
+        if any(label is not None and label not in known for label in labels):
+            return result
+
+        # Variables with equal constraints are interchangeable for symmetry
+        # breaking; nodes without edges only get IDs when a variable needs them
+        pattern = Pattern()
+        classes: Dict[Any, int] = {}
+        for var, node in q.nodes.items():
+            ids = None
+            if var in candidates:
+                ids = [self.graph.topology_id(n, allocate=var not in linked)
+                       for n in candidates[var]]
+                ids = [i for i in ids if i is not None]
+            key = (tuple(sorted(node.labels)), repr(sorted(node.props.items())),
+                   tuple(sorted(repr((_unbound(c.left), c.op, _unbound(c.right)))
+                                for c in local[var])))
+            pattern.add_var(ids, classes.setdefault(key, len(classes)))
+
+        order = list(q.nodes)
+        views, names = {}, []
+        if not q.edges:
+            view, names = self.graph.topology()
+            view.release()
+        try:
+            for label in labels:
+                views[label], names = self.graph.topology(label)
+            for e in q.edges:
+                pattern.add_edge(order.index(e.src), order.index(e.dst), views[e.label], e.undirected)
+
+            data_cache = dict(node_data)
+
+            def value(node_id: str, prop: Optional[str]) -> Any:
+                if prop is None or prop == 'id':
+                    return node_id
+                if node_id not in data_cache:
+                    data_cache[node_id] = self.graph.get_nodes([node_id])[0]
+                return _property(node_id, data_cache[node_id], prop)
+
+            def operand(o: Any, binding: Dict[str, str]) -> Any:
+                return value(binding[o[0]], o[1]) if isinstance(o, PropRef) else o
+
+            def on_rows(batch: List[Tuple[int, ...]]) -> bool:
+                for row in batch:
+                    binding = {order[i]: names[n] for i, n in enumerate(row)}
+                    if not all(_compare(operand(c.left, binding), c.op, operand(c.right, binding))
+                               for c in cross):
+                        continue
+                    if len(result.rows) == max_rows:
+                        result.truncated = True
+                        return False
+                    result.rows.append([value(binding[var], prop) for var, prop in q.returns])
+                return True
+
+            stats = pattern.stream(
+                on_rows,
+                limit=0 if cross else max_rows + 1,
+                threads=threads,
+                break_symmetry=not all_orderings and not cross,
+            )
+            result.automorphisms = stats['automorphisms']
+            if not cross and stats['matches'] > max_rows:
+                result.truncated = True
+        finally:
+            for view in views.values():
+                view.release()
+
+        self._log_debug(f"Pattern query matched {len(result.rows)} rows")
+        return result
+
+    @staticmethod
+    def _accepts(node: NodePattern, conditions: List[Condition], node_id: str,
+                 data: Optional[Dict[str, Any]]) -> bool:
+        """True if a node satisfies a variable's labels, properties and conditions"""
+        if data is None:
+            return False
+        if not all(_has_label(data, label) for label in node.labels):
+            return False
+        if not all(_property(node_id, data, k) == v for k, v in node.props.items()):
+            return False
+        for c in conditions:
+            left = _property(node_id, data, c.left[1]) if isinstance(c.left, PropRef) else c.left
+            right = _property(node_id, data, c.right[1]) if isinstance(c.right, PropRef) else c.right
+            if not _compare(left, c.op, right):
+                return False
+        return True
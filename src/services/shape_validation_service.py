@@ -0,0 +1,384 @@
+"""
+Shape Validation Service
+
+Bulk validation of instances against the constraints of their classes:
+required properties and cardinalities (a property's required flag,
+min/max cardinality and functional characteristic, on its domain
+classes), XSD datatypes of data property values, and class membership
+of object property values.
+
+Constraints are compiled once into a native rule program (see
+src/core/shapes.h) in which every class already carries the rules it
+inherits, so a batch is checked by worker threads without walking the
+hierarchy or re-deriving inherited properties per instance. The program
+is rebuilt only when the schema changes - a class or property node is
+written, or a subclass, domain or range edge changes - never because
+instances were written.
+"""
+
+import json
+import threading
+from dataclasses import dataclass
+from typing import Any, Dict, List, Optional, Sequence, Set, Tuple
+from graph_db import GraphDB
+from src.adapters import shapes
+from src.adapters.shapes import ShapeBatch, ShapeProgram
+from src.services.base_service import BaseService, ValidationError
+from src.services.models import ShapeReport, ShapeViolation
+from src.services.ontology_models import OntologyInstance
+
+
+# XSD datatype masks by local name
+_XSD_MASKS = {
+    **dict.fromkeys(("string", "normalizedString", "token", "language", "Name",
+                     "NCName"), shapes.XSD_STRING),
+    **dict.fromkeys(("integer", "int", "long", "short", "byte", "nonNegativeInteger",
+                     "positiveInteger", "negativeInteger", "nonPositiveInteger",
+                     "unsignedLong", "unsignedInt", "unsignedShort", "unsignedByte"),
+                    shapes.XSD_INTEGER),
+    **dict.fromkeys(("decimal", "float", "double"), shapes.XSD_DECIMAL),
+    "boolean": shapes.XSD_BOOLEAN,
+    "date": shapes.XSD_DATE,
+    "dateTime": shapes.XSD_DATETIME,
+    "time": shapes.XSD_TIME,
+    "anyURI": shapes.XSD_ANY_URI,
+}
+_XSD_PREFIXES = ("http://www.w3.org/2001/XMLSchema#", "xsd:")
+
+
+def _xsd_mask(names: Sequence[str]) -> int:
+    """Mask of XSD datatypes, or 0 if any name is not a known datatype"""
+    mask = 0
+    for name in names:
+        for prefix in _XSD_PREFIXES:
+            if name.startswith(prefix):
+                name = name[len(prefix):]
+                break
+        if name not in _XSD_MASKS:
+            return 0
+        mask |= _XSD_MASKS[name]
+    return mask
+
+
+@dataclass
+class _Rule:
+    """What a native rule ID stands for"""
+    class_id: Optional[str]     # None = every instance
+    property_id: Optional[str]
+    label: str
+    constraint: str
+    arg: Any                    # count, datatype names or range class IDs
+
+
+@dataclass
+class _Compiled:
+    """A compiled program and the ID maps it was built with"""
+    key: Tuple
+    program: ShapeProgram
+    classes: Dict[str, int]
+    properties: Dict[str, int]
+    references: Set[str]        # object properties with a range rule
+    rules: List[_Rule]
+    unknown_class: int          # sentinel class failing the "class" rule
+
+
+class ShapeValidationService(BaseService):
+    """
+    Service for bulk instance validation
+
+    Handles:
+    - Compiling class constraints, inherited ones included, into rules
+    - Checking batches of instances on worker threads
+    - Violation reports in instance order
+    """
+
+    CLASS_TYPE = "owl:Class"
+    PROPERTY_TYPE = "owl:Property"
+    INSTANCE_TYPE = "owl:Individual"
+    SUBCLASS_RELATION = "rdfs:subClassOf"
+    TYPE_RELATION = "rdf:type"
+    DOMAIN_RELATION = "rdfs:domain"
+    RANGE_RELATION = "rdfs:range"
+    RESERVED_FIELDS = ("label", "node_type")
+
+    DEFAULT_MAX_VIOLATIONS = 1000
+    MAX_VIOLATIONS = 100000
+
+    def __init__(self, graph_db: Optional[GraphDB] = None):
+        """
+        Initialize shape validation service
+
+        Args:
+            graph_db: Graph holding the ontology; its node types start
+                being counted here (a one-time scan)
+        """
+        super().__init__()
+        self.graph = graph_db or GraphDB()
+        self.graph.count_values("node_type")
+        self._compiled: Optional[_Compiled] = None
+        self._lock = threading.Lock()
+
+    # ========================================================================
+    # Validation
+    # ========================================================================
+
+    def validate(self, instances: Sequence[OntologyInstance], threads: int = 0,
+                 max_violations: int = DEFAULT_MAX_VIOLATIONS) -> ShapeReport:
+        """
+        Validate a batch of instances (stored or not)
+
+        Object property values naming an instance of the batch refer to it;
+        other names are looked up among the graph's instances.
+
+        Args:
+            instances: Instances to check
+            threads: Worker threads (0 = one per CPU)
+            max_violations: Violations listed in the report (all are counted)
+
+        Returns:
+            ShapeReport with violations in instance order
+
+        Raises:
+            ValidationError: If max_violations is out of range
+        """
+        self._check_limit(max_violations)
+        with self.graph.snapshot():
+            compiled = self._program()
+            report = self._check(compiled, list(instances), threads, max_violations)
+        self._log_operation("validate_shapes", instances=report.checked,
+                            violations=report.total_violations)
+        return report
+
+    def validate_graph(self, threads: int = 0,
+                       max_violations: int = DEFAULT_MAX_VIOLATIONS) -> ShapeReport:
+        """
+        Validate every instance stored in the graph
+
+        Raises:
+            ValidationError: If max_violations is out of range
+        """
+        self._check_limit(max_violations)
+        with self.graph.snapshot():
+            compiled = self._program()
+            ids = self.graph.get_all_nodes()
+            stored = [(node_id, data) for node_id, data in zip(ids, self.graph.get_nodes(ids))
+                      if data and data.get('node_type') == self.INSTANCE_TYPE]
+            types = self._targets(self.TYPE_RELATION, [node_id for node_id, _ in stored])
+            instances = [
+                OntologyInstance(
+                    id=node_id, label=data.get('label', node_id), class_ids=classes,
+                    properties={k: v for k, v in data.items() if k not in self.RESERVED_FIELDS},
+                )
+                for (node_id, data), classes in zip(stored, types)
+            ]
+            report = self._check(compiled, instances, threads, max_violations)
+        self._log_operation("validate_graph_shapes", instances=report.checked,
+                            violations=report.total_violations)
+        return report
+
+    def _check_limit(self, max_violations: int):
+        if not 0 <= max_violations <= self.MAX_VIOLATIONS:
+            raise ValidationError(
+                f"max_violations must be between 0 and {self.MAX_VIOLATIONS}")
+
+    def _check(self, compiled: _Compiled, instances: List[OntologyInstance],
+               threads: int, max_violations: int) -> ShapeReport:
+        batch_index = {inst.id: i for i, inst in enumerate(instances)}
+        external: Dict[str, int] = {}
+        entity_types: List[List[int]] = []
+        values: List[List[shapes.Value]] = []
+
+        for inst in instances:
+            classes = [compiled.classes.get(c, compiled.unknown_class) for c in inst.class_ids]
+            entity_types.append(classes)
+            row = []
+            for key, raw in inst.properties.items():
+                prop = compiled.properties.get(key)
+                if prop is None:
+                    continue
+                for item in raw if isinstance(raw, (list, tuple)) else (raw,):
+                    if item is None:
+                        continue
+                    if isinstance(item, str) and key in compiled.references:
+                        target = batch_index.get(item)
+                        if target is None:
+                            target = external.setdefault(item, len(instances) + len(external))
+                        row.append((prop, shapes.REF, item, target))
+                    else:
+                        row.append((prop, *self._literal(item), shapes.SHP_NONE))
+            values.append(row)
+
+        # Referred-to instances outside the batch; unknown names have no class
+        names = list(external)
+        stored = self.graph.get_nodes(names)
+        found = [name for name, data in zip(names, stored)
+                 if data and data.get('node_type') == self.INSTANCE_TYPE]
+        found_types = dict(zip(found, self._targets(self.TYPE_RELATION, found)))
+        for name in names:
+            entity_types.append([compiled.classes[c] for c in found_types.get(name, ())
+                                 if c in compiled.classes])
+
+        batch = ShapeBatch(entity_types, values)
+        found_violations, stats = compiled.program.validate(batch, threads, max_violations)
+        return ShapeReport(
+            checked=len(instances),
+            invalid=stats['invalid'],
+            total_violations=stats['violations'],
+            violations=[self._describe(compiled, batch, instances[i], rule, value, count)
+                        for i, rule, value, count in found_violations],
+            threads=stats['threads'],
+        )
+
+    @staticmethod
+    def _literal(item: Any) -> Tuple[int, str]:
+        """(kind, lexical form) of a literal value"""
+        if isinstance(item, str):
+            return shapes.STRING, item
+        if isinstance(item, bool):
+            return shapes.BOOLEAN, "true" if item else "false"
+        if isinstance(item, int):
+            return shapes.INTEGER, str(item)
+        if isinstance(item, float):
+            return shapes.NUMBER, repr(item)
+        if isinstance(item, (dict, list)):
+            return shapes.STRING, json.dumps(item, sort_keys=True)
+        return shapes.STRING, str(item)
+
+    def _describe(self, compiled: _Compiled, batch: ShapeBatch, inst: OntologyInstance,
+                  rule_id: int, value: int, count: int) -> ShapeViolation:
+        rule = compiled.rules[rule_id]
+        text = batch.value(value)[1] if value != shapes.SHP_NONE else None
+        if rule.constraint == "class":
+            unknown = [c for c in inst.class_ids if c not in compiled.classes]
+            return ShapeViolation(inst.id, None, "class",
+                                  f"Unknown class '{', '.join(unknown)}'")
+        if rule.constraint == "min_count":
+            if rule.arg == 1:
+                inherited = rule.class_id is not None and rule.class_id not in inst.class_ids
+                source = f" (inherited from {self._label(rule.class_id)})" if inherited else ""
+                message = f"Missing required property '{rule.label}'{source}"
+            else:
+                message = f"'{rule.label}' needs at least {rule.arg} values, found {count}"
+        elif rule.constraint == "max_count":
+            message = (f"'{rule.label}' allows at most {rule.arg} "
+                       f"value{'s' if rule.arg != 1 else ''}, found {count}")
+        elif rule.constraint == "datatype":
+            message = f"Value '{text}' of '{rule.label}' is not a valid {' or '.join(rule.arg)}"
+        else:
+            message = (f"Value '{text}' of '{rule.label}' is not an instance of "
+                       f"{' or '.join(rule.arg)}")
+        return ShapeViolation(inst.id, rule.property_id, rule.constraint, message,
+                              class_id=rule.class_id, value=text)
+
+    def _label(self, node_id: str) -> str:
+        data = self.graph.get_nodes([node_id])[0]
+        return (data or {}).get('label', node_id)
+
+    # ========================================================================
+    # Compilation
+    # ========================================================================
+
+    def _schema_key(self) -> Tuple:
+        """
+        Changes whenever a class, property or schema edge is written
+
+        Write counts and layer versions start over when the graph is
+        cleared or reimported, so the graph generation is part of it.
+        """
+        writes = self.graph.value_writes("node_type")
+        layers = []
+        for label in (self.SUBCLASS_RELATION, self.DOMAIN_RELATION, self.RANGE_RELATION):
+            try:
+                with self.graph.topology_view(label) as view:
+                    layers.append(view.version)
+            except KeyError:
+                layers.append(None)
+        return (self.graph.generation(), writes.get(self.CLASS_TYPE, 0),
+                writes.get(self.PROPERTY_TYPE, 0), *layers)
+
+    def _program(self) -> _Compiled:
+        """The compiled program for the current schema (call in a snapshot)"""
+        key = self._schema_key()
+        compiled = self._compiled
+        if compiled is None or compiled.key != key:
+            compiled = self._compile(key)
+            with self._lock:
+                self._compiled = compiled
+        return compiled
+
+    def _targets(self, label: str, node_ids: List[str]) -> List[List[str]]:
+        """Out-neighbors of each node in one edge layer"""
+        try:
+            view = self.graph.topology_view(label)
+        except KeyError:
+            return [[] for _ in node_ids]
+        with view:
+            lists = []
+            for node_id in node_ids:
+                tid = self.graph.topology_id(node_id)
+                lists.append(view.neighbors(tid) if tid is not None else [])
+        names = iter(self.graph.topology_names([t for targets in lists for t in targets]))
+        return [[next(names) for _ in targets] for targets in lists]
+
+    def _compile(self, key: Tuple) -> _Compiled:
+        ids = self.graph.get_all_nodes()
+        nodes = list(zip(ids, self.graph.get_nodes(ids)))
+        class_ids = [n for n, d in nodes if d and d.get('node_type') == self.CLASS_TYPE]
+        props = [(n, d) for n, d in nodes if d and d.get('node_type') == self.PROPERTY_TYPE]
+        classes = {c: i for i, c in enumerate(class_ids)}
+
+        # One extra class for instances typed with an unknown class
+        unknown_class = len(class_ids)
+        program = ShapeProgram(len(class_ids) + 1)
+        for cls, parents in zip(class_ids, self._targets(self.SUBCLASS_RELATION, class_ids)):
+            for parent in parents:
+                if parent in classes:
+                    program.add_parent(classes[cls], classes[parent])
+
+        prop_ids = [p for p, _ in props]
+        domains = self._targets(self.DOMAIN_RELATION, prop_ids)
+        ranges = self._targets(self.RANGE_RELATION, prop_ids)
+        properties: Dict[str, int] = {}
+        references: Set[str] = set()
+        rules: List[_Rule] = []
+
+        def add(cls: Optional[str], op: int, prop_id: str, label: str, constraint: str,
+                arg: Any, native_arg: int):
+            prop = properties.setdefault(prop_id, len(properties))
+            native_cls = shapes.SHP_ALL if cls is None else classes[cls]
+            program.add_rule(native_cls, op, prop, native_arg)
+            rules.append(_Rule(cls, prop_id, label, constraint, arg))
+
+        for (prop_id, data), domain, range_ids in zip(props, domains, ranges):
+            label = data.get('label', prop_id)
+            owners = [c for c in domain if c in classes] or [None]
+            low = max(1 if data.get('required') else 0, data.get('min_cardinality') or 0)
+            high = data.get('max_cardinality')
+            if "functional" in (data.get('characteristics') or "").split(","):
+                high = 1 if high is None else min(high, 1)
+            for owner in owners:
+                if low > 0:
+                    add(owner, shapes.MIN_COUNT, prop_id, label, "min_count", low, low)
+                if high is not None:
+                    add(owner, shapes.MAX_COUNT, prop_id, label, "max_count", high, high)
+
+            kind = data.get('property_type', 'object')
+            datatypes = [d for d in (data.get('datatype_range') or "").split(",") if d]
+            mask = _xsd_mask(datatypes) if datatypes else 0
+            if kind != 'object' and mask:
+                add(None, shapes.DATATYPE, prop_id, label, "datatype", datatypes, mask)
+            range_classes = [c for c in range_ids if c in classes]
+            if kind == 'object' and range_classes:
+                class_set = program.add_class_set(classes[c] for c in range_classes)
+                add(None, shapes.RANGE, prop_id, label, "range", range_classes, class_set)
+                references.add(prop_id)
+
+        # Nothing ever has a value of the reserved property, so this rule
+        # flags every instance of the unknown class
+        program.add_rule(unknown_class, shapes.MIN_COUNT, len(properties), 1)
+        rules.append(_Rule(None, None, "", "class", 1))
+        program.compile()
+
+        self._log_debug("compile_shapes", classes=len(class_ids), rules=len(rules),
+                        flat_rules=program.flat_rules)
+        return _Compiled(key, program, classes, properties, references, rules, unknown_class)
@@ -0,0 +1,171 @@
+"""
+Symptom Service
+
+Dictionary symptom extraction from free text (see src/core/text_match.h):
+symptom labels and synonyms from the medical ontology are compiled into
+one Aho-Corasick automaton, so a description is matched in microseconds
+instead of a round trip through the LLM. Negated mentions ("no fever")
+are reported separately, misspellings are caught by a bounded fuzzy
+match, and a coverage score tells the caller when the text says more
+than the dictionary understood and the LLM is still worth asking.
+"""
+
+import re
+from typing import Any, Dict, List, Optional
+from src.adapters.text_match import PhraseDict, TM_NEGATION, TM_TERMINATOR
+from src.services.base_service import BaseService, ValidationError
+from src.services.models import SymptomExtraction
+
+
+class SymptomService(BaseService):
+    """
+    Service for extracting symptoms from free text
+
+    Handles:
+    - Compiling symptom labels and synonyms into a native matcher
+    - Negation and fuzzy matching
+    - Deciding when dictionary coverage is too low to skip the LLM
+    """
+
+    # Below this share of content words explained, ask the LLM as well
+    MIN_COVERAGE = 0.6
+    MAX_EDITS = 1
+    NEGATION_WINDOW = 5
+
+    NEGATION_CUES = (
+        "no", "not", "never", "without", "denies", "denied", "deny",
+        "negative for", "free of", "absence of", "no signs of", "no sign of",
+        "dont", "doesnt", "didnt", "isnt", "havent", "hasnt", "hadnt", "wasnt",
+    )
+    TERMINATORS = (
+        "but", "however", "although", "though", "except", "apart from",
+        "aside from", "yet", "still",
+    )
+    # Words that carry no symptom information; ignored for coverage
+    STOPWORDS = frozenset("""
+        a an the and or of to in on at for with from by as is are was were be been
+        being am have has had having do does did i im ive me my mine we our you your
+        he she his her they them their it its this that these those some any very
+        really quite bit little lot lots also too so just since ago about like
+        feel feeling feels felt get getting got keep keeps kept started start
+        starting today yesterday tonight morning evening night week weeks day days
+        hour hours month months last past now again all over both bad badly mild
+        severe slight slightly constant constantly sometimes often kind sort
+        think maybe pretty much more most lately recently patient reports
+        complains presents presenting symptoms symptom one two three four five
+        six seven eight nine ten few several
+    """.split()) | frozenset(w for w in NEGATION_CUES + TERMINATORS if " " not in w)
+
+    _TOKEN = re.compile(r"[A-Za-z0-9\u0080-\U0010FFFF']+")
+
+    def __init__(self, symptoms: Dict[str, Dict[str, Any]]):
+        """
+        Initialize symptom service
+
+        Args:
+            symptoms: Symptom ID -> {'label': str, 'synonyms': [str, ...]}
+        """
+        super().__init__()
+        self._ids: List[str] = []
+        self._labels: List[str] = []
+        self._dict = PhraseDict()
+        for symptom_id, info in symptoms.items():
+            value = len(self._ids)
+            self._ids.append(symptom_id)
+            self._labels.append(info.get('label') or symptom_id)
+            for phrase in [info.get('label')] + list(info.get('synonyms') or []):
+                if phrase:
+                    self._dict.add(phrase, value)
+        for cue in self.NEGATION_CUES:
+            self._dict.add(cue, 0, TM_NEGATION)
+        for word in self.TERMINATORS:
+            self._dict.add(word, 0, TM_TERMINATOR)
+        self._dict.build()
+        self._log_debug(f"SymptomService compiled {self._dict.phrase_count} phrases "
+                        f"into {self._dict.state_count} states")
+
+    @classmethod
+    def from_ontology(cls, ttl_path: str) -> "SymptomService":
+        """
+        Build from the med:Symptom individuals of a Turtle ontology
+        (med:id, rdfs:label and med:synonym)
+        """
+        from rdflib import Graph as RDFGraph, Namespace, RDF, RDFS
+
+        g = RDFGraph()
+        g.parse(ttl_path, format='turtle')
+        MED = Namespace('http://wally.io/medical#')
+        symptoms = {}
+        for s in g.subjects(RDF.type, MED.Symptom):
+            symptom_id = next(g.objects(s, MED.id), None)
+            label = next(g.objects(s, RDFS.label), None)
+            if not symptom_id or not label:
+                continue
+            symptoms[str(symptom_id)] = {
+                'label': str(label),
+                'synonyms': sorted(str(v) for v in g.objects(s, MED.synonym)),
+            }
+        return cls(symptoms)
+
+    # ========================================================================
+    # EXTRACTION
+    # ========================================================================
+
+    def extract(self, text: str, max_edits: Optional[int] = None) -> SymptomExtraction:
+        """
+        Symptoms mentioned in free text
+
+        Args:
+            text: Patient description
+            max_edits: Typos tolerated per phrase (0 = exact only; default
+                MAX_EDITS)
+
+        Returns:
+            SymptomExtraction: present and negated symptoms in text order
+            (each once), coverage and whether the LLM should still be asked
+
+        Raises:
+            ValidationError: If text is not a non-empty string
+        """
+        if not isinstance(text, str) or not text.strip():
+            raise ValidationError("Text must be a non-empty string")
+        if max_edits is None:
+            max_edits = self.MAX_EDITS
+        if max_edits < 0:
+            raise ValidationError("max_edits must be non-negative")
+
+        matches, _stats = self._dict.scan(text, max_edits=max_edits,
+                                          negation_window=self.NEGATION_WINDOW)
+        present, negated = {}, {}
+        for match in matches:
+            entry = {
+                'id': self._ids[match['value']],
+                'label': self._labels[match['value']],
+                'text': match['text'],
+                'start': match['start'],
+                'end': match['end'],
+                'fuzzy': match['fuzzy'],
+            }
+            (negated if match['negated'] else present).setdefault(entry['id'], entry)
+        # A symptom mentioned both ways counts as present
+        negated = [entry for symptom_id, entry in negated.items() if symptom_id not in present]
+        present = list(present.values())
+
+        coverage = self._coverage(text, matches)
+        self._log_operation("extract_symptoms", found=len(present), negated=len(negated))
+        return SymptomExtraction(
+            symptoms=present, negated=negated, coverage=coverage,
+            needs_llm=not (present or negated) or coverage < self.MIN_COVERAGE,
+        )
+
+    def _coverage(self, text: str, matches: List[Dict[str, Any]]) -> float:
+        """Share of content words (not stopwords) inside a match"""
+        spans = [(m['start'], m['end']) for m in matches]
+        content = covered = 0
+        for token in self._TOKEN.finditer(text):
+            word = token.group().replace("'", "").lower()
+            if not word or word.isdigit() or word in self.STOPWORDS:
+                continue
+            content += 1
+            covered += any(s <= token.start() < e for s, e in spans)
+        return covered / content if content else 1.0
@@ -12,6 +12,7 @@ from datetime import datetime
 from typing import Dict, List, Optional, Any
 from dataclasses import dataclass, asdict
 from pathlib import Path
+from src.services.parallel_test_service import ShardedTestRunner
 
 
 @dataclass
@@ -176,6 +177,79 @@ class TestExecutionService:
         
         return result
     
+    def run_tests_parallel(
+        self,
+        layer: Optional[str] = None,
+        test_path: Optional[str] = None,
+        workers: Optional[int] = None,
+        on_result=None,
+    ) -> TestRunResult:
+        """
+        Run tests sharded across worker processes
+        
+        Shards are balanced by the durations recorded in recent run
+        summaries.  Results are merged into one TestRunResult.
+        
+        Args:
+            layer: Layer to test (None for all)
+            test_path: Path to test file or directory (overrides layer)
+            workers: Worker process count (defaults to the CPU count)
+            on_result: Called with each result record as it finishes
+            
+        Returns:
+            TestRunResult with execution results
+        """
+        if test_path:
+            prefix, selection = "path", [test_path]
+        elif layer:
+            prefix, selection = layer, ["-m", layer]
+        else:
+            prefix, selection = "all", ["tests/"]
+        run_id = f"{prefix}_{datetime.utcnow().strftime('%Y%m%d_%H%M%S')}"
+        
+        runner = ShardedTestRunner(self.workspace_root, workers)
+        start_time = datetime.utcnow()
+        records = runner.run(selection, durations=self._historical_durations, on_result=on_result)
+        duration = (datetime.utcnow() - start_time).total_seconds()
+        
+        test_results = [
+            TestResult(
+                test_id=r['nodeid'],
+                name=r['nodeid'].split('::')[-1],
+                status=r['outcome'] if r['outcome'] in ('passed', 'failed', 'skipped') else 'error',
+                duration=r['duration'],
+                error_message=r['longrepr'] if r['outcome'] != 'passed' else None,
+                layer=layer,
+            )
+            for r in records
+        ]
+        
+        result = TestRunResult(
+            run_id=run_id,
+            timestamp=datetime.utcnow().isoformat(),
+            total=len(test_results),
+            passed=sum(t.status == 'passed' for t in test_results),
+            failed=sum(t.status == 'failed' for t in test_results),
+            skipped=sum(t.status == 'skipped' for t in test_results),
+            errors=sum(t.status == 'error' for t in test_results),
+            duration=duration,
+            layer=layer or ("all" if not test_path else None),
+            test_results=test_results
+        )
+        self._save_summary(result)
+        
+        return result
+    
+    def _historical_durations(self, test_ids: List[str], runs: int = 10) -> Dict[str, float]:
+        """Latest recorded duration of each test over the last few runs"""
+        wanted = set(test_ids)
+        durations = {}
+        for run in self.get_test_history(limit=runs):
+            for test in run.test_results:
+                if test.test_id in wanted and test.test_id not in durations:
+                    durations[test.test_id] = test.duration
+        return durations
+    
     def _parse_json_report(self, run_id: str, layer: Optional[str], duration: float) -> TestRunResult:
         """Parse pytest JSON report"""
         report_path = os.path.join(self.results_dir, f"{run_id}.json")
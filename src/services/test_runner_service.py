@@ -10,11 +10,14 @@ import json
 import pytest
 import sys
 from pathlib import Path
-from datetime import datetime
+from datetime import datetime, timedelta
 from typing import Dict, List, Optional, Any
 from dataclasses import dataclass, asdict
 import sqlite3
+import threading
 from enum import Enum
+from src.adapters.ts_store import TimeSeriesStore, STATUSES, DAY_MS, to_ms
+from src.services.parallel_test_service import ShardedTestRunner, TestJob, TestJobManager
 
 
 class TestStatus(Enum):
@@ -58,11 +61,19 @@ class TestSuite:
 
 
 class TestResultsDB:
-    """Persistent storage for test results using SQLite"""
+    """
+    Persistent storage for test results using SQLite
+
+    Rows live in SQLite; trend and layer-stat queries are served from an
+    in-memory time-series index (one series per layer, day blocks), built
+    from SQLite on first use and appended to on every save.
+    """
     
     def __init__(self, db_path: str = "test_results.db"):
         """Initialize test results database"""
         self.db_path = db_path
+        self._series: Optional[TimeSeriesStore] = None
+        self._series_lock = threading.Lock()
         self._init_db()
     
     def _init_db(self):
@@ -166,8 +177,50 @@ class TestResultsDB:
                     result.error_message,
                     result.timestamp
                 ))
+                self._index_result(cursor.lastrowid, result.layer, result.status,
+                                   result.duration, result.timestamp)
             conn.commit()
     
+    # ------------------------------------------------------------------
+    # Time-series index
+    # ------------------------------------------------------------------
+    
+    def _series_index(self) -> TimeSeriesStore:
+        """The layer index, backfilled from SQLite in timestamp order."""
+        with self._series_lock:
+            if self._series is None:
+                store = TimeSeriesStore(DAY_MS)
+                with sqlite3.connect(self.db_path) as conn:
+                    rows = conn.execute("""
+                        SELECT id, layer, status, duration, timestamp
+                        FROM test_results ORDER BY timestamp, id
+                    """)
+                    for row_id, layer, status, duration, timestamp in rows:
+                        self._append_point(store, row_id, layer, status, duration, timestamp)
+                self._series = store
+            return self._series
+    
+    def _index_result(self, row_id: int, layer: str, status: str,
+                      duration: Optional[float], timestamp: str):
+        """Append a saved row to the index if it has been built."""
+        with self._series_lock:
+            if self._series is None:
+                return
+            if not self._append_point(self._series, row_id, layer, status, duration, timestamp):
+                self._series = None     # out-of-order row: rebuild on next query
+    
+    @staticmethod
+    def _append_point(store: TimeSeriesStore, row_id: int, layer: str, status: str,
+                      duration: Optional[float], timestamp: str) -> bool:
+        if status not in STATUSES:
+            status = 'error'
+        return store.append(f"layer:{layer}", to_ms(timestamp), status,
+                            duration or 0.0, row_id)
+    
+    @staticmethod
+    def _cutoff_ms(days: int) -> int:
+        return to_ms(datetime.utcnow() - timedelta(days=days))
+    
     def get_latest_suite(self) -> Optional[Dict]:
         """Get latest test suite execution"""
         with sqlite3.connect(self.db_path) as conn:
@@ -204,22 +257,30 @@ class TestResultsDB:
             """, (test_id, limit))
             return [dict(row) for row in cursor.fetchall()]
     
+    def get_test_durations(self, test_ids: List[str]) -> Dict[str, float]:
+        """Average recorded duration (seconds) of each test that has history"""
+        wanted = set(test_ids)
+        with sqlite3.connect(self.db_path) as conn:
+            rows = conn.execute("""
+                SELECT test_id, AVG(duration) FROM test_results
+                WHERE status != 'skipped' AND duration IS NOT NULL
+                GROUP BY test_id
+            """)
+            return {test_id: avg for test_id, avg in rows if test_id in wanted}
+    
     def get_layer_stats(self, layer: str, days: int = 30) -> Dict:
         """Get statistics for a specific layer"""
-        with sqlite3.connect(self.db_path) as conn:
-            conn.row_factory = sqlite3.Row
-            cursor = conn.cursor()
-            cursor.execute("""
-                SELECT 
-                    COUNT(*) as total,
-                    SUM(CASE WHEN status = 'passed' THEN 1 ELSE 0 END) as passed,
-                    SUM(CASE WHEN status = 'failed' THEN 1 ELSE 0 END) as failed,
-                    AVG(duration) as avg_duration
-                FROM test_results
-                WHERE layer = ? 
-                AND timestamp >= datetime('now', '-' || ? || ' days')
-            """, (layer, days))
-            return dict(cursor.fetchone())
+        buckets = self._series_index().summarize(
+            f"layer:{layer}", start=self._cutoff_ms(days), bucket_ms=DAY_MS)
+        total = sum(b['count'] for b in buckets)
+        if total == 0:
+            return {'total': 0, 'passed': None, 'failed': None, 'avg_duration': None}
+        return {
+            'total': total,
+            'passed': sum(b['status_counts']['passed'] for b in buckets),
+            'failed': sum(b['status_counts']['failed'] for b in buckets),
+            'avg_duration': sum(b['duration_sum'] for b in buckets) / total,
+        }
     
     def get_all_suites(self, limit: int = 50) -> List[Dict]:
         """Get all test suite executions"""
@@ -233,40 +294,30 @@ class TestResultsDB:
             return [dict(row) for row in cursor.fetchall()]
     
     def get_trends(self, layer: Optional[str] = None, days: int = 30) -> List[Dict]:
-        """Get test trends over time"""
-        with sqlite3.connect(self.db_path) as conn:
-            conn.row_factory = sqlite3.Row
-            cursor = conn.cursor()
-            
-            if layer:
-                cursor.execute("""
-                    SELECT 
-                        DATE(timestamp) as date,
-                        layer,
-                        COUNT(*) as total_tests,
-                        ROUND(AVG(CASE WHEN status = 'passed' THEN 100.0 ELSE 0 END), 2) as pass_rate,
-                        ROUND(AVG(duration), 4) as avg_duration
-                    FROM test_results
-                    WHERE layer = ? 
-                    AND timestamp >= datetime('now', '-' || ? || ' days')
-                    GROUP BY DATE(timestamp), layer
-                    ORDER BY date DESC
-                """, (layer, days))
-            else:
-                cursor.execute("""
-                    SELECT 
-                        DATE(timestamp) as date,
-                        layer,
-                        COUNT(*) as total_tests,
-                        ROUND(AVG(CASE WHEN status = 'passed' THEN 100.0 ELSE 0 END), 2) as pass_rate,
-                        ROUND(AVG(duration), 4) as avg_duration
-                    FROM test_results
-                    WHERE timestamp >= datetime('now', '-' || ? || ' days')
-                    GROUP BY DATE(timestamp), layer
-                    ORDER BY date DESC, layer
-                """, (days,))
-            
-            return [dict(row) for row in cursor.fetchall()]
+        """
+        Get test trends over time (one row per day and layer, newest first)
+
+        Whole days come from the index's per-block summaries, so the cost
+        depends on the number of days, not the number of stored results.
+        """
+        index = self._series_index()
+        series = [f"layer:{layer}"] if layer else index.series("layer:")
+        cutoff = self._cutoff_ms(days)
+        
+        trends = []
+        for name in series:
+            for bucket in index.summarize(name, start=cutoff, bucket_ms=DAY_MS):
+                trends.append({
+                    'date': datetime.utcfromtimestamp(bucket['start'] / 1000).date().isoformat(),
+                    'layer': name[len("layer:"):],
+                    'total_tests': bucket['count'],
+                    'pass_rate': round(bucket['pass_rate'], 2),
+                    'avg_duration': round(bucket['duration_avg'], 4),
+                })
+        
+        trends.sort(key=lambda t: t['layer'])
+        trends.sort(key=lambda t: t['date'], reverse=True)
+        return trends
 
 
 class TestRunnerService:
@@ -282,6 +333,7 @@ class TestRunnerService:
         self.project_root = project_root or Path.cwd()
         self.tests_dir = self.project_root / "tests"
         self.db = TestResultsDB()
+        self.jobs = TestJobManager()
         
         # Layer definitions
         self.layers = {
@@ -342,15 +394,7 @@ class TestRunnerService:
         suite_id = f"suite_{datetime.now().strftime('%Y%m%d_%H%M%S')}_{uuid.uuid4().hex[:8]}"
         
         # Determine what to run
-        if test_file:
-            suite_name = f"File: {test_file}"
-            args = [test_file]
-        elif layer:
-            suite_name = f"Layer: {layer}"
-            args = ["-m", self.layers[layer]["marker"]]
-        else:
-            suite_name = "All Tests"
-            args = ["tests/"]
+        suite_name, args = self._selection(layer, test_file)
         
         # Create custom plugin to capture results
         class ResultCollector:
@@ -389,12 +433,6 @@ class TestRunnerService:
         # Parse results from collector
         test_results = self._parse_collected_results(collector.results, layer or "all")
         
-        # Calculate summary
-        passed = sum(1 for r in test_results if r.status == "passed")
-        failed = sum(1 for r in test_results if r.status == "failed")
-        skipped = sum(1 for r in test_results if r.status == "skipped")
-        errors = sum(1 for r in test_results if r.status == "error")
-        
         # Get coverage if available
         coverage_pct = None
         if coverage:
@@ -404,15 +442,97 @@ class TestRunnerService:
                     cov_data = json.load(f)
                     coverage_pct = cov_data.get("totals", {}).get("percent_covered")
         
-        # Create suite summary
+        return self._save_suite(suite_id, suite_name, test_results, duration, coverage_pct)
+    
+    def start_tests(
+        self,
+        layer: Optional[str] = None,
+        test_file: Optional[str] = None,
+        workers: Optional[int] = None,
+        coverage: bool = False
+    ) -> TestJob:
+        """
+        Run tests sharded across worker processes, in the background
+        
+        Shards are balanced by each test's stored average duration.  Poll
+        the returned job (or get_job) for progress; when it completes its
+        result is the saved suite as a dict.
+        
+        Coverage cannot be merged across shards, so a coverage run executes
+        in-process through run_tests instead (no per-test progress).
+        
+        Args:
+            layer: Specific layer to test (None for all)
+            test_file: Specific test file (overrides layer)
+            workers: Worker process count (defaults to the CPU count)
+            coverage: Whether to collect coverage data
+            
+        Returns:
+            The submitted TestJob
+            
+        Raises:
+            ValueError: If workers is not a positive integer
+        """
+        import uuid
+        
+        if workers is not None and (isinstance(workers, bool) or not isinstance(workers, int)
+                                    or workers < 1):
+            raise ValueError(f"workers must be a positive integer, got {workers!r}")
+        
+        suite_name, args = self._selection(layer, test_file)
+        
+        if coverage:
+            return self.jobs.submit(suite_name, lambda job: asdict(
+                self.run_tests(layer=layer, test_file=test_file, coverage=True)))
+        
+        def work(job: TestJob) -> Dict:
+            suite_id = f"suite_{datetime.now().strftime('%Y%m%d_%H%M%S')}_{uuid.uuid4().hex[:8]}"
+            runner = ShardedTestRunner(self.project_root, workers)
+            
+            start_time = datetime.now()
+            records = runner.run(
+                args,
+                durations=self.db.get_test_durations,
+                on_collected=job.set_total,
+                on_result=job.record,
+            )
+            duration = (datetime.now() - start_time).total_seconds()
+            
+            test_results = self._parse_collected_results(records, layer or "all")
+            return asdict(self._save_suite(suite_id, suite_name, test_results, duration))
+        
+        return self.jobs.submit(suite_name, work)
+    
+    def get_job(self, job_id: str) -> Optional[Dict]:
+        """Progress (and, once finished, result) of a background test job"""
+        job = self.jobs.get(job_id)
+        return job.to_dict() if job else None
+    
+    def _selection(self, layer: Optional[str], test_file: Optional[str]):
+        """Suite name and pytest arguments for a layer / file choice"""
+        if test_file:
+            return f"File: {test_file}", [test_file]
+        if layer:
+            return f"Layer: {layer}", ["-m", self.layers[layer]["marker"]]
+        return "All Tests", ["tests/"]
+    
+    def _save_suite(
+        self,
+        suite_id: str,
+        suite_name: str,
+        test_results: List[TestResult],
+        duration: float,
+        coverage_pct: Optional[float] = None
+    ) -> TestSuite:
+        """Summarize results into a suite and save both"""
         suite = TestSuite(
             suite_id=suite_id,
             suite_name=suite_name,
             total_tests=len(test_results),
-            passed=passed,
-            failed=failed,
-            skipped=skipped,
-            errors=errors,
+            passed=sum(1 for r in test_results if r.status == "passed"),
+            failed=sum(1 for r in test_results if r.status == "failed"),
+            skipped=sum(1 for r in test_results if r.status == "skipped"),
+            errors=sum(1 for r in test_results if r.status == "error"),
             duration=duration,
             timestamp=datetime.now().isoformat(),
             coverage=coverage_pct
@@ -2,12 +2,18 @@
 Test Storage Service
 
 Persists test results to database for historical tracking and analysis.
+
+Run details are JSON documents in SimpleDB; the time dimension (history,
+trends, retention) is a TimeSeriesStore with one point per run and per
+test result, so trend queries read day-block summaries instead of
+deserializing every run.
 """
 
 import json
-from datetime import datetime
+from datetime import datetime, timedelta
 from typing import List, Dict, Optional, Any
 from src.adapters.simple_db import SimpleDB
+from src.adapters.ts_store import TimeSeriesStore, STATUSES, DAY_MS, to_ms
 from src.services.test_execution_service import TestResult, TestRunResult
 
 
@@ -24,16 +30,20 @@ class TestStorageService:
             db_path: Path to the database file (used for naming, SimpleDB is in-memory)
         """
         self.db = SimpleDB()
+        self.series = TimeSeriesStore(DAY_MS)
         self.db_path = db_path  # Store for reference but SimpleDB is in-memory
         self._init_schema()
     
     def _init_schema(self):
         """Initialize database structure"""
-        # Store test runs as JSON
-        # Key format: run:{run_id}
-        # Key format: run_index:{timestamp} -> run_id
-        # Key format: layer:{layer}:latest -> run_id
-        # Key format: stats:total_runs -> count
+        # SimpleDB keys:
+        #   run:{run_id}          -> run JSON (with its test results)
+        #   run_seq:{seq}         -> run_id (seq is the series point ref)
+        #   layer:{layer}:latest  -> run_id
+        #   stats:total_runs      -> count
+        # Time series (ts = run / test timestamp, ref = run seq):
+        #   runs, runs:{layer}    -> one point per run (passed = no failures)
+        #   tests, tests:{layer}  -> one point per test result
         pass
     
     def store_test_run(self, result: TestRunResult):
@@ -47,22 +57,58 @@ class TestStorageService:
         run_key = f"run:{result.run_id}"
         self.db.set(run_key, json.dumps(self._serialize_result(result)))
         
-        # Index by timestamp
-        index_key = f"run_index:{result.timestamp}"
-        self.db.set(index_key, result.run_id)
-        
-        # Update latest for layer
-        if result.layer:
-            layer_key = f"layer:{result.layer}:latest"
-            self.db.set(layer_key, result.run_id)
+        # Update statistics; the run count doubles as the run's sequence number
+        seq = self._update_stats(result)
+        self.db.set(f"run_seq:{seq}", result.run_id)
         
-        # Update statistics
-        self._update_stats(result)
+        # Index the run and its test results in time; series are append-only,
+        # so a run older than the newest indexed one forces a rebuild
+        if self._index_run(self.series, result, seq):
+            if result.layer:
+                layer_key = f"layer:{result.layer}:latest"
+                self.db.set(layer_key, result.run_id)
+        else:
+            self._rebuild_index()
+    
+    @staticmethod
+    def _index_run(series: TimeSeriesStore, result: TestRunResult, seq: int) -> bool:
+        """Append a run's points; False if any series rejected one as out of order"""
+        ts = to_ms(result.timestamp)
+        suffixes = ["", f":{result.layer}"] if result.layer else [""]
+        run_status = 'passed' if result.failed + result.errors == 0 else 'failed'
+        ok = True
+        for suffix in suffixes:
+            ok &= series.append(f"runs{suffix}", ts, run_status, result.duration, seq)
         
-        # Store individual test results
         for test_result in result.test_results:
-            test_key = f"test:{result.run_id}:{test_result.test_id}"
-            self.db.set(test_key, json.dumps(self._serialize_test(test_result)))
+            status = test_result.status if test_result.status in STATUSES else 'error'
+            for suffix in suffixes:
+                ok &= series.append(f"tests{suffix}", ts, status, test_result.duration or 0.0, seq)
+        return ok
+    
+    def _rebuild_index(self):
+        """Re-index every stored run in timestamp order, and each layer's latest run"""
+        seq_keys = [key for key in self.db.keys() if key.startswith("run_seq:")]
+        seqs = [(int(key[len("run_seq:"):]), run_id)
+                for key, run_id in zip(seq_keys, self.db.mget(seq_keys)) if run_id]
+        docs = self.db.mget([f"run:{run_id}" for _, run_id in seqs])
+        
+        runs = []
+        for (seq, _), doc in zip(seqs, docs):
+            if doc:
+                run = self._deserialize_result(json.loads(doc))
+                runs.append((to_ms(run.timestamp), seq, run))
+        runs.sort(key=lambda entry: entry[:2])
+        
+        series = TimeSeriesStore(self.series.block_span)
+        latest = {}
+        for _, seq, run in runs:
+            self._index_run(series, run, seq)
+            if run.layer:
+                latest[run.layer] = run.run_id
+        self.series = series
+        for layer, run_id in latest.items():
+            self.db.set(f"layer:{layer}:latest", run_id)
     
     def get_test_run(self, run_id: str) -> Optional[TestRunResult]:
         """
@@ -111,20 +157,15 @@ class TestStorageService:
         Returns:
             List of TestRunResult objects
         """
-        # Get all run indices
-        all_keys = self.db.keys()
-        run_indices = [k for k in all_keys if k.startswith("run_index:")]
-        run_indices.sort(reverse=True)  # Most recent first
+        name = f"runs:{layer}" if layer else "runs"
+        points = self.series.latest(name, limit)
+        run_ids = self.db.mget([f"run_seq:{p['ref']}" for p in points])
         
         results = []
-        for index_key in run_indices[:limit * 2]:  # Get extra in case of filtering
-            run_id = self.db.get(index_key)
-            if run_id:
-                result = self.get_test_run(run_id)
-                if result and (layer is None or result.layer == layer):
-                    results.append(result)
-                    if len(results) >= limit:
-                        break
+        for run_id in run_ids:
+            result = self.get_test_run(run_id) if run_id else None
+            if result:
+                results.append(result)
         
         return results
     
@@ -139,18 +180,21 @@ class TestStorageService:
         Returns:
             Dictionary with trend data
         """
-        history = self.get_test_history(limit=100, layer=layer)
+        start = to_ms(datetime.utcnow() - timedelta(days=days))
+        suffix = f":{layer}" if layer else ""
+        runs = self.series.summarize(f"runs{suffix}", start=start, bucket_ms=DAY_MS)
+        tests = self.series.summarize(f"tests{suffix}", start=start, bucket_ms=DAY_MS)
         
-        # Calculate trends
-        total_runs = len(history)
-        total_passed = sum(r.passed for r in history)
-        total_failed = sum(r.failed for r in history)
-        total_tests = sum(r.total for r in history)
+        total_runs = sum(b['count'] for b in runs)
+        total_tests = sum(b['count'] for b in tests)
+        total_passed = sum(b['status_counts']['passed'] for b in tests)
+        total_failed = sum(b['status_counts']['failed'] for b in tests)
         
-        avg_success_rate = sum(r.success_rate for r in history) / total_runs if total_runs > 0 else 0
-        avg_duration = sum(r.duration for r in history) / total_runs if total_runs > 0 else 0
+        avg_success_rate = total_passed / total_tests * 100 if total_tests > 0 else 0
+        avg_duration = sum(b['duration_sum'] for b in runs) / total_runs if total_runs > 0 else 0
         
         # Get latest results
+        history = self.get_test_history(limit=1, layer=layer)
         latest = history[0] if history else None
         
         return {
@@ -162,7 +206,16 @@ class TestStorageService:
             'average_duration': round(avg_duration, 2),
             'latest_run': self._serialize_result(latest) if latest else None,
             'history_days': days,
-            'layer': layer
+            'layer': layer,
+            'daily': [
+                {
+                    'date': datetime.utcfromtimestamp(b['start'] / 1000).date().isoformat(),
+                    'total_tests': b['count'],
+                    'pass_rate': round(b['pass_rate'], 2),
+                    'avg_duration': round(b['duration_avg'], 4),
+                }
+                for b in tests
+            ],
         }
     
     def get_failing_tests(self, limit: int = 20) -> List[Dict[str, Any]]:
@@ -223,11 +276,12 @@ class TestStorageService:
             'last_updated': datetime.utcnow().isoformat()
         }
     
-    def _update_stats(self, result: TestRunResult):
-        """Update overall statistics"""
+    def _update_stats(self, result: TestRunResult) -> int:
+        """Update overall statistics; returns the new run count"""
         stats_key = "stats:total_runs"
-        current = int(self.db.get(stats_key) or "0")
-        self.db.set(stats_key, str(current + 1))
+        current = int(self.db.get(stats_key) or "0") + 1
+        self.db.set(stats_key, str(current))
+        return current
     
     def _serialize_result(self, result: TestRunResult) -> Dict:
         """Convert TestRunResult to dict for storage"""
@@ -265,32 +319,28 @@ class TestStorageService:
         """Convert dict to TestRunResult"""
         test_results = [TestResult(**t) for t in data.get('test_results', [])]
         data['test_results'] = test_results
+        data.pop('success_rate', None)  # derived property, not a field
         return TestRunResult(**data)
     
     def cleanup_old_data(self, days: int = 90):
         """
         Remove test data older than specified days
+
+        Retention works on whole day blocks: data in the day containing the
+        cutoff is kept until that day has fully aged out.
         
         Args:
             days: Number of days to retain
         """
-        cutoff = datetime.utcnow().timestamp() - (days * 86400)
-        cutoff_iso = datetime.fromtimestamp(cutoff).isoformat()
-        
-        # Get all run indices
-        all_keys = self.db.keys()
-        run_indices = [k for k in all_keys if k.startswith("run_index:")]
-        
-        for index_key in run_indices:
-            timestamp = index_key.replace("run_index:", "")
-            if timestamp < cutoff_iso:
-                run_id = self.db.get(index_key)
-                if run_id:
-                    # Delete the run
-                    self.db.delete(f"run:{run_id}")
-                    # Delete the index
-                    self.db.delete(index_key)
-                    # Delete individual test results
-                    test_keys = [k for k in all_keys if k.startswith(f"test:{run_id}:")]
-                    for test_key in test_keys:
-                        self.db.delete(test_key)
+        cutoff = to_ms(datetime.utcnow() - timedelta(days=days))
+        cutoff -= cutoff % self.series.block_span
+        
+        # Delete the detail documents of runs in the blocks about to go
+        for point in self.series.scan("runs", end=cutoff):
+            seq_key = f"run_seq:{point['ref']}"
+            run_id = self.db.get(seq_key)
+            if run_id:
+                self.db.delete(f"run:{run_id}")
+            self.db.delete(seq_key)
+        
+        self.series.drop_before(cutoff)
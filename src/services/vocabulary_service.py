@@ -0,0 +1,128 @@
+"""
+Vocabulary Service
+
+Triple-pattern queries over large vocabularies stored as compressed HDT
+files (see src/core/hdt.h). A file is converted once from Turtle, OWL or
+any other RDF syntax rdflib reads; afterwards it is memory-mapped, so
+opening costs nothing however large the vocabulary is and a query only
+touches the pages it needs, with no parsing and no in-memory graph.
+
+Terms are N-Triples strings (<iri>, "literal"@lang, _:blank) as rdflib's
+term.n3() writes them; a bare IRI in a pattern is wrapped in angle
+brackets.
+"""
+
+import os
+from typing import Dict, Iterable, Optional, Union
+from src.adapters.hdt import HDTFile, HDTWriter
+from src.services.base_service import BaseService, ValidationError
+from src.services.models import TriplePage
+
+
+class VocabularyService(BaseService):
+    """
+    Service for querying compressed RDF vocabularies
+
+    Handles:
+    - Converting RDF files to HDT
+    - Paged triple-pattern queries with match counts
+    """
+
+    DEFAULT_LIMIT = 100
+    MAX_LIMIT = 1000
+
+    def __init__(self, hdt_path: str):
+        """
+        Open a vocabulary file
+
+        Args:
+            hdt_path: HDT file written by convert
+
+        Raises:
+            FileNotFoundError: If the file does not exist
+            OSError: If it is not a readable HDT file
+        """
+        super().__init__()
+        if not os.path.exists(hdt_path):
+            raise FileNotFoundError(hdt_path)
+        self._file = HDTFile(hdt_path)
+        self.path = hdt_path
+        self._log_operation("open_vocabulary", path=hdt_path, **self._file.stats())
+
+    @staticmethod
+    def convert(sources: Union[str, Iterable[str]], hdt_path: str,
+                rdf_format: Optional[str] = None) -> Dict[str, int]:
+        """
+        Convert RDF files into one HDT file
+
+        Args:
+            sources: Input file or files
+            hdt_path: Output file (replaced)
+            rdf_format: rdflib format name (None = guessed per file from
+                its extension, .owl read as RDF/XML)
+
+        Returns:
+            File statistics (triples, dictionary sections, bytes)
+        """
+        from rdflib import Graph as RDFGraph
+        from rdflib.util import guess_format
+
+        if isinstance(sources, str):
+            sources = [sources]
+        writer = HDTWriter()
+        try:
+            for source in sources:
+                fmt = rdf_format or guess_format(source) or 'turtle'
+                graph = RDFGraph()
+                graph.parse(source, format=fmt)
+                writer.add_all((s.n3(), p.n3(), o.n3()) for s, p, o in graph)
+            return writer.save(hdt_path)
+        finally:
+            writer.close()
+
+    @staticmethod
+    def _term(value: Optional[str]) -> Optional[str]:
+        if value is None or value == '':
+            return None
+        if not isinstance(value, str):
+            raise ValidationError("Pattern terms must be strings")
+        if value.startswith(('<', '"', '_:')):
+            return value
+        return f"<{value}>"
+
+    def triples(self, subject: Optional[str] = None, predicate: Optional[str] = None,
+                obj: Optional[str] = None, limit: int = DEFAULT_LIMIT,
+                offset: int = 0) -> TriplePage:
+        """
+        Triples matching a pattern, one page at a time
+
+        Args:
+            subject, predicate, obj: Bound terms, or None for any
+            limit: Page size (1 to MAX_LIMIT)
+            offset: Matches to skip
+
+        Returns:
+            TriplePage with the total match count
+
+        Raises:
+            ValidationError: For a bad limit or offset
+        """
+        if not 1 <= limit <= self.MAX_LIMIT:
+            raise ValidationError(f"limit must be between 1 and {self.MAX_LIMIT}")
+        if offset < 0:
+            raise ValidationError("offset must not be negative")
+        s, p, o = self._term(subject), self._term(predicate), self._term(obj)
+        total = self._file.count(s, p, o)
+        rows = [{'subject': ts, 'predicate': tp, 'object': to}
+                for ts, tp, to in self._file.search(s, p, o, limit=limit, offset=offset)]
+        self._log_debug("triples", pattern=(s, p, o), total=total, returned=len(rows))
+        return TriplePage(pattern={'subject': s, 'predicate': p, 'object': o},
+                          total=total, offset=offset, triples=rows)
+
+    def stats(self) -> Dict[str, int]:
+        """Triple and term counts and the file's size"""
+        return self._file.stats()
+
+    def close(self):
+        """Unmap the vocabulary file"""
+        self._file.close()
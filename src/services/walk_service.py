@@ -0,0 +1,196 @@
+"""
+Walk Service
+
+Random-walk sampling over the graph's topology mirror (see
+src/core/walks.h): "related node" suggestions by random walk with
+restart, and walk corpora (uniform, weighted or node2vec-biased) for
+embedding and co-occurrence jobs.
+
+The native walk graph is built once per topology version and option set,
+then shared by all requests until the graph changes.
+"""
+
+import threading
+from collections import OrderedDict
+from typing import Iterable, List, Optional
+from weakref import WeakKeyDictionary
+from graph_db import GraphDB
+from src.adapters.walks import WalkGraph, RW_END
+from src.services.base_service import BaseService, NodeNotFoundError, ValidationError
+from src.services.models import RelatedNodes
+
+
+class WalkService(BaseService):
+    """
+    Service for random-walk sampling
+
+    Handles:
+    - Personalised proximity (random walk with restart) for suggestions
+    - Walk corpora mapped to node names
+    - Per-graph-version caching of the native walk graph
+    """
+
+    DEFAULT_WALKS = 20_000
+    MAX_WALKS = 1_000_000
+    CACHE_SIZE = 4
+
+    _caches: "WeakKeyDictionary[GraphDB, OrderedDict]" = WeakKeyDictionary()
+    _cache_lock = threading.Lock()
+
+    def __init__(self, graph_db: Optional[GraphDB] = None):
+        """
+        Initialize walk service
+
+        Args:
+            graph_db: GraphDB instance to walk (creates a new one if None)
+        """
+        super().__init__()
+        self.graph = graph_db or GraphDB()
+
+    # ========================================================================
+    # SAMPLING
+    # ========================================================================
+
+    def related(self, nodes: Iterable[str], top_k: int = 10, restart: float = 0.15,
+                walks: int = DEFAULT_WALKS, weighted: bool = True,
+                ignore_direction: bool = False, p: float = 1.0, q: float = 1.0,
+                seed: int = 0) -> RelatedNodes:
+        """
+        Nodes most related to the given ones by random walk with restart
+
+        Walks start at a random given node and end at each step with
+        probability restart; a node's score is its share of all visits (a
+        personalised PageRank estimate). The given nodes are excluded.
+
+        Args:
+            nodes: Source nodes (e.g. the concept being edited, or the
+                symptoms entered so far)
+            top_k: Suggestions wanted
+            restart: Probability of ending a walk at each step (higher =
+                more local)
+            walks: Number of walks (more = less noise)
+            weighted: Step with probability proportional to edge weight
+            ignore_direction: Walk edges in both directions
+            p, q: node2vec return and in-out parameters
+            seed: RNG seed (results are reproducible per seed)
+
+        Returns:
+            RelatedNodes with {'node_id', 'label', 'score'} entries
+
+        Raises:
+            NodeNotFoundError: If a source node doesn't exist
+            ValidationError: If a parameter is out of range
+        """
+        sources = sorted(set(nodes))
+        if not sources:
+            raise ValidationError("At least one source node is required")
+        for node_id in sources:
+            if not self.graph.node_exists(node_id):
+                raise NodeNotFoundError(f"Node '{node_id}' not found")
+        if not 0 < restart <= 1:
+            raise ValidationError("restart must be in (0, 1]")
+        if not 0 < walks <= self.MAX_WALKS:
+            raise ValidationError(f"walks must be in 1..{self.MAX_WALKS}")
+        if top_k < 1 or p <= 0 or q <= 0:
+            raise ValidationError("top_k, p and q must be positive")
+        self._log_operation("related", sources=len(sources), walks=walks)
+
+        walker, names = self._walker(weighted, ignore_direction)
+        ids = [self.graph.topology_id(node_id) for node_id in sources]
+        ids = [idx for idx in ids if idx is not None and idx < walker.node_count]
+        result = RelatedNodes(sources=sources, walks=walks, restart=restart, p=p, q=q)
+        if not ids:
+            return result            # no source has edges yet
+
+        # Walks are capped well beyond the expected length 1 / restart
+        max_length = min(10_000, int(50 / restart))
+        ranked = walker.proximity(ids, walks=walks, restart=restart, max_length=max_length,
+                                  top_k=top_k, p=p, q=q, seed=seed)
+        node_ids = [names[idx] for idx, _ in ranked]
+        for node_id, node, (_, score) in zip(node_ids, self.graph.get_nodes(node_ids), ranked):
+            data = node or {}
+            result.related.append({
+                'node_id': node_id,
+                'label': data.get('label', node_id),
+                'score': score,
+            })
+        return result
+
+    def walk_corpus(self, start_nodes: Optional[Iterable[str]] = None,
+                    walks_per_node: int = 10, length: int = 40, weighted: bool = True,
+                    ignore_direction: bool = False, p: float = 1.0, q: float = 1.0,
+                    seed: int = 0) -> List[List[str]]:
+        """
+        Random walks as sequences of node names
+
+        Args:
+            start_nodes: Nodes to start from (None = every node)
+            walks_per_node: Walks from each start node
+            length: Steps per walk (walks stop early at dead ends)
+            weighted: Step with probability proportional to edge weight
+            ignore_direction: Walk edges in both directions
+            p: node2vec return parameter (low = stay local, BFS-like)
+            q: node2vec in-out parameter (low = move outward, DFS-like)
+            seed: RNG seed (results are reproducible per seed)
+
+        Returns:
+            One list of node names per walk, grouped by round: walk k
+            starts at the (k mod starts)-th start node
+
+        Raises:
+            NodeNotFoundError: If a start node doesn't exist
+            ValidationError: If a parameter is out of range
+        """
+        if walks_per_node < 1 or length < 0 or p <= 0 or q <= 0:
+            raise ValidationError("walks_per_node, p and q must be positive and length >= 0")
+        walker, names = self._walker(weighted, ignore_direction)
+        if start_nodes is None:
+            existing = set(self.graph.get_all_nodes())
+            starts = [idx for idx, node_id in enumerate(names[:walker.node_count])
+                      if node_id in existing]
+        else:
+            starts = []
+            for node_id in start_nodes:
+                idx = self.graph.topology_id(node_id)
+                if not self.graph.node_exists(node_id):
+                    raise NodeNotFoundError(f"Node '{node_id}' not found")
+                if idx is not None and idx < walker.node_count:
+                    starts.append(idx)   # never-linked nodes have no walks
+        self._log_operation("walk_corpus", starts=len(starts), walks_per_node=walks_per_node)
+        if not starts:
+            return []
+
+        flat = walker.walks(starts, walks_per_node=walks_per_node, length=length,
+                            p=p, q=q, seed=seed)
+        stride = length + 1
+        corpus = []
+        for k in range(0, len(flat), stride):
+            walk = flat[k:k + stride]
+            end = walk.index(RW_END) if RW_END in walk else stride
+            corpus.append([names[idx] for idx in walk[:end]])
+        return corpus
+
+    # ========================================================================
+    # HELPERS
+    # ========================================================================
+
+    def _walker(self, weighted: bool, ignore_direction: bool):
+        """Native walk graph for the current topology version, and node names"""
+        generation = self.graph.generation()
+        view, names = self.graph.topology()
+        with view:
+            key = (weighted, ignore_direction, generation, view.version)
+            with self._cache_lock:
+                cache = self._caches.setdefault(self.graph, OrderedDict())
+                hit = cache.get(key)
+                if hit is not None:
+                    cache.move_to_end(key)
+                    return hit
+            walker = WalkGraph(view, weighted=weighted, undirected=ignore_direction)
+
+        with self._cache_lock:
+            cache = self._caches.setdefault(self.graph, OrderedDict())
+            cache[key] = (walker, names)
+            while len(cache) > self.CACHE_SIZE:
+                cache.popitem(last=False)
+        return walker, names
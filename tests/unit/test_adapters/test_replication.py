@@ -0,0 +1,173 @@
+"""
+Adapter Layer Tests: SimpleDB Replication
+
+Tests leader-follower log shipping between SimpleDB stores.
+Focus: replicas matching the leader, catch-up from snapshots, lag
+reporting, failover, authentication and replicas in other processes.
+
+Test IDs: TC-A-014 through TC-A-017
+"""
+
+import json
+import logging
+import os
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+from adapters import Replica, ReplicationLeader, SimpleDB
+
+SRC = Path(__file__).resolve().parents[3] / 'src'
+
+
+def _settle(leader, followers, timeout=5.0):
+    """Wait until the leader has heard every follower acknowledge its version."""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        stats = leader.stats()
+        if len(stats['followers']) == followers and all(
+                f['lag'] == 0 for f in stats['followers']):
+            return stats
+        time.sleep(0.01)
+    raise AssertionError(f"followers did not catch up: {leader.stats()}")
+
+
+class TestReplication:
+    """Test leaders, replicas and failover"""
+
+    def test_replicas_follow_leader(self):
+        """
+        TC-A-014: Replicas Follow
+
+        Verify replicas started before and after writes converge on the
+        leader's contents, report no lag once caught up, and that a
+        follower in another process serves the same reads.
+        """
+        db = SimpleDB()
+        db.set("seed", "1")
+        with ReplicationLeader(db) as leader:
+            early = Replica(leader.address)
+            for i in range(300):
+                db.set(f"k{i}", str(i))
+            db.apply([("seed", None), ("batch", "yes"), ("k0", "changed")])
+            late = Replica(leader.address)
+            db.delete("k1")
+            try:
+                for replica in (early, late):
+                    assert replica.wait(db.version(), timeout=5.0)
+                    assert sorted(replica.items()) == sorted(db.items())
+                    assert replica.get("k0") == "changed" and "k1" not in replica
+                    stats = replica.stats()
+                    assert stats['connected'] and stats['leader'] == leader.id
+                    assert stats['lag'] == 0 and stats['lag_seconds'] == 0.0
+                    assert stats['snapshots'] == 1
+                stats = _settle(leader, 2)
+                assert stats['version'] == db.version()
+                assert stats['log_records'] == db.stats()['log_records'] > 300
+
+                script = (
+                    "import json, sys\n"
+                    "from adapters import Replica\n"
+                    "replica = Replica(sys.argv[1])\n"
+                    "ok = replica.wait(int(sys.argv[2]), timeout=10.0)\n"
+                    "print(json.dumps([ok, replica.count(), replica.get('batch')]))\n"
+                    "replica.close()\n"
+                )
+                out = subprocess.run(
+                    [sys.executable, '-c', script, leader.address, str(db.version())],
+                    capture_output=True, text=True, timeout=30,
+                    env={**os.environ, 'PYTHONPATH': str(SRC)},
+                )
+                assert json.loads(out.stdout) == [True, db.count(), "yes"]
+            finally:
+                early.close()
+                late.close()
+
+    def test_catch_up_beyond_log(self):
+        """
+        TC-A-015: Catch-Up Beyond The Log
+
+        Verify a replica that falls behind a small log while stopped is
+        reseeded from a snapshot by a new connection, and that waiting for
+        a version that never comes times out.
+        """
+        db = SimpleDB()
+        with ReplicationLeader(db, log_bytes=2048) as leader:
+            replica = Replica(leader.address)
+            db.set("a", "1")
+            assert replica.wait(db.version(), timeout=5.0)
+            replica.close()
+
+            for i in range(400):
+                db.set(f"k{i % 20}", str(i))
+            assert leader.stats()['log_floor'] > replica.position
+
+            resumed = Replica(leader.address, db=replica.db)
+            try:
+                assert resumed.wait(db.version(), timeout=5.0)
+                assert sorted(resumed.items()) == sorted(db.items())
+                assert resumed.stats()['snapshots'] == 1
+                assert not resumed.wait(db.version() + 1, timeout=0.05)
+            finally:
+                resumed.close()
+            assert replica.get("k19") == "399"                # same store
+
+    def test_promote_standby(self):
+        """
+        TC-A-016: Failover
+
+        Verify a replica promoted to leader keeps its data and serves new
+        writes to other replicas, which resync from its snapshot.
+        """
+        db = SimpleDB()
+        leader = ReplicationLeader(db)
+        standby = Replica(leader.address)
+        db.apply([(f"k{i}", str(i)) for i in range(100)])
+        assert standby.wait(db.version(), timeout=5.0)
+        leader.close()
+
+        with standby.promote() as new_leader:
+            assert standby.db.log_enabled
+            follower = Replica(new_leader.address)
+            try:
+                standby.db.set("after", "failover")
+                assert follower.wait(standby.db.version(), timeout=5.0)
+                assert follower.count() == 101 and follower.get("after") == "failover"
+                assert follower.stats()['leader'] == new_leader.id != leader.id
+            finally:
+                follower.close()
+
+    def test_rejects_bad_authkey(self, caplog):
+        """
+        TC-A-017: Authentication
+
+        Verify followers with a wrong or missing authkey are turned away
+        (and logged) without stopping the leader, whose rightful followers
+        still connect, and that a rejected replica keeps retrying quietly.
+        """
+        caplog.set_level(logging.WARNING, logger="adapters.replication")
+        db = SimpleDB()
+        db.set("secret", "1")
+        with ReplicationLeader(db, authkey=b"right") as leader:
+            wrong = Replica(leader.address, authkey=b"wrong", reconnect_interval=0.01)
+            missing = Replica(leader.address, reconnect_interval=0.01)
+            try:
+                time.sleep(0.3)
+                assert not wrong.stats()['connected'] and "secret" not in wrong
+                assert not missing.stats()['connected'] and missing.count() == 0
+                assert leader._accepter.is_alive()
+
+                good = Replica(leader.address, authkey=b"right")
+                try:
+                    assert good.wait(db.version(), timeout=5.0)
+                    assert good.get("secret") == "1"
+                finally:
+                    good.close()
+            finally:
+                wrong.close()
+                missing.close()
+
+        messages = [r.getMessage() for r in caplog.records]
+        assert sum("rejected the replica" in m for m in messages) == 1
+        assert any("Rejected follower" in m for m in messages)
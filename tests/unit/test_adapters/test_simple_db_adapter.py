@@ -4,7 +4,7 @@ Adapter Layer Tests: SimpleDB Python Wrapper
 Tests Python-specific features of the adapter layer.
 Focus: Pythonic API, type handling, error handling.
 
-Test IDs: TC-A-001 through TC-A-011
+Test IDs: TC-A-001 through TC-A-013
 """
 
 import pytest
@@ -252,6 +252,42 @@ class TestIntegration:
         del db1, db2, db3
 
 
+class TestBatchedLookup:
+    """Test mget()"""
+
+    @pytest.mark.parametrize("batch_size", [0, 1, 3, 64, 1000])
+    def test_mget_matches_get(self, batch_size):
+        """
+        TC-A-012: Batched Get
+
+        Verify mget returns the same values as get, in order, for any
+        batch size, including misses and duplicates.
+        """
+        db = SimpleDB()
+        for i in range(500):
+            db.set(f"node:{i}", f"value {i} ✓")
+
+        keys = [f"node:{i}" for i in range(0, 600, 7)] + ["node:1", "node:1", ""]
+        assert db.mget(keys, batch_size=batch_size) == [db.get(k) for k in keys]
+        assert db.mget([]) == []
+
+        with pytest.raises(TypeError):
+            db.mget(["ok", 1])
+
+    def test_snapshot_mget(self, populated_db):
+        """
+        TC-A-013: Batched Get On Snapshot
+
+        Verify Snapshot.mget reads the pinned version.
+        """
+        with populated_db.snapshot() as snap:
+            populated_db.delete("user:1")
+            populated_db.set("user:2", "Robert")
+            assert snap.mget(["user:1", "user:2", "user:9"]) == ["Alice", "Bob", None]
+
+        assert populated_db.mget(["user:1", "user:2"]) == [None, "Robert"]
+
+
 class TestStatsMethods:
     """Test statistics and debugging methods"""
 
@@ -0,0 +1,149 @@
+"""
+Core Layer Tests: coarsen C Library
+
+Tests the multilevel coarsening hierarchy through the adapter layer.
+Focus: hierarchy invariants, cut edge aggregation and degenerate graphs.
+
+Test IDs: TC-C-056 through TC-C-058
+"""
+
+import random
+from collections import defaultdict
+
+import pytest
+from adapters import GraphStore, Hierarchy
+from adapters.coarsen import CH_NONE
+
+
+def _graph(pairs):
+    g = GraphStore()
+    g.add_edges([s for s, _ in pairs], [d for _, d in pairs])
+    g.flush()
+    return g
+
+
+def _members(h, level, node):
+    """Level-0 nodes inside a node"""
+    if level == 0:
+        return [node]
+    return [m for child in h.children(level, node) for m in _members(h, level - 1, child)]
+
+
+class TestHierarchy:
+    """Test hierarchy structure"""
+
+    def test_invariants(self):
+        """
+        TC-C-056: Heavy-Edge Matching Hierarchy
+
+        Verify every level partitions the linked level-0 nodes, parents,
+        children and sizes agree, representatives are members, and
+        super-graph weights sum the level-0 edges between clusters.
+        """
+        rng = random.Random(4)
+        for _ in range(8):
+            nodes = rng.randrange(5, 300)
+            pairs = {(rng.randrange(nodes), rng.randrange(nodes)) for _ in range(rng.randrange(3, 600))}
+            pairs = {(s, d) for s, d in pairs if s != d}
+            g = _graph(pairs)
+            with g.view() as view:
+                h = Hierarchy(view, min_nodes=4, seed=rng.randrange(100))
+            linked = {s for s, _ in pairs} | {d for _, d in pairs}
+            assert set(i for i, size in enumerate(h.sizes(0)) if size) == linked
+            assert h.level_size(h.levels - 1) < len(linked) or h.levels == 1
+
+            for level in range(1, h.levels):
+                owner = {}
+                sizes, reps = h.sizes(level), h.reps(level)
+                below = h.parents(level - 1)
+                for c in range(h.level_size(level)):
+                    members = _members(h, level, c)
+                    assert len(members) == sizes[c] and reps[c] in members
+                    assert all(below[child] == c for child in h.children(level, c))
+                    owner.update((m, c) for m in members)
+                assert set(owner) == linked
+
+                weights = defaultdict(float)
+                for s, d in pairs:
+                    if owner[s] != owner[d]:
+                        weights[min(owner[s], owner[d]), max(owner[s], owner[d])] += 1.0
+                got = {}
+                for c in range(h.level_size(level)):
+                    for x, w in h.neighbors(level, c):
+                        got[min(c, x), max(c, x)] = w
+                assert got == pytest.approx(dict(weights))
+
+    def test_star_and_distances(self):
+        """
+        TC-C-057: Hub Contraction / Super-Graph Distances
+
+        Verify a star shrinks geometrically instead of one leaf per level
+        and distances follow the level's super-graph, lifting to the
+        nearest member at coarser levels.
+        """
+        g = _graph([(0, leaf) for leaf in range(1, 1001)])
+        with g.view() as view:
+            h = Hierarchy(view, min_nodes=8)
+        sizes = [h.level_size(level) for level in range(h.levels)]
+        assert sizes[-1] <= 8 and h.levels <= 6
+
+        g = _graph([(i, i + 1) for i in range(9)])
+        with g.view() as view:
+            h = Hierarchy(view, min_nodes=0)
+        assert list(h.distances(0, 0)) == list(range(10))
+        assert list(h.distances(0, 0, max_hops=2))[3:] == [CH_NONE] * 7
+        assert h.level_size(h.levels - 1) == 1
+        dist = h.distances(0, 0)
+        for level in range(1, h.levels):
+            lifted = h.lift_min(level, dist)
+            assert list(lifted) == [min(dist[m] for m in h.children(level, c))
+                                    for c in range(h.level_size(level))]
+            dist = lifted
+        assert list(dist) == [0]
+
+
+class TestCutEdges:
+    """Test edges between the items of a cut"""
+
+    def test_matches_brute_force(self):
+        """
+        TC-C-058: Mixed-Level Cut Aggregation
+
+        Verify aggregated cut edges equal summed level-0 edges for random
+        mixed-level cuts, and overlapping items and graphs without
+        in-adjacency are rejected.
+        """
+        rng = random.Random(8)
+        pairs = {(rng.randrange(200), rng.randrange(200)) for _ in range(700)}
+        pairs = {(s, d) for s, d in pairs if s != d}
+        g = _graph(pairs)
+        with g.view() as view:
+            h = Hierarchy(view, min_nodes=4)
+        for _ in range(10):
+            # Expand random items of the top level down to random depths
+            items = [(h.levels - 1, c) for c in range(h.level_size(h.levels - 1))]
+            for _ in range(30):
+                k = rng.randrange(len(items))
+                level, node = items[k]
+                if level > 0:
+                    items[k:k + 1] = [(level - 1, child) for child in h.children(level, node)]
+            owner = {m: i for i, item in enumerate(items) for m in _members(h, *item)}
+            expected = defaultdict(float)
+            for s, d in pairs:
+                a, b = owner[s], owner[d]
+                if a != b:
+                    expected[min(a, b), max(a, b)] += 1.0
+            got = {(a, b): w for a, b, w in h.cut_edges(items)}
+            assert got == pytest.approx(dict(expected))
+
+        top = h.levels - 1
+        child = h.children(top, 0)[0]
+        with pytest.raises(ValueError):
+            h.cut_edges([(top, 0), (top - 1, child)])
+
+        g = GraphStore(track_in=False)
+        g.add_edges([0], [1])
+        g.flush()
+        with g.view() as view:
+            with pytest.raises(ValueError):
+                Hierarchy(view)
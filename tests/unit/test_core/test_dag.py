@@ -0,0 +1,88 @@
+"""
+Core Layer Tests: dag C Library
+
+Tests hierarchy levels through the adapter layer.
+Focus: depths against a brute-force longest path, shape counts, cycles
+and rejection.
+
+Test IDs: TC-C-072 through TC-C-073
+"""
+
+import functools
+import random
+
+import pytest
+from adapters import GraphStore, hierarchy_levels
+from adapters.dag import DAG_CYCLIC
+
+
+def _store(edges, track_in=True):
+    g = GraphStore(track_in=track_in)
+    g.add_edges([a for a, _ in edges], [b for _, b in edges])
+    g.flush()
+    return g
+
+
+class TestLevels:
+    """Test depths and shape of hierarchies"""
+
+    def test_depths_match_brute_force(self):
+        """
+        TC-C-072: Longest Path Depths
+
+        Verify every node of random multiple-inheritance DAGs sits one
+        level below its deepest parent, and roots, leaves, nodes with
+        several parents and the depth sum match a direct count.
+        """
+        rng = random.Random(3)
+        for n in (1, 12, 300):
+            # Edges point from child to a lower-numbered parent: acyclic
+            edges = {(c, rng.randrange(c)) for c in range(1, n) for _ in range(rng.randint(0, 3))}
+            edges = sorted(edges | {(c, c) for c in rng.sample(range(n), min(n, 5))})
+            g = _store(edges)
+            parents = {u: {p for c, p in edges if c == u and p != u} for u in range(n)}
+            children = {u: {c for c, p in edges if p == u and c != u} for u in range(n)}
+
+            @functools.lru_cache(maxsize=None)
+            def depth(u):
+                return 1 + max(depth(p) for p in parents[u]) if parents[u] else 0
+
+            linked = [u for u in range(n) if parents[u] or children[u]]
+            with g.view() as view:
+                depths, stats = hierarchy_levels(view)
+                assert len(depths) == view.node_count
+            for u in range(len(depths)):
+                assert depths[u] == (depth(u) if u in linked else 0)
+            assert stats['nodes'] == len(linked)
+            assert stats['edges'] == sum(len(p) for p in parents.values())
+            assert stats['roots'] == sum(1 for u in linked if not parents[u])
+            assert stats['leaves'] == sum(1 for u in linked if not children[u])
+            assert stats['multi_parent'] == sum(1 for u in linked if len(parents[u]) > 1)
+            assert stats['max_children'] == max([len(c) for c in children.values()] + [0])
+            assert stats['max_depth'] == max([depth(u) for u in linked] + [0])
+            assert stats['depth_sum'] == sum(depth(u) for u in linked)
+            assert stats['cyclic'] == 0
+
+    def test_cycles_and_rejection(self):
+        """
+        TC-C-073: Cycles
+
+        Verify nodes on a cycle and below it get no depth while the rest
+        of the hierarchy is unaffected, depths can be skipped, and views
+        without in-adjacency are rejected.
+        """
+        # 0 <- 1 <- 2 <- 3 ; 4 <-> 5 with 6 below 5 and 7 below 6 and 1
+        edges = [(1, 0), (2, 1), (3, 2), (4, 5), (5, 4), (6, 5), (7, 6), (7, 1)]
+        g = _store(edges)
+        with g.view() as view:
+            depths, stats = hierarchy_levels(view)
+            assert list(depths) == [0, 1, 2, 3] + [DAG_CYCLIC] * 4
+            assert stats['cyclic'] == 4 and stats['max_depth'] == 3
+            assert stats['depth_sum'] == 6 and stats['roots'] == 1
+            skipped, same = hierarchy_levels(view, depths=False)
+            assert skipped is None and same == stats
+
+        g = _store(edges, track_in=False)
+        with g.view() as view:
+            with pytest.raises(ValueError):
+                hierarchy_levels(view)
@@ -0,0 +1,168 @@
+"""
+Core Layer Tests: diagnosis C Library
+
+Tests noisy-OR differential diagnosis through the adapter layer.
+Focus: agreement with the textbook posterior, ranking, hierarchy roll-ups
+and next-question information gains.
+
+Test IDs: TC-C-067 through TC-C-069
+"""
+
+import math
+import random
+
+import pytest
+from adapters import DiagnosisModel, rollup_posterior, entropy
+from adapters.diagnosis import DX_NONE
+
+
+def _reference(n_diseases, links, priors, leak, present, absent):
+    """Posterior computed directly from P(s | d) = 1 - (1 - leak)(1 - w)"""
+    weight = {}
+    for d, s, w in links:
+        weight[d, s] = max(weight.get((d, s), 0.0), w)
+    scores = []
+    for d in range(n_diseases):
+        score = math.log(priors[d] / sum(priors))
+        for s in present:
+            score += math.log(1 - (1 - leak) * (1 - weight.get((d, s), 0.0)))
+        for s in absent:
+            score += math.log((1 - leak) * (1 - weight.get((d, s), 0.0)))
+        scores.append(score)
+    top = max(scores)
+    total = sum(math.exp(x - top) for x in scores)
+    return [math.exp(x - top) / total for x in scores], scores
+
+
+class TestPosterior:
+    """Test scoring against a direct computation"""
+
+    def test_matches_reference_and_ranks(self):
+        """
+        TC-C-067: Noisy-OR Posterior
+
+        Verify posteriors and log-likelihoods match the direct formula for
+        random models (repeated links keep the largest weight), ranking is
+        best first with ties by index, and bad input is rejected.
+        """
+        rng = random.Random(11)
+        for _ in range(50):
+            nd, ns = rng.randint(1, 30), rng.randint(1, 40)
+            links = [(rng.randrange(nd), rng.randrange(ns), round(rng.random(), 3))
+                     for _ in range(rng.randint(0, 120))]
+            priors = [rng.uniform(0.1, 5) for _ in range(nd)]
+            leak = rng.choice([0.001, 0.01, 0.1])
+            symptoms = rng.sample(range(ns), rng.randint(0, min(ns, 8)))
+            cut = rng.randint(0, len(symptoms))
+            present, absent = symptoms[:cut], symptoms[cut:]
+
+            model = DiagnosisModel(nd, ns, links, priors=priors, leak=leak)
+            ranked, post = model.diagnose(present, absent, top_k=5)
+            expected, scores = _reference(nd, links, priors, leak, present, absent)
+            assert list(post) == pytest.approx(expected, rel=1e-4, abs=1e-12)
+            assert list(model.log_likelihoods(present, absent)) == pytest.approx(scores, rel=1e-4)
+            best = sorted(range(nd), key=lambda d: (-scores[d], d))[:5]
+            assert [d for d, _ in ranked] == best or \
+                [scores[d] for d, _ in ranked] == pytest.approx([scores[d] for d in best])
+
+        # Uniform priors, no evidence: all tie, ranked by index
+        model = DiagnosisModel(3, 2, [(2, 0, 1.0), (0, 1, 0.5)])
+        ranked, post = model.diagnose(top_k=10)
+        assert [d for d, _ in ranked] == [0, 1, 2] and list(post) == pytest.approx([1 / 3] * 3)
+        # A weight of 1 is capped, so absence lowers but never excludes
+        ranked, _ = model.diagnose(present=[], absent=[0], top_k=3)
+        assert ranked[-1][0] == 2 and 0 < ranked[-1][1] < 1e-4
+        assert model.link_count == 2 and model.symptom_count == 2
+
+        with pytest.raises(ValueError):
+            model.diagnose([0], [0])
+        with pytest.raises(ValueError):
+            model.diagnose([2])
+        for bad in ([(0, 0, 1.5)], [(3, 0, 0.5)], [(0, 2, 0.5)]):
+            with pytest.raises(ValueError):
+                DiagnosisModel(3, 2, bad)
+        with pytest.raises(ValueError):
+            DiagnosisModel(3, 2, [], leak=0.0)
+        with pytest.raises(ValueError):
+            DiagnosisModel(2, 2, [], priors=[1.0, 0.0])
+
+
+class TestRollup:
+    """Test hierarchy roll-ups"""
+
+    def test_sums_up_the_tree(self):
+        """
+        TC-C-068: Posterior Roll-up
+
+        Verify each group receives the posterior of the diseases below it,
+        ungrouped diseases are skipped, and out-of-range groups or cycles
+        are rejected.
+        """
+        # 0 root <- 1 <- 2, and 3 a separate root
+        parent = [DX_NONE, 0, 1, DX_NONE]
+        totals = rollup_posterior([0.5, 0.2, 0.2, 0.1], [2, 1, 3, DX_NONE], parent)
+        assert list(totals) == pytest.approx([0.7, 0.7, 0.5, 0.2])
+
+        with pytest.raises(ValueError):
+            rollup_posterior([1.0], [4], parent)
+        with pytest.raises(ValueError):
+            rollup_posterior([1.0], [0], [1, 2, 0])
+        with pytest.raises(ValueError):
+            rollup_posterior([1.0, 0.0], [0], parent)
+
+
+def _h(probs):
+    return -sum(p * math.log2(p) for p in probs if p > 0)
+
+
+class TestQuestions:
+    """Test incremental updates and information gains"""
+
+    def test_gain_matches_expected_entropy_drop(self):
+        """
+        TC-C-069: Next-Question Information Gain
+
+        Verify observe matches rescoring from scratch, every gain equals
+        the entropy minus the expected entropy after the answer (computed
+        with observe), asked symptoms are skipped, and the threaded pass
+        on a large model agrees with the single-threaded one.
+        """
+        rng = random.Random(3)
+        for _ in range(30):
+            nd, ns = rng.randint(1, 12), rng.randint(1, 15)
+            links = [(rng.randrange(nd), rng.randrange(ns), round(rng.random(), 3))
+                     for _ in range(rng.randint(0, 40))]
+            model = DiagnosisModel(nd, ns, links, leak=0.05)
+            asked = rng.sample(range(ns), rng.randint(0, min(3, ns)))
+            _, post = model.diagnose(asked[:1], asked[1:])
+
+            s = rng.randrange(ns)
+            step = model.observe(post, s, True) if s not in asked else post
+            if s not in asked:
+                _, direct = model.diagnose(asked[:1] + [s], asked[1:])
+                assert list(step) == pytest.approx(list(direct), rel=1e-6, abs=1e-12)
+
+            ranked, p_present = model.questions(post, skip=asked, top_k=ns)
+            assert {q for q, _ in ranked} == set(range(ns)) - set(asked)
+            assert [g for _, g in ranked] == sorted((g for _, g in ranked), reverse=True)
+            for q, gain in ranked:
+                yes, no = model.observe(post, q, True), model.observe(post, q, False)
+                expected = entropy(post) - (p_present[q] * _h(yes) + (1 - p_present[q]) * _h(no))
+                assert gain == pytest.approx(max(expected, 0.0), abs=1e-9)
+        assert entropy([0.5, 0.5]) == pytest.approx(1.0) and entropy([0, 0]) == 0.0
+
+        # Large enough to be split among threads
+        nd, ns = 400, 3000
+        links = [(rng.randrange(nd), rng.randrange(ns), rng.random()) for _ in range(80_000)]
+        model = DiagnosisModel(nd, ns, links)
+        _, post = model.diagnose(present=[1, 2], absent=[3])
+        threaded, p4 = model.questions(post, skip=[1, 2, 3], top_k=20, threads=4)
+        single, p1 = model.questions(post, skip=[1, 2, 3], top_k=20, threads=1)
+        assert threaded == single and list(p4) == list(p1)
+
+        with pytest.raises(ValueError):
+            model.questions(post, skip=[ns])
+        with pytest.raises(ValueError):
+            model.questions([0.0] * nd)
+        with pytest.raises(ValueError):
+            model.observe(post, ns, True)
@@ -0,0 +1,154 @@
+"""
+Core Layer Tests: graph_store C Library
+
+Tests the batched adjacency store through the adapter layer.
+Focus: merge semantics, version isolation, concurrent producers.
+
+Test IDs: TC-C-040 through TC-C-043
+"""
+
+import random
+import threading
+
+import pytest
+from adapters import GraphStore
+
+
+class TestMerge:
+    """Test folding queued operations into adjacency lists"""
+
+    def test_last_operation_wins(self):
+        """
+        TC-C-040: Operation Order
+
+        Verify sorted neighbor lists, weight updates, and that the last of
+        several operations on one edge decides its state.
+        """
+        g = GraphStore()
+        g.add_edges([3, 3, 3, 1], [9, 2, 5, 3], [1.0, 2.0, 3.0, 4.0])
+        g.add_edge(3, 2, 7.5)
+        g.delete_edge(3, 9)
+        g.add_edge(1, 4)
+        g.delete_edge(1, 4)
+        g.delete_edge(8, 8)
+        g.flush()
+
+        with g.view() as v:
+            assert v.weighted_neighbors(3) == [(2, 7.5), (5, 3.0)]
+            assert v.neighbors(1) == [3]
+            assert v.in_neighbors(3) == [1]
+            assert v.edge_weight(1, 4) is None
+            assert v.edge_count == 3
+            assert v.node_count == 10
+            assert v.degree(42) == 0
+
+    def test_matches_reference_model(self):
+        """
+        TC-C-041: Random Updates
+
+        Verify a random mix of inserts and deletes over many batches
+        matches a Python set of edges, in both directions, including
+        in-degrees and pages of in-neighbors.
+        """
+        g = GraphStore()
+        rng = random.Random(7)
+        edges = {}
+        for _ in range(20):
+            src = [rng.randrange(3000) for _ in range(2000)]
+            dst = [rng.randrange(3000) for _ in range(2000)]
+            if rng.random() < 0.3:
+                g.delete_edges(src, dst)
+                for pair in zip(src, dst):
+                    edges.pop(pair, None)
+            else:
+                g.add_edges(src, dst)
+                edges.update(dict.fromkeys(zip(src, dst), 1.0))
+            if rng.random() < 0.5:
+                g.flush()
+        g.flush()
+
+        with g.view() as v:
+            assert v.edge_count == len(edges)
+            for node in range(0, 3000, 37):
+                assert v.neighbors(node) == sorted(d for s, d in edges if s == node)
+                incoming = sorted(s for s, d in edges if d == node)
+                assert v.in_neighbors(node) == incoming
+                assert v.in_degree(node) == len(incoming)
+                start = rng.randrange(3000)
+                assert v.in_neighbors_from(node, start, 3) == [s for s in incoming if s >= start][:3]
+
+
+class TestVersions:
+    """Test that views are isolated from later merges"""
+
+    def test_view_keeps_its_version(self):
+        """
+        TC-C-042: Snapshot Isolation
+
+        Verify a pinned view is unaffected by later writes and that flush
+        makes them visible to a new view.
+        """
+        g = GraphStore(track_in=False)
+        g.add_edges(list(range(2000)), [0] * 2000)
+        g.flush()
+        old = g.view()
+
+        g.delete_edges(list(range(2000)), [0] * 2000)
+        g.add_edge(5, 6)
+        version = g.flush()
+
+        assert old.edge_count == 2000
+        assert old.neighbors(1999) == [0]
+        with g.view() as new:
+            assert new.version == version > old.version
+            assert new.edge_count == 1
+            assert new.neighbors(5) == [6]
+            with pytest.raises(ValueError):
+                new.in_neighbors(6)
+            with pytest.raises(ValueError):
+                new.in_degree(6)
+        old.release()
+        with pytest.raises(ValueError):
+            old.neighbors(0)
+
+
+class TestConcurrency:
+    """Test concurrent producers and readers"""
+
+    def test_threads_ingest_concurrently(self):
+        """
+        TC-C-043: Concurrent Ingestion
+
+        Verify edges pushed from several threads while a reader polls are
+        all present after flush, and readers only see growing versions.
+        """
+        g = GraphStore(ring_capacity=256)
+        done = threading.Event()
+        seen = []
+
+        def writer(k):
+            for base in range(0, 20000, 500):
+                g.add_edges([k * 20000 + base + i for i in range(500)], [k] * 500)
+
+        def reader():
+            while not done.is_set():
+                with g.view() as v:
+                    seen.append((v.version, v.edge_count))
+
+        threads = [threading.Thread(target=writer, args=(k,)) for k in range(4)]
+        poll = threading.Thread(target=reader)
+        poll.start()
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        g.flush()
+        done.set()
+        poll.join()
+
+        stats = g.stats()
+        assert stats['edges'] == 80000
+        assert stats['pending'] == 0 and stats['merge_retries'] == 0
+        assert seen == sorted(seen)
+        with g.view() as v:
+            assert len(v.in_neighbors(3)) == 20000
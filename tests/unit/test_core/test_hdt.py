@@ -0,0 +1,125 @@
+"""
+Core Layer Tests: hdt C Library
+
+Tests compressed RDF files through the adapter layer.
+Focus: dictionary round trips, triple patterns against a brute-force
+filter, and rejection of damaged files.
+
+Test IDs: TC-C-070 through TC-C-071
+"""
+
+import random
+
+import pytest
+from adapters import HDTWriter, HDTFile
+from adapters.hdt import SUBJECT, PREDICATE, OBJECT, HDT_ANY as ANY
+
+
+def _random_triples(rng, n):
+    iris = [f"<http://example.org/{rng.choice(['Disease', 'Symptom', 'x'])}/{i:04d}>"
+            for i in range(60)]
+    predicates = [f"<http://example.org/p{i}>" for i in range(5)]
+    literals = ['""', '"fever"@en', '"Fever"', '"café"@fr',
+                '"1"^^<http://www.w3.org/2001/XMLSchema#int>']
+    subjects = iris + ["_:b1", "_:b2"]
+    objects = iris + literals
+    return [(rng.choice(subjects), rng.choice(predicates), rng.choice(objects)) for _ in range(n)]
+
+
+class TestRoundTrip:
+    """Test writing, reading and pattern queries"""
+
+    def test_patterns_match_brute_force(self, tmp_path):
+        """
+        TC-C-070: Triple Patterns
+
+        Verify every combination of bound and unbound positions returns
+        exactly the matching triples (duplicates dropped) in subject,
+        predicate, object ID order, counts agree, terms round-trip through
+        the dictionary, and limit/offset page through the matches.
+        """
+        rng = random.Random(5)
+        for n in (0, 1, 40, 3000):
+            triples = _random_triples(rng, n)
+            path = str(tmp_path / f"t{n}.hdt")
+            writer = HDTWriter()
+            writer.add_all(triples)
+            stats = writer.save(path)
+            distinct = set(triples)
+            assert stats['triples'] == len(distinct)
+
+            f = HDTFile(path)
+            assert f.stats() == stats and f.triple_count == len(distinct)
+            assert f.term_count(PREDICATE) == len({p for _, p, _ in distinct})
+            for s, p, o in list(distinct)[:50]:
+                for term, role in ((s, SUBJECT), (p, PREDICATE), (o, OBJECT)):
+                    assert f.terms([f.lookup(term, role)], role) == [term]
+            assert f.lookup("<http://example.org/none>", SUBJECT) is None
+            assert f.lookup('"fever"@en', SUBJECT) is None
+
+            everything = list(f.search())
+            assert set(everything) == distinct and len(everything) == len(distinct)
+            ids = list(f.search_ids())
+            assert ids == sorted(ids)
+
+            samples = list(distinct)[:20] + [("_:b1", "<http://example.org/p0>", '"Fever"')]
+            for s, p, o in samples:
+                for mask in range(8):
+                    pattern = (s if mask & 1 else None, p if mask & 2 else None,
+                               o if mask & 4 else None)
+                    expected = {t for t in distinct
+                                if all(q is None or q == v for q, v in zip(pattern, t))}
+                    found = list(f.search(*pattern))
+                    assert set(found) == expected and len(found) == len(expected)
+                    assert f.count(*pattern) == len(expected)
+                    page = list(f.search(*pattern, limit=3, offset=1))
+                    assert page == found[1:4]
+            f.close()
+
+    def test_rejects_damaged_files(self, tmp_path):
+        """
+        TC-C-071: Damaged Files
+
+        Verify missing, foreign and truncated files are rejected on open,
+        and files with corrupted data never crash a query.
+        """
+        path = tmp_path / "v.hdt"
+        writer = HDTWriter()
+        writer.add_all(_random_triples(random.Random(2), 500))
+        writer.save(str(path))
+        data = path.read_bytes()
+
+        with pytest.raises(OSError):
+            HDTFile(str(tmp_path / "missing.hdt"))
+        (tmp_path / "text.hdt").write_text("@prefix ex: <http://example.org/> .\n" * 20)
+        with pytest.raises(OSError):
+            HDTFile(str(tmp_path / "text.hdt"))
+        for cut in (0, 100, len(data) // 2, len(data) - 8):
+            (tmp_path / "cut.hdt").write_bytes(data[:cut])
+            with pytest.raises(OSError):
+                HDTFile(str(tmp_path / "cut.hdt"))
+
+        # Scribble over the body (past the header): queries may fail but must not crash
+        rng = random.Random(9)
+        for _ in range(40):
+            damaged = bytearray(data)
+            for _ in range(8):
+                damaged[rng.randrange(256, len(data))] = rng.randrange(256)
+            (tmp_path / "bad.hdt").write_bytes(bytes(damaged))
+            try:
+                f = HDTFile(str(tmp_path / "bad.hdt"))
+            except OSError:
+                continue
+            patterns = [(ANY, ANY, ANY), (0, ANY, ANY), (ANY, 0, ANY), (ANY, ANY, 0), (1, 0, ANY)]
+            for pattern in patterns:
+                try:
+                    list(f.search_ids(*pattern))
+                except ValueError:
+                    pass
+            for role in (SUBJECT, PREDICATE, OBJECT):
+                try:
+                    f.terms(range(min(f.term_count(role), 30)), role)
+                    f.lookup("<http://example.org/x/0001>", role)
+                except (ValueError, UnicodeDecodeError):
+                    pass
+            f.close()
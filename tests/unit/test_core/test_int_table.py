@@ -0,0 +1,153 @@
+"""
+Core Layer Tests: int_table C Library
+
+Tests the integer-keyed table family through the adapter layer.
+Focus: hashed and dense layouts, growth, deletion, batch lookup.
+
+Test IDs: TC-C-028 through TC-C-034
+"""
+
+import random
+
+import pytest
+from adapters import IntMap32, IntMap64
+
+
+class TestHashedTable:
+    """Test the open-addressing layout"""
+
+    def test_put_get_remove(self):
+        """
+        TC-C-028: Basic Operations
+
+        Verify put/get/remove/update on a hashed table.
+        """
+        m = IntMap32()
+        assert m.put(7, 70)
+        assert m.put(0, 1)           # zero is an ordinary key
+        assert m.get(7) == 70
+        assert m.get(0) == 1
+        assert m.get(8) is None
+
+        m.put(7, 71)
+        assert m[7] == 71
+        assert len(m) == 2
+
+        assert m.remove(7)
+        assert not m.remove(7)
+        assert 7 not in m
+        assert len(m) == 1
+
+    def test_growth_and_churn_match_dict(self):
+        """
+        TC-C-029: Growth and Tombstones
+
+        Verify a long random insert/delete sequence matches a Python dict,
+        across several resizes.
+        """
+        m = IntMap64()
+        ref = {}
+        rng = random.Random(42)
+        for _ in range(20000):
+            key = rng.randrange(5000) << 40   # high bits only
+            if rng.random() < 0.6:
+                value = rng.randrange(1 << 64)
+                m[key] = value
+                ref[key] = value
+            else:
+                assert m.remove(key) == (key in ref)
+                ref.pop(key, None)
+
+        assert len(m) == len(ref)
+        for key, value in ref.items():
+            assert m[key] == value
+        assert m.stats()['capacity'] >= len(ref)
+
+    def test_extreme_keys(self):
+        """
+        TC-C-030: Full Key Range
+
+        Verify the largest key values are stored like any other.
+        """
+        m = IntMap64()
+        m[2**64 - 1] = 1
+        m[2**63] = 2
+        assert m[2**64 - 1] == 1
+        assert m[2**63] == 2
+
+        with pytest.raises(ValueError):
+            m.put(2**64, 0)
+        with pytest.raises(ValueError):
+            IntMap32().put(-1, 0)
+
+    def test_clear(self):
+        """
+        TC-C-031: Clear and Reuse
+        """
+        m = IntMap32(capacity=1000)
+        for i in range(1000):
+            m[i] = i
+        m.clear()
+        assert len(m) == 0
+        assert m.get(5) is None
+        m[5] = 6
+        assert m[5] == 6
+
+
+class TestDenseTable:
+    """Test the direct-mapped layout"""
+
+    def test_dense_operations(self):
+        """
+        TC-C-032: Dense Layout
+
+        Verify a dense table accepts keys in range and rejects others.
+        """
+        m = IntMap32(dense_max_key=99)
+        assert m.dense
+        assert m.put(0, 5)
+        assert m.put(99, 6)
+        assert not m.put(100, 7)
+        assert m.get(100) is None
+
+        assert len(m) == 2
+        assert m.remove(0)
+        assert m.get(0) is None
+
+        with pytest.raises(KeyError):
+            m[100] = 1
+
+
+class TestBatchLookup:
+    """Test get_many"""
+
+    @pytest.mark.parametrize("dense", [False, True])
+    def test_get_many(self, dense):
+        """
+        TC-C-033: Batched Lookup
+
+        Verify get_many returns values in order with None for misses.
+        """
+        m = IntMap32(dense_max_key=999) if dense else IntMap32()
+        for i in range(0, 1000, 2):
+            m[i] = i * 3
+
+        keys = list(range(0, 1000, 7)) + [5, 4]
+        expected = [k * 3 if k % 2 == 0 else None for k in keys]
+        assert m.get_many(keys) == expected
+        assert m.get_many([]) == []
+
+    def test_get_many_matches_get(self):
+        """
+        TC-C-034: Batch Equals Scalar
+
+        Verify batched and scalar lookups agree on a table spanning many
+        prefetch batches.
+        """
+        m = IntMap64()
+        rng = random.Random(1)
+        keys = [rng.randrange(1 << 64) for _ in range(3000)]
+        for k in keys[::2]:
+            m[k] = k ^ 0xFFFF
+
+        assert m.get_many(keys) == [m.get(k) for k in keys]
@@ -0,0 +1,102 @@
+"""
+Core Layer Tests: partition C Library
+
+Tests multilevel K-way partitioning through the adapter layer.
+Focus: planted communities, balance, reported statistics, nodes without
+edges and rejection.
+
+Test IDs: TC-C-077 through TC-C-078
+"""
+
+import math
+import random
+
+import pytest
+from adapters import GraphStore, Hierarchy, partition
+
+
+def _hierarchy(edges, n=None, min_nodes=32, seed=0):
+    g = GraphStore()
+    if n:
+        g.add_edge(n - 1, n - 1)            # allocate IDs up to n - 1
+        g.delete_edge(n - 1, n - 1)
+    g.add_edges([a for a, _ in edges], [b for _, b in edges])
+    g.flush()
+    with g.view() as view:
+        return Hierarchy(view, min_nodes=min_nodes, seed=seed)
+
+
+def _cut(edges, parts):
+    pairs = {(min(a, b), max(a, b)) for a, b in edges if a != b}
+    return sum(1 for a, b in pairs if parts[a] != parts[b])
+
+
+class TestPartition:
+    """Test partition quality and bookkeeping"""
+
+    def test_planted_communities(self):
+        """
+        TC-C-077: Planted Communities
+
+        Verify that communities joined by a few random edges are kept
+        whole when k divides them evenly, that parts respect the size
+        limit, and that the reported cut matches the assignment.
+        """
+        rng = random.Random(11)
+        communities, size = 8, 250
+        edges = []
+        for c in range(communities):
+            base = c * size
+            edges += [(base + i, base + (i + 1) % size) for i in range(size)]   # connected
+            edges += [(base + rng.randrange(size), base + rng.randrange(size))
+                      for _ in range(4 * size)]
+        bridges = [(rng.randrange(communities * size), rng.randrange(communities * size))
+                   for _ in range(40)]
+        edges += bridges
+        h = _hierarchy(edges)
+
+        for k in (2, 4, 8):
+            for seed in range(3):
+                parts, stats = partition(h, k, imbalance=0.03, seed=seed)
+                limit = math.ceil(1.03 * communities * size / k)
+                counts = [list(parts).count(p) for p in range(k)]
+                assert max(counts) <= limit
+                assert (stats['largest'], stats['smallest']) == (max(counts), min(counts))
+                assert stats['cut_edges'] == _cut(edges, parts)
+                assert stats['cut_edges'] <= len(bridges)
+                # Every community in a single part
+                for c in range(communities):
+                    assert len({parts[c * size + i] for i in range(size)}) == 1
+
+    def test_balance_isolated_and_rejection(self):
+        """
+        TC-C-078: Balance And Rejection
+
+        Verify a grid split with no slack is exactly balanced and cuts far
+        fewer edges than a random split, nodes without edges fill the
+        smallest parts, k = 1 and k beyond the node count work, and bad
+        arguments are refused.
+        """
+        side = 40
+        grid = [(i * side + j, i * side + j + 1) for i in range(side) for j in range(side - 1)]
+        grid += [(i * side + j, (i + 1) * side + j) for i in range(side - 1) for j in range(side)]
+        h = _hierarchy(grid, n=side * side + 100)          # 100 nodes without edges
+
+        parts, stats = partition(h, 4, imbalance=0.0)
+        counts = [list(parts).count(p) for p in range(4)]
+        assert counts == [(side * side + 100) // 4] * 4
+        rng = random.Random(3)
+        shuffled = [rng.randrange(4) for _ in parts]
+        assert stats['cut_edges'] * 5 < _cut(grid, shuffled)
+
+        parts, stats = partition(h, 1)
+        assert set(parts) == {0} and stats['cut'] == 0.0
+        parts, stats = partition(h, 5000)
+        assert len(set(parts)) == side * side + 100 and stats['largest'] == 1
+
+        with pytest.raises(ValueError):
+            partition(h, 0)
+        with pytest.raises(ValueError):
+            partition(h, 2, imbalance=-0.1)
+        with pytest.raises(ValueError):
+            partition(h, 2, imbalance=float('nan'))
@@ -0,0 +1,122 @@
+"""
+Core Layer Tests: pattern_match C Library
+
+Tests the native subgraph matcher through the adapter layer.
+Focus: agreement with brute force, symmetry breaking, limits.
+
+Test IDs: TC-C-047 through TC-C-049
+"""
+
+import itertools
+import random
+
+import pytest
+from adapters import GraphStore, Pattern
+
+
+def _random_graph(rng, nodes, edges):
+    g = GraphStore()
+    pairs = {(rng.randrange(nodes), rng.randrange(nodes)) for _ in range(edges)}
+    g.add_edges([s for s, _ in pairs], [d for _, d in pairs])
+    g.flush()
+    return g, pairs
+
+
+class TestJoin:
+    """Test match enumeration against a reference"""
+
+    def test_matches_brute_force(self):
+        """
+        TC-C-047: Random Patterns
+
+        Verify random patterns (directed and undirected edges, self-loops,
+        candidate lists, several threads) find exactly the injective
+        bindings a brute-force search finds.
+        """
+        rng = random.Random(11)
+        for _ in range(25):
+            g, pairs = _random_graph(rng, 14, rng.randrange(20, 90))
+            n_vars = rng.randrange(2, 5)
+            edges = [(rng.randrange(n_vars), rng.randrange(n_vars), rng.random() < 0.3)
+                     for _ in range(rng.randrange(1, 5))]
+            cands = [None if rng.random() < 0.6 else sorted(rng.sample(range(14), 7))
+                     for _ in range(n_vars)]
+
+            with g.view() as v:
+                p = Pattern()
+                for c in cands:
+                    p.add_var(c)
+                for s, d, undirected in edges:
+                    p.add_edge(s, d, v, undirected)
+                got = sorted(p.match(threads=3, break_symmetry=False))
+
+                expected = [
+                    t for t in itertools.permutations(range(v.node_count), n_vars)
+                    if all(c is None or t[i] in c for i, c in enumerate(cands))
+                    and all((t[s], t[d]) in pairs or (u and (t[d], t[s]) in pairs)
+                            for s, d, u in edges)
+                ]
+            assert got == expected
+
+
+class TestSymmetry:
+    """Test that symmetric patterns report each subgraph once"""
+
+    def test_triangles_once(self):
+        """
+        TC-C-048: Automorphisms
+
+        Verify an undirected triangle has 6 automorphisms and, with symmetry
+        breaking, each triangle of the graph is reported exactly once.
+        """
+        g = GraphStore()
+        # Two triangles sharing the edge 1-2, plus a tail
+        g.add_edges([0, 1, 2, 1, 3, 3], [1, 2, 0, 3, 2, 4])
+        g.flush()
+
+        with g.view() as v:
+            p = Pattern()
+            a, b, c = p.add_var(), p.add_var(), p.add_var()
+            p.add_edge(a, b, v, undirected=True)
+            p.add_edge(b, c, v, undirected=True)
+            p.add_edge(c, a, v, undirected=True)
+
+            rows = []
+            stats = p.stream(rows.extend)
+            assert stats['automorphisms'] == 6
+            assert sorted(tuple(sorted(r)) for r in rows) == [(0, 1, 2), (1, 2, 3)]
+            assert len(p.match(break_symmetry=False)) == 12
+
+
+class TestStreaming:
+    """Test limits and early stops"""
+
+    def test_limit_and_stop(self):
+        """
+        TC-C-049: Limits
+
+        Verify limit caps the delivered matches, a callback returning False
+        stops the search, an empty candidate list matches nothing, and
+        invalid patterns are rejected.
+        """
+        rng = random.Random(5)
+        g, _ = _random_graph(rng, 500, 5000)
+        with g.view() as v:
+            p = Pattern()
+            a, b = p.add_var(), p.add_var()
+            p.add_edge(a, b, v)
+            assert len(p.match(limit=123)) == 123
+
+            batches = []
+            stats = p.stream(lambda rows: batches.append(rows) or False)
+            assert len(batches) == 1
+            assert stats['stopped']
+
+            empty = Pattern()
+            empty.add_edge(empty.add_var([]), empty.add_var(), v)
+            assert empty.match() == []
+
+            with pytest.raises(ValueError):
+                p.add_edge(a, 7, v)
+            with pytest.raises(ValueError):
+                Pattern().match()
@@ -0,0 +1,196 @@
+"""
+Core Layer Tests: shapes C Library
+
+Tests compiled shape programs through the adapter layer.
+Focus: inherited rules against a brute-force evaluation, thread-count
+independence, lexical datatype checks and rejection.
+
+Test IDs: TC-C-074 through TC-C-075
+"""
+
+import random
+import re
+
+import pytest
+from adapters import ShapeBatch, ShapeProgram
+from adapters.shapes import (
+    BOOLEAN, DATATYPE, INTEGER, MAX_COUNT, MIN_COUNT, NUMBER, RANGE, REF, SHP_ALL,
+    SHP_NONE, STRING, XSD_ANY_URI, XSD_BOOLEAN, XSD_DATE, XSD_DATETIME, XSD_DECIMAL,
+    XSD_INTEGER, XSD_STRING, XSD_TIME,
+)
+
+
+def _lexical_ok(kind, text, mask):
+    """XSD_STRING / XSD_INTEGER acceptance, as the brute-force reference"""
+    is_text = kind in (STRING, REF)
+    if mask & XSD_STRING and is_text:
+        return True
+    return bool(mask & XSD_INTEGER and
+                (kind == INTEGER or (is_text and re.fullmatch(r"[+-]?[0-9]+", text))))
+
+
+class TestPrograms:
+    """Test rule evaluation"""
+
+    def test_rules_match_brute_force(self):
+        """
+        TC-C-074: Inherited Rules
+
+        Verify random programs over multiple-inheritance hierarchies report
+        exactly the violations of a direct evaluation - every rule of every
+        ancestor of every class of an instance, plus global rules, once -
+        in instance order, with the same result on one thread or several.
+        """
+        rng = random.Random(7)
+        n_classes, n_props = 40, 6
+        parents = {c: {rng.randrange(c) for _ in range(rng.randint(0, 2))} if c else set()
+                   for c in range(n_classes)}
+        parents[3].add(9)                       # a subclass cycle
+        parents[9].add(3)
+
+        def ancestors(c):
+            seen, stack = {c}, [c]
+            while stack:
+                for p in parents[stack.pop()]:
+                    if p not in seen:
+                        seen.add(p)
+                        stack.append(p)
+            return seen
+
+        program = ShapeProgram(n_classes)
+        for c, ps in parents.items():
+            for p in ps:
+                program.add_parent(c, p)
+        sets = [sorted(rng.sample(range(n_classes), rng.randint(1, 3))) for _ in range(4)]
+        set_ids = [program.add_class_set(s) for s in sets]
+        rules = []
+        for _ in range(60):
+            cls = SHP_ALL if rng.random() < 0.1 else rng.randrange(n_classes)
+            op = rng.choice((MIN_COUNT, MAX_COUNT, DATATYPE, RANGE))
+            prop = rng.randrange(n_props)
+            if op in (MIN_COUNT, MAX_COUNT):
+                arg = rng.randint(0, 3)
+            elif op == DATATYPE:
+                arg = rng.choice((XSD_STRING, XSD_INTEGER, XSD_STRING | XSD_INTEGER))
+            else:
+                arg = rng.choice(set_ids)
+            assert program.add_rule(cls, op, prop, arg) == len(rules)
+            rules.append((cls, op, prop, arg))
+        program.compile()
+        assert program.is_a(3, 9) and program.is_a(9, 3)
+
+        n_inst, n_ext = 5000, 50
+        entity_types = [rng.sample(range(n_classes), rng.randint(0, 2))
+                        for _ in range(n_inst + n_ext)]
+        texts = ("12", "-3", "+0", "x", "1.5", "", "007")
+        values = []
+        for _ in range(n_inst):
+            row = []
+            for _ in range(rng.randint(0, 6)):
+                kind = rng.choice((STRING, INTEGER, REF))
+                target = rng.randrange(n_inst + n_ext) if kind == REF else SHP_NONE
+                text = str(rng.randint(-9, 9)) if kind == INTEGER else rng.choice(texts)
+                row.append((rng.randrange(n_props + 1), kind, text, target))
+            values.append(row)
+        batch = ShapeBatch(entity_types, values)
+
+        closure = [ancestors(c) for c in range(n_classes)]
+        expected = []
+        offset = 0
+        for i, row in enumerate(values):
+            owners = set().union(*(closure[c] for c in entity_types[i])) | {SHP_ALL}
+            for r, (cls, op, prop, arg) in enumerate(rules):
+                if cls not in owners:
+                    continue
+                count = sum(1 for v in row if v[0] == prop)
+                if op == MIN_COUNT and count < arg or op == MAX_COUNT and count > arg:
+                    expected.append((i, r, SHP_NONE, count))
+                for k, (vprop, kind, text, target) in enumerate(row):
+                    if vprop != prop or op in (MIN_COUNT, MAX_COUNT):
+                        continue
+                    if op == DATATYPE:
+                        bad = not _lexical_ok(kind, text, arg)
+                    else:
+                        members = set(sets[set_ids.index(arg)])
+                        bad = kind != REF or not any(
+                            closure[t] & members for t in entity_types[target])
+                    if bad:
+                        expected.append((i, r, offset + k, count))
+            offset += len(row)
+
+        for threads in (1, 4):
+            found, stats = program.validate(batch, threads=threads, max_violations=len(expected))
+            assert sorted(found) == sorted(expected)
+            assert [v[0] for v in found] == sorted(v[0] for v in found)
+            assert stats['violations'] == len(expected)
+            assert stats['invalid'] == len({v[0] for v in expected})
+            assert stats['threads'] == threads
+
+        # Past the cap everything is still counted; the first ones are kept
+        capped, stats = program.validate(batch, threads=4, max_violations=10)
+        assert capped == found[:10] and stats['violations'] == len(expected)
+        for _, rule, value, _ in found:
+            if value != SHP_NONE:
+                assert batch.value(value)[0] == rules[rule][2]
+
+    def test_lexical_forms_and_rejection(self):
+        """
+        TC-C-075: Datatypes And Rejection
+
+        Verify lexical forms of each XSD datatype (leap days, time zones,
+        24:00:00, exponents), value kinds, and that uncompiled programs,
+        out-of-range IDs and additions after compiling are refused.
+        """
+        cases = [
+            (XSD_INTEGER, STRING, "-42", True), (XSD_INTEGER, STRING, "4.0", False),
+            (XSD_INTEGER, STRING, "+", False), (XSD_INTEGER, NUMBER, "4.5", False),
+            (XSD_DECIMAL, STRING, "-1.5e3", True), (XSD_DECIMAL, STRING, ".5", True),
+            (XSD_DECIMAL, STRING, "INF", True), (XSD_DECIMAL, STRING, "1e", False),
+            (XSD_DECIMAL, INTEGER, "3", True), (XSD_DECIMAL, NUMBER, "0.25", True),
+            (XSD_BOOLEAN, STRING, "true", True), (XSD_BOOLEAN, STRING, "1", True),
+            (XSD_BOOLEAN, STRING, "yes", False), (XSD_BOOLEAN, BOOLEAN, "false", True),
+            (XSD_DATE, STRING, "2024-02-29", True), (XSD_DATE, STRING, "2023-02-29", False),
+            (XSD_DATE, STRING, "1900-02-29", False), (XSD_DATE, STRING, "2000-02-29Z", True),
+            (XSD_DATE, STRING, "2024-13-01", False), (XSD_DATE, STRING, "24-01-01", False),
+            (XSD_DATETIME, STRING, "2024-05-01T24:00:00", True),
+            (XSD_DATETIME, STRING, "2024-05-01T24:00:01", False),
+            (XSD_DATETIME, STRING, "2024-05-01T24:00:00.000", True),
+            (XSD_DATETIME, STRING, "2024-05-01T24:00:00.001", False),
+            (XSD_TIME, STRING, "24:00:00.5", False),
+            (XSD_DATETIME, STRING, "2024-05-01T10:30:00.125+05:30", True),
+            (XSD_DATETIME, STRING, "2024-05-01T10:30:00+15:00", False),
+            (XSD_DATETIME, STRING, "2024-05-01", False),
+            (XSD_TIME, STRING, "23:59:59", True), (XSD_TIME, STRING, "23:60:00", False),
+            (XSD_ANY_URI, STRING, "http://x.org/a#b", True), (XSD_ANY_URI, STRING, "a b", False),
+            (XSD_STRING, STRING, "", True), (XSD_STRING, INTEGER, "5", False),
+            (XSD_STRING | XSD_INTEGER, INTEGER, "5", True),
+        ]
+        program = ShapeProgram(1)
+        for prop, (mask, *_rest) in enumerate(cases):
+            program.add_rule(0, DATATYPE, prop, mask)
+        program.compile()
+        row = [(prop, kind, text, SHP_NONE) for prop, (_, kind, text, _ok) in enumerate(cases)]
+        found, _ = program.validate(ShapeBatch([[0]], [row]))
+        assert {v[2] for v in found} == {k for k, c in enumerate(cases) if not c[3]}
+
+        # Additions after compiling, out-of-range IDs and bad batches
+        with pytest.raises(ValueError):
+            program.add_rule(0, MIN_COUNT, 0, 1)
+        with pytest.raises(ValueError):
+            program.validate(ShapeBatch([[1]], [[]]))
+        with pytest.raises(ValueError):
+            program.validate(ShapeBatch([[0]], [[(0, REF, "x", 1)]]))
+        with pytest.raises(ValueError):
+            ShapeBatch([], [[]])
+        fresh = ShapeProgram(2)
+        with pytest.raises(ValueError):
+            fresh.add_parent(0, 2)
+        with pytest.raises(ValueError):
+            fresh.add_rule(0, 9, 0, 0)
+        with pytest.raises(ValueError):
+            fresh.add_rule(0, RANGE, 0, 0)          # no class set 0 yet
+        with pytest.raises(ValueError):
+            fresh.validate(ShapeBatch([[0]], [[]]))
+        fresh.close()
+        with pytest.raises(ValueError):
+            fresh.compile()
@@ -4,9 +4,15 @@ Core Layer Tests: SimpleDB C Library
 Tests the C library directly through the adapter layer.
 Focus: C library functionality, memory management, edge cases.
 
-Test IDs: TC-C-001 through TC-C-018
+Test IDs: TC-C-001 through TC-C-027, TC-C-044 through TC-C-046, TC-C-076,
+          TC-C-079 through TC-C-084
 """
 
+import random
+import struct
+import threading
+import time
+
 import pytest
 from adapters import SimpleDB
 
@@ -258,6 +264,36 @@ class TestStressTests:
 
         assert simple_db.count() == 5
 
+    def test_reads_during_writes(self, simple_db):
+        """
+        TC-C-081: Reads Racing Writes
+
+        Verify get() and mget() from one thread always return a whole
+        value while another thread keeps overwriting (and so freeing)
+        the values being read.
+        """
+        values = ["a" * 4096, "b" * 16, "c" * 1024]
+        keys = [f"k{i}" for i in range(8)]
+        for key in keys:
+            simple_db.set(key, values[0])
+        stop = threading.Event()
+
+        def writer():
+            i = 0
+            while not stop.is_set():
+                simple_db.set(keys[i % len(keys)], values[i % len(values)])
+                i += 1
+
+        thread = threading.Thread(target=writer)
+        thread.start()
+        try:
+            for _ in range(2000):
+                assert simple_db.get(keys[0]) in values
+                assert all(v in values for v in simple_db.mget(keys))
+        finally:
+            stop.set()
+            thread.join()
+
 
 class TestMemoryManagement:
     """Test memory-related functionality"""
@@ -315,6 +351,487 @@ class TestStatistics:
         assert stats['max_chain_length'] >= 1
 
 
+class TestSnapshots:
+    """Test multi-version point-in-time reads"""
+
+    def test_snapshot_isolated_from_writes(self, populated_db):
+        """
+        TC-C-019: Snapshot Isolation
+
+        Verify a snapshot keeps seeing values that were later updated,
+        deleted or added.
+        """
+        with populated_db.snapshot() as snap:
+            populated_db.set("user:1", "changed")
+            populated_db.delete("user:2")
+            populated_db.set("user:4", "Dave")
+
+            assert snap.get("user:1") == "Alice"
+            assert snap.exists("user:2")
+            assert not snap.exists("user:4")
+            assert snap.count() == 5
+
+        assert populated_db.get("user:1") == "changed"
+        assert populated_db.get("user:2") is None
+        assert populated_db.count() == 5
+
+    def test_snapshot_survives_clear(self, populated_db):
+        """
+        TC-C-020: Snapshot Across Clear
+
+        Verify clear() does not affect a held snapshot.
+        """
+        with populated_db.snapshot() as snap:
+            populated_db.clear()
+            assert populated_db.count() == 0
+            assert snap.count() == 5
+            assert set(snap.keys()) == {
+                "user:1", "user:2", "user:3", "item:1", "item:2"
+            }
+
+    def test_multiple_snapshots(self, simple_db):
+        """
+        TC-C-021: Independent Snapshots
+
+        Verify snapshots taken at different times see different versions.
+        """
+        simple_db.set("k", "v1")
+        first = simple_db.snapshot()
+        simple_db.set("k", "v2")
+        second = simple_db.snapshot()
+        simple_db.set("k", "v3")
+
+        assert first.get("k") == "v1"
+        assert second.get("k") == "v2"
+        assert simple_db.get("k") == "v3"
+        assert first.version < second.version <= simple_db.version()
+
+        first.release()
+        assert second.get("k") == "v2"
+        second.release()
+
+    def test_versions_reclaimed_on_release(self, simple_db):
+        """
+        TC-C-022: Version Reclamation
+
+        Verify superseded versions are freed once no snapshot needs them.
+        """
+        simple_db.set("k", "v0")
+        snap = simple_db.snapshot()
+        for i in range(10):
+            simple_db.set("k", f"v{i + 1}")
+        simple_db.delete("k")
+
+        stats = simple_db.stats()
+        assert stats['active_snapshots'] == 1
+        assert stats['retained_versions'] > 0
+
+        snap.release()
+        stats = simple_db.stats()
+        assert stats['active_snapshots'] == 0
+        assert stats['retained_versions'] == 0
+        assert simple_db.count() == 0
+
+    def test_released_snapshot_rejected(self, simple_db):
+        """
+        TC-C-023: Use After Release
+
+        Verify a released snapshot raises instead of reading freed memory.
+        """
+        snap = simple_db.snapshot()
+        snap.release()
+        snap.release()  # idempotent
+
+        assert snap.released
+        with pytest.raises(RuntimeError):
+            snap.get("k")
+
+    def test_apply_is_one_commit(self, populated_db):
+        """
+        TC-C-076: Atomic Batches
+
+        Verify apply() lands sets and deletes under a single version, with
+        and without snapshots or history held: a snapshot taken before sees
+        none of it, a version before or after sees all or nothing, and a
+        repeated key keeps its last write.
+        """
+        before = populated_db.version()
+        with populated_db.snapshot() as snap:
+            assert populated_db.apply([
+                ("user:1", "changed"), ("user:2", None), ("user:9", "new"),
+                ("user:9", "newer"), ("item:1", None), ("item:1", "back"), ("nope", None),
+            ])
+            assert snap.get("user:1") == "Alice" and snap.exists("user:2")
+            assert not snap.exists("user:9") and snap.count() == 5
+        assert populated_db.version() == before + 1
+        assert populated_db.get("user:1") == "changed"
+        assert populated_db.get("user:2") is None
+        assert populated_db.get("user:9") == "newer"
+        assert populated_db.get("item:1") == "back"
+        assert populated_db.count() == 5
+
+        # Single-version fast path (no snapshot) and time travel
+        assert populated_db.apply([("a", "1"), ("a", None), ("b", "2")])
+        populated_db.enable_history()
+        mark = populated_db.version()
+        assert populated_db.apply([(f"k{i}", str(i)) for i in range(500)] + [("b", None)])
+        assert populated_db.version() == mark + 1
+        with populated_db.snapshot_at(mark) as old:
+            assert old.get("b") == "2" and not old.exists("k0")
+        with populated_db.snapshot_at(mark + 1) as new:
+            assert new.count() == populated_db.count() == 505
+            assert new.get("k499") == "499" and not new.exists("b")
+        assert not populated_db.exists("a")
+
+        assert populated_db.apply([]) and populated_db.version() == mark + 1
+        with pytest.raises(TypeError):
+            populated_db.apply([("k", 1)])
+
+    def test_apply_if_version(self, populated_db):
+        """
+        TC-C-082: Conditional Batches
+
+        Verify apply_if() commits only while the database is still at the
+        expected version, and that a lost race applies nothing.
+        """
+        with populated_db.snapshot() as snap:
+            seen = snap.version
+        assert populated_db.apply_if(seen, [("user:1", "first"), ("new", "1")])
+        assert populated_db.version() == seen + 1
+
+        # Computed from the same read, so it must not overwrite the first
+        assert not populated_db.apply_if(seen, [("user:1", "second"), ("user:2", None)])
+        assert populated_db.get("user:1") == "first" and populated_db.exists("user:2")
+        assert populated_db.version() == seen + 1
+
+        assert populated_db.apply_if(seen + 1, [])
+        assert populated_db.version() == seen + 1
+        with pytest.raises(TypeError):
+            populated_db.apply_if(seen + 1, [("k", 1)])
+
+
+class TestHistory:
+    """Test temporal history (reads at arbitrary past versions)"""
+
+    def test_every_version_readable(self, simple_db):
+        """
+        TC-C-044: Time Travel
+
+        Verify random sets, deletes and clears can all be read back at
+        every version committed since history was enabled.
+        """
+        simple_db.set("pre", "x")
+        simple_db.enable_history()
+        rng = random.Random(11)
+        state, states = {"pre": "x"}, {simple_db.version(): {"pre": "x"}}
+        for i in range(600):
+            key = f"k{rng.randrange(12)}"
+            op = rng.random()
+            if op < 0.6:
+                simple_db.set(key, str(i))
+                state[key] = str(i)
+            elif op < 0.95:
+                if not simple_db.delete(key):
+                    continue
+                del state[key]
+            else:
+                simple_db.clear()
+                state = {}
+            states[simple_db.version()] = dict(state)
+
+        for version, expected in states.items():
+            with simple_db.snapshot_at(version) as snap:
+                assert dict(snap.items()) == expected
+        assert simple_db.history_enabled
+
+    def test_version_at_time(self, simple_db):
+        """
+        TC-C-045: Time Index
+
+        Verify wall-clock times map to the last version committed by then.
+        """
+        simple_db.enable_history()
+        simple_db.set("k", "v1")
+        v1 = simple_db.version()
+        time.sleep(0.005)
+        between = int(time.time() * 1000)
+        time.sleep(0.005)
+        simple_db.set("k", "v2")
+
+        assert simple_db.version_at(between) == v1
+        assert simple_db.version_at(int(time.time() * 1000)) == simple_db.version()
+        assert simple_db.version_at(0) == 0
+        assert simple_db.version_time(v1) <= between
+        with simple_db.snapshot_at(simple_db.version_at(between)) as snap:
+            assert snap.get("k") == "v1"
+
+    def test_compact_drops_old_history(self, simple_db):
+        """
+        TC-C-046: Compaction
+
+        Verify compaction frees versions below the floor, keeps the floor
+        readable and leaves held snapshots intact.
+        """
+        simple_db.enable_history()
+        versions = []
+        for i in range(100):
+            simple_db.set("k", str(i))
+            versions.append(simple_db.version())
+        held = simple_db.snapshot_at(versions[10])
+
+        freed = simple_db.compact(versions[50])
+
+        assert freed == 10
+        assert held.get("k") == "10"
+        with pytest.raises(ValueError):
+            simple_db.snapshot_at(versions[5])
+        held.release()
+        assert simple_db.compact(versions[50]) == 0
+        assert simple_db.history_floor() == versions[50]
+        with simple_db.snapshot_at(versions[50]) as snap:
+            assert snap.get("k") == "50"
+        with pytest.raises(ValueError):
+            simple_db.snapshot_at(versions[20])
+        assert simple_db.stats()['retained_versions'] == 49
+
+    @pytest.mark.parametrize("via", ["apply", "replay"])
+    def test_compact_with_repeated_keys(self, via):
+        """
+        TC-C-083: Compaction Of Repeated Writes
+
+        Verify compaction at every floor keeps past reads right when each
+        commit wrote the key twice (so two versions share a number), both
+        for apply() and for replayed log records.
+        """
+        for floor in range(3, 120, 7):
+            db = SimpleDB()
+            db.enable_history()
+            source = db if via == "apply" else SimpleDB()
+            if via == "replay":
+                source.enable_log(max_bytes=1 << 20)
+            for i in range(128):
+                source.apply([("k", f"a{i}"), ("k", f"b{i}")])
+            if via == "replay":
+                assert db.replay(source.log_read(0)[0])
+            first = 1                       # one local commit per batch
+
+            db.compact(first + floor)
+            db.apply([(f"pad:{i}", "x" * 40) for i in range(200)])   # reuse freed slots
+            for i in range(floor, 128):
+                with db.snapshot_at(first + i) as snap:
+                    assert snap.get("k") == f"b{i}"
+
+
+class TestReplicationLog:
+    """Test the mutation log, dumps and replay onto replicas"""
+
+    def test_log_replay_matches_leader(self, populated_db):
+        """
+        TC-C-079: Log Shipping
+
+        Verify replaying the log in size-limited chunks reproduces every
+        kind of write, that each leader commit lands as one replica commit
+        (a replica snapshot never sees part of one), and that positions
+        advance over commits that changed nothing.
+        """
+        leader = populated_db
+        leader.enable_log()
+        assert leader.log_enabled and leader.log_floor() == leader.version()
+        replica = SimpleDB()
+        seed, position = leader.dump()
+        assert replica.replay(seed) and position == leader.version()
+
+        leader.set("user:1", "Alicia")
+        leader.delete("user:2")
+        leader.delete("user:2")                                  # no commit
+        leader.apply([("nope", None)])                           # commit, no records
+        leader.apply([(f"batch:{i}", "x" * i) for i in range(200)] + [("item:1", None)])
+        leader.clear()
+        leader.apply([("after", "clear"), ("k:1", "1"), ("k:2", "2")])
+        leader.set("", "empty key")
+        stats = leader.stats()
+        assert stats['log_records'] == 208 and stats['log_bytes'] > 0
+
+        chunks = 0
+        while position < leader.version():
+            records, through = leader.log_read(position, max_bytes=256)
+            assert through > position
+            with replica.snapshot() as before:
+                count = before.count()
+                assert replica.replay(records)
+                assert before.count() == count                   # untouched
+            position = through
+            chunks += 1
+        assert chunks >= 3
+        assert sorted(replica.items()) == sorted(leader.items())
+        assert leader.log_read(position) == (b"", position)
+
+        # The batch arrives whole even when larger than max_bytes
+        leader.apply([(f"big:{i}", "y" * 100) for i in range(50)])
+        records, through = leader.log_read(position, max_bytes=16)
+        assert through == leader.version() and replica.replay(records)
+        assert replica.count() == leader.count() == 54
+
+    def test_floor_dump_and_rejection(self, simple_db):
+        """
+        TC-C-080: Catch-Up And Rejection
+
+        Verify the log drops whole old commits past its limit and refuses
+        positions below its floor or ahead of the leader, that a snapshot
+        dump plus the log tail catches a replica up, and that malformed
+        records are rejected with nothing applied.
+        """
+        leader = simple_db
+        assert leader.log_read(0) is None                        # no log yet
+        leader.enable_log(max_bytes=4096)
+        for i in range(500):
+            leader.set(f"k{i % 50}", str(i))
+        floor = leader.log_floor()
+        assert floor > 0 and leader.stats()['log_bytes'] <= 4096
+        assert leader.log_read(floor - 1) is None
+        assert leader.log_read(leader.version() + 1) is None
+        assert leader.log_read(floor) is not None
+
+        replica = SimpleDB()
+        replica.set("stale", "1")
+        with leader.snapshot() as snap:
+            leader.set("k0", "later")
+            leader.delete("k1")
+            seed, version = leader.dump(snap)
+            assert version == snap.version
+        assert replica.replay(seed) and not replica.exists("stale")
+        assert replica.get("k0") == "450"
+        records, through = leader.log_read(version)
+        assert replica.replay(records) and through == leader.version()
+        assert sorted(replica.items()) == sorted(leader.items())
+
+        # Replicas log what they replay, so they can serve followers in turn
+        replica.enable_log()
+        seed, mark = replica.dump()
+        leader.set("chained", "yes")
+        assert replica.replay(leader.log_read(through)[0])
+        downstream = SimpleDB()
+        assert downstream.replay(seed) and not downstream.exists("chained")
+        assert downstream.replay(replica.log_read(mark)[0])
+        assert sorted(downstream.items()) == sorted(leader.items())
+
+        version = replica.version()
+        good = leader.log_read(through)[0]
+        for bad in (b"abc", good[:-1], good[:20] + b"\x00" + good[21:],
+                    good.replace(b"chained\x00", b"chaine\x00d")):
+            assert not replica.replay(bad)
+        assert replica.version() == version
+        assert replica.replay(b"") and replica.version() == version
+        with pytest.raises(TypeError):
+            replica.replay("text")
+
+    def test_clear_inside_commit(self):
+        """
+        TC-C-084: Clear Inside A Commit
+
+        Verify a leader commit that writes, clears and writes again lands
+        as one replica commit holding only what follows the clear, both on
+        a single-version replica and under a reader's snapshot, and that
+        the replica logs a commit its own followers replay the same way.
+        """
+        def record(version, key=None, value=None):
+            k = key.encode() + b"\x00" if key is not None else b""
+            v = value.encode() + b"\x00" if value is not None else b""
+            return struct.pack("<QII", version, len(k), len(v)) + k + v
+
+        records = b"".join([
+            record(7, "q", "Q"), record(7, "pre", None), record(7),
+            record(7, "r", "R"), record(7, "a", "A2"), record(7, "r", None),
+            record(8, "s", "S"),
+        ])
+        for pinned in (False, True):
+            replica = SimpleDB()
+            replica.enable_log()
+            replica.apply([("pre", "P"), ("a", "A")])
+            start = replica.version()
+            snap = replica.snapshot() if pinned else None
+            assert replica.replay(records)
+            assert replica.version() == start + 2
+            assert sorted(replica.items()) == [("a", "A2"), ("s", "S")]
+            if snap:
+                with snap:
+                    assert sorted(snap.items()) == [("a", "A"), ("pre", "P")]
+
+            follower = SimpleDB()
+            follower.apply([("pre", "P"), ("a", "A")])
+            assert follower.replay(replica.log_read(start)[0])
+            assert sorted(follower.items()) == sorted(replica.items())
+
+
+class TestAllocationPolicies:
+    """Test huge-page / NUMA table allocation options"""
+
+    @pytest.mark.parametrize("pages", ["default", "transparent", "hugetlb"])
+    @pytest.mark.parametrize("numa", ["default", "interleave"])
+    def test_policy_roundtrip(self, pages, numa):
+        """
+        TC-C-024: Operations Under Every Policy
+
+        Verify CRUD, snapshots and clear behave identically whatever
+        allocation policy is requested.
+        """
+        db = SimpleDB(pages=pages, numa=numa, initial_capacity=4096)
+        for i in range(2000):
+            assert db.set(f"key_{i}", f"value_{i}")
+        for i in range(0, 2000, 2):
+            assert db.delete(f"key_{i}")
+
+        with db.snapshot() as snap:
+            db.clear()
+            assert snap.count() == 1000
+            assert snap.get("key_1") == "value_1"
+
+        assert db.count() == 0
+        assert db.stats()['retained_versions'] == 0
+
+    def test_policy_reported_in_stats(self):
+        """
+        TC-C-025: Effective Policy Reporting
+
+        Verify stats report the policy obtained, which may be weaker than
+        the one requested but never stronger.
+        """
+        order = ["default", "transparent", "hugetlb"]
+        db = SimpleDB(pages="hugetlb")
+        db.set("k", "v")
+        stats = db.stats()
+
+        assert order.index(stats['page_policy']) <= order.index("hugetlb")
+        assert stats['table_bytes'] > 0
+        assert stats['huge_page_bytes'] <= stats['table_bytes']
+        if stats['page_policy'] != "default":
+            assert stats['huge_page_bytes'] > 0
+
+    def test_unavailable_numa_node_falls_back(self):
+        """
+        TC-C-026: NUMA Fallback
+
+        Verify binding to a node that does not exist still yields a working
+        table, reported as first-touch placement.
+        """
+        db = SimpleDB(numa="bind", numa_node=63)
+        db.set("k", "v")
+
+        assert db.get("k") == "v"
+        assert db.stats()['numa_policy'] == "default"
+
+    def test_unknown_policy_rejected(self):
+        """
+        TC-C-027: Invalid Policy Names
+
+        Verify unknown policy names raise ValueError.
+        """
+        with pytest.raises(ValueError):
+            SimpleDB(pages="giant")
+        with pytest.raises(ValueError):
+            SimpleDB(numa="spread")
+
+
 # ============================================================================
 # PERFORMANCE BENCHMARKS
 # ============================================================================
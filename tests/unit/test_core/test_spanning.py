@@ -0,0 +1,160 @@
+"""
+Core Layer Tests: spanning C Library
+
+Tests minimum spanning forests and Steiner trees through the adapter layer.
+Focus: optimal weights, determinism, approximation bound and rejection.
+
+Test IDs: TC-C-062 through TC-C-064
+"""
+
+import itertools
+import random
+
+import pytest
+from adapters import GraphStore, minimum_spanning_tree, steiner_tree
+
+
+def _graph(edges, track_in=True):
+    g = GraphStore(track_in=track_in)
+    g.add_edges([a for a, _, _ in edges], [b for _, b, _ in edges], [w for _, _, w in edges])
+    g.flush()
+    return g
+
+
+def _random_edges(rng, n, m):
+    return [(rng.randrange(n), rng.randrange(n), float(rng.randint(1, 20))) for _ in range(m)]
+
+
+def _undirected(edges):
+    """Lighter direction per unordered pair (a later insert of an edge
+    replaces it), without self-loops"""
+    directed = {(a, b): w for a, b, w in edges if a != b}
+    best = {}
+    for (a, b), w in directed.items():
+        key = (min(a, b), max(a, b))
+        best[key] = min(w, best.get(key, w))
+    return best
+
+
+def _find(parent, u):
+    while parent.setdefault(u, u) != u:
+        u = parent[u]
+    return u
+
+
+def _kruskal(pairs):
+    parent, total, count = {}, 0.0, 0
+    for (a, b), w in sorted(pairs.items(), key=lambda item: item[1]):
+        ra, rb = _find(parent, a), _find(parent, b)
+        if ra != rb:
+            parent[ra] = rb
+            total += w
+            count += 1
+    return total, count
+
+
+def _is_forest(edges):
+    parent = {}
+    for a, b, _ in edges:
+        ra, rb = _find(parent, a), _find(parent, b)
+        if ra == rb:
+            return False
+        parent[ra] = rb
+    return True
+
+
+class TestMinimumSpanningTree:
+    """Test Borůvka spanning forests"""
+
+    def test_matches_kruskal(self):
+        """
+        TC-C-062: Minimum Spanning Forest
+
+        Verify the forest weight and size match Kruskal on random directed
+        multigraphs, every edge exists, the forest counts its trees, and
+        the result does not depend on the thread count.
+        """
+        rng = random.Random(7)
+        for n, m in ((30, 40), (200, 900), (3000, 12000)):
+            edges = _random_edges(rng, n, m)
+            pairs = _undirected(edges)
+            linked = {u for pair in pairs for u in pair}
+            with _graph(edges).view() as view:
+                forest, stats = minimum_spanning_tree(view, threads=1)
+                weight, count = _kruskal(pairs)
+                assert stats['weight'] == pytest.approx(weight)
+                assert stats['edges'] == len(forest) == count
+                assert stats['components'] == len(linked) - count
+                assert all(pairs[(a, b)] == w for a, b, w in forest)
+                assert _is_forest(forest)
+                assert minimum_spanning_tree(view, threads=4)[0] == forest
+
+                hops, stats = minimum_spanning_tree(view, unweighted=True)
+                assert stats['weight'] == len(hops) == count
+
+
+class TestSteinerTree:
+    """Test Mehlhorn Steiner trees"""
+
+    def test_joins_terminals_within_bound(self):
+        """
+        TC-C-063: Steiner Approximation
+
+        Verify the tree joins all terminals with no spare leaves and weighs
+        at most twice the optimum found by brute force on small graphs.
+        """
+        rng = random.Random(3)
+        for trial in range(25):
+            n = 9
+            edges = _random_edges(rng, n, 18) + [(u, u + 1, 20.0) for u in range(n - 1)]
+            pairs = _undirected(edges)
+            terminals = rng.sample(range(n), rng.randint(2, 4))
+            with _graph(edges).view() as view:
+                tree, stats = steiner_tree(view, terminals + terminals[:1])
+            assert stats['components'] == 1
+            assert _is_forest(tree)
+            assert all(pairs[(min(a, b), max(a, b))] == w for a, b, w in tree)
+            nodes = {u for a, b, _ in tree for u in (a, b)}
+            assert set(terminals) <= nodes
+            degree = {u: sum(u in (a, b) for a, b, _ in tree) for u in nodes}
+            assert all(degree[u] > 1 for u in nodes - set(terminals))
+
+            # Optimum: the cheapest spanning tree over terminals plus any
+            # subset of other nodes
+            others = [u for u in range(n) if u not in terminals]
+            optimum = float('inf')
+            for k in range(len(others) + 1):
+                for extra in itertools.combinations(others, k):
+                    keep = set(terminals) | set(extra)
+                    induced = {p: w for p, w in pairs.items() if set(p) <= keep}
+                    weight, count = _kruskal(induced)
+                    if count == len(keep) - 1:
+                        optimum = min(optimum, weight)
+            assert optimum <= stats['weight'] <= 2 * optimum + 1e-9
+
+    def test_disconnected_and_rejected(self):
+        """
+        TC-C-064: Steiner Edge Cases
+
+        Verify disconnected terminals yield a forest, a single terminal an
+        empty tree, hop counts with unweighted, and rejection of negative
+        weights, out-of-range terminals and views without in-adjacency.
+        """
+        edges = [(0, 1, 1.0), (1, 2, 1.0), (0, 2, 5.0), (3, 4, 2.0)]
+        with _graph(edges).view() as view:
+            tree, stats = steiner_tree(view, [0, 2, 3, 4])
+            assert sorted(tree) == [(0, 1, 1.0), (1, 2, 1.0), (3, 4, 2.0)]
+            assert stats['components'] == 2 and stats['weight'] == 4.0
+            assert steiner_tree(view, [1])[0] == []
+            hops, _ = steiner_tree(view, [0, 2], unweighted=True)
+            assert hops == [(0, 2, 1.0)]
+            with pytest.raises(ValueError):
+                steiner_tree(view, [0, 9])
+
+        with _graph([(0, 1, -1.0)]).view() as view:
+            with pytest.raises(ValueError):
+                steiner_tree(view, [0, 1])
+            assert steiner_tree(view, [0, 1], unweighted=True)[1]['edges'] == 1
+        with _graph([(0, 1, 1.0)], track_in=False).view() as view:
+            with pytest.raises(ValueError):
+                minimum_spanning_tree(view)
@@ -0,0 +1,104 @@
+"""
+Core Layer Tests: text_match C Library
+
+Tests dictionary phrase matching through the adapter layer.
+Focus: token boundaries, overlap resolution, negation and fuzzy matches.
+
+Test IDs: TC-C-065 through TC-C-066
+"""
+
+import random
+
+import pytest
+from adapters import PhraseDict
+from adapters.text_match import TM_NEGATION, TM_TERMINATOR
+
+
+def _dict(terms, cues=(), terminators=()):
+    d = PhraseDict()
+    for value, phrase in enumerate(terms):
+        assert d.add(phrase, value)
+    for cue in cues:
+        d.add(cue, 0, TM_NEGATION)
+    for word in terminators:
+        d.add(word, 0, TM_TERMINATOR)
+    d.build()
+    return d
+
+
+def _found(d, text, **kwargs):
+    return [(m['value'], m['text']) for m in d.scan(text, **kwargs)[0]]
+
+
+class TestExactMatching:
+    """Test the Aho-Corasick automaton"""
+
+    def test_boundaries_overlaps_and_folding(self):
+        """
+        TC-C-065: Exact Dictionary Matches
+
+        Verify case and punctuation folding, whole-token matching,
+        leftmost-longest overlap resolution, character offsets for UTF-8
+        text, and agreement with a brute-force matcher on random text.
+        """
+        d = _dict(["headache", "severe headache", "ache", "sore throat", "flu", "flu-like"])
+        assert _found(d, "SEVERE Headache; sore-throat") == [(1, "SEVERE Headache"),
+                                                             (3, "sore-throat")]
+        assert _found(d, "headaches, an ache", max_edits=0) == [(2, "ache")]
+        assert _found(d, "headaches, an ache") == [(0, "headaches"), (2, "ache")]
+        assert _found(d, "flu like symptoms, influenza") == [(5, "flu like")]
+        matches, stats = d.scan("Fièvre — sore throat")
+        assert matches[0]['start'] == 9 and matches[0]['text'] == "sore throat"
+        assert stats == {'tokens': 3, 'covered': 2, 'terms': 1}
+
+        with pytest.raises(ValueError):
+            d.add("late", 9)
+        assert not PhraseDict().add("--", 0)
+
+        # Against a brute-force scan of random token streams
+        rng = random.Random(5)
+        words = ["ab", "abc", "b", "bc", "cab", "x"]
+        terms = sorted({" ".join(rng.choices(words, k=rng.randint(1, 3))) for _ in range(30)})
+        d = _dict(terms)
+        for _ in range(200):
+            tokens = rng.choices(words, k=12)
+            got = [(m['value'], m['start']) for m in d.scan(" ".join(tokens), max_edits=0)[0]]
+            expected, k = [], 0
+            while k < len(tokens):
+                best = max((n for n in range(1, 4) if " ".join(tokens[k:k + n]) in terms),
+                           default=0)
+                if best:
+                    start = len(" ".join(tokens[:k])) + (1 if k else 0)
+                    expected.append((terms.index(" ".join(tokens[k:k + best])), start))
+                k += best or 1
+            assert got == expected
+
+
+class TestNegationAndFuzzy:
+    """Test negation scopes and the edit-distance fallback"""
+
+    def test_scopes_and_typos(self):
+        """
+        TC-C-066: Negation and Fuzzy Matches
+
+        Verify negation reaches list items in its clause and window, stops
+        at terminators and clause punctuation, and typos within the edit
+        bound match while short phrases and first-letter changes do not.
+        """
+        d = _dict(["fever", "cough", "nausea", "chills", "rash", "shortness of breath"],
+                  cues=["no", "denies"], terminators=["but"])
+        negated = {m['text']: m['negated'] for m in
+                   d.scan("No fever, cough or nausea but chills. Denies rash")[0]}
+        assert negated == {"fever": True, "cough": True, "nausea": True,
+                           "chills": False, "rash": True}
+        assert [m['negated'] for m in d.scan("no fever. cough")[0]] == [True, False]
+        assert d.scan("no one two three four five six fever")[0][0]['negated'] is False
+        assert d.scan("no fever", negation_window=0)[0][0]['negated'] is False
+
+        fuzzy = d.scan("fevr, coughh and rahs")[0]
+        assert [(m['value'], m['fuzzy'], m['distance']) for m in fuzzy] == [(0, True, 1),
+                                                                           (1, True, 1)]
+        assert _found(d, "tough day") == []
+        assert _found(d, "fevr", max_edits=0) == []
+        assert _found(d, "shortnes of breth") == []
+        assert _found(d, "shortnes of breth", max_edits=2) == [(5, "shortnes of breth")]
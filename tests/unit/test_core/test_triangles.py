@@ -0,0 +1,119 @@
+"""
+Core Layer Tests: triangles C Library
+
+Tests the native triangle counter through the adapter layer.
+Focus: agreement with a reference count, estimate accuracy, edge cases.
+
+Test IDs: TC-C-050 through TC-C-052
+"""
+
+import itertools
+import random
+
+import pytest
+from adapters import GraphStore, count_triangles, estimate_triangles
+
+
+def _random_graph(rng, nodes, edges, hubs=0):
+    g = GraphStore()
+    pairs = {(rng.randrange(nodes), rng.randrange(nodes)) for _ in range(edges)}
+    for hub in range(hubs):
+        pairs |= {(hub, rng.randrange(nodes)) for _ in range(nodes // 2)}
+    g.add_edges([s for s, _ in pairs], [d for _, d in pairs])
+    g.flush()
+    return g, pairs
+
+
+def _reference(nodes, pairs):
+    adj = [set() for _ in range(nodes)]
+    for s, d in pairs:
+        if s != d:
+            adj[s].add(d)
+            adj[d].add(s)
+    per_node = [0] * nodes
+    for u, v, w in itertools.combinations(range(nodes), 3):
+        if v in adj[u] and w in adj[u] and w in adj[v]:
+            for x in (u, v, w):
+                per_node[x] += 1
+    wedges = sum(len(a) * (len(a) - 1) // 2 for a in adj)
+    clustering = [2 * t / (len(a) * (len(a) - 1)) if len(a) > 1 else 0.0
+                  for t, a in zip(per_node, adj)]
+    return sum(per_node) // 3, wedges, per_node, clustering
+
+
+class TestExactCount:
+    """Test exact triangle counts against a reference"""
+
+    def test_matches_reference(self):
+        """
+        TC-C-050: Random Graphs
+
+        Verify totals, per-node counts and local clustering coefficients
+        match a brute-force count on random graphs with reciprocal edges,
+        self-loops and hubs, for one and several threads.
+        """
+        rng = random.Random(5)
+        for trial in range(12):
+            nodes = rng.randrange(5, 70)
+            g, pairs = _random_graph(rng, nodes, rng.randrange(10, 400), hubs=trial % 3)
+            triangles, wedges, per_node, clustering = _reference(nodes, pairs)
+            with g.view() as view:
+                for threads in (1, 3):
+                    stats, tri, cc = count_triangles(view, per_node=True, threads=threads)
+                    assert stats['triangles'] == triangles
+                    assert stats['wedges'] == wedges
+                    assert list(tri) == per_node
+                    assert list(cc) == pytest.approx(clustering)
+                    totals, none_tri, none_cc = count_triangles(view, threads=threads)
+                    assert totals['triangles'] == triangles
+                    assert none_tri is None and none_cc is None
+                    assert totals['avg_clustering'] is None
+
+
+class TestEstimate:
+    """Test sampled estimates"""
+
+    def test_estimate_close_and_deterministic(self):
+        """
+        TC-C-051: Wedge Sampling
+
+        Verify estimates land near the exact values and depend only on the
+        seed, not on the thread count.
+        """
+        rng = random.Random(8)
+        g, _ = _random_graph(rng, 3000, 30000, hubs=4)
+        with g.view() as view:
+            exact, _, cc = count_triangles(view, per_node=True)
+            one = estimate_triangles(view, samples=200000, seed=3, threads=1)
+            many = estimate_triangles(view, samples=200000, seed=3, threads=4)
+        assert one == many
+        assert one['approximate'] and not exact['approximate']
+        assert one['wedges'] == exact['wedges']
+        assert one['transitivity'] == pytest.approx(exact['transitivity'], abs=0.01)
+        assert one['avg_clustering'] == pytest.approx(exact['avg_clustering'], abs=0.01)
+
+
+class TestEdgeCases:
+    """Test degenerate inputs"""
+
+    def test_empty_and_untracked(self):
+        """
+        TC-C-052: Empty Graph / Missing In-Adjacency
+
+        Verify an empty graph yields zeros and a view without in-adjacency
+        is rejected.
+        """
+        with GraphStore().view() as view:
+            stats, tri, cc = count_triangles(view, per_node=True)
+            assert stats['triangles'] == 0 and stats['transitivity'] == 0
+            assert len(tri) == 0 and len(cc) == 0
+            assert estimate_triangles(view)['triangles'] == 0
+
+        g = GraphStore(track_in=False)
+        g.add_edges([0, 1, 2], [1, 2, 0])
+        g.flush()
+        with g.view() as view:
+            with pytest.raises(ValueError):
+                count_triangles(view)
+            with pytest.raises(ValueError):
+                estimate_triangles(view)
@@ -0,0 +1,140 @@
+"""
+Core Layer Tests: ts_store C Library
+
+Tests the time-series store through the adapter layer.
+Focus: codec round trip, ordering, block summaries, retention.
+
+Test IDs: TC-C-035 through TC-C-039
+"""
+
+import random
+
+import pytest
+from adapters import TimeSeriesStore
+from adapters.ts_store import DAY_MS, STATUSES
+
+HOUR_MS = 3_600_000
+
+
+class TestCodec:
+    """Test that compressed blocks decode to what was written"""
+
+    def test_random_round_trip(self):
+        """
+        TC-C-035: Round Trip
+
+        Verify irregular timestamps, arbitrary doubles, status changes and
+        ref jumps all decode exactly, across many blocks.
+        """
+        ts = TimeSeriesStore(HOUR_MS)
+        rng = random.Random(3)
+        statuses = list(STATUSES)
+        expected = []
+        t = 1_700_000_000_000
+        for i in range(3000):
+            t += rng.choice([0, 1, 60_000, 60_000, rng.randrange(10 ** 7)])
+            duration = rng.choice([0.5, 0.5, rng.random() * 100, -rng.random()])
+            point = {'ts': t, 'status': rng.choice(statuses),
+                     'duration': duration, 'ref': rng.choice([i, rng.randrange(1 << 32)])}
+            assert ts.append("s", point['ts'], point['status'], point['duration'], point['ref'])
+            expected.append(point)
+
+        assert ts.scan("s") == expected
+        assert ts.count("s") == 3000
+        assert ts.stats()['blocks'] > 1
+
+    def test_regular_series_compresses(self):
+        """
+        TC-C-036: Compression
+
+        Verify a regular series (fixed interval, stable duration) encodes to
+        a small fraction of its raw size.
+        """
+        ts = TimeSeriesStore()
+        for i in range(10000):
+            ts.append("s", i * 60_000, 'passed' if i % 100 else 'failed', 0.25, i)
+
+        stats = ts.stats()
+        assert stats['points'] == 10000
+        assert stats['compressed_bytes'] * 10 < stats['raw_bytes']
+
+
+class TestOrdering:
+    """Test append-only rules and ordered reads"""
+
+    def test_out_of_order_rejected(self):
+        """
+        TC-C-037: Append-Only
+
+        Verify older timestamps are rejected per series, equal ones are
+        accepted, and unknown statuses raise.
+        """
+        ts = TimeSeriesStore()
+        assert ts.append("a", 1000, 'passed', 1.0)
+        assert ts.append("a", 1000, 'failed', 2.0)
+        assert not ts.append("a", 999, 'passed', 1.0)
+        assert ts.append("b", 5, 'passed', 1.0)      # independent series
+        with pytest.raises(ValueError):
+            ts.append("a", 2000, 'bogus', 1.0)
+
+        latest = ts.latest("a", 5)
+        assert [p['status'] for p in latest] == ['failed', 'passed']
+        assert ts.series() == ['a', 'b']
+        assert ts.scan("a", 1000, 1001)[0]['duration'] == 1.0
+
+
+class TestSummaries:
+    """Test bucketed aggregation"""
+
+    def test_summaries_match_points(self):
+        """
+        TC-C-038: Day Buckets
+
+        Verify day buckets (served from block summaries) and partial ranges
+        (decoded) agree with aggregates computed from the raw points.
+        """
+        ts = TimeSeriesStore(DAY_MS)
+        rng = random.Random(9)
+        points = []
+        t = 0
+        for _ in range(5000):
+            t += rng.randrange(2 * HOUR_MS)
+            status = 'passed' if rng.random() < 0.8 else 'failed'
+            duration = round(rng.random(), 3)
+            ts.append("s", t, status, duration)
+            points.append((t, status, duration))
+
+        start = points[100][0]
+        buckets = ts.summarize("s", start=start, bucket_ms=DAY_MS)
+        for b in buckets:
+            inside = [p for p in points if b['start'] <= p[0] < b['end'] and p[0] >= start]
+            assert b['count'] == len(inside)
+            assert b['status_counts']['passed'] == sum(p[1] == 'passed' for p in inside)
+            assert b['duration_max'] == max(p[2] for p in inside)
+            assert b['duration_sum'] == pytest.approx(sum(p[2] for p in inside))
+        assert sum(b['count'] for b in buckets) == len(points) - 100
+
+        weekly = ts.summarize("s", bucket_ms=7 * DAY_MS)
+        assert sum(b['count'] for b in weekly) == len(points)
+
+
+class TestRetention:
+    """Test block-granular retention"""
+
+    def test_drop_before(self):
+        """
+        TC-C-039: Block Drop
+
+        Verify drop_before removes whole blocks ending at or before the
+        cutoff, keeps the partially covered block, and removes empty series.
+        """
+        ts = TimeSeriesStore(DAY_MS)
+        for day in range(10):
+            ts.append("long", day * DAY_MS + HOUR_MS, 'passed', 1.0, day)
+        ts.append("short", HOUR_MS, 'passed', 1.0)
+
+        dropped = ts.drop_before(3 * DAY_MS + HOUR_MS)
+        assert dropped == 3 + 1
+        assert [p['ref'] for p in ts.scan("long")] == list(range(3, 10))
+        assert "short" not in ts
+        assert ts.series() == ['long']
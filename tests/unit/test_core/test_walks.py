@@ -0,0 +1,132 @@
+"""
+Core Layer Tests: walks C Library
+
+Tests random walks and restart proximity through the adapter layer.
+Focus: transition probabilities, determinism and proximity ranking.
+
+Test IDs: TC-C-059 through TC-C-061
+"""
+
+from collections import Counter
+
+import pytest
+from adapters import GraphStore, WalkGraph
+from adapters.walks import RW_END
+
+
+def _graph(pairs, weights=None, both=False):
+    g = GraphStore()
+    if both:
+        pairs = list(pairs) + [(d, s) for s, d in pairs]
+        weights = weights + weights if weights else None
+    g.add_edges([s for s, _ in pairs], [d for _, d in pairs], weights)
+    g.flush()
+    return g
+
+
+def _rows(flat, length):
+    return [list(flat[k:k + length + 1]) for k in range(0, len(flat), length + 1)]
+
+
+class TestTransitions:
+    """Test step distributions"""
+
+    def test_uniform_weighted_and_node2vec(self):
+        """
+        TC-C-059: Alias Tables and Rejection Sampling
+
+        Verify uniform and weighted first steps and node2vec second steps
+        follow their exact probabilities, and walks stay on edges.
+        """
+        g = _graph([(0, 1), (0, 2), (0, 3)], [1.0, 2.0, 5.0])
+        with g.view() as view:
+            for weighted, expected in ((False, [1 / 3] * 3), (True, [1 / 8, 2 / 8, 5 / 8])):
+                walker = WalkGraph(view, weighted=weighted)
+                steps = Counter(walker.walks([0], walks_per_node=40000, length=1, seed=2)[1::2])
+                for node, p in zip((1, 2, 3), expected):
+                    assert steps[node] / 40000 == pytest.approx(p, abs=0.01)
+
+        # From 1 having come from 0: back to 0 weighs 1/p, to 2 (adjacent
+        # to 0) 1, to 3 1/q
+        edges = [(0, 1), (1, 2), (0, 2), (1, 3)]
+        g = _graph(edges, both=True)
+        with g.view() as view:
+            walker = WalkGraph(view)
+            rows = _rows(walker.walks([0], walks_per_node=60000, length=2, p=0.5, q=2.0), 2)
+            after = Counter(row[2] for row in rows if row[1] == 1)
+            total = sum(after.values())
+            for node, weight in ((0, 2.0), (2, 1.0), (3, 0.5)):
+                assert after[node] / total == pytest.approx(weight / 3.5, abs=0.01)
+            adjacent = set(edges) | {(d, s) for s, d in edges}
+            for row in rows[:1000]:
+                assert all((a, b) in adjacent for a, b in zip(row, row[1:]))
+
+
+class TestCorpus:
+    """Test corpus layout and determinism"""
+
+    def test_layout_dead_ends_and_determinism(self):
+        """
+        TC-C-060: Walk Corpus Layout
+
+        Verify walk k starts at starts[k % n], dead ends pad with RW_END,
+        undirected walks follow in-edges, results depend on the seed only,
+        and bad starts and parameters are rejected.
+        """
+        g = _graph([(0, 1), (1, 2)])
+        with g.view() as view:
+            walker = WalkGraph(view)
+            rows = _rows(walker.walks([0, 2], walks_per_node=2, length=3), 3)
+            assert rows == [[0, 1, 2, RW_END], [2] + [RW_END] * 3] * 2
+            back = WalkGraph(view, undirected=True)
+            for row in _rows(back.walks([2], walks_per_node=20, length=2), 2):
+                assert row[:2] == [2, 1] and row[2] in (0, 2)
+            with pytest.raises(ValueError):
+                walker.walks([7])
+            with pytest.raises(ValueError):
+                walker.walks([0], p=0)
+
+        pairs = [(i, (i * 7 + 3) % 500) for i in range(500)] + [(i, (i + 1) % 500) for i in range(500)]
+        g = _graph(pairs, both=True)
+        with g.view() as view:
+            walker = WalkGraph(view, weighted=True)
+            one = walker.walks(range(500), walks_per_node=3, length=20, p=0.25, q=4, seed=9, threads=1)
+            many = walker.walks(range(500), walks_per_node=3, length=20, p=0.25, q=4, seed=9, threads=4)
+            assert one == many
+            assert walker.walks(range(500), length=20, seed=10) != walker.walks(range(500), length=20, seed=9)
+
+        g = GraphStore(track_in=False)
+        g.add_edges([0], [1])
+        g.flush()
+        with g.view() as view:
+            with pytest.raises(ValueError):
+                WalkGraph(view, undirected=True)
+
+
+class TestProximity:
+    """Test random walk with restart"""
+
+    def test_ranking(self):
+        """
+        TC-C-061: Restart Proximity
+
+        Verify proximity ranks a source's own community above the rest,
+        excludes the sources, normalises by all visits and is independent
+        of the thread count.
+        """
+        # Two 6-cliques joined by one edge
+        pairs = [(a, b) for c in (0, 6) for a in range(c, c + 6) for b in range(a + 1, c + 6)]
+        g = _graph(pairs + [(5, 6)], both=True)
+        with g.view() as view:
+            walker = WalkGraph(view)
+            ranked = walker.proximity([0], walks=20000, restart=0.3, top_k=12, seed=1)
+            nodes = [node for node, _ in ranked]
+            assert 0 not in nodes and len(nodes) == 11
+            assert set(nodes[:5]) == {1, 2, 3, 4, 5}
+            assert all(a[1] >= b[1] for a, b in zip(ranked, ranked[1:]))
+            assert sum(score for _, score in ranked) < 1.0
+            assert walker.proximity([0], walks=20000, restart=0.3, top_k=12, seed=1,
+                                    threads=3) == ranked
+            assert walker.proximity([0], top_k=0) == []
+            with pytest.raises(ValueError):
+                walker.proximity([99])
@@ -0,0 +1,89 @@
+"""
+Unit Tests for CentralityService
+
+Tests betweenness and closeness over a GraphDB, including caching.
+"""
+
+import json
+
+import pytest
+from graph_db import GraphDB
+from src.services import CentralityService, ValidationError
+
+
+@pytest.fixture
+def bridge():
+    """Two triangles joined through a bridge node, plus an isolated node"""
+    graph = GraphDB(directed=False)
+    for node in ("a1", "a2", "a3", "hub", "b1", "b2", "b3", "lonely"):
+        graph.add_node(node)
+    graph.add_edges([
+        ("a1", "a2", 1.0), ("a2", "a3", 1.0), ("a3", "a1", 1.0),
+        ("b1", "b2", 1.0), ("b2", "b3", 1.0), ("b3", "b1", 1.0),
+        ("a1", "hub", 1.0), ("hub", "b1", 1.0),
+    ])
+    return CentralityService(graph)
+
+
+class TestCentrality:
+    """Test centrality values and caching"""
+
+    def test_betweenness_exact_and_sampled(self, bridge):
+        """Test the bridge dominates, networkx-style normalisation and sampling"""
+        exact = bridge.betweenness()
+        assert exact.top_nodes(3)[0]['node_id'] == "hub"
+        # hub is interior to the shortest path of each pair in
+        # {a1, a2, a3} x {b1, b2, b3}: 9 unordered pairs, n = 8
+        assert exact.values["hub"] == pytest.approx(2 * 9 / (7 * 6))
+        assert exact.values["lonely"] == 0.0
+
+        raw = bridge.betweenness(normalized=False)
+        assert raw.values["hub"] == pytest.approx(9)
+
+        sampled = bridge.betweenness(approximate=True, epsilon=0.02, seed=1)
+        assert sampled.approximate and sampled.samples > 0
+        for node, value in exact.values.items():
+            # Sampling bounds error relative to n(n-1) rather than (n-1)(n-2)
+            assert abs(sampled.values[node] - value) * 6 / 8 < 0.02
+
+        with pytest.raises(ValidationError):
+            bridge.betweenness(epsilon=0)
+
+    def test_closeness_subset(self, bridge):
+        """Test harmonic closeness for chosen nodes"""
+        result = bridge.closeness(nodes=["hub", "a2", "lonely"])
+        assert set(result.values) == {"hub", "a2", "lonely"}
+        # hub: a1, b1 at 1; a2, a3, b2, b3 at 2
+        assert result.values["hub"] == pytest.approx(2 + 4 / 2)
+        assert result.values["lonely"] == 0.0
+        assert bridge.closeness(normalized=True).values["hub"] == pytest.approx(4 / 7)
+
+    def test_cache_follows_graph_version(self, bridge):
+        """Test results are reused until the graph changes"""
+        first = bridge.betweenness()
+        again = CentralityService(bridge.graph).betweenness()
+        assert not first.cached and again.cached
+        assert again.values == first.values
+
+        bridge.graph.add_edge("a2", "b2")
+        changed = bridge.betweenness()
+        assert not changed.cached
+        assert changed.values["hub"] < first.values["hub"]
+
+    def test_cache_survives_reimport(self, bridge):
+        """Test a reimported graph is not served results cached for the old one"""
+        first = bridge.betweenness()
+        assert first.values["hub"] > 0
+
+        # Same node count, and the new topology starts over at the same
+        # version number; here a1 is the center of a star
+        nodes = ["a1", "a2", "a3", "hub", "b1", "b2", "b3", "lonely"]
+        bridge.graph.import_from_json(json.dumps({
+            "directed": False,
+            "nodes": [{"id": n} for n in nodes],
+            "edges": [{"from": "a1", "to": n} for n in nodes[1:]],
+        }))
+        star = bridge.betweenness()
+        assert not star.cached
+        assert star.values["hub"] == 0
+        assert star.values["a1"] > first.values["a1"]
@@ -0,0 +1,99 @@
+"""
+Unit Tests for DiagnosisService
+
+Tests ranked differentials from symptom weights, hierarchy roll-ups and
+next-question suggestions.
+"""
+
+import pytest
+from src.services import DiagnosisService, ValidationError
+
+
+@pytest.fixture
+def service():
+    """Three diseases under a two-level hierarchy"""
+    return DiagnosisService(
+        diseases={
+            "resp:Influenza": {"label": "Influenza", "parent": "resp:Viral", "severity": "moderate",
+                               "symptoms": {"symp:Fever": 0.9, "symp:Cough": 0.85,
+                                            "symp:Headache": 0.75}},
+            "resp:CommonCold": {"label": "Common Cold", "parent": "resp:Upper",
+                                "symptoms": {"symp:RunnyNose": 0.95, "symp:Cough": 0.8,
+                                             "symp:Fever": None}},
+            "neuro:Migraine": {"label": "Migraine", "parent": "neuro:Headache",
+                               "symptoms": {"symp:Headache": 0.95}},
+        },
+        symptoms={"symp:Fever": {"label": "Fever"}, "symp:Cough": {"label": "Cough"},
+                  "symp:Headache": {"label": "Headache"},
+                  "symp:RunnyNose": {"label": "Runny Nose"}},
+        hierarchy={"resp:Viral": {"label": "Viral", "parent": "resp:Respiratory"},
+                   "resp:Upper": {"label": "Upper", "parent": "resp:Respiratory"},
+                   "resp:Respiratory": {"label": "Respiratory", "parent": "owl:Disease"},
+                   "neuro:Headache": {"label": "Headache Disorder"}},
+    )
+
+
+class TestDiagnose:
+    """Test differential ranking"""
+
+    def test_ranks_with_present_and_absent_evidence(self, service):
+        """Test IDs and labels resolve, absent symptoms shift the ranking and groups roll up"""
+        result = service.diagnose(["fever", "symp:Cough", "Tinnitus"], top_k=3)
+        assert result.present == ["symp:Fever", "symp:Cough"]
+        assert result.unknown == ["Tinnitus"]
+        assert [c['id'] for c in result.ranked][:2] == ["resp:Influenza", "resp:CommonCold"]
+        assert result.ranked[0]['matched'] == ["symp:Fever", "symp:Cough"]
+        assert result.ranked[0]['severity'] == "moderate"
+        assert sum(c['probability'] for c in result.ranked) == pytest.approx(1.0)
+
+        # Ruling out headache moves the cold (fever at the default weight) ahead
+        ruled_out = service.diagnose(["Fever", "Cough"], ["Headache"], top_k=1)
+        assert ruled_out.ranked[0]['id'] == "resp:CommonCold"
+        assert ruled_out.absent == ["symp:Headache"]
+
+        groups = {g['id']: g['probability'] for g in result.groups}
+        assert groups["resp:Respiratory"] == pytest.approx(
+            groups["resp:Viral"] + groups["resp:Upper"])
+        assert result.groups[0]['id'] == "resp:Respiratory"
+
+        # Present wins over absent
+        both = service.diagnose(["Cough"], ["Cough"])
+        assert both.present == ["symp:Cough"] and both.absent == []
+
+    def test_next_questions(self, service):
+        """Test questions skip answered symptoms and incremental answers match rescoring"""
+        first = service.next_questions(["Cough"], top_k=3)
+        assert first.present == ["symp:Cough"]
+        ids = [q['id'] for q in first.questions]
+        assert "symp:Cough" not in ids and len(ids) == 3
+        assert first.questions[0]['gain'] >= first.questions[-1]['gain'] > 0
+        assert 0 < first.questions[0]['p_present'] < 1
+        assert first.candidates[0]['id'] in ("resp:Influenza", "resp:CommonCold")
+
+        # Answering the top question reuses the cached posterior
+        asked = first.questions[0]['id']
+        second = service.next_questions(["Cough"], [asked], top_k=5)
+        assert asked not in [q['id'] for q in second.questions]
+        assert second.entropy < first.entropy
+
+        probs = {c['id']: c['probability']
+                 for c in service.diagnose(["Cough"], [asked], top_k=3).ranked}
+        for c in second.candidates:
+            assert c['probability'] == pytest.approx(probs[c['id']])
+
+        opening = service.next_questions()
+        assert opening.present == [] and opening.questions
+
+    def test_validation(self, service):
+        """Test empty evidence and bad parameters are rejected"""
+        with pytest.raises(ValidationError):
+            service.diagnose([])
+        with pytest.raises(ValidationError):
+            service.diagnose("Fever")
+        with pytest.raises(ValidationError):
+            service.diagnose(["Fever"], top_k=0)
+        with pytest.raises(ValidationError):
+            DiagnosisService({"d": {"symptoms": {"s": 2.0}}})
+        with pytest.raises(ValidationError):
+            DiagnosisService({"d": {"parent": "a", "symptoms": {}}},
+                             hierarchy={"a": {"parent": "b"}, "b": {"parent": "a"}})
@@ -4,7 +4,12 @@ Unit Tests for GraphService
 Tests the business logic layer independent of HTTP/Flask.
 """
 
+import json
+import random
+
 import pytest
+from graph_db import GraphDB
+from partitioned_graph import PartitionedGraph
 from src.services import (
     GraphService,
     NodeNotFoundError,
@@ -311,3 +316,403 @@ class TestGraphServiceIntegration:
         service.delete_node("Middle")
         stats = service.get_stats()
         assert stats.node_count == 2
+
+
+class TestGraphSnapshots:
+    """Test point-in-time read views on the underlying graph"""
+    
+    def test_snapshot_reads_ignore_concurrent_writes(self):
+        """Test that reads inside a snapshot see the graph as of entry"""
+        service = GraphService()
+        service.add_node("A")
+        service.add_node("B")
+        service.add_edge("A", "B", weight=1.0)
+        graph = service.graph
+        
+        with graph.snapshot():
+            service.delete_node("B")
+            service.add_node("C")
+            
+            assert graph.node_exists("B")
+            assert not graph.node_exists("C")
+            assert [(f, t) for f, t, _ in graph.get_all_edges()] == [("A", "B")]
+            assert [n["to"] for n in graph.get_neighbors("A")] == ["B"]
+        
+        assert not graph.node_exists("B")
+        assert graph.node_exists("C")
+        assert graph.get_all_edges() == []
+    
+    def test_snapshot_is_per_thread(self):
+        """Test that a pinned view does not leak into other threads"""
+        import threading
+        
+        service = GraphService()
+        service.add_node("A")
+        graph = service.graph
+        seen = {}
+        
+        with graph.snapshot():
+            service.add_node("B")
+            worker = threading.Thread(
+                target=lambda: seen.update(b=graph.node_exists("B"))
+            )
+            worker.start()
+            worker.join()
+            assert not graph.node_exists("B")
+        
+        assert seen["b"] is True
+
+
+class TestGraphBulkIngestion:
+    """Test bulk edge ingestion and the native topology mirror"""
+    
+    def test_add_edges_matches_single_edge_path(self):
+        """Test that add_edges stores the same graph as repeated add_edge"""
+        bulk, single = GraphService(), GraphService()
+        for service in (bulk, single):
+            for node in "ABCD":
+                service.add_node(node)
+        edges = [("A", "B", 2.0), ("A", "C", 1.0), ("B", "C", 3.0), ("A", "B", 5.0), ("A", "Z", 1.0)]
+        
+        added = bulk.graph.add_edges(edges)
+        for from_node, to_node, weight in edges[:4]:
+            single.graph.add_edge(from_node, to_node, weight)
+        
+        assert added == 3
+        for node in "ABCD":
+            assert bulk.graph.get_neighbors(node) == single.graph.get_neighbors(node)
+        assert bulk.graph.get_edge("A", "B") == single.graph.get_edge("A", "B")
+        assert bulk.graph.get_stats()["edges"] == 3
+    
+    def test_topology_tracks_updates(self):
+        """Test that the topology view reflects adds and deletes"""
+        service = GraphService()
+        for node in "ABC":
+            service.add_node(node)
+        service.graph.add_edges([("A", "B"), ("C", "B")])
+        service.delete_node("C")
+        
+        view, names = service.graph.topology()
+        with view:
+            b = service.graph.topology_id("B")
+            assert [names[n] for n in view.in_neighbors(b)] == ["A"]
+            assert view.edge_count == 1
+        assert service.graph.get_degree("B")["in_degree"] == 1
+
+
+class TestGraphDiffImport:
+    """Test diff imports against clear-and-reload"""
+
+    @staticmethod
+    def _state(graph):
+        layers = {}
+        for label in graph.edge_labels():
+            view, names = graph.topology(label)
+            with view:
+                layers[label] = sorted((names[a], names[b]) for a in range(view.node_count)
+                                       for b in view.neighbors(a))
+        edges = {(a, b, graph.get_edge(a, b).get("label", "")) for a, b, _ in graph.get_all_edges()}
+        return ({n: graph.get_node(n) for n in graph.get_all_nodes()}, edges, layers,
+                graph.value_counts("kind"), graph.get_stats()["edges"])
+
+    @pytest.mark.parametrize("directed", [True, False])
+    def test_diff_matches_reload(self, directed):
+        """Test a diff import stores what a fresh import would, in one version"""
+        def payload(kinds, edges):
+            return json.dumps({
+                "directed": directed, "weighted": False,
+                "nodes": [{"id": n, "data": {"kind": k}} for n, k in kinds.items()],
+                "edges": [{"from": a, "to": b, "label": label} for a, b, label in edges]})
+        old = payload({"owl:Thing": "root", "A": "x", "B": "x", "C": "y"},
+                      [("A", "owl:Thing", "is"), ("B", "A", "is"), ("C", "B", "near")])
+        new_edges = [("A", "owl:Thing", "is"), ("B", "A", "near"), ("D", "B", "is")]
+        new = payload({"owl:Thing": "root", "A": "y", "B": "x", "D": "x"}, new_edges)
+        diffed, fresh = GraphDB(directed=directed), GraphDB(directed=directed)
+        for graph in (diffed, fresh):
+            graph.count_values("kind")
+        diffed.import_from_json(old)
+        fresh.import_from_json(new)
+
+        before = diffed.version()
+        with diffed.snapshot() as view:
+            assert diffed.import_from_json(new, diff=True)
+            assert view.get("node:C") is not None and view.get("node:D") is None
+        assert diffed.version() == before + 1
+        assert self._state(diffed) == self._state(fresh)
+        assert json.loads(diffed.export_to_json()) == json.loads(fresh.export_to_json())
+
+        # An identical re-import writes nothing
+        writes = diffed.value_writes("kind")
+        stats = diffed.import_diff({n: None for n in ("owl:Thing", "A", "B", "D")},
+                                   [(a, b, 1.0, label) for a, b, label in new_edges])
+        assert (stats["nodes_unchanged"], stats["edges_unchanged"]) == (4, 3)
+        assert diffed.version() == before + 1
+        assert diffed.value_writes("kind") == writes
+
+    def test_owned_scope_and_adjacency_list(self):
+        """Test only owned nodes are replaced and edges to kept nodes survive"""
+        graph = GraphDB()
+        graph.import_from_adjacency_list("A -> B, C\nB -> C\nC ->\n")
+        graph.add_node("i1", {"node_type": "instance"})
+        graph.add_edges([("i1", "B", 1.0, "type"), ("i1", "C", 1.0, "type")])
+
+        stats = graph.import_diff({"A": None, "B": None}, [("A", "B"), ("B", "A")],
+                                  owned=lambda _, data: data.get("node_type") != "instance")
+        assert (stats["nodes_deleted"], stats["nodes_unchanged"]) == (1, 2)
+        assert (stats["edges_added"], stats["edges_deleted"], stats["edges_unchanged"]) == (1, 3, 2)
+        assert sorted(graph.get_all_nodes()) == ["A", "B", "i1"]
+        assert sorted((a, b) for a, b, _ in graph.get_all_edges()) == [
+            ("A", "B"), ("B", "A"), ("i1", "B")]
+        assert graph.get_stats()["edges"] == 3
+
+        graph.import_from_adjacency_list("A -> B\nB -> A\n", diff=True)
+        assert sorted(graph.get_all_nodes()) == ["A", "B"]
+        assert graph.get_stats()["edges"] == 2
+
+    def test_concurrent_write_is_not_lost(self):
+        """Test a write landing between the diff and its batch forces a re-plan"""
+        graph = GraphDB()
+        graph.import_from_adjacency_list("A -> B\nB ->\n")
+        plan = graph._plan_diff
+        calls = []
+
+        def racing_plan(*args):
+            planned = plan(*args)
+            if not calls:
+                graph.add_node("manual", {"node_type": "instance"})
+                graph.add_edge("manual", "A")
+            calls.append(planned)
+            return planned
+
+        graph._plan_diff = racing_plan
+        stats = graph.import_diff({"A": None, "C": {}}, [("A", "C")],
+                                  owned=lambda _, data: data.get("node_type") != "instance")
+        assert len(calls) == 2
+        assert (stats["nodes_added"], stats["nodes_deleted"]) == (1, 1)
+        assert sorted(graph.get_all_nodes()) == ["A", "C", "manual"]
+        assert sorted((a, b) for a, b, _ in graph.get_all_edges()) == [("A", "C"), ("manual", "A")]
+        assert graph.get_stats()["nodes"] == 3 and graph.get_stats()["edges"] == 2
+        assert graph.get_degree("A")["in_degree"] == 1
+
+    def test_write_inside_pinned_snapshot(self):
+        """Test a diff import after a write made under the caller's own snapshot"""
+        graph = GraphDB()
+        graph.import_from_adjacency_list("A -> B\nB ->\n")
+        with graph.snapshot() as view:
+            graph.add_node("manual", {"node_type": "instance"})
+            stats = graph.import_diff({"A": None, "C": {}}, [("A", "C")],
+                                      owned=lambda _, data: data.get("node_type") != "instance")
+            assert view.get("node:C") is None
+        assert (stats["nodes_added"], stats["nodes_deleted"]) == (1, 1)
+        assert sorted(graph.get_all_nodes()) == ["A", "C", "manual"]
+        assert sorted((a, b) for a, b, _ in graph.get_all_edges()) == [("A", "C")]
+
+
+class TestPartitionedGraph:
+    """Test the multi-process graph against the in-process one"""
+
+    @staticmethod
+    def _communities(directed, weighted, seed=5):
+        """Six communities of 60 nodes joined by a few random edges"""
+        rng = random.Random(seed)
+        graph = GraphDB(directed=directed, weighted=weighted)
+        for i in range(360):
+            graph.add_node(f"n:{i}", {"i": i})
+        graph.add_node("lonely")
+        edges = [(f"n:{c * 60 + rng.randrange(60)}", f"n:{c * 60 + rng.randrange(60)}",
+                  float(rng.randint(1, 9))) for c in range(6) for _ in range(240)]
+        edges += [(f"n:{rng.randrange(360)}", f"n:{rng.randrange(360)}", float(rng.randint(1, 9)))
+                  for _ in range(30)]
+        graph.add_edges(edges)
+        return graph
+
+    @pytest.mark.parametrize("directed,weighted", [(True, False), (False, True)])
+    def test_matches_graph_db(self, directed, weighted):
+        """Test lookups, BFS and shortest paths over three worker processes"""
+        graph = self._communities(directed, weighted)
+        with PartitionedGraph.from_graph(graph, parts=3) as pg:
+            stats = pg.get_stats()
+            assert stats["nodes"] == 361 and max(stats["nodes_per_part"]) <= 124
+            assert stats["partition"]["cut_edges"] <= 30
+
+            ids = ["n:5", "lonely", "missing", "n:300"]
+            assert pg.get_nodes(ids) == graph.get_nodes(ids)
+            assert pg.get_node("n:5") == graph.get_node("n:5")
+            assert pg.get_neighbors_many(ids) == graph.get_neighbors_many(ids)
+            assert pg.owner("missing") is None and pg.owner("n:5") in range(3)
+
+            for start in ("n:0", "n:130", "n:359"):
+                assert pg.bfs(start)["distances"] == graph.bfs(start)["distances"]
+                for end in ("n:10", "n:250", "lonely"):
+                    got, want = pg.shortest_path(start, end), graph.shortest_path(start, end)
+                    assert got["distance"] == want["distance"]
+                    if got["path"]:
+                        assert got["path"][0] == start and got["path"][-1] == end
+                        hops = list(zip(got["path"], got["path"][1:]))
+                        assert all(graph.edge_exists(a, b) for a, b in hops)
+            found = pg.bfs("n:0", "n:250")
+            assert found["found"] and len(found["path"]) - 1 == found["distances"]["n:250"]
+            assert pg.bfs("missing") == graph.bfs("missing")
+
+    def test_writes_and_shutdown(self):
+        """Test added nodes and edges are routed, and workers stop on close"""
+        pg = PartitionedGraph(parts=2, weighted=True)
+        assert pg.add_node("A", {"x": 1}) and pg.add_node("B") and not pg.add_node("A")
+        assert pg.owner("A") != pg.owner("B")
+        assert pg.add_edge("A", "B", 2.5) and not pg.add_edge("A", "Z")
+        pg.add_edge("A", "B", 1.5)
+        assert pg.get_neighbors("A") == [{"to": "B", "weight": 1.5}]
+        assert pg.shortest_path("A", "B") == {"path": ["A", "B"], "distance": 1.5}
+        assert pg.shortest_path("B", "A")["path"] == []
+        assert pg.get_stats()["ghosts_per_part"][pg.owner("A")] == 1
+
+        procs = list(pg._procs)
+        pg.close()
+        assert all(proc.poll() is not None for proc in procs)
+        with pytest.raises(ValueError):
+            PartitionedGraph(parts=0)
+
+    def test_errors_keep_workers_in_step(self):
+        """Test a failed part's error is raised only after every reply is read"""
+        pg = PartitionedGraph(parts=3)
+        try:
+            for node_id in ("A", "B", "C"):
+                pg.add_node(node_id, {"id": node_id})
+            with pytest.raises(RuntimeError, match="Part 0"):
+                pg._scatter({0: ("no_such_op", ()), 1: ("missing", ()), 2: ("missing", ())})
+            assert sorted(map(pg.owner, "ABC")) == [0, 1, 2]
+            assert pg.get_nodes(["A", "B", "C"]) == [{"id": n} for n in "ABC"]
+
+            pg._procs[pg.owner("B")].kill()
+            pg._procs[pg.owner("B")].wait()
+            with pytest.raises(RuntimeError, match="exited"):
+                pg.get_nodes(["A", "B", "C"])
+            with pytest.raises(RuntimeError, match="closed"):
+                pg.get_node("A")
+        finally:
+            pg.close()
+
+
+class TestTemporalGraph:
+    """Test time-travel reads on a temporal graph"""
+    
+    def test_as_of_sees_past_state(self):
+        """Test that traversals inside as_of see the graph as it was"""
+        from graph_db import GraphDB
+        
+        service = GraphService(GraphDB(temporal=True))
+        for node in "ABC":
+            service.add_node(node)
+        service.graph.update_node("A", {"rev": 1})
+        service.add_edge("A", "B")
+        service.add_edge("B", "C")
+        before = service.graph.version()
+        
+        service.delete_node("B")
+        service.graph.update_node("A", {"rev": 2})
+        
+        with service.graph.as_of(before):
+            assert service.graph.bfs("A")["visited"] == ["A", "B", "C"]
+            assert service.graph.get_node("A")["data"] == {"rev": 1}
+        assert service.graph.bfs("A")["visited"] == ["A"]
+        
+        service.graph.compact_history(before_version=service.graph.version())
+        with pytest.raises(ValueError):
+            with service.graph.as_of(before):
+                pass
+
+
+class TestTriangleStats:
+    """Test triangle counts and clustering coefficients"""
+    
+    def _service(self):
+        service = GraphService()
+        for node in "ABCDE":
+            service.add_node(node)
+        # Triangle A-B-C plus a tail C-D; E is isolated
+        for src, dst in [("A", "B"), ("B", "C"), ("C", "A"), ("C", "D")]:
+            service.add_edge(src, dst)
+        return service
+    
+    def test_exact_per_node(self):
+        """Test exact counts, per-node values and the all-node average"""
+        stats = self._service().get_triangle_stats(per_node=True)
+        
+        assert stats.triangles == 1
+        assert stats.wedges == 5
+        assert stats.transitivity == pytest.approx(0.6)
+        assert stats.per_node["C"] == {'triangles': 1, 'clustering': pytest.approx(1 / 3)}
+        assert stats.per_node["E"] == {'triangles': 0, 'clustering': 0.0}
+        assert stats.avg_clustering == pytest.approx((1 + 1 + 1 / 3) / 5)
+        assert [n['node_id'] for n in stats.top_nodes(3)] == ["A", "B", "C"]
+    
+    def test_get_stats_and_approximate(self):
+        """Test get_stats integration and sampled estimates"""
+        service = self._service()
+        
+        stats = service.get_stats(include_triangles=True)
+        assert stats.to_dict()['triangles'] == 1
+        assert 'triangles' not in service.get_stats().to_dict()
+        
+        approx = service.get_triangle_stats(approximate=True, samples=20000)
+        assert approx.approximate and approx.per_node is None
+        assert approx.transitivity == pytest.approx(0.6, abs=0.05)
+        assert approx.avg_clustering == pytest.approx((1 + 1 + 1 / 3) / 5, abs=0.05)
+        
+        with pytest.raises(ValidationError):
+            service.get_triangle_stats(per_node=True, approximate=True)
+
+
+class TestExplainConnection:
+    """Test Steiner-tree explanations and spanning forests"""
+    
+    def _service(self):
+        service = GraphService(GraphDB(weighted=True))
+        for node in ["fever", "cough", "flu", "cold", "viral", "hub", "rash", "lonely"]:
+            service.add_node(node)
+        # Symptoms reach the disease directly (heavy) or through a shared
+        # class (light); rash hangs off a separate component
+        for src, dst, weight in [("fever", "flu", 5.0), ("cough", "flu", 5.0),
+                                 ("fever", "viral", 1.0), ("cough", "viral", 1.0),
+                                 ("flu", "viral", 1.0), ("cold", "viral", 2.0),
+                                 ("hub", "fever", 9.0), ("hub", "cough", 9.0),
+                                 ("rash", "lonely", 1.0)]:
+            service.add_edge(src, dst, weight=weight)
+        return service
+    
+    def test_explains_with_shared_nodes(self):
+        """Test the tree shares intermediate nodes and keeps edge direction"""
+        service = self._service()
+        
+        result = service.explain_connection(["fever", "cough", "flu"])
+        
+        assert result.connected and result.cost == 3.0
+        assert result.nodes[:3] == ["fever", "cough", "flu"]
+        assert set(result.nodes) == {"fever", "cough", "flu", "viral"}
+        assert {(e.from_node, e.to_node) for e in result.edges} == {
+            ("fever", "viral"), ("cough", "viral"), ("flu", "viral")}
+        
+        hops = service.explain_connection(["fever", "cough", "flu"], weighted=False)
+        assert hops.cost == 2.0 and len(hops.nodes) == 3
+        
+        assert service.explain_connection(["flu"]).to_dict()['edges'] == []
+    
+    def test_disconnected_and_validation(self):
+        """Test unreachable nodes are reported and bad input rejected"""
+        service = self._service()
+        service.add_node("unlinked")
+        
+        result = service.explain_connection(["fever", "rash", "unlinked"])
+        assert not result.connected and result.components == 3
+        
+        with pytest.raises(NodeNotFoundError):
+            service.explain_connection(["fever", "missing"])
+        with pytest.raises(ValidationError):
+            service.explain_connection([])
+    
+    def test_minimum_spanning_tree(self):
+        """Test the spanning forest weight and tree count"""
+        forest = self._service().minimum_spanning_tree()
+        
+        assert forest.cost == 1 + 1 + 1 + 2 + 9 + 1
+        assert forest.components == 2 and len(forest.edges) == 6
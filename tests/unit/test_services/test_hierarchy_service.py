@@ -0,0 +1,88 @@
+"""
+Unit Tests for HierarchyService
+
+Tests depth-limited class trees, counts and cursor paging.
+"""
+
+import pytest
+from src.services import HierarchyService, NodeNotFoundError, ValidationError
+from src.services.ontology_service import OntologyService
+from src.services.ontology_models import OntologyClass, OntologyInstance
+
+
+@pytest.fixture
+def ontology():
+    """Disease -> 12 Infection subclasses (one with a child), plus instances"""
+    onto = OntologyService()
+    onto.create_class(OntologyClass(id="Disease", label="Disease"))
+    onto.create_class(OntologyClass(id="Symptom", label="Symptom"))
+    for i in range(12):
+        onto.create_class(OntologyClass(id=f"Infection{i}", label=f"Infection {i}",
+                                        parent_classes=["Disease"]))
+    onto.create_class(OntologyClass(id="Flu", label="Flu", parent_classes=["Infection3"]))
+    for i in range(4):
+        onto.create_instance(OntologyInstance(id=f"case{i}", label=f"Case {i}",
+                                              class_ids=["Flu"]))
+    onto.create_instance(OntologyInstance(id="case_d", label="Case D", class_ids=["Disease"]))
+    return onto
+
+
+class TestTree:
+    """Test depth-limited trees"""
+
+    def test_levels_counts_and_cursors(self, ontology):
+        """Test depth stops expansion, counts match and collapsed nodes keep a cursor"""
+        service = HierarchyService(ontology.graph)
+        root = service.tree("owl:Thing", depth=1, limit=5)
+        assert root.child_count == 2 and root.next_cursor is None
+        disease = next(c for c in root.children if c.class_id == "Disease")
+        assert disease.depth == 1 and disease.parent_id == "owl:Thing"
+        assert disease.child_count == 12 and disease.instance_count == 1
+        # One level deep: Disease is collapsed but can be loaded
+        assert disease.children == [] and disease.next_cursor == "0"
+
+        tree = service.tree("Disease", depth=2, limit=5)
+        assert [c.class_id for c in tree.children] == [f"Infection{i}" for i in range(5)]
+        assert tree.next_cursor is not None
+        flu = tree.children[3].children[0]
+        assert (flu.class_id, flu.depth, flu.instance_count) == ("Flu", 2, 4)
+        assert tree.to_dict()['children'][3]['children'][0]['label'] == "Flu"
+
+        leaf = service.tree("Flu", depth=3)
+        assert leaf.child_count == 0 and leaf.children == [] and leaf.next_cursor is None
+
+    def test_paging_children(self, ontology):
+        """Test cursors page through every subclass exactly once"""
+        service = HierarchyService(ontology.graph)
+        seen, cursor = [], None
+        while True:
+            page = service.children("Disease", cursor=cursor, limit=5)
+            assert page.total == 12 and len(page.children) <= 5
+            seen += [c.class_id for c in page.children]
+            cursor = page.next_cursor
+            if cursor is None:
+                break
+        assert seen == [f"Infection{i}" for i in range(12)]
+
+        expanded = service.children("Infection3", depth=1)
+        assert expanded.children[0].class_id == "Flu" and expanded.children[0].instance_count == 4
+
+        # Classes added while paging appear on later pages
+        first = service.children("Disease", limit=6)
+        ontology.create_class(OntologyClass(id="Late", label="Late", parent_classes=["Disease"]))
+        rest = service.children("Disease", cursor=first.next_cursor, limit=50)
+        assert [c.class_id for c in rest.children][-1] == "Late" and rest.total == 13
+
+    def test_validation(self, ontology):
+        """Test unknown roots, non-classes and bad parameters are rejected"""
+        service = HierarchyService(ontology.graph)
+        with pytest.raises(NodeNotFoundError):
+            service.tree("Nope")
+        with pytest.raises(ValidationError):
+            service.tree("case0")
+        with pytest.raises(ValidationError):
+            service.tree(depth=-1)
+        with pytest.raises(ValidationError):
+            service.children("Disease", limit=0)
+        with pytest.raises(ValidationError):
+            service.children("Disease", cursor="abc")
@@ -0,0 +1,94 @@
+"""
+Unit Tests for LODService
+
+Tests level-of-detail viewports over a GraphDB, including caching.
+"""
+
+import json
+
+import pytest
+from graph_db import GraphDB
+from src.services import LODService, NodeNotFoundError, ValidationError
+
+
+@pytest.fixture
+def chain():
+    """Eight cliques of five nodes joined in a chain, plus an isolated node"""
+    graph = GraphDB(directed=False)
+    names = [f"n{c}_{i}" for c in range(8) for i in range(5)]
+    for name in names + ["lonely"]:
+        graph.add_node(name, {"label": name.upper(), "node_type": "concept"})
+    edges = []
+    for c in range(8):
+        members = names[5 * c:5 * c + 5]
+        edges += [(a, b, 1.0) for k, a in enumerate(members) for b in members[k + 1:]]
+        if c:
+            edges.append((names[5 * c - 1], members[0], 1.0))
+    graph.add_edges(edges)
+    return LODService(graph)
+
+
+class TestLODViewport:
+    """Test fish-eye viewports"""
+
+    def test_budget_and_focus(self, chain):
+        """Test the focus is detailed, the budget holds and all nodes are represented"""
+        stats = chain.get_hierarchy_stats()
+        assert stats['level_sizes'][0] == 40 and stats['levels'] > 1
+
+        for budget in (12, 20, 60):
+            view = chain.get_viewport("n0_0", budget=budget)
+            assert view['total_nodes'] <= budget
+            assert view['represented_nodes'] == 40
+            by_id = {node['id']: node for node in view['nodes']}
+            assert by_id["n0_0"]['distance_from_center'] == 0
+            assert by_id["n0_0"]['count'] == 1
+            assert by_id["n0_0"]['label'] == "N0_0" and by_id["n0_0"]['type'] == "concept"
+            ids = set(by_id)
+            for edge in view['edges']:
+                assert edge['source'] in ids and edge['target'] in ids
+                assert edge['aggregated'] == (edge['source'].startswith("cluster:")
+                                              or edge['target'].startswith("cluster:"))
+
+        full = chain.get_viewport("n0_0", budget=60)
+        assert full['levels'] == {0: 40}
+        assert sum(edge['weight'] for edge in full['edges']) == 8 * 10 + 7
+
+        small = chain.get_viewport("n7_4", budget=12)
+        clusters = [node for node in small['nodes'] if node['type'] == 'cluster']
+        assert clusters and all(node['label'] == f"{node['representative'].upper()} (+{node['count'] - 1})"
+                                for node in clusters)
+
+    def test_unlinked_center_and_errors(self, chain):
+        """Test an isolated focus is shown on its own and bad input is rejected"""
+        view = chain.get_viewport("lonely", budget=10)
+        assert view['total_nodes'] <= 10
+        assert {node['id'] for node in view['nodes'] if node['level'] == 0} >= {"lonely"}
+
+        with pytest.raises(NodeNotFoundError):
+            chain.get_viewport("missing")
+        with pytest.raises(ValidationError):
+            chain.get_viewport("n0_0", budget=0)
+
+    def test_hierarchy_rebuilt_after_change(self, chain):
+        """Test the cached hierarchy follows graph changes"""
+        before = chain._state()
+        assert chain._state() is before
+        chain.graph.add_node("extra")
+        chain.graph.add_edge("extra", "n3_2", 1.0)
+        after = chain._state()
+        assert after is not before
+        assert chain.get_viewport("extra", budget=60)['represented_nodes'] == 41
+
+    def test_hierarchy_rebuilt_after_reimport(self, chain):
+        """Test a reimported graph does not reuse the old graph's hierarchy"""
+        before = chain.get_viewport("n0_0", budget=60)
+        exported = json.dumps({
+            "directed": False,
+            "nodes": [{"id": node['id'].replace("n", "m", 1)} for node in before['nodes']],
+            "edges": [{"from": e['source'].replace("n", "m", 1),
+                       "to": e['target'].replace("n", "m", 1)} for e in before['edges']],
+        })
+        chain.graph.import_from_json(exported)
+        after = chain.get_viewport("m0_0", budget=60)
+        assert {node['id'] for node in after['nodes']} == {f"m{c}_{i}" for c in range(8) for i in range(5)}
@@ -0,0 +1,102 @@
+"""
+Unit Tests for OntologyStatsService
+
+Tests maintained counts, hierarchy figures and per-version caching.
+"""
+
+import pytest
+from src.services import OntologyStatsService
+from src.services.ontology_service import OntologyService
+from src.services.ontology_models import (
+    OntologyClass,
+    OntologyInstance,
+    OntologyProperty,
+    PropertyType,
+)
+
+
+@pytest.fixture
+def ontology():
+    """Diamond: Flu under both Infection and Respiratory, below Disease"""
+    onto = OntologyService()
+    onto.create_class(OntologyClass(id="Disease", label="Disease"))
+    onto.create_class(OntologyClass(id="Infection", label="Infection", parent_classes=["Disease"]))
+    onto.create_class(OntologyClass(id="Respiratory", label="Respiratory",
+                                    parent_classes=["Disease"]))
+    onto.create_class(OntologyClass(id="Viral", label="Viral", parent_classes=["Infection"]))
+    onto.create_class(OntologyClass(id="Flu", label="Flu",
+                                    parent_classes=["Viral", "Respiratory"]))
+    onto.create_property(OntologyProperty(id="hasSymptom", label="has symptom",
+                                          property_type=PropertyType.OBJECT))
+    onto.create_property(OntologyProperty(id="onset", label="onset",
+                                          property_type=PropertyType.DATA))
+    onto.create_property(OntologyProperty(id="note", label="note",
+                                          property_type=PropertyType.ANNOTATION))
+    for i in range(3):
+        onto.create_instance(OntologyInstance(id=f"case{i}", label=f"Case {i}",
+                                              class_ids=["Flu"]))
+    return onto
+
+
+class TestStatistics:
+    """Test counts and hierarchy figures"""
+
+    def test_counts_and_hierarchy(self, ontology):
+        """Test counts and depths under multiple inheritance"""
+        stats = ontology.get_statistics()
+        assert stats.total_classes == 6
+        assert (stats.total_properties, stats.total_object_properties,
+                stats.total_data_properties, stats.total_annotation_properties) == (3, 1, 1, 1)
+        assert stats.total_instances == 3
+        # owl:Thing 0, Disease 1, Infection/Respiratory 2, Viral 3, Flu 4 (via Viral)
+        assert stats.max_hierarchy_depth == 4
+        assert stats.avg_hierarchy_depth == pytest.approx((0 + 1 + 2 + 2 + 3 + 4) / 6)
+        assert stats.root_classes == 1 and stats.leaf_classes == 1
+        assert stats.multi_parent_classes == 1 and stats.cyclic_classes == 0
+        # 6 subclass edges below 5 classes with subclasses; Disease has 2
+        assert stats.avg_branching_factor == pytest.approx(6 / 5)
+        assert stats.max_branching_factor == 2
+
+    def test_counters_follow_mutations(self, ontology):
+        """Test counts stay correct through updates, deletes and a cycle"""
+        graph = ontology.graph
+        ontology.graph_service.delete_node("case0")
+        data = graph.get_node("case1")['data']
+        graph.update_node("case1", dict(data, node_type="owl:Class"))
+        onset = graph.get_node("onset")['data']
+        graph.update_node("onset", dict(onset, property_type="annotation"))
+        stats = ontology.get_statistics()
+        assert stats.total_instances == 1 and stats.total_classes == 7
+        assert (stats.total_data_properties, stats.total_annotation_properties) == (0, 2)
+        # case1 is now an unlinked class: one more root and leaf
+        assert stats.root_classes == 2 and stats.leaf_classes == 2
+
+        graph.add_edge("Disease", "Flu", label="rdfs:subClassOf")
+        stats = ontology.get_statistics()
+        assert stats.cyclic_classes == 5
+        assert stats.max_hierarchy_depth == 0
+
+        # A service attached later counts the existing nodes
+        assert OntologyStatsService(graph).statistics().total_classes == 7
+
+
+class TestCaching:
+    """Test per-version caching"""
+
+    def test_cached_until_next_write(self, ontology, monkeypatch):
+        """Test repeated reads reuse the result and a write refreshes it"""
+        service = ontology.stats_service
+        calls = []
+        compute = service._compute
+        monkeypatch.setattr(service, "_compute", lambda v: calls.append(v) or compute(v))
+
+        first = ontology.get_statistics()
+        first.total_classes = -1
+        second = ontology.get_statistics()
+        assert len(calls) == 1 and second.total_classes == 6
+
+        ontology.create_class(OntologyClass(id="Measles", label="Measles",
+                                            parent_classes=["Viral"]))
+        third = ontology.get_statistics()
+        assert len(calls) == 2 and third.total_classes == 7
+        assert third.version > second.version
@@ -0,0 +1,116 @@
+"""
+Unit Tests for the parallel test service
+
+Tests shard planning and a sharded run of a small throwaway test suite.
+"""
+
+import time
+
+import pytest
+from src.services.parallel_test_service import (
+    ShardedTestRunner,
+    TestJobManager,
+    plan_shards,
+)
+from src.services.test_runner_service import TestRunnerService
+
+
+class TestShardPlanning:
+    """Test longest-processing-time shard planning"""
+
+    def test_balances_by_duration(self):
+        """Test that one long test gets a shard to itself"""
+        ids = [f"t{i}" for i in range(7)]
+        durations = {"t3": 6.0, **{t: 1.0 for t in ids if t != "t3"}}
+
+        shards = plan_shards(ids, durations, 2)
+
+        assert sorted(sum(shards, [])) == sorted(ids)
+        assert ["t3"] in shards
+
+    def test_keeps_collection_order_and_defaults_unknown(self):
+        """Test shard order and the mean duration used for unknown tests"""
+        ids = ["a", "b", "c", "d"]
+        shards = plan_shards(ids, {"a": 2.0}, 2)
+
+        for shard in shards:
+            assert shard == sorted(shard, key=ids.index)
+        assert len(shards) == 2
+        assert plan_shards([], {}, 4) == []
+        assert plan_shards(ids, {}, 16) == [[t] for t in ids]
+
+
+class TestShardedRun:
+    """Test running a suite across worker processes"""
+
+    def test_results_stream_and_merge(self, tmp_path):
+        """Test collection, streamed results and outcomes across shards"""
+        (tmp_path / "test_sample.py").write_text(
+            "import pytest\n"
+            "def test_ok(): pass\n"
+            "def test_bad(): assert False\n"
+            "@pytest.mark.skip\n"
+            "def test_skip(): pass\n"
+            "@pytest.mark.parametrize('n', range(5))\n"
+            "def test_param(n): pass\n"
+        )
+        runner = ShardedTestRunner(tmp_path, workers=3)
+        streamed = []
+
+        results = runner.run(["test_sample.py"], on_result=streamed.append)
+
+        outcomes = {r["nodeid"].split("::")[-1]: r["outcome"] for r in results}
+        assert len(results) == 8
+        assert len(streamed) == 8
+        assert outcomes["test_ok"] == "passed"
+        assert outcomes["test_bad"] == "failed"
+        assert outcomes["test_skip"] == "skipped"
+        assert [r["nodeid"] for r in results] == runner.collect(["test_sample.py"])
+
+    def test_collection_errors_fail_the_run(self, tmp_path):
+        """Test that modules failing to import and bad arguments are reported"""
+        (tmp_path / "test_fine.py").write_text("def test_ok(): pass\n")
+        (tmp_path / "test_broken.py").write_text("import no_such_module_here\n")
+        runner = ShardedTestRunner(tmp_path, workers=2)
+
+        with pytest.raises(RuntimeError) as raised:
+            runner.run(["."])
+        assert "test_broken.py" in str(raised.value)
+        assert "no_such_module_here" in str(raised.value)
+
+        with pytest.raises(RuntimeError, match="--no-such-option"):
+            runner.collect(["--no-such-option", "test_fine.py"])
+
+        assert runner.collect(["test_fine.py", "-k", "nothing_matches"]) == []
+        assert runner.collect(["test_fine.py"]) == ["test_fine.py::test_ok"]
+
+    def test_job_reports_progress(self):
+        """Test that a background job completes with its work's result"""
+        def work(job):
+            job.set_total(["x"])
+            job.record({"outcome": "passed"})
+            return 42
+
+        manager = TestJobManager()
+        job = manager.submit("demo", work)
+
+        for _ in range(100):
+            if job.state in ("completed", "failed"):
+                break
+            time.sleep(0.01)
+
+        state = manager.get(job.job_id).to_dict()
+        assert state["state"] == "completed"
+        assert state["result"] == 42
+        assert state["progress"] == 100.0
+        assert state["counts"] == {"passed": 1}
+
+    def test_rejects_bad_worker_counts(self, tmp_path, monkeypatch):
+        """Test that start_tests refuses worker counts that are not positive ints"""
+        monkeypatch.chdir(tmp_path)     # TestResultsDB writes to the working directory
+        runner = TestRunnerService(tmp_path)
+
+        for workers in (0, -2, 1.5, "4", True):
+            with pytest.raises(ValueError):
+                runner.start_tests(workers=workers)
+        assert runner.jobs.list() == []
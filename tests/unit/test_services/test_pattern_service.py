@@ -0,0 +1,107 @@
+"""
+Unit Tests for PatternService
+
+Tests pattern query parsing and matching over a GraphDB.
+"""
+
+import pytest
+from graph_db import GraphDB
+from src.services import PatternService, ValidationError
+
+
+@pytest.fixture
+def clinic():
+    """Diseases linked to symptoms, plus a treatment chain"""
+    graph = GraphDB(directed=True)
+    for disease in ("flu", "cold", "covid"):
+        graph.add_node(disease, {"type": "Disease"})
+    for symptom, severity in (("fever", "high"), ("cough", "low"), ("fatigue", "low")):
+        graph.add_node(symptom, {"type": "Symptom", "severity": severity})
+    graph.add_node("rest", {"type": "Treatment", "cost": 0})
+    graph.add_node("antiviral", {"type": "Treatment", "cost": 40})
+    graph.add_edges([
+        ("flu", "fever", 1.0, "HAS_SYMPTOM"),
+        ("flu", "cough", 1.0, "HAS_SYMPTOM"),
+        ("cold", "cough", 1.0, "HAS_SYMPTOM"),
+        ("covid", "fever", 1.0, "HAS_SYMPTOM"),
+        ("covid", "cough", 1.0, "HAS_SYMPTOM"),
+        ("fever", "rest", 1.0, "TREATED_BY"),
+        ("fever", "antiviral", 1.0, "TREATED_BY"),
+        ("cough", "rest", 1.0, "TREATED_BY"),
+    ])
+    return PatternService(graph)
+
+
+class TestPatternQueries:
+    """Test matching labeled patterns"""
+
+    def test_shared_symptoms_reported_once(self, clinic):
+        """Test symmetric patterns yield each disease pair once per symptom"""
+        result = clinic.query(
+            "MATCH (a:Disease)-[:HAS_SYMPTOM]->(s)<-[:HAS_SYMPTOM]-(b:Disease) RETURN a, b, s"
+        )
+        found = {(frozenset(r[:2]), r[2]) for r in result.rows}
+        assert result.automorphisms == 2
+        assert len(result.rows) == len(found) == 4
+        assert found == {
+            (frozenset({"flu", "covid"}), "fever"),
+            (frozenset({"flu", "cold"}), "cough"),
+            (frozenset({"flu", "covid"}), "cough"),
+            (frozenset({"cold", "covid"}), "cough"),
+        }
+
+        every = clinic.query(
+            "MATCH (a:Disease)-[:HAS_SYMPTOM]->(s)<-[:HAS_SYMPTOM]-(b:Disease) RETURN a, b, s",
+            all_orderings=True,
+        )
+        assert len(every.rows) == 8
+
+    def test_labeled_chain_with_conditions(self, clinic):
+        """Test an A->B->C chain over two edge labels with WHERE filters"""
+        result = clinic.query(
+            'MATCH (d:Disease)-[:HAS_SYMPTOM]->(s {severity: "high"})-[:TREATED_BY]->(t) '
+            'WHERE t.cost > 10 AND d.id <> "flu" RETURN d, s, t.cost'
+        )
+        assert result.columns == ["d", "s", "t.cost"]
+        assert result.rows == [["covid", "fever", 40]]
+
+    def test_cross_variable_condition_and_limit(self, clinic):
+        """Test conditions across variables and LIMIT truncation"""
+        result = clinic.query(
+            "MATCH (a:Symptom)-[:TREATED_BY]->(t), (b:Symptom)-[:TREATED_BY]->(t) "
+            "WHERE a.severity != b.severity RETURN a, b, t"
+        )
+        assert sorted(result.rows) == [["cough", "fever", "rest"], ["fever", "cough", "rest"]]
+
+        limited = clinic.query("MATCH (d:Disease)-->(s) RETURN d, s LIMIT 2")
+        assert len(limited.rows) == 2
+        assert limited.truncated
+
+        assert clinic.query("MATCH (d:Disease)-->(s) RETURN d, s", limit=0).rows == []
+        assert len(clinic.query("MATCH (d:Disease)-->(s) RETURN d, s", limit=3).rows) == 3
+        with pytest.raises(ValidationError):
+            clinic.query("MATCH (d:Disease)-->(s) RETURN d, s", limit=-1)
+
+    def test_updates_and_unknown_labels(self, clinic):
+        """Test relabeled edges move between layers and unknown labels match nothing"""
+        clinic.graph.add_edge("cold", "cough", label="MIMICS")
+        result = clinic.query("MATCH (d)-[:HAS_SYMPTOM]->(s {id: 'cough'}) RETURN d")
+        assert sorted(r[0] for r in result.rows) == ["covid", "flu"]
+        assert clinic.query("MATCH (a)-[:NO_SUCH_LABEL]->(b)").rows == []
+
+    def test_filters_matching_nothing(self, clinic):
+        """Test variables whose filters match no node yield no rows"""
+        for text in ("MATCH (d:Vaccine)-[:HAS_SYMPTOM]->(s) RETURN d, s",
+                     'MATCH (d)-[:HAS_SYMPTOM]->(s {severity: "none"}) RETURN d, s',
+                     "MATCH (d)-[:HAS_SYMPTOM]->(s) WHERE d.id = 'measles' RETURN d, s",
+                     "MATCH (t:Treatment) WHERE t.cost > 100 RETURN t"):
+            result = clinic.query(text)
+            assert result.rows == []
+            assert not result.truncated
+
+    def test_syntax_errors(self, clinic):
+        """Test malformed queries raise ValidationError"""
+        for bad in ("MATCH (a", "MATCH (a)-[:X]->(b) RETURN c", "FIND (a)",
+                    "MATCH (a) WHERE a.x ~ 1", "MATCH (a) LIMIT -1"):
+            with pytest.raises(ValidationError):
+                clinic.query(bad)
@@ -0,0 +1,196 @@
+"""
+Unit Tests for ShapeValidationService
+
+Tests compiled constraints, violation reports and schema-keyed caching.
+"""
+
+import json
+
+import pytest
+from src.services import ShapeValidationService
+from src.services.base_service import NodeNotFoundError, ValidationError
+from src.services.ontology_service import OntologyService
+from src.services.ontology_models import (
+    OntologyClass,
+    OntologyInstance,
+    OntologyProperty,
+    PropertyCharacteristic,
+    PropertyType,
+)
+
+
+@pytest.fixture
+def ontology():
+    """Professor under Person; departments referred to by object property"""
+    onto = OntologyService()
+    onto.create_class(OntologyClass(id="Person", label="Person"))
+    onto.create_class(OntologyClass(id="Professor", label="Professor",
+                                    parent_classes=["Person"]))
+    onto.create_class(OntologyClass(id="Department", label="Department"))
+    onto.create_class(OntologyClass(id="Lab", label="Lab", parent_classes=["Department"]))
+    onto.create_property(OntologyProperty(id="name", label="name", property_type=PropertyType.DATA,
+                                          domain=["Person"], range=["xsd:string"],
+                                          required=True))
+    onto.create_property(OntologyProperty(
+        id="born", label="born", property_type=PropertyType.DATA, domain=["Person"],
+        range=["xsd:date"], characteristics={PropertyCharacteristic.FUNCTIONAL}))
+    onto.create_property(OntologyProperty(id="phone", label="phone",
+                                          property_type=PropertyType.DATA,
+                                          domain=["Person"], max_cardinality=2))
+    onto.create_property(OntologyProperty(id="memberOf", label="member of",
+                                          property_type=PropertyType.OBJECT,
+                                          domain=["Professor"], range=["Department"],
+                                          min_cardinality=1))
+    onto.create_instance(OntologyInstance(id="cs", label="CS", class_ids=["Department"]))
+    return onto
+
+
+def _instance(node_id, classes, **properties):
+    return OntologyInstance(id=node_id, label=node_id, class_ids=classes, properties=properties)
+
+
+class TestValidation:
+    """Test constraints and reports"""
+
+    def test_constraints(self, ontology):
+        """Test required, cardinality, datatype, range and unknown classes"""
+        report = ontology.shape_service.validate([
+            _instance("ok", ["Professor"], name="Ann", born="1970-01-31", memberOf="cs"),
+            _instance("lab", ["Lab"]),
+            _instance("p1", ["Professor"], memberOf="lab", phone=["1", "2", "3"]),
+            _instance("p2", ["Professor"], name="Bo", born=["1970-02-30", "1971-01-01"],
+                      memberOf=["ok", "nowhere"]),
+            _instance("x", ["Alien"]),
+        ])
+        assert (report.checked, report.invalid, report.total_violations) == (5, 3, 7)
+        assert not report.valid
+        got = [(v.instance_id, v.constraint, v.property_id, v.value) for v in report.violations]
+        assert sorted(got) == sorted([
+            ("p1", "min_count", "name", None),
+            ("p1", "max_count", "phone", None),
+            ("p2", "max_count", "born", None),
+            ("p2", "datatype", "born", "1970-02-30"),
+            ("p2", "range", "memberOf", "ok"),
+            ("p2", "range", "memberOf", "nowhere"),
+            ("x", "class", None, None),
+        ])
+        assert [v.instance_id for v in report.violations] == ["p1", "p1"] + ["p2"] * 4 + ["x"]
+        messages = {v.message for v in report.violations}
+        assert "Missing required property 'name' (inherited from Person)" in messages
+        assert "'phone' allows at most 2 values, found 3" in messages
+        assert "Value '1970-02-30' of 'born' is not a valid xsd:date" in messages
+        assert "Value 'nowhere' of 'member of' is not an instance of Department" in messages
+        assert "Unknown class 'Alien'" in messages
+
+        capped = ontology.shape_service.validate([_instance("p", ["Professor"])] * 5,
+                                                 max_violations=3)
+        assert capped.total_violations == 10 and len(capped.violations) == 3
+        with pytest.raises(ValidationError):
+            ontology.shape_service.validate([], max_violations=-1)
+
+    def test_ontology_integration(self, ontology):
+        """Test per-class checks, whole-graph validation and stored references"""
+        assert ontology.validate_instance_properties("Professor", {"memberOf": "cs"}) == [
+            "Missing required property 'name' (inherited from Person)"]
+        assert ontology.validate_instance_properties("Person", {}) == [
+            "Missing required property 'name'"]
+        with pytest.raises(NodeNotFoundError):
+            ontology.validate_instance_properties("Alien", {})
+
+        ontology.create_instance(_instance("bo", ["Professor"], name="Bo", memberOf="cs"))
+        ontology.create_instance(_instance("al", ["Person"], born="yesterday"))
+        report = ontology.shape_service.validate_graph()
+        assert report.checked == 3
+        assert [(v.instance_id, v.constraint) for v in report.violations] == [
+            ("al", "min_count"), ("al", "datatype")]
+        shape_errors = [e for e in ontology.validate_ontology().errors if e['type'] == "shape"]
+        assert [e['element_id'] for e in shape_errors] == ["al", "al"]
+
+
+class TestCaching:
+    """Test the program is rebuilt only when the schema changes"""
+
+    def test_recompiled_on_schema_writes_only(self, ontology, monkeypatch):
+        """Test instance writes reuse the program; class, property and edge writes do not"""
+        service = ontology.shape_service
+        calls = []
+        compile_ = service._compile
+        monkeypatch.setattr(service, "_compile", lambda key: calls.append(key) or compile_(key))
+
+        check = [_instance("p", ["Professor"], name="P", memberOf="cs")]
+        assert service.validate(check).valid
+        ontology.create_instance(_instance("ee", ["Department"]))
+        ontology.graph_service.delete_node("ee")
+        assert service.validate(check).valid
+        assert len(calls) == 1
+
+        ontology.create_property(OntologyProperty(id="office", label="office",
+                                                  property_type=PropertyType.DATA,
+                                                  domain=["Professor"], required=True))
+        assert service.validate(check).total_violations == 1
+        ontology.graph.add_edge("Department", "Person", label="rdfs:subClassOf")
+        # cs is now a Person too, but p is not a stored instance: only p is checked
+        assert service.validate(check).total_violations == 1
+        assert ontology.validate_instance_properties("Department", {}) == [
+            "Missing required property 'name' (inherited from Person)"]
+        assert len(calls) == 3
+
+        # A service attached later compiles the same rules
+        fresh = ShapeValidationService(ontology.graph)
+        assert fresh.validate(check).total_violations == 1
+
+    def test_recompiled_after_reimport(self, ontology):
+        """Test a reimported graph is not checked with the old graph's program"""
+        service = ontology.shape_service
+        check = [_instance("p", ["Professor"], memberOf="cs")]
+        # Imported twice, the schema reaches the same write counts and
+        # layer versions both times
+        exported = json.loads(ontology.graph.export_to_json())
+        ontology.graph.import_from_json(json.dumps(exported))
+        assert [v.constraint for v in service.validate(check).violations] == ["min_count"]
+
+        for node in exported["nodes"]:
+            if node["id"] == "name":
+                node["data"]["required"] = False
+        ontology.graph.import_from_json(json.dumps(exported))
+        assert service.validate(check).valid
+
+    def test_unchanged_schema_import_keeps_program(self, ontology, monkeypatch):
+        """Test replace_schema writes only the difference and keeps instances"""
+        service = ontology.shape_service
+        calls = []
+        compile_ = service._compile
+        monkeypatch.setattr(service, "_compile", lambda key: calls.append(key) or compile_(key))
+        classes = [OntologyClass(id="Person", label="Person"),
+                   OntologyClass(id="Professor", label="Professor", parent_classes=["Person"]),
+                   OntologyClass(id="Department", label="Department"),
+                   OntologyClass(id="Lab", label="Lab", parent_classes=["Department"])]
+        properties = [
+            OntologyProperty(id="name", label="name", property_type=PropertyType.DATA,
+                             domain=["Person"], range=["xsd:string"], required=True),
+            OntologyProperty(id="born", label="born", property_type=PropertyType.DATA,
+                             domain=["Person"], range=["xsd:date"],
+                             characteristics={PropertyCharacteristic.FUNCTIONAL}),
+            OntologyProperty(id="phone", label="phone", property_type=PropertyType.DATA,
+                             domain=["Person"], max_cardinality=2),
+            OntologyProperty(id="memberOf", label="member of", property_type=PropertyType.OBJECT,
+                             domain=["Professor"], range=["Department"], min_cardinality=1)]
+        ontology.create_instance(_instance("ai", ["Lab", "Department"]))
+        check = [_instance("p", ["Professor"], memberOf="cs")]
+        assert service.validate(check).total_violations == 1
+
+        version = ontology.graph.version()
+        stats = ontology.replace_schema(classes, properties)
+        assert stats["nodes_added"] + stats["nodes_updated"] + stats["nodes_deleted"] == 0
+        assert ontology.graph.version() == version
+        assert service.validate(check).total_violations == 1
+        assert len(calls) == 1
+
+        properties[0].required = False
+        stats = ontology.replace_schema(classes[:3], properties)
+        assert (stats["nodes_updated"], stats["nodes_deleted"]) == (1, 1)
+        assert ontology.graph.version() == version + 1
+        assert service.validate(check).valid
+        assert len(calls) == 2
+        assert ontology.graph.node_exists("cs") and ontology.graph.node_exists("ai")
+        assert [e['to'] for e in ontology.graph.get_neighbors("ai")] == ["Department"]
@@ -0,0 +1,82 @@
+"""
+Unit Tests for the test storage service
+
+Tests run history, trends and retention over the run time series,
+including runs stored out of timestamp order.
+"""
+
+from datetime import datetime, timedelta
+
+from src.services.test_execution_service import TestResult, TestRunResult
+from src.services.test_storage_service import TestStorageService
+
+
+def _run(run_id, when, layer="core", failed=0):
+    stamp = when.isoformat()
+    tests = [
+        TestResult(test_id=f"{run_id}-a", name="a", status="passed", duration=0.5,
+                   layer=layer, timestamp=stamp),
+        TestResult(test_id=f"{run_id}-b", name="b", status="failed" if failed else "passed",
+                   duration=0.25, layer=layer, timestamp=stamp),
+    ]
+    return TestRunResult(run_id=run_id, timestamp=stamp, total=2, passed=2 - failed,
+                         failed=failed, skipped=0, errors=0, duration=1.0,
+                         layer=layer, test_results=tests)
+
+
+class TestRunHistory:
+    """Test history, trends and retention"""
+
+    def test_history_newest_first(self):
+        """Test that runs come back newest first and per layer"""
+        storage = TestStorageService()
+        now = datetime.utcnow()
+        storage.store_test_run(_run("r1", now - timedelta(hours=2)))
+        storage.store_test_run(_run("r2", now - timedelta(hours=1), layer="api"))
+        storage.store_test_run(_run("r3", now))
+
+        assert [r.run_id for r in storage.get_test_history()] == ["r3", "r2", "r1"]
+        assert [r.run_id for r in storage.get_test_history(layer="core")] == ["r3", "r1"]
+        assert storage.get_latest_run_by_layer("core").run_id == "r3"
+
+    def test_out_of_order_run_is_indexed(self):
+        """Test that a run older than the newest stored one is still indexed"""
+        storage = TestStorageService()
+        now = datetime.utcnow().replace(hour=10, minute=0)
+        storage.store_test_run(_run("r1", now))
+        storage.store_test_run(_run("r2", now - timedelta(hours=1), failed=1))
+        storage.store_test_run(_run("r3", now + timedelta(minutes=5)))
+
+        assert [r.run_id for r in storage.get_test_history()] == ["r3", "r1", "r2"]
+        assert [r.run_id for r in storage.get_test_history(layer="core")] == ["r3", "r1", "r2"]
+        assert storage.get_latest_run_by_layer("core").run_id == "r3"
+
+        trends = storage.get_test_trends(layer="core")
+        assert trends['total_runs'] == 3
+        assert trends['total_tests_executed'] == 6
+        assert trends['total_failed'] == 1
+        assert storage.get_failing_tests()[0]['run_id'] == "r2"
+
+    def test_late_run_does_not_replace_latest(self):
+        """Test that a late, older run does not become the layer's latest"""
+        storage = TestStorageService()
+        now = datetime.utcnow()
+        storage.store_test_run(_run("new", now))
+        storage.store_test_run(_run("old", now - timedelta(days=1)))
+
+        assert storage.get_latest_run_by_layer("core").run_id == "new"
+        assert storage.get_statistics()['total_runs'] == 2
+
+    def test_cleanup_removes_out_of_order_runs(self):
+        """Test that retention also drops runs that arrived out of order"""
+        storage = TestStorageService()
+        now = datetime.utcnow()
+        storage.store_test_run(_run("recent", now))
+        storage.store_test_run(_run("stale", now - timedelta(days=200)))
+        assert len(storage.get_test_history()) == 2
+
+        storage.cleanup_old_data(days=90)
+
+        assert [r.run_id for r in storage.get_test_history()] == ["recent"]
+        assert storage.get_test_run("stale") is None
+        assert storage.get_test_run("recent") is not None
@@ -0,0 +1,59 @@
+"""
+Unit Tests for SymptomService
+
+Tests dictionary symptom extraction and the LLM fallback decision.
+"""
+
+import pytest
+from src.services import SymptomService, ValidationError
+
+
+@pytest.fixture
+def service():
+    """A few symptoms with ontology-style IDs and synonyms"""
+    return SymptomService({
+        "symp:Fever": {"label": "Fever", "synonyms": ["high temperature", "febrile"]},
+        "symp:Cough": {"label": "Cough", "synonyms": ["coughing"]},
+        "symp:Headache": {"label": "Headache"},
+        "symp:SevereHeadache": {"label": "Severe Headache"},
+        "symp:Vomiting": {"label": "Vomiting", "synonyms": ["throwing up"]},
+        "symp:ShortnessOfBreath": {"label": "Shortness of Breath",
+                                   "synonyms": ["short of breath"]},
+    })
+
+
+class TestExtract:
+    """Test symptom extraction"""
+
+    def test_labels_synonyms_and_negation(self, service):
+        """Test labels and synonyms map to IDs, once each, and negations are split out"""
+        result = service.extract("I've had a high temperature and a severe headache, "
+                                 "coughing all night. No vomiting. Fever again today")
+        assert [s['id'] for s in result.symptoms] == [
+            "symp:Fever", "symp:SevereHeadache", "symp:Cough"]
+        assert result.symptoms[0]['text'] == "high temperature"
+        assert result.symptoms[1]['label'] == "Severe Headache"
+        assert [s['id'] for s in result.negated] == ["symp:Vomiting"]
+        assert not result.needs_llm and result.coverage == 1.0
+
+        # Mentioned both ways counts as present
+        both = service.extract("no cough at first, but now a cough")
+        assert [s['id'] for s in both.symptoms] == ["symp:Cough"] and both.negated == []
+
+    def test_typos_and_llm_fallback(self, service):
+        """Test typos match fuzzily and unexplained text asks for the LLM"""
+        result = service.extract("feverr and short of breth")
+        assert [(s['id'], s['fuzzy']) for s in result.symptoms] == [
+            ("symp:Fever", True), ("symp:ShortnessOfBreath", True)]
+        assert service.extract("fevr", max_edits=0).symptoms == []
+
+        vague = service.extract("my skin itches and there is a red rash on my arm")
+        assert vague.symptoms == [] and vague.needs_llm
+
+        partial = service.extract("fever, itchy rash, swollen ankles and blurred vision")
+        assert [s['id'] for s in partial.symptoms] == ["symp:Fever"]
+        assert partial.coverage < SymptomService.MIN_COVERAGE and partial.needs_llm
+        assert partial.to_dict()['needs_llm'] is True
+
+        with pytest.raises(ValidationError):
+            service.extract("   ")
@@ -0,0 +1,56 @@
+"""
+Unit Tests for VocabularyService
+
+Tests paged triple-pattern queries over a compressed vocabulary file.
+"""
+
+import pytest
+from src.adapters.hdt import HDTWriter
+from src.services import VocabularyService, ValidationError
+
+RDFS_LABEL = "<http://www.w3.org/2000/01/rdf-schema#label>"
+SUBCLASS = "<http://www.w3.org/2000/01/rdf-schema#subClassOf>"
+
+
+@pytest.fixture
+def service(tmp_path):
+    """Ten diseases under one parent, each with a label"""
+    path = str(tmp_path / "vocab.hdt")
+    writer = HDTWriter()
+    for i in range(10):
+        iri = f"<http://example.org/Disease{i}>"
+        writer.add(iri, RDFS_LABEL, f'"Disease {i}"@en')
+        writer.add(iri, SUBCLASS, "<http://example.org/Disease>")
+    writer.save(path)
+    vocabulary = VocabularyService(path)
+    yield vocabulary
+    vocabulary.close()
+
+
+class TestTriples:
+    """Test pattern queries"""
+
+    def test_pages_through_matches(self, service):
+        """Test bound terms (bare IRIs wrapped), totals and paging"""
+        page = service.triples(predicate="http://www.w3.org/2000/01/rdf-schema#subClassOf",
+                               limit=4, offset=8)
+        assert page.total == 10 and page.offset == 8
+        assert [t['subject'] for t in page.triples] == ["<http://example.org/Disease8>",
+                                                        "<http://example.org/Disease9>"]
+        assert page.pattern == {'subject': None, 'predicate': SUBCLASS, 'object': None}
+
+        label = service.triples(subject="<http://example.org/Disease3>", predicate=RDFS_LABEL)
+        assert label.triples == [{'subject': "<http://example.org/Disease3>",
+                                  'predicate': RDFS_LABEL, 'object': '"Disease 3"@en'}]
+        assert service.triples(obj='"Disease 3"@en').total == 1
+        assert service.triples(subject="http://example.org/Unknown").total == 0
+        assert service.stats()['triples'] == 20
+
+    def test_validation(self, service, tmp_path):
+        """Test bad paging and missing files are rejected"""
+        with pytest.raises(ValidationError):
+            service.triples(limit=0)
+        with pytest.raises(ValidationError):
+            service.triples(offset=-1)
+        with pytest.raises(FileNotFoundError):
+            VocabularyService(str(tmp_path / "missing.hdt"))
@@ -0,0 +1,89 @@
+"""
+Unit Tests for WalkService
+
+Tests related-node suggestions and walk corpora over a GraphDB.
+"""
+
+import json
+
+import pytest
+from graph_db import GraphDB
+from src.services import WalkService, NodeNotFoundError, ValidationError
+
+
+@pytest.fixture
+def communities():
+    """Two symptom clusters joined by one weak link, plus an unlinked node"""
+    graph = GraphDB(directed=False)
+    left = ["fever", "cough", "fatigue", "chills"]
+    right = ["rash", "itch", "swelling", "hives"]
+    for node in left + right + ["lonely"]:
+        graph.add_node(node, {"label": node.title()})
+    edges = [(a, b, 1.0) for group in (left, right)
+             for k, a in enumerate(group) for b in group[k + 1:]]
+    graph.add_edges(edges + [("chills", "rash", 0.1)])
+    return WalkService(graph)
+
+
+class TestRelated:
+    """Test random walk with restart suggestions"""
+
+    def test_suggests_own_cluster_first(self, communities):
+        """Test sources are excluded and their cluster ranks first, with labels"""
+        result = communities.related(["fever"], top_k=7, restart=0.3, seed=1)
+        ranked = [item['node_id'] for item in result.related]
+        assert "fever" not in ranked
+        assert set(ranked[:3]) == {"cough", "fatigue", "chills"}
+        assert result.related[0]['label'] == result.related[0]['node_id'].title()
+        assert result.to_dict()['walks'] == WalkService.DEFAULT_WALKS
+
+        both = communities.related(["fever", "rash"], top_k=3)
+        assert not {"fever", "rash"} & {item['node_id'] for item in both.related}
+
+        assert communities.related(["lonely"]).related == []
+
+    def test_validation(self, communities):
+        """Test unknown nodes and bad parameters are rejected"""
+        with pytest.raises(NodeNotFoundError):
+            communities.related(["missing"])
+        with pytest.raises(ValidationError):
+            communities.related([])
+        with pytest.raises(ValidationError):
+            communities.related(["fever"], restart=0)
+        with pytest.raises(ValidationError):
+            communities.walk_corpus(["fever"], p=-1)
+
+
+class TestCorpus:
+    """Test walk corpora"""
+
+    def test_walks_follow_edges(self, communities):
+        """Test walks start where asked, follow edges and track graph changes"""
+        corpus = communities.walk_corpus(["fever", "hives"], walks_per_node=3, length=5,
+                                         p=0.5, q=2.0, seed=4)
+        assert len(corpus) == 6
+        assert [walk[0] for walk in corpus] == ["fever", "hives"] * 3
+        graph = communities.graph
+        for walk in corpus:
+            assert len(walk) == 6
+            assert all(graph.edge_exists(a, b) for a, b in zip(walk, walk[1:]))
+
+        assert communities.walk_corpus(["lonely"]) == []
+        graph.add_edge("lonely", "fever", 1.0)
+        assert communities.walk_corpus(["lonely"], length=1)[0] == ["lonely", "fever"]
+
+    def test_walks_follow_reimported_graph(self, communities):
+        """Test walks over a reimported graph use its edges, not cached ones"""
+        graph = communities.graph
+        nodes = graph.get_all_nodes()
+        communities.walk_corpus(nodes, walks_per_node=2, length=4, seed=1)
+
+        # The same nodes joined in one ring instead of two clusters
+        ring = [{"from": a, "to": b} for a, b in zip(nodes, nodes[1:] + nodes[:1])]
+        graph.import_from_json(json.dumps({
+            "directed": False,
+            "nodes": [{"id": node} for node in nodes],
+            "edges": ring,
+        }))
+        for walk in communities.walk_corpus(nodes, walks_per_node=2, length=4, seed=1):
+            assert all(graph.edge_exists(a, b) for a, b in zip(walk, walk[1:]))
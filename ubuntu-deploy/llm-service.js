@@ -4,6 +4,9 @@ import cors from 'cors';
 const app = express();
 const PORT = process.env.PORT || 3001;
 const OLLAMA_URL = process.env.OLLAMA_URL || 'http://localhost:11434';
+// Ontology API with the dictionary symptom extractor; empty disables the fast path
+const ONTOLOGY_API_URL = process.env.ONTOLOGY_API_URL ?? 'http://localhost:5002';
+const DICTIONARY_TIMEOUT_MS = 500;
 
 // CORS configuration for remote access
 app.use(cors({
@@ -32,6 +35,27 @@ app.get('/api/health', (req, res) => {
   });
 });
 
+// Dictionary extraction via the ontology API: matches symptom labels and
+// synonyms natively in microseconds. Returns null when the API is
+// unavailable so the caller falls back to the LLM.
+async function extractWithDictionary(text) {
+  if (!ONTOLOGY_API_URL) return null;
+  try {
+    const response = await fetch(`${ONTOLOGY_API_URL}/api/diagnose/extract-symptoms`, {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/json' },
+      body: JSON.stringify({ text }),
+      signal: AbortSignal.timeout(DICTIONARY_TIMEOUT_MS)
+    });
+    if (!response.ok) return null;
+    const body = await response.json();
+    return body.success ? body.data : null;
+  } catch (error) {
+    console.warn(`[${new Date().toISOString()}] Dictionary extraction unavailable: ${error.message}`);
+    return null;
+  }
+}
+
 // Symptom extraction endpoint
 app.post('/api/extract-symptoms', async (req, res) => {
   const { text } = req.body;
@@ -52,6 +76,23 @@ app.post('/api/extract-symptoms', async (req, res) => {
 
   console.log(`[${new Date().toISOString()}] Extracting symptoms from: "${text}"`);
 
+  // Fast path: skip the model when the dictionary explains the text
+  const started = Date.now();
+  const dictionary = await extractWithDictionary(text);
+  if (dictionary && !dictionary.needs_llm) {
+    console.log(`[${new Date().toISOString()}] Dictionary: ${dictionary.symptoms.map(s => s.label).join(', ')}`);
+    return res.json({
+      success: true,
+      extracted: dictionary.symptoms.map(s => s.label),
+      symptomIds: dictionary.symptoms.map(s => s.id),
+      negated: dictionary.negated.map(s => s.id),
+      method: 'dictionary',
+      coverage: dictionary.coverage,
+      llmModel: null,
+      processingTime: `${((Date.now() - started) / 1000).toFixed(3)}s`
+    });
+  }
+
   try {
     const prompt = `You are a medical symptom extraction assistant. Extract ONLY the symptom names from the following text. Return ONLY a comma-separated list of symptoms, nothing else.
 
@@ -107,6 +148,7 @@ Extracted symptoms (comma-separated):`;
       success: true,
       extracted: symptoms,
       symptomIds: symptomIds,
+      method: 'llm',
       llmModel: 'llama3.2:3b',
       rawResponse: extractedText,
       processingTime: data.total_duration ? `${(data.total_duration / 1000000000).toFixed(2)}s` : 'N/A'